@@ -54,6 +54,20 @@ namespace itk
  * This is an image to image filter.  The specific types of the images are not
  * fixed at this level in the hierarchy.
  *
+ * \par Active blocks
+ * When UseActiveBlocks is on, the requested region is tiled into blocks of
+ * ActiveBlockSize pixels, and CalculateChange() and ApplyUpdate() only visit
+ * the active blocks. A block is deactivated for the next iteration when the
+ * largest change applied to its pixels (the norm of the update times the time
+ * step) does not exceed ActiveBlockTolerance, and none of the blocks within
+ * reach of the function radius changed more than that. Deactivated blocks keep
+ * their values and a zero update. The time step of each thread is the minimum
+ * of the time steps computed on its blocks. With the default tolerance of
+ * zero, only blocks whose update is exactly zero are skipped, which leaves
+ * the result unchanged for functions whose update only depends on the
+ * neighborhood values. The number of active blocks and pixels of the last
+ * iteration can be queried from an IterationEvent observer.
+ *
  * \par How to use this class
  * This filter is only one layer in a branch the finite difference solver
  * hierarchy.  It does not define the function used in the CalculateChange() and
@@ -102,6 +116,35 @@ public:
   /** The container type for the update buffer. */
   using UpdateBufferType = OutputImageType;
 
+  /** The size type of the blocks used by the active-block mode. */
+  using BlockSizeType = typename OutputImageType::SizeType;
+
+  /** Enable/Disable the active-block mode, which skips the blocks where the
+   * solution has converged.  Off by default. */
+  itkSetMacro(UseActiveBlocks, bool);
+  itkGetConstMacro(UseActiveBlocks, bool);
+  itkBooleanMacro(UseActiveBlocks);
+
+  /** Set/Get the size in pixels of the blocks tracked by the active-block
+   * mode.  Defaults to 16 in each dimension. */
+  itkSetMacro(ActiveBlockSize, BlockSizeType);
+  itkGetConstReferenceMacro(ActiveBlockSize, BlockSizeType);
+
+  /** Set/Get the largest change a block may undergo in one iteration and
+   * still be considered converged.  Defaults to zero. */
+  itkSetMacro(ActiveBlockTolerance, double);
+  itkGetConstMacro(ActiveBlockTolerance, double);
+
+  /** Number of blocks tiling the requested region, and number of blocks and
+   * pixels processed during the last iteration, in active-block mode. */
+  itkGetConstMacro(NumberOfBlocks, SizeValueType);
+  itkGetConstMacro(NumberOfActiveBlocks, SizeValueType);
+  itkGetConstMacro(NumberOfActivePixels, SizeValueType);
+
+  /** Fraction of the requested region processed during the last iteration,
+   * in active-block mode. */
+  double GetActiveVolumeFraction() const;
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro( OutputTimesDoubleCheck,
@@ -116,8 +159,18 @@ public:
 #endif
 
 protected:
-  DenseFiniteDifferenceImageFilter()
-  { m_UpdateBuffer = UpdateBufferType::New(); }
+  DenseFiniteDifferenceImageFilter() :
+    m_UseActiveBlocks(false),
+    m_ActiveBlockTolerance(0.0),
+    m_NumberOfBlocks(0),
+    m_NumberOfActiveBlocks(0),
+    m_NumberOfActivePixels(0)
+  {
+    m_UpdateBuffer = UpdateBufferType::New();
+    m_ActiveBlockSize.Fill(16);
+    m_BlockGridBlockSize.Fill(0);
+    m_BlockGridSize.Fill(0);
+  }
   ~DenseFiniteDifferenceImageFilter() override {}
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -183,8 +236,51 @@ private:
    * which it then passes to ThreadedCalculateChange for processing. */
   static ITK_THREAD_RETURN_TYPE CalculateChangeThreaderCallback(void *arg);
 
+  /** Tile the requested region into blocks when needed, and gather the
+   * active blocks of the coming iteration. */
+  void PrepareActiveBlocks();
+
+  /** Decide which blocks are active in the next iteration, from the largest
+   * change applied to each block with the time step dt. */
+  void UpdateActiveBlocks(const TimeStepType & dt);
+
+  /** Region covered by a block, given its linear index in the block grid. */
+  ThreadRegionType GetBlockRegion(SizeValueType block) const;
+
+  /** Calculate the change over the share of the active blocks assigned to
+   * threadId.  Returns false if the thread was given no block. */
+  bool ThreadedCalculateChangeOnActiveBlocks(ThreadIdType threadId,
+                                             ThreadIdType threadCount,
+                                             TimeStepType & timeStep);
+
+  /** Apply the update over the share of the active blocks assigned to
+   * threadId. */
+  void ThreadedApplyUpdateOnActiveBlocks(const TimeStepType & dt,
+                                         ThreadIdType threadId,
+                                         ThreadIdType threadCount);
+
   /** The buffer that holds the updates for an iteration of the algorithm. */
   typename UpdateBufferType::Pointer m_UpdateBuffer;
+
+  bool          m_UseActiveBlocks;
+  BlockSizeType m_ActiveBlockSize;
+  double        m_ActiveBlockTolerance;
+
+  SizeValueType m_NumberOfBlocks;
+  SizeValueType m_NumberOfActiveBlocks;
+  SizeValueType m_NumberOfActivePixels;
+
+  /** Region and block size the block grid was built for, and number of
+   * blocks along each dimension. */
+  ThreadRegionType m_BlockGridRegion;
+  BlockSizeType    m_BlockGridBlockSize;
+  BlockSizeType    m_BlockGridSize;
+
+  /** Activity flag and largest update norm of each block, and list of the
+   * blocks processed in the current iteration. */
+  std::vector< unsigned char > m_ActiveBlocks;
+  std::vector< double >        m_BlockMaximumUpdate;
+  std::vector< SizeValueType > m_ActiveBlockList;
 };
 } // end namespace itk
 
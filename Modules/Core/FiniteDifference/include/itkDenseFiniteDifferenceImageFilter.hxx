@@ -19,10 +19,13 @@
 #define itkDenseFiniteDifferenceImageFilter_hxx
 #include "itkDenseFiniteDifferenceImageFilter.h"
 
+#include <algorithm>
+#include <cmath>
 #include <list>
 #include "itkImageRegionIterator.h"
 #include "itkNumericTraits.h"
 #include "itkNeighborhoodAlgorithm.h"
+#include "itkDefaultConvertPixelTraits.h"
 
 namespace itk
 {
@@ -96,6 +99,11 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   // Multithread the execution
   this->GetMultiThreader()->SingleMethodExecute();
 
+  if ( m_UseActiveBlocks )
+    {
+    this->UpdateActiveBlocks(dt);
+    }
+
   // Explicitely call Modified on GetOutput here
   // since ThreadedApplyUpdate changes this buffer
   // through iterators which do not increment the
@@ -113,6 +121,12 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 
   auto * str = (DenseFDThreadStruct *) ( ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->UserData );
 
+  if ( str->Filter->m_UseActiveBlocks )
+    {
+    str->Filter->ThreadedApplyUpdateOnActiveBlocks(str->TimeStep, threadId, threadCount);
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -134,6 +148,16 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >::TimeStepType
 DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 ::CalculateChange()
 {
+  if ( m_UseActiveBlocks )
+    {
+    this->PrepareActiveBlocks();
+    if ( m_ActiveBlockList.empty() )
+      {
+      // Every block has converged: there is nothing left to compute.
+      return NumericTraits< TimeStepType >::ZeroValue();
+      }
+    }
+
   // Set up for multithreaded processing.
   DenseFDThreadStruct str;
 
@@ -181,6 +205,17 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 
   auto * str = (DenseFDThreadStruct *) ( ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->UserData );
 
+  if ( str->Filter->m_UseActiveBlocks )
+    {
+    TimeStepType timeStep = NumericTraits< TimeStepType >::ZeroValue();
+    if ( str->Filter->ThreadedCalculateChangeOnActiveBlocks(threadId, threadCount, timeStep) )
+      {
+      str->TimeStepList[threadId] = timeStep;
+      str->ValidTimeStepList[threadId] = true;
+      }
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -297,12 +332,234 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   return timeStep;
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::PrepareActiveBlocks()
+{
+  const ThreadRegionType region = this->GetOutput()->GetRequestedRegion();
+
+  // A new run, or a change of region or block size, restarts with every
+  // block active.
+  if ( this->GetElapsedIterations() == 0
+       || region != m_BlockGridRegion
+       || m_ActiveBlockSize != m_BlockGridBlockSize )
+    {
+    m_NumberOfBlocks = 1;
+    for ( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      if ( m_ActiveBlockSize[dim] == 0 )
+        {
+        itkExceptionMacro(<< "ActiveBlockSize must be at least one pixel in each dimension: " << m_ActiveBlockSize);
+        }
+      m_BlockGridSize[dim] = ( region.GetSize(dim) + m_ActiveBlockSize[dim] - 1 ) / m_ActiveBlockSize[dim];
+      m_NumberOfBlocks *= m_BlockGridSize[dim];
+      }
+    m_BlockGridRegion = region;
+    m_BlockGridBlockSize = m_ActiveBlockSize;
+
+    m_ActiveBlocks.assign(m_NumberOfBlocks, 1);
+    m_BlockMaximumUpdate.assign(m_NumberOfBlocks, 0.0);
+    }
+
+  m_ActiveBlockList.clear();
+  m_NumberOfActivePixels = 0;
+  for ( SizeValueType block = 0; block < m_NumberOfBlocks; ++block )
+    {
+    if ( m_ActiveBlocks[block] )
+      {
+      m_ActiveBlockList.push_back(block);
+      m_NumberOfActivePixels += this->GetBlockRegion(block).GetNumberOfPixels();
+      }
+    }
+  m_NumberOfActiveBlocks = m_ActiveBlockList.size();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::UpdateActiveBlocks(const TimeStepType & dt)
+{
+  // A change in a block modifies the neighborhoods of the pixels of the blocks
+  // within the function radius, which must then be computed again.
+  const typename FiniteDifferenceFunctionType::RadiusType radius =
+    this->GetDifferenceFunction()->GetRadius();
+  IndexValueType reach[ImageDimension];
+  for ( unsigned int dim = 0; dim < ImageDimension; ++dim )
+    {
+    reach[dim] = static_cast< IndexValueType >(
+      ( radius[dim] + m_BlockGridBlockSize[dim] - 1 ) / m_BlockGridBlockSize[dim] );
+    }
+
+  const double timeStep = std::abs( static_cast< double >( dt ) );
+
+  std::vector< unsigned char > nextActiveBlocks(m_NumberOfBlocks, 0);
+  for ( auto block : m_ActiveBlockList )
+    {
+    if ( m_BlockMaximumUpdate[block] * timeStep <= m_ActiveBlockTolerance )
+      {
+      continue;
+      }
+
+    IndexValueType lower[ImageDimension];
+    IndexValueType upper[ImageDimension];
+    IndexValueType neighbor[ImageDimension];
+    SizeValueType  remainder = block;
+    for ( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      const auto gridSize = static_cast< IndexValueType >( m_BlockGridSize[dim] );
+      const auto position = static_cast< IndexValueType >( remainder % m_BlockGridSize[dim] );
+      remainder /= m_BlockGridSize[dim];
+      lower[dim] = std::max(position - reach[dim], IndexValueType(0));
+      upper[dim] = std::min(position + reach[dim], gridSize - 1);
+      neighbor[dim] = lower[dim];
+      }
+
+    unsigned int dim = 0;
+    while ( dim < ImageDimension )
+      {
+      SizeValueType neighborBlock = 0;
+      for ( int d = ImageDimension - 1; d >= 0; --d )
+        {
+        neighborBlock = neighborBlock * m_BlockGridSize[d] + neighbor[d];
+        }
+      nextActiveBlocks[neighborBlock] = 1;
+
+      for ( dim = 0; dim < ImageDimension; ++dim )
+        {
+        if ( ++neighbor[dim] <= upper[dim] )
+          {
+          break;
+          }
+        neighbor[dim] = lower[dim];
+        }
+      }
+    }
+
+  // Deactivated blocks hold a zero update, so that subclasses reading the
+  // whole update buffer see no change there.
+  for ( auto block : m_ActiveBlockList )
+    {
+    if ( !nextActiveBlocks[block] )
+      {
+      ImageRegionIterator< UpdateBufferType > u(m_UpdateBuffer, this->GetBlockRegion(block));
+      for ( u.GoToBegin(); !u.IsAtEnd(); ++u )
+        {
+        u.Value() = NumericTraits< PixelType >::ZeroValue( u.Get() );
+        }
+      }
+    }
+
+  m_ActiveBlocks.swap(nextActiveBlocks);
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >::ThreadRegionType
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::GetBlockRegion(SizeValueType block) const
+{
+  ThreadRegionType blockRegion;
+  for ( unsigned int dim = 0; dim < ImageDimension; ++dim )
+    {
+    const SizeValueType position = block % m_BlockGridSize[dim];
+    block /= m_BlockGridSize[dim];
+
+    const SizeValueType offset = position * m_BlockGridBlockSize[dim];
+    blockRegion.SetIndex( dim, m_BlockGridRegion.GetIndex(dim) + static_cast< IndexValueType >( offset ) );
+    blockRegion.SetSize( dim, std::min( m_BlockGridBlockSize[dim], m_BlockGridRegion.GetSize(dim) - offset ) );
+    }
+  return blockRegion;
+}
+
+template< typename TInputImage, typename TOutputImage >
+bool
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::ThreadedCalculateChangeOnActiveBlocks(ThreadIdType threadId,
+                                        ThreadIdType threadCount,
+                                        TimeStepType & timeStep)
+{
+  const SizeValueType numberOfActiveBlocks = m_ActiveBlockList.size();
+  const SizeValueType first = numberOfActiveBlocks * threadId / threadCount;
+  const SizeValueType last = numberOfActiveBlocks * ( threadId + 1 ) / threadCount;
+
+  bool valid = false;
+  for ( SizeValueType ii = first; ii < last; ++ii )
+    {
+    const SizeValueType    block = m_ActiveBlockList[ii];
+    const ThreadRegionType blockRegion = this->GetBlockRegion(block);
+
+    const TimeStepType blockTimeStep = this->ThreadedCalculateChange(blockRegion, threadId);
+    if ( !valid || blockTimeStep < timeStep )
+      {
+      timeStep = blockTimeStep;
+      valid = true;
+      }
+
+    // Keep the largest update norm of the block; whether the block has
+    // converged is decided once the time step is known.
+    double maximumSquaredNorm = 0.0;
+    ImageRegionConstIterator< UpdateBufferType > u(m_UpdateBuffer, blockRegion);
+    for ( u.GoToBegin(); !u.IsAtEnd(); ++u )
+      {
+      const PixelType & update = u.Get();
+      double squaredNorm = 0.0;
+      for ( unsigned int c = 0; c < NumericTraits< PixelType >::GetLength(update); ++c )
+        {
+        const auto component = static_cast< double >(
+          DefaultConvertPixelTraits< PixelType >::GetNthComponent(c, update) );
+        squaredNorm += component * component;
+        }
+      maximumSquaredNorm = std::max(maximumSquaredNorm, squaredNorm);
+      }
+    m_BlockMaximumUpdate[block] = std::sqrt(maximumSquaredNorm);
+    }
+
+  return valid;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::ThreadedApplyUpdateOnActiveBlocks(const TimeStepType & dt,
+                                    ThreadIdType threadId,
+                                    ThreadIdType threadCount)
+{
+  const SizeValueType numberOfActiveBlocks = m_ActiveBlockList.size();
+  const SizeValueType first = numberOfActiveBlocks * threadId / threadCount;
+  const SizeValueType last = numberOfActiveBlocks * ( threadId + 1 ) / threadCount;
+
+  for ( SizeValueType ii = first; ii < last; ++ii )
+    {
+    this->ThreadedApplyUpdate(dt, this->GetBlockRegion(m_ActiveBlockList[ii]), threadId);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+double
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::GetActiveVolumeFraction() const
+{
+  const SizeValueType numberOfPixels = m_BlockGridRegion.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return 1.0;
+    }
+  return static_cast< double >( m_NumberOfActivePixels ) / static_cast< double >( numberOfPixels );
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseActiveBlocks: " << m_UseActiveBlocks << std::endl;
+  os << indent << "ActiveBlockSize: " << m_ActiveBlockSize << std::endl;
+  os << indent << "ActiveBlockTolerance: " << m_ActiveBlockTolerance << std::endl;
+  os << indent << "NumberOfBlocks: " << m_NumberOfBlocks << std::endl;
+  os << indent << "NumberOfActiveBlocks: " << m_NumberOfActiveBlocks << std::endl;
+  os << indent << "NumberOfActivePixels: " << m_NumberOfActivePixels << std::endl;
 }
 } // end namespace itk
 
@@ -25,6 +25,8 @@
 #include "itkCovariantVector.h"
 #include "itkDefaultStaticMeshTraits.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkMultiThreaderBase.h"
+#include <vector>
 
 namespace itk
 {
@@ -37,33 +39,51 @@ namespace itk
  * model into one hybrid framework.
  *
  * \par
- * To construct a mesh, we need to construct elements in a voxel and combine
- * those elements later to form the final mesh. Before go through every voxel
- * in the 3D volume, we first construct 2 look up tables. The index of these 2
- * tables are the on-off combination of the 8 nodes that form the voxel. So
- * both of these tables has the size of \$2^8\$ bytes. According to previous
- * work, all those \$2^8\$ combination of the nodes can be grouped into 16
- * final combinations. In the first table, we record the final combination that
- * can be transformed from the current combination. The entries of the second
- * table are made up of the transforming sequence that is necessary for the
- * current combination transform to one of the final combinations.
+ * The surface is built by marching cubes: every cube of 8 neighboring
+ * voxels is classified by which of its corners belong to the object, and a
+ * lookup table gives the triangles to generate in that cube.  The vertices
+ * are placed at the middle of the cube edges joining an object voxel to a
+ * non object voxel.  The lookup table is computed once from the faces of
+ * the cube.  Two object corners that are diagonal on a face are always
+ * separated, so neighboring cubes agree on every shared face and the
+ * surface is closed and manifold.  Voxels outside the region of interest
+ * are treated as background, so the surface is also closed on the region
+ * boundary.  The triangles are oriented with their normals pointing out of
+ * the object.
  *
  * \par
- * We then go through the 3D volume voxel by voxel, using those two tables we have defined
- * to construct elements within each voxel. We then merge all these mesh elements into
- * one 3D mesh.
+ * The volume is processed in slabs of slices on several threads.  A first
+ * pass counts the vertices and triangles of every slab, a second pass
+ * generates them.  Every vertex is identified by the voxel edge it lies on,
+ * so each vertex is created exactly once and its identifier is known from
+ * the counts of the first pass, without any search.  With UseCellsArrays on,
+ * a Mesh output keeps its triangles as compact cell arrays (see
+ * Mesh::SetCellsFromArrays()).
  *
  * \par PARAMETERS
  * The ObjectValue parameter is used to identify the object. In most applications,
  * pixels in the object region are assigned to "1", so the default value of ObjectValue is
  * set to "1"
  *
+ * \par
+ * Several objects of a label image can be extracted in one pass by setting
+ * ObjectValues, which then takes precedence over ObjectValue.  Each object
+ * gets its own closed surface, the data of every triangle being the index
+ * of its object in ObjectValues.  Two touching objects thus have
+ * coincident, but distinct, triangles and points along their interface.
+ * With a single object, the data of every triangle is 0.
+ *
+ * \par
+ * NumberOfStreamDivisions splits the region of interest into that many
+ * slabs along the last axis, and updates the input pipeline for one slab at
+ * a time.  Only one slab of the input needs to be in memory at once.
+ *
  * \par REFERENCE
  * W. Lorensen and H. Cline, "Marching Cubes: A High Resolution 3D Surface Construction Algorithm",
  * Computer Graphics 21, pp. 163-169, 1987.
  *
  * \par INPUT
- * The input should be a 3D binary image.
+ * The input should be a 3D binary or label image.
  *
  * \ingroup ITKMesh
  */
@@ -125,7 +145,31 @@ public:
   using IdentifierType = itk::IdentifierType;
   using SizeValueType = itk::SizeValueType;
 
+  /** List of the pixel values of the objects to extract. */
+  using ObjectValuesType = std::vector< InputPixelType >;
+
+  static_assert( InputImageType::ImageDimension == 3, "The input image must be 3D" );
+
   itkSetMacro(ObjectValue, InputPixelType);
+  itkGetConstMacro(ObjectValue, InputPixelType);
+
+  /** Set the pixel values of several objects to extract in one pass.  When
+   * not empty, this list is used instead of ObjectValue. */
+  void SetObjectValues(const ObjectValuesType & values)
+    {
+    if ( values != m_ObjectValues )
+      {
+      m_ObjectValues = values;
+      this->Modified();
+      }
+    }
+
+  itkGetConstReferenceMacro(ObjectValues, ObjectValuesType);
+
+  /** Number of slabs the input is requested in.  The default, 1, requests
+   * the whole region of interest at once. */
+  itkSetClampMacro(NumberOfStreamDivisions, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfStreamDivisions, unsigned int);
 
   itkGetConstMacro(NumberOfNodes, SizeValueType);
   itkGetConstMacro(NumberOfCells, SizeValueType);
@@ -148,11 +192,13 @@ public:
 
 protected:
   BinaryMask3DMeshSource();
-  ~BinaryMask3DMeshSource() override;
+  ~BinaryMask3DMeshSource() override = default;
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
   void GenerateData() override;
 
+  /** Request the region of interest, or its first slab when streaming. */
+  void GenerateInputRequestedRegion() override;
 
   bool       m_RegionOfInterestProvidedByUser;
   RegionType m_RegionOfInterest;
@@ -162,78 +208,120 @@ protected:
 private:
   using InputImageSizeType = typename InputImageType::SizeType;
 
-  void CreateMesh();
+  /** Index of a pixel value in the list of object values. */
+  using LabelIndexType = unsigned int;
+  static constexpr LabelIndexType NoLabel = NumericTraits< LabelIndexType >::max();
+
+  /** Labels of a padded slice, with the extent [RowBegin, RowEnd) of the
+   * object voxels of every row.  RowBegin is past RowEnd in an empty row. */
+  struct LabelSliceType
+  {
+    std::vector< LabelIndexType > Labels;
+    std::vector< SizeValueType >  RowBegin;
+    std::vector< SizeValueType >  RowEnd;
+  };
+
+  using IdentifierSliceType = std::vector< IdentifierType >;
+  using OPointIdentifier = typename OutputMeshType::PointIdentifier;
+  using OCellPixelType = typename OMeshTraits::CellPixelType;
+
+  /** Triangles of the 256 cube configurations, as triplets of cube edges.
+   * A cube corner c is at offset (c & 1, (c >> 1) & 1, (c >> 2) & 1), and
+   * cube edge e goes along axis e / 4 from corner EdgeCorners[e]. */
+  struct CaseTable
+  {
+    unsigned char NumberOfTriangles[256];
+    unsigned char Edges[256][36];
+    unsigned char EdgeCorners[12];
+  };
+
+  static const CaseTable & GetCaseTable();
 
-  void XFlip(unsigned char *tp);     // 7 kinds of transformation
+  static void BuildCaseTable(CaseTable & table);
 
-  void YFlip(unsigned char *tp);
+  /** Region of interest cropped to the largest possible region. */
+  RegionType ComputeExtractionRegion(const InputImageType *input) const;
 
-  void ZFlip(unsigned char *tp);
+  /** Region of the input needed by layers [begin, end). */
+  RegionType ComputeLayersInputRegion(SizeValueType begin, SizeValueType end) const;
 
-  void XRotation(unsigned char *tp);
+  /** Slices and layers are numbered on the extraction region padded with one
+   * background voxel on each side: slice 0 and the last slice are outside of
+   * the region, and layer j holds the cubes between slices j and j + 1. */
+  void FillLabelSlice(SizeValueType slice, LabelSliceType & labels) const;
 
-  void YRotation(unsigned char *tp);
+  LabelIndexType GetLabelIndex(const InputPixelType & value) const;
 
-  void ZRotation(unsigned char *tp);
+  /** Number the vertices on the edges along the first two axes in a slice,
+   * starting at \a id.  With \a ids set to nullptr the vertices are only
+   * counted.  Returns the identifier after the last vertex. */
+  IdentifierType NumberSliceEdges(SizeValueType slice, const LabelSliceType & labels,
+                                  IdentifierType id, IdentifierSliceType *ids, bool writePoints);
 
-  void inverse(unsigned char *tp);
+  /** Same as NumberSliceEdges() for the edges along the last axis in a layer. */
+  IdentifierType NumberLayerEdges(SizeValueType layer, const LabelSliceType & bottom,
+                                  const LabelSliceType & top, IdentifierType id,
+                                  IdentifierSliceType *ids, bool writePoints);
 
-  void InitializeLUT(); // initialize the look up table before the mesh
-                        // construction
+  SizeValueType CountLayerTriangles(const LabelSliceType & bottom, const LabelSliceType & top) const;
 
-  void AddCells(unsigned char celltype, unsigned char celltran, int index);
+  void GenerateLayerTriangles(const LabelSliceType & bottom, const LabelSliceType & top,
+                              const IdentifierSliceType & bottomIds, const IdentifierSliceType & topIds,
+                              const IdentifierSliceType & layerIds, SizeValueType cellId);
 
-  void AddNodes(int index,
-                unsigned char *nodesid,
-                IdentifierType *globalnodesid,
-                IdentifierType **currentrowtmp,
-                IdentifierType **currentframetmp);
+  void ComputeVertexPoint(SizeValueType x, SizeValueType y, SizeValueType slice,
+                          unsigned int axis, OPointType & point) const;
 
-  void CellTransfer(unsigned char *nodesid, unsigned char celltran);
+  /** First pass: count the vertices and triangles of layers [begin, end). */
+  void CountLayers(SizeValueType begin, SizeValueType end);
 
-  IdentifierType SearchThroughLastRow(int index, int start, int end);
+  /** Second pass: generate the vertices and triangles of layers [begin, end). */
+  void GenerateLayers(SizeValueType begin, SizeValueType end);
 
-  IdentifierType SearchThroughLastFrame(int index, int start, int end);
+  /** Run CountLayers() or GenerateLayers() over layers [begin, end) on
+   * several threads. */
+  void ThreadLayers(SizeValueType begin, SizeValueType end, bool count);
 
-  unsigned char m_LUT[256][2]; // the two lookup tables
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
 
-  IdentifierType m_LastVoxel[14];
-  IdentifierType m_CurrentVoxel[14];
+  struct ThreadStruct
+  {
+    Self *Filter;
+    SizeValueType Begin;
+    SizeValueType End;
+    bool Count;
+  };
 
-  IdentifierType **m_LastRow;
-  IdentifierType **m_LastFrame;
-  IdentifierType **m_CurrentRow;
-  IdentifierType **m_CurrentFrame;
+  /** Move the content of a vector into a mesh container.  A VectorContainer
+   * takes the vector over without copying it. */
+  template< typename TContainer >
+  static void MoveIntoContainer(std::vector< typename TContainer::Element > & values, TContainer *container);
 
-  unsigned short m_CurrentRowIndex;
-  unsigned short m_CurrentFrameIndex;
-  unsigned short m_LastRowNum;
-  unsigned short m_LastFrameNum;
-  unsigned short m_CurrentRowNum;
-  unsigned short m_CurrentFrameNum;
-  unsigned char  m_AvailableNodes[14];
+  template< typename TElementIdentifier, typename TElement >
+  static void MoveIntoContainer(std::vector< TElement > & values,
+                                VectorContainer< TElementIdentifier, TElement > *container);
 
-  double m_LocationOffset[14][3];
+  /** Hand the generated points, triangles and triangle data to the output. */
+  void FillOutputMesh();
 
   SizeValueType m_NumberOfNodes;
   SizeValueType m_NumberOfCells;
 
-  int m_NodeLimit;
-  int m_CellLimit;
-  int m_ImageWidth;
-  int m_ImageHeight;
-  int m_ImageDepth;
-  int m_ColFlag;
-  int m_RowFlag;
-  int m_FrameFlag;
-  int m_LastRowIndex;
-  int m_LastVoxelIndex;
-  int m_LastFrameIndex;
-
-  unsigned char  m_PointFound;
-  InputPixelType m_ObjectValue;
-
-  /** temporary variables used in CreateMesh to avoid thousands of
+  InputPixelType   m_ObjectValue;
+  ObjectValuesType m_ObjectValues;
+  unsigned int     m_NumberOfStreamDivisions;
+
+  /** State of the extraction, valid during GenerateData(). */
+  RegionType                      m_ExtractionRegion;
+  SizeValueType                   m_PaddedSize[3];
+  ObjectValuesType                m_Labels;
+  std::vector< IdentifierType >   m_LayerVertexOffsets;
+  std::vector< SizeValueType >    m_LayerCellOffsets;
+  std::vector< OPointType >       m_Points;
+  std::vector< OPointIdentifier > m_Connectivity;
+  std::vector< OCellPixelType >   m_CellData;
+
+  /** temporary variables used in GenerateData to avoid thousands of
    *  calls to GetInput() and GetOutput()
    */
   OutputMeshType       *m_OutputMesh;
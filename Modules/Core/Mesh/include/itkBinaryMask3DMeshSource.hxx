@@ -19,41 +19,25 @@
 #define itkBinaryMask3DMeshSource_hxx
 
 #include "itkBinaryMask3DMeshSource.h"
-#include "itkContinuousIndex.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkNumericTraits.h"
-#include "itkMath.h"
+
+#include <algorithm>
 
 namespace itk
 {
+template< typename TInputImage, typename TOutputMesh >
+constexpr typename BinaryMask3DMeshSource< TInputImage, TOutputMesh >::LabelIndexType
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >::NoLabel;
+
 template< typename TInputImage, typename TOutputMesh >
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
 ::BinaryMask3DMeshSource() :
   m_RegionOfInterestProvidedByUser(false),
-  m_LastRow(nullptr),
-  m_LastFrame(nullptr),
-  m_CurrentRow(nullptr),
-  m_CurrentFrame(nullptr),
-  m_CurrentRowIndex(0),
-  m_CurrentFrameIndex(0),
-  m_LastRowNum(0),
-  m_LastFrameNum(0),
-  m_CurrentRowNum(200),
-  m_CurrentFrameNum(2000),
   m_NumberOfNodes(0),
   m_NumberOfCells(0),
-  m_NodeLimit(2000),
-  m_CellLimit(4000),
-  m_ImageWidth(0),
-  m_ImageHeight(0),
-  m_ImageDepth(0),
-  m_ColFlag(0),
-  m_RowFlag(0),
-  m_FrameFlag(0),
-  m_LastRowIndex(0),
-  m_LastVoxelIndex(0),
-  m_LastFrameIndex(0),
-  m_PointFound(0),
   m_ObjectValue(NumericTraits< InputPixelType >::OneValue()),
+  m_NumberOfStreamDivisions(1),
   m_OutputMesh(nullptr),
   m_InputImage(nullptr)
 {
@@ -63,49 +47,7 @@ BinaryMask3DMeshSource< TInputImage, TOutputMesh >
   SizeType size;
   size.Fill( 0 );
   m_RegionOfInterest.SetSize(size);
-
-  this->GetOutput()->GetPoints()->Reserve(m_NodeLimit);
-  this->GetOutput()->GetCells()->Reserve(m_CellLimit);
-}
-
-template< typename TInputImage, typename TOutputMesh >
-BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::~BinaryMask3DMeshSource()
-{
-  int i;
-
-  if ( m_CurrentFrame )
-    {
-    for ( i = 0; i < 2000; i++ )
-      {
-      free(m_CurrentFrame[i]);
-      }
-    free (m_CurrentFrame);
-    }
-  if ( m_CurrentRow )
-    {
-    for ( i = 0; i < 200; i++ )
-      {
-      free(m_CurrentRow[i]);
-      }
-    free (m_CurrentRow);
-    }
-  if ( m_LastFrame )
-    {
-    for ( i = 0; i < m_LastFrameNum; i++ )
-      {
-      free(m_LastFrame[i]);
-      }
-    free (m_LastFrame);
-    }
-  if ( m_LastRow )
-    {
-    for ( i = 0; i < m_LastRowNum; i++ )
-      {
-      free(m_LastRow[i]);
-      }
-    free (m_LastRow);
-    }
+  m_PaddedSize[0] = m_PaddedSize[1] = m_PaddedSize[2] = 0;
 }
 
 template< typename TInputImage, typename TOutputMesh >
@@ -117,2553 +59,776 @@ BinaryMask3DMeshSource< TInputImage, TOutputMesh >
                                     const_cast< InputImageType * >( image ) );
 }
 
-/** Generate the data */
 template< typename TInputImage, typename TOutputMesh >
-void
+const typename BinaryMask3DMeshSource< TInputImage, TOutputMesh >::CaseTable &
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::GenerateData()
+::GetCaseTable()
 {
-  if ( !m_RegionOfInterestProvidedByUser )
+  static const CaseTable table = []()
     {
-    m_RegionOfInterest = this->GetInput()->GetBufferedRegion();
-    }
-  else
-    {
-    m_RegionOfInterest.Crop( this->GetInput()->GetBufferedRegion() );
-    }
-
-  this->InitializeLUT();
-  this->CreateMesh();
+    CaseTable t;
+    BuildCaseTable(t);
+    return t;
+    }();
+  return table;
 }
 
 template< typename TInputImage, typename TOutputMesh >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::XFlip(unsigned char *x)
+::BuildCaseTable(CaseTable & table)
 {
-  unsigned char nodeindex;
-
-  int i = 0;
+  // Cube edge e goes along axis a = e / 4 from the corner whose bits along
+  // the two other axes are given by e % 4.
+  unsigned char otherAxes[3][2] = { { 1, 2 }, { 0, 2 }, { 0, 1 } };
+  for ( unsigned int e = 0; e < 12; ++e )
+    {
+    const unsigned int a = e / 4;
+    table.EdgeCorners[e] = static_cast< unsigned char >( ( ( e & 1 ) << otherAxes[a][0] )
+                                                         | ( ( ( e >> 1 ) & 1 ) << otherAxes[a][1] ) );
+    }
+  const auto edgeIndex = [&otherAxes](unsigned int c0, unsigned int c1) -> unsigned int
+    {
+    const unsigned int lo = std::min(c0, c1);
+    const unsigned int a = ( c0 ^ c1 ) == 1 ? 0 : ( ( c0 ^ c1 ) == 2 ? 1 : 2 );
+    return 4 * a + ( ( lo >> otherAxes[a][0] ) & 1 ) + 2 * ( ( lo >> otherAxes[a][1] ) & 1 );
+    };
+  // Two cube edges lie on a common face when they share the position along
+  // one of the axes they are orthogonal to.
+  const auto shareFace = [&table, &otherAxes](unsigned int e0, unsigned int e1) -> bool
+    {
+    for ( unsigned int i = 0; i < 2; ++i )
+      {
+      for ( unsigned int j = 0; j < 2; ++j )
+        {
+        const unsigned int axis = otherAxes[e0 / 4][i];
+        if ( axis == otherAxes[e1 / 4][j]
+             && ( ( table.EdgeCorners[e0] >> axis ) & 1 ) == ( ( table.EdgeCorners[e1] >> axis ) & 1 ) )
+          {
+          return true;
+          }
+        }
+      }
+    return false;
+    };
 
-  while ( i < 3 )
+  for ( unsigned int mask = 0; mask < 256; ++mask )
     {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
+    const auto inside = [mask](unsigned int c) -> bool { return ( ( mask >> c ) & 1 ) != 0; };
+
+    // On every face, walk the corners counterclockwise seen from outside of
+    // the cube and link each edge entering the object to the next edge
+    // leaving it.  Object corners that are diagonal on the face are thus
+    // separated, whatever the cube the face is seen from.
+    int next[12];
+    std::fill(next, next + 12, -1);
+    for ( unsigned int f = 0; f < 3; ++f )
       {
-      case 1:
-        break;
-      case 2:
-        x[i] = 4;
-        break;
-      case 3:
-        break;
-      case 4:
-        x[i] = 2;
-        break;
-      case 5:
-        break;
-      case 6:
-        x[i] = 8;
-        break;
-      case 7:
-        break;
-      case 8:
-        x[i] = 6;
-        break;
-      case 9:
-        x[i] = 10;
-        break;
-      case 10:
-        x[i] = 9;
-        break;
-      case 11:
-        x[i] = 12;
-        break;
-      case 12:
-        x[i] = 11;
-        break;
-      case 13:
-        break;
+      const unsigned int u = ( f + 1 ) % 3;
+      const unsigned int v = ( f + 2 ) % 3;
+      for ( unsigned int side = 0; side < 2; ++side )
+        {
+        unsigned int corners[4] = { 0u, 1u << u, ( 1u << u ) | ( 1u << v ), 1u << v };
+        if ( side == 0 )
+          {
+          std::swap(corners[1], corners[3]);
+          }
+        for ( unsigned int i = 0; i < 4; ++i )
+          {
+          corners[i] |= side << f;
+          }
+        for ( unsigned int i = 0; i < 4; ++i )
+          {
+          if ( inside( corners[i] ) || !inside( corners[( i + 1 ) % 4] ) )
+            {
+            continue;
+            }
+          unsigned int j = ( i + 1 ) % 4;
+          while ( !inside( corners[j] ) || inside( corners[( j + 1 ) % 4] ) )
+            {
+            j = ( j + 1 ) % 4;
+            }
+          next[edgeIndex( corners[i], corners[( i + 1 ) % 4] )] =
+            static_cast< int >( edgeIndex( corners[j], corners[( j + 1 ) % 4] ) );
+          }
+        }
       }
-    i++;
+
+    // Chain the segments into loops and triangulate every loop as a fan.
+    // The fan starts from a vertex none of whose diagonals lies on a cube
+    // face, otherwise the diagonal could also be generated by the cube on
+    // the other side of the face.
+    unsigned int numberOfTriangles = 0;
+    bool         visited[12] = { false };
+    for ( unsigned int e = 0; e < 12; ++e )
+      {
+      if ( next[e] < 0 || visited[e] )
+        {
+        continue;
+        }
+      unsigned int loop[12];
+      unsigned int n = 0;
+      for ( int k = static_cast< int >( e ); !visited[k]; k = next[k] )
+        {
+        visited[k] = true;
+        loop[n++] = static_cast< unsigned int >( k );
+        }
+      unsigned int start = 0;
+      for ( unsigned int s = 0; s < n; ++s )
+        {
+        bool valid = true;
+        for ( unsigned int k = 2; k + 1 < n && valid; ++k )
+          {
+          valid = !shareFace( loop[s], loop[( s + k ) % n] );
+          }
+        if ( valid )
+          {
+          start = s;
+          break;
+          }
+        }
+      for ( unsigned int k = 1; k + 1 < n; ++k )
+        {
+        unsigned char *triangle = table.Edges[mask] + 3 * numberOfTriangles++;
+        triangle[0] = static_cast< unsigned char >( loop[start] );
+        triangle[1] = static_cast< unsigned char >( loop[( start + k ) % n] );
+        triangle[2] = static_cast< unsigned char >( loop[( start + k + 1 ) % n] );
+        }
+      }
+    table.NumberOfTriangles[mask] = static_cast< unsigned char >( numberOfTriangles );
     }
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+typename BinaryMask3DMeshSource< TInputImage, TOutputMesh >::RegionType
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::YFlip(unsigned char *x)
+::ComputeExtractionRegion(const InputImageType *input) const
 {
-  unsigned char nodeindex;
-
-  int i = 0;
-
-  while ( i < 3 )
+  RegionType region = input->GetLargestPossibleRegion();
+  if ( m_RegionOfInterestProvidedByUser )
     {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
+    RegionType roi = m_RegionOfInterest;
+    if ( !roi.Crop( region ) )
       {
-      case 1:
-        x[i] = 3;
-        break;
-      case 2:
-        break;
-      case 3:
-        x[i] = 1;
-        break;
-      case 4:
-        break;
-      case 5:
-        x[i] = 7;
-        break;
-      case 6:
-        break;
-      case 7:
-        x[i] = 5;
-        break;
-      case 8:
-        break;
-      case 9:
-        x[i] = 12;
-        break;
-      case 10:
-        x[i] = 11;
-        break;
-      case 11:
-        x[i] = 10;
-        break;
-      case 12:
-        x[i] = 9;
-        break;
-      case 13:
-        break;
+      SizeType size;
+      size.Fill( 0 );
+      roi.SetSize(size);
       }
-    i++;
+    region = roi;
     }
+  return region;
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+typename BinaryMask3DMeshSource< TInputImage, TOutputMesh >::RegionType
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::ZFlip(unsigned char *x)
+::ComputeLayersInputRegion(SizeValueType begin, SizeValueType end) const
 {
-  unsigned char nodeindex;
-
-  int i = 0;
-
-  while ( i < 3 )
-    {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
-      {
-      case 1:
-        x[i] = 5;
-        break;
-      case 2:
-        x[i] = 6;
-        break;
-      case 3:
-        x[i] = 7;
-        break;
-      case 4:
-        x[i] = 8;
-        break;
-      case 5:
-        x[i] = 1;
-        break;
-      case 6:
-        x[i] = 2;
-        break;
-      case 7:
-        x[i] = 3;
-        break;
-      case 8:
-        x[i] = 4;
-        break;
-      case 9:
-        break;
-      case 10:
-        break;
-      case 11:
-        break;
-      case 12:
-        break;
-      case 13:
-        break;
-      }
-    i++;
-    }
+  // Layers [begin, end) use the padded slices [begin, end], that is the
+  // region slices [begin - 1, end - 1].
+  RegionType          region = m_ExtractionRegion;
+  const SizeValueType depth = region.GetSize(2);
+  const SizeValueType first = std::max< SizeValueType >( begin, 1 ) - 1;
+  const SizeValueType last = std::min< SizeValueType >( end, depth ) - 1;
+  region.SetIndex( 2, region.GetIndex(2) + static_cast< IndexValueType >( first ) );
+  region.SetSize( 2, last - first + 1 );
+  return region;
 }
 
 template< typename TInputImage, typename TOutputMesh >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::XRotation(unsigned char *x)
+::GenerateInputRequestedRegion()
 {
-  unsigned char nodeindex;
+  Superclass::GenerateInputRequestedRegion();
 
-  int i = 0;
+  auto * input = const_cast< InputImageType * >( this->GetInput() );
+  if ( !input )
+    {
+    return;
+    }
 
-  while ( i < 3 )
+  m_ExtractionRegion = this->ComputeExtractionRegion(input);
+  if ( m_ExtractionRegion.GetNumberOfPixels() == 0 )
     {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
-      {
-      case 1:
-        x[i] = 4;
-        break;
-      case 2:
-        x[i] = 1;
-        break;
-      case 3:
-        x[i] = 2;
-        break;
-      case 4:
-        x[i] = 3;
-        break;
-      case 5:
-        x[i] = 8;
-        break;
-      case 6:
-        x[i] = 5;
-        break;
-      case 7:
-        x[i] = 6;
-        break;
-      case 8:
-        x[i] = 7;
-        break;
-      case 9:
-        x[i] = 12;
-        break;
-      case 10:
-        x[i] = 9;
-        break;
-      case 11:
-        x[i] = 10;
-        break;
-      case 12:
-        x[i] = 11;
-        break;
-      case 13:
-        break;
-      }
-    i++;
+    return;
+    }
+  if ( m_NumberOfStreamDivisions > 1 )
+    {
+    const SizeValueType numberOfLayers = m_ExtractionRegion.GetSize(2) + 1;
+    const SizeValueType numberOfDivisions =
+      std::min< SizeValueType >( m_NumberOfStreamDivisions, numberOfLayers );
+    input->SetRequestedRegion( this->ComputeLayersInputRegion( 0, numberOfLayers / numberOfDivisions ) );
+    }
+  else
+    {
+    input->SetRequestedRegion( m_ExtractionRegion );
     }
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+typename BinaryMask3DMeshSource< TInputImage, TOutputMesh >::LabelIndexType
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::YRotation(unsigned char *x)
+::GetLabelIndex(const InputPixelType & value) const
 {
-  unsigned char nodeindex;
-
-  int i = 0;
-
-  while ( i < 3 )
+  for ( size_t i = 0; i < m_Labels.size(); ++i )
     {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
+    if ( value == m_Labels[i] )
       {
-      case 1:
-        x[i] = 9;
-        break;
-      case 2:
-        x[i] = 4;
-        break;
-      case 3:
-        x[i] = 12;
-        break;
-      case 4:
-        x[i] = 8;
-        break;
-      case 5:
-        x[i] = 10;
-        break;
-      case 6:
-        x[i] = 2;
-        break;
-      case 7:
-        x[i] = 11;
-        break;
-      case 8:
-        x[i] = 6;
-        break;
-      case 9:
-        x[i] = 5;
-        break;
-      case 10:
-        x[i] = 1;
-        break;
-      case 11:
-        x[i] = 3;
-        break;
-      case 12:
-        x[i] = 7;
-        break;
-      case 13:
-        break;
+      return static_cast< LabelIndexType >( i );
       }
-    i++;
     }
+  return NoLabel;
 }
 
 template< typename TInputImage, typename TOutputMesh >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::ZRotation(unsigned char *x)
+::FillLabelSlice(SizeValueType slice, LabelSliceType & labels) const
 {
-  unsigned char nodeindex;
+  const SizeValueType nx = m_PaddedSize[0];
+  const SizeValueType ny = m_PaddedSize[1];
+
+  labels.Labels.assign(nx * ny, NoLabel);
+  labels.RowBegin.assign(ny, nx);
+  labels.RowEnd.assign(ny, 0);
+  if ( slice == 0 || slice + 1 == m_PaddedSize[2] )
+    {
+    return;
+    }
 
-  int i = 0;
+  RegionType region = m_ExtractionRegion;
+  region.SetIndex( 2, region.GetIndex(2) + static_cast< IndexValueType >( slice ) - 1 );
+  region.SetSize( 2, 1 );
 
-  while ( i < 3 )
+  // Neighboring voxels mostly share their value, so the last lookup is
+  // remembered.
+  ImageScanlineConstIterator< InputImageType > it(m_InputImage, region);
+  InputPixelType lastValue = it.Get();
+  LabelIndexType lastLabel = this->GetLabelIndex(lastValue);
+  for ( SizeValueType y = 1; !it.IsAtEnd(); ++y )
     {
-    nodeindex = x[i];
-    switch ( (int)nodeindex )
+    LabelIndexType *row = labels.Labels.data() + y * nx;
+    SizeValueType   x = 1;
+    while ( !it.IsAtEndOfLine() )
       {
-      case 1:
-        x[i] = 3;
-        break;
-      case 2:
-        x[i] = 11;
-        break;
-      case 3:
-        x[i] = 7;
-        break;
-      case 4:
-        x[i] = 12;
-        break;
-      case 5:
-        x[i] = 1;
-        break;
-      case 6:
-        x[i] = 10;
-        break;
-      case 7:
-        x[i] = 5;
-        break;
-      case 8:
-        x[i] = 9;
-        break;
-      case 9:
-        x[i] = 4;
-        break;
-      case 10:
-        x[i] = 2;
-        break;
-      case 11:
-        x[i] = 6;
-        break;
-      case 12:
-        x[i] = 8;
-        break;
-      case 13:
-        break;
+      const InputPixelType value = it.Get();
+      if ( value != lastValue )
+        {
+        lastValue = value;
+        lastLabel = this->GetLabelIndex(value);
+        }
+      if ( lastLabel != NoLabel )
+        {
+        row[x] = lastLabel;
+        labels.RowBegin[y] = std::min(labels.RowBegin[y], x);
+        labels.RowEnd[y] = x + 1;
+        }
+      ++x;
+      ++it;
       }
-    i++;
+    it.NextLine();
     }
 }
 
 template< typename TInputImage, typename TOutputMesh >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::inverse(unsigned char *x)
-{
-  unsigned char tmp;
-
-  tmp = x[2];
-  x[2] = x[1];
-  x[1] = tmp;
-}
-
-template< typename TInputImage, typename TOutputMesh >
-void
-BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::InitializeLUT()
+::ComputeVertexPoint(SizeValueType x, SizeValueType y, SizeValueType slice,
+                     unsigned int axis, OPointType & point) const
 {
-  m_LUT[0][0] = 0;
-  m_LUT[1][0] = 1;
-  m_LUT[2][0] = 1;
-  m_LUT[3][0] = 2;
-  m_LUT[4][0] = 1;
-  m_LUT[5][0] = 3;
-  m_LUT[6][0] = 2;
-  m_LUT[7][0] = 5;
-  m_LUT[8][0] = 1;
-  m_LUT[9][0] = 2;
-  m_LUT[10][0] = 3;
-  m_LUT[11][0] = 5;
-  m_LUT[12][0] = 2;
-  m_LUT[13][0] = 5;
-  m_LUT[14][0] = 5;
-  m_LUT[15][0] = 8;
-  m_LUT[16][0] = 1;
-  m_LUT[17][0] = 2;
-  m_LUT[18][0] = 3;
-  m_LUT[19][0] = 5;
-  m_LUT[20][0] = 4;
-  m_LUT[21][0] = 6;
-  m_LUT[22][0] = 6;
-  m_LUT[23][0] = 11;
-  m_LUT[24][0] = 3;
-  m_LUT[25][0] = 5;
-  m_LUT[26][0] = 7;
-  m_LUT[27][0] = 9;
-  m_LUT[28][0] = 6;
-  m_LUT[29][0] = 11;
-  m_LUT[30][0] = 12;
-  m_LUT[31][0] = 5;
-  m_LUT[32][0] = 1;
-  m_LUT[33][0] = 3;
-  m_LUT[34][0] = 2;
-  m_LUT[35][0] = 5;
-  m_LUT[36][0] = 3;
-  m_LUT[37][0] = 7;
-  m_LUT[38][0] = 5;
-  m_LUT[39][0] = 9;
-  m_LUT[40][0] = 4;
-  m_LUT[41][0] = 6;
-  m_LUT[42][0] = 6;
-  m_LUT[43][0] = 11;
-  m_LUT[44][0] = 6;
-  m_LUT[45][0] = 12;
-  m_LUT[46][0] = 11;
-  m_LUT[47][0] = 5;
-  m_LUT[48][0] = 2;
-  m_LUT[49][0] = 5;
-  m_LUT[50][0] = 5;
-  m_LUT[51][0] = 8;
-  m_LUT[52][0] = 6;
-  m_LUT[53][0] = 12;
-  m_LUT[54][0] = 11;
-  m_LUT[55][0] = 5;
-  m_LUT[56][0] = 6;
-  m_LUT[57][0] = 11;
-  m_LUT[58][0] = 12;
-  m_LUT[59][0] = 5;
-  m_LUT[60][0] = 10;
-  m_LUT[61][0] = 16;
-  m_LUT[62][0] = 16;
-  m_LUT[63][0] = 2;
-  m_LUT[64][0] = 1;
-  m_LUT[65][0] = 4;
-  m_LUT[66][0] = 3;
-  m_LUT[67][0] = 6;
-  m_LUT[68][0] = 2;
-  m_LUT[69][0] = 6;
-  m_LUT[70][0] = 5;
-  m_LUT[71][0] = 11;
-  m_LUT[72][0] = 3;
-  m_LUT[73][0] = 6;
-  m_LUT[74][0] = 7;
-  m_LUT[75][0] = 12;
-  m_LUT[76][0] = 5;
-  m_LUT[77][0] = 11;
-  m_LUT[78][0] = 9;
-  m_LUT[79][0] = 5;
-  m_LUT[80][0] = 3;
-  m_LUT[81][0] = 6;
-  m_LUT[82][0] = 7;
-  m_LUT[83][0] = 12;
-  m_LUT[84][0] = 6;
-  m_LUT[85][0] = 10;
-  m_LUT[86][0] = 12;
-  m_LUT[87][0] = 16;
-  m_LUT[88][0] = 7;
-  m_LUT[89][0] = 12;
-  m_LUT[90][0] = 13;
-  m_LUT[91][0] = 14;
-  m_LUT[92][0] = 12;
-  m_LUT[93][0] = 16;
-  m_LUT[94][0] = 14;
-  m_LUT[95][0] = 15;
-  m_LUT[96][0] = 2;
-  m_LUT[97][0] = 6;
-  m_LUT[98][0] = 5;
-  m_LUT[99][0] = 11;
-  m_LUT[100][0] = 5;
-  m_LUT[101][0] = 12;
-  m_LUT[102][0] = 8;
-  m_LUT[103][0] = 5;
-  m_LUT[104][0] = 6;
-  m_LUT[105][0] = 10;
-  m_LUT[106][0] = 12;
-  m_LUT[107][0] = 16;
-  m_LUT[108][0] = 11;
-  m_LUT[109][0] = 16;
-  m_LUT[110][0] = 5;
-  m_LUT[111][0] = 2;
-  m_LUT[112][0] = 5;
-  m_LUT[113][0] = 11;
-  m_LUT[114][0] = 9;
-  m_LUT[115][0] = 5;
-  m_LUT[116][0] = 11;
-  m_LUT[117][0] = 16;
-  m_LUT[118][0] = 5;
-  m_LUT[119][0] = 2;
-  m_LUT[120][0] = 12;
-  m_LUT[121][0] = 16;
-  m_LUT[122][0] = 14;
-  m_LUT[123][0] = 15;
-  m_LUT[124][0] = 16;
-  m_LUT[125][0] = 4;
-  m_LUT[126][0] = 15;
-  m_LUT[127][0] = 1;
-  m_LUT[128][0] = 1;
-  m_LUT[129][0] = 3;
-  m_LUT[130][0] = 4;
-  m_LUT[131][0] = 6;
-  m_LUT[132][0] = 3;
-  m_LUT[133][0] = 7;
-  m_LUT[134][0] = 6;
-  m_LUT[135][0] = 12;
-  m_LUT[136][0] = 2;
-  m_LUT[137][0] = 5;
-  m_LUT[138][0] = 6;
-  m_LUT[139][0] = 11;
-  m_LUT[140][0] = 5;
-  m_LUT[141][0] = 9;
-  m_LUT[142][0] = 11;
-  m_LUT[143][0] = 5;
-  m_LUT[144][0] = 2;
-  m_LUT[145][0] = 5;
-  m_LUT[146][0] = 6;
-  m_LUT[147][0] = 11;
-  m_LUT[148][0] = 6;
-  m_LUT[149][0] = 12;
-  m_LUT[150][0] = 10;
-  m_LUT[151][0] = 16;
-  m_LUT[152][0] = 5;
-  m_LUT[153][0] = 8;
-  m_LUT[154][0] = 12;
-  m_LUT[155][0] = 5;
-  m_LUT[156][0] = 11;
-  m_LUT[157][0] = 5;
-  m_LUT[158][0] = 16;
-  m_LUT[159][0] = 2;
-  m_LUT[160][0] = 3;
-  m_LUT[161][0] = 7;
-  m_LUT[162][0] = 6;
-  m_LUT[163][0] = 12;
-  m_LUT[164][0] = 7;
-  m_LUT[165][0] = 13;
-  m_LUT[166][0] = 12;
-  m_LUT[167][0] = 14;
-  m_LUT[168][0] = 6;
-  m_LUT[169][0] = 12;
-  m_LUT[170][0] = 10;
-  m_LUT[171][0] = 16;
-  m_LUT[172][0] = 12;
-  m_LUT[173][0] = 14;
-  m_LUT[174][0] = 16;
-  m_LUT[175][0] = 15;
-  m_LUT[176][0] = 5;
-  m_LUT[177][0] = 9;
-  m_LUT[178][0] = 11;
-  m_LUT[179][0] = 5;
-  m_LUT[180][0] = 12;
-  m_LUT[181][0] = 14;
-  m_LUT[182][0] = 16;
-  m_LUT[183][0] = 15;
-  m_LUT[184][0] = 11;
-  m_LUT[185][0] = 5;
-  m_LUT[186][0] = 16;
-  m_LUT[187][0] = 2;
-  m_LUT[188][0] = 16;
-  m_LUT[189][0] = 15;
-  m_LUT[190][0] = 4;
-  m_LUT[191][0] = 1;
-  m_LUT[192][0] = 2;
-  m_LUT[193][0] = 6;
-  m_LUT[194][0] = 6;
-  m_LUT[195][0] = 10;
-  m_LUT[196][0] = 5;
-  m_LUT[197][0] = 12;
-  m_LUT[198][0] = 11;
-  m_LUT[199][0] = 16;
-  m_LUT[200][0] = 5;
-  m_LUT[201][0] = 11;
-  m_LUT[202][0] = 12;
-  m_LUT[203][0] = 16;
-  m_LUT[204][0] = 8;
-  m_LUT[205][0] = 5;
-  m_LUT[206][0] = 5;
-  m_LUT[207][0] = 2;
-  m_LUT[208][0] = 5;
-  m_LUT[209][0] = 11;
-  m_LUT[210][0] = 12;
-  m_LUT[211][0] = 16;
-  m_LUT[212][0] = 11;
-  m_LUT[213][0] = 16;
-  m_LUT[214][0] = 16;
-  m_LUT[215][0] = 4;
-  m_LUT[216][0] = 9;
-  m_LUT[217][0] = 5;
-  m_LUT[218][0] = 14;
-  m_LUT[219][0] = 15;
-  m_LUT[220][0] = 5;
-  m_LUT[221][0] = 2;
-  m_LUT[222][0] = 15;
-  m_LUT[223][0] = 1;
-  m_LUT[224][0] = 5;
-  m_LUT[225][0] = 12;
-  m_LUT[226][0] = 11;
-  m_LUT[227][0] = 16;
-  m_LUT[228][0] = 9;
-  m_LUT[229][0] = 14;
-  m_LUT[230][0] = 5;
-  m_LUT[231][0] = 15;
-  m_LUT[232][0] = 11;
-  m_LUT[233][0] = 16;
-  m_LUT[234][0] = 16;
-  m_LUT[235][0] = 4;
-  m_LUT[236][0] = 5;
-  m_LUT[237][0] = 15;
-  m_LUT[238][0] = 2;
-  m_LUT[239][0] = 1;
-  m_LUT[240][0] = 8;
-  m_LUT[241][0] = 5;
-  m_LUT[242][0] = 5;
-  m_LUT[243][0] = 2;
-  m_LUT[244][0] = 5;
-  m_LUT[245][0] = 15;
-  m_LUT[246][0] = 2;
-  m_LUT[247][0] = 1;
-  m_LUT[248][0] = 5;
-  m_LUT[249][0] = 2;
-  m_LUT[250][0] = 15;
-  m_LUT[251][0] = 1;
-  m_LUT[252][0] = 2;
-  m_LUT[253][0] = 1;
-  m_LUT[254][0] = 1;
-  m_LUT[255][0] = 0;
-  m_LUT[0][1] = 0;
-  m_LUT[1][1] = 0;
-  m_LUT[2][1] = 4;
-  m_LUT[3][1] = 0;
-  m_LUT[4][1] = 6;
-  m_LUT[5][1] = 0;
-  m_LUT[6][1] = 34;
-  m_LUT[7][1] = 8;
-  m_LUT[8][1] = 2;
-  m_LUT[9][1] = 32;
-  m_LUT[10][1] = 2;
-  m_LUT[11][1] = 12;
-  m_LUT[12][1] = 2;
-  m_LUT[13][1] = 13;
-  m_LUT[14][1] = 9;
-  m_LUT[15][1] = 8;
-  m_LUT[16][1] = 1;
-  m_LUT[17][1] = 16;
-  m_LUT[18][1] = 11;
-  m_LUT[19][1] = 5;
-  m_LUT[20][1] = 1;
-  m_LUT[21][1] = 16;
-  m_LUT[22][1] = 34;
-  m_LUT[23][1] = 1;
-  m_LUT[24][1] = 16;
-  m_LUT[25][1] = 24;
-  m_LUT[26][1] = 6;
-  m_LUT[27][1] = 1;
-  m_LUT[28][1] = 6;
-  m_LUT[29][1] = 37;
-  m_LUT[30][1] = 9;
-  m_LUT[31][1] = 75;
-  m_LUT[32][1] = 5;
-  m_LUT[33][1] = 9;
-  m_LUT[34][1] = 17;
-  m_LUT[35][1] = 1;
-  m_LUT[36][1] = 17;
-  m_LUT[37][1] = 2;
-  m_LUT[38][1] = 26;
-  m_LUT[39][1] = 5;
-  m_LUT[40][1] = 2;
-  m_LUT[41][1] = 32;
-  m_LUT[42][1] = 17;
-  m_LUT[43][1] = 5;
-  m_LUT[44][1] = 2;
-  m_LUT[45][1] = 13;
-  m_LUT[46][1] = 39;
-  m_LUT[47][1] = 79;
-  m_LUT[48][1] = 1;
-  m_LUT[49][1] = 4;
-  m_LUT[50][1] = 0;
-  m_LUT[51][1] = 0;
-  m_LUT[52][1] = 1;
-  m_LUT[53][1] = 4;
-  m_LUT[54][1] = 16;
-  m_LUT[55][1] = 70;
-  m_LUT[56][1] = 5;
-  m_LUT[57][1] = 17;
-  m_LUT[58][1] = 0;
-  m_LUT[59][1] = 66;
-  m_LUT[60][1] = 25;
-  m_LUT[61][1] = 23;
-  m_LUT[62][1] = 22;
-  m_LUT[63][1] = 67;
-  m_LUT[64][1] = 7;
-  m_LUT[65][1] = 0;
-  m_LUT[66][1] = 19;
-  m_LUT[67][1] = 0;
-  m_LUT[68][1] = 19;
-  m_LUT[69][1] = 19;
-  m_LUT[70][1] = 27;
-  m_LUT[71][1] = 35;
-  m_LUT[72][1] = 8;
-  m_LUT[73][1] = 36;
-  m_LUT[74][1] = 0;
-  m_LUT[75][1] = 12;
-  m_LUT[76][1] = 3;
-  m_LUT[77][1] = 7;
-  m_LUT[78][1] = 7;
-  m_LUT[79][1] = 78;
-  m_LUT[80][1] = 1;
-  m_LUT[81][1] = 20;
-  m_LUT[82][1] = 3;
-  m_LUT[83][1] = 5;
-  m_LUT[84][1] = 23;
-  m_LUT[85][1] = 9;
-  m_LUT[86][1] = 27;
-  m_LUT[87][1] = 7;
-  m_LUT[88][1] = 5;
-  m_LUT[89][1] = 24;
-  m_LUT[90][1] = 1;
-  m_LUT[91][1] = 1;
-  m_LUT[92][1] = 3;
-  m_LUT[93][1] = 1;
-  m_LUT[94][1] = 7;
-  m_LUT[95][1] = 1;
-  m_LUT[96][1] = 35;
-  m_LUT[97][1] = 35;
-  m_LUT[98][1] = 30;
-  m_LUT[99][1] = 20;
-  m_LUT[100][1] = 31;
-  m_LUT[101][1] = 31;
-  m_LUT[102][1] = 26;
-  m_LUT[103][1] = 93;
-  m_LUT[104][1] = 39;
-  m_LUT[105][1] = 0;
-  m_LUT[106][1] = 30;
-  m_LUT[107][1] = 14;
-  m_LUT[108][1] = 22;
-  m_LUT[109][1] = 15;
-  m_LUT[110][1] = 92;
-  m_LUT[111][1] = 97;
-  m_LUT[112][1] = 10;
-  m_LUT[113][1] = 0;
-  m_LUT[114][1] = 4;
-  m_LUT[115][1] = 71;
-  m_LUT[116][1] = 34;
-  m_LUT[117][1] = 6;
-  m_LUT[118][1] = 89;
-  m_LUT[119][1] = 82;
-  m_LUT[120][1] = 10;
-  m_LUT[121][1] = 8;
-  m_LUT[122][1] = 4;
-  m_LUT[123][1] = 8;
-  m_LUT[124][1] = 16;
-  m_LUT[125][1] = 67;
-  m_LUT[126][1] = 16;
-  m_LUT[127][1] = 67;
-  m_LUT[128][1] = 3;
-  m_LUT[129][1] = 18;
-  m_LUT[130][1] = 3;
-  m_LUT[131][1] = 4;
-  m_LUT[132][1] = 10;
-  m_LUT[133][1] = 4;
-  m_LUT[134][1] = 38;
-  m_LUT[135][1] = 8;
-  m_LUT[136][1] = 18;
-  m_LUT[137][1] = 25;
-  m_LUT[138][1] = 18;
-  m_LUT[139][1] = 33;
-  m_LUT[140][1] = 7;
-  m_LUT[141][1] = 3;
-  m_LUT[142][1] = 3;
-  m_LUT[143][1] = 74;
-  m_LUT[144][1] = 33;
-  m_LUT[145][1] = 28;
-  m_LUT[146][1] = 33;
-  m_LUT[147][1] = 21;
-  m_LUT[148][1] = 37;
-  m_LUT[149][1] = 28;
-  m_LUT[150][1] = 1;
-  m_LUT[151][1] = 10;
-  m_LUT[152][1] = 29;
-  m_LUT[153][1] = 24;
-  m_LUT[154][1] = 29;
-  m_LUT[155][1] = 95;
-  m_LUT[156][1] = 23;
-  m_LUT[157][1] = 94;
-  m_LUT[158][1] = 11;
-  m_LUT[159][1] = 99;
-  m_LUT[160][1] = 3;
-  m_LUT[161][1] = 7;
-  m_LUT[162][1] = 21;
-  m_LUT[163][1] = 1;
-  m_LUT[164][1] = 1;
-  m_LUT[165][1] = 0;
-  m_LUT[166][1] = 26;
-  m_LUT[167][1] = 5;
-  m_LUT[168][1] = 22;
-  m_LUT[169][1] = 25;
-  m_LUT[170][1] = 8;
-  m_LUT[171][1] = 3;
-  m_LUT[172][1] = 7;
-  m_LUT[173][1] = 3;
-  m_LUT[174][1] = 5;
-  m_LUT[175][1] = 3;
-  m_LUT[176][1] = 14;
-  m_LUT[177][1] = 0;
-  m_LUT[178][1] = 4;
-  m_LUT[179][1] = 67;
-  m_LUT[180][1] = 14;
-  m_LUT[181][1] = 0;
-  m_LUT[182][1] = 12;
-  m_LUT[183][1] = 10;
-  m_LUT[184][1] = 32;
-  m_LUT[185][1] = 91;
-  m_LUT[186][1] = 2;
-  m_LUT[187][1] = 83;
-  m_LUT[188][1] = 17;
-  m_LUT[189][1] = 17;
-  m_LUT[190][1] = 64;
-  m_LUT[191][1] = 71;
-  m_LUT[192][1] = 3;
-  m_LUT[193][1] = 7;
-  m_LUT[194][1] = 3;
-  m_LUT[195][1] = 24;
-  m_LUT[196][1] = 2;
-  m_LUT[197][1] = 2;
-  m_LUT[198][1] = 18;
-  m_LUT[199][1] = 20;
-  m_LUT[200][1] = 6;
-  m_LUT[201][1] = 19;
-  m_LUT[202][1] = 6;
-  m_LUT[203][1] = 21;
-  m_LUT[204][1] = 2;
-  m_LUT[205][1] = 64;
-  m_LUT[206][1] = 68;
-  m_LUT[207][1] = 65;
-  m_LUT[208][1] = 15;
-  m_LUT[209][1] = 36;
-  m_LUT[210][1] = 15;
-  m_LUT[211][1] = 19;
-  m_LUT[212][1] = 6;
-  m_LUT[213][1] = 0;
-  m_LUT[214][1] = 13;
-  m_LUT[215][1] = 66;
-  m_LUT[216][1] = 2;
-  m_LUT[217][1] = 90;
-  m_LUT[218][1] = 2;
-  m_LUT[219][1] = 19;
-  m_LUT[220][1] = 65;
-  m_LUT[221][1] = 81;
-  m_LUT[222][1] = 11;
-  m_LUT[223][1] = 69;
-  m_LUT[224][1] = 11;
-  m_LUT[225][1] = 11;
-  m_LUT[226][1] = 38;
-  m_LUT[227][1] = 18;
-  m_LUT[228][1] = 6;
-  m_LUT[229][1] = 6;
-  m_LUT[230][1] = 88;
-  m_LUT[231][1] = 18;
-  m_LUT[232][1] = 2;
-  m_LUT[233][1] = 9;
-  m_LUT[234][1] = 4;
-  m_LUT[235][1] = 65;
-  m_LUT[236][1] = 69;
-  m_LUT[237][1] = 9;
-  m_LUT[238][1] = 80;
-  m_LUT[239][1] = 65;
-  m_LUT[240][1] = 10;
-  m_LUT[241][1] = 73;
-  m_LUT[242][1] = 77;
-  m_LUT[243][1] = 66;
-  m_LUT[244][1] = 76;
-  m_LUT[245][1] = 0;
-  m_LUT[246][1] = 96;
-  m_LUT[247][1] = 66;
-  m_LUT[248][1] = 72;
-  m_LUT[249][1] = 98;
-  m_LUT[250][1] = 2;
-  m_LUT[251][1] = 70;
-  m_LUT[252][1] = 64;
-  m_LUT[253][1] = 68;
-  m_LUT[254][1] = 64;
-  m_LUT[255][1] = 0;
-
-  m_LocationOffset[1][0] = 0.5;
-  m_LocationOffset[2][0] = 1;
-  m_LocationOffset[3][0] = 0.5;
-  m_LocationOffset[4][0] = 0;
-  m_LocationOffset[5][0] = 0.5;
-  m_LocationOffset[6][0] = 1;
-  m_LocationOffset[7][0] = 0.5;
-  m_LocationOffset[8][0] = 0;
-  m_LocationOffset[9][0] = 0;
-  m_LocationOffset[10][0] = 1;
-  m_LocationOffset[11][0] = 1;
-  m_LocationOffset[12][0] = 0;
-  m_LocationOffset[13][0] = 0.5;
-  m_LocationOffset[1][1] = 0;
-  m_LocationOffset[2][1] = 0.5;
-  m_LocationOffset[3][1] = 1;
-  m_LocationOffset[4][1] = 0.5;
-  m_LocationOffset[5][1] = 0;
-  m_LocationOffset[6][1] = 0.5;
-  m_LocationOffset[7][1] = 1;
-  m_LocationOffset[8][1] = 0.5;
-  m_LocationOffset[9][1] = 0;
-  m_LocationOffset[10][1] = 0;
-  m_LocationOffset[11][1] = 1;
-  m_LocationOffset[12][1] = 1;
-  m_LocationOffset[13][1] = 0.5;
-  m_LocationOffset[1][2] = 0;
-  m_LocationOffset[2][2] = 0;
-  m_LocationOffset[3][2] = 0;
-  m_LocationOffset[4][2] = 0;
-  m_LocationOffset[5][2] = 1;
-  m_LocationOffset[6][2] = 1;
-  m_LocationOffset[7][2] = 1;
-  m_LocationOffset[8][2] = 1;
-  m_LocationOffset[9][2] = 0.5;
-  m_LocationOffset[10][2] = 0.5;
-  m_LocationOffset[11][2] = 0.5;
-  m_LocationOffset[12][2] = 0.5;
-  m_LocationOffset[13][2] = 0.5;
+  ContinuousIndex< double, 3 > index;
+  index[0] = static_cast< double >( m_ExtractionRegion.GetIndex(0) ) + static_cast< double >( x ) - 1.0;
+  index[1] = static_cast< double >( m_ExtractionRegion.GetIndex(1) ) + static_cast< double >( y ) - 1.0;
+  index[2] = static_cast< double >( m_ExtractionRegion.GetIndex(2) ) + static_cast< double >( slice ) - 1.0;
+  index[axis] += 0.5;
+  m_InputImage->TransformContinuousIndexToPhysicalPoint(index, point);
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+IdentifierType
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::CreateMesh()
+::NumberSliceEdges(SizeValueType slice, const LabelSliceType & labels,
+                   IdentifierType id, IdentifierSliceType *ids, bool writePoints)
 {
-  // NOTE ALEX: this is checked by the new pipeline
-  // through SetNumberOfRequiredInput
-  // if (this->GetNumberOfInputs() < 1)
-  //  {
-  //  std::cout << "BinaryMask3DMeshSource : Binary image mask not set";
-  //  std::cout << std::endl;
-  //  return;
-  //  }
-
-  // Initialize variables
-  m_NumberOfCells = 0;
-  m_NumberOfNodes = 0;
-  m_NodeLimit = 2000;
-  m_CellLimit = 4000;
-  m_LastRowIndex = 0;
-  m_LastVoxelIndex = 0;
-  m_LastFrameIndex = 0;
-  m_CurrentRowIndex = 0;
-  m_CurrentFrameIndex = 0;
-  m_CurrentFrame = nullptr;
-  m_CurrentRow = nullptr;
-  m_LastRow = nullptr;
-  m_LastRowNum = 0;
-  m_LastFrameNum = 0;
-  m_LastFrame = nullptr;
-  m_CurrentRowNum = 200;
-  m_CurrentFrameNum = 2000;
-  m_OutputMesh = this->GetOutput();
-  m_InputImage = this->GetInput();
-  m_InputImage =
-    static_cast< const InputImageType * >( this->ProcessObject::GetInput(0) );
-
-  InputImageIterator it1( m_InputImage, m_RegionOfInterest );
-  InputImageIterator it2( m_InputImage, m_RegionOfInterest );
-  InputImageIterator it3( m_InputImage, m_RegionOfInterest );
-  InputImageIterator it4( m_InputImage, m_RegionOfInterest );
-
-  it1.GoToBegin();
-  it2.GoToBegin();
-  it3.GoToBegin();
-  it4.GoToBegin();
-
-  InputImageSizeType inputImageSize = m_RegionOfInterest.GetSize();
-  m_ImageWidth  = inputImageSize[0];
-  m_ImageHeight = inputImageSize[1];
-  m_ImageDepth  = inputImageSize[2];
-  int frame = m_ImageWidth * m_ImageHeight;
-  int row = m_ImageWidth;
-
-  int i = 0;
-  int j;
-
-  while ( i < frame )
-    {
-    ++it3;
-    ++it4;
-    i++;
-    }
-
-  i = 0;
-
-  while ( i < row )
-    {
-    ++it2;
-    ++it4;
-    i++;
-    }
-
-  unsigned char vertexindex;
-
-  if ( m_CurrentRow )
-    {
-    for ( i = 0; i < 200; i++ )
-      {
-      free(m_CurrentRow[i]);
-      }
-    free (m_CurrentRow);
-    }
-  m_CurrentRow = (IdentifierType **)malloc( 200 * sizeof( IdentifierType * ) );
-  for ( i = 0; i < 200; i++ )
-    {
-    m_CurrentRow[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
-    }
-
-  if ( m_CurrentFrame )
-    {
-    for ( i = 0; i < 2000; i++ )
-      {
-      free(m_CurrentFrame[i]);
-      }
-    free (m_CurrentFrame);
-    }
+  // An edge between two different labels gets one vertex per object label,
+  // the one of its first end first.  ids holds the identifier of the first
+  // vertex of each edge, at 2 * voxel + axis.  Only the voxels next to the
+  // object voxels of a row and of the next row can have cut edges.
+  const SizeValueType nx = m_PaddedSize[0];
+  const SizeValueType ny = m_PaddedSize[1];
 
-  m_CurrentFrame = (IdentifierType **)malloc( 2000 * sizeof( IdentifierType * ) );
-
-  for ( i = 0; i < 2000; i++ )
-    {
-    m_CurrentFrame[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
-    }
-
-  i = 0;
-
-  while ( !it4.IsAtEnd() )
+  for ( SizeValueType y = 0; y < ny; ++y )
     {
-    vertexindex = 0;
-
-    if ( Math::ExactlyEquals(it1.Value(), m_ObjectValue) ) { vertexindex += 1; }
-    if ( Math::ExactlyEquals(it2.Value(), m_ObjectValue) ) { vertexindex += 8; }
-    if ( Math::ExactlyEquals(it3.Value(), m_ObjectValue) ) { vertexindex += 16; }
-    if ( Math::ExactlyEquals(it4.Value(), m_ObjectValue) ) { vertexindex += 128; }
-    ++it1;
-    ++it2;
-    ++it3;
-    ++it4;
-
-    if ( ( i % m_ImageWidth < m_ImageWidth - 1 )
-         && ( ( i % ( m_ImageWidth * m_ImageHeight ) ) / m_ImageWidth < m_ImageHeight - 1 ) )
+    SizeValueType begin = labels.RowBegin[y];
+    SizeValueType end = labels.RowEnd[y];
+    if ( y + 1 < ny )
       {
-      if ( Math::ExactlyEquals(it1.Value(), m_ObjectValue) ) { vertexindex += 2; }
-      if ( Math::ExactlyEquals(it2.Value(), m_ObjectValue) ) { vertexindex += 4; }
-      if ( Math::ExactlyEquals(it3.Value(), m_ObjectValue) ) { vertexindex += 32; }
-      if ( Math::ExactlyEquals(it4.Value(), m_ObjectValue) ) { vertexindex += 64; }
+      begin = std::min(begin, labels.RowBegin[y + 1]);
+      end = std::max(end, labels.RowEnd[y + 1]);
       }
-    else
+    for ( SizeValueType x = begin - 1; x < end; ++x )
       {
-      if ( ( i % ( m_ImageWidth * m_ImageHeight ) ) / m_ImageWidth == m_ImageHeight - 1 )
+      const SizeValueType  i = y * nx + x;
+      const LabelIndexType label = labels.Labels[i];
+      for ( unsigned int axis = 0; axis < 2; ++axis )
         {
-        if ( vertexindex > 50 ) { vertexindex -= 128; }
-        if ( ( ( vertexindex > 7 ) && ( vertexindex < 10 ) ) || ( vertexindex > 17 ) ) { vertexindex -= 8; }
-        if ( Math::ExactlyEquals(it1.Value(), m_ObjectValue) ) { vertexindex += 2; }
-        if ( Math::ExactlyEquals(it3.Value(), m_ObjectValue) ) { vertexindex += 32; }
+        if ( axis == 1 && y + 1 == ny )
+          {
+          continue;
+          }
+        const LabelIndexType other = labels.Labels[axis == 0 ? i + 1 : i + nx];
+        if ( label == other )
+          {
+          continue;
+          }
+        if ( ids )
+          {
+          ( *ids )[2 * i + axis] = id;
+          }
+        const IdentifierType count = ( label != NoLabel ? 1 : 0 ) + ( other != NoLabel ? 1 : 0 );
+        if ( writePoints )
+          {
+          this->ComputeVertexPoint(x, y, slice, axis, m_Points[id]);
+          if ( count == 2 )
+            {
+            m_Points[id + 1] = m_Points[id];
+            }
+          }
+        id += count;
         }
       }
-
-    for ( j = 0; j < 14; j++ )
-      {
-      m_CurrentVoxel[j] = 0;
-      }
-
-    if ( ( vertexindex == 0 ) || ( vertexindex == 255 ) )
-      {
-//      for ( j=0; j<13; j++ ) m_LastVoxel[j] = 0;
-      }
-    else
-      {
-      this->AddCells(m_LUT[vertexindex][0], m_LUT[vertexindex][1], i);
-      }
-    i++;
     }
-
-  // This indicates that the current BufferedRegion is equal to the
-  // requested region. This action prevents useless rexecutions of
-  // the pipeline.
-  this->m_OutputMesh->SetBufferedRegion( this->GetOutput()->GetRequestedRegion() );
+  return id;
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+IdentifierType
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::AddCells(unsigned char celltype, unsigned char celltran, int index)
+::NumberLayerEdges(SizeValueType layer, const LabelSliceType & bottom,
+                   const LabelSliceType & top, IdentifierType id,
+                   IdentifierSliceType *ids, bool writePoints)
 {
+  const SizeValueType nx = m_PaddedSize[0];
+  const SizeValueType ny = m_PaddedSize[1];
 
-  int             i;
-  IdentifierType **currentrowtmp;
-  IdentifierType **currentframetmp;
-
-  currentrowtmp = (IdentifierType **)malloc( 4 * sizeof( IdentifierType * ) );
-  for ( i = 0; i < 4; i++ )
+  for ( SizeValueType y = 0; y < ny; ++y )
     {
-    currentrowtmp[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
-    currentrowtmp[i][0] = 0;
-    currentrowtmp[i][1] = 0;
-    }
-  currentframetmp = (IdentifierType **)malloc( 4 * sizeof( IdentifierType * ) );
-  for ( i = 0; i < 4; i++ )
-    {
-    currentframetmp[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
-    currentframetmp[i][0] = 0;
-    currentframetmp[i][1] = 0;
-    }
-
-  if ( ( index % m_ImageWidth == 0 ) || ( index > m_LastVoxelIndex + 1 ) )
-    {
-    m_ColFlag = 0;
-    for ( i = 0; i < 14; i++ )
+    const SizeValueType begin = std::min(bottom.RowBegin[y], top.RowBegin[y]);
+    const SizeValueType end = std::max(bottom.RowEnd[y], top.RowEnd[y]);
+    for ( SizeValueType x = begin; x < end; ++x )
       {
-      m_LastVoxel[i] = 0;
-      }
-    }
-  else
-    {
-    m_ColFlag = 1;
-    }
-
-  if ( ( ( index % ( m_ImageWidth * m_ImageHeight ) ) < m_ImageWidth )
-       || ( ( index /  m_ImageWidth ) > m_LastRowIndex + 1 ) )
-    {
-    m_RowFlag = 0;
-    }
-  else
-    {
-    m_RowFlag = 1;
-    }
-
-  if ( ( index <  m_ImageWidth * m_ImageHeight )
-       || ( ( index / ( m_ImageWidth * m_ImageHeight ) ) > m_LastFrameIndex + 1 ) )
-    {
-    m_FrameFlag = 0;
-    }
-  else
-    {
-    m_FrameFlag = 1;
-    }
-
-  /** allocate memory */
-  if ( m_RowFlag == 1 )
-    {
-    if ( ( index / m_ImageWidth ) != m_LastRowIndex )
-      {
-      if ( m_LastRowNum == 0 )
+      const SizeValueType i = y * nx + x;
+      if ( bottom.Labels[i] == top.Labels[i] )
         {
-        m_LastRow = (IdentifierType **)malloc( m_CurrentRowIndex * sizeof( IdentifierType * ) );
+        continue;
         }
-      else
+      if ( ids )
         {
-        if ( m_LastRowNum >  m_CurrentRowIndex )
-          {
-          for ( i = m_CurrentRowIndex; i < m_LastRowNum; i++ )
-            {
-            free(m_LastRow[i]);
-            }
-          }
-        m_LastRow = (IdentifierType **)realloc( m_LastRow, m_CurrentRowIndex * sizeof( IdentifierType * ) );
+        ( *ids )[i] = id;
         }
-      for ( i = 0; i < m_CurrentRowIndex; i++ )
+      const IdentifierType count = ( bottom.Labels[i] != NoLabel ? 1 : 0 ) + ( top.Labels[i] != NoLabel ? 1 : 0 );
+      if ( writePoints )
         {
-        if ( i > m_LastRowNum - 1 )
+        this->ComputeVertexPoint(x, y, layer, 2, m_Points[id]);
+        if ( count == 2 )
           {
-          m_LastRow[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
+          m_Points[id + 1] = m_Points[id];
           }
-        m_LastRow[i][0] = m_CurrentRow[i][0];
-        m_LastRow[i][1] = m_CurrentRow[i][1];
         }
-      m_LastRowNum = m_CurrentRowIndex;
-      m_CurrentRowIndex = 0;
+      id += count;
       }
     }
-  else
-    {
-    if ( m_ColFlag == 0 )
-      {
-      if ( m_LastRowNum > 0 )
+  return id;
+}
+
+template< typename TInputImage, typename TOutputMesh >
+SizeValueType
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::CountLayerTriangles(const LabelSliceType & bottom, const LabelSliceType & top) const
+{
+  const CaseTable &   table = GetCaseTable();
+  const SizeValueType nx = m_PaddedSize[0];
+  const SizeValueType ny = m_PaddedSize[1];
+  const LabelIndexType *b = bottom.Labels.data();
+  const LabelIndexType *t = top.Labels.data();
+
+  SizeValueType count = 0;
+  for ( SizeValueType y = 0; y + 1 < ny; ++y )
+    {
+    const SizeValueType begin = std::min( std::min(bottom.RowBegin[y], bottom.RowBegin[y + 1]),
+                                          std::min(top.RowBegin[y], top.RowBegin[y + 1]) );
+    const SizeValueType end = std::max( std::max(bottom.RowEnd[y], bottom.RowEnd[y + 1]),
+                                        std::max(top.RowEnd[y], top.RowEnd[y + 1]) );
+    for ( SizeValueType x = begin - 1; x < end; ++x )
+      {
+      const SizeValueType  i = y * nx + x;
+      const LabelIndexType corners[8] = { b[i], b[i + 1], b[i + nx], b[i + nx + 1],
+                                          t[i], t[i + 1], t[i + nx], t[i + nx + 1] };
+      if ( std::all_of( corners + 1, corners + 8,
+                        [&corners](LabelIndexType label) { return label == corners[0]; } ) )
+        {
+        continue;
+        }
+      for ( unsigned int c = 0; c < 8; ++c )
         {
-        for ( i = 0; i < m_LastRowNum; i++ )
+        const LabelIndexType label = corners[c];
+        if ( label == NoLabel || std::find(corners, corners + c, label) != corners + c )
+          {
+          continue;
+          }
+        unsigned int mask = 0;
+        for ( unsigned int k = c; k < 8; ++k )
           {
-          free (m_LastRow[i]);
+          mask |= static_cast< unsigned int >( corners[k] == label ) << k;
           }
-        free (m_LastRow);
-        m_LastRow = nullptr;
+        count += table.NumberOfTriangles[mask];
         }
-      m_LastRowNum = 0;
       }
     }
+  return count;
+}
 
-  if ( m_FrameFlag == 1 )
-    {
-    if ( ( index / ( m_ImageWidth * m_ImageHeight ) ) != m_LastFrameIndex )
-      {
-      if ( m_LastFrameNum == 0 )
+template< typename TInputImage, typename TOutputMesh >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::GenerateLayerTriangles(const LabelSliceType & bottom, const LabelSliceType & top,
+                         const IdentifierSliceType & bottomIds, const IdentifierSliceType & topIds,
+                         const IdentifierSliceType & layerIds, SizeValueType cellId)
+{
+  const CaseTable &   table = GetCaseTable();
+  const SizeValueType nx = m_PaddedSize[0];
+  const SizeValueType ny = m_PaddedSize[1];
+  const LabelIndexType *b = bottom.Labels.data();
+  const LabelIndexType *t = top.Labels.data();
+
+  // Offset of every cube corner in a slice, for corners 0 to 3.
+  const SizeValueType cornerOffsets[4] = { 0, 1, nx, nx + 1 };
+
+  OPointIdentifier *connectivity = m_Connectivity.data() + 3 * cellId;
+  OCellPixelType   *cellData = m_CellData.data() + cellId;
+  for ( SizeValueType y = 0; y + 1 < ny; ++y )
+    {
+    const SizeValueType begin = std::min( std::min(bottom.RowBegin[y], bottom.RowBegin[y + 1]),
+                                          std::min(top.RowBegin[y], top.RowBegin[y + 1]) );
+    const SizeValueType end = std::max( std::max(bottom.RowEnd[y], bottom.RowEnd[y + 1]),
+                                        std::max(top.RowEnd[y], top.RowEnd[y + 1]) );
+    for ( SizeValueType x = begin - 1; x < end; ++x )
+      {
+      const SizeValueType  i = y * nx + x;
+      const LabelIndexType corners[8] = { b[i], b[i + 1], b[i + nx], b[i + nx + 1],
+                                          t[i], t[i + 1], t[i + nx], t[i + nx + 1] };
+      if ( std::all_of( corners + 1, corners + 8,
+                        [&corners](LabelIndexType label) { return label == corners[0]; } ) )
         {
-        m_LastFrame = (IdentifierType **)malloc( m_CurrentFrameIndex * sizeof( IdentifierType * ) );
+        continue;
         }
-      else
+      for ( unsigned int c = 0; c < 8; ++c )
         {
-        if ( m_LastFrameNum >  m_CurrentFrameIndex )
+        const LabelIndexType label = corners[c];
+        if ( label == NoLabel || std::find(corners, corners + c, label) != corners + c )
+          {
+          continue;
+          }
+        unsigned int mask = 0;
+        for ( unsigned int k = c; k < 8; ++k )
+          {
+          mask |= static_cast< unsigned int >( corners[k] == label ) << k;
+          }
+        const unsigned char *edges = table.Edges[mask];
+        for ( unsigned int k = 0; k < 3u * table.NumberOfTriangles[mask]; ++k )
           {
-          for ( i = m_CurrentFrameIndex; i < m_LastFrameNum; i++ )
+          const unsigned int  axis = edges[k] / 4;
+          const unsigned int  corner = table.EdgeCorners[edges[k]];
+          const SizeValueType voxel = i + cornerOffsets[corner & 3];
+          IdentifierType      id;
+          if ( axis == 2 )
+            {
+            id = layerIds[voxel];
+            }
+          else
             {
-            free(m_LastFrame[i]);
+            id = ( corner & 4 ? topIds : bottomIds )[2 * voxel + axis];
             }
+          // The second vertex of the edge, if any, belongs to the label at
+          // its second end.
+          if ( corners[corner] != label && corners[corner] != NoLabel )
+            {
+            ++id;
+            }
+          *connectivity++ = static_cast< OPointIdentifier >( id );
           }
-        m_LastFrame = (IdentifierType **)realloc( m_LastFrame, m_CurrentFrameIndex * sizeof( IdentifierType * ) );
-        }
-      for ( i = 0; i < m_CurrentFrameIndex; i++ )
-        {
-        if ( i > m_LastFrameNum - 1 )
+        for ( unsigned int k = 0; k < table.NumberOfTriangles[mask]; ++k )
           {
-          m_LastFrame[i] = (IdentifierType *)malloc( 2 * sizeof( IdentifierType ) );
+          *cellData++ = static_cast< OCellPixelType >( label );
           }
-        m_LastFrame[i][0] = m_CurrentFrame[i][0];
-        m_LastFrame[i][1] = m_CurrentFrame[i][1];
-        }
-      m_LastFrameNum = m_CurrentFrameIndex;
-      m_CurrentFrameIndex = 0;
-      }
-    }
-  else
-    {
-    if ( index % ( m_ImageWidth * m_ImageHeight ) == 0 )
-      {
-      for ( i = 0; i < m_LastFrameNum; i++ )
-        {
-        free (m_LastFrame[i]);
         }
-      free (m_LastFrame);
-      m_LastFrame = nullptr;
       }
     }
+}
 
-  m_LastVoxelIndex = index;
-  m_LastRowIndex = index / m_ImageWidth;
-  m_LastFrameIndex = index / ( m_ImageWidth * m_ImageHeight );
-
-  m_AvailableNodes[1] = 0;
-  m_AvailableNodes[2] = 0;
-  m_AvailableNodes[3] = 0;
-  m_AvailableNodes[4] = 0;
-  m_AvailableNodes[5] = 0;
-  m_AvailableNodes[6] = 1;
-  m_AvailableNodes[7] = 1;
-  m_AvailableNodes[8] = 0;
-  m_AvailableNodes[9] = 0;
-  m_AvailableNodes[10] = 0;
-  m_AvailableNodes[11] = 1;
-  m_AvailableNodes[12] = 0;
-  m_AvailableNodes[13] = 1;
-
-  if ( m_ColFlag == 0 )
-    {
-    m_AvailableNodes[4] = 1;
-    m_AvailableNodes[8] = 1;
-    m_AvailableNodes[9] = 1;
-    m_AvailableNodes[12] = 1;
-    }
-
-  if ( m_RowFlag == 0 )
-    {
-    m_AvailableNodes[1] = 1;
-    m_AvailableNodes[5] = 1;
-    m_AvailableNodes[9] = 1;
-    m_AvailableNodes[10] = 1;
-    }
+template< typename TInputImage, typename TOutputMesh >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::CountLayers(SizeValueType begin, SizeValueType end)
+{
+  LabelSliceType bottom;
+  LabelSliceType top;
 
-  if ( m_FrameFlag == 0 )
+  this->FillLabelSlice(begin, bottom);
+  for ( SizeValueType layer = begin; layer < end; ++layer )
     {
-    m_AvailableNodes[1] = 1;
-    m_AvailableNodes[2] = 1;
-    m_AvailableNodes[3] = 1;
-    m_AvailableNodes[4] = 1;
+    this->FillLabelSlice(layer + 1, top);
+    IdentifierType count = this->NumberSliceEdges(layer + 1, top, 0, nullptr, false);
+    count = this->NumberLayerEdges(layer, bottom, top, count, nullptr, false);
+    // The counts are stored one past their layer, and turned into offsets
+    // once all the layers are counted.
+    m_LayerVertexOffsets[layer + 1] = count;
+    m_LayerCellOffsets[layer + 1] = this->CountLayerTriangles(bottom, top);
+    std::swap(bottom, top);
     }
+}
 
-  typename TriCell::CellAutoPointer insertCell;
-  typename OutputMeshType::PointIdentifier  tripoints[3];
-  unsigned char *tp;
-  tp = (unsigned char *)malloc( 3 * sizeof( unsigned char ) );
+template< typename TInputImage, typename TOutputMesh >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::GenerateLayers(SizeValueType begin, SizeValueType end)
+{
+  const SizeValueType size = m_PaddedSize[0] * m_PaddedSize[1];
 
-  IdentifierType *tpl;
-  tpl = (IdentifierType *)malloc( 3 * sizeof( IdentifierType ) );
+  LabelSliceType      bottom;
+  LabelSliceType      top;
+  IdentifierSliceType bottomIds(2 * size);
+  IdentifierSliceType topIds(2 * size);
+  IdentifierSliceType layerIds(size);
 
-  switch ( (int)celltype )
+  // The vertices on the first slice belong to the previous layer, which
+  // numbers them first.
+  this->FillLabelSlice(begin, bottom);
+  if ( begin > 0 )
+    {
+    this->NumberSliceEdges(begin, bottom, m_LayerVertexOffsets[begin - 1], &bottomIds, false);
+    }
+  for ( SizeValueType layer = begin; layer < end; ++layer )
     {
-    case 1:
-      tp[0] = 1;
-      tp[1] = 9;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 2:
-      tp[0] = 4;
-      tp[1] = 2;
-      tp[2] = 9;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 10;
-      tp[1] = 9;
-      tp[2] = 2;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 3:
-      tp[0] = 1;
-      tp[1] = 9;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 3;
-      tp[2] = 11;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 4:
-      tp[0] = 1;
-      tp[1] = 9;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 6;
-      tp[1] = 11;
-      tp[2] = 7;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 5:
-      tp[0] = 1;
-      tp[1] = 2;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 9;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 9;
-      tp[1] = 13;
-      tp[2] = 8;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 2;
-      tp[2] = 6;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 6;
-      tp[2] = 8;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 6:
-      tp[0] = 10;
-      tp[1] = 9;
-      tp[2] = 2;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 4;
-      tp[1] = 2;
-      tp[2] = 9;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 6;
-      tp[1] = 11;
-      tp[2] = 7;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 7:
-      tp[0] = 1;
-      tp[1] = 2;
-      tp[2] = 10;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 6;
-      tp[1] = 11;
-      tp[2] = 7;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 3;
-      tp[1] = 4;
-      tp[2] = 12;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 8:
-      tp[0] = 13;
-      tp[1] = 2;
-      tp[2] = 6;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 6;
-      tp[2] = 8;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 8;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 4;
-      tp[2] = 2;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 9:
-      tp[0] = 1;
-      tp[1] = 10;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 10;
-      tp[1] = 6;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 6;
-      tp[1] = 7;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 7;
-      tp[1] = 12;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 12;
-      tp[1] = 4;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 10:
-      tp[0] = 1;
-      tp[1] = 9;
-      tp[2] = 3;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 9;
-      tp[1] = 12;
-      tp[2] = 3;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 5;
-      tp[1] = 10;
-      tp[2] = 7;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 10;
-      tp[1] = 11;
-      tp[2] = 7;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 11:
-      tp[0] = 1;
-      tp[1] = 10;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 10;
-      tp[2] = 11;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 7;
-      tp[1] = 13;
-      tp[2] = 11;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 7;
-      tp[1] = 8;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 8;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 12:
-      tp[0] = 1;
-      tp[1] = 2;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 9;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 9;
-      tp[1] = 13;
-      tp[2] = 8;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 2;
-      tp[2] = 6;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 6;
-      tp[2] = 8;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 3;
-      tp[1] = 4;
-      tp[2] = 12;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 13:
-      tp[0] = 1;
-      tp[1] = 9;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 5;
-      tp[1] = 10;
-      tp[2] = 6;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 3;
-      tp[2] = 11;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 8;
-      tp[1] = 7;
-      tp[2] = 12;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 14:
-      tp[0] = 1;
-      tp[1] = 10;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 10;
-      tp[1] = 6;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 6;
-      tp[1] = 7;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 7;
-      tp[1] = 12;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 12;
-      tp[1] = 4;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 3;
-      tp[2] = 11;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 15:
-      tp[0] = 1;
-      tp[1] = 10;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 13;
-      tp[2] = 10;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 3;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 3;
-      tp[1] = 12;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 4;
-      tp[1] = 13;
-      tp[2] = 12;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
-    case 16:
-      tp[0] = 13;
-      tp[1] = 1;
-      tp[2] = 5;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 5;
-      tp[1] = 6;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 13;
-      tp[1] = 6;
-      tp[2] = 2;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 2;
-      tp[1] = 3;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 3;
-      tp[1] = 12;
-      tp[2] = 13;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 4;
-      tp[1] = 13;
-      tp[2] = 12;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      tp[0] = 1;
-      tp[1] = 13;
-      tp[2] = 4;
-      CellTransfer(tp, celltran);
-      AddNodes(index, tp, tpl, currentrowtmp, currentframetmp);
-      tripoints[0] = tpl[0];
-      tripoints[1] = tpl[2];
-      tripoints[2] = tpl[1];
-      insertCell.TakeOwnership(new TriCell);
-      insertCell->SetPointIds(tripoints);
-      this->m_OutputMesh->SetCell(m_NumberOfCells, insertCell);
-      this->m_OutputMesh->SetCellData(m_NumberOfCells, 0.0);
-      m_NumberOfCells++;
-      break;
+    this->FillLabelSlice(layer + 1, top);
+    IdentifierType id = this->NumberSliceEdges(layer + 1, top, m_LayerVertexOffsets[layer], &topIds, true);
+    this->NumberLayerEdges(layer, bottom, top, id, &layerIds, true);
+    this->GenerateLayerTriangles(bottom, top, bottomIds, topIds, layerIds, m_LayerCellOffsets[layer]);
+    std::swap(bottom, top);
+    std::swap(bottomIds, topIds);
     }
+}
 
-  i = 0;
-  int j;
-  while ( i < 4 )
+template< typename TInputImage, typename TOutputMesh >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::ThreadLayers(SizeValueType begin, SizeValueType end, bool count)
+{
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >(
+    std::min< SizeValueType >( this->GetNumberOfThreads(), end - begin ) );
+  if ( numberOfThreads <= 1 )
     {
-    if ( currentrowtmp[i][0] != 0 )
+    if ( count )
       {
-      m_CurrentRow[m_CurrentRowIndex][1] = currentrowtmp[i][1];
-      m_CurrentRow[m_CurrentRowIndex++][0] = currentrowtmp[i][0];
-      if ( m_CurrentRowIndex == m_CurrentRowNum )
-        {
-        m_CurrentRowNum += 100;
-        m_CurrentRow = (IdentifierType **)realloc(m_CurrentRow, sizeof( IdentifierType * ) * m_CurrentRowNum);
-        for ( j = m_CurrentRowIndex; j < m_CurrentRowNum; j++ )
-          {
-          m_CurrentRow[j] = (IdentifierType *)malloc(sizeof( IdentifierType ) * 2);
-          }
-        }
+      this->CountLayers(begin, end);
       }
-
-    if ( currentframetmp[i][0] != 0 )
+    else
       {
-      m_CurrentFrame[m_CurrentFrameIndex][1] = currentframetmp[i][1];
-      m_CurrentFrame[m_CurrentFrameIndex++][0] = currentframetmp[i][0];
-      if ( m_CurrentFrameIndex == m_CurrentFrameNum )
-        {
-        m_CurrentFrameNum += 1000;
-        m_CurrentFrame = (IdentifierType **)realloc(m_CurrentFrame, sizeof( IdentifierType * ) * m_CurrentFrameNum);
-        for ( j = m_CurrentFrameIndex; j < m_CurrentFrameNum; j++ )
-          {
-          m_CurrentFrame[j] = (IdentifierType *)malloc(sizeof( IdentifierType ) * 2);
-          }
-        }
+      this->GenerateLayers(begin, end);
       }
-
-    i++;
-    }
-
-  for ( i = 0; i < 4; i++ )
-    {
-    free (currentrowtmp[i]);
-    }
-  free (currentrowtmp);
-
-  for ( i = 0; i < 4; i++ )
-    {
-    free (currentframetmp[i]);
+    return;
     }
 
-  free (currentframetmp);
-
-  free (tp);
-  free (tpl);
+  ThreadStruct str;
+  str.Filter = this;
+  str.Begin = begin;
+  str.End = end;
+  str.Count = count;
 
-  m_LastVoxel[4] = m_CurrentVoxel[2];
-  m_LastVoxel[9] = m_CurrentVoxel[10];
-  m_LastVoxel[8] = m_CurrentVoxel[6];
-  m_LastVoxel[12] = m_CurrentVoxel[11];
-  for ( i = 1; i < 14; i++ )
-    {
-    m_CurrentVoxel[i] = 0;
-    }
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
 }
 
 template< typename TInputImage, typename TOutputMesh >
-void
+ITK_THREAD_RETURN_TYPE
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::AddNodes(int index,
-           unsigned char *nodesid,
-           IdentifierType *globalnodesid,
-           IdentifierType **currentrowtmp,
-           IdentifierType **currentframetmp)
+::ThreaderCallback(void *arg)
 {
-  int        i;
-  OPointType new_p;
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
 
-  for ( i = 0; i < 3; i++ )
+  const SizeValueType n = str->End - str->Begin;
+  const SizeValueType begin = str->Begin + n * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType end = str->Begin + n * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  if ( begin < end )
     {
-    m_PointFound = 0;
-    if ( m_AvailableNodes[nodesid[i]] != 0 )
+    if ( str->Count )
       {
-      m_PointFound = 1;
-
-      using PointValueType = typename OPointType::ValueType;
-      using ContinuousIndexType = ContinuousIndex<PointValueType,3>;
-
-      ContinuousIndexType indTemp;
-      indTemp[0] = m_LocationOffset[nodesid[i]][0]
-                   + ( index % m_ImageWidth )
-                   + m_RegionOfInterest.GetIndex()[0];
-      indTemp[1] = m_LocationOffset[nodesid[i]][1]
-                   + ( ( index % ( m_ImageWidth * m_ImageHeight ) ) / m_ImageWidth )
-                   + m_RegionOfInterest.GetIndex()[1];
-      indTemp[2] = m_LocationOffset[nodesid[i]][2]
-                   + ( index / ( m_ImageWidth * m_ImageHeight ) )
-                   + m_RegionOfInterest.GetIndex()[2];
-
-
-      // We transform the point to the physical space since the mesh does not
-      // have the notion
-      // of spacing and origin
-      this->m_InputImage->TransformContinuousIndexToPhysicalPoint(indTemp,new_p);
-      this->m_OutputMesh->SetPoint(m_NumberOfNodes, new_p);
-
-      switch ( nodesid[i] )
-        {
-        case 2:
-          m_CurrentVoxel[2] = m_NumberOfNodes;
-          break;
-        case 6:
-          m_CurrentVoxel[6] = m_NumberOfNodes;
-          currentframetmp[1][1] = m_NumberOfNodes;
-          currentframetmp[1][0] = ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 + 2;
-          break;
-        case 10:
-          m_CurrentVoxel[10] = m_NumberOfNodes;
-          break;
-        case 11:
-          m_CurrentVoxel[11] = m_NumberOfNodes;
-          currentrowtmp[3][1] = m_NumberOfNodes;
-          currentrowtmp[3][0] = ( index % m_ImageWidth ) * 13 + 10;
-          break;
-        case 3:
-          currentrowtmp[0][1] = m_NumberOfNodes;
-          currentrowtmp[0][0] = ( index % m_ImageWidth ) * 13 + 1;
-          break;
-        case 7:
-          currentrowtmp[1][1] = m_NumberOfNodes;
-          currentrowtmp[1][0] = ( index % m_ImageWidth ) * 13 + 5;
-          currentframetmp[2][1] = m_NumberOfNodes;
-          currentframetmp[2][0] = ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 + 3;
-          break;
-        case 12:
-          currentrowtmp[2][1] = m_NumberOfNodes;
-          currentrowtmp[2][0] = ( index % m_ImageWidth ) * 13 + 9;
-          break;
-        case 5:
-          currentframetmp[0][1] = m_NumberOfNodes;
-          currentframetmp[0][0] = ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 + 1;
-          break;
-        case 8:
-          currentframetmp[3][1] = m_NumberOfNodes;
-          currentframetmp[3][0] = ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 + 4;
-          break;
-        case 1:
-          m_CurrentVoxel[1] = m_NumberOfNodes;
-          break;
-        case 4:
-          m_CurrentVoxel[4] = m_NumberOfNodes;
-          break;
-        case 9:
-          m_CurrentVoxel[9] = m_NumberOfNodes;
-          break;
-        case 13:
-          m_CurrentVoxel[13] = m_NumberOfNodes;
-          break;
-        }
-      globalnodesid[i] = m_NumberOfNodes;
-      m_AvailableNodes[nodesid[i]] = 0;
-      m_CurrentVoxel[nodesid[i]] = m_NumberOfNodes;
-      m_NumberOfNodes++;
+      str->Filter->CountLayers(begin, end);
       }
     else
       {
-      if ( m_CurrentVoxel[nodesid[i]] != 0 )
-        {
-        globalnodesid[i] = m_CurrentVoxel[nodesid[i]];
-        m_PointFound = 1;
-
-        continue;
-        }
-      if ( m_LastVoxel[nodesid[i]] != 0 )
-        {
-        globalnodesid[i] = m_LastVoxel[nodesid[i]];
-        m_PointFound = 1;
-
-        continue;
-        }
-      if ( ( m_LastRowNum != 0 )
-           && ( ( nodesid[i] == 1 ) || ( nodesid[i] == 5 ) || ( nodesid[i] == 9 ) || ( nodesid[i] == 10 ) ) )
-        {
-        globalnodesid[i] = this->SearchThroughLastRow( ( index % m_ImageWidth ) * 13 + nodesid[i], 0, m_LastRowNum - 1 );
-        if ( m_PointFound != 0 ) { continue; }
-        else
-          {
-          if ( nodesid[i] == 9 ) { globalnodesid[i] = this->SearchThroughLastRow( ( index % m_ImageWidth ) * 13 - 3, 0,
-                                                                                  m_LastRowNum - 1 ); }
-          if ( nodesid[i] == 10 ) { globalnodesid[i] =
-                                      this->SearchThroughLastRow( ( index % m_ImageWidth ) * 13 + 22, 0,
-                                                                  m_LastRowNum - 1 ); }
-          if ( m_PointFound != 0 ) { continue; }
-          }
-        }
-      if ( ( m_LastFrameNum != 0 )
-           && ( ( nodesid[i] == 1 ) || ( nodesid[i] == 2 ) || ( nodesid[i] == 3 ) || ( nodesid[i] == 4 ) ) )
-        {
-        globalnodesid[i] =
-          this->SearchThroughLastFrame( ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 + nodesid[i], 0,
-                                        m_LastFrameNum - 1 );
-        if ( m_PointFound != 0 ) { continue; }
-        else
-          {
-          if ( nodesid[i] == 4 ) { globalnodesid[i] =
-                                     this->SearchThroughLastFrame(
-                                        ( index % ( m_ImageWidth * m_ImageHeight ) ) * 13 - 11, 0,
-                                       m_LastFrameNum - 1 ); }
-          if ( nodesid[i] == 1 ) { globalnodesid[i] =
-                                     this->SearchThroughLastFrame(
-                                        ( index
-                                          % ( m_ImageWidth
-                                              * m_ImageHeight ) - m_ImageWidth ) * 13 + 3, 0,
-                                       m_LastFrameNum - 1 ); }
-          if ( m_PointFound != 0 ) { continue; }
-          }
-        }
-      }
-
-    if ( m_PointFound == 0 )
-      {
-      m_AvailableNodes[nodesid[i]] = 1;
-      i--;
+      str->Filter->GenerateLayers(begin, end);
       }
     }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TInputImage, typename TOutputMesh >
+template< typename TContainer >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::CellTransfer(unsigned char *nodesid, unsigned char celltran)
+::MoveIntoContainer(std::vector< typename TContainer::Element > & values, TContainer *container)
 {
-  if ( ( celltran & 1 ) != 0 )
-    {
-    this->ZFlip(nodesid);
-    if ( celltran > 64 ) { celltran -= 64; }
-    else { celltran += 64; }
-    }
-  if ( ( celltran & 2 ) != 0 )
-    {
-    this->YFlip(nodesid);
-    if ( celltran > 64 ) { celltran -= 64; }
-    else { celltran += 64; }
-    }
-  if ( ( celltran & 4 ) != 0 )
+  using ElementIdentifier = typename TContainer::ElementIdentifier;
+
+  for ( SizeValueType i = 0; i < values.size(); ++i )
     {
-    this->XFlip(nodesid);
-    if ( celltran > 64 ) { celltran -= 64; }
-    else { celltran += 64; }
+    container->InsertElement( static_cast< ElementIdentifier >( i ), values[i] );
     }
-  if ( ( celltran & 8 ) != 0 ) { this->ZRotation(nodesid); }
-  if ( ( celltran & 16 ) != 0 ) { this->YRotation(nodesid); }
-  if ( ( celltran & 32 ) != 0 ) { this->XRotation(nodesid); }
-  if ( ( celltran & 64 ) != 0 ) { this->inverse(nodesid); }
+  std::vector< typename TContainer::Element >().swap(values);
 }
 
 template< typename TInputImage, typename TOutputMesh >
-IdentifierType
+template< typename TElementIdentifier, typename TElement >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::MoveIntoContainer(std::vector< TElement > & values,
+                    VectorContainer< TElementIdentifier, TElement > *container)
+{
+  container->CastToSTLContainer().swap(values);
+  std::vector< TElement >().swap(values);
+}
+
+template< typename TInputImage, typename TOutputMesh >
+void
+BinaryMask3DMeshSource< TInputImage, TOutputMesh >
+::FillOutputMesh()
+{
+  typename OutputMeshType::PointsContainerPointer points = OutputMeshType::PointsContainer::New();
+  MoveIntoContainer(m_Points, points.GetPointer());
+  m_OutputMesh->SetPoints(points);
+
+  // The triangles are given as compact arrays, which a plain Mesh stores
+  // without allocating a cell object per triangle.
+  using CellGeometriesContainer = typename OutputMeshType::CellGeometriesContainer;
+  using CellOffsetsContainer = typename OutputMeshType::CellOffsetsContainer;
+  using CellConnectivityContainer = typename OutputMeshType::CellConnectivityContainer;
+
+  typename CellGeometriesContainer::Pointer geometries = CellGeometriesContainer::New();
+  geometries->CastToSTLContainer().assign( m_NumberOfCells, TCellInterface::TRIANGLE_CELL );
+  typename CellOffsetsContainer::Pointer offsets = CellOffsetsContainer::New();
+  auto & offsetsVector = offsets->CastToSTLContainer();
+  offsetsVector.resize( m_NumberOfCells + 1 );
+  for ( SizeValueType i = 0; i <= m_NumberOfCells; ++i )
+    {
+    offsetsVector[i] = 3 * i;
+    }
+  typename CellConnectivityContainer::Pointer connectivity = CellConnectivityContainer::New();
+  connectivity->CastToSTLContainer().swap(m_Connectivity);
+  OutputMeshType::SetCellsFromArrays(m_OutputMesh, geometries, offsets, connectivity,
+                                     this->GetUseCellsArrays());
+  std::vector< OPointIdentifier >().swap(m_Connectivity);
+
+  typename OutputMeshType::CellDataContainerPointer cellData = OutputMeshType::CellDataContainer::New();
+  MoveIntoContainer(m_CellData, cellData.GetPointer());
+  m_OutputMesh->SetCellData(cellData);
+}
+
+/** Generate the data */
+template< typename TInputImage, typename TOutputMesh >
+void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::SearchThroughLastRow(int index, int start, int end)
+::GenerateData()
 {
-  int            mid;
-  auto lindex = static_cast< IdentifierType >( index );
+  m_InputImage = this->GetInput();
+  m_OutputMesh = this->GetOutput();
+  m_NumberOfNodes = 0;
+  m_NumberOfCells = 0;
 
-  if ( ( end - start ) > 1 )
+  m_ExtractionRegion = this->ComputeExtractionRegion(m_InputImage);
+  if ( m_NumberOfStreamDivisions == 1 )
     {
-    mid = static_cast< int >( std::floor( static_cast< float >( ( start + end ) / 2 ) ) );
-    if ( lindex == m_LastRow[mid][0] )
-      {
-      m_PointFound = 1;
-      return m_LastRow[mid][1];
-      }
-    else
+    if ( !m_ExtractionRegion.Crop( m_InputImage->GetBufferedRegion() ) )
       {
-      if ( lindex > m_LastRow[mid][0] )
-        {
-        return this->SearchThroughLastRow(index, mid + 1, end);
-        }
-      else
-        {
-        return this->SearchThroughLastRow(index, start, mid);
-        }
+      SizeType size;
+      size.Fill( 0 );
+      m_ExtractionRegion.SetSize(size);
       }
     }
-  else
+  if ( !m_RegionOfInterestProvidedByUser )
     {
-    if ( lindex == m_LastRow[start][0] )
-      {
-      m_PointFound = 1;
-      return m_LastRow[start][1];
-      }
-    if ( lindex == m_LastRow[end][0] )
-      {
-      m_PointFound = 1;
-      return m_LastRow[end][1];
-      }
+    m_RegionOfInterest = m_ExtractionRegion;
     }
-  return 0;
-}
 
-template< typename TInputImage, typename TOutputMesh >
-IdentifierType
-BinaryMask3DMeshSource< TInputImage, TOutputMesh >
-::SearchThroughLastFrame(int index, int start, int end)
-{
-  int            mid;
-  auto lindex = static_cast< IdentifierType >( index );
-  IdentifierType result = 0;
+  m_Labels = m_ObjectValues;
+  if ( m_Labels.empty() )
+    {
+    m_Labels.push_back(m_ObjectValue);
+    }
 
-  if ( ( end - start ) > 1 )
+  const SizeValueType depth = m_ExtractionRegion.GetSize(2);
+  if ( m_ExtractionRegion.GetNumberOfPixels() > 0 )
     {
-    mid = static_cast< int >( std::floor( static_cast< float >( ( start + end ) / 2 ) ) );
-    if ( lindex == m_LastFrame[mid][0] )
+    for ( unsigned int i = 0; i < 3; ++i )
       {
-      m_PointFound = 1;
-      result = m_LastFrame[mid][1];
+      m_PaddedSize[i] = m_ExtractionRegion.GetSize(i) + 2;
       }
-    else
+
+    // Layers are counted then generated one stream division at a time.  The
+    // first layer of a division needs the vertex offset of the layer before
+    // it, which is known once the previous division is counted.
+    const SizeValueType numberOfLayers = depth + 1;
+    const SizeValueType numberOfDivisions =
+      std::min< SizeValueType >( m_NumberOfStreamDivisions, numberOfLayers );
+    m_LayerVertexOffsets.assign(numberOfLayers + 1, 0);
+    m_LayerCellOffsets.assign(numberOfLayers + 1, 0);
+    for ( SizeValueType division = 0; division < numberOfDivisions && !this->GetAbortGenerateData(); ++division )
       {
-      if ( lindex > m_LastFrame[mid][0] )
+      const SizeValueType begin = numberOfLayers * division / numberOfDivisions;
+      const SizeValueType end = numberOfLayers * ( division + 1 ) / numberOfDivisions;
+      if ( numberOfDivisions > 1 )
         {
-        result = this->SearchThroughLastFrame(index, mid + 1, end);
+        auto *input = const_cast< InputImageType * >( m_InputImage );
+        const RegionType region = this->ComputeLayersInputRegion(begin, end);
+        input->SetRequestedRegion(region);
+        input->PropagateRequestedRegion();
+        input->UpdateOutputData();
+        if ( !input->GetBufferedRegion().IsInside(region) )
+          {
+          itkExceptionMacro(<< "The input region " << region << " is not buffered");
+          }
         }
-      else
+
+      this->ThreadLayers(begin, end, true);
+      for ( SizeValueType layer = begin; layer < end; ++layer )
         {
-        result = this->SearchThroughLastFrame(index, start, mid);
+        m_LayerVertexOffsets[layer + 1] += m_LayerVertexOffsets[layer];
+        m_LayerCellOffsets[layer + 1] += m_LayerCellOffsets[layer];
         }
+      m_Points.resize( m_LayerVertexOffsets[end] );
+      m_Connectivity.resize( 3 * m_LayerCellOffsets[end] );
+      m_CellData.resize( m_LayerCellOffsets[end] );
+      this->ThreadLayers(begin, end, false);
+
+      this->UpdateProgress( static_cast< float >( division + 1 ) / static_cast< float >( numberOfDivisions ) );
       }
+
+    m_NumberOfNodes = m_Points.size();
+    m_NumberOfCells = m_CellData.size();
     }
-  else
-    {
-    if ( lindex == m_LastFrame[start][0] )
-      {
-      m_PointFound = 1;
-      result = m_LastFrame[start][1];
-      }
-    if ( lindex == m_LastFrame[end][0] )
-      {
-      m_PointFound = 1;
-      result = m_LastFrame[end][1];
-      }
-    }
-  return result;
+
+  this->FillOutputMesh();
+
+  std::vector< IdentifierType >().swap(m_LayerVertexOffsets);
+  std::vector< SizeValueType >().swap(m_LayerCellOffsets);
+  m_InputImage = nullptr;
+  m_OutputMesh = nullptr;
 }
 
-/** PrintSelf */
 template< typename TInputImage, typename TOutputMesh >
 void
 BinaryMask3DMeshSource< TInputImage, TOutputMesh >
@@ -2676,6 +841,18 @@ BinaryMask3DMeshSource< TInputImage, TOutputMesh >
      << static_cast< NumericTraits< unsigned char >::PrintType >( m_ObjectValue )
      << std::endl;
 
+  os << indent << "ObjectValues:";
+  for ( size_t i = 0; i < m_ObjectValues.size(); ++i )
+    {
+    os << " " << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_ObjectValues[i] );
+    }
+  os << std::endl;
+
+  os << indent
+     << "NumberOfStreamDivisions: "
+     << m_NumberOfStreamDivisions
+     << std::endl;
+
   os << indent
      << "NumberOfNodes: "
      << m_NumberOfNodes
@@ -149,7 +149,9 @@ ConnectedRegionsMeshFilter< TInputMesh, TOutputMesh >
   InputMeshConstPointer                  input = this->GetInput();
   OutputMeshPointer                      output = this->GetOutput();
   InputMeshPointsContainerConstPointer   inPts = input->GetPoints();
-  InputMeshCellsContainerConstPointer    inCells = input->GetCells();
+  // Cells stored as compact arrays are read through cell objects
+  const auto                             inputWithCells = input->GetMeshWithCellObjects();
+  InputMeshCellsContainerConstPointer    inCells = inputWithCells->GetCells();
   InputMeshCellDataContainerConstPointer inCellData = input->GetCellData();
 
   itkDebugMacro(<< "Executing connectivity");
@@ -34,6 +34,9 @@
 #include "itkBoundingBox.h"
 #include "itkCellInterface.h"
 #include "itkMapContainer.h"
+#include "itkVectorContainer.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMutexLockHolder.h"
 #include <vector>
 #include <set>
 
@@ -68,6 +71,24 @@ namespace itk
  * intersection does not need to be performed); then Mesh can be further
  * extended by adding explicit boundary assignments.
  *
+ * \par Compact cell storage
+ * Cells that are never modified individually (e.g. a mesh read from a
+ * file) can alternatively be stored as three contiguous arrays through
+ * SetCellsArrays(): the geometry of every cell, the offset of every cell
+ * into a connectivity array, and the connectivity array holding the point
+ * identifiers of all the cells back to back.  No cell object is allocated
+ * in this representation, which is only used when asked for: readers and
+ * filters produce cell objects unless MeshSource::UseCellsArrays is on.
+ * Accept(), GetCell(), GetNumberOfCells() and BuildCellLinks() work
+ * directly on the arrays; GetCell() then returns a new cell built from the
+ * arrays, which is a read-only copy: changing it does not change the mesh.
+ * Both GetCells() methods, SetCell(), boundary assignments and neighbor
+ * queries convert the arrays into cells the first time they are called,
+ * see ConvertCellsArraysToCells().  The conversion is serialized, so
+ * several threads may call GetCells() on the same mesh at once; call it
+ * once before sharing an array-backed mesh between threads which also use
+ * the other accessors.
+ *
  * \par Usage
  * Mesh has three template parameters.  The first is the pixel type, or the
  * type of data stored (optionally) with points, cells, and/or boundaries.
@@ -191,6 +212,17 @@ public:
   /** Visiting cells. */
   using CellMultiVisitorType = typename CellType::MultiVisitor;
 
+  /** Compact cell storage.  Cell i has the geometry
+   * CellGeometries[i] (a CellType::CellGeometry value) and uses the point
+   * identifiers CellConnectivity[ CellOffsets[i] ] up to, but not
+   * including, CellConnectivity[ CellOffsets[i+1] ]. */
+  using CellGeometriesContainer = VectorContainer< CellIdentifier, unsigned char >;
+  using CellOffsetsContainer = VectorContainer< CellIdentifier, SizeValueType >;
+  using CellConnectivityContainer = VectorContainer< SizeValueType, PointIdentifier >;
+  using CellGeometriesContainerPointer = typename CellGeometriesContainer::Pointer;
+  using CellOffsetsContainerPointer = typename CellOffsetsContainer::Pointer;
+  using CellConnectivityContainerPointer = typename CellConnectivityContainer::Pointer;
+
   /** \class BoundaryAssignmentIdentifier
    *  An explicit cell boundary assignment can be accessed through the cell
    *  identifier to which the assignment is made, and the feature Id of the
@@ -309,8 +341,53 @@ public:
 
   CellsContainer * GetCells();
 
+  /** Same as above.  Cells stored as arrays are converted as well, so
+   * that the returned container always holds every cell. */
   const CellsContainer * GetCells() const;
 
+  /** Store the cells of the mesh as contiguous arrays instead of cell
+   * objects.  \a offsets must hold one more element than \a geometries,
+   * its last element being the size of \a connectivity.  The cells
+   * container is released.  The arrays are referenced, not copied, and
+   * should not be modified afterwards. */
+  void SetCellsArrays(CellGeometriesContainer *geometries,
+                      CellOffsetsContainer *offsets,
+                      CellConnectivityContainer *connectivity);
+
+  /** Get the compact cell arrays.  These are nullptr unless the cells are
+   * currently stored as arrays, see HasCellsArrays(). */
+  const CellGeometriesContainer * GetCellGeometries() const;
+
+  const CellOffsetsContainer * GetCellOffsets() const;
+
+  const CellConnectivityContainer * GetCellConnectivity() const;
+
+  /** Return true if the cells are stored as compact arrays. */
+  bool HasCellsArrays() const;
+
+  /** Convert the compact cell arrays, if any, into cell objects stored in
+   * the cells container.  The arrays are released afterwards.  Concurrent
+   * calls are serialized and only the first one converts. */
+  void ConvertCellsArraysToCells();
+
+  /** Return this mesh if its cells are stored as cell objects.  Otherwise
+   * return a new mesh sharing the points and the data of this one, with
+   * its own cell objects built from the arrays.  This mesh is not
+   * modified. */
+  ConstPointer GetMeshWithCellObjects() const;
+
+  /** Set the cells of \a mesh from compact arrays.  A plain Mesh keeps the
+   * arrays when \a useCellsArrays is true, see SetCellsArrays().
+   * Otherwise, and always for meshes derived from it which maintain their
+   * own cell structures (e.g. QuadEdgeMesh), the mesh gets one cell object
+   * per cell. */
+  template< typename TMesh >
+  static void SetCellsFromArrays(TMesh *mesh,
+                                 CellGeometriesContainer *geometries,
+                                 CellOffsetsContainer *offsets,
+                                 CellConnectivityContainer *connectivity,
+                                 bool useCellsArrays = false);
+
   /** Access m_CellDataContainer, which contains data associated with
    *  the mesh's cells.  Optionally, this can be nullptr, indicating that
    *  no data are associated with the cells.  The data for a cell can
@@ -344,7 +421,10 @@ public:
    *  and get information from it.  If SetCell is used to overwrite a
    *  cell currently in the mesh, it is the caller's responsibility to
    *  release the memory for the cell currently at the CellIdentifier
-   *  position prior to calling SetCell. */
+   *  position prior to calling SetCell.  When the cells are stored as
+   *  arrays, GetCell returns a newly created cell owned by \a cellPointer:
+   *  it is a read-only copy, changes made through it are not stored in
+   *  the mesh. */
   void SetCell(CellIdentifier, CellAutoPointer &);
   bool GetCell(CellIdentifier, CellAutoPointer &) const;
   /** Access routines to fill the CellData container, and get information
@@ -443,12 +523,24 @@ protected:
       SetCellsAllocationMethod()   */
   void ReleaseCellsMemory();
 
+  /** Create an empty cell of the given CellType::CellGeometry, or nullptr
+   * if the geometry is unknown. */
+  static CellType * CreateCell(unsigned char geometry);
+
   /** The bounding box (xmin,xmax, ymin,ymax, ...) of the mesh. The
    * bounding box is used for searching, picking, display, etc. */
   BoundingBoxPointer m_BoundingBox;
 
 private:
   CellsAllocationMethodType m_CellsAllocationMethod;
+
+  /** Compact cell storage, see SetCellsArrays(). */
+  CellGeometriesContainerPointer   m_CellGeometries;
+  CellOffsetsContainerPointer      m_CellOffsets;
+  CellConnectivityContainerPointer m_CellConnectivity;
+
+  /** Serializes ConvertCellsArraysToCells(). */
+  SimpleFastMutexLock m_CellsArraysLock;
 }; // End Class: Mesh
 } // end namespace itk
 
@@ -30,8 +30,19 @@
 
 #include "itkMesh.h"
 #include "itkProcessObject.h"
+#include "itkHexahedronCell.h"
+#include "itkLineCell.h"
+#include "itkPolygonCell.h"
+#include "itkQuadraticEdgeCell.h"
+#include "itkQuadraticTriangleCell.h"
+#include "itkQuadrilateralCell.h"
+#include "itkTetrahedronCell.h"
+#include "itkTriangleCell.h"
+#include "itkVertexCell.h"
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 
 namespace itk
 {
@@ -46,7 +57,9 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   os << indent << "Number Of Cell Links: "
      << ( ( m_CellLinksContainer ) ?  m_CellLinksContainer->Size() : 0 ) << std::endl;
   os << indent << "Number Of Cells: "
-     << ( ( m_CellsContainer ) ?  m_CellsContainer->Size() : 0 ) << std::endl;
+     << this->GetNumberOfCells() << std::endl;
+  os << indent << "Cells Stored As Arrays: "
+     << ( this->HasCellsArrays() ? "On" : "Off" ) << std::endl;
   os << indent << "Cell Data Container pointer: "
      << ( ( m_CellDataContainer ) ?  m_CellDataContainer.GetPointer() : nullptr ) << std::endl;
   os << indent << "Size of Cell Data Container: "
@@ -105,10 +118,13 @@ Mesh< TPixelType, VDimension, TMeshTraits >
 ::SetCells(CellsContainer *cells)
 {
   itkDebugMacro("setting Cells container to " << cells);
-  if ( m_CellsContainer != cells )
+  if ( m_CellsContainer != cells || this->HasCellsArrays() )
     {
     this->ReleaseCellsMemory();
     m_CellsContainer = cells;
+    m_CellGeometries = nullptr;
+    m_CellOffsets = nullptr;
+    m_CellConnectivity = nullptr;
     this->Modified();
     }
 }
@@ -121,6 +137,7 @@ typename Mesh< TPixelType, VDimension, TMeshTraits >::CellsContainer *
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetCells()
 {
+  this->ConvertCellsArraysToCells();
   itkDebugMacro("returning Cells container of " << m_CellsContainer);
   return m_CellsContainer;
 }
@@ -130,10 +147,101 @@ const typename Mesh< TPixelType, VDimension, TMeshTraits >::CellsContainer *
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetCells() const
 {
+  // Converting the arrays changes the representation of the cells, not the
+  // cells themselves.
+  const_cast< Self * >( this )->ConvertCellsArraysToCells();
   itkDebugMacro("returning Cells container of " << m_CellsContainer);
   return m_CellsContainer;
 }
 
+/**
+ * Access routine to store the cells as compact arrays.
+ */
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+void
+Mesh< TPixelType, VDimension, TMeshTraits >
+::SetCellsArrays(CellGeometriesContainer *geometries,
+                 CellOffsetsContainer *offsets,
+                 CellConnectivityContainer *connectivity)
+{
+  if ( geometries == nullptr || offsets == nullptr || connectivity == nullptr )
+    {
+    itkExceptionMacro(<< "The cell geometries, offsets and connectivity must all be provided");
+    }
+  if ( offsets->Size() != geometries->Size() + 1
+       || offsets->ElementAt(0) != 0
+       || offsets->ElementAt( geometries->Size() ) != connectivity->Size() )
+    {
+    itkExceptionMacro(<< "Cell offsets are inconsistent with the "
+                      << geometries->Size() << " cell geometries and the "
+                      << connectivity->Size() << " connectivity entries");
+    }
+  // One empty cell per geometry gives the expected number of points.
+  std::unique_ptr< CellType > prototypes[CellType::LAST_ITK_CELL];
+  for ( CellIdentifier cellId = 0; cellId < geometries->Size(); ++cellId )
+    {
+    const unsigned char geometry = geometries->ElementAt(cellId);
+    const SizeValueType numberOfPoints = offsets->ElementAt(cellId + 1) - offsets->ElementAt(cellId);
+    bool valid = geometry < CellType::LAST_ITK_CELL
+                 && offsets->ElementAt(cellId) <= offsets->ElementAt(cellId + 1);
+    if ( valid && geometry != CellType::POLYGON_CELL )
+      {
+      if ( !prototypes[geometry] )
+        {
+        prototypes[geometry].reset( Self::CreateCell(geometry) );
+        }
+      valid = ( numberOfPoints == prototypes[geometry]->GetNumberOfPoints() );
+      }
+    if ( !valid )
+      {
+      itkExceptionMacro(<< "Invalid cell " << cellId << " of geometry "
+                        << static_cast< unsigned int >( geometry ) << " with "
+                        << numberOfPoints << " points");
+      }
+    }
+
+  itkDebugMacro("setting Cells arrays");
+  this->ReleaseCellsMemory();
+  m_CellsContainer = nullptr;
+  m_CellsAllocationMethod = CellsAllocatedDynamicallyCellByCell;
+  m_CellGeometries = geometries;
+  m_CellOffsets = offsets;
+  m_CellConnectivity = connectivity;
+  this->Modified();
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+const typename Mesh< TPixelType, VDimension, TMeshTraits >::CellGeometriesContainer *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::GetCellGeometries() const
+{
+  return m_CellGeometries;
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+const typename Mesh< TPixelType, VDimension, TMeshTraits >::CellOffsetsContainer *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::GetCellOffsets() const
+{
+  return m_CellOffsets;
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+const typename Mesh< TPixelType, VDimension, TMeshTraits >::CellConnectivityContainer *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::GetCellConnectivity() const
+{
+  return m_CellConnectivity;
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+bool
+Mesh< TPixelType, VDimension, TMeshTraits >
+::HasCellsArrays() const
+{
+  return m_CellGeometries.IsNotNull();
+}
+
 /**
  * Access routine to set the cell data container.
  */
@@ -242,6 +350,8 @@ void
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::SetCell(CellIdentifier cellId, CellAutoPointer & cellPointer)
 {
+  this->ConvertCellsArraysToCells();
+
   /**
    * Make sure a cells container exists.
    */
@@ -268,6 +378,24 @@ bool
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetCell(CellIdentifier cellId, CellAutoPointer & cellPointer) const
 {
+  /**
+   * Cells stored as arrays are created on demand.
+   */
+  if ( this->HasCellsArrays() )
+    {
+    if ( cellId >= m_CellGeometries->Size() )
+      {
+      cellPointer.Reset();
+      return false;
+      }
+    const PointIdentifier *connectivity = m_CellConnectivity->CastToSTLConstContainer().data();
+    CellType *cell = Self::CreateCell( m_CellGeometries->ElementAt(cellId) );
+    cell->SetPointIds( connectivity + m_CellOffsets->ElementAt(cellId),
+                       connectivity + m_CellOffsets->ElementAt(cellId + 1) );
+    cellPointer.TakeOwnership(cell);
+    return true;
+    }
+
   /**
    * If the cells container doesn't exist, then the cell doesn't exist.
    */
@@ -380,8 +508,10 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   m_BoundaryAssignmentsContainers[dimension]->InsertElement(assignId, boundaryId);
 
   /**
-   * Add cellId to the UsingCells list of boundaryId.
+   * Add cellId to the UsingCells list of boundaryId.  This needs the
+   * actual cell object stored in the mesh.
    */
+  this->ConvertCellsArraysToCells();
   CellAutoPointer boundaryCell;
   this->GetCell(boundaryId, boundaryCell);
   boundaryCell->AddUsingCell(cellId);
@@ -457,6 +587,16 @@ typename Mesh< TPixelType, VDimension, TMeshTraits >::CellFeatureCount
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetNumberOfCellBoundaryFeatures(int dimension, CellIdentifier cellId) const
 {
+  /**
+   * Cells stored as arrays are created on demand.
+   */
+  if ( this->HasCellsArrays() )
+    {
+    CellAutoPointer cell;
+    if ( !this->GetCell(cellId, cell) ) { return 0; }
+    return cell->GetNumberOfBoundaryFeatures(dimension);
+    }
+
   /**
    * Make sure the cell container exists and contains the given cell Id.
    */
@@ -490,6 +630,10 @@ typename Mesh< TPixelType, VDimension, TMeshTraits >::CellIdentifier
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetNumberOfCells() const
 {
+  if ( this->HasCellsArrays() )
+    {
+    return m_CellGeometries->Size();
+    }
   if ( !m_CellsContainer )
     {
     return 0;
@@ -517,6 +661,9 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   m_CellsContainer = nullptr;
   m_CellDataContainer = nullptr;
   m_CellLinksContainer = nullptr;
+  m_CellGeometries = nullptr;
+  m_CellOffsets = nullptr;
+  m_CellConnectivity = nullptr;
 }
 
 /**
@@ -548,6 +695,18 @@ Mesh< TPixelType, VDimension, TMeshTraits >
    * This will be a geometric copy of the actual boundary feature, not
    * a pointer to an actual cell in the mesh.
    */
+  if ( this->HasCellsArrays() )
+    {
+    CellAutoPointer thecell;
+    if ( this->GetCell(cellId, thecell)
+         && thecell->GetBoundaryFeature(dimension, featureId, boundary) )
+      {
+      return true;
+      }
+    boundary.Reset();
+    return false;
+    }
+
   if ( ( !m_CellsContainer.IsNull() ) && m_CellsContainer->IndexExists(cellId) )
     {
     // Don't take ownership
@@ -589,6 +748,8 @@ Mesh< TPixelType, VDimension, TMeshTraits >
                                   CellFeatureIdentifier featureId,
                                   std::set< CellIdentifier > *cellSet)
 {
+  this->ConvertCellsArraysToCells();
+
   /**
    * Sanity check on mesh status.
    */
@@ -751,6 +912,8 @@ typename Mesh< TPixelType, VDimension, TMeshTraits >::CellIdentifier
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::GetCellNeighbors(CellIdentifier cellId, std::set< CellIdentifier > *cellSet)
 {
+  this->ConvertCellsArraysToCells();
+
   /**
    * Sanity check on mesh status.
    */
@@ -910,8 +1073,8 @@ Mesh< TPixelType, VDimension, TMeshTraits >
          GetElementIfIndexExists(assignId, &boundaryId) )
       {
       CellType * boundaryptr = nullptr;
-      const bool found = m_CellsContainer->
-                         GetElementIfIndexExists(boundaryId, &boundaryptr);
+      const bool found = m_CellsContainer
+                         && m_CellsContainer->GetElementIfIndexExists(boundaryId, &boundaryptr);
       if ( found )
         {
         boundary.TakeNoOwnership(boundaryptr);
@@ -934,6 +1097,27 @@ void
 Mesh< TPixelType, VDimension, TMeshTraits >
 ::Accept(CellMultiVisitorType *mv) const
 {
+  if ( this->HasCellsArrays() )
+    {
+    // One cell object per geometry is reused as a view on the arrays, so
+    // visiting does not allocate a cell per visited cell.
+    std::unique_ptr< CellType > views[CellType::LAST_ITK_CELL];
+    const PointIdentifier *connectivity = m_CellConnectivity->CastToSTLConstContainer().data();
+    const CellIdentifier numberOfCells = m_CellGeometries->Size();
+    for ( CellIdentifier cellId = 0; cellId < numberOfCells; ++cellId )
+      {
+      const unsigned char geometry = m_CellGeometries->ElementAt(cellId);
+      if ( !views[geometry] )
+        {
+        views[geometry].reset( Self::CreateCell(geometry) );
+        }
+      views[geometry]->SetPointIds( connectivity + m_CellOffsets->ElementAt(cellId),
+                                    connectivity + m_CellOffsets->ElementAt(cellId + 1) );
+      views[geometry]->Accept(cellId, mv);
+      }
+    return;
+    }
+
   if ( !this->m_CellsContainer )
     {
     return;
@@ -967,7 +1151,7 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   /**
    * Make sure we have a cells and a points container.
    */
-  if ( !this->m_PointsContainer || !m_CellsContainer )
+  if ( !this->m_PointsContainer || ( !m_CellsContainer && !this->HasCellsArrays() ) )
     {
     /**
      * TODO: Throw EXCEPTION here?
@@ -983,6 +1167,23 @@ Mesh< TPixelType, VDimension, TMeshTraits >
     this->m_CellLinksContainer = CellLinksContainer::New();
     }
 
+  /**
+   * Cells stored as arrays are traversed directly.
+   */
+  if ( this->HasCellsArrays() )
+    {
+    const CellIdentifier numberOfCells = m_CellGeometries->Size();
+    for ( CellIdentifier cellId = 0; cellId < numberOfCells; ++cellId )
+      {
+      for ( SizeValueType k = m_CellOffsets->ElementAt(cellId);
+            k < m_CellOffsets->ElementAt(cellId + 1); ++k )
+        {
+        ( m_CellLinksContainer->CreateElementAt( m_CellConnectivity->ElementAt(k) ) ).insert(cellId);
+        }
+      }
+    return;
+    }
+
   /**
    * Loop through each cell, and add its identifier to the CellLinks of each
    * of its points.
@@ -1129,6 +1330,138 @@ Mesh< TPixelType, VDimension, TMeshTraits >
     }
 }
 
+/**
+ * Create an empty cell for the given geometry.  Polygons are created
+ * without points; every other cell has its fixed number of points.
+ */
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+typename Mesh< TPixelType, VDimension, TMeshTraits >::CellType *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::CreateCell(unsigned char geometry)
+{
+  switch ( geometry )
+    {
+    case CellType::VERTEX_CELL:
+      return new VertexCell< CellType >;
+    case CellType::LINE_CELL:
+      return new LineCell< CellType >;
+    case CellType::TRIANGLE_CELL:
+      return new TriangleCell< CellType >;
+    case CellType::QUADRILATERAL_CELL:
+      return new QuadrilateralCell< CellType >;
+    case CellType::POLYGON_CELL:
+      return new PolygonCell< CellType >;
+    case CellType::TETRAHEDRON_CELL:
+      return new TetrahedronCell< CellType >;
+    case CellType::HEXAHEDRON_CELL:
+      return new HexahedronCell< CellType >;
+    case CellType::QUADRATIC_EDGE_CELL:
+      return new QuadraticEdgeCell< CellType >;
+    case CellType::QUADRATIC_TRIANGLE_CELL:
+      return new QuadraticTriangleCell< CellType >;
+    default:
+      return nullptr;
+    }
+}
+
+/**
+ * Replace the compact cell arrays by one cell object per cell.  The
+ * methods needing persistent cell objects call this the first time they
+ * are used.
+ */
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+void
+Mesh< TPixelType, VDimension, TMeshTraits >
+::ConvertCellsArraysToCells()
+{
+  MutexLockHolder< SimpleFastMutexLock > lockHolder(m_CellsArraysLock);
+  if ( !this->HasCellsArrays() )
+    {
+    return;
+    }
+
+  itkDebugMacro("converting Cells arrays to Cells container");
+  const PointIdentifier *connectivity = m_CellConnectivity->CastToSTLConstContainer().data();
+  const CellIdentifier   numberOfCells = m_CellGeometries->Size();
+
+  CellsContainerPointer cells = CellsContainer::New();
+  cells->Reserve(numberOfCells);
+  for ( CellIdentifier cellId = 0; cellId < numberOfCells; ++cellId )
+    {
+    CellType *cell = Self::CreateCell( m_CellGeometries->ElementAt(cellId) );
+    cell->SetPointIds( connectivity + m_CellOffsets->ElementAt(cellId),
+                       connectivity + m_CellOffsets->ElementAt(cellId + 1) );
+    cells->SetElement(cellId, cell);
+    }
+
+  // SetCellsArrays() set the allocation method to
+  // CellsAllocatedDynamicallyCellByCell, which matches the cells created
+  // here.
+  m_CellsContainer = cells;
+  m_CellGeometries = nullptr;
+  m_CellOffsets = nullptr;
+  m_CellConnectivity = nullptr;
+}
+
+/**
+ * Const readers needing the cells container work on a copy of an
+ * array-backed mesh, so that the mesh itself is never modified.
+ */
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+typename Mesh< TPixelType, VDimension, TMeshTraits >::ConstPointer
+Mesh< TPixelType, VDimension, TMeshTraits >
+::GetMeshWithCellObjects() const
+{
+  if ( !this->HasCellsArrays() )
+    {
+    return this;
+    }
+
+  Pointer mesh = Self::New();
+  mesh->Graft(this);
+  mesh->ConvertCellsArraysToCells();
+  return mesh.GetPointer();
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+template< typename TMesh >
+void
+Mesh< TPixelType, VDimension, TMeshTraits >
+::SetCellsFromArrays(TMesh *mesh,
+                     CellGeometriesContainer *geometries,
+                     CellOffsetsContainer *offsets,
+                     CellConnectivityContainer *connectivity,
+                     bool useCellsArrays)
+{
+  using PlainMeshType = Mesh< typename TMesh::PixelType, TMesh::PointDimension,
+                              typename TMesh::MeshTraits >;
+  if ( std::is_same< TMesh, PlainMeshType >::value )
+    {
+    mesh->SetCellsArrays(geometries, offsets, connectivity);
+    if ( !useCellsArrays )
+      {
+      mesh->ConvertCellsArraysToCells();
+      }
+    return;
+    }
+
+  const PointIdentifier *pointIds = connectivity->CastToSTLConstContainer().data();
+  const CellIdentifier   numberOfCells = geometries->Size();
+  for ( CellIdentifier cellId = 0; cellId < numberOfCells; ++cellId )
+    {
+    CellType *newCell = Self::CreateCell( geometries->ElementAt(cellId) );
+    if ( newCell == nullptr )
+      {
+      itkGenericExceptionMacro(<< "Unknown geometry of cell " << cellId);
+      }
+    newCell->SetPointIds( pointIds + offsets->ElementAt(cellId),
+                          pointIds + offsets->ElementAt(cellId + 1) );
+    CellAutoPointer cell;
+    cell.TakeOwnership(newCell);
+    mesh->SetCell(cellId, cell);
+    }
+}
+
 template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
 void
 Mesh< TPixelType, VDimension, TMeshTraits >
@@ -1171,6 +1504,9 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   this->m_CellDataContainer  = mesh->m_CellDataContainer;
   this->m_CellLinksContainer = mesh->m_CellLinksContainer;
   this->m_BoundaryAssignmentsContainers = mesh->m_BoundaryAssignmentsContainers;
+  this->m_CellGeometries     = mesh->m_CellGeometries;
+  this->m_CellOffsets        = mesh->m_CellOffsets;
+  this->m_CellConnectivity   = mesh->m_CellConnectivity;
 
   // The cell allocation method must be maintained. The reference count
   // test on the container will prevent premature deletion of cells.
@@ -75,6 +75,15 @@ public:
 
   OutputMeshType * GetOutput(unsigned int idx);
 
+  /** Set/Get whether a Mesh output keeps its cells as compact arrays
+   * (see Mesh::SetCellsArrays()) when the source produces them this way,
+   * instead of one cell object per cell.  This saves memory, but the cells
+   * are converted the first time the cells container is requested.  Off by
+   * default. */
+  itkSetMacro(UseCellsArrays, bool);
+  itkGetConstMacro(UseCellsArrays, bool);
+  itkBooleanMacro(UseCellsArrays);
+
   /** Set the mesh output of this process object. This call is slated
    * to be removed from ITK. You should GraftOutput() and possible
    * DataObject::DisconnectPipeline() to properly change the output. */
@@ -158,6 +167,8 @@ private:
    * by the execute method. Set in the GenerateInputRequestedRegion method. */
   int m_GenerateDataRegion;
   int m_GenerateDataNumberOfRegions;
+
+  bool m_UseCellsArrays;
 };
 } // end namespace itk
 
@@ -39,6 +39,7 @@ MeshSource< TOutputMesh >
 
   m_GenerateDataRegion = 0;
   m_GenerateDataNumberOfRegions = 0;
+  m_UseCellsArrays = false;
 }
 
 /**
@@ -157,6 +158,8 @@ MeshSource< TOutputMesh >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseCellsArrays: " << m_UseCellsArrays << std::endl;
 }
 } // end namespace itk
 
@@ -195,6 +195,30 @@ MeshToMeshFilter< TInputMesh, TOutputMesh >
 
   outputMesh->SetCellsAllocationMethod(OutputMeshType::CellsAllocatedDynamicallyCellByCell);
 
+  // Cells stored as compact arrays are copied as arrays, without creating a
+  // cell object per cell when the output is a plain Mesh.
+  if ( inputMesh->HasCellsArrays() )
+    {
+    using OutputCellGeometriesContainer = typename TOutputMesh::CellGeometriesContainer;
+    using OutputCellOffsetsContainer = typename TOutputMesh::CellOffsetsContainer;
+    using OutputCellConnectivityContainer = typename TOutputMesh::CellConnectivityContainer;
+
+    const auto & inputGeometries = inputMesh->GetCellGeometries()->CastToSTLConstContainer();
+    const auto & inputOffsets = inputMesh->GetCellOffsets()->CastToSTLConstContainer();
+    const auto & inputConnectivity = inputMesh->GetCellConnectivity()->CastToSTLConstContainer();
+
+    typename OutputCellGeometriesContainer::Pointer outputGeometries = OutputCellGeometriesContainer::New();
+    outputGeometries->CastToSTLContainer().assign( inputGeometries.begin(), inputGeometries.end() );
+    typename OutputCellOffsetsContainer::Pointer outputOffsets = OutputCellOffsetsContainer::New();
+    outputOffsets->CastToSTLContainer().assign( inputOffsets.begin(), inputOffsets.end() );
+    typename OutputCellConnectivityContainer::Pointer outputConnectivity = OutputCellConnectivityContainer::New();
+    outputConnectivity->CastToSTLContainer().assign( inputConnectivity.begin(), inputConnectivity.end() );
+
+    OutputMeshType::SetCellsFromArrays(outputMesh.GetPointer(), outputGeometries, outputOffsets, outputConnectivity,
+                                       this->GetUseCellsArrays());
+    return;
+    }
+
   typename OutputCellsContainer::Pointer outputCells = OutputCellsContainer::New();
   const InputCellsContainer *inputCells = inputMesh->GetCells();
 
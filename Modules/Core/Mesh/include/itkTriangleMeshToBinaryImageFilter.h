@@ -25,11 +25,17 @@
 #include "itkVectorContainer.h"
 #include "itkAutomaticTopologyMeshSource.h"
 #include "itkPointSet.h"
+#include "itkImage.h"
+#include "itkContinuousIndex.h"
+#include "itkIntTypes.h"
 
 #include <vector>
 
 namespace itk
 {
+#if !defined( ITK_LEGACY_REMOVE )
+/** \deprecated Only used by the legacy
+ * TriangleMeshToBinaryImageFilter::PolygonToImageRaster(). */
 class Point1D
 {
 public:
@@ -59,11 +65,42 @@ public:
     return m_Sign;
   }
 };
+#endif
 
 /** \class TriangleMeshToBinaryImageFilter
  *
- * \brief 3D Rasterization algorithm Courtesy of Dr David Gobbi of Atamai Inc.
-
+ * \brief Rasterizes closed triangle meshes into a binary or label image.
+ *
+ * A voxel is inside a mesh when a ray cast from its center along the
+ * first index axis crosses the surface an odd number of times. The
+ * crossings of every ray are found exactly: the mesh points are mapped
+ * to continuous index coordinates, their projection onto the second and
+ * third index axes is snapped to a fixed-point grid, and each triangle
+ * is tested against the ray with integer orientation predicates and a
+ * symbolic perturbation of the ray for rays through edges or vertices.
+ * Neighbouring triangles therefore agree on every shared edge, and the
+ * result of a watertight mesh has neither holes nor streaks whatever its
+ * resolution. Polygon cells are triangulated as fans; vertex and line
+ * cells are ignored.
+ *
+ * The triangles are binned by the slices of the output they span, once
+ * per update, and the output is then filled in parallel: each thread
+ * rasterizes the slices of its own slab of the requested region.
+ *
+ * Several meshes can be rasterized in one pass into a label image, by
+ * setting them as the indexed inputs of the filter: the voxels inside
+ * the mesh of input \c i are set to InsideValue + \c i, a later input
+ * overriding an earlier one where the meshes overlap.
+ *
+ * When ComputeSignedDistance is on, the second output also receives the
+ * signed distance, in physical units, from the center of each voxel to
+ * the closest surface, negative inside the meshes. Distances are only
+ * computed exactly up to MaximumDistance; farther voxels are set to
+ * plus or minus MaximumDistance.
+ *
+ * The geometry of the output is given either by the Size, Index,
+ * Spacing, Origin and Direction of the filter, or by an InfoImage.
+ *
  * \author Leila Baghdadi, MICe, Hospital for Sick Childern, Toronto, Canada,
  * \ingroup ITKMesh
  */
@@ -110,24 +147,32 @@ public:
   using InputPointsContainerPointer = typename InputPointsContainer::Pointer;
   using InputPointsContainerIterator = typename InputPointsContainer::Iterator;
 
+  using PointType = itk::Point< double, 3 >;
+
+#if !defined( ITK_LEGACY_REMOVE )
+  /** \deprecated Types of the scan line rasterization used before the
+   * crossings were computed exactly, only used by the legacy
+   * PolygonToImageRaster(). */
   using PointSetType = itk::PointSet< double, 3 >;
   using PointsContainer = typename PointSetType::PointsContainer;
-
-  using PointType = itk::Point< double, 3 >;
   using Point2DType = itk::Point< double, 2 >;
-
   using DoubleArrayType = itk::Array< double >;
-
   using Point1DVector = std::vector< Point1D >;
   using Point1DArray = std::vector< std::vector< Point1D > >;
-
   using Point2DVector = std::vector< Point2DType >;
   using Point2DArray = std::vector< std::vector< Point2DType > >;
-
   using PointVector = std::vector< PointType >;
   using PointArray = std::vector< std::vector< PointType > >;
-
   using StencilIndexVector = std::vector< int >;
+#endif
+
+  /** Type of the signed distance output. */
+  using DistanceImageType = Image< float, 3 >;
+  using DistanceImagePointer = typename DistanceImageType::Pointer;
+
+  static_assert( TOutputImage::ImageDimension == 3,
+                 "TriangleMeshToBinaryImageFilter only rasterizes into 3D images" );
+
   /** Spacing (size of a pixel) of the output image. The
    * spacing is the geometric distance between image samples.
    * It is stored internally as double, but may be set from
@@ -145,19 +190,13 @@ public:
   itkSetMacro(Direction, DirectionType);
   itkGetConstMacro(Direction, DirectionType);
 
-  /** Set/Get the value for pixels inside the spatial object.
-  * By default, this filter will return an image
-  * If this "inside" value is changed to a non-null value,
-  * the output produced by this filter will be a mask with inside/outside values
-  * specified by the user. */
+  /** Set/Get the value for pixels inside the mesh. With several input
+   * meshes, the pixels inside the mesh of input i are set to
+   * InsideValue + i. */
   itkSetMacro(InsideValue, ValueType);
   itkGetConstMacro(InsideValue, ValueType);
 
-  /** Set/Get the value for pixels outside the spatial object.
-  * By default, this filter will return an image
-  * If this "outside" value is changed to a non-null value,
-  * the output produced by this filter will be a mask with inside/outside values
-  * specified by the user. */
+  /** Set/Get the value for pixels outside the meshes. */
   itkSetMacro(OutsideValue, ValueType);
   itkGetConstMacro(OutsideValue, ValueType);
 
@@ -184,6 +223,10 @@ public:
   using Superclass::SetInput;
   void SetInput(InputMeshType *input);
 
+  /** Set the mesh of the given index, rasterized with the label
+   * InsideValue + idx. */
+  void SetInput(unsigned int idx, InputMeshType *input);
+
   void SetInfoImage(OutputImageType *InfoImage)
   {
     if ( InfoImage != m_InfoImage )
@@ -198,20 +241,57 @@ public:
 
   InputMeshType * GetInput(unsigned int idx);
 
-  /* Set the tolerance for doing spatial searches of the polydata. */
-  itkSetMacro(Tolerance, double);
-  itkGetConstMacro(Tolerance, double);
+#if !defined( ITK_LEGACY_REMOVE )
+  /** \deprecated Set/Get the tolerance used to merge nearby crossings of
+   * a ray with the surface. The crossings are now computed exactly and
+   * never merged, so the tolerance has no effect. */
+  itkLegacyMacro(virtual void SetTolerance(double tolerance));
+  itkLegacyMacro(virtual double GetTolerance() const);
+#endif
+
+  /** Set/Get whether the signed distance to the surface is computed into
+   * the second output. Off by default. */
+  itkSetMacro(ComputeSignedDistance, bool);
+  itkGetConstMacro(ComputeSignedDistance, bool);
+  itkBooleanMacro(ComputeSignedDistance);
+
+  /** Set/Get the distance, in physical units, up to which the signed
+   * distance is computed exactly. Defaults to 5. */
+  itkSetClampMacro(MaximumDistance, double, 0.0, NumericTraits< double >::max());
+  itkGetConstMacro(MaximumDistance, double);
+
+  /** Get the signed distance output. It is only filled when
+   * ComputeSignedDistance is on. */
+  DistanceImageType * GetDistanceOutput();
 
 protected:
   TriangleMeshToBinaryImageFilter();
-  ~TriangleMeshToBinaryImageFilter() override;
+  ~TriangleMeshToBinaryImageFilter() override = default;
 
-  void GenerateOutputInformation() override {}  // do nothing
-  void GenerateData() override;
+  using Superclass::MakeOutput;
+  ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx) override;
 
+  void GenerateOutputInformation() override;
+
+  void AllocateOutputs() override;
+
+  void BeforeThreadedGenerateData() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) override;
+
+  void AfterThreadedGenerateData() override;
+
+  /** Map the points of the meshes to the output grid and collect their
+   * triangles. */
   virtual void RasterizeTriangles();
 
-  static int PolygonToImageRaster(PointVector coords, Point1DArray & zymatrix, int extent[6]);
+#if !defined( ITK_LEGACY_REMOVE )
+  /** \deprecated Scan convert a single polygon, given in continuous index
+   * coordinates, into the x coordinates of its crossings with the rows of
+   * extent. The filter no longer uses it. */
+  itkLegacyMacro(static int PolygonToImageRaster(PointVector coords, Point1DArray & zymatrix, int extent[6]));
+#endif
 
   OutputImageType *m_InfoImage;
 
@@ -223,21 +303,92 @@ protected:
 
   PointType m_Origin;        //start value
 
+#if !defined( ITK_LEGACY_REMOVE )
   double m_Tolerance;
+#endif
 
   ValueType m_InsideValue;
   ValueType m_OutsideValue;
 
   DirectionType m_Direction;
 
-  StencilIndexVector m_StencilIndex;
+  bool m_ComputeSignedDistance;
+
+  double m_MaximumDistance;
 
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+#if !defined( ITK_LEGACY_REMOVE )
   static bool ComparePoints2D(Point2DType a, Point2DType b);
+#endif
+
+  /** Fixed-point coordinates on the second and third index axes, with
+   * eight fractional bits. */
+  using FixedType = int64_t;
+  static constexpr double FixedOne = 256.0;
+  static constexpr double FixedLimit = 536870912.0;
+
+  /** A mesh point mapped to the output grid. */
+  struct RasterPoint
+  {
+    ContinuousIndex< double, 3 > m_Index;
+    FixedType m_Y;
+    FixedType m_Z;
+    PointType m_Physical;
+  };
+
+  /** A triangle, as three indices in m_Points, and its label. */
+  struct RasterTriangle
+  {
+    SizeValueType m_Points[3];
+    unsigned int  m_Label;
+  };
+
+  /** A crossing of a ray with the mesh of a label. */
+  struct Crossing
+  {
+    unsigned int m_Label;
+    double       m_X;
+
+    bool operator<(const Crossing & other) const
+    {
+      return m_Label < other.m_Label || ( m_Label == other.m_Label && m_X < other.m_X );
+    }
+  };
+
+  /** The triangles spanning each slice of the requested region. */
+  struct SliceBins
+  {
+    std::vector< SizeValueType > m_Offsets;
+    std::vector< SizeValueType > m_Triangles;
+    IndexValueType               m_First;
+  };
+
+  static FixedType ToFixed(double x);
+
+  static int EdgeSign(const RasterPoint & a, const RasterPoint & b, FixedType y, FixedType z, FixedType & e);
+
+  static double OrientationDeterminant(const ContinuousIndex< double, 3 > & a, const ContinuousIndex< double, 3 > & b,
+                                       double y, double z);
+
+  /** Bin the triangles by the slices they span, padded by pad slices. */
+  void BinTriangles(double pad, SliceBins & bins) const;
+
+  void RasterizeSlice(IndexValueType z, const OutputImageRegionType & region,
+                      std::vector< std::vector< Crossing > > & rows);
+
+  void ComputeSliceDistance(IndexValueType z, const OutputImageRegionType & region);
+
+  static double SquaredDistanceToTriangle(const PointType & p, const PointType & a,
+                                          const PointType & b, const PointType & c);
 
-  static bool ComparePoints1D(Point1D a, Point1D b);
+  std::vector< RasterPoint >    m_Points;
+  std::vector< RasterTriangle > m_Triangles;
+  SliceBins                     m_SliceBins;
+  SliceBins                     m_DistanceSliceBins;
+  Matrix< double, 3, 3 >        m_IndexToPhysical;
+  Vector< double, 3 >           m_DistancePadding;
 };
 } // end namespace itk
 
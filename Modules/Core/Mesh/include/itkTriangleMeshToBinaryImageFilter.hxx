@@ -19,9 +19,10 @@
 #define itkTriangleMeshToBinaryImageFilter_hxx
 
 #include "itkTriangleMeshToBinaryImageFilter.h"
-#include "itkImageRegionIteratorWithIndex.h"
 #include "itkNumericTraits.h"
-#include <cstdlib>
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -32,6 +33,10 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 {
   this->SetNumberOfRequiredInputs(1);
 
+  // The second output holds the signed distance to the surface.
+  this->SetNumberOfRequiredOutputs(2);
+  this->ProcessObject::SetNthOutput( 1, this->MakeOutput(1) );
+
   m_Size.Fill(0);
   m_Index.Fill(0);
 
@@ -45,15 +50,34 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   m_OutsideValue = NumericTraits< ValueType >::ZeroValue();
   m_Direction.GetVnlMatrix().set_identity();
 
+#if !defined( ITK_LEGACY_REMOVE )
   m_Tolerance = 1e-5;
+#endif
   m_InfoImage = nullptr;
+
+  m_ComputeSignedDistance = false;
+  m_MaximumDistance = 5.0;
+}
+
+template< typename TInputMesh, typename TOutputImage >
+ProcessObject::DataObjectPointer
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx)
+{
+  if ( idx == 1 )
+    {
+    return DistanceImageType::New().GetPointer();
+    }
+  return Superclass::MakeOutput(idx);
 }
 
-/** Destructor */
 template< typename TInputMesh, typename TOutputImage >
+typename TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >::DistanceImageType *
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::~TriangleMeshToBinaryImageFilter()
-{}
+::GetDistanceOutput()
+{
+  return static_cast< DistanceImageType * >( this->ProcessObject::GetOutput(1) );
+}
 
 /** Set the Input Mesh */
 template< typename TInputMesh, typename TOutputImage >
@@ -64,13 +88,21 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   this->ProcessObject::SetNthInput(0, input);
 }
 
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::SetInput(unsigned int idx, TInputMesh *input)
+{
+  this->ProcessObject::SetNthInput(idx, input);
+}
+
 /** Get the input Mesh */
 template< typename TInputMesh, typename TOutputImage >
 typename TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >::InputMeshType *
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 ::GetInput(void)
 {
-  return static_cast< TInputMesh * >( this->GetInput() );
+  return static_cast< TInputMesh * >( this->ProcessObject::GetInput(0) );
 }
 
 /** Get the input Mesh */
@@ -130,122 +162,46 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   this->SetOrigin(p);
 }
 
-// used by an STL sort
+#if !defined( ITK_LEGACY_REMOVE )
 template< typename TInputMesh, typename TOutputImage >
-bool
+void
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::ComparePoints2D(Point2DType a, Point2DType b)
+::SetTolerance(double tolerance)
 {
-  // sort xy points by ascending y value, then x
-  if ( Math::ExactlyEquals(a[1], b[1]) )
-    {
-    return ( a[0] < b[0] );
-    }
-  else
+  itkLegacyBodyMacro(TriangleMeshToBinaryImageFilter::SetTolerance, 5.0);
+  if ( Math::NotExactlyEquals(m_Tolerance, tolerance) )
     {
-    return ( a[1] < b[1] );
+    m_Tolerance = tolerance;
+    this->Modified();
     }
 }
 
-// used by an STL sort
 template< typename TInputMesh, typename TOutputImage >
-bool
+double
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::ComparePoints1D(Point1D a, Point1D b)
+::GetTolerance() const
 {
-  return ( a.m_X < b.m_X );
+  itkLegacyBodyMacro(TriangleMeshToBinaryImageFilter::GetTolerance, 5.0);
+  return m_Tolerance;
 }
 
-//----------------------------------------------------------------------------
-
-/** Update */
+// used by an STL sort
 template< typename TInputMesh, typename TOutputImage >
-void
+bool
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::GenerateData(void)
+::ComparePoints2D(Point2DType a, Point2DType b)
 {
-  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() called");
-
-  // Get the input and output pointers
-  OutputImagePointer OutputImage = this->GetOutput();
-  if ( m_InfoImage == nullptr )
+  // sort xy points by ascending y value, then x
+  if ( Math::ExactlyEquals(a[1], b[1]) )
     {
-    if ( m_Size[0] == 0 ||  m_Size[1] == 0 ||  m_Size[2] == 0 )
-      {
-      itkExceptionMacro(<< "Must Set Image Size");
-      }
-
-    typename OutputImageType::RegionType region;
-
-    region.SetSize (m_Size);
-    region.SetIndex(m_Index);
-
-    OutputImage->SetLargestPossibleRegion(region); //
-    OutputImage->SetBufferedRegion(region);        // set the region
-    OutputImage->SetRequestedRegion(region);       //
-    OutputImage->SetSpacing(m_Spacing);            // set spacing
-    OutputImage->SetOrigin(m_Origin);              //   and origin
-    OutputImage->SetDirection(m_Direction);        // direction cosines
+    return ( a[0] < b[0] );
     }
   else
     {
-    itkDebugMacro(<< "Using info image");
-    m_InfoImage->Update();
-    OutputImage->CopyInformation(m_InfoImage);
-    OutputImage->SetRegions( m_InfoImage->GetLargestPossibleRegion() );
-    m_Size = m_InfoImage->GetLargestPossibleRegion().GetSize();
-    m_Index = m_InfoImage->GetLargestPossibleRegion().GetIndex();
-    m_Spacing = m_InfoImage->GetSpacing();
-    m_Origin = m_InfoImage->GetOrigin();
-    m_Direction = m_InfoImage->GetDirection();
+    return ( a[1] < b[1] );
     }
+}
 
-  OutputImage->Allocate();
-
-  RasterizeTriangles();
-
-  using myIteratorType = itk::ImageRegionIteratorWithIndex< OutputImageType >;
-
-  myIteratorType it( OutputImage, OutputImage->GetLargestPossibleRegion() );
-
-  int DataIndex = 0;
-  int StencilId = 0;
-  it.GoToBegin();
-
-  size_t n = m_StencilIndex.size();
-  if ( n == 0 )
-    {
-    itkWarningMacro(<< "No Image Indices Found.");
-    }
-  else
-    {
-    int StencilMin = m_StencilIndex[0];
-    int StencilMax = m_StencilIndex[n - 1];
-
-    while ( !it.IsAtEnd() )
-      {
-      if ( DataIndex >= StencilMin && DataIndex <= StencilMax )
-        {
-        if ( DataIndex == m_StencilIndex[StencilId] )
-          {
-          it.Set(m_InsideValue);
-          StencilId++;
-          }
-        else
-          {
-          it.Set(m_OutsideValue);
-          }
-        }
-      else
-        {
-        it.Set(m_OutsideValue);
-        }
-      DataIndex++;
-      ++it;
-      }
-    }
-  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() finished");
-} // end update function
 
 //----------------------------------------------------------------------------
 /** convert a single polygon/triangle to raster format */
@@ -254,6 +210,8 @@ int
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 ::PolygonToImageRaster(PointVector coords, Point1DArray & zymatrix, int extent[6])
 {
+  itkGenericLegacyBodyMacro(TriangleMeshToBinaryImageFilter::PolygonToImageRaster, 5.0);
+
   // convert the polgon into a rasterizable form by finding its
   // intersection with each z plane, and store the (x,y) coords
   // of each intersection in a vector called "matrix"
@@ -389,173 +347,607 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 
   return sign;
 }
+#endif
 
-/** raterize : Courtesy of Dr D Gobbi of Atamai Inc.*/
+//----------------------------------------------------------------------------
 template< typename TInputMesh, typename TOutputImage >
 void
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::RasterizeTriangles()
+::GenerateOutputInformation()
 {
-  InputMeshPointer input = this->GetInput(0);
+  OutputImageType *            output = this->GetOutput();
+  const OutputImageRegionType previousRegion = output->GetLargestPossibleRegion();
 
-  InputPointsContainerPointer  myPoints = input->GetPoints();
-  InputPointsContainerIterator points = myPoints->Begin();
+  if ( m_InfoImage == nullptr )
+    {
+    if ( m_Size[0] == 0 ||  m_Size[1] == 0 ||  m_Size[2] == 0 )
+      {
+      itkExceptionMacro(<< "Must Set Image Size");
+      }
 
-  int extent[6];
+    OutputImageRegionType region;
+    region.SetSize(m_Size);
+    region.SetIndex(m_Index);
 
-  // create a similar extent like vtk
-  extent[0] = m_Index[0];
-  extent[1] = m_Size[0] - 1;
-  extent[2] = m_Index[1];
-  extent[3] = m_Size[1] - 1;
-  extent[4] = m_Index[2];
-  extent[5] = m_Size[2] - 1;
+    output->SetLargestPossibleRegion(region);
+    output->SetSpacing(m_Spacing);
+    output->SetOrigin(m_Origin);
+    output->SetDirection(m_Direction);
+    }
+  else
+    {
+    itkDebugMacro(<< "Using info image");
+    m_InfoImage->Update();
+    output->CopyInformation(m_InfoImage);
+    output->SetLargestPossibleRegion( m_InfoImage->GetLargestPossibleRegion() );
+    m_Size = m_InfoImage->GetLargestPossibleRegion().GetSize();
+    m_Index = m_InfoImage->GetLargestPossibleRegion().GetIndex();
+    m_Spacing = m_InfoImage->GetSpacing();
+    m_Origin = m_InfoImage->GetOrigin();
+    m_Direction = m_InfoImage->GetDirection();
+    }
 
-  OutputImagePointer OutputImage = this->GetOutput();
+  DistanceImageType *distance = this->GetDistanceOutput();
+  distance->SetLargestPossibleRegion( output->GetLargestPossibleRegion() );
+  distance->SetSpacing( output->GetSpacing() );
+  distance->SetOrigin( output->GetOrigin() );
+  distance->SetDirection( output->GetDirection() );
 
-  // need to transform points from physical to index coordinates
-  PointsContainer::Pointer NewPoints = PointsContainer::New();
-  PointSetType::Pointer    NewPointSet = PointSetType::New();
-  PointSetType::PointType  newpoint;
+  // A requested region left from a previous geometry is reset, as the
+  // regions of the output used to be set by GenerateData.
+  if ( output->GetLargestPossibleRegion() != previousRegion )
+    {
+    output->SetRequestedRegionToLargestPossibleRegion();
+    distance->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
 
-  // the index value type must match the point value type
-  ContinuousIndex< PointType::ValueType, 3 > ind;
-  unsigned int                               pointId = 0;
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::AllocateOutputs()
+{
+  OutputImageType *output = this->GetOutput();
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
 
-  while ( points != myPoints->End() )
+  // The distance output is left empty unless it is computed.
+  DistanceImageType *distance = this->GetDistanceOutput();
+  if ( m_ComputeSignedDistance )
     {
-    PointType p = points.Value();
-    OutputImage->TransformPhysicalPointToContinuousIndex(p, ind);
-    NewPoints->InsertElement(pointId++, ind);
-
-    points++;
+    distance->SetBufferedRegion( distance->GetRequestedRegion() );
     }
-  NewPointSet->SetPoints(NewPoints);
-
-  // the stencil is kept in 'zymatrix' that provides
-  // the x extents for each (y,z) coordinate for which a ray
-  // parallel to the x axis intersects the polydata
-  int          zInc = extent[3] - extent[2] + 1;
-  int          zSize = extent[5] - extent[4] + 1;
-  Point1DArray zymatrix(zInc * zSize);
-  PointVector  coords;
+  else
+    {
+    distance->SetBufferedRegion( OutputImageRegionType() );
+    }
+  distance->Allocate();
+}
 
-  CellsContainerPointer  cells = input->GetCells();
-  CellsContainerIterator cellIt = cells->Begin();
+//----------------------------------------------------------------------------
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  this->RasterizeTriangles();
 
-  while ( cellIt != cells->End() )
+  if ( m_Triangles.empty() )
     {
-    CellType *nextCell = cellIt->Value();
-    typename CellType::PointIdIterator pointIt = nextCell->PointIdsBegin();
-    PointType p;
+    itkWarningMacro(<< "No Image Indices Found.");
+    }
+
+  this->BinTriangles(0.0, m_SliceBins);
 
-    switch ( nextCell->GetType() )
+  if ( m_ComputeSignedDistance )
+    {
+    // A ball of radius MaximumDistance spans, along each index axis, the
+    // norm of the corresponding row of the physical to index matrix.
+    const OutputImageType *output = this->GetOutput();
+    for ( unsigned int i = 0; i < 3; ++i )
       {
-      case CellType::VERTEX_CELL:
-      case CellType::LINE_CELL:
-        break;
-      case CellType::TRIANGLE_CELL:
-      case CellType::POLYGON_CELL:
+      for ( unsigned int j = 0; j < 3; ++j )
         {
-        coords.clear();
-        while ( pointIt != nextCell->PointIdsEnd() )
-          {
-          if ( !NewPointSet->GetPoint(*pointIt++, &newpoint) )
-            {
-            itkExceptionMacro ("Point with id " << *pointIt - 1
-                                                << " does not exist in the new pointset");
-            }
-          p[0] = newpoint[0];
-          p[1] = newpoint[1];
-          p[2] = newpoint[2];
-          coords.push_back(p);
-          }
-        this->PolygonToImageRaster(coords, zymatrix, extent);
+        m_IndexToPhysical[i][j] = output->GetDirection()[i][j] * output->GetSpacing()[j];
         }
-        break;
-      default:
-        itkExceptionMacro(<< "Need Triangle or Polygon cells ONLY");
       }
-    cellIt++;
+    const vnl_matrix_fixed< double, 3, 3 > physicalToIndex = m_IndexToPhysical.GetInverse();
+    for ( unsigned int i = 0; i < 3; ++i )
+      {
+      m_DistancePadding[i] = m_MaximumDistance * physicalToIndex.get_row(i).magnitude();
+      }
+    this->BinTriangles(m_DistancePadding[2], m_DistanceSliceBins);
     }
+}
 
-  //create the equivalent of vtkStencilData from our zymatrix
-  m_StencilIndex.clear(); //prevent corruption of the filter in later updates
-  for ( int z = extent[4]; z <= extent[5]; z++ )
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const IndexValueType zBegin = outputRegionForThread.GetIndex(2);
+  const IndexValueType zEnd = zBegin + static_cast< IndexValueType >( outputRegionForThread.GetSize(2) );
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetSize(2) );
+
+  std::vector< std::vector< Crossing > > rows( outputRegionForThread.GetSize(1) );
+  for ( IndexValueType z = zBegin; z < zEnd; ++z )
     {
-    for ( int y = extent[2]; y <= extent[3]; y++ )
+    this->RasterizeSlice(z, outputRegionForThread, rows);
+    if ( m_ComputeSignedDistance )
       {
-      int           zyidx = ( z - extent[4] ) * zInc + ( y - extent[2] );
-      Point1DVector xlist = zymatrix[zyidx];
+      this->ComputeSliceDistance(z, outputRegionForThread);
+      }
+    progress.CompletedPixel();
+    }
+}
 
-      if ( xlist.size() <= 1 )
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  // Release the rasterization structures.
+  std::vector< RasterPoint >().swap(m_Points);
+  std::vector< RasterTriangle >().swap(m_Triangles);
+  m_SliceBins = SliceBins();
+  m_DistanceSliceBins = SliceBins();
+}
+
+//----------------------------------------------------------------------------
+template< typename TInputMesh, typename TOutputImage >
+typename TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >::FixedType
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::ToFixed(double x)
+{
+  // Coordinates are clamped far enough outside of any image for the
+  // products of the orientation predicates to fit in 64 bits.
+  const double limit = FixedLimit;
+  const double scaled = std::max( -limit, std::min(x * FixedOne, limit) );
+
+  return static_cast< FixedType >( std::floor(scaled + 0.5) );
+}
+
+template< typename TInputMesh, typename TOutputImage >
+int
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::EdgeSign(const RasterPoint & a, const RasterPoint & b, FixedType y, FixedType z, FixedType & e)
+{
+  // The predicate is evaluated with the end points in a canonical order,
+  // so that the two triangles sharing an edge see exactly opposite values.
+  const bool flip = a.m_Y > b.m_Y || ( a.m_Y == b.m_Y && a.m_Z > b.m_Z );
+  const RasterPoint & p = flip ? b : a;
+  const RasterPoint & q = flip ? a : b;
+
+  const FixedType dy = q.m_Y - p.m_Y;
+  const FixedType dz = q.m_Z - p.m_Z;
+
+  e = dy * ( z - p.m_Z ) - dz * ( y - p.m_Y );
+
+  int sign;
+  if ( e != 0 )
+    {
+    sign = e > 0 ? 1 : -1;
+    }
+  else if ( dz != 0 )
+    {
+    // The ray passes through the edge: it is moved by (eps, eps^2) along
+    // the second and third axes, which decides the side of every edge.
+    sign = dz > 0 ? -1 : 1;
+    }
+  else
+    {
+    sign = dy > 0 ? 1 : 0;
+    }
+
+  if ( flip )
+    {
+    e = -e;
+    sign = -sign;
+    }
+  return sign;
+}
+
+template< typename TInputMesh, typename TOutputImage >
+double
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::OrientationDeterminant(const ContinuousIndex< double, 3 > & a, const ContinuousIndex< double, 3 > & b,
+                         double y, double z)
+{
+  return ( b[1] - a[1] ) * ( z - a[2] ) - ( b[2] - a[2] ) * ( y - a[1] );
+}
+
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::BinTriangles(double pad, SliceBins & bins) const
+{
+  const OutputImageRegionType & region = this->GetOutput()->GetRequestedRegion();
+  const IndexValueType zBegin = region.GetIndex(2);
+  const IndexValueType zEnd = zBegin + static_cast< IndexValueType >( region.GetSize(2) );
+
+  // The slices spanned by each triangle, clipped to the requested region.
+  auto sliceRange = [&](const RasterTriangle & triangle, IndexValueType & first, IndexValueType & last)
+  {
+    FixedType zmin = m_Points[triangle.m_Points[0]].m_Z;
+    FixedType zmax = zmin;
+    for ( unsigned int k = 1; k < 3; ++k )
+      {
+      zmin = std::min( zmin, m_Points[triangle.m_Points[k]].m_Z );
+      zmax = std::max( zmax, m_Points[triangle.m_Points[k]].m_Z );
+      }
+    first = std::max( zBegin, static_cast< IndexValueType >( std::ceil(zmin / FixedOne - pad) ) );
+    last = std::min( zEnd - 1, static_cast< IndexValueType >( std::floor(zmax / FixedOne + pad) ) );
+  };
+
+  bins.m_Offsets.assign(region.GetSize(2) + 1, 0);
+  for ( const auto & triangle : m_Triangles )
+    {
+    IndexValueType first, last;
+    sliceRange(triangle, first, last);
+    for ( IndexValueType z = first; z <= last; ++z )
+      {
+      ++bins.m_Offsets[z - zBegin + 1];
+      }
+    }
+  for ( SizeValueType k = 1; k < bins.m_Offsets.size(); ++k )
+    {
+    bins.m_Offsets[k] += bins.m_Offsets[k - 1];
+    }
+
+  bins.m_Triangles.resize( bins.m_Offsets.back() );
+  std::vector< SizeValueType > cursor( bins.m_Offsets.begin(), bins.m_Offsets.end() - 1 );
+  for ( SizeValueType t = 0; t < m_Triangles.size(); ++t )
+    {
+    IndexValueType first, last;
+    sliceRange(m_Triangles[t], first, last);
+    for ( IndexValueType z = first; z <= last; ++z )
+      {
+      bins.m_Triangles[cursor[z - zBegin]++] = t;
+      }
+    }
+  bins.m_First = zBegin;
+}
+
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::RasterizeSlice(IndexValueType z, const OutputImageRegionType & region,
+                 std::vector< std::vector< Crossing > > & rows)
+{
+  const IndexValueType xBegin = region.GetIndex(0);
+  const IndexValueType xEnd = xBegin + static_cast< IndexValueType >( region.GetSize(0) );
+  const IndexValueType yBegin = region.GetIndex(1);
+  const IndexValueType yEnd = yBegin + static_cast< IndexValueType >( region.GetSize(1) );
+
+  for ( auto & row : rows )
+    {
+    row.clear();
+    }
+
+  // Find the crossings of the rays of the slice with each triangle
+  // spanning it.
+  const FixedType fz = static_cast< FixedType >( z ) * static_cast< FixedType >( FixedOne );
+  const SizeValueType binBegin = m_SliceBins.m_Offsets[z - m_SliceBins.m_First];
+  const SizeValueType binEnd = m_SliceBins.m_Offsets[z - m_SliceBins.m_First + 1];
+  for ( SizeValueType bin = binBegin; bin < binEnd; ++bin )
+    {
+    const RasterTriangle & triangle = m_Triangles[m_SliceBins.m_Triangles[bin]];
+    const RasterPoint &    a = m_Points[triangle.m_Points[0]];
+    const RasterPoint &    b = m_Points[triangle.m_Points[1]];
+    const RasterPoint &    c = m_Points[triangle.m_Points[2]];
+
+    const FixedType      ymin = std::min( a.m_Y, std::min(b.m_Y, c.m_Y) );
+    const FixedType      ymax = std::max( a.m_Y, std::max(b.m_Y, c.m_Y) );
+    const IndexValueType first = std::max( yBegin, static_cast< IndexValueType >( std::ceil(ymin / FixedOne) ) );
+    const IndexValueType last = std::min( yEnd - 1, static_cast< IndexValueType >( std::floor(ymax / FixedOne) ) );
+
+    for ( IndexValueType y = first; y <= last; ++y )
+      {
+      const FixedType fy = static_cast< FixedType >( y ) * static_cast< FixedType >( FixedOne );
+      FixedType       ea, eb, ec;
+      const int       sa = EdgeSign(b, c, fy, fz, ea);
+      if ( sa == 0 || EdgeSign(c, a, fy, fz, eb) != sa || EdgeSign(a, b, fy, fz, ec) != sa )
         {
-        continue; //this is a peripheral point in the zy projection plane
+        continue;
         }
-      else
+      if ( ea + eb + ec == 0 )
         {
-        std::sort(xlist.begin(), xlist.end(), ComparePoints1D);
+        continue;
         }
-      //get the first entry
-      double lastx = xlist[0].m_X;
-      int lastSign = xlist[0].m_Sign;
-      int    signproduct = 1;
-
-      // if adjacent x values are within tolerance of each
-      // other, check whether the number of 'exits' and
-      // 'entrances' are equal (via signproduct) and if so,
-      // ignore all x values, but if not, then count
-      // them as a single intersection of the ray with the
-      // surface
-
-      std::vector< double > nlist;
-      size_t               m = xlist.size();
-      for ( size_t j = 1; j < m; j++ )
+      // The crossing is interpolated from the unrounded coordinates; the
+      // fixed-point predicates only decide which triangles the ray crosses.
+      double la = OrientationDeterminant(b.m_Index, c.m_Index, y, z);
+      double lb = OrientationDeterminant(c.m_Index, a.m_Index, y, z);
+      double lc = OrientationDeterminant(a.m_Index, b.m_Index, y, z);
+      double area = la + lb + lc;
+      if ( Math::ExactlyEquals(area, 0.0) )
         {
-        Point1D p1D = xlist[j];
-        double  x = p1D.m_X;
-        int     sign = p1D.m_Sign;
+        la = static_cast< double >( ea );
+        lb = static_cast< double >( eb );
+        lc = static_cast< double >( ec );
+        area = la + lb + lc;
+        }
+      Crossing crossing;
+      crossing.m_Label = triangle.m_Label;
+      crossing.m_X = ( la * a.m_Index[0] + lb * b.m_Index[0] + lc * c.m_Index[0] ) / area;
+      rows[y - yBegin].push_back(crossing);
+      }
+    }
 
-        //check absolute distance from lastx to x
-        if ( std::abs(x - lastx) > m_Tolerance )
-          {
-          signproduct = sign * lastSign;
-          if ( signproduct < 0 )
-            {
-            nlist.push_back(lastx);
-            }
-          }
-        lastx = x;
-        lastSign = sign;
+  // Fill each row between pairs of consecutive crossings of each label,
+  // in increasing label order.
+  OutputImageType *output = this->GetOutput();
+  IndexType        index;
+  index[0] = xBegin;
+  index[2] = z;
+  for ( IndexValueType y = yBegin; y < yEnd; ++y )
+    {
+    index[1] = y;
+    ValueType *buffer = output->GetBufferPointer() + output->ComputeOffset(index) - xBegin;
+    std::fill(buffer + xBegin, buffer + xEnd, m_OutsideValue);
+
+    std::vector< Crossing > & crossings = rows[y - yBegin];
+    std::sort( crossings.begin(), crossings.end() );
+    for ( SizeValueType k = 0; k + 1 < crossings.size(); k += 2 )
+      {
+      if ( crossings[k].m_Label != crossings[k + 1].m_Label )
+        {
+        // An open mesh crosses the row an odd number of times.
+        --k;
+        continue;
+        }
+      const IndexValueType x1 = std::max( xBegin, static_cast< IndexValueType >( std::ceil(crossings[k].m_X) ) );
+      const IndexValueType x2 = std::min( xEnd - 1, static_cast< IndexValueType >( std::floor(crossings[k + 1].m_X) ) );
+      if ( x1 <= x2 )
+        {
+        std::fill( buffer + x1, buffer + x2 + 1,
+                   static_cast< ValueType >( m_InsideValue + crossings[k].m_Label ) );
         }
+      }
+    }
+}
 
-        nlist.push_back(lastx);
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::ComputeSliceDistance(IndexValueType z, const OutputImageRegionType & region)
+{
+  const IndexValueType xBegin = region.GetIndex(0);
+  const IndexValueType xSize = static_cast< IndexValueType >( region.GetSize(0) );
+  const IndexValueType yBegin = region.GetIndex(1);
+  const IndexValueType ySize = static_cast< IndexValueType >( region.GetSize(1) );
+
+  const double maximum = m_MaximumDistance * m_MaximumDistance;
+  std::vector< double > slice(xSize * ySize, maximum);
+
+  const OutputImageType *output = this->GetOutput();
+  IndexType              index;
+  index[2] = z;
+
+  // Each triangle lowers the squared distance of the voxels of the slice
+  // within MaximumDistance of its bounding box.
+  Vector< double, 3 > step;
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    step[i] = m_IndexToPhysical[i][0];
+    }
+  const SizeValueType binBegin = m_DistanceSliceBins.m_Offsets[z - m_DistanceSliceBins.m_First];
+  const SizeValueType binEnd = m_DistanceSliceBins.m_Offsets[z - m_DistanceSliceBins.m_First + 1];
+  for ( SizeValueType bin = binBegin; bin < binEnd; ++bin )
+    {
+    const RasterTriangle & triangle = m_Triangles[m_DistanceSliceBins.m_Triangles[bin]];
+    const RasterPoint &    a = m_Points[triangle.m_Points[0]];
+    const RasterPoint &    b = m_Points[triangle.m_Points[1]];
+    const RasterPoint &    c = m_Points[triangle.m_Points[2]];
+
+    const double xmin = std::min( a.m_Index[0], std::min(b.m_Index[0], c.m_Index[0]) ) - m_DistancePadding[0];
+    const double xmax = std::max( a.m_Index[0], std::max(b.m_Index[0], c.m_Index[0]) ) + m_DistancePadding[0];
+    const double ymin = std::min( a.m_Index[1], std::min(b.m_Index[1], c.m_Index[1]) ) - m_DistancePadding[1];
+    const double ymax = std::max( a.m_Index[1], std::max(b.m_Index[1], c.m_Index[1]) ) + m_DistancePadding[1];
+
+    const IndexValueType x1 = std::max( xBegin, static_cast< IndexValueType >( std::ceil(xmin) ) );
+    const IndexValueType x2 = std::min( xBegin + xSize - 1, static_cast< IndexValueType >( std::floor(xmax) ) );
+    const IndexValueType y1 = std::max( yBegin, static_cast< IndexValueType >( std::ceil(ymin) ) );
+    const IndexValueType y2 = std::min( yBegin + ySize - 1, static_cast< IndexValueType >( std::floor(ymax) ) );
+
+    for ( IndexValueType y = y1; y <= y2; ++y )
+      {
+      index[0] = x1;
+      index[1] = y;
+      PointType point;
+      output->TransformIndexToPhysicalPoint(index, point);
+      double *row = &slice[( y - yBegin ) * xSize - xBegin];
+      for ( IndexValueType x = x1; x <= x2; ++x, point += step )
+        {
+        row[x] = std::min( row[x], SquaredDistanceToTriangle(point, a.m_Physical, b.m_Physical, c.m_Physical) );
+        }
+      }
+    }
 
-      // create the stencil extents
-      int minx1 = extent[0]; // minimum allowable x1 value
-      int n = (int)( nlist.size() ) / 2;
+  // The voxels inside the meshes get negative distances.
+  DistanceImageType *distance = this->GetDistanceOutput();
+  index[0] = xBegin;
+  for ( IndexValueType y = yBegin; y < yBegin + ySize; ++y )
+    {
+    index[1] = y;
+    const ValueType *mask = output->GetBufferPointer() + output->ComputeOffset(index);
+    float *          buffer = distance->GetBufferPointer() + distance->ComputeOffset(index);
+    const double *   row = &slice[( y - yBegin ) * xSize];
+    for ( IndexValueType x = 0; x < xSize; ++x )
+      {
+      const double d = std::sqrt(row[x]);
+      buffer[x] = static_cast< float >( Math::NotExactlyEquals(mask[x], m_OutsideValue) ? -d : d );
+      }
+    }
+}
+
+template< typename TInputMesh, typename TOutputImage >
+double
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::SquaredDistanceToTriangle(const PointType & p, const PointType & a,
+                            const PointType & b, const PointType & c)
+{
+  // Closest point on a triangle, by the Voronoi region of p.
+  const Vector< double, 3 > ab = b - a;
+  const Vector< double, 3 > ac = c - a;
+  const Vector< double, 3 > ap = p - a;
+  const double              d1 = ab * ap;
+  const double              d2 = ac * ap;
+  if ( d1 <= 0.0 && d2 <= 0.0 )
+    {
+    return ap.GetSquaredNorm();
+    }
+
+  const Vector< double, 3 > bp = p - b;
+  const double              d3 = ab * bp;
+  const double              d4 = ac * bp;
+  if ( d3 >= 0.0 && d4 <= d3 )
+    {
+    return bp.GetSquaredNorm();
+    }
+
+  const double vc = d1 * d4 - d3 * d2;
+  if ( vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0 )
+    {
+    return ( ap - ab * ( d1 / ( d1 - d3 ) ) ).GetSquaredNorm();
+    }
+
+  const Vector< double, 3 > cp = p - c;
+  const double              d5 = ab * cp;
+  const double              d6 = ac * cp;
+  if ( d6 >= 0.0 && d5 <= d6 )
+    {
+    return cp.GetSquaredNorm();
+    }
+
+  const double vb = d5 * d2 - d1 * d6;
+  if ( vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0 )
+    {
+    return ( ap - ac * ( d2 / ( d2 - d6 ) ) ).GetSquaredNorm();
+    }
 
-      for ( int i = 0; i < n; i++ )
+  const double va = d3 * d6 - d5 * d4;
+  if ( va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0 )
+    {
+    return ( bp - ( c - b ) * ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) ) ).GetSquaredNorm();
+    }
+
+  const double sum = va + vb + vc;
+  if ( sum <= 0.0 )
+    {
+    // Degenerate triangle.
+    return std::min( ap.GetSquaredNorm(), std::min( bp.GetSquaredNorm(), cp.GetSquaredNorm() ) );
+    }
+  return ( ap - ab * ( vb / sum ) - ac * ( vc / sum ) ).GetSquaredNorm();
+}
+
+//----------------------------------------------------------------------------
+/** Map the mesh points to the output grid and triangulate the cells */
+template< typename TInputMesh, typename TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::RasterizeTriangles()
+{
+  const OutputImageType *output = this->GetOutput();
+
+  m_Points.clear();
+  m_Triangles.clear();
+
+  const unsigned int numberOfMeshes = this->GetNumberOfIndexedInputs();
+  for ( unsigned int label = 0; label < numberOfMeshes; ++label )
+    {
+    const InputMeshType *input = this->GetInput(label);
+    if ( input == nullptr )
+      {
+      continue;
+      }
+
+    // The rasterized points of the mesh, by point identifier.
+    const InputPointsContainer *points = input->GetPoints();
+    const SizeValueType         invalid = NumericTraits< SizeValueType >::max();
+    std::vector< SizeValueType > pointIndices;
+    for ( auto it = points->Begin(); it != points->End(); ++it )
+      {
+      if ( it.Index() >= pointIndices.size() )
         {
-        auto x1 = (int)( std::ceil(nlist[2 * i]) );
-        auto x2 = (int)( std::floor(nlist[2 * i + 1]) );
+        pointIndices.resize(it.Index() + 1, invalid);
+        }
+      pointIndices[it.Index()] = m_Points.size();
+
+      RasterPoint point;
+      point.m_Physical = it.Value();
+      output->TransformPhysicalPointToContinuousIndex(point.m_Physical, point.m_Index);
+      point.m_Y = ToFixed(point.m_Index[1]);
+      point.m_Z = ToFixed(point.m_Index[2]);
+      m_Points.push_back(point);
+      }
 
-        if ( x2 < extent[0] || x1 > ( extent[1] ) )
-          {
-          continue;
-          }
-        x1 = ( x1 > minx1 ) ? ( x1 ) : ( minx1 );         // max(x1,minx1)
-        x2 = ( x2 < extent[1] ) ? ( x2 ) : ( extent[1] ); //min(x2,extent[1])
+    // Cells stored as compact arrays are read directly from the connectivity
+    // array, without creating a cell object per cell.
+    const bool cellsArrays = input->HasCellsArrays();
+    const typename InputMeshType::PointIdentifier *connectivity = nullptr;
+    typename InputMeshType::CellsContainer::ConstIterator cellIt;
+    if ( cellsArrays )
+      {
+      connectivity = input->GetCellConnectivity()->CastToSTLConstContainer().data();
+      }
+    else
+      {
+      cellIt = input->GetCells()->Begin();
+      }
 
-        if ( x2 >= x1 )
+    const typename InputMeshType::CellIdentifier numberOfCells = input->GetNumberOfCells();
+    for ( typename InputMeshType::CellIdentifier cellId = 0; cellId < numberOfCells; ++cellId )
+      {
+      unsigned int                            cellType;
+      typename CellType::PointIdConstIterator pointIt;
+      typename CellType::PointIdConstIterator pointEnd;
+      if ( cellsArrays )
+        {
+        cellType = input->GetCellGeometries()->ElementAt(cellId);
+        pointIt = connectivity + input->GetCellOffsets()->ElementAt(cellId);
+        pointEnd = connectivity + input->GetCellOffsets()->ElementAt(cellId + 1);
+        }
+      else
+        {
+        const CellType *nextCell = cellIt.Value();
+        cellType = nextCell->GetType();
+        pointIt = nextCell->PointIdsBegin();
+        pointEnd = nextCell->PointIdsEnd();
+        ++cellIt;
+        }
+
+      switch ( cellType )
+        {
+        case CellType::VERTEX_CELL:
+        case CellType::LINE_CELL:
+          break;
+        case CellType::TRIANGLE_CELL:
+        case CellType::POLYGON_CELL:
           {
-          for ( int idX = x1; idX <= x2; idX++ )
+          // Polygons are triangulated as fans around their first point.
+          RasterTriangle triangle;
+          triangle.m_Label = label;
+          for ( unsigned int k = 0; pointIt != pointEnd; ++pointIt, ++k )
             {
-            m_StencilIndex.push_back(idX + y * m_Size[0] + z * m_Size[0] * m_Size[1]);
+            if ( *pointIt >= pointIndices.size() || pointIndices[*pointIt] == invalid )
+              {
+              itkExceptionMacro ("Point with id " << *pointIt
+                                                  << " does not exist in the new pointset");
+              }
+            triangle.m_Points[std::min(k, 2u)] = pointIndices[*pointIt];
+            if ( k >= 2 )
+              {
+              m_Triangles.push_back(triangle);
+              triangle.m_Points[1] = triangle.m_Points[2];
+              }
             }
           }
-        // next x1 value must be at least x2+1
-        minx1 = x2 + 1;
+          break;
+        default:
+          itkExceptionMacro(<< "Need Triangle or Polygon cells ONLY");
         }
       }
     }
@@ -572,11 +964,15 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
      << static_cast< typename NumericTraits< ValueType >::PrintType >( m_InsideValue ) << std::endl;
   os << indent << "Outside Value : "
      << static_cast< typename NumericTraits< ValueType >::PrintType >( m_OutsideValue ) << std::endl;
+#if !defined( ITK_LEGACY_REMOVE )
   os << indent << "Tolerance: " << m_Tolerance << std::endl;
+#endif
   os << indent << "Origin: " << m_Origin << std::endl;
   os << indent << "Spacing: " << m_Spacing << std::endl;
   os << indent << "Direction: " << std::endl << m_Direction << std::endl;
   os << indent << "Index: " << m_Index << std::endl;
+  os << indent << "ComputeSignedDistance: " << m_ComputeSignedDistance << std::endl;
+  os << indent << "MaximumDistance: " << m_MaximumDistance << std::endl;
 }
 } // end namespace itk
 
@@ -145,7 +145,9 @@ VTKPolyDataWriter< TInputMesh >
   unsigned int numberOfEdges = 0;
   unsigned int numberOfPolygons = 0;
 
-  const CellsContainer *cells = this->m_Input->GetCells();
+  // Cells stored as compact arrays are read through cell objects
+  const auto meshWithCells = this->m_Input->GetMeshWithCellObjects();
+  const CellsContainer *cells = meshWithCells->GetCells();
 
   if ( cells )
     {
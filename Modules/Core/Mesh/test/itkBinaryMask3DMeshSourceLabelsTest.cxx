@@ -0,0 +1,218 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryMask3DMeshSource.h"
+#include "itkFlipImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <map>
+
+// Check that every triangle edge is used once in each direction, that is
+// that the surfaces are closed and consistently oriented, and accumulate the
+// volume enclosed by the triangles of every label.
+template< typename TMesh >
+bool CheckClosedSurfaces( const TMesh *mesh, std::vector< double > & volumes )
+{
+  using PointIdentifier = typename TMesh::PointIdentifier;
+  using EdgeType = std::pair< PointIdentifier, PointIdentifier >;
+
+  std::map< EdgeType, unsigned int > edges;
+  for ( typename TMesh::CellIdentifier cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId )
+    {
+    typename TMesh::CellAutoPointer cell;
+    mesh->GetCell( cellId, cell );
+    if ( cell->GetNumberOfPoints() != 3 )
+      {
+      std::cerr << "Cell " << cellId << " is not a triangle" << std::endl;
+      return false;
+      }
+    const PointIdentifier *ids = cell->GetPointIds();
+    for ( unsigned int k = 0; k < 3; ++k )
+      {
+      ++edges[EdgeType( ids[k], ids[( k + 1 ) % 3] )];
+      }
+
+    typename TMesh::CellPixelType label{};
+    if ( !mesh->GetCellData( cellId, &label ) )
+      {
+      std::cerr << "Cell " << cellId << " has no label" << std::endl;
+      return false;
+      }
+    const auto labelIndex = static_cast< size_t >( label );
+    if ( labelIndex >= volumes.size() )
+      {
+      std::cerr << "Cell " << cellId << " has an invalid label " << label << std::endl;
+      return false;
+      }
+    const typename TMesh::PointType p0 = mesh->GetPoint( ids[0] );
+    const typename TMesh::PointType p1 = mesh->GetPoint( ids[1] );
+    const typename TMesh::PointType p2 = mesh->GetPoint( ids[2] );
+    volumes[labelIndex] += ( p0[0] * ( p1[1] * p2[2] - p1[2] * p2[1] )
+                             - p0[1] * ( p1[0] * p2[2] - p1[2] * p2[0] )
+                             + p0[2] * ( p1[0] * p2[1] - p1[1] * p2[0] ) ) / 6.0;
+    }
+
+  for ( const auto & edge : edges )
+    {
+    const auto opposite = edges.find( EdgeType( edge.first.second, edge.first.first ) );
+    if ( edge.second != 1 || opposite == edges.end() || opposite->second != 1 )
+      {
+      std::cerr << "Edge " << edge.first.first << " - " << edge.first.second
+                << " is not shared by exactly two consistently oriented triangles" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int itkBinaryMask3DMeshSourceLabelsTest( int, char *[] )
+{
+  constexpr unsigned int Dimension = 3;
+
+  using ImageType = itk::Image< unsigned char, Dimension >;
+  using MeshType = itk::Mesh< double >;
+  using FlipType = itk::FlipImageFilter< ImageType >;
+  using MonitorType = itk::PipelineMonitorImageFilter< ImageType >;
+  using MeshSourceType = itk::BinaryMask3DMeshSource< ImageType, MeshType >;
+
+  // Two touching balls labeled 1 and 2, and a ball labeled 3 which is not
+  // extracted.
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 32;
+  size[2] = 36;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.0;
+  spacing[2] = 1.5;
+  image->SetSpacing( spacing );
+  image->Allocate();
+  image->FillBuffer( 0 );
+
+  const double centers[3][3] = { { 12.0, 16.0, 18.0 }, { 24.0, 16.0, 18.0 }, { 33.0, 6.0, 6.0 } };
+  const double radii[3] = { 7.0, 6.0, 4.0 };
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    for ( unsigned int label = 0; label < 3; ++label )
+      {
+      double distance = 0.0;
+      for ( unsigned int i = 0; i < Dimension; ++i )
+        {
+        const double d = it.GetIndex()[i] - centers[label][i];
+        distance += d * d;
+        }
+      if ( distance < radii[label] * radii[label] )
+        {
+        it.Set( static_cast< ImageType::PixelType >( label + 1 ) );
+        break;
+        }
+      }
+    }
+
+  MeshSourceType::Pointer meshSource = MeshSourceType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( meshSource, BinaryMask3DMeshSource, ImageToMeshFilter );
+
+  const MeshSourceType::ObjectValuesType objectValues = { 1, 2 };
+  meshSource->SetObjectValues( objectValues );
+  TEST_EXPECT_TRUE( meshSource->GetObjectValues() == objectValues );
+
+  meshSource->SetInput( image );
+  meshSource->SetNumberOfThreads( 4 );
+  meshSource->UseCellsArraysOn();
+  TRY_EXPECT_NO_EXCEPTION( meshSource->Update() );
+
+  const MeshType *mesh = meshSource->GetOutput();
+  TEST_EXPECT_TRUE( mesh->HasCellsArrays() );
+  TEST_EXPECT_EQUAL( mesh->GetNumberOfPoints(), meshSource->GetNumberOfNodes() );
+  TEST_EXPECT_EQUAL( mesh->GetNumberOfCells(), meshSource->GetNumberOfCells() );
+
+  // Every label has its own closed surface, whose volume is close to the one
+  // of its ball.
+  std::vector< double > volumes( objectValues.size(), 0.0 );
+  TEST_EXPECT_TRUE( CheckClosedSurfaces( mesh, volumes ) );
+  const double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+  for ( unsigned int label = 0; label < objectValues.size(); ++label )
+    {
+    const double expected = 4.0 / 3.0 * itk::Math::pi * std::pow( radii[label], 3 ) * voxelVolume;
+    std::cout << "Label " << label + 1 << " volume: " << volumes[label]
+              << " expected: " << expected << std::endl;
+    TEST_EXPECT_TRUE( std::abs( volumes[label] - expected ) < 0.1 * expected );
+    }
+
+  // Streaming the input through a pipeline gives the same mesh.  The flip
+  // filter, which flips no axis, generates only the requested regions.
+  FlipType::Pointer flip = FlipType::New();
+  flip->SetInput( image );
+
+  MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( flip->GetOutput() );
+
+  MeshSourceType::Pointer streamingMeshSource = MeshSourceType::New();
+  streamingMeshSource->SetInput( monitor->GetOutput() );
+  streamingMeshSource->SetObjectValues( objectValues );
+  streamingMeshSource->SetNumberOfThreads( 1 );
+  streamingMeshSource->UseCellsArraysOn();
+  streamingMeshSource->SetNumberOfStreamDivisions( 5 );
+  TEST_SET_GET_VALUE( 5u, streamingMeshSource->GetNumberOfStreamDivisions() );
+  TRY_EXPECT_NO_EXCEPTION( streamingMeshSource->Update() );
+
+  // The first division is requested by the pipeline update, the others by
+  // the mesh source.
+  TEST_EXPECT_EQUAL( monitor->GetNumberOfUpdates(), 5u );
+  const MonitorType::RegionVectorType regions = monitor->GetUpdatedRequestedRegions();
+  for ( const auto & region : regions )
+    {
+    TEST_EXPECT_TRUE( region.GetSize(2) < size[2] / 2 );
+    }
+
+  const MeshType *streamedMesh = streamingMeshSource->GetOutput();
+  TEST_EXPECT_EQUAL( streamedMesh->GetNumberOfPoints(), mesh->GetNumberOfPoints() );
+  TEST_EXPECT_EQUAL( streamedMesh->GetNumberOfCells(), mesh->GetNumberOfCells() );
+  for ( MeshType::PointIdentifier pointId = 0; pointId < mesh->GetNumberOfPoints(); ++pointId )
+    {
+    if ( streamedMesh->GetPoint( pointId ) != mesh->GetPoint( pointId ) )
+      {
+      std::cerr << "Point " << pointId << " differs when streaming" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  TEST_EXPECT_TRUE( mesh->GetCellConnectivity()->CastToSTLConstContainer()
+                    == streamedMesh->GetCellConnectivity()->CastToSTLConstContainer() );
+
+  // A single object value gives the surface of that label only, with cell
+  // data 0.
+  MeshSourceType::Pointer singleMeshSource = MeshSourceType::New();
+  singleMeshSource->SetInput( image );
+  singleMeshSource->SetObjectValue( 2 );
+  TEST_SET_GET_VALUE( 2, singleMeshSource->GetObjectValue() );
+  TRY_EXPECT_NO_EXCEPTION( singleMeshSource->Update() );
+
+  std::vector< double > singleVolumes( 1, 0.0 );
+  TEST_EXPECT_TRUE( CheckClosedSurfaces( singleMeshSource->GetOutput(), singleVolumes ) );
+  TEST_EXPECT_TRUE( itk::Math::FloatAlmostEqual( singleVolumes[0], volumes[1], 4, 1e-9 ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
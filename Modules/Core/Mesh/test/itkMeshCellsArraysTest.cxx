@@ -0,0 +1,320 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMesh.h"
+#include "itkTransformMeshFilter.h"
+#include "itkTranslationTransform.h"
+#include "itkTriangleMeshToBinaryImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using MeshType = itk::Mesh< float, 3 >;
+using CellType = MeshType::CellType;
+using TriangleCellType = itk::TriangleCell< CellType >;
+
+/** The triangles visited, and the sum of their point identifiers. */
+struct TriangleCounts
+{
+  unsigned int  m_NumberOfTriangles{ 0 };
+  unsigned long m_SumOfPointIds{ 0 };
+};
+
+class VisitTriangles
+{
+public:
+  void SetCountClass(TriangleCounts *counts)
+  {
+    m_Counts = counts;
+  }
+
+  void Visit(unsigned long, TriangleCellType *t)
+  {
+    ++m_Counts->m_NumberOfTriangles;
+    for ( TriangleCellType::PointIdConstIterator it = t->PointIdsBegin(); it != t->PointIdsEnd(); ++it )
+      {
+      m_Counts->m_SumOfPointIds += *it;
+      }
+  }
+
+private:
+  TriangleCounts *m_Counts{ nullptr };
+};
+
+using TriangleVisitorType = itk::CellInterfaceVisitorImplementation<
+  float, MeshType::CellTraits, TriangleCellType, VisitTriangles >;
+
+/** Build the surface of an octahedron, plus a few cells of other geometries,
+ * either as cell objects or as compact cell arrays. */
+MeshType::Pointer
+CreateOctahedron(bool cellsArrays)
+{
+  MeshType::Pointer mesh = MeshType::New();
+
+  const float coordinates[6][3] = { { 10, 0, 0 }, { -10, 0, 0 }, { 0, 10, 0 },
+                                    { 0, -10, 0 }, { 0, 0, 10 }, { 0, 0, -10 } };
+  for ( unsigned int i = 0; i < 6; ++i )
+    {
+    MeshType::PointType p;
+    p[0] = coordinates[i][0];
+    p[1] = coordinates[i][1];
+    p[2] = coordinates[i][2];
+    mesh->SetPoint(i, p);
+    }
+
+  const unsigned char triangle = CellType::TRIANGLE_CELL;
+  const std::vector< unsigned char > geometries = { triangle, triangle, triangle, triangle,
+                                                    triangle, triangle, triangle, triangle,
+                                                    CellType::VERTEX_CELL, CellType::LINE_CELL,
+                                                    CellType::POLYGON_CELL };
+  const std::vector< MeshType::PointIdentifier > connectivity = { 0, 2, 4,  2, 1, 4,  1, 3, 4,  3, 0, 4,
+                                                                  2, 0, 5,  1, 2, 5,  3, 1, 5,  0, 3, 5,
+                                                                  5,  0, 1,  0, 2, 1, 3 };
+  const std::vector< itk::SizeValueType > offsets = { 0, 3, 6, 9, 12, 15, 18, 21, 24, 25, 27, 31 };
+
+  if ( cellsArrays )
+    {
+    MeshType::CellGeometriesContainer::Pointer geometriesContainer = MeshType::CellGeometriesContainer::New();
+    geometriesContainer->CastToSTLContainer() = geometries;
+    MeshType::CellOffsetsContainer::Pointer offsetsContainer = MeshType::CellOffsetsContainer::New();
+    offsetsContainer->CastToSTLContainer() = offsets;
+    MeshType::CellConnectivityContainer::Pointer connectivityContainer = MeshType::CellConnectivityContainer::New();
+    connectivityContainer->CastToSTLContainer() = connectivity;
+    mesh->SetCellsArrays(geometriesContainer, offsetsContainer, connectivityContainer);
+    }
+  else
+    {
+    for ( MeshType::CellIdentifier cellId = 0; cellId < geometries.size(); ++cellId )
+      {
+      MeshType::CellAutoPointer cell;
+      switch ( geometries[cellId] )
+        {
+        case CellType::VERTEX_CELL:
+          cell.TakeOwnership( new itk::VertexCell< CellType > );
+          break;
+        case CellType::LINE_CELL:
+          cell.TakeOwnership( new itk::LineCell< CellType > );
+          break;
+        case CellType::TRIANGLE_CELL:
+          cell.TakeOwnership( new TriangleCellType );
+          break;
+        default:
+          cell.TakeOwnership( new itk::PolygonCell< CellType > );
+          break;
+        }
+      cell->SetPointIds( &connectivity[offsets[cellId]], &connectivity[0] + offsets[cellId + 1] );
+      mesh->SetCell(cellId, cell);
+      }
+    }
+  return mesh;
+}
+
+bool
+SameCells(const MeshType *a, const MeshType *b)
+{
+  if ( a->GetNumberOfCells() != b->GetNumberOfCells() )
+    {
+    std::cerr << "Number of cells differ: " << a->GetNumberOfCells()
+              << " != " << b->GetNumberOfCells() << std::endl;
+    return false;
+    }
+  for ( MeshType::CellIdentifier cellId = 0; cellId < a->GetNumberOfCells(); ++cellId )
+    {
+    MeshType::CellAutoPointer cellA;
+    MeshType::CellAutoPointer cellB;
+    if ( !a->GetCell(cellId, cellA) || !b->GetCell(cellId, cellB)
+         || cellA->GetType() != cellB->GetType()
+         || cellA->GetNumberOfPoints() != cellB->GetNumberOfPoints()
+         || !std::equal( cellA->PointIdsBegin(), cellA->PointIdsEnd(), cellB->PointIdsBegin() ) )
+      {
+      std::cerr << "Cell " << cellId << " differs" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool
+SameCellLinks(const MeshType *a, const MeshType *b)
+{
+  a->BuildCellLinks();
+  b->BuildCellLinks();
+  for ( MeshType::PointIdentifier pointId = 0; pointId < a->GetNumberOfPoints(); ++pointId )
+    {
+    if ( a->GetCellLinks()->ElementAt(pointId) != b->GetCellLinks()->ElementAt(pointId) )
+      {
+      std::cerr << "Cell links of point " << pointId << " differ" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkMeshCellsArraysTest(int, char* [] )
+{
+  MeshType::Pointer cellsMesh = CreateOctahedron(false);
+  MeshType::Pointer arraysMesh = CreateOctahedron(true);
+
+  TEST_EXPECT_TRUE( !cellsMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( arraysMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( SameCells(cellsMesh, arraysMesh) );
+  TEST_EXPECT_TRUE( SameCellLinks(cellsMesh, arraysMesh) );
+  TEST_EXPECT_TRUE( arraysMesh->HasCellsArrays() );
+
+  // Boundary features are constructed from the arrays as well.
+  TEST_EXPECT_EQUAL( arraysMesh->GetNumberOfCellBoundaryFeatures(1, 0), 3 );
+  MeshType::CellAutoPointer edge;
+  TEST_EXPECT_TRUE( arraysMesh->GetCellBoundaryFeature(1, 0, 1, edge) );
+  TEST_EXPECT_EQUAL( edge->GetPointIds()[0], 2 );
+  TEST_EXPECT_EQUAL( edge->GetPointIds()[1], 4 );
+
+  // Visiting the compact cells sees the same triangles.
+  TriangleCounts cellsCounts;
+  TriangleCounts arraysCounts;
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    CellType::MultiVisitor::Pointer multiVisitor = CellType::MultiVisitor::New();
+    TriangleVisitorType::Pointer triangleVisitor = TriangleVisitorType::New();
+    triangleVisitor->SetCountClass( i == 0 ? &cellsCounts : &arraysCounts );
+    multiVisitor->AddVisitor(triangleVisitor);
+    ( i == 0 ? cellsMesh : arraysMesh )->Accept(multiVisitor);
+    }
+  TEST_EXPECT_EQUAL( arraysCounts.m_NumberOfTriangles, 8 );
+  TEST_EXPECT_EQUAL( arraysCounts.m_NumberOfTriangles, cellsCounts.m_NumberOfTriangles );
+  TEST_EXPECT_EQUAL( arraysCounts.m_SumOfPointIds, cellsCounts.m_SumOfPointIds );
+
+  // Filters keep the compact representation when asked to.
+  using TransformType = itk::TranslationTransform< double, 3 >;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::OutputVectorType translation;
+  translation.Fill(1.0);
+  transform->Translate(translation);
+
+  using TransformFilterType = itk::TransformMeshFilter< MeshType, MeshType, TransformType >;
+  TransformFilterType::Pointer transformFilter = TransformFilterType::New();
+  transformFilter->SetInput(arraysMesh);
+  transformFilter->SetTransform(transform);
+  TRY_EXPECT_NO_EXCEPTION( transformFilter->Update() );
+  TEST_EXPECT_TRUE( !transformFilter->GetOutput()->HasCellsArrays() );
+  TEST_EXPECT_TRUE( SameCells(transformFilter->GetOutput(), cellsMesh) );
+  transformFilter->UseCellsArraysOn();
+  TRY_EXPECT_NO_EXCEPTION( transformFilter->Update() );
+  TEST_EXPECT_TRUE( transformFilter->GetOutput()->HasCellsArrays() );
+  TEST_EXPECT_TRUE( SameCells(transformFilter->GetOutput(), cellsMesh) );
+
+  // Rasterizing the compact mesh gives the same image as the cell objects.
+  using ImageType = itk::Image< unsigned char, 3 >;
+  using RasterizerType = itk::TriangleMeshToBinaryImageFilter< MeshType, ImageType >;
+  ImageType::Pointer images[2];
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    // The vertex, line and polygon cells are not supported by the rasterizer.
+    MeshType::Pointer surface = MeshType::New();
+    surface->SetPoints( cellsMesh->GetPoints() );
+    if ( i == 0 )
+      {
+      MeshType::CellsContainer::Pointer triangles = MeshType::CellsContainer::New();
+      for ( MeshType::CellIdentifier cellId = 0; cellId < 8; ++cellId )
+        {
+        MeshType::CellAutoPointer cell;
+        cellsMesh->GetCell(cellId, cell);
+        CellType::CellAutoPointer copy;
+        cell->MakeCopy(copy);
+        triangles->InsertElement( cellId, copy.ReleaseOwnership() );
+        }
+      surface->SetCells(triangles);
+      }
+    else
+      {
+      MeshType::CellGeometriesContainer::Pointer geometries = MeshType::CellGeometriesContainer::New();
+      geometries->CastToSTLContainer().assign( 8, CellType::TRIANGLE_CELL );
+      MeshType::CellOffsetsContainer::Pointer offsets = MeshType::CellOffsetsContainer::New();
+      offsets->CastToSTLContainer().assign( arraysMesh->GetCellOffsets()->CastToSTLConstContainer().begin(),
+                                            arraysMesh->GetCellOffsets()->CastToSTLConstContainer().begin() + 9 );
+      MeshType::CellConnectivityContainer::Pointer connectivity = MeshType::CellConnectivityContainer::New();
+      connectivity->CastToSTLContainer().assign(
+        arraysMesh->GetCellConnectivity()->CastToSTLConstContainer().begin(),
+        arraysMesh->GetCellConnectivity()->CastToSTLConstContainer().begin() + 24 );
+      surface->SetCellsArrays(geometries, offsets, connectivity);
+      }
+
+    RasterizerType::Pointer rasterizer = RasterizerType::New();
+    rasterizer->SetInput(surface);
+    ImageType::SizeType size;
+    size.Fill(24);
+    rasterizer->SetSize(size);
+    ImageType::PointType origin;
+    origin.Fill(-12.0);
+    rasterizer->SetOrigin(origin);
+    TRY_EXPECT_NO_EXCEPTION( rasterizer->Update() );
+    images[i] = rasterizer->GetOutput();
+    }
+
+  unsigned int numberOfInsidePixels = 0;
+  itk::ImageRegionConstIterator< ImageType > it0( images[0], images[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > it1( images[1], images[1]->GetLargestPossibleRegion() );
+  for ( ; !it0.IsAtEnd(); ++it0, ++it1 )
+    {
+    if ( it0.Get() != it1.Get() )
+      {
+      std::cerr << "Rasterized images differ at " << it0.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    numberOfInsidePixels += ( it0.Get() != 0 );
+    }
+  TEST_EXPECT_TRUE( numberOfInsidePixels > 0 );
+
+  const MeshType *constArraysMesh = arraysMesh;
+
+  // Cells returned by GetCell() are copies: changing them leaves the mesh
+  // unchanged.
+  MeshType::CellAutoPointer copiedCell;
+  TEST_EXPECT_TRUE( arraysMesh->GetCell(0, copiedCell) );
+  const MeshType::PointIdentifier firstPointId = copiedCell->GetPointIds()[0];
+  copiedCell->SetPointId(0, firstPointId + 1);
+  TEST_EXPECT_TRUE( arraysMesh->GetCell(0, copiedCell) );
+  TEST_EXPECT_EQUAL( copiedCell->GetPointIds()[0], firstPointId );
+
+  // Const readers needing the cells container get them from a copy.
+  MeshType::ConstPointer meshWithCells = constArraysMesh->GetMeshWithCellObjects();
+  TEST_EXPECT_TRUE( meshWithCells.GetPointer() != constArraysMesh );
+  TEST_EXPECT_TRUE( meshWithCells->GetCells() != nullptr );
+  TEST_EXPECT_TRUE( SameCells(cellsMesh, meshWithCells) );
+  TEST_EXPECT_TRUE( arraysMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( cellsMesh->GetMeshWithCellObjects().GetPointer() == cellsMesh.GetPointer() );
+
+  // Requesting the cells container, even from a const mesh, converts the
+  // arrays into cells.
+  TEST_EXPECT_TRUE( constArraysMesh->GetCells() != nullptr );
+  TEST_EXPECT_TRUE( !arraysMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( SameCells(cellsMesh, arraysMesh) );
+
+  // Inconsistent arrays are rejected.
+  MeshType::CellGeometriesContainer::Pointer badGeometries = MeshType::CellGeometriesContainer::New();
+  badGeometries->CastToSTLContainer().assign( 1, CellType::TRIANGLE_CELL );
+  MeshType::CellOffsetsContainer::Pointer badOffsets = MeshType::CellOffsetsContainer::New();
+  badOffsets->CastToSTLContainer() = { 0, 2 };
+  MeshType::CellConnectivityContainer::Pointer badConnectivity = MeshType::CellConnectivityContainer::New();
+  badConnectivity->CastToSTLContainer() = { 0, 1 };
+  TRY_EXPECT_EXCEPTION( arraysMesh->SetCellsArrays(badGeometries, badOffsets, badConnectivity) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
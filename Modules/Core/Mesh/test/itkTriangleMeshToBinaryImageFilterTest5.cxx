@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRegularSphereMeshSource.h"
+#include "itkTriangleMeshToBinaryImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using MeshType = itk::Mesh< float, 3 >;
+using ImageType = itk::Image< unsigned char, 3 >;
+using FilterType = itk::TriangleMeshToBinaryImageFilter< MeshType, ImageType >;
+using SphereType = itk::RegularSphereMeshSource< MeshType >;
+
+MeshType::Pointer
+MakeSphere(double x, double radius)
+{
+  SphereType::Pointer sphere = SphereType::New();
+  MeshType::PointType center;
+  center[0] = x;
+  center[1] = 20.3;
+  center[2] = 19.8;
+  SphereType::VectorType scale;
+  scale.Fill(radius);
+  sphere->SetCenter(center);
+  sphere->SetScale(scale);
+  sphere->SetResolution(4);
+  sphere->Update();
+  return sphere->GetOutput();
+}
+
+bool
+SameImages(const ImageType *a, const ImageType *b)
+{
+  if ( a->GetBufferedRegion() != b->GetBufferedRegion() )
+    {
+    return false;
+    }
+  return std::equal( a->GetBufferPointer(),
+                     a->GetBufferPointer() + a->GetBufferedRegion().GetNumberOfPixels(),
+                     b->GetBufferPointer() );
+}
+}
+
+int itkTriangleMeshToBinaryImageFilterTest5(int , char * [] )
+{
+  // A cube with corners on the grid: the rays through its faces, edges and
+  // corners are all decided consistently.
+  MeshType::Pointer cube = MeshType::New();
+  MeshType::PointIdentifier pointId = 0;
+  for ( unsigned int k = 0; k < 8; ++k )
+    {
+    MeshType::PointType point;
+    for ( unsigned int i = 0; i < 3; ++i )
+      {
+      point[i] = ( k >> i & 1 ) ? 10.0 : 2.0;
+      }
+    cube->SetPoint(pointId++, point);
+    }
+  const MeshType::PointIdentifier faces[6][4] =
+    { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+  MeshType::CellIdentifier cellId = 0;
+  for ( const auto & face : faces )
+    {
+    for ( unsigned int t = 0; t < 2; ++t )
+      {
+      MeshType::CellAutoPointer cell;
+      cell.TakeOwnership( new itk::TriangleCell< MeshType::CellType > );
+      cell->SetPointId(0, face[0]);
+      cell->SetPointId(1, face[1 + t]);
+      cell->SetPointId(2, face[2 + t]);
+      cube->SetCell(cellId++, cell);
+      }
+    }
+
+  FilterType::Pointer cubeFilter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS(cubeFilter, TriangleMeshToBinaryImageFilter, ImageSource);
+
+  ImageType::SizeType cubeSize;
+  cubeSize.Fill(16);
+  cubeFilter->SetInput(cube);
+  cubeFilter->SetSize(cubeSize);
+  TRY_EXPECT_NO_EXCEPTION( cubeFilter->Update() );
+
+  unsigned long cubeCount = 0;
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( cubeFilter->GetOutput(),
+                                                               cubeFilter->GetOutput()->GetBufferedRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    cubeCount += it.Get() == 1;
+    }
+  // The voxels on the faces at the first corner along the second and third
+  // axes are inside, the others outside.
+  TEST_EXPECT_EQUAL( cubeCount, 9 * 8 * 8 );
+
+  // Two spheres rasterized into a label image, with the signed distance.
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( MakeSphere(20.1, 12.0) );
+  filter->SetInput( 1, MakeSphere(45.2, 8.0) );
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 40;
+  size[2] = 40;
+  filter->SetSize(size);
+  filter->SetInsideValue(3);
+  filter->SetOutsideValue(0);
+  filter->SetNumberOfThreads(4);
+  TEST_EXPECT_EQUAL( filter->GetMaximumDistance(), 5.0 );
+  filter->SetMaximumDistance(3.0);
+  TEST_SET_GET_VALUE( 3.0, filter->GetMaximumDistance() );
+  filter->ComputeSignedDistanceOn();
+  TEST_SET_GET_BOOLEAN( filter, ComputeSignedDistance, true );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  const ImageType *                  labels = filter->GetOutput();
+  const FilterType::DistanceImageType *distance = filter->GetDistanceOutput();
+
+  unsigned long counts[2] = { 0, 0 };
+  const double  centers[2] = { 20.1, 45.2 };
+  const double  radii[2] = { 12.0, 8.0 };
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( labels, labels->GetBufferedRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const ImageType::PixelType label = it.Get();
+    const float                d = distance->GetPixel(index);
+
+    // The distance is negative inside the meshes only.
+    if ( ( label != 0 ) != ( d < 0.0f ) )
+      {
+      std::cerr << "Inconsistent sign of the distance at " << index << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Near the surfaces, the distance is close to the signed distance to
+    // the spheres, and elsewhere clamped.
+    double expected = 3.0;
+    for ( unsigned int s = 0; s < 2; ++s )
+      {
+      const double dx = index[0] - centers[s];
+      const double dy = index[1] - 20.3;
+      const double dz = index[2] - 19.8;
+      const double sphereDistance = std::sqrt(dx * dx + dy * dy + dz * dz) - radii[s];
+      expected = std::min(expected, sphereDistance);
+      }
+    expected = std::max(expected, -3.0);
+    if ( std::abs(d - expected) > 0.25 )
+      {
+      std::cerr << "Distance " << d << " at " << index << " instead of about " << expected << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    if ( label == 3 || label == 4 )
+      {
+      ++counts[label - 3];
+      }
+    else if ( label != 0 )
+      {
+      std::cerr << "Unexpected label " << static_cast< int >( label ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The polyhedra are slightly smaller than the spheres.
+  for ( unsigned int s = 0; s < 2; ++s )
+    {
+    const double volume = 4.0 / 3.0 * itk::Math::pi * radii[s] * radii[s] * radii[s];
+    std::cout << "Label " << s + 3 << ": " << counts[s] << " voxels, sphere volume " << volume << std::endl;
+    TEST_EXPECT_TRUE( counts[s] > 0.93 * volume && counts[s] < 1.01 * volume );
+    }
+
+  // The image does not depend on the number of threads nor on streaming.
+  FilterType::Pointer single = FilterType::New();
+  single->SetInput( filter->GetInput(0) );
+  single->SetInput( 1, filter->GetInput(1) );
+  single->SetSize(size);
+  single->SetInsideValue(3);
+  single->SetNumberOfThreads(1);
+  TRY_EXPECT_NO_EXCEPTION( single->Update() );
+  TEST_EXPECT_TRUE( SameImages( single->GetOutput(), labels ) );
+
+  using StreamerType = itk::StreamingImageFilter< ImageType, ImageType >;
+  StreamerType::Pointer streamer = StreamerType::New();
+  filter->ComputeSignedDistanceOff();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(7);
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( SameImages( streamer->GetOutput(), single->GetOutput() ) );
+  TEST_EXPECT_EQUAL( filter->GetDistanceOutput()->GetBufferedRegion().GetNumberOfPixels(), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -52,156 +52,160 @@
  * @param st Superclass type.
  * @param pt Primal edge type.
  * @param dt Dual edge type.
+ *
+ * The rings of a primal edge only ever link primal edges of the same
+ * type, and the Rot ring alternates primal and dual edges, so the
+ * downcasts are static: they are on every step of a mesh traversal.
  * \todo Should this macro be added to doxygen macros?
  */
 #define itkQEAccessorsMacro(st, pt, dt)                               \
   pt * GetOnext()                                                     \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetOnext() ) );         \
+    return ( static_cast<  pt * >( this->st::GetOnext() ) );         \
     }                                                                 \
                                                                       \
   dt *GetRot()                                                        \
     {                                                                 \
-    return ( dynamic_cast<  dt * >( this->st::GetRot() ) );           \
+    return ( static_cast<  dt * >( this->st::GetRot() ) );           \
     }                                                                 \
                                                                       \
   pt *GetSym()                                                        \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetSym() ) );           \
+    return ( static_cast<  pt * >( this->st::GetSym() ) );           \
     }                                                                 \
                                                                       \
   pt *GetLnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetLnext() ) );         \
+    return ( static_cast<  pt * >( this->st::GetLnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetRnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetRnext() ) );         \
+    return ( static_cast<  pt * >( this->st::GetRnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetDnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetDnext() ) );         \
+    return ( static_cast<  pt * >( this->st::GetDnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetOprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetOprev() ) );         \
+    return ( static_cast<  pt * >( this->st::GetOprev() ) );         \
     }                                                                 \
                                                                       \
   pt *GetLprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetLprev() ) );         \
+    return ( static_cast<  pt * >( this->st::GetLprev() ) );         \
     }                                                                 \
                                                                       \
   pt *GetRprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetRprev() ) );         \
+    return ( static_cast<  pt * >( this->st::GetRprev() ) );         \
     }                                                                 \
                                                                       \
   pt *GetDprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetDprev() ) );         \
+    return ( static_cast<  pt * >( this->st::GetDprev() ) );         \
     }                                                                 \
                                                                       \
   dt *GetInvRot()                                                     \
     {                                                                 \
-    return ( dynamic_cast< dt * >( this->st::GetInvRot() ) );         \
+    return ( static_cast< dt * >( this->st::GetInvRot() ) );         \
     }                                                                 \
                                                                       \
   pt *GetInvOnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvOnext() ) );      \
+    return ( static_cast<  pt * >( this->st::GetInvOnext() ) );      \
     }                                                                 \
                                                                       \
   pt *GetInvLnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvLnext() ) );      \
+    return ( static_cast<  pt * >( this->st::GetInvLnext() ) );      \
     }                                                                 \
                                                                       \
   pt *GetInvRnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvRnext() ) );      \
+    return ( static_cast<  pt * >( this->st::GetInvRnext() ) );      \
     }                                                                 \
                                                                       \
   pt *GetInvDnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvDnext() ) );      \
+    return ( static_cast<  pt * >( this->st::GetInvDnext() ) );      \
     }                                                                 \
   const pt *GetOnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetOnext() ) );    \
+    return ( static_cast< const pt * >( this->st::GetOnext() ) );    \
     }                                                                 \
                                                                       \
   const dt *GetRot() const                                            \
     {                                                                 \
-    return ( dynamic_cast< const dt * >( this->st::GetRot() ) );      \
+    return ( static_cast< const dt * >( this->st::GetRot() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetSym() const                                            \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetSym() ) );      \
+    return ( static_cast< const pt * >( this->st::GetSym() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetLnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetLnext() ) );    \
+    return ( static_cast< const pt * >( this->st::GetLnext() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetRnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetRnext() ) );    \
+    return ( static_cast< const pt * >( this->st::GetRnext() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetDnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetDnext() ) );    \
+    return ( static_cast< const pt * >( this->st::GetDnext() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetOprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetOprev() ) );    \
+    return ( static_cast< const pt * >( this->st::GetOprev() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetLprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetLprev() ) );    \
+    return ( static_cast< const pt * >( this->st::GetLprev() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetRprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetRprev() ) );    \
+    return ( static_cast< const pt * >( this->st::GetRprev() ) );    \
     }                                                                 \
                                                                       \
   const pt *GetDprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetDprev() ) );    \
+    return ( static_cast< const pt * >( this->st::GetDprev() ) );    \
     }                                                                 \
                                                                       \
   const dt *GetInvRot() const                                         \
     {                                                                 \
-    return ( dynamic_cast< const dt * >( this->st::GetInvRot() ) );   \
+    return ( static_cast< const dt * >( this->st::GetInvRot() ) );   \
     }                                                                 \
                                                                       \
   const pt *GetInvOnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvOnext() ) ); \
+    return ( static_cast< const pt * >( this->st::GetInvOnext() ) ); \
     }                                                                 \
                                                                       \
   const pt *GetInvLnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvLnext() ) ); \
+    return ( static_cast< const pt * >( this->st::GetInvLnext() ) ); \
     }                                                                 \
                                                                       \
   const pt *GetInvRnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvRnext() ) ); \
+    return ( static_cast< const pt * >( this->st::GetInvRnext() ) ); \
     }                                                                 \
                                                                       \
   const pt *GetInvDnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvDnext() ) ); \
+    return ( static_cast< const pt * >( this->st::GetInvDnext() ) ); \
     }
 
 namespace itk
@@ -207,6 +207,16 @@ private:
   CellIdentifier          m_Identifier;
   QEType *                m_QuadEdgeGeom;
   mutable PointIdentifier m_PointIds[2];
+
+  /**
+   * The four quad-edges of the edge, in Rot order, live in the cell
+   * itself: an edge is a single allocation and Sym/Rot steps stay
+   * within it.
+   */
+  QEType m_PrimalEdge;
+  QEDual m_RotEdge;
+  QEType m_SymEdge;
+  QEDual m_InvRotEdge;
 };
 } // end namespace itk
 
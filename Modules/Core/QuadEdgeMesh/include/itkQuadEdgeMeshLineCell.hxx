@@ -29,11 +29,11 @@ QuadEdgeMeshLineCell< TCellInterface >
 ::QuadEdgeMeshLineCell()
 {
   m_Identifier = 0;
-  m_QuadEdgeGeom = new QEType;
+  m_QuadEdgeGeom = &m_PrimalEdge;
 
-  auto * e2 = new QEType;
-  auto * e1 = new QEDual;
-  auto * e3 = new QEDual;
+  QEType *e2 = &m_SymEdge;
+  QEDual *e1 = &m_RotEdge;
+  QEDual *e3 = &m_InvRotEdge;
   this->m_QuadEdgeGeom->SetRot(e1);
   e1->SetRot(e2);
   e2->SetRot(e3);
@@ -56,52 +56,7 @@ QuadEdgeMeshLineCell< TCellInterface >
   //  {
   //  m_QuadEdgeGeom->Disconnect( );
   //  }
-
-  bool FoundNullPointer = false;
-
-  if ( m_QuadEdgeGeom )
-    {
-    if ( m_QuadEdgeGeom->GetRot() )
-      {
-      if ( m_QuadEdgeGeom->GetRot()->GetRot() )
-        {
-        if ( m_QuadEdgeGeom->GetRot()->GetRot()->GetRot() )
-          {
-          delete m_QuadEdgeGeom->GetRot()->GetRot()->GetRot();    //e3
-          delete m_QuadEdgeGeom->GetRot()->GetRot();              //e2
-          delete m_QuadEdgeGeom->GetRot();                        //e1
-          delete m_QuadEdgeGeom;
-          }
-        else
-          {
-          FoundNullPointer = true;
-          delete m_QuadEdgeGeom->GetRot()->GetRot();              //e2
-          delete m_QuadEdgeGeom->GetRot();                        //e1
-          delete m_QuadEdgeGeom;
-          }
-        }
-      else
-        {
-        FoundNullPointer = true;
-        delete m_QuadEdgeGeom->GetRot();                        //e1
-        delete m_QuadEdgeGeom;
-        }
-      }
-    else
-      {
-      FoundNullPointer = true;
-      delete m_QuadEdgeGeom;
-      }
-    }
-  else
-    {
-    FoundNullPointer = true;
-    }
-
-  if ( FoundNullPointer )
-    {
-    //Throw exception here
-    }
+  // The quad-edges are members and go away with the cell.
 }
 
 // ---------------------------------------------------------------------
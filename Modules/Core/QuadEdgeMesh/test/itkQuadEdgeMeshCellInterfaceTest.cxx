@@ -430,29 +430,18 @@ int itkQuadEdgeMeshCellInterfaceTest(int, char* [] )
 
   mesh->Accept(   multiVisitor );
 
-  // test 4 very specific QELineCell destructor cases
+  // the four quad-edges of a QELineCell are owned by the cell
   auto * test = new QELineCellType();
   QEType* m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( nullptr );
-  delete test;
-
-  test = new QELineCellType();
-  m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( nullptr );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->SetRot( nullptr );
-  delete test;
-
-  test = new QELineCellType();
-  m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( nullptr );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->SetRot( nullptr );
-  delete m_QuadEdgeGeom->GetRot( );
-  m_QuadEdgeGeom->SetRot( nullptr );
+  if( m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( )->GetRot( ) != m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetSym( ) == m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetSym( )->GetSym( ) != m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetOnext( ) != m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetRot( )->GetOnext( ) != m_QuadEdgeGeom->GetInvRot( ) )
+    {
+    std::cerr << "QELineCell quad-edges are not linked properly" << std::endl;
+    status = EXIT_FAILURE;
+    }
   delete test;
 
   return status;
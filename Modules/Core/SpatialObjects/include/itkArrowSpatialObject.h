@@ -137,6 +137,10 @@ private:
   VectorType m_Direction;
   PointType  m_Position;
   double     m_Length;
+
+  /** TimeStamps of the last bounding box computation */
+  mutable ModifiedTimeType m_OldMTime{ 0 };
+  mutable ModifiedTimeType m_IndexToWorldTransformMTime{ 0 };
 };
 } // end namespace itk
 
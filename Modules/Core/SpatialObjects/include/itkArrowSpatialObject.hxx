@@ -75,6 +75,20 @@ ArrowSpatialObject< TDimension >
 {
   itkDebugMacro("Computing Rectangle bounding box");
 
+  // IsInside() calls this method on every query. Skipping the
+  // recomputation while the arrow and its transform are unchanged keeps
+  // the queries free of writes, so that the arrow can be queried from
+  // several threads once its bounds are up to date.
+  if ( ( this->Object::GetMTime() == m_OldMTime )
+       && ( m_IndexToWorldTransformMTime ==
+            this->GetIndexToWorldTransform()->GetMTime() ) )
+    {
+    return true;
+    }
+
+  m_OldMTime = this->Object::GetMTime();
+  m_IndexToWorldTransformMTime = this->GetIndexToWorldTransform()->GetMTime();
+
   if ( this->GetBoundingBoxChildrenName().empty()
        || strstr( typeid( Self ).name(), this->GetBoundingBoxChildrenName().c_str() ) )
     {
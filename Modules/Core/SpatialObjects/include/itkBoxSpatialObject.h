@@ -91,6 +91,10 @@ protected:
 
   SizeType m_Size;
 
+  /** TimeStamps of the last bounding box computation */
+  mutable ModifiedTimeType m_OldMTime{ 0 };
+  mutable ModifiedTimeType m_IndexToWorldTransformMTime{ 0 };
+
   /** Print the object informations in a stream. */
   void PrintSelf(std::ostream & os, Indent indent) const override;
 };
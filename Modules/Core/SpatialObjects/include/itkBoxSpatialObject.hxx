@@ -117,6 +117,19 @@ BoxSpatialObject< TDimension >
 {
   itkDebugMacro("Computing BoxSpatialObject bounding box");
 
+  // The bounds only change with the object or its transform. Skipping the
+  // recomputation otherwise keeps IsInside() free of writes, so that the
+  // object can be queried from several threads.
+  if ( ( this->Object::GetMTime() == m_OldMTime )
+       && ( m_IndexToWorldTransformMTime ==
+            this->GetIndexToWorldTransform()->GetMTime() ) )
+    {
+    return true;
+    }
+
+  m_OldMTime = this->Object::GetMTime();
+  m_IndexToWorldTransformMTime = this->GetIndexToWorldTransform()->GetMTime();
+
   if ( this->GetBoundingBoxChildrenName().empty()
        || strstr( typeid( Self ).name(),
                   this->GetBoundingBoxChildrenName().c_str() ) )
@@ -119,6 +119,10 @@ protected:
   ScalarType m_Radius;
   ScalarType m_Sigma;
 
+  /** TimeStamps of the last bounding box computation */
+  mutable ModifiedTimeType m_OldMTime{ 0 };
+  mutable ModifiedTimeType m_IndexToWorldTransformMTime{ 0 };
+
   /** Print the object information in a stream. */
   void PrintSelf(std::ostream & os, Indent indent) const override;
 };
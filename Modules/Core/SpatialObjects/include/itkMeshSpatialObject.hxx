@@ -69,7 +69,8 @@ MeshSpatialObject< TMesh >
 
   if ( this->GetBounds()->IsInside(transformedPoint) )
     {
-    typename MeshType::CellsContainerPointer cells =  m_Mesh->GetCells();
+    const MeshType *mesh = m_Mesh.GetPointer();
+    const typename MeshType::CellsContainer *cells = mesh->GetCells();
     typename MeshType::CellsContainer::ConstIterator it = cells->Begin();
     while ( it != cells->End() )
       {
@@ -186,6 +187,9 @@ MeshSpatialObject< TMesh >
 ::SetMesh(MeshType *mesh)
 {
   m_Mesh = mesh;
+  // Convert compact cell arrays once here rather than in IsInside(), which
+  // may run on several threads.
+  m_Mesh->ConvertCellsArraysToCells();
   m_Mesh->Modified();
   this->ComputeBoundingBox();
 }
@@ -265,7 +265,9 @@ MetaMeshConverter< NDimensions, PixelType, TMeshTraits >
 
   // Add Cells
   using CellsContainer = typename MeshType::CellsContainer;
-  const CellsContainer *cells = mesh->GetCells();
+  // Cells stored as compact arrays are read through cell objects
+  const auto meshWithCells = mesh->GetMeshWithCellObjects();
+  const CellsContainer *cells = meshWithCells->GetCells();
   typename MeshType::CellsContainer::ConstIterator it_cells = cells->Begin();
 
   while ( it_cells != cells->End() )
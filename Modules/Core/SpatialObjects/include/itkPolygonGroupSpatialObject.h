@@ -96,14 +96,29 @@ public:
   /** Same as Volume, above. */
   double MeasureVolume();
 
-  /** Test whether a point is inside or outside the object. */
+  /** Test whether a point is inside or outside the object. The bounds of
+   *  the strands are only recomputed when the group, one of its strands or
+   *  their transforms changed since the last ComputeBoundingBox(), so the
+   *  query only reads the group once its bounds are up to date. */
   bool IsInside(const PointType & point,
                         unsigned int depth = 0,
                         char *name = nullptr) const override;
 
+  /** Compute the bounding box of the group and of its strands. */
+  bool ComputeBoundingBox() const override;
+
 protected:
   PolygonGroupSpatialObject(void) {}
   ~PolygonGroupSpatialObject(void) override {}
+
+  /** Latest modified time of the group, of its strands and of their
+   *  IndexToWorld transforms. */
+  ModifiedTimeType GetBoundsMTime() const;
+
+private:
+  /** Value of GetBoundsMTime() when the bounds used by IsInside() were last
+   *  computed, zero when they are not valid. */
+  mutable ModifiedTimeType m_IsInsideBoundsMTime{ 0 };
 };
 }
 #ifndef ITK_MANUAL_INSTANTIATION
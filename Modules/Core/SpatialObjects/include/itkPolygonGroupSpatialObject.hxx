@@ -19,6 +19,7 @@
 #define itkPolygonGroupSpatialObject_hxx
 
 #include "itkPolygonGroupSpatialObject.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -114,17 +115,55 @@ double PolygonGroupSpatialObject< TDimension >::MeasureVolume()
 template< unsigned int TDimension >
 bool PolygonGroupSpatialObject< TDimension >::IsInside(const PointType & point, unsigned int, char *name) const
 {
-  // want to encompass all children, at least 2 levels, but to be
-  // safe say 4;
-  const_cast< Self * >( this )->SetBoundingBoxChildrenDepth(4);
-  const_cast< Self * >( this )->SetBoundingBoxChildrenName("");
-  const_cast< Self * >( this )->ComputeBoundingBox();
-  BoundingBoxType *bounds = const_cast< Self * >( this )->GetBoundingBox();
-  if ( !bounds->IsInside(point) )
+  if ( m_IsInsideBoundsMTime != this->GetBoundsMTime() )
+    {
+    // want to encompass all children, at least 2 levels, but to be
+    // safe say 4;
+    const_cast< Self * >( this )->SetBoundingBoxChildrenDepth(4);
+    const_cast< Self * >( this )->SetBoundingBoxChildrenName("");
+    this->ComputeBoundingBox();
+    }
+  if ( !this->GetBounds()->IsInside(point) )
     {
     return false;
     }
   return this->SpatialObject< TDimension >::IsInside(point, 4, name);
 }
+
+template< unsigned int TDimension >
+bool PolygonGroupSpatialObject< TDimension >::ComputeBoundingBox() const
+{
+  const bool result = Superclass::ComputeBoundingBox();
+
+  // The bounds can serve IsInside() when they cover the children it visits
+  if ( this->GetBoundingBoxChildrenDepth() >= 4
+       && this->GetBoundingBoxChildrenName().empty() )
+    {
+    m_IsInsideBoundsMTime = this->GetBoundsMTime();
+    }
+  else
+    {
+    m_IsInsideBoundsMTime = 0;
+    }
+  return result;
+}
+
+template< unsigned int TDimension >
+ModifiedTimeType PolygonGroupSpatialObject< TDimension >::GetBoundsMTime() const
+{
+  ModifiedTimeType latestTime = std::max( this->GetMTime(),
+                                          this->GetIndexToWorldTransform()->GetMTime() );
+  const TreeNodeType *node = this->GetTreeNode();
+  if ( node )
+    {
+    const typename TreeNodeType::ChildIdentifier numberOfChildren = node->CountChildren();
+    for ( typename TreeNodeType::ChildIdentifier i = 0; i < numberOfChildren; ++i )
+      {
+      latestTime = std::max( latestTime,
+                             node->GetChild(i)->Get()->GetIndexToWorldTransform()->GetMTime() );
+      }
+    }
+  return latestTime;
+}
 }
 #endif
@@ -148,21 +148,17 @@ SpatialObject< TDimension >
 {
   if ( depth > 0 )
     {
-    using TreeChildrenListType = typename TreeNodeType::ChildrenListType;
-    TreeChildrenListType *children = m_TreeNode->GetChildren();
-    typename TreeChildrenListType::const_iterator it = children->begin();
-    typename TreeChildrenListType::const_iterator itEnd = children->end();
-
-    while ( it != itEnd )
+    // Walk the children in place: this is called once per sample when
+    // rasterizing, so copying the children list would dominate the cost.
+    const typename TreeNodeType::ChildrenListType & children =
+      m_TreeNode->GetChildrenList();
+    for ( const auto & child : children )
       {
-      if ( ( *it )->Get()->IsInside(point, depth - 1, name) )
+      if ( child->Get()->IsInside(point, depth - 1, name) )
         {
-        delete children;
         return true;
         }
-      it++;
       }
-    delete children;
     }
 
   return false;
@@ -177,21 +173,15 @@ SpatialObject< TDimension >
 {
   if ( depth > 0 )
     {
-    using TreeChildrenListType = typename TreeNodeType::ChildrenListType;
-    TreeChildrenListType *children = m_TreeNode->GetChildren();
-    typename TreeChildrenListType::const_iterator it = children->begin();
-    typename TreeChildrenListType::const_iterator itEnd = children->end();
-
-    while ( it != itEnd )
+    const typename TreeNodeType::ChildrenListType & children =
+      m_TreeNode->GetChildrenList();
+    for ( const auto & child : children )
       {
-      if ( ( *it )->Get()->IsEvaluableAt(point, depth - 1, name) )
+      if ( child->Get()->IsEvaluableAt(point, depth - 1, name) )
         {
-        delete children;
         return true;
         }
-      it++;
       }
-    delete children;
     }
 
   return false;
@@ -208,22 +198,17 @@ SpatialObject< TDimension >
 
   if ( depth > 0 )
     {
-    using TreeChildrenListType = typename TreeNodeType::ChildrenListType;
-    TreeChildrenListType *children = m_TreeNode->GetChildren();
-    typename TreeChildrenListType::const_iterator it = children->begin();
-    typename TreeChildrenListType::const_iterator itEnd = children->end();
-
-    while ( it != itEnd )
+    const typename TreeNodeType::ChildrenListType & children =
+      m_TreeNode->GetChildrenList();
+    for ( const auto & child : children )
       {
-      if ( ( *it )->Get()->IsEvaluableAt(point, depth - 1, name) )
+      if ( child->Get()->IsEvaluableAt(point, depth - 1, name) )
         {
-        ( *it )->Get()->ValueAt(point, value, depth - 1, name);
+        child->Get()->ValueAt(point, value, depth - 1, name);
         evaluable = true;
         break;
         }
-      it++;
       }
-    delete children;
     }
 
   if ( evaluable )
@@ -506,22 +491,16 @@ SpatialObject< TDimension >
     return latestTime;
     }
 
-  TreeChildrenListType *children = m_TreeNode->GetChildren();
-  typename TreeChildrenListType::const_iterator it = children->begin();
-  typename TreeChildrenListType::const_iterator itEnd = children->end();
-  ModifiedTimeType localTime;
-
-  while ( it != itEnd )
+  const TreeChildrenListType & children = m_TreeNode->GetChildrenList();
+  for ( const auto & child : children )
     {
-    localTime = ( *it )->Get()->GetMTime();
+    const ModifiedTimeType localTime = child->Get()->GetMTime();
 
     if ( localTime > latestTime )
       {
       latestTime = localTime;
       }
-    it++;
     }
-  delete children;
   return latestTime;
 }
 
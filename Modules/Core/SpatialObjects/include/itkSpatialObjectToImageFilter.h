@@ -30,6 +30,12 @@ namespace itk
  *  the maximum size of the object's bounding box is used.
  *  The spacing of the image is given by the spacing of the input
  *  Spatial object.
+ *
+ *  The output is generated by several threads, each querying the input
+ *  hierarchy for its own part of the image. The bounding box of the
+ *  hierarchy is computed beforehand, which brings the cached bounds and
+ *  search structures of the objects up to date, so that the queries
+ *  themselves only read the objects.
  * \ingroup ITKSpatialObjects
  *
  * \wiki
@@ -154,8 +160,14 @@ protected:
   SpatialObjectToImageFilter();
   ~SpatialObjectToImageFilter() override;
 
-  void GenerateOutputInformation() override {}  // do nothing
-  void GenerateData() override;
+  /** Compute the geometry of the output image from the input object,
+   *  unless it has been set explicitly. */
+  void GenerateOutputInformation() override;
+
+  void BeforeThreadedGenerateData() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) override;
 
   SizeType m_Size;
   double m_Spacing[OutputImageDimension];
@@ -278,19 +278,21 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
 
 //----------------------------------------------------------------------------
 
-/** Update */
 template< typename TInputSpatialObject, typename TOutputImage >
 void
 SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
-::GenerateData(void)
+::GenerateOutputInformation()
 {
   unsigned int i;
 
-  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() called");
-
   // Get the input and output pointers
   const InputSpatialObjectType *InputObject  = this->GetInput();
-  OutputImagePointer            OutputImage = this->GetOutput();
+  OutputImageType              *OutputImage = this->GetOutput();
+
+  if ( !InputObject || !OutputImage )
+    {
+    return;
+    }
 
   // Generate the image
   SizeType size;
@@ -331,9 +333,14 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     }
   region.SetIndex(index);
 
-  OutputImage->SetLargestPossibleRegion(region);      //
-  OutputImage->SetBufferedRegion(region);             // set the region
-  OutputImage->SetRequestedRegion(region);            //
+  // A requested region left over from a previous, larger geometry would no
+  // longer fit in the output
+  if ( region != OutputImage->GetLargestPossibleRegion() )
+    {
+    OutputImage->SetLargestPossibleRegion(region);
+    OutputImage->SetRequestedRegionToLargestPossibleRegion();
+    }
+
   // If the spacing has been explicitly specified, the filter
   // will set the output spacing to that explicit spacing, otherwise the spacing
   // from
@@ -360,17 +367,45 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     }
   OutputImage->SetOrigin(m_Origin);     //   and origin
   OutputImage->SetDirection(m_Direction);
-  OutputImage->Allocate();   // allocate the image
+}
+
+template< typename TInputSpatialObject, typename TOutputImage >
+void
+SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() called");
+
+  // The objects refresh their cached bounds and search structures when they
+  // compute their bounding box. Do it here, before the threads start
+  // querying them.
+  this->GetInput()->ComputeBoundingBox();
+}
+
+template< typename TInputSpatialObject, typename TOutputImage >
+void
+SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  unsigned int i;
+
+  const InputSpatialObjectType *InputObject  = this->GetInput();
+  OutputImageType              *OutputImage = this->GetOutput();
+
+  const bool useMask =
+    Math::NotExactlyEquals(m_InsideValue, NumericTraits< ValueType >:: ZeroValue())
+    || Math::NotExactlyEquals(m_OutsideValue, NumericTraits< ValueType >::ZeroValue());
 
   using myIteratorType = itk::ImageRegionIteratorWithIndex< OutputImageType >;
 
-  myIteratorType it(OutputImage, region);
+  myIteratorType it(OutputImage, outputRegionForThread);
 
   itk::Point< double, ObjectDimension >      objectPoint;
   itk::Point< double, OutputImageDimension > imagePoint;
 
   ProgressReporter
-    progress(this,0,OutputImage->GetRequestedRegion().GetNumberOfPixels());
+    progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
   while( !it.IsAtEnd() )
     {
@@ -384,7 +419,7 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     double val = 0;
 
     bool evaluable = InputObject->ValueAt(objectPoint, val, m_ChildrenDepth);
-    if ( Math::NotExactlyEquals(m_InsideValue, NumericTraits< ValueType >:: ZeroValue()) || Math::NotExactlyEquals(m_OutsideValue, NumericTraits< ValueType >::ZeroValue()) )
+    if ( useMask )
       {
       if ( evaluable )
         {
@@ -409,9 +444,7 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     ++it;
     progress.CompletedPixel();
     }
-
-  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() finished");
-} // end update function
+}
 
 template< typename TInputSpatialObject, typename TOutputImage >
 void
@@ -19,6 +19,7 @@
 #define itkTubeSpatialObject_h
 
 #include <list>
+#include <vector>
 
 #include "itkPointBasedSpatialObject.h"
 #include "itkTubeSpatialObjectPoint.h"
@@ -34,6 +35,14 @@ namespace itk
  * of a TubeSpatialObject Object.
  * A tube is also identified by an id number when connected to a network.
  *
+ * IsInside() searches a bounding volume hierarchy over the segments (flat
+ * end-type) or the points (rounded end-type) of the tube, so a query costs
+ * O(log n) instead of a scan of all the points. The hierarchy is rebuilt
+ * with the bounding box whenever the tube is modified; call Modified()
+ * after editing the points through GetPoints(). Once the bounding box is up
+ * to date, IsInside(), IsEvaluableAt() and ValueAt() only read the tube and
+ * can be called from several threads at once.
+ *
  * \sa TubeSpatialObjectPoint
  * \ingroup ITKSpatialObjects
  */
@@ -88,11 +97,17 @@ public:
 
   /** Set a point in the list at the specified index */
   virtual void SetPoint(IdentifierType ind, const TubePointType & pnt)
-  { m_Points[ind] = pnt; }
+  {
+    m_Points[ind] = pnt;
+    this->Modified();
+  }
 
   /** Remove a point in the list given the index */
   virtual void RemovePoint(IdentifierType ind)
-  { m_Points.erase(m_Points.begin() + ind); }
+  {
+    m_Points.erase(m_Points.begin() + ind);
+    this->Modified();
+  }
 
   /** Return the number of points in the list */
   SizeValueType GetNumberOfPoints(void) const override
@@ -173,6 +188,43 @@ protected:
   /** TimeStamps */
   mutable ModifiedTimeType m_OldMTime;
   mutable ModifiedTimeType m_IndexToWorldTransformMTime;
+
+private:
+  /** Node of the bounding volume hierarchy used by IsInside(). The box is
+   *  in index space and covers the items m_Begin to m_End of
+   *  m_SearchItems; the children of an inner node are stored at
+   *  m_FirstChild and m_FirstChild + 1. */
+  struct SearchNode {
+    double       m_Minimum[TDimension];
+    double       m_Maximum[TDimension];
+    unsigned int m_Begin;
+    unsigned int m_End;
+    unsigned int m_FirstChild; // zero for a leaf
+  };
+
+  /** Rebuild the hierarchy from the current points and end-type. */
+  void BuildSearchTree() const;
+
+  /** Exact inside test against the segment starting at point ind, for the
+   *  flat end-type. */
+  bool IsInsideSegment(const PointType & transformedPoint, SizeValueType ind) const;
+
+  /** Inside tests in index space, for the flat and rounded end-types. */
+  bool IsInsideFlat(const PointType & transformedPoint) const;
+  bool IsInsideRounded(const PointType & transformedPoint) const;
+
+  /** False when the points were edited without a call to Modified(); the
+   *  queries then fall back to a scan of all the points. */
+  bool IsSearchTreeCurrent() const
+  {
+    return m_SearchTreeEndType == m_EndType
+           && m_SearchTreeNumberOfPoints == m_Points.size();
+  }
+
+  mutable std::vector< SearchNode >   m_SearchTree;
+  mutable std::vector< unsigned int > m_SearchItems;
+  mutable unsigned int                m_SearchTreeEndType{ 0 };
+  mutable SizeValueType               m_SearchTreeNumberOfPoints{ 0 };
 };
 } // end namespace itk
 
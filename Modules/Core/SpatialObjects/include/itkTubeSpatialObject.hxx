@@ -22,6 +22,8 @@
 #include "itkMath.h"
 #include "itkTubeSpatialObject.h"
 
+#include <algorithm>
+
 namespace itk
 {
 /** Constructor */
@@ -100,6 +102,7 @@ TubeSpatialObject< TDimension, TTubePointType >
 ::Clear(void)
 {
   m_Points.clear();
+  this->Modified();
 }
 
 /** Print the object */
@@ -127,8 +130,11 @@ TubeSpatialObject< TDimension, TTubePointType >
 {
   itkDebugMacro("Computing tube bounding box");
 
-  // Check if the IndexToWorldTransform or the object itself has been modified
-  if ( ( this->GetMTime() == m_OldMTime )
+  // Check if the IndexToWorldTransform or the object itself has been
+  // modified. Only the tube's own time stamp matters here: the children do
+  // not change its local bounds, and computing the bounding box of the
+  // hierarchy touches them, which must not invalidate the search tree.
+  if ( ( this->Object::GetMTime() == m_OldMTime )
        && ( m_IndexToWorldTransformMTime ==
             this->GetIndexToWorldTransform()->GetMTime() )
         )
@@ -136,9 +142,11 @@ TubeSpatialObject< TDimension, TTubePointType >
     return true; // if not modified we return
     }
 
-  m_OldMTime = this->GetMTime();
+  m_OldMTime = this->Object::GetMTime();
   m_IndexToWorldTransformMTime = this->GetIndexToWorldTransform()->GetMTime();
 
+  this->BuildSearchTree();
+
   if ( this->GetBoundingBoxChildrenName().empty()
        || strstr( typeid( Self ).name(), this->GetBoundingBoxChildrenName().c_str() ) )
     {
@@ -190,118 +198,440 @@ TubeSpatialObject< TDimension, TTubePointType >
   return true;
 }
 
-/** Test whether a point is inside or outside the object
- *  For computational speed purposes, it is faster if the method does not
- *  check the name of the class and the current depth */
+/** Build the bounding volume hierarchy over the segments or the points */
 template< unsigned int TDimension, typename TTubePointType >
-bool
+void
 TubeSpatialObject< TDimension, TTubePointType >
-::IsInside(const PointType & point) const
+::BuildSearchTree() const
 {
-  this->ComputeLocalBoundingBox();
-  if ( !this->GetBounds()->IsInside(point) )
+  // Small enough for a leaf to fit in a few cache lines, large enough to
+  // keep the tree shallow.
+  constexpr unsigned int LeafSize = 8;
+
+  const SizeValueType numberOfPoints = m_Points.size();
+
+  m_SearchTree.clear();
+  m_SearchItems.clear();
+  m_SearchTreeEndType = m_EndType;
+  m_SearchTreeNumberOfPoints = numberOfPoints;
+
+  // Box of every item, indexed like the points
+  std::vector< SearchNode > itemBoxes(numberOfPoints);
+
+  if ( m_EndType == 0 )
     {
-    return false;
-    }
+    for ( SizeValueType i = 0; i + 1 < numberOfPoints; ++i )
+      {
+      const PointType & a = m_Points[i].GetPosition();
+      const PointType & b = m_Points[i + 1].GetPosition();
+      const double      ra = m_Points[i].GetRadius();
+      const double      rb = m_Points[i + 1].GetRadius();
 
-  double minSquareDist = 999999.0;
-  double tempSquareDist;
-  auto it = m_Points.begin();
-  auto it2 = m_Points.begin();
-  auto end = m_Points.end();
-  typename PointListType::const_iterator min;
+      double B = 0;
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        B += ( b[d] - a[d] ) * ( b[d] - a[d] );
+        }
+      if ( !( B > 0 ) )
+        {
+        continue; // IsInsideSegment() never succeeds on a degenerate segment
+        }
 
-  if ( !this->SetInternalInverseTransformToWorldToIndexTransform() )
+      // The test accepts the points within R of the axis between a and b,
+      // and, past the first segment, within R of the axis continued from b
+      // back towards a by up to ra / 2.
+      SearchNode & box = itemBoxes[i];
+      double       radius = std::max(std::max(ra, rb), 0.0);
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        box.m_Minimum[d] = std::min(a[d], b[d]);
+        box.m_Maximum[d] = std::max(a[d], b[d]);
+        }
+      if ( i > 0 )
+        {
+        const double lambda = -( ra / ( 2 * std::sqrt(B) ) );
+        radius = std::max(radius, rb + lambda * ( rb - ra ));
+        for ( unsigned int d = 0; d < TDimension; ++d )
+          {
+          const double c = b[d] + lambda * ( b[d] - a[d] );
+          box.m_Minimum[d] = std::min(box.m_Minimum[d], c);
+          box.m_Maximum[d] = std::max(box.m_Maximum[d], c);
+          }
+        }
+
+      // Pad for the rounding of the exact test
+      double scale = radius;
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        scale = std::max(scale, std::max(std::abs(box.m_Minimum[d]),
+                                         std::abs(box.m_Maximum[d])));
+        }
+      const double pad = radius + 1e-9 * ( 1.0 + scale );
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        box.m_Minimum[d] -= pad;
+        box.m_Maximum[d] += pad;
+        }
+      m_SearchItems.push_back(static_cast< unsigned int >( i ));
+      }
+    }
+  else if ( m_EndType == 1 )
     {
-    return false;
+    for ( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      const PointType & position = m_Points[i].GetPosition();
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        itemBoxes[i].m_Minimum[d] = position[d];
+        itemBoxes[i].m_Maximum[d] = position[d];
+        }
+      m_SearchItems.push_back(static_cast< unsigned int >( i ));
+      }
     }
 
-  PointType transformedPoint =
-    this->GetInternalInverseTransform()->TransformPoint(point);
+  if ( m_SearchItems.empty() )
+    {
+    return;
+    }
 
-  if ( m_EndType == 0 ) // flat end-type
+  // Top-down build, splitting the items at the median of their box centers
+  // along the widest axis. The median split keeps the depth logarithmic.
+  SearchNode root;
+  root.m_Begin = 0;
+  root.m_End = static_cast< unsigned int >( m_SearchItems.size() );
+  root.m_FirstChild = 0;
+  m_SearchTree.push_back(root);
+
+  std::vector< unsigned int > pending(1, 0);
+  while ( !pending.empty() )
     {
-    it2++; // next point
-    while ( it2 != end )
+    const unsigned int nodeId = pending.back();
+    pending.pop_back();
+
+    SearchNode & node = m_SearchTree[nodeId];
+    double       centerMinimum[TDimension];
+    double       centerMaximum[TDimension];
+    for ( unsigned int d = 0; d < TDimension; ++d )
       {
-      // Check if the point is on the normal plane
-      PointType a = ( *it ).GetPosition();
-      PointType b = ( *it2 ).GetPosition();
+      node.m_Minimum[d] = NumericTraits< double >::max();
+      node.m_Maximum[d] = NumericTraits< double >::NonpositiveMin();
+      centerMinimum[d] = NumericTraits< double >::max();
+      centerMaximum[d] = NumericTraits< double >::NonpositiveMin();
+      }
+    for ( unsigned int k = node.m_Begin; k < node.m_End; ++k )
+      {
+      const SearchNode & box = itemBoxes[m_SearchItems[k]];
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        node.m_Minimum[d] = std::min(node.m_Minimum[d], box.m_Minimum[d]);
+        node.m_Maximum[d] = std::max(node.m_Maximum[d], box.m_Maximum[d]);
+        const double center = 0.5 * ( box.m_Minimum[d] + box.m_Maximum[d] );
+        centerMinimum[d] = std::min(centerMinimum[d], center);
+        centerMaximum[d] = std::max(centerMaximum[d], center);
+        }
+      }
 
-      double A = 0;
-      double B = 0;
+    if ( node.m_End - node.m_Begin <= LeafSize )
+      {
+      continue;
+      }
+
+    unsigned int axis = 0;
+    for ( unsigned int d = 1; d < TDimension; ++d )
+      {
+      if ( centerMaximum[d] - centerMinimum[d]
+           > centerMaximum[axis] - centerMinimum[axis] )
+        {
+        axis = d;
+        }
+      }
+
+    const unsigned int begin = node.m_Begin;
+    const unsigned int end = node.m_End;
+    const unsigned int middle = begin + ( end - begin ) / 2;
+    std::nth_element(m_SearchItems.begin() + begin,
+                     m_SearchItems.begin() + middle,
+                     m_SearchItems.begin() + end,
+                     [&itemBoxes, axis](unsigned int i, unsigned int j)
+                       {
+                       return itemBoxes[i].m_Minimum[axis] + itemBoxes[i].m_Maximum[axis]
+                              < itemBoxes[j].m_Minimum[axis] + itemBoxes[j].m_Maximum[axis];
+                       });
+
+    const auto firstChild = static_cast< unsigned int >( m_SearchTree.size() );
+    node.m_FirstChild = firstChild;
+
+    SearchNode child;
+    child.m_FirstChild = 0;
+    child.m_Begin = begin;
+    child.m_End = middle;
+    m_SearchTree.push_back(child); // invalidates node
+    child.m_Begin = middle;
+    child.m_End = end;
+    m_SearchTree.push_back(child);
+    pending.push_back(firstChild);
+    pending.push_back(firstChild + 1);
+    }
+}
+
+/** Exact inside test against one segment of a flat-ended tube */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsInsideSegment(const PointType & transformedPoint, SizeValueType ind) const
+{
+  // Check if the point is on the normal plane
+  const TubePointType & pa = m_Points[ind];
+  const TubePointType & pb = m_Points[ind + 1];
+  PointType a = pa.GetPosition();
+  PointType b = pb.GetPosition();
+
+  double A = 0;
+  double B = 0;
+
+  for ( unsigned int i = 0; i < TDimension; i++ )
+    {
+    A += ( b[i] - a[i] ) * ( transformedPoint[i] - a[i] );
+    B += ( b[i] - a[i] ) * ( b[i] - a[i] );
+    }
+
+  double lambda = A / B;
 
+  if ( ( ( ind != 0 )
+         && ( lambda > -( pa.GetRadius() / ( 2 * std::sqrt(B) ) ) )
+         && ( lambda < 0 ) )
+       || ( ( lambda <= 1.0 ) && ( lambda >= 0.0 ) )
+        )
+    {
+    PointType p;
+
+    if ( lambda >= 0 )
+      {
       for ( unsigned int i = 0; i < TDimension; i++ )
         {
-        A += ( b[i] - a[i] ) * ( transformedPoint[i] - a[i] );
-        B += ( b[i] - a[i] ) * ( b[i] - a[i] );
+        p[i] = a[i] + lambda * ( b[i] - a[i] );
+        }
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < TDimension; i++ )
+        {
+        p[i] = b[i] + lambda * ( b[i] - a[i] );
+        }
+      }
+
+    double tempSquareDist = transformedPoint.EuclideanDistanceTo(p);
+
+    double R;
+    if ( lambda >= 0 )
+      {
+      R = pa.GetRadius() + lambda * ( pb.GetRadius() - pa.GetRadius() );
+      }
+    else
+      {
+      R = pb.GetRadius() + lambda * ( pb.GetRadius() - pa.GetRadius() );
+      }
+
+    if ( tempSquareDist <= R )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+/** A point is inside a flat-ended tube if it is inside any segment */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsInsideFlat(const PointType & transformedPoint) const
+{
+  if ( !this->IsSearchTreeCurrent() )
+    {
+    for ( SizeValueType i = 0; i + 1 < m_Points.size(); ++i )
+      {
+      if ( this->IsInsideSegment(transformedPoint, i) )
+        {
+        return true;
         }
+      }
+    return false;
+    }
+
+  if ( m_SearchTree.empty() )
+    {
+    return false;
+    }
 
-      double lambda = A / B;
+  // The median split bounds the depth by log2 of the number of items, so
+  // a fixed stack is enough.
+  unsigned int stack[64];
+  unsigned int top = 0;
+  stack[top++] = 0;
+  while ( top > 0 )
+    {
+    const SearchNode & node = m_SearchTree[stack[--top]];
 
-      if ( ( ( it != m_Points.begin() )
-             && ( lambda > -( ( *it ).GetRadius() / ( 2 * std::sqrt(B) ) ) )
-             && ( lambda < 0 ) )
-           || ( ( lambda <= 1.0 ) && ( lambda >= 0.0 ) )
-            )
+    bool inside = true;
+    for ( unsigned int d = 0; d < TDimension; ++d )
+      {
+      if ( transformedPoint[d] < node.m_Minimum[d]
+           || transformedPoint[d] > node.m_Maximum[d] )
         {
-        PointType p;
+        inside = false;
+        break;
+        }
+      }
+    if ( !inside )
+      {
+      continue;
+      }
 
-        if ( lambda >= 0 )
-          {
-          for ( unsigned int i = 0; i < TDimension; i++ )
-            {
-            p[i] = a[i] + lambda * ( b[i] - a[i] );
-            }
-          }
-        else
+    if ( node.m_FirstChild == 0 )
+      {
+      for ( unsigned int k = node.m_Begin; k < node.m_End; ++k )
+        {
+        if ( this->IsInsideSegment(transformedPoint, m_SearchItems[k]) )
           {
-          for ( unsigned int i = 0; i < TDimension; i++ )
-            {
-            p[i] = b[i] + lambda * ( b[i] - a[i] );
-            }
+          return true;
           }
+        }
+      }
+    else
+      {
+      stack[top++] = node.m_FirstChild;
+      stack[top++] = node.m_FirstChild + 1;
+      }
+    }
+  return false;
+}
 
-        tempSquareDist = transformedPoint.EuclideanDistanceTo(p);
+/** A point is inside a round-ended tube if it is within the radius of the
+ *  nearest tube point; ties go to the last of the nearest points. */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsInsideRounded(const PointType & transformedPoint) const
+{
+  double        minSquareDist = 999999.0;
+  bool          found = false;
+  SizeValueType nearest = 0;
 
-        double R;
-        if ( lambda >= 0 )
+  const auto consider = [&](SizeValueType i)
+    {
+    const double squareDist =
+      transformedPoint.SquaredEuclideanDistanceTo(m_Points[i].GetPosition());
+    if ( squareDist < minSquareDist
+         || ( squareDist <= minSquareDist && ( !found || i > nearest ) ) )
+      {
+      minSquareDist = squareDist;
+      nearest = i;
+      found = true;
+      }
+    };
+
+  if ( !this->IsSearchTreeCurrent() )
+    {
+    for ( SizeValueType i = 0; i < m_Points.size(); ++i )
+      {
+      consider(i);
+      }
+    }
+  else if ( !m_SearchTree.empty() )
+    {
+    // The distance to a box is computed with the same rounding as the
+    // distance to a point inside it, so it never exceeds the latter and the
+    // search finds exactly the point the linear scan would.
+    const auto squareDistanceToNode = [&transformedPoint](const SearchNode & node)
+      {
+      double squareDist = 0;
+      for ( unsigned int d = 0; d < TDimension; ++d )
+        {
+        double difference = 0;
+        if ( transformedPoint[d] < node.m_Minimum[d] )
           {
-          R = ( *it ).GetRadius() + lambda * ( ( *it2 ).GetRadius() - ( *it ).GetRadius() );
+          difference = transformedPoint[d] - node.m_Minimum[d];
           }
-        else
+        else if ( transformedPoint[d] > node.m_Maximum[d] )
           {
-          R = ( *it2 ).GetRadius() + lambda * ( ( *it2 ).GetRadius() - ( *it ).GetRadius() );
+          difference = transformedPoint[d] - node.m_Maximum[d];
           }
+        squareDist += difference * difference;
+        }
+      return squareDist;
+      };
 
-        if ( tempSquareDist <= R )
+    unsigned int stack[64];
+    unsigned int top = 0;
+    stack[top++] = 0;
+    while ( top > 0 )
+      {
+      const SearchNode & node = m_SearchTree[stack[--top]];
+      // Nodes at the current distance may still hold a later tie
+      if ( squareDistanceToNode(node) > minSquareDist )
+        {
+        continue;
+        }
+      if ( node.m_FirstChild == 0 )
+        {
+        for ( unsigned int k = node.m_Begin; k < node.m_End; ++k )
           {
-          return true;
+          consider(m_SearchItems[k]);
           }
         }
-      it++;
-      it2++;
-      }
-    }
-  else if ( m_EndType == 1 ) // rounded end-type
-    {
-    while ( it != end )
-      {
-      tempSquareDist = transformedPoint.SquaredEuclideanDistanceTo(
-        ( *it ).GetPosition() );
-      if ( tempSquareDist <= minSquareDist )
+      else
         {
-        minSquareDist = tempSquareDist;
-        min = it;
+        // Visit the nearer child first to tighten the bound early
+        unsigned int near = node.m_FirstChild;
+        unsigned int far = node.m_FirstChild + 1;
+        if ( squareDistanceToNode(m_SearchTree[far])
+             < squareDistanceToNode(m_SearchTree[near]) )
+          {
+          std::swap(near, far);
+          }
+        stack[top++] = far;
+        stack[top++] = near;
         }
-      it++;
       }
+    }
 
-    double dist = std::sqrt(minSquareDist);
-    if ( dist <= ( ( *min ).GetRadius() ) )
-      {
-      return true;
-      }
+  if ( !found )
+    {
+    return false;
+    }
+  const double dist = std::sqrt(minSquareDist);
+  return dist <= m_Points[nearest].GetRadius();
+}
+
+/** Test whether a point is inside or outside the object
+ *  For computational speed purposes, it is faster if the method does not
+ *  check the name of the class and the current depth */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsInside(const PointType & point) const
+{
+  this->ComputeLocalBoundingBox();
+  if ( !this->GetBounds()->IsInside(point) )
+    {
+    return false;
+    }
+
+  if ( !this->SetInternalInverseTransformToWorldToIndexTransform() )
+    {
+    return false;
+    }
+
+  PointType transformedPoint =
+    this->GetInternalInverseTransform()->TransformPoint(point);
+
+  if ( m_EndType == 0 ) // flat end-type
+    {
+    return this->IsInsideFlat(transformedPoint);
+    }
+  else if ( m_EndType == 1 ) // rounded end-type
+    {
+    return this->IsInsideRounded(transformedPoint);
     }
   return false;
 }
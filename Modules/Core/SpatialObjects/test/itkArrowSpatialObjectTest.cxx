@@ -94,6 +94,20 @@ int itkArrowSpatialObjectTest(int, char* [])
 
   std::cout << "[PASSED]" << std::endl;
 
+  // The cached bounds follow the arrow
+  std::cout << "Bounds after SetPosition: ";
+  myArrow->SetPosition(0, 0, 5);
+  myArrow->IsInside(in);
+  if( (itk::Math::NotExactlyEquals(boundingBox->GetBounds()[4], 5) )
+     || (itk::Math::NotExactlyEquals(boundingBox->GetBounds()[5], 5) )
+      )
+    {
+      std::cout<<"[FAILED]"<<std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << "[PASSED]" << std::endl;
+
   std::cout << "Testing 2D Arrow:";
   using Arrow2DType = itk::ArrowSpatialObject<2>;
   Arrow2DType::Pointer myArrow2D = Arrow2DType::New();
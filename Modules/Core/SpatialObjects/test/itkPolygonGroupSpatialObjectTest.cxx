@@ -262,5 +262,57 @@ int itkPolygonGroupSpatialObjectTest(int, char *[])
               << std::endl;
     }
 
+  // Moving a strand and calling Modified() on it refreshes the bounds used
+  // by IsInside
+  PolygonGroup3DType::ChildrenListType *strands = PolygonGroup->GetChildren();
+  auto * strand = static_cast< itk::PolygonSpatialObject<3> * >( strands->front().GetPointer() );
+  delete strands;
+  PolygonGroup->IsInside(insidepoint);
+  for(auto & strandPoint : strand->GetPoints())
+    {
+    itk::PolygonSpatialObject<3>::PointType position = strandPoint.GetPosition();
+    position[0] += 100.0;
+    strandPoint.SetPosition(position);
+    }
+  strand->Modified();
+  itk::PolygonSpatialObject<3>::PointType movedInsidePoint = insidepoint;
+  movedInsidePoint[0] += 100.0;
+  movedInsidePoint[2] = 0.0;
+  if(!strand->IsInside(movedInsidePoint) || !PolygonGroup->IsInside(movedInsidePoint))
+    {
+    std::cerr << "101.75,1.75,0 is inside the moved strand, IsInside returns false"
+              << std::endl;
+    return 1;
+    }
+  movedInsidePoint[0] -= 100.0;
+  if(strand->IsInside(movedInsidePoint))
+    {
+    std::cerr << "1.75,1.75,0 is not inside the moved strand, IsInside returns true"
+              << std::endl;
+    return 1;
+    }
+  for(auto & strandPoint : strand->GetPoints())
+    {
+    itk::PolygonSpatialObject<3>::PointType position = strandPoint.GetPosition();
+    position[0] -= 100.0;
+    strandPoint.SetPosition(position);
+    }
+  strand->Modified();
+
+  // Moving the group refreshes the bounds used by IsInside
+  PolygonGroup3DType::TransformType::OutputVectorType offset;
+  offset[0] = 0.0;
+  offset[1] = 0.0;
+  offset[2] = 20.0;
+  PolygonGroup->GetObjectToParentTransform()->SetOffset(offset);
+  PolygonGroup->ComputeObjectToWorldTransform();
+  insidepoint[2] += 20.0;
+  if(!PolygonGroup->IsInside(insidepoint))
+    {
+    std::cerr << "1.75,1.75,25 is inside the moved PolygonGroup, IsInside returns false"
+              << std::endl;
+    return 1;
+    }
+
   return 0;
 }
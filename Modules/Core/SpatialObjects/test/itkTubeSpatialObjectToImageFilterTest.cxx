@@ -0,0 +1,304 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGroupSpatialObject.h"
+#include "itkTubeSpatialObject.h"
+#include "itkSpatialObjectToImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <random>
+
+namespace
+{
+using TubeType = itk::TubeSpatialObject< 3 >;
+
+// Linear scan over all the points, as IsInside() did before it used a
+// search tree. The query point is in index space.
+bool
+BruteForceIsInside(const TubeType * tube, const TubeType::PointType & point)
+{
+  const TubeType::PointListType & points = tube->GetPoints();
+
+  // The tube has an identity transform: its bounding box is the box of the
+  // points grown by their radius
+  for ( unsigned int d = 0; d < 3; ++d )
+    {
+    double minimum = itk::NumericTraits< double >::max();
+    double maximum = itk::NumericTraits< double >::NonpositiveMin();
+    for ( const auto & tubePoint : points )
+      {
+      minimum = std::min(minimum, tubePoint.GetPosition()[d] - tubePoint.GetRadius());
+      maximum = std::max(maximum, tubePoint.GetPosition()[d] + tubePoint.GetRadius());
+      }
+    if ( point[d] < minimum || point[d] > maximum )
+      {
+      return false;
+      }
+    }
+
+  if ( tube->GetEndType() == 0 )
+    {
+    for ( size_t i = 0; i + 1 < points.size(); ++i )
+      {
+      const TubeType::PointType a = points[i].GetPosition();
+      const TubeType::PointType b = points[i + 1].GetPosition();
+      double A = 0;
+      double B = 0;
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        A += ( b[d] - a[d] ) * ( point[d] - a[d] );
+        B += ( b[d] - a[d] ) * ( b[d] - a[d] );
+        }
+      const double lambda = A / B;
+      if ( ( i > 0 && lambda > -( points[i].GetRadius() / ( 2 * std::sqrt(B) ) ) && lambda < 0 )
+           || ( lambda <= 1.0 && lambda >= 0.0 ) )
+        {
+        TubeType::PointType p;
+        for ( unsigned int d = 0; d < 3; ++d )
+          {
+          p[d] = ( lambda >= 0 ? a[d] : b[d] ) + lambda * ( b[d] - a[d] );
+          }
+        const double R = ( lambda >= 0 ? points[i].GetRadius() : points[i + 1].GetRadius() )
+          + lambda * ( points[i + 1].GetRadius() - points[i].GetRadius() );
+        if ( point.EuclideanDistanceTo(p) <= R )
+          {
+          return true;
+          }
+        }
+      }
+    return false;
+    }
+
+  double minSquareDist = 999999.0;
+  size_t nearest = points.size();
+  for ( size_t i = 0; i < points.size(); ++i )
+    {
+    const double squareDist = point.SquaredEuclideanDistanceTo(points[i].GetPosition());
+    if ( squareDist <= minSquareDist )
+      {
+      minSquareDist = squareDist;
+      nearest = i;
+      }
+    }
+  return nearest < points.size()
+         && std::sqrt(minSquareDist) <= points[nearest].GetRadius();
+}
+
+TubeType::Pointer
+MakeRandomTube(std::mt19937 & generator, unsigned int numberOfPoints,
+               unsigned int endType, double step)
+{
+  std::uniform_real_distribution< double > uniform(-1.0, 1.0);
+
+  TubeType::PointListType points;
+  double position[3] = { 8 * uniform(generator), 8 * uniform(generator), 8 * uniform(generator) };
+  for ( unsigned int i = 0; i < numberOfPoints; ++i )
+    {
+    TubeType::TubePointType point;
+    point.SetPosition(position[0], position[1], position[2]);
+    point.SetRadius(1.5 + uniform(generator));
+    points.push_back(point);
+    if ( i % 9 == 4 )
+      {
+      points.push_back(point); // duplicated points make degenerate segments
+      }
+    for ( double & coordinate : position )
+      {
+      coordinate += step * uniform(generator);
+      }
+    }
+
+  TubeType::Pointer tube = TubeType::New();
+  tube->SetPoints(points);
+  tube->SetEndType(endType);
+  return tube;
+}
+}
+
+int itkTubeSpatialObjectToImageFilterTest(int, char* [] )
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution< double > uniform(-1.0, 1.0);
+
+  // The search tree must give exactly the answers of a linear scan, for
+  // both end-types.
+  for ( unsigned int endType = 0; endType < 2; ++endType )
+    {
+    TubeType::Pointer tube = MakeRandomTube(generator, 500, endType, 0.7);
+    tube->ComputeBoundingBox();
+
+    unsigned int numberOfInside = 0;
+    for ( unsigned int i = 0; i < 20000; ++i )
+      {
+      TubeType::PointType point;
+      const TubeType::PointType & center =
+        tube->GetPoints()[i % tube->GetNumberOfPoints()].GetPosition();
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        point[d] = center[d] + 3.0 * uniform(generator);
+        }
+      if ( i % 4 == 0 )
+        {
+        point = center;
+        }
+      const bool inside = tube->IsInside(point);
+      if ( inside != BruteForceIsInside(tube, point) )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in IsInside() for end-type " << endType
+                  << " at point " << point << std::endl;
+        return EXIT_FAILURE;
+        }
+      numberOfInside += inside;
+      }
+    std::cout << "End-type " << endType << ": " << numberOfInside
+              << " of 20000 points inside" << std::endl;
+    TEST_EXPECT_TRUE(numberOfInside > 2000 && numberOfInside < 18000);
+    }
+
+  // Halfway between two points of a round-ended tube, the later point
+  // decides, whichever part of the tree it is in
+  TubeType::Pointer roundTube = TubeType::New();
+  TubeType::PointListType roundPoints;
+  for ( unsigned int i = 0; i < 64; ++i )
+    {
+    TubeType::TubePointType point;
+    point.SetPosition(2.0 * i, 0.0, 0.0);
+    point.SetRadius(( i % 2 ) ? 1.2 : 0.8);
+    roundPoints.push_back(point);
+    }
+  roundTube->SetPoints(roundPoints);
+  roundTube->SetEndType(1);
+  for ( unsigned int i = 0; i + 1 < 64; ++i )
+    {
+    TubeType::PointType point;
+    point[0] = 2.0 * i + 1.0;
+    point[1] = 0.5;
+    point[2] = 0.0;
+    // At distance 1.118 of both points, inside only the larger one
+    TEST_EXPECT_EQUAL(roundTube->IsInside(point), ( i % 2 ) == 0);
+    }
+
+  // Moving a point through SetPoint() rebuilds the search tree
+  TubeType::Pointer tube = MakeRandomTube(generator, 50, 0, 0.7);
+  TubeType::PointType farPoint;
+  farPoint.Fill(100.0);
+  TEST_EXPECT_TRUE(!tube->IsInside(farPoint));
+  TubeType::TubePointType tubePoint = tube->GetPoints().back();
+  tubePoint.SetPosition(farPoint);
+  tube->SetPoint(tube->GetNumberOfPoints() - 1, tubePoint);
+  TEST_EXPECT_TRUE(tube->IsInside(farPoint));
+
+  // A vessel tree: branches attached to a root tube and to each other, one
+  // of them moved by its own transform
+  using GroupType = itk::GroupSpatialObject< 3 >;
+  GroupType::Pointer group = GroupType::New();
+  TubeType::Pointer root = MakeRandomTube(generator, 300, 0, 0.8);
+  group->AddSpatialObject(root);
+  TubeType::Pointer parent = root;
+  for ( unsigned int i = 0; i < 6; ++i )
+    {
+    TubeType::Pointer branch = MakeRandomTube(generator, 200, i % 2, 0.8);
+    parent->AddSpatialObject(branch);
+    if ( i == 3 )
+      {
+      TubeType::TransformType::OutputVectorType offset;
+      offset[0] = 2.5;
+      offset[1] = -1.0;
+      offset[2] = 0.5;
+      branch->GetObjectToParentTransform()->SetOffset(offset);
+      branch->ComputeObjectToWorldTransform();
+      }
+    parent = ( i % 2 ) ? branch : root;
+    }
+
+  using ImageType = itk::Image< unsigned char, 3 >;
+  using FilterType = itk::SpatialObjectToImageFilter< GroupType, ImageType >;
+
+  ImageType::SizeType size;
+  size.Fill(48);
+  double spacing[3] = { 0.75, 0.75, 0.75 };
+  double origin[3] = { -18.0, -18.0, -18.0 };
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(group);
+  filter->SetSize(size);
+  filter->SetSpacing(spacing);
+  filter->SetOrigin(origin);
+  filter->SetInsideValue(255);
+  filter->SetOutsideValue(0);
+  filter->SetNumberOfThreads(4);
+  TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+  // Every voxel must match a direct query of the hierarchy
+  const ImageType * image = filter->GetOutput();
+  TEST_EXPECT_EQUAL(image->GetLargestPossibleRegion().GetSize(), size);
+  unsigned int numberOfInside = 0;
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it(image, image->GetLargestPossibleRegion());
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    double value;
+    const unsigned char expected =
+      group->ValueAt(point, value, filter->GetChildrenDepth()) ? 255 : 0;
+    if ( it.Get() != expected )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the rasterization at index " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    numberOfInside += ( expected != 0 );
+    }
+  std::cout << numberOfInside << " voxels inside the vessel tree" << std::endl;
+  TEST_EXPECT_TRUE(numberOfInside > 0);
+
+  // The number of threads does not change the output
+  FilterType::Pointer serialFilter = FilterType::New();
+  serialFilter->SetInput(group);
+  serialFilter->SetSize(size);
+  serialFilter->SetSpacing(spacing);
+  serialFilter->SetOrigin(origin);
+  serialFilter->SetInsideValue(255);
+  serialFilter->SetOutsideValue(0);
+  serialFilter->SetNumberOfThreads(1);
+  TRY_EXPECT_NO_EXCEPTION(serialFilter->Update());
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > serialIt(serialFilter->GetOutput(),
+    serialFilter->GetOutput()->GetLargestPossibleRegion());
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++serialIt )
+    {
+    if ( it.Get() != serialIt.Get() )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Output depends on the number of threads at index "
+                << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A smaller output after the first update
+  size.Fill(20);
+  filter->SetSize(size);
+  TRY_EXPECT_NO_EXCEPTION(filter->Update());
+  TEST_EXPECT_EQUAL(filter->GetOutput()->GetBufferedRegion().GetSize(), size);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
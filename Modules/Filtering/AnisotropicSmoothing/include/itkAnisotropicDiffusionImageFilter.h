@@ -99,6 +99,7 @@ public:
    * Inherited from the superclass. */
   using PixelType = typename Superclass::PixelType;
   using TimeStepType = typename Superclass::TimeStepType;
+  using ThreadRegionType = typename Superclass::ThreadRegionType;
 
   /** Set/Get the time step for each iteration */
   itkSetMacro(TimeStep, TimeStepType);
@@ -147,6 +148,17 @@ protected:
   /** Prepare for the iteration process. */
   void InitializeIteration() override;
 
+  /** Compute the change over the region of a thread with the
+   * ComputeUpdateInRegion() method of a difference function of type
+   * TFunction, which computes the flux through each face between two
+   * pixels once.  The per-pixel evaluation of the superclass is used
+   * instead when \a useSharedFaceFluxes is false or when the difference
+   * function is not a TFunction. */
+  template< typename TFunction >
+  TimeStepType ThreadedCalculateChangeWithSharedFaceFluxes(const ThreadRegionType & regionToProcess,
+                                                           ThreadIdType threadId,
+                                                           bool useSharedFaceFluxes);
+
   bool m_GradientMagnitudeIsFixed;
 
 private:
@@ -107,6 +107,28 @@ AnisotropicDiffusionImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+template< typename TFunction >
+typename AnisotropicDiffusionImageFilter< TInputImage, TOutputImage >::TimeStepType
+AnisotropicDiffusionImageFilter< TInputImage, TOutputImage >
+::ThreadedCalculateChangeWithSharedFaceFluxes(const ThreadRegionType & regionToProcess,
+                                              ThreadIdType threadId,
+                                              bool useSharedFaceFluxes)
+{
+  const auto * df = dynamic_cast< const TFunction * >( this->GetDifferenceFunction().GetPointer() );
+  if ( !useSharedFaceFluxes || df == nullptr )
+    {
+    return Superclass::ThreadedCalculateChange(regionToProcess, threadId);
+    }
+
+  df->ComputeUpdateInRegion( this->GetOutput(), regionToProcess, this->GetUpdateBuffer() );
+
+  void *             globalData = df->GetGlobalDataPointer();
+  const TimeStepType timeStep = df->ComputeGlobalTimeStep(globalData);
+  df->ReleaseGlobalDataPointer(globalData);
+  return timeStep;
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 AnisotropicDiffusionImageFilter< TInputImage, TOutputImage >
@@ -48,6 +48,17 @@ namespace itk
  * 2D image, this means valid time steps are below 0.1250.  For a 3D image,
  * valid time steps are below 0.0625.
  *
+ * \par Performance
+ * By default the change at each iteration is computed with
+ * CurvatureNDAnisotropicDiffusionFunction::ComputeUpdateInRegion(), which
+ * processes each thread's region in tiles. It computes the centralized
+ * derivatives of each pixel once, and the normalized flux through every
+ * face between two pixels once instead of once from each side, and gives the
+ * same result as the per-pixel neighborhood evaluation. Set
+ * UseSharedFaceFluxes to false to use the per-pixel evaluation. It is also
+ * used when the difference function has been replaced by one that is not a
+ * CurvatureNDAnisotropicDiffusionFunction.
+ *
  * \sa AnisotropicDiffusionImageFilter
  * \sa AnisotropicDiffusionFunction
  * \sa CurvatureNDAnisotropicDiffusionFunction
@@ -77,6 +88,7 @@ public:
 
   /** Extract superclass information. */
   using UpdateBufferType = typename Superclass::UpdateBufferType;
+  using TimeStepType = typename Superclass::TimeStepType;
 
   /** Extract superclass image dimension. */
   static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
@@ -88,8 +100,15 @@ public:
   // End concept checking
 #endif
 
+  /** Set/Get whether the flux through each face between two pixels is
+   * computed once and shared by both pixels. On by default. */
+  itkSetMacro(UseSharedFaceFluxes, bool);
+  itkGetConstMacro(UseSharedFaceFluxes, bool);
+  itkBooleanMacro(UseSharedFaceFluxes);
+
 protected:
-  CurvatureAnisotropicDiffusionImageFilter()
+  CurvatureAnisotropicDiffusionImageFilter() :
+    m_UseSharedFaceFluxes(true)
   {
     typename CurvatureNDAnisotropicDiffusionFunction< UpdateBufferType >::Pointer q =
       CurvatureNDAnisotropicDiffusionFunction< UpdateBufferType >::New();
@@ -107,6 +126,26 @@ protected:
         << "Anisotropic diffusion is using a time step which may introduce instability into the solution.");
       }
   }
+
+  using ThreadRegionType = typename Superclass::ThreadRegionType;
+
+  /** Compute the change over the region of a thread with
+   * CurvatureNDAnisotropicDiffusionFunction::ComputeUpdateInRegion(). */
+  TimeStepType ThreadedCalculateChange(const ThreadRegionType & regionToProcess,
+                                       ThreadIdType threadId) override
+  {
+    return this->template ThreadedCalculateChangeWithSharedFaceFluxes<
+      CurvatureNDAnisotropicDiffusionFunction< UpdateBufferType > >(regionToProcess, threadId, m_UseSharedFaceFluxes);
+  }
+
+  void PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "UseSharedFaceFluxes: " << m_UseSharedFaceFluxes << std::endl;
+  }
+
+private:
+  bool m_UseSharedFaceFluxes;
 };
 } // end namspace itk
 
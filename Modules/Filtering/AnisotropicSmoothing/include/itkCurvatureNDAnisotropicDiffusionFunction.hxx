@@ -18,7 +18,9 @@
 #ifndef itkCurvatureNDAnisotropicDiffusionFunction_hxx
 #define itkCurvatureNDAnisotropicDiffusionFunction_hxx
 
+#include "itkNumericTraits.h"
 #include "itkCurvatureNDAnisotropicDiffusionFunction.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -167,6 +169,230 @@ CurvatureNDAnisotropicDiffusionFunction< TImage >
     }
   return static_cast< PixelType >( std::sqrt(propagation_gradient) * speed );
 }
+
+template< typename TImage >
+void
+CurvatureNDAnisotropicDiffusionFunction< TImage >
+::ComputeUpdateInRegion(const ImageType *image,
+                        const typename ImageType::RegionType & region,
+                        ImageType *update) const
+{
+  using IndexType = typename ImageType::IndexType;
+  using PixelRealType = typename NumericTraits< PixelType >::RealType;
+  using AccumulateRealType = typename NumericTraits< PixelRealType >::AccumulateType;
+  using OperatorValueType = typename NumericTraits< PixelType >::ValueType;
+
+  unsigned int  i, j, d;
+  SizeValueType n;
+
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  PixelType * const             updateBuffer = update->GetBufferPointer();
+  const OffsetValueType * const updateOffsetTable = update->GetOffsetTable();
+
+  SizeValueType       numberOfTiles[ImageDimension];
+  const SizeValueType totalNumberOfTiles = this->SplitRegionIntoTiles(region, numberOfTiles);
+
+  std::vector< PixelType > values;
+  std::vector< double >    derivatives[ImageDimension];
+  std::vector< double >    fluxes[ImageDimension];
+
+  IndexType       tileIndex;
+  SizeValueType   position[ImageDimension];
+  SizeValueType   tileSize[ImageDimension];
+  OffsetValueType valueStride[ImageDimension];
+  SizeValueType   derivativeSize[ImageDimension];
+  OffsetValueType derivativeStride[ImageDimension];
+  SizeValueType   fluxSize[ImageDimension][ImageDimension];
+  OffsetValueType fluxStride[ImageDimension][ImageDimension];
+
+  for ( SizeValueType tile = 0; tile < totalNumberOfTiles; ++tile )
+    {
+    this->GetTile(region, numberOfTiles, tile, tileIndex, tileSize);
+    this->GetPaddedTileValues(image, tileIndex, tileSize, values, valueStride);
+
+    // Centralized derivatives of the tile padded by one pixel, accumulated
+    // in the same order and precision as m_InnerProduct.
+    SizeValueType numberOfDerivatives = 1;
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      derivativeSize[d] = tileSize[d] + 2;
+      derivativeStride[d] = numberOfDerivatives;
+      numberOfDerivatives *= derivativeSize[d];
+      position[d] = 0;
+      }
+    for ( j = 0; j < ImageDimension; ++j )
+      {
+      derivatives[j].resize( numberOfDerivatives );
+      }
+
+    for ( n = 0; n < numberOfDerivatives; ++n )
+      {
+      OffsetValueType v = 0;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        v += static_cast< OffsetValueType >( position[d] + 1 ) * valueStride[d];
+        }
+      for ( j = 0; j < ImageDimension; ++j )
+        {
+        AccumulateRealType sum = NumericTraits< AccumulateRealType >::ZeroValue();
+        for ( unsigned int k = 0; k < 3; ++k )
+          {
+          sum += static_cast< AccumulateRealType >(
+            static_cast< OperatorValueType >( m_DerivativeOperator[k] )
+            * static_cast< PixelRealType >( values[v + ( static_cast< OffsetValueType >( k ) - 1 ) * valueStride[j]] ) );
+          }
+        double dx = static_cast< PixelType >( sum );
+        dx *= this->m_ScaleCoefficients[j];
+        derivatives[j][n] = dx;
+        }
+
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        if ( ++position[d] < derivativeSize[d] )
+          {
+          break;
+          }
+        position[d] = 0;
+        }
+      }
+
+    // First order normalized finite-difference conductance product through
+    // the face between each pixel and its neighbor in the i direction. The
+    // tile is extended by one pixel backwards along i so that the pixels on
+    // its lower side have both of their faces.
+    for ( i = 0; i < ImageDimension; ++i )
+      {
+      SizeValueType numberOfFluxes = 1;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        fluxSize[i][d] = tileSize[d] + ( d == i ? 1 : 0 );
+        fluxStride[i][d] = numberOfFluxes;
+        numberOfFluxes *= fluxSize[i][d];
+        position[d] = 0;
+        }
+      fluxes[i].resize( numberOfFluxes );
+
+      for ( n = 0; n < numberOfFluxes; ++n )
+        {
+        OffsetValueType v = 0;
+        OffsetValueType r = 0;
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          const OffsetValueType p = static_cast< OffsetValueType >( position[d] ) - ( d == i ? 1 : 0 );
+          v += ( p + 2 ) * valueStride[d];
+          r += ( p + 1 ) * derivativeStride[d];
+          }
+
+        double dx_forward = values[v + valueStride[i]] - values[v];
+        dx_forward *= this->m_ScaleCoefficients[i];
+
+        double grad_mag_sq = dx_forward * dx_forward;
+        for ( j = 0; j < ImageDimension; ++j )
+          {
+          if ( j != i )
+            {
+            const double dx_sum = derivatives[j][r] + derivatives[j][r + derivativeStride[i]];
+            grad_mag_sq += 0.25f * dx_sum * dx_sum;
+            }
+          }
+        const double grad_mag = std::sqrt(m_MIN_NORM + grad_mag_sq);
+
+        double Cx;
+        if ( m_K == 0.0 )
+          {
+          Cx = 0.0;
+          }
+        else
+          {
+          Cx = std::exp(grad_mag_sq / m_K);
+          }
+        fluxes[i][n] = ( dx_forward / grad_mag ) * Cx;
+
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          if ( ++position[d] < fluxSize[i][d] )
+            {
+            break;
+            }
+          position[d] = 0;
+          }
+        }
+      }
+
+    // Second order conductance-modified curvature times the "upwind"
+    // gradient magnitude.
+    SizeValueType numberOfPixels = 1;
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      numberOfPixels *= tileSize[d];
+      position[d] = 0;
+      }
+    const OffsetValueType tileOffset = update->ComputeOffset(tileIndex);
+
+    for ( n = 0; n < numberOfPixels; ++n )
+      {
+      OffsetValueType u = tileOffset;
+      OffsetValueType v = 0;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        u += static_cast< OffsetValueType >( position[d] ) * updateOffsetTable[d];
+        v += static_cast< OffsetValueType >( position[d] + 2 ) * valueStride[d];
+        }
+
+      double dx_forward[ImageDimension];
+      double dx_backward[ImageDimension];
+      double speed = 0.0;
+      for ( i = 0; i < ImageDimension; ++i )
+        {
+        dx_forward[i] = values[v + valueStride[i]] - values[v];
+        dx_forward[i] *= this->m_ScaleCoefficients[i];
+        dx_backward[i] = values[v] - values[v - valueStride[i]];
+        dx_backward[i] *= this->m_ScaleCoefficients[i];
+
+        OffsetValueType f = 0;
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          f += static_cast< OffsetValueType >( position[d] + ( d == i ? 1 : 0 ) ) * fluxStride[i][d];
+          }
+        speed += ( fluxes[i][f] - fluxes[i][f - fluxStride[i][i]] );
+        }
+
+      double propagation_gradient = 0.0;
+      if ( speed > 0 )
+        {
+        for ( i = 0; i < ImageDimension; ++i )
+          {
+          propagation_gradient +=
+            itk::Math::sqr( std::min(dx_backward[i], 0.0) )
+            + itk::Math::sqr( std::max(dx_forward[i],  0.0) );
+          }
+        }
+      else
+        {
+        for ( i = 0; i < ImageDimension; ++i )
+          {
+          propagation_gradient +=
+            itk::Math::sqr( std::max(dx_backward[i], 0.0) )
+            + itk::Math::sqr( std::min(dx_forward[i],  0.0) );
+          }
+        }
+      updateBuffer[u] = static_cast< PixelType >( std::sqrt(propagation_gradient) * speed );
+
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        if ( ++position[d] < tileSize[d] )
+          {
+          break;
+          }
+        position[d] = 0;
+        }
+      }
+    }
+}
 } // end namespace itk
 
 #endif
@@ -39,6 +39,17 @@ namespace itk
  * Please see the description of parameters given in
  * itkAnisotropicDiffusionImageFilter.
  *
+ * \par Performance
+ * By default the change at each iteration is computed with
+ * GradientNDAnisotropicDiffusionFunction::ComputeUpdateInRegion(), which
+ * processes each thread's region in tiles and computes the flux through
+ * every face between two pixels once instead of once from each side. This
+ * halves the number of conductance evaluations and gives the same result as
+ * the per-pixel neighborhood evaluation. Set UseSharedFaceFluxes to false to
+ * use the per-pixel evaluation. It is also used when the difference
+ * function has been replaced by one that is not a
+ * GradientNDAnisotropicDiffusionFunction.
+ *
  * \sa AnisotropicDiffusionImageFilter
  * \sa AnisotropicDiffusionFunction
  * \sa GradientAnisotropicDiffusionFunction
@@ -69,6 +80,7 @@ public:
 
   /** Extract information from the superclass. */
   using UpdateBufferType = typename Superclass::UpdateBufferType;
+  using TimeStepType = typename Superclass::TimeStepType;
 
   /** Extract information from the superclass. */
   static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
@@ -80,8 +92,15 @@ public:
   // End concept checking
 #endif
 
+  /** Set/Get whether the flux through each face between two pixels is
+   * computed once and shared by both pixels. On by default. */
+  itkSetMacro(UseSharedFaceFluxes, bool);
+  itkGetConstMacro(UseSharedFaceFluxes, bool);
+  itkBooleanMacro(UseSharedFaceFluxes);
+
 protected:
-  GradientAnisotropicDiffusionImageFilter()
+  GradientAnisotropicDiffusionImageFilter() :
+    m_UseSharedFaceFluxes(true)
   {
     typename GradientNDAnisotropicDiffusionFunction< UpdateBufferType >::Pointer p =
       GradientNDAnisotropicDiffusionFunction< UpdateBufferType >::New();
@@ -89,6 +108,26 @@ protected:
   }
 
   ~GradientAnisotropicDiffusionImageFilter() override {}
+
+  using ThreadRegionType = typename Superclass::ThreadRegionType;
+
+  /** Compute the change over the region of a thread with
+   * GradientNDAnisotropicDiffusionFunction::ComputeUpdateInRegion(). */
+  TimeStepType ThreadedCalculateChange(const ThreadRegionType & regionToProcess,
+                                       ThreadIdType threadId) override
+  {
+    return this->template ThreadedCalculateChangeWithSharedFaceFluxes<
+      GradientNDAnisotropicDiffusionFunction< UpdateBufferType > >(regionToProcess, threadId, m_UseSharedFaceFluxes);
+  }
+
+  void PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "UseSharedFaceFluxes: " << m_UseSharedFaceFluxes << std::endl;
+  }
+
+private:
+  bool m_UseSharedFaceFluxes;
 };
 } // end namspace itk
 
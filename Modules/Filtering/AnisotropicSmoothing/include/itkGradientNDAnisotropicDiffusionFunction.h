@@ -22,6 +22,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkDerivativeOperator.h"
+#include <vector>
 
 namespace itk
 {
@@ -104,6 +105,17 @@ public:
                                     * this->GetConductanceParameter() * this->GetConductanceParameter() * -2.0f );
   }
 
+  /** Compute the update of every pixel of a region of the image at once.
+   * The values written to the update image are those ComputeUpdate() returns
+   * for a neighborhood with a zero flux Neumann boundary condition. The
+   * region is processed in small tiles, and the conductance-weighted flux
+   * through the face between two neighboring pixels is computed once and
+   * used by both pixels, instead of once from each side. Both images must
+   * have the same buffered region, and the region must lie within it. */
+  void ComputeUpdateInRegion(const ImageType *image,
+                             const typename ImageType::RegionType & region,
+                             ImageType *update) const;
+
 protected:
   GradientNDAnisotropicDiffusionFunction();
   ~GradientNDAnisotropicDiffusionFunction() override {}
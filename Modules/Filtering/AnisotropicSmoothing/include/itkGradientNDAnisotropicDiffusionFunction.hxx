@@ -20,6 +20,7 @@
 
 #include "itkNumericTraits.h"
 #include "itkGradientNDAnisotropicDiffusionFunction.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -159,6 +160,186 @@ GradientNDAnisotropicDiffusionFunction< TImage >
 
   return static_cast< PixelType >( delta );
 }
+
+template< typename TImage >
+void
+GradientNDAnisotropicDiffusionFunction< TImage >
+::ComputeUpdateInRegion(const ImageType *image,
+                        const typename ImageType::RegionType & region,
+                        ImageType *update) const
+{
+  using IndexType = typename ImageType::IndexType;
+
+  unsigned int i, j, d;
+  SizeValueType n;
+
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  PixelType * const             updateBuffer = update->GetBufferPointer();
+  const OffsetValueType * const updateOffsetTable = update->GetOffsetTable();
+
+  SizeValueType       numberOfTiles[ImageDimension];
+  const SizeValueType totalNumberOfTiles = this->SplitRegionIntoTiles(region, numberOfTiles);
+
+  std::vector< PixelType >     values;
+  std::vector< PixelRealType > derivatives[ImageDimension];
+  std::vector< PixelRealType > fluxes[ImageDimension];
+
+  IndexType       tileIndex;
+  SizeValueType   position[ImageDimension];
+  SizeValueType   tileSize[ImageDimension];
+  OffsetValueType valueStride[ImageDimension];
+  SizeValueType   derivativeSize[ImageDimension];
+  OffsetValueType derivativeStride[ImageDimension];
+  SizeValueType   fluxSize[ImageDimension][ImageDimension];
+  OffsetValueType fluxStride[ImageDimension][ImageDimension];
+
+  for ( SizeValueType tile = 0; tile < totalNumberOfTiles; ++tile )
+    {
+    this->GetTile(region, numberOfTiles, tile, tileIndex, tileSize);
+    this->GetPaddedTileValues(image, tileIndex, tileSize, values, valueStride);
+
+    // Centralized derivatives of the tile padded by one pixel.
+    SizeValueType numberOfDerivatives = 1;
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      derivativeSize[d] = tileSize[d] + 2;
+      derivativeStride[d] = numberOfDerivatives;
+      numberOfDerivatives *= derivativeSize[d];
+      position[d] = 0;
+      }
+    for ( j = 0; j < ImageDimension; ++j )
+      {
+      derivatives[j].resize( numberOfDerivatives );
+      }
+
+    for ( n = 0; n < numberOfDerivatives; ++n )
+      {
+      OffsetValueType v = 0;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        v += static_cast< OffsetValueType >( position[d] + 1 ) * valueStride[d];
+        }
+      for ( j = 0; j < ImageDimension; ++j )
+        {
+        PixelRealType dx = ( values[v + valueStride[j]] - values[v - valueStride[j]] ) / 2.0f;
+        dx *= this->m_ScaleCoefficients[j];
+        derivatives[j][n] = dx;
+        }
+
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        if ( ++position[d] < derivativeSize[d] )
+          {
+          break;
+          }
+        position[d] = 0;
+        }
+      }
+
+    // Conductance modified flux through the face between each pixel and its
+    // neighbor in the i direction. The tile is extended by one pixel backwards
+    // along i so that the pixels on its lower side have both of their faces.
+    for ( i = 0; i < ImageDimension; ++i )
+      {
+      SizeValueType numberOfFluxes = 1;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        fluxSize[i][d] = tileSize[d] + ( d == i ? 1 : 0 );
+        fluxStride[i][d] = numberOfFluxes;
+        numberOfFluxes *= fluxSize[i][d];
+        position[d] = 0;
+        }
+      fluxes[i].resize( numberOfFluxes );
+
+      for ( n = 0; n < numberOfFluxes; ++n )
+        {
+        OffsetValueType v = 0;
+        OffsetValueType r = 0;
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          const OffsetValueType p = static_cast< OffsetValueType >( position[d] ) - ( d == i ? 1 : 0 );
+          v += ( p + 2 ) * valueStride[d];
+          r += ( p + 1 ) * derivativeStride[d];
+          }
+
+        PixelRealType dx_forward = values[v + valueStride[i]] - values[v];
+        dx_forward *= this->m_ScaleCoefficients[i];
+
+        double accum = 0.0;
+        for ( j = 0; j < ImageDimension; ++j )
+          {
+          if ( j != i )
+            {
+            accum += 0.25f * itk::Math::sqr( derivatives[j][r] + derivatives[j][r + derivativeStride[i]] );
+            }
+          }
+
+        double Cx;
+        if ( m_K == 0.0 )
+          {
+          Cx = 0.0;
+          }
+        else
+          {
+          Cx = std::exp( ( itk::Math::sqr(dx_forward) + accum ) / m_K );
+          }
+        fluxes[i][n] = dx_forward * Cx;
+
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          if ( ++position[d] < fluxSize[i][d] )
+            {
+            break;
+            }
+          position[d] = 0;
+          }
+        }
+      }
+
+    // Conductance modified second order derivative.
+    SizeValueType numberOfPixels = 1;
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      numberOfPixels *= tileSize[d];
+      position[d] = 0;
+      }
+    const OffsetValueType tileOffset = update->ComputeOffset(tileIndex);
+
+    for ( n = 0; n < numberOfPixels; ++n )
+      {
+      OffsetValueType u = tileOffset;
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        u += static_cast< OffsetValueType >( position[d] ) * updateOffsetTable[d];
+        }
+
+      PixelRealType delta = NumericTraits< PixelRealType >::ZeroValue();
+      for ( i = 0; i < ImageDimension; ++i )
+        {
+        OffsetValueType f = 0;
+        for ( d = 0; d < ImageDimension; ++d )
+          {
+          f += static_cast< OffsetValueType >( position[d] + ( d == i ? 1 : 0 ) ) * fluxStride[i][d];
+          }
+        delta += fluxes[i][f] - fluxes[i][f - fluxStride[i][i]];
+        }
+      updateBuffer[u] = static_cast< PixelType >( delta );
+
+      for ( d = 0; d < ImageDimension; ++d )
+        {
+        if ( ++position[d] < tileSize[d] )
+          {
+          break;
+          }
+        position[d] = 0;
+        }
+      }
+    }
+}
 } // end namespace itk
 
 #endif
@@ -19,6 +19,7 @@
 #define itkScalarAnisotropicDiffusionFunction_h
 
 #include "itkAnisotropicDiffusionFunction.h"
+#include <vector>
 
 namespace itk
 {
@@ -70,6 +71,32 @@ public:
 protected:
   ScalarAnisotropicDiffusionFunction() {}
   ~ScalarAnisotropicDiffusionFunction() override {}
+
+  using IndexType = typename ImageType::IndexType;
+  using RegionType = typename ImageType::RegionType;
+
+  /** Split a region into tiles small enough for the values, derivatives and
+   * face fluxes of one tile to stay in cache. Returns the total number of
+   * tiles and fills the number of tiles along each dimension. */
+  static SizeValueType SplitRegionIntoTiles(const RegionType & region,
+                                            SizeValueType numberOfTiles[]);
+
+  /** Get the start index and the size of one of the tiles of a region. */
+  static void GetTile(const RegionType & region,
+                      const SizeValueType numberOfTiles[],
+                      SizeValueType tile,
+                      IndexType & tileIndex,
+                      SizeValueType tileSize[]);
+
+  /** Copy the pixel values of a tile padded by two pixels on every side into
+   * a contiguous buffer, and fill its strides. Outside of the buffered region
+   * of the image the indices are clamped, as in
+   * ZeroFluxNeumannBoundaryCondition. */
+  static void GetPaddedTileValues(const ImageType *image,
+                                  const IndexType & tileIndex,
+                                  const SizeValueType tileSize[],
+                                  std::vector< PixelType > & values,
+                                  OffsetValueType valueStride[]);
 };
 } // end namespace itk
 
@@ -23,6 +23,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkDerivativeOperator.h"
 #include "itkScalarAnisotropicDiffusionFunction.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -129,6 +130,104 @@ ScalarAnisotropicDiffusionFunction< TImage >
 
   this->SetAverageGradientMagnitudeSquared( (double)( accumulator / counter ) );
 }
+
+template< typename TImage >
+SizeValueType
+ScalarAnisotropicDiffusionFunction< TImage >
+::SplitRegionIntoTiles(const RegionType & region, SizeValueType numberOfTiles[])
+{
+  const SizeValueType tileEdge = ( ImageDimension == 1 ) ? 4096 :
+                                 ( ImageDimension == 2 ) ? 64 :
+                                 ( ImageDimension == 3 ) ? 16 : 8;
+
+  SizeValueType totalNumberOfTiles = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    numberOfTiles[d] = ( region.GetSize(d) + tileEdge - 1 ) / tileEdge;
+    totalNumberOfTiles *= numberOfTiles[d];
+    }
+  return totalNumberOfTiles;
+}
+
+template< typename TImage >
+void
+ScalarAnisotropicDiffusionFunction< TImage >
+::GetTile(const RegionType & region,
+          const SizeValueType numberOfTiles[],
+          SizeValueType tile,
+          IndexType & tileIndex,
+          SizeValueType tileSize[])
+{
+  SizeValueType remainder = tile;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    // The tiles along a dimension differ in size by at most one pixel.
+    const SizeValueType tilePosition = remainder % numberOfTiles[d];
+    remainder /= numberOfTiles[d];
+    const SizeValueType begin = tilePosition * region.GetSize(d) / numberOfTiles[d];
+    const SizeValueType end = ( tilePosition + 1 ) * region.GetSize(d) / numberOfTiles[d];
+    tileIndex[d] = region.GetIndex(d) + static_cast< IndexValueType >( begin );
+    tileSize[d] = end - begin;
+    }
+}
+
+template< typename TImage >
+void
+ScalarAnisotropicDiffusionFunction< TImage >
+::GetPaddedTileValues(const ImageType *image,
+                      const IndexType & tileIndex,
+                      const SizeValueType tileSize[],
+                      std::vector< PixelType > & values,
+                      OffsetValueType valueStride[])
+{
+  const RegionType &            bufferedRegion = image->GetBufferedRegion();
+  const PixelType * const       inputBuffer = image->GetBufferPointer();
+  const OffsetValueType * const inputOffsetTable = image->GetOffsetTable();
+
+  unsigned int                   d;
+  SizeValueType                  n;
+  SizeValueType                  position[ImageDimension];
+  SizeValueType                  valueSize[ImageDimension];
+  std::vector< OffsetValueType > clampedOffsets[ImageDimension];
+
+  SizeValueType numberOfValues = 1;
+  for ( d = 0; d < ImageDimension; ++d )
+    {
+    valueSize[d] = tileSize[d] + 4;
+    valueStride[d] = numberOfValues;
+    numberOfValues *= valueSize[d];
+
+    const IndexValueType low = bufferedRegion.GetIndex(d);
+    const IndexValueType high = low + static_cast< IndexValueType >( bufferedRegion.GetSize(d) ) - 1;
+    clampedOffsets[d].resize( valueSize[d] );
+    for ( n = 0; n < valueSize[d]; ++n )
+      {
+      const IndexValueType coordinate = std::min( high, std::max( low, tileIndex[d] - 2 + static_cast< IndexValueType >( n ) ) );
+      clampedOffsets[d][n] = ( coordinate - low ) * inputOffsetTable[d];
+      }
+    position[d] = 0;
+    }
+
+  values.resize( numberOfValues );
+  for ( n = 0; n < numberOfValues; ++n )
+    {
+    OffsetValueType offset = 0;
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      offset += clampedOffsets[d][position[d]];
+      }
+    values[n] = inputBuffer[offset];
+
+    for ( d = 0; d < ImageDimension; ++d )
+      {
+      if ( ++position[d] < valueSize[d] )
+        {
+        break;
+        }
+      position[d] = 0;
+      }
+    }
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCurvatureAnisotropicDiffusionImageFilter.h"
+#include "itkGradientAnisotropicDiffusionImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+/** Smooth a noisy image with and without shared face fluxes and check that
+ * both evaluations give the same result. */
+template< template< typename, typename > class TFilter, typename TImage >
+int TestSharedFaceFluxes( const typename TImage::SizeType & size, bool useImageSpacing )
+{
+  using ImageType = TImage;
+  using PixelType = typename ImageType::PixelType;
+  using FilterType = TFilter< ImageType, ImageType >;
+
+  typename ImageType::Pointer input = ImageType::New();
+  input->SetRegions( size );
+  typename ImageType::SpacingType spacing;
+  for( unsigned int d = 0; d < ImageType::ImageDimension; ++d )
+    {
+    spacing[d] = 1.0 + 0.25 * d;
+    }
+  input->SetSpacing( spacing );
+  input->Allocate();
+
+  // A step edge with noise.
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+  itk::ImageRegionIterator< ImageType > it( input, input->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const double edge = ( it.GetIndex()[0] < static_cast< itk::IndexValueType >( size[0] / 2 ) ) ? 0.0 : 100.0;
+    it.Set( static_cast< PixelType >( edge + generator->GetNormalVariate( 0.0, 25.0 ) ) );
+    }
+
+  typename FilterType::Pointer sharedFilter = FilterType::New();
+  typename FilterType::Pointer perPixelFilter = FilterType::New();
+
+  TEST_EXPECT_TRUE( sharedFilter->GetUseSharedFaceFluxes() );
+  perPixelFilter->UseSharedFaceFluxesOff();
+  TEST_EXPECT_TRUE( !perPixelFilter->GetUseSharedFaceFluxes() );
+
+  itk::TimeProbe sharedProbe;
+  itk::TimeProbe perPixelProbe;
+  FilterType * filters[2] = { sharedFilter.GetPointer(), perPixelFilter.GetPointer() };
+  itk::TimeProbe * probes[2] = { &sharedProbe, &perPixelProbe };
+  for( unsigned int ii = 0; ii < 2; ++ii )
+    {
+    filters[ii]->SetInput( input );
+    filters[ii]->SetNumberOfIterations( 5 );
+    filters[ii]->SetConductanceParameter( 1.5 );
+    filters[ii]->SetTimeStep( ImageType::ImageDimension == 2 ? 0.125 : 0.0625 );
+    filters[ii]->SetUseImageSpacing( useImageSpacing );
+    filters[ii]->SetNumberOfThreads( 3 );
+    probes[ii]->Start();
+    TRY_EXPECT_NO_EXCEPTION( filters[ii]->Update() );
+    probes[ii]->Stop();
+    }
+
+  std::cout << "  Shared face fluxes: " << sharedProbe.GetMean() << " s, per-pixel: "
+            << perPixelProbe.GetMean() << " s" << std::endl;
+
+  // Both evaluations compute the same fluxes; only the contraction of
+  // floating point operations by the compiler may differ.
+  const double tolerance = 1e-4;
+  itk::ImageRegionConstIterator< ImageType > sharedIt( sharedFilter->GetOutput(),
+    sharedFilter->GetOutput()->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > perPixelIt( perPixelFilter->GetOutput(),
+    perPixelFilter->GetOutput()->GetLargestPossibleRegion() );
+  for( ; !sharedIt.IsAtEnd(); ++sharedIt, ++perPixelIt )
+    {
+    if( itk::Math::abs( static_cast< double >( sharedIt.Get() ) - perPixelIt.Get() ) > tolerance )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Shared face flux output differs from per-pixel output at " << sharedIt.GetIndex()
+                << ": " << sharedIt.Get() << " vs. " << perPixelIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+template< template< typename, typename > class TFilter >
+int TestSharedFaceFluxesForFilter()
+{
+  int testStatus = EXIT_SUCCESS;
+
+  // Sizes that are not multiples of the tile edge.
+  itk::Image< float, 2 >::SizeType size2D;
+  size2D[0] = 131;
+  size2D[1] = 97;
+  std::cout << " 2D float" << std::endl;
+  if( TestSharedFaceFluxes< TFilter, itk::Image< float, 2 > >( size2D, false ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+  std::cout << " 2D double, image spacing" << std::endl;
+  if( TestSharedFaceFluxes< TFilter, itk::Image< double, 2 > >( size2D, true ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+
+  itk::Image< float, 3 >::SizeType size3D;
+  size3D[0] = 37;
+  size3D[1] = 20;
+  size3D[2] = 18;
+  std::cout << " 3D float, image spacing" << std::endl;
+  if( TestSharedFaceFluxes< TFilter, itk::Image< float, 3 > >( size3D, true ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+
+  return testStatus;
+}
+}
+
+int itkAnisotropicDiffusionSharedFluxTest( int, char* [] )
+{
+  int testStatus = EXIT_SUCCESS;
+
+  using ImageType = itk::Image< float, 2 >;
+
+  using GradientFilterType = itk::GradientAnisotropicDiffusionImageFilter< ImageType, ImageType >;
+  GradientFilterType::Pointer gradientFilter = GradientFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( gradientFilter, GradientAnisotropicDiffusionImageFilter,
+    AnisotropicDiffusionImageFilter );
+
+  using CurvatureFilterType = itk::CurvatureAnisotropicDiffusionImageFilter< ImageType, ImageType >;
+  CurvatureFilterType::Pointer curvatureFilter = CurvatureFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( curvatureFilter, CurvatureAnisotropicDiffusionImageFilter,
+    AnisotropicDiffusionImageFilter );
+
+  std::cout << "GradientAnisotropicDiffusionImageFilter" << std::endl;
+  if( TestSharedFaceFluxesForFilter< itk::GradientAnisotropicDiffusionImageFilter >() != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+
+  std::cout << "CurvatureAnisotropicDiffusionImageFilter" << std::endl;
+  if( TestSharedFaceFluxesForFilter< itk::CurvatureAnisotropicDiffusionImageFilter >() != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
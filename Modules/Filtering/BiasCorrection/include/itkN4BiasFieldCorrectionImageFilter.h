@@ -27,6 +27,14 @@
 
 #include "vnl/vnl_vector.h"
 
+CLANG_PRAGMA_PUSH
+CLANG_SUPPRESS_Wfloat_equal
+#include "vnl/algo/vnl_fft_1d.h"
+CLANG_PRAGMA_POP
+
+#include <memory>
+#include <vector>
+
 namespace itk {
 
 /**
@@ -71,6 +79,13 @@ namespace itk {
  * the corrected input image and spatially smoothing those results with a
  * B-spline scalar field estimate of the bias field.
  *
+ * The voxels used for estimation are the same at every iteration, so the
+ * filter collects them once and, when UseCachedBSplineFitting is on (the
+ * default), fits the residual bias field directly from per-dimension
+ * B-spline basis values that are computed once per fitting level.  The
+ * lattice accumulation is multithreaded with one lattice per thread.  The
+ * FFT used to sharpen the histogram is also reused across iterations.
+ *
  * \author Nicholas J. Tustison
  *
  * Contributed by Nicholas J. Tustison, James C. Gee in the Insight Journal
@@ -342,6 +357,17 @@ public:
    */
   itkGetConstMacro( ConvergenceThreshold, RealType );
 
+  /**
+   * Set/Get whether the residual bias field is fitted with B-spline basis
+   * values cached per fitting level instead of rebuilding a point set for
+   * BSplineScatteredDataPointSetToImageFilter at every iteration.  Both
+   * variants compute the same lattice up to floating point round-off.
+   * Default = true.
+   */
+  itkSetMacro( UseCachedBSplineFitting, bool );
+  itkGetConstMacro( UseCachedBSplineFitting, bool );
+  itkBooleanMacro( UseCachedBSplineFitting );
+
   /**
    * Typically, a reduced size image is used as input to the N4 filter using
    * something like itkShrinkImageFilter.  Since the output is a corrected
@@ -412,6 +438,31 @@ private:
    */
   RealType CalculateConvergenceMeasurement( const RealImageType *, const RealImageType * ) const;
 
+  /**
+   * Collect the buffer offsets, indices and confidence weights of the voxels
+   * that take part in the estimation.
+   */
+  void CollectMaskedVoxels( const RealImageType * );
+
+  /**
+   * Compute, for each dimension, the first control point and the B-spline
+   * basis values of every voxel coordinate for the given lattice size.
+   */
+  void ComputeBSplineBasisCache( const RealImageType *, const ArrayType & );
+
+  /**
+   * Fit a control point lattice to the masked voxels of the field estimate
+   * using the cached basis values.  Equivalent to a single level of
+   * BSplineScatteredDataPointSetToImageFilter.
+   */
+  typename BiasFieldControlPointLatticeType::Pointer
+  FitBSplineLattice( const RealImageType *, const ArrayType & );
+
+  /** Accumulate the lattice contributions of a range of masked voxels. */
+  void ThreadedFitBSplineLattice( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  static ITK_THREAD_RETURN_TYPE FitBSplineLatticeThreaderCallback( void *arg );
+
   MaskPixelType m_MaskLabel;
   bool          m_UseMaskLabel;
 
@@ -438,6 +489,24 @@ private:
   ArrayType    m_NumberOfControlPoints;
   ArrayType    m_NumberOfFittingLevels;
 
+  bool m_UseCachedBSplineFitting;
+
+  // Voxels taking part in the estimation, in buffer order
+
+  std::vector<OffsetValueType>                   m_MaskedVoxelOffsets;
+  std::vector<typename RealImageType::IndexType> m_MaskedVoxelIndices;
+  std::vector<RealType>                          m_MaskedVoxelWeights;
+
+  // Per-dimension B-spline basis cache and per-thread fitting lattices
+
+  ArrayType                            m_CachedNumberOfControlPoints;
+  std::vector<unsigned int>            m_BasisSpans[ImageDimension];
+  std::vector<RealType>                m_BasisValues[ImageDimension];
+  const RealType *                     m_FittingFieldBuffer;
+  std::vector< std::vector<RealType> > m_OmegaLatticePerThread;
+  std::vector< std::vector<RealType> > m_DeltaLatticePerThread;
+
+  mutable std::unique_ptr< vnl_fft_1d<double> > m_HistogramFFT;
 };
 
 } // end namespace itk
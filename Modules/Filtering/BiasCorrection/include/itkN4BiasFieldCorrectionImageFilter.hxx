@@ -22,6 +22,8 @@
 
 #include "itkAddImageFilter.h"
 #include "itkBSplineControlPointImageFilter.h"
+#include "itkBSplineKernelFunction.h"
+#include "itkCoxDeBoorBSplineKernelFunction.h"
 #include "itkDivideImageFilter.h"
 #include "itkExpImageFilter.h"
 #include "itkImageRegionIterator.h"
@@ -33,7 +35,6 @@
 
 CLANG_PRAGMA_PUSH
 CLANG_SUPPRESS_Wfloat_equal
-#include "vnl/algo/vnl_fft_1d.h"
 #include "vnl/vnl_complex_traits.h"
 #include "complex"
 CLANG_PRAGMA_POP
@@ -52,7 +53,9 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   m_ConvergenceThreshold( 0.001 ),
   m_CurrentConvergenceMeasurement( NumericTraits<RealType>::ZeroValue() ),
   m_CurrentLevel( 0 ),
-  m_SplineOrder( 3 )
+  m_SplineOrder( 3 ),
+  m_UseCachedBSplineFitting( true ),
+  m_FittingFieldBuffer( nullptr )
 {
   this->SetNumberOfRequiredInputs( 1 );
 
@@ -63,6 +66,8 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 
   this->m_MaximumNumberOfIterations.SetSize( 1 );
   this->m_MaximumNumberOfIterations.Fill( 50 );
+
+  this->m_CachedNumberOfControlPoints.Fill( 0 );
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
@@ -95,26 +100,16 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
     ++outItr;
     }
 
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
-  const MaskPixelType maskLabel = this->GetMaskLabel();
-  const bool useMaskLabel = this->GetUseMaskLabel();
-
-  ImageRegionIteratorWithIndex<RealImageType> It( logInputImage, inputRegion );
+  // The voxels used in the estimation do not change between iterations.
+  this->CollectMaskedVoxels( logInputImage );
+  this->m_CachedNumberOfControlPoints.Fill( 0 );
 
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  RealType * logInputBuffer = logInputImage->GetBufferPointer();
+  for( const OffsetValueType offset : this->m_MaskedVoxelOffsets )
     {
-    if( ( !maskImage
-          || ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel &&  maskImage->GetPixel( It.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
+    if( logInputBuffer[offset] > NumericTraits<typename InputImageType::PixelType>::ZeroValue() )
       {
-      if( It.Get() > NumericTraits<typename InputImageType::PixelType>::ZeroValue() )
-        {
-        It.Set( std::log( static_cast< RealType >( It.Get() ) ) );
-        }
+      logInputBuffer[offset] = std::log( static_cast< RealType >( logInputBuffer[offset] ) );
       }
     }
 
@@ -234,19 +229,66 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   divider->Update();
 
   this->GraftOutput( divider->GetOutput() );
+
+  // Release the caches.
+  std::vector<OffsetValueType>().swap( this->m_MaskedVoxelOffsets );
+  std::vector<typename RealImageType::IndexType>().swap( this->m_MaskedVoxelIndices );
+  std::vector<RealType>().swap( this->m_MaskedVoxelWeights );
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    std::vector<unsigned int>().swap( this->m_BasisSpans[d] );
+    std::vector<RealType>().swap( this->m_BasisValues[d] );
+    }
+  this->m_CachedNumberOfControlPoints.Fill( 0 );
+  this->m_HistogramFFT.reset();
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
-typename
-N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealImagePointer
+void
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
-::SharpenImage( const RealImageType *unsharpenedImage ) const
+::CollectMaskedVoxels( const RealImageType *image )
 {
   const MaskImageType * maskImage = this->GetMaskImage();
   const RealImageType * confidenceImage = this->GetConfidenceImage();
   const MaskPixelType maskLabel = this->GetMaskLabel();
   const bool useMaskLabel = this->GetUseMaskLabel();
 
+  this->m_MaskedVoxelOffsets.clear();
+  this->m_MaskedVoxelIndices.clear();
+  this->m_MaskedVoxelWeights.clear();
+
+  ImageRegionConstIteratorWithIndex<RealImageType> It( image, image->GetBufferedRegion() );
+
+  OffsetValueType offset = 0;
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It, ++offset )
+    {
+    if( ( !maskImage
+          || ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel )
+          || ( !useMaskLabel &&  maskImage->GetPixel( It.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
+          )
+        && ( !confidenceImage ||
+             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
+      {
+      RealType confidenceWeight = 1.0;
+      if( confidenceImage )
+        {
+        confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
+        }
+      this->m_MaskedVoxelOffsets.push_back( offset );
+      this->m_MaskedVoxelIndices.push_back( It.GetIndex() );
+      this->m_MaskedVoxelWeights.push_back( confidenceWeight );
+      }
+    }
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+typename
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealImagePointer
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::SharpenImage( const RealImageType *unsharpenedImage ) const
+{
+  const RealType * unsharpenedBuffer = unsharpenedImage->GetBufferPointer();
+
   // Build the histogram for the uncorrected image.  Store copy
   // in a vnl_vector to utilize vnl FFT routines.  Note that variables
   // in real space are denoted by a single uppercase letter whereas their
@@ -255,27 +297,16 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   RealType binMaximum = NumericTraits<RealType>::NonpositiveMin();
   RealType binMinimum = NumericTraits<RealType>::max();
 
-  ImageRegionConstIterator<RealImageType> ItU(
-    unsharpenedImage, unsharpenedImage->GetLargestPossibleRegion() );
-
-  for( ItU.GoToBegin(); !ItU.IsAtEnd(); ++ItU )
+  for( const OffsetValueType offset : this->m_MaskedVoxelOffsets )
     {
-    if( ( !maskImage ||
-          ( useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
+    RealType pixel = unsharpenedBuffer[offset];
+    if( pixel > binMaximum )
       {
-      RealType pixel = ItU.Get();
-      if( pixel > binMaximum )
-        {
-        binMaximum = pixel;
-        }
-      else if( pixel < binMinimum )
-        {
-        binMinimum = pixel;
-        }
+      binMaximum = pixel;
+      }
+    else if( pixel < binMinimum )
+      {
+      binMinimum = pixel;
       }
     }
   RealType histogramSlope = ( binMaximum - binMinimum ) /
@@ -286,31 +317,23 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 
   vnl_vector<RealType> H( this->m_NumberOfHistogramBins, 0.0 );
 
-  for( ItU.GoToBegin(); !ItU.IsAtEnd(); ++ItU )
+  for( const OffsetValueType voxelOffset : this->m_MaskedVoxelOffsets )
     {
-    if( ( !maskImage ||
-          ( useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
-      {
-      RealType pixel = ItU.Get();
+    RealType pixel = unsharpenedBuffer[voxelOffset];
 
-      RealType cidx = ( static_cast<RealType>( pixel ) - binMinimum ) /
-        histogramSlope;
-      unsigned int idx = itk::Math::floor( cidx );
-      RealType     offset = cidx - static_cast<RealType>( idx );
+    RealType cidx = ( static_cast<RealType>( pixel ) - binMinimum ) /
+      histogramSlope;
+    unsigned int idx = itk::Math::floor( cidx );
+    RealType     offset = cidx - static_cast<RealType>( idx );
 
-      if( offset == 0.0 )
-        {
-        H[idx] += 1.0;
-        }
-      else if( idx < this->m_NumberOfHistogramBins - 1 )
-        {
-        H[idx] += 1.0 - offset;
-        H[idx+1] += offset;
-        }
+    if( offset == 0.0 )
+      {
+      H[idx] += 1.0;
+      }
+    else if( idx < this->m_NumberOfHistogramBins - 1 )
+      {
+      H[idx] += 1.0 - offset;
+      H[idx+1] += offset;
       }
     }
 
@@ -336,9 +359,15 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
     V[n+histogramOffset] = H[n];
     }
 
-  // Instantiate the 1-d vnl fft routine.
+  // Instantiate the 1-d vnl fft routine.  The padded size only depends on
+  // the number of histogram bins so the factorization is reused across
+  // iterations.
 
-  vnl_fft_1d<FFTComputationType> fft( paddedHistogramSize );
+  if( !this->m_HistogramFFT || this->m_HistogramFFT->size() != paddedHistogramSize )
+    {
+    this->m_HistogramFFT.reset( new vnl_fft_1d<FFTComputationType>( paddedHistogramSize ) );
+    }
+  vnl_fft_1d<FFTComputationType> & fft = *this->m_HistogramFFT;
 
   vnl_vector< FFTComplexType > Vf( V );
 
@@ -452,33 +481,24 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   sharpenedImage->SetRegions( inputImage->GetLargestPossibleRegion() );
   sharpenedImage->Allocate( true ); // initialize buffer to zero
 
-  ImageRegionIterator<RealImageType> ItC(
-    sharpenedImage, sharpenedImage->GetLargestPossibleRegion() );
+  RealType * sharpenedBuffer = sharpenedImage->GetBufferPointer();
 
-  for( ItU.GoToBegin(), ItC.GoToBegin(); !ItU.IsAtEnd(); ++ItU, ++ItC )
+  for( const OffsetValueType offset : this->m_MaskedVoxelOffsets )
     {
-    if( ( !maskImage ||
-          ( useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel && maskImage->GetPixel( ItU.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
-      {
-      RealType     cidx = ( ItU.Get() - binMinimum ) / histogramSlope;
-      unsigned int idx = itk::Math::floor( cidx );
+    RealType     cidx = ( unsharpenedBuffer[offset] - binMinimum ) / histogramSlope;
+    unsigned int idx = itk::Math::floor( cidx );
 
-      RealType correctedPixel = 0;
-      if( idx < E.size() - 1 )
-        {
-        correctedPixel = E[idx] + ( E[idx + 1] - E[idx] )
-          * ( cidx - static_cast<RealType>( idx ) );
-        }
-      else
-        {
-        correctedPixel = E[E.size() - 1];
-        }
-      ItC.Set( correctedPixel );
+    RealType correctedPixel = 0;
+    if( idx < E.size() - 1 )
+      {
+      correctedPixel = E[idx] + ( E[idx + 1] - E[idx] )
+        * ( cidx - static_cast<RealType>( idx ) );
+      }
+    else
+      {
+      correctedPixel = E[E.size() - 1];
       }
+    sharpenedBuffer[offset] = correctedPixel;
     }
 
   return sharpenedImage;
@@ -490,76 +510,7 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealIma
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 ::UpdateBiasFieldEstimate( RealImageType* fieldEstimate )
 {
-  // Temporarily set the direction cosine to identity since the B-spline
-  // approximation algorithm works in parametric space and not physical
-  // space.
-  typename ScalarImageType::DirectionType identity;
-  identity.SetIdentity();
-
-  const typename ScalarImageType::RegionType & bufferedRegion = fieldEstimate->GetBufferedRegion();
-  const SizeValueType numberOfPixels = bufferedRegion.GetNumberOfPixels();
-  const bool filterHandlesMemory = false;
-
-  using ImporterType = ImportImageFilter<RealType, ImageDimension>;
-  typename ImporterType::Pointer importer = ImporterType::New();
-  importer->SetImportPointer( fieldEstimate->GetBufferPointer(), numberOfPixels, filterHandlesMemory );
-  importer->SetRegion( fieldEstimate->GetBufferedRegion() );
-  importer->SetOrigin( fieldEstimate->GetOrigin() );
-  importer->SetSpacing( fieldEstimate->GetSpacing() );
-  importer->SetDirection( identity );
-  importer->Update();
-
-  const typename ImporterType::OutputImageType * parametricFieldEstimate = importer->GetOutput();
-
-  PointSetPointer fieldPoints = PointSetType::New();
-  fieldPoints->Initialize();
-
-  typename BSplineFilterType::WeightsContainerType::Pointer weights =
-    BSplineFilterType::WeightsContainerType::New();
-  weights->Initialize();
-
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
-  const MaskPixelType maskLabel = this->GetMaskLabel();
-  const bool useMaskLabel = this->GetUseMaskLabel();
-
-  ImageRegionConstIteratorWithIndex<RealImageType>
-    It( parametricFieldEstimate, parametricFieldEstimate->GetRequestedRegion() );
-
-  unsigned int index = 0;
-  for ( It.GoToBegin(); !It.IsAtEnd(); ++It )
-    {
-    if( ( !maskImage ||
-          ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel && maskImage->GetPixel( It.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
-      {
-      PointType point;
-      parametricFieldEstimate->TransformIndexToPhysicalPoint( It.GetIndex(), point );
-
-      ScalarType scalar;
-      scalar[0] = It.Get();
-
-      fieldPoints->SetPointData( index, scalar );
-      fieldPoints->SetPoint( index, point );
-
-      RealType confidenceWeight = 1.0;
-      if( confidenceImage )
-        {
-        confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
-        }
-      weights->InsertElement( index, confidenceWeight );
-      index++;
-      }
-    }
-
-  typename BSplineFilterType::Pointer bspliner = BSplineFilterType::New();
-
   typename BSplineFilterType::ArrayType numberOfControlPoints;
-  typename BSplineFilterType::ArrayType numberOfFittingLevels;
-  numberOfFittingLevels.Fill( 1 );
   for( unsigned int d = 0; d < ImageDimension; d++ )
     {
     if( !this->m_LogBiasFieldControlPointLattice )
@@ -573,27 +524,105 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
       }
     }
 
-  typename ScalarImageType::PointType parametricOrigin =
-    fieldEstimate->GetOrigin();
-  for( unsigned int d = 0; d < ImageDimension; d++ )
+  typename BiasFieldControlPointLatticeType::Pointer phiLattice;
+  if( this->m_UseCachedBSplineFitting )
     {
-    parametricOrigin[d] += (
-        fieldEstimate->GetSpacing()[d] *
-        fieldEstimate->GetLargestPossibleRegion().GetIndex()[d] );
+    phiLattice = this->FitBSplineLattice( fieldEstimate, numberOfControlPoints );
     }
-  bspliner->SetOrigin( parametricOrigin );
-  bspliner->SetSpacing( fieldEstimate->GetSpacing() );
-  bspliner->SetSize( fieldEstimate->GetLargestPossibleRegion().GetSize() );
-  bspliner->SetDirection( fieldEstimate->GetDirection() );
-  bspliner->SetGenerateOutputImage( false );
-  bspliner->SetNumberOfLevels( numberOfFittingLevels );
-  bspliner->SetSplineOrder( this->m_SplineOrder );
-  bspliner->SetNumberOfControlPoints( numberOfControlPoints );
-  bspliner->SetInput( fieldPoints );
-  bspliner->SetPointWeights( weights );
-  bspliner->Update();
+  else
+    {
+    // Temporarily set the direction cosine to identity since the B-spline
+    // approximation algorithm works in parametric space and not physical
+    // space.
+    typename ScalarImageType::DirectionType identity;
+    identity.SetIdentity();
+
+    const typename ScalarImageType::RegionType & bufferedRegion = fieldEstimate->GetBufferedRegion();
+    const SizeValueType numberOfPixels = bufferedRegion.GetNumberOfPixels();
+    const bool filterHandlesMemory = false;
+
+    using ImporterType = ImportImageFilter<RealType, ImageDimension>;
+    typename ImporterType::Pointer importer = ImporterType::New();
+    importer->SetImportPointer( fieldEstimate->GetBufferPointer(), numberOfPixels, filterHandlesMemory );
+    importer->SetRegion( fieldEstimate->GetBufferedRegion() );
+    importer->SetOrigin( fieldEstimate->GetOrigin() );
+    importer->SetSpacing( fieldEstimate->GetSpacing() );
+    importer->SetDirection( identity );
+    importer->Update();
+
+    const typename ImporterType::OutputImageType * parametricFieldEstimate = importer->GetOutput();
+
+    PointSetPointer fieldPoints = PointSetType::New();
+    fieldPoints->Initialize();
+
+    typename BSplineFilterType::WeightsContainerType::Pointer weights =
+      BSplineFilterType::WeightsContainerType::New();
+    weights->Initialize();
+
+    const MaskImageType * maskImage = this->GetMaskImage();
+    const RealImageType * confidenceImage = this->GetConfidenceImage();
+    const MaskPixelType maskLabel = this->GetMaskLabel();
+    const bool useMaskLabel = this->GetUseMaskLabel();
+
+    ImageRegionConstIteratorWithIndex<RealImageType>
+      It( parametricFieldEstimate, parametricFieldEstimate->GetRequestedRegion() );
+
+    unsigned int index = 0;
+    for ( It.GoToBegin(); !It.IsAtEnd(); ++It )
+      {
+      if( ( !maskImage ||
+            ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel )
+            || ( !useMaskLabel && maskImage->GetPixel( It.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
+            )
+          && ( !confidenceImage ||
+               confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
+        {
+        PointType point;
+        parametricFieldEstimate->TransformIndexToPhysicalPoint( It.GetIndex(), point );
+
+        ScalarType scalar;
+        scalar[0] = It.Get();
+
+        fieldPoints->SetPointData( index, scalar );
+        fieldPoints->SetPoint( index, point );
+
+        RealType confidenceWeight = 1.0;
+        if( confidenceImage )
+          {
+          confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
+          }
+        weights->InsertElement( index, confidenceWeight );
+        index++;
+        }
+      }
+
+    typename BSplineFilterType::Pointer bspliner = BSplineFilterType::New();
+
+    typename BSplineFilterType::ArrayType numberOfFittingLevels;
+    numberOfFittingLevels.Fill( 1 );
 
-  typename BiasFieldControlPointLatticeType::Pointer phiLattice = bspliner->GetPhiLattice();
+    typename ScalarImageType::PointType parametricOrigin =
+      fieldEstimate->GetOrigin();
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      parametricOrigin[d] += (
+          fieldEstimate->GetSpacing()[d] *
+          fieldEstimate->GetLargestPossibleRegion().GetIndex()[d] );
+      }
+    bspliner->SetOrigin( parametricOrigin );
+    bspliner->SetSpacing( fieldEstimate->GetSpacing() );
+    bspliner->SetSize( fieldEstimate->GetLargestPossibleRegion().GetSize() );
+    bspliner->SetDirection( fieldEstimate->GetDirection() );
+    bspliner->SetGenerateOutputImage( false );
+    bspliner->SetNumberOfLevels( numberOfFittingLevels );
+    bspliner->SetSplineOrder( this->m_SplineOrder );
+    bspliner->SetNumberOfControlPoints( numberOfControlPoints );
+    bspliner->SetInput( fieldPoints );
+    bspliner->SetPointWeights( weights );
+    bspliner->Update();
+
+    phiLattice = bspliner->GetPhiLattice();
+    }
 
   // Add the bias field control points to the current estimate.
 
@@ -661,6 +690,288 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   return biasField;
 }
 
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ComputeBSplineBasisCache( const RealImageType *fieldEstimate,
+                            const ArrayType & numberOfControlPoints )
+{
+  using KernelType = CoxDeBoorBSplineKernelFunction<3>;
+  using KernelOrder0Type = BSplineKernelFunction<0>;
+  using KernelOrder1Type = BSplineKernelFunction<1>;
+  using KernelOrder2Type = BSplineKernelFunction<2>;
+  using KernelOrder3Type = BSplineKernelFunction<3>;
+
+  typename KernelType::Pointer kernel = KernelType::New();
+  kernel->SetSplineOrder( this->m_SplineOrder );
+  typename KernelOrder0Type::Pointer kernelOrder0 = KernelOrder0Type::New();
+  typename KernelOrder1Type::Pointer kernelOrder1 = KernelOrder1Type::New();
+  typename KernelOrder2Type::Pointer kernelOrder2 = KernelOrder2Type::New();
+  typename KernelOrder3Type::Pointer kernelOrder3 = KernelOrder3Type::New();
+
+  const unsigned int numberOfBasisFunctions = this->m_SplineOrder + 1;
+
+  // Same parametric mapping as BSplineScatteredDataPointSetToImageFilter
+  // applied to the physical points of the voxels with identity direction.
+
+  const typename RealImageType::RegionType & region = fieldEstimate->GetLargestPossibleRegion();
+  const typename RealImageType::PointType & origin = fieldEstimate->GetOrigin();
+  const typename RealImageType::SpacingType & spacing = fieldEstimate->GetSpacing();
+  const RealType bsplineEpsilon = 1e-3;
+
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    const SizeValueType size = region.GetSize()[d];
+    const typename PointType::ValueType parametricOrigin = origin[d] +
+      spacing[d] * region.GetIndex()[d];
+
+    const unsigned int totalNumberOfSpans = numberOfControlPoints[d] - this->m_SplineOrder;
+    const RealType r = static_cast<RealType>( totalNumberOfSpans ) /
+      ( static_cast<RealType>( size - 1 ) * static_cast<RealType>( spacing[d] ) );
+    const RealType epsilon = r * static_cast<RealType>( spacing[d] ) * bsplineEpsilon;
+
+    this->m_BasisSpans[d].resize( size );
+    this->m_BasisValues[d].resize( size * numberOfBasisFunctions );
+
+    for( SizeValueType c = 0; c < size; c++ )
+      {
+      const typename PointType::ValueType point = origin[d] + spacing[d] *
+        static_cast<double>( region.GetIndex()[d] + static_cast<IndexValueType>( c ) );
+
+      RealType p = ( point - parametricOrigin ) * r;
+      if( std::abs( p - static_cast<RealType>( totalNumberOfSpans ) ) <= epsilon )
+        {
+        p = static_cast<RealType>( totalNumberOfSpans ) - epsilon;
+        }
+      if( p < NumericTraits<RealType>::ZeroValue() && std::abs( p ) <= epsilon )
+        {
+        p = NumericTraits<RealType>::ZeroValue();
+        }
+      if( p < NumericTraits<RealType>::ZeroValue() ||
+          p >= static_cast<RealType>( totalNumberOfSpans ) )
+        {
+        itkExceptionMacro( "The reparameterized point component " << p
+          << " is outside the corresponding parametric domain of [0, "
+          << totalNumberOfSpans << ")." );
+        }
+
+      const auto span = static_cast<unsigned int>( p );
+      this->m_BasisSpans[d][c] = span;
+      for( unsigned int k = 0; k < numberOfBasisFunctions; k++ )
+        {
+        RealType u = static_cast<RealType>( p - span - k ) + 0.5 *
+          static_cast<RealType>( this->m_SplineOrder - 1 );
+
+        RealType B = 0.0;
+        switch( this->m_SplineOrder )
+          {
+          case 0:
+            {
+            B = kernelOrder0->Evaluate( u );
+            break;
+            }
+          case 1:
+            {
+            B = kernelOrder1->Evaluate( u );
+            break;
+            }
+          case 2:
+            {
+            B = kernelOrder2->Evaluate( u );
+            break;
+            }
+          case 3:
+            {
+            B = kernelOrder3->Evaluate( u );
+            break;
+            }
+          default:
+            {
+            B = kernel->Evaluate( u );
+            break;
+            }
+          }
+        this->m_BasisValues[d][c * numberOfBasisFunctions + k] = B;
+        }
+      }
+    }
+  this->m_CachedNumberOfControlPoints = numberOfControlPoints;
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+typename
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::BiasFieldControlPointLatticeType::Pointer
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::FitBSplineLattice( const RealImageType *fieldEstimate,
+                     const ArrayType & numberOfControlPoints )
+{
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( numberOfControlPoints[d] < this->m_SplineOrder + 1 )
+      {
+      itkExceptionMacro(
+        "The number of control points must be greater than the spline order." );
+      }
+    }
+
+  // The basis values only depend on the lattice size, which changes once per
+  // fitting level.
+  if( this->m_CachedNumberOfControlPoints != numberOfControlPoints )
+    {
+    this->ComputeBSplineBasisCache( fieldEstimate, numberOfControlPoints );
+    }
+
+  SizeValueType numberOfLatticePoints = 1;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    numberOfLatticePoints *= numberOfControlPoints[d];
+    }
+
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  this->m_OmegaLatticePerThread.assign( numberOfThreads,
+    std::vector<RealType>( numberOfLatticePoints, 0.0 ) );
+  this->m_DeltaLatticePerThread.assign( numberOfThreads,
+    std::vector<RealType>( numberOfLatticePoints, 0.0 ) );
+  this->m_FittingFieldBuffer = fieldEstimate->GetBufferPointer();
+
+  this->GetMultiThreader()->SetNumberOfThreads( numberOfThreads );
+  this->GetMultiThreader()->SetSingleMethod( this->FitBSplineLatticeThreaderCallback, this );
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Accumulate the per-thread lattices and compute the control point values.
+
+  std::vector<RealType> & omega = this->m_OmegaLatticePerThread[0];
+  std::vector<RealType> & delta = this->m_DeltaLatticePerThread[0];
+  for( ThreadIdType n = 1; n < numberOfThreads; n++ )
+    {
+    for( SizeValueType i = 0; i < numberOfLatticePoints; i++ )
+      {
+      omega[i] += this->m_OmegaLatticePerThread[n][i];
+      delta[i] += this->m_DeltaLatticePerThread[n][i];
+      }
+    }
+
+  typename BiasFieldControlPointLatticeType::SizeType size;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    size[d] = numberOfControlPoints[d];
+    }
+  typename BiasFieldControlPointLatticeType::Pointer phiLattice =
+    BiasFieldControlPointLatticeType::New();
+  phiLattice->SetRegions( size );
+  phiLattice->Allocate();
+
+  ScalarType * phi = phiLattice->GetBufferPointer();
+  for( SizeValueType i = 0; i < numberOfLatticePoints; i++ )
+    {
+    phi[i][0] = 0.0;
+    if( Math::NotAlmostEquals( omega[i], NumericTraits<RealType>::ZeroValue() ) )
+      {
+      const RealType value = delta[i] / omega[i];
+      if( !itk::Math::isnan( value ) && !itk::Math::isinf( value ) )
+        {
+        phi[i][0] = value;
+        }
+      }
+    }
+
+  this->m_FittingFieldBuffer = nullptr;
+  this->m_OmegaLatticePerThread.clear();
+  this->m_DeltaLatticePerThread.clear();
+
+  return phiLattice;
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+ITK_THREAD_RETURN_TYPE
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::FitBSplineLatticeThreaderCallback( void *arg )
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  Self *filter = static_cast< Self * >( info->UserData );
+
+  filter->ThreadedFitBSplineLattice( info->ThreadID, info->NumberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedFitBSplineLattice( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const unsigned int numberOfBasisFunctions = this->m_SplineOrder + 1;
+
+  // Lattice strides and the tensor product neighborhood of a point.
+
+  SizeValueType latticeStride[ImageDimension];
+  SizeValueType numberOfNeighbors = 1;
+  latticeStride[0] = 1;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d > 0 )
+      {
+      latticeStride[d] = latticeStride[d - 1] * this->m_CachedNumberOfControlPoints[d - 1];
+      }
+    numberOfNeighbors *= numberOfBasisFunctions;
+    }
+  std::vector<RealType>      neighborWeights( numberOfNeighbors );
+  std::vector<SizeValueType> neighborOffsets( numberOfNeighbors );
+
+  const SizeValueType numberOfPoints = this->m_MaskedVoxelOffsets.size();
+  const SizeValueType numberOfPointsPerThread = numberOfPoints / numberOfThreads;
+  const SizeValueType start = threadId * numberOfPointsPerThread;
+  const SizeValueType end = ( threadId == numberOfThreads - 1 ) ? numberOfPoints :
+    start + numberOfPointsPerThread;
+
+  const typename RealImageType::IndexType & startIndex =
+    this->GetInput()->GetLargestPossibleRegion().GetIndex();
+
+  std::vector<RealType> & omega = this->m_OmegaLatticePerThread[threadId];
+  std::vector<RealType> & delta = this->m_DeltaLatticePerThread[threadId];
+
+  for( SizeValueType n = start; n < end; n++ )
+    {
+    const typename RealImageType::IndexType & index = this->m_MaskedVoxelIndices[n];
+
+    // Expand the separable basis values into the weights and lattice offsets
+    // of the (order + 1)^d neighborhood, and accumulate the sum of squares.
+    SizeValueType count = 1;
+    neighborWeights[0] = 1.0;
+    neighborOffsets[0] = 0;
+    RealType w2Sum = 1.0;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const SizeValueType c = index[d] - startIndex[d];
+      const RealType * B = &this->m_BasisValues[d][c * numberOfBasisFunctions];
+      const SizeValueType spanOffset = this->m_BasisSpans[d][c] * latticeStride[d];
+
+      RealType b2Sum = 0.0;
+      for( unsigned int k = numberOfBasisFunctions; k-- > 0; )
+        {
+        for( SizeValueType j = 0; j < count; j++ )
+          {
+          neighborWeights[k * count + j] = neighborWeights[j] * B[k];
+          neighborOffsets[k * count + j] = neighborOffsets[j] + spanOffset + k * latticeStride[d];
+          }
+        b2Sum += B[k] * B[k];
+        }
+      w2Sum *= b2Sum;
+      count *= numberOfBasisFunctions;
+      }
+
+    const RealType wc = this->m_MaskedVoxelWeights[n];
+    const RealType data = this->m_FittingFieldBuffer[this->m_MaskedVoxelOffsets[n]] * wc / w2Sum;
+    for( SizeValueType j = 0; j < numberOfNeighbors; j++ )
+      {
+      const RealType t = neighborWeights[j];
+      const RealType t2 = t * t;
+      omega[neighborOffsets[j]] += wc * t2;
+      delta[neighborOffsets[j]] += data * t2 * t;
+      }
+    }
+}
+
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
 typename
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealType
@@ -681,33 +992,18 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   RealType sigma = 0.0;
   RealType N = 0.0;
 
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
-  const MaskPixelType maskLabel = this->GetMaskLabel();
-  const bool useMaskLabel = this->GetUseMaskLabel();
-
-  ImageRegionConstIteratorWithIndex<RealImageType> It(
-    subtracter->GetOutput(),
-    subtracter->GetOutput()->GetLargestPossibleRegion() );
+  const RealType * differenceBuffer = subtracter->GetOutput()->GetBufferPointer();
 
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  for( const OffsetValueType offset : this->m_MaskedVoxelOffsets )
     {
-    if( ( !maskImage ||
-          ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel )
-          || ( !useMaskLabel && maskImage->GetPixel( It.GetIndex() ) != NumericTraits< MaskPixelType >::ZeroValue() )
-          )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
-      {
-      RealType pixel = std::exp( It.Get() );
-      N += 1.0;
+    RealType pixel = std::exp( differenceBuffer[offset] );
+    N += 1.0;
 
-      if( N > 1.0 )
-        {
-        sigma = sigma + itk::Math::sqr( pixel - mu ) * ( N - 1.0 ) / N;
-        }
-      mu = mu * ( 1.0 - 1.0 / N ) + pixel / N;
+    if( N > 1.0 )
+      {
+      sigma = sigma + itk::Math::sqr( pixel - mu ) * ( N - 1.0 ) / N;
       }
+    mu = mu * ( 1.0 - 1.0 / N ) + pixel / N;
     }
   sigma = std::sqrt( sigma / ( N - 1.0 ) );
 
@@ -738,6 +1034,8 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
      << this->m_NumberOfFittingLevels << std::endl;
   os << indent << "Number of control points: "
      << this->m_NumberOfControlPoints << std::endl;
+  os << indent << "Use cached B-spline fitting: "
+     << this->m_UseCachedBSplineFitting << std::endl;
   os << indent << "CurrentConvergenceMeasurement: "
      << this->m_CurrentConvergenceMeasurement << std::endl;
   os << indent << "CurrentLevel: " << this->m_CurrentLevel << std::endl;
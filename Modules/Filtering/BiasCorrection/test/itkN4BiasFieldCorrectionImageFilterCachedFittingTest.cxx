@@ -0,0 +1,204 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkN4BiasFieldCorrectionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Compares the cached B-spline fitting of N4BiasFieldCorrectionImageFilter
+// with the fitting through BSplineScatteredDataPointSetToImageFilter.
+
+namespace
+{
+
+template< typename TImage >
+typename TImage::Pointer
+CreateBiasedImage( const typename TImage::SizeType & size )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 2018 );
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  typename TImage::SpacingType spacing;
+  for( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+    {
+    spacing[d] = 1.0 + 0.25 * d;
+    }
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    // Three tissue classes in slabs along the first dimension, multiplied by
+    // a smooth bias field.
+    double value = 100.0;
+    if( index[0] >= static_cast< itk::IndexValueType >( size[0] / 3 ) )
+      {
+      value = 200.0;
+      }
+    if( index[0] >= static_cast< itk::IndexValueType >( 2 * size[0] / 3 ) )
+      {
+      value = 300.0;
+      }
+    double bias = 0.0;
+    for( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+      {
+      const double x = static_cast< double >( index[d] ) / size[d] - 0.5;
+      bias += 0.4 * x - 0.6 * x * x;
+      }
+    it.Set( value * std::exp( bias ) + generator->GetNormalVariate( 0.0, 4.0 ) );
+    }
+  return image;
+}
+
+template< typename TImage, typename TInputImage >
+typename TImage::Pointer
+CreateMask( const TInputImage * input )
+{
+  typename TImage::Pointer mask = TImage::New();
+  mask->CopyInformation( input );
+  mask->SetRegions( input->GetLargestPossibleRegion() );
+  mask->Allocate( true );
+
+  typename TImage::RegionType region = mask->GetLargestPossibleRegion();
+  region.ShrinkByRadius( 2 );
+  itk::ImageRegionIteratorWithIndex< TImage > it( mask, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( 1 );
+    }
+  return mask;
+}
+
+template< typename TImage, typename TMaskImage >
+bool
+CompareCachedAndPointSetFitting( const typename TImage::SizeType & size, bool useMask )
+{
+  using FilterType = itk::N4BiasFieldCorrectionImageFilter< TImage, TMaskImage, TImage >;
+  using LatticeType = typename FilterType::BiasFieldControlPointLatticeType;
+
+  const typename TImage::Pointer input = CreateBiasedImage< TImage >( size );
+  const typename TMaskImage::Pointer mask = CreateMask< TMaskImage >( input.GetPointer() );
+
+  typename TImage::Pointer outputs[2];
+  typename LatticeType::Pointer lattices[2];
+  for( unsigned int n = 0; n < 2; n++ )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( input );
+    if( useMask )
+      {
+      filter->SetMaskImage( mask );
+      }
+    typename FilterType::VariableSizeArrayType maximumNumberOfIterations( 2 );
+    maximumNumberOfIterations.Fill( 10 );
+    filter->SetMaximumNumberOfIterations( maximumNumberOfIterations );
+    filter->SetNumberOfFittingLevels( 2 );
+    filter->SetConvergenceThreshold( 0.0 );
+    filter->SetUseCachedBSplineFitting( n == 0 );
+    filter->Update();
+
+    outputs[n] = filter->GetOutput();
+    lattices[n] = const_cast< LatticeType * >( filter->GetLogBiasFieldControlPointLattice() );
+    }
+
+  if( lattices[0]->GetLargestPossibleRegion() != lattices[1]->GetLargestPossibleRegion() )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The control point lattices have different sizes" << std::endl;
+    return false;
+    }
+
+  double latticeDifference = 0.0;
+  itk::ImageRegionConstIterator< LatticeType > itL0( lattices[0], lattices[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< LatticeType > itL1( lattices[1], lattices[1]->GetLargestPossibleRegion() );
+  for( ; !itL0.IsAtEnd(); ++itL0, ++itL1 )
+    {
+    latticeDifference = std::max( latticeDifference,
+      static_cast< double >( std::abs( itL0.Get()[0] - itL1.Get()[0] ) ) );
+    }
+
+  double outputDifference = 0.0;
+  itk::ImageRegionConstIterator< TImage > itO0( outputs[0], outputs[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > itO1( outputs[1], outputs[1]->GetLargestPossibleRegion() );
+  for( ; !itO0.IsAtEnd(); ++itO0, ++itO1 )
+    {
+    outputDifference = std::max( outputDifference,
+      std::abs( static_cast< double >( itO0.Get() ) - static_cast< double >( itO1.Get() ) )
+      / std::max( std::abs( static_cast< double >( itO1.Get() ) ), 1.0 ) );
+    }
+
+  std::cout << "Size " << size << ", mask " << useMask
+            << ": maximum lattice difference " << latticeDifference
+            << ", maximum relative output difference " << outputDifference << std::endl;
+
+  const double tolerance = 1e-4;
+  if( latticeDifference > tolerance || outputDifference > tolerance )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The cached fitting differs from the point set fitting by more than "
+              << tolerance << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end namespace
+
+int itkN4BiasFieldCorrectionImageFilterCachedFittingTest( int, char* [] )
+{
+  using ImageType = itk::Image< float, 2 >;
+  using MaskImageType = itk::Image< unsigned char, 2 >;
+  using FilterType = itk::N4BiasFieldCorrectionImageFilter< ImageType, MaskImageType, ImageType >;
+
+  FilterType::Pointer filter = FilterType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( filter, N4BiasFieldCorrectionImageFilter, ImageToImageFilter );
+
+  TEST_SET_GET_BOOLEAN( filter, UseCachedBSplineFitting, true );
+  TEST_SET_GET_BOOLEAN( filter, UseCachedBSplineFitting, false );
+
+  bool testPassed = true;
+
+  ImageType::SizeType size2D;
+  size2D[0] = 64;
+  size2D[1] = 48;
+  testPassed &= CompareCachedAndPointSetFitting< ImageType, MaskImageType >( size2D, false );
+  testPassed &= CompareCachedAndPointSetFitting< ImageType, MaskImageType >( size2D, true );
+
+  using Image3DType = itk::Image< float, 3 >;
+  using MaskImage3DType = itk::Image< unsigned char, 3 >;
+  Image3DType::SizeType size3D;
+  size3D[0] = 24;
+  size3D[1] = 20;
+  size3D[2] = 16;
+  testPassed &= CompareCachedAndPointSetFitting< Image3DType, MaskImage3DType >( size3D, true );
+
+  if( !testPassed )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,227 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCurvatureFlowImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkCommand.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Records the active volume statistics of the filter after each iteration.
+template< typename TFilter >
+class ActiveVolumeObserver
+{
+public:
+  ActiveVolumeObserver( TFilter * filter ) : m_Filter( filter ) {}
+
+  void Record()
+    {
+    m_ActiveBlocks.push_back( m_Filter->GetNumberOfActiveBlocks() );
+    m_ActiveFractions.push_back( m_Filter->GetActiveVolumeFraction() );
+    }
+
+  TFilter *                        m_Filter;
+  std::vector< itk::SizeValueType > m_ActiveBlocks;
+  std::vector< double >            m_ActiveFractions;
+};
+
+// Records the largest pixel change of the filter output in each iteration.
+template< typename TFilter, typename TImage >
+class ChangeObserver
+{
+public:
+  ChangeObserver( TFilter * filter, const TImage * input ) : m_Filter( filter )
+    {
+    m_Previous.assign( input->GetBufferPointer(),
+                       input->GetBufferPointer() + input->GetBufferedRegion().GetNumberOfPixels() );
+    }
+
+  void Record()
+    {
+    const typename TImage::PixelType * current = m_Filter->GetOutput()->GetBufferPointer();
+    double maximumChange = 0.0;
+    for( size_t ii = 0; ii < m_Previous.size(); ++ii )
+      {
+      maximumChange = std::max( maximumChange, std::abs( static_cast< double >( current[ii] - m_Previous[ii] ) ) );
+      m_Previous[ii] = current[ii];
+      }
+    m_Changes.push_back( maximumChange );
+    }
+
+  TFilter *                                   m_Filter;
+  std::vector< typename TImage::PixelType >   m_Previous;
+  std::vector< double >                       m_Changes;
+};
+}
+
+int itkCurvatureFlowActiveBlocksTest( int, char* [] )
+{
+  constexpr unsigned int Dimension = 2;
+  using PixelType = float;
+  using ImageType = itk::Image< PixelType, Dimension >;
+  using FilterType = itk::CurvatureFlowImageFilter< ImageType, ImageType >;
+
+  // A bright square on a flat background: the background has a zero update,
+  // and only the blocks the smoothing reaches should be processed.
+  ImageType::SizeType size;
+  size.Fill( 128 );
+
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+  input->FillBuffer( 0.0f );
+
+  ImageType::IndexType squareIndex;
+  squareIndex.Fill( 56 );
+  ImageType::SizeType squareSize;
+  squareSize.Fill( 12 );
+  ImageType::RegionType squareRegion( squareIndex, squareSize );
+
+  itk::ImageRegionIterator< ImageType > it( input, squareRegion );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( 100.0f );
+    }
+
+  constexpr unsigned int numberOfIterations = 10;
+
+  FilterType::Pointer denseFilter = FilterType::New();
+  denseFilter->SetInput( input );
+  denseFilter->SetNumberOfIterations( numberOfIterations );
+  denseFilter->SetTimeStep( 0.1 );
+
+  using ChangeObserverType = ChangeObserver< FilterType, ImageType >;
+  ChangeObserverType changeObserver( denseFilter, input );
+  using ChangeCommandType = itk::SimpleMemberCommand< ChangeObserverType >;
+  ChangeCommandType::Pointer changeCommand = ChangeCommandType::New();
+  changeCommand->SetCallbackFunction( &changeObserver, &ChangeObserverType::Record );
+  denseFilter->AddObserver( itk::IterationEvent(), changeCommand );
+
+  TRY_EXPECT_NO_EXCEPTION( denseFilter->Update() );
+  TEST_EXPECT_EQUAL( changeObserver.m_Changes.size(), numberOfIterations );
+
+  FilterType::Pointer blockFilter = FilterType::New();
+  blockFilter->SetInput( input );
+  blockFilter->SetNumberOfIterations( numberOfIterations );
+  blockFilter->SetTimeStep( 0.1 );
+  blockFilter->SetNumberOfThreads( 3 );
+
+  TEST_EXPECT_TRUE( !blockFilter->GetUseActiveBlocks() );
+  blockFilter->UseActiveBlocksOn();
+  TEST_EXPECT_TRUE( blockFilter->GetUseActiveBlocks() );
+
+  FilterType::BlockSizeType blockSize;
+  blockSize.Fill( 8 );
+  blockFilter->SetActiveBlockSize( blockSize );
+  TEST_SET_GET_VALUE( blockSize, blockFilter->GetActiveBlockSize() );
+  TEST_SET_GET_VALUE( 0.0, blockFilter->GetActiveBlockTolerance() );
+
+  using ObserverType = ActiveVolumeObserver< FilterType >;
+  ObserverType observer( blockFilter );
+  using CommandType = itk::SimpleMemberCommand< ObserverType >;
+  CommandType::Pointer command = CommandType::New();
+  command->SetCallbackFunction( &observer, &ObserverType::Record );
+  blockFilter->AddObserver( itk::IterationEvent(), command );
+
+  TRY_EXPECT_NO_EXCEPTION( blockFilter->Update() );
+
+  TEST_EXPECT_EQUAL( blockFilter->GetNumberOfBlocks(), 256 );
+  TEST_EXPECT_EQUAL( observer.m_ActiveBlocks.size(), numberOfIterations );
+
+  // The first iteration processes everything; afterwards only the blocks
+  // around the square remain active.
+  TEST_EXPECT_EQUAL( observer.m_ActiveBlocks.front(), 256 );
+  TEST_EXPECT_TRUE( observer.m_ActiveFractions.front() == 1.0 );
+  TEST_EXPECT_TRUE( observer.m_ActiveBlocks.back() < 64 );
+  TEST_EXPECT_TRUE( observer.m_ActiveFractions.back() < 0.25 );
+  for( unsigned int ii = 0; ii < numberOfIterations; ++ii )
+    {
+    std::cout << "Iteration " << ii << ": " << observer.m_ActiveBlocks[ii]
+              << " active blocks, active volume fraction "
+              << observer.m_ActiveFractions[ii] << std::endl;
+    }
+
+  // With a zero tolerance, only blocks whose update is exactly zero are
+  // skipped, so the result must match the dense iteration.
+  itk::ImageRegionConstIterator< ImageType > denseIt( denseFilter->GetOutput(),
+    denseFilter->GetOutput()->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > blockIt( blockFilter->GetOutput(),
+    blockFilter->GetOutput()->GetLargestPossibleRegion() );
+  for( ; !denseIt.IsAtEnd(); ++denseIt, ++blockIt )
+    {
+    if( denseIt.Get() != blockIt.Get() )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Active-block output differs from dense output at " << denseIt.GetIndex()
+                << ": " << blockIt.Get() << " vs. " << denseIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The corners of the square change by several intensity units per
+  // iteration, and a block is only switched off once its largest change
+  // drops to the tolerance. The largest change of the dense run decreases
+  // monotonically, so a tolerance equal to its value at convergedIteration
+  // keeps the blocks on the dense iteration until then, and switches all of
+  // them off afterwards. The result therefore differs from the dense one by
+  // at most the sum of the changes of the later dense iterations.
+  constexpr unsigned int convergedIteration = numberOfIterations / 2;
+  for( unsigned int ii = 1; ii < numberOfIterations; ++ii )
+    {
+    TEST_EXPECT_TRUE( changeObserver.m_Changes[ii] <= changeObserver.m_Changes[ii - 1] );
+    }
+  const double tolerance = changeObserver.m_Changes[convergedIteration - 1];
+  double errorBound = 0.0;
+  for( unsigned int ii = convergedIteration; ii < numberOfIterations; ++ii )
+    {
+    errorBound += changeObserver.m_Changes[ii];
+    }
+
+  const itk::SizeValueType exactActiveBlocks = observer.m_ActiveBlocks.back();
+  observer.m_ActiveBlocks.clear();
+  observer.m_ActiveFractions.clear();
+  blockFilter->SetActiveBlockTolerance( tolerance );
+  TRY_EXPECT_NO_EXCEPTION( blockFilter->Update() );
+  TEST_EXPECT_TRUE( blockFilter->GetNumberOfActiveBlocks() < exactActiveBlocks );
+  TEST_EXPECT_EQUAL( observer.m_ActiveBlocks.back(), 0 );
+
+  double maximumError = 0.0;
+  blockIt = itk::ImageRegionConstIterator< ImageType >( blockFilter->GetOutput(),
+    blockFilter->GetOutput()->GetLargestPossibleRegion() );
+  for( denseIt.GoToBegin(); !denseIt.IsAtEnd(); ++denseIt, ++blockIt )
+    {
+    maximumError = std::max( maximumError, std::abs( static_cast< double >( blockIt.Get() - denseIt.Get() ) ) );
+    }
+  std::cout << "Tolerance " << tolerance << ": largest difference to the dense result "
+            << maximumError << ", bound " << errorBound << std::endl;
+  TEST_EXPECT_TRUE( maximumError <= errorBound );
+
+  // An empty block size is rejected.
+  blockSize.Fill( 0 );
+  blockFilter->SetActiveBlockSize( blockSize );
+  TRY_EXPECT_EXCEPTION( blockFilter->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -53,6 +53,14 @@ namespace itk
  * scheme for defining patch weights (mask) as described in Awate and Whitaker 2005 IEEE CVPR and
  * 2006 IEEE TPAMI.
  *
+ * When the sampler is a SpatialNeighborSubsampler (the default) and the component space is
+ * Euclidean, the image update visits the search window one offset at a time instead of one pixel
+ * at a time: for each offset the patch distances of a whole cache-sized tile are obtained from a
+ * single buffer of pixel differences, using separable box sums for uniform patch weights. The
+ * result matches the per-pixel computation up to floating-point rounding. Optionally, candidate
+ * patches can be preselected with the weighted patch means, which bound the patch distance from
+ * below (see SetPatchPreselectionThreshold()).
+ *
  * \ingroup Filtering
  * \ingroup ITKDenoising
  * \sa PatchBasedDenoisingBaseImageFilter
@@ -184,6 +192,32 @@ public:
   itkBooleanMacro(UseFastTensorComputations);
   itkGetConstMacro(UseFastTensorComputations, bool);
 
+  /** Set/Get flag indicating whether the patch distances of the image update
+   *  should be computed for one search window offset at a time over tiles of
+   *  the image (default true) instead of one pixel at a time.
+   *  This is only used when the sampler is a SpatialNeighborSubsampler and the
+   *  component space is Euclidean; other configurations always use the
+   *  per-pixel computation.
+   */
+  itkSetMacro(UseSearchWindowPatchDistances, bool);
+  itkBooleanMacro(UseSearchWindowPatchDistances);
+  itkGetConstMacro(UseSearchWindowPatchDistances, bool);
+
+  /** Set/Get the weight below which candidate patches are skipped without
+   *  computing their distance to the patch being denoised.
+   *
+   *  The weighted squared distance between two patches is bounded from below
+   *  by the sum of the squared patch weights times the squared difference of
+   *  the patch means of the first component, each mean being weighted by the
+   *  squared patch weights (Cauchy-Schwarz inequality). Any patch whose
+   *  Gaussian weight is guaranteed by that bound to be smaller than this
+   *  threshold is dropped. Only patches that lie entirely inside the image are
+   *  preselected, and only in the Euclidean component space.
+   *  A value of 0 (default) disables the preselection.
+   */
+  itkSetClampMacro(PatchPreselectionThreshold, double, 0.0, 1.0);
+  itkGetConstMacro(PatchPreselectionThreshold, double);
+
   /** Maximum number of Newton-Raphson iterations for sigma update. */
   static constexpr unsigned int MaxSigmaUpdateIterations = 20;
 
@@ -417,6 +451,31 @@ protected:
                                                BaseSamplerPointer& sampler,
                                                ThreadDataStruct& threadData);
 
+  /** Returns true if the image update may visit the search window one offset
+   * at a time, see SetUseSearchWindowPatchDistances(). */
+  virtual bool CanUseSearchWindowPatchDistances() const;
+
+  /** Computes the gradient of the joint entropy for every pixel of the region,
+   * looping over the offsets of the search window of the
+   * SpatialNeighborSubsampler. The gradients are stored pixel by pixel, in
+   * the order of the region, with m_NumPixelComponents values per pixel. */
+  virtual void ThreadedComputeSearchWindowGradients(const InputImageRegionType& regionToProcess,
+                                                    std::vector<RealValueType>& gradients);
+
+  /** Computes the weighted patch means used to preselect candidate patches. */
+  virtual void ComputePatchMeans();
+
+  virtual void ThreadedComputePatchMeans(const InputImageRegionType& regionToProcess);
+
+  /** Returns true if the patch at selectedOffset cannot have a weight larger
+   * than PatchPreselectionThreshold relative to the patch at currentOffset.
+   * Both patches must lie entirely inside the image. */
+  bool IsRejectedByPatchMeans(OffsetValueType currentOffset, OffsetValueType selectedOffset) const
+  {
+    const RealValueType diff = m_PatchMeans[currentOffset] - m_PatchMeans[selectedOffset];
+    return diff * diff > m_PatchPreselectionDistance;
+  }
+
   void ApplyUpdate() override;
 
   virtual void ThreadedApplyUpdate(const InputImageRegionType& regionToProcess,
@@ -441,6 +500,15 @@ private:
    * region which it then passes to ThreadedApplyUpdate for processing. */
   static ITK_THREAD_RETURN_TYPE ApplyUpdateThreaderCallback( void *arg );
 
+  /** This callback method uses ImageSource::SplitRequestedRegion to acquire a
+   * region which it then passes to ThreadedComputePatchMeans for processing. */
+  static ITK_THREAD_RETURN_TYPE ComputePatchMeansThreaderCallback( void *arg );
+
+  /** Calls function(index) with the first index of every line, along the
+   * first dimension, of the region. */
+  template <typename TFunction>
+  static void ForEachLineInRegion(const InputImageRegionType& region, TFunction function);
+
   template <typename TInputImageType>
   void DispatchedMinMax(const TInputImageType* img);
 
@@ -512,6 +580,12 @@ private:
 
   bool m_UseFastTensorComputations;
 
+  bool m_UseSearchWindowPatchDistances;
+
+  double                     m_PatchPreselectionThreshold;
+  RealValueType              m_PatchPreselectionDistance;
+  std::vector<RealValueType> m_PatchMeans;
+
   RealArrayType  m_KernelBandwidthSigma;
   bool           m_KernelBandwidthSigmaIsSet;
   RealArrayType  m_IntensityRescaleInvFactor;
@@ -29,6 +29,8 @@
 #include "itkImageAlgorithm.h"
 #include "itkVectorImageToImageAdaptor.h"
 #include "itkSpatialNeighborSubsampler.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkMacro.h"
 #include "itkMath.h"
 
@@ -44,6 +46,9 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
   m_TotalNumberPixels( 0 ),        // not valid until an image is provided
   m_UseSmoothDiscPatchWeights( true ),
   m_UseFastTensorComputations( true ),
+  m_UseSearchWindowPatchDistances( true ),
+  m_PatchPreselectionThreshold( 0.0 ),
+  m_PatchPreselectionDistance( 0.0 ),
   m_KernelBandwidthSigmaIsSet( false ),
   m_ZeroPixel(),                 // not valid until Initialize()
   m_KernelBandwidthFractionPixelsForEstimation( 0.20 ),
@@ -1997,6 +2002,17 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
 
   str.Filter = this;
 
+  if( m_PatchPreselectionThreshold > 0.0
+      && this->GetComponentSpace() == Superclass::EUCLIDEAN
+      && this->GetSmoothingWeight() > 0 )
+    {
+    this->ComputePatchMeans();
+    }
+  else
+    {
+    m_PatchMeans.clear();
+    }
+
   // Compute smoothing updated for intensites at each pixel
   // based on gradient of the joint entropy
   this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads() );
@@ -2074,6 +2090,18 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
 
   BaseSamplerPointer sampler = threadData.sampler;
 
+  // When possible, compute the gradients of the joint entropy for the whole
+  // region up front, one search window offset at a time.
+  const bool useSearchWindow = this->GetSmoothingWeight() > 0
+    && this->CanUseSearchWindowPatchDistances();
+  std::vector<RealValueType> searchWindowGradients;
+  if( useSearchWindow )
+    {
+    this->ThreadedComputeSearchWindowGradients(regionToProcess, searchWindowGradients);
+    }
+  const typename OutputImageType::IndexType regionIndex = regionToProcess.GetIndex();
+  const typename OutputImageType::SizeType  regionSize = regionToProcess.GetSize();
+
   ProgressReporter progress(this, threadId, regionToProcess.GetNumberOfPixels() );
 
   // Break the input into a series of regions.  The first region is free
@@ -2118,9 +2146,28 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
       if( smoothingWeight > 0 )
         {
         // Get intensity update driven by patch-based denoiser
-        const RealType gradientJointEntropy =
-          this->ComputeGradientJointEntropy(sampleIt.GetInstanceIdentifier(), inList, sampler,
-          threadData);
+        RealType gradientJointEntropy;
+        if( useSearchWindow )
+          {
+          const typename OutputImageType::IndexType index = outputIt.GetIndex();
+          SizeValueType pos = 0;
+          for( int dim = OutputImageType::ImageDimension - 1; dim >= 0; --dim )
+            {
+            pos = pos * regionSize[dim] + ( index[dim] - regionIndex[dim] );
+            }
+          gradientJointEntropy = m_ZeroPixel;
+          for( unsigned int pc = 0; pc < m_NumPixelComponents; ++pc )
+            {
+            this->SetComponent(gradientJointEntropy, pc,
+                               searchWindowGradients[pos * m_NumPixelComponents + pc]);
+            }
+          }
+        else
+          {
+          gradientJointEntropy =
+            this->ComputeGradientJointEntropy(sampleIt.GetInstanceIdentifier(), inList, sampler,
+            threadData);
+          }
 
         constexpr RealValueType stepSizeSmoothing  = 0.2;
         result = AddUpdate(result,  gradientJointEntropy * (smoothingWeight * stepSizeSmoothing) );
@@ -2324,6 +2371,11 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
 
   bool useCachedComputations = false;
 
+  // The patch means only bound the distance between patches that are
+  // entirely inside the image.
+  const bool preselect = !m_PatchMeans.empty() && currentPatch.InBounds()
+    && this->GetComponentSpace() == Superclass::EUCLIDEAN;
+
   for( typename BaseSamplerType::SubsampleConstIterator selectedIt = selectedPatches->Begin();
        selectedIt != selectedPatches->End();
        ++selectedIt )
@@ -2332,6 +2384,12 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
     selectedPatch += currSelectedIdx - lastSelectedIdx;
     lastSelectedIdx = currSelectedIdx;
 
+    if( preselect
+        && this->IsRejectedByPatchMeans(currentPatchId, output->ComputeOffset(currSelectedIdx) ) )
+      {
+      continue;
+      }
+
     RealValueType distanceJointEntropy = 0.0;
 
     squaredNorm.Fill(0.0);
@@ -2470,6 +2528,579 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
   return gradientJointEntropy;
 }
 
+template <typename TInputImage, typename TOutputImage>
+bool
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::CanUseSearchWindowPatchDistances() const
+{
+  // The random subsamplers derive from SpatialNeighborSubsampler, so the
+  // exact class is checked by name.
+  return m_UseSearchWindowPatchDistances
+    && this->GetComponentSpace() == Superclass::EUCLIDEAN
+    && m_Sampler.IsNotNull()
+    && std::string( m_Sampler->GetNameOfClass() ) == "SpatialNeighborSubsampler";
+}
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TFunction>
+void
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::ForEachLineInRegion(const InputImageRegionType &region, TFunction function)
+{
+  if( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+  const typename InputImageRegionType::IndexType start = region.GetIndex();
+  const typename InputImageRegionType::IndexType end = region.GetUpperIndex();
+  typename InputImageRegionType::IndexType index = start;
+  unsigned int dim;
+  do
+    {
+    function( index );
+    for( dim = 1; dim < ImageDimension; ++dim )
+      {
+      if( index[dim] < end[dim] )
+        {
+        ++index[dim];
+        break;
+        }
+      index[dim] = start[dim];
+      }
+    }
+  while( dim < ImageDimension );
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::ThreadedComputeSearchWindowGradients(const InputImageRegionType &regionToProcess,
+                                       std::vector<RealValueType> &gradients)
+{
+  // For each offset of the search window, the differences between the
+  // pixels of a tile (padded by the patch radius) and the pixels at that
+  // offset are computed once, and the patch distances of the whole tile are
+  // sums of those differences over the patch. For every pixel, the selected
+  // patches are visited in the same order as in ComputeGradientJointEntropy,
+  // and with the same region constraint.
+  using IndexType = typename OutputImageType::IndexType;
+  using SizeType = typename OutputImageType::SizeType;
+  using OffsetType = typename OutputImageType::OffsetType;
+  using SamplerType =
+      itk::Statistics::SpatialNeighborSubsampler< PatchSampleType, InputImageRegionType >;
+
+  const OutputImageType *     output = this->m_OutputImage;
+  const InputImageRegionType  imageRegion = this->m_InputImage->GetLargestPossibleRegion();
+  const IndexType             imageIndex = imageRegion.GetIndex();
+  const SizeType              imageSize = imageRegion.GetSize();
+  const IndexType             bufferIndex = output->GetBufferedRegion().GetIndex();
+  const OffsetValueType *     bufferOffsetTable = output->GetOffsetTable();
+  const PatchRadiusType       patchRadius = this->GetPatchRadiusInVoxels();
+  const SizeType              searchRadius =
+    static_cast<const SamplerType *>( m_Sampler.GetPointer() )->GetRadius();
+  const unsigned int          numComponents = m_NumPixelComponents;
+  const bool                  preselect = !m_PatchMeans.empty();
+
+  // Patch taps, in the order in which ComputeGradientJointEntropy adds them
+  // to the squared norm.
+  const PatchWeightsType patchWeights = this->GetPatchWeights();
+  const unsigned int     lengthPatch = this->GetPatchLengthInVoxels();
+  const unsigned int     center = ( lengthPatch - 1 ) / 2;
+  std::vector<unsigned int> taps;
+  for( unsigned int jj = 0, kk = center + 1; jj < center; ++jj, ++kk )
+    {
+    taps.push_back( jj );
+    taps.push_back( kk );
+    }
+  taps.push_back( center );
+
+  bool uniformWeights = true;
+  std::vector<OffsetType>    tapOffsets;
+  std::vector<RealValueType> tapSquaredWeights;
+  for( std::vector<unsigned int>::const_iterator tapIt = taps.begin(); tapIt != taps.end(); ++tapIt )
+    {
+    const RealValueType weight = patchWeights[*tapIt];
+    uniformWeights = uniformWeights && ( patchWeights[*tapIt] == patchWeights[0] );
+    if( weight == 0 )
+      {
+      continue;
+      }
+    OffsetType    offset;
+    SizeValueType remainder = *tapIt;
+    for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      const SizeValueType diameter = 2 * patchRadius[dim] + 1;
+      offset[dim] = static_cast<OffsetValueType>( remainder % diameter ) -
+        static_cast<OffsetValueType>( patchRadius[dim] );
+      remainder /= diameter;
+      }
+    tapOffsets.push_back( offset );
+    tapSquaredWeights.push_back( weight * weight );
+    }
+
+  RealArrayType sigmaSquared( numComponents );
+  for( unsigned int ic = 0; ic < numComponents; ++ic )
+    {
+    sigmaSquared[ic] = itk::Math::sqr( m_KernelBandwidthSigma[ic] );
+    }
+
+  // Offsets of the search window, in the order in which the sampler returns
+  // the selected patches.
+  std::vector<OffsetType> searchOffsets;
+  InputImageRegionType    searchWindow;
+  IndexType               searchWindowIndex;
+  SizeType                searchWindowSize;
+  for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+    {
+    searchWindowIndex[dim] = -static_cast<IndexValueType>( searchRadius[dim] );
+    searchWindowSize[dim] = 2 * searchRadius[dim] + 1;
+    }
+  searchWindow.SetIndex( searchWindowIndex );
+  searchWindow.SetSize( searchWindowSize );
+  ForEachLineInRegion( searchWindow, [&]( const IndexType & line )
+    {
+    OffsetType offset;
+    for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      offset[dim] = line[dim];
+      }
+    for( SizeValueType i = 0; i < searchWindowSize[0]; ++i, ++offset[0] )
+      {
+      searchOffsets.push_back( offset );
+      }
+    } );
+
+  // Split the region into tiles that keep the buffers of one offset in cache.
+  const SizeValueType tileEdge = ( ImageDimension == 1 ) ? 4096 :
+    ( ImageDimension == 2 ) ? 64 : ( ImageDimension == 3 ) ? 16 : 8;
+  const IndexType regionIndex = regionToProcess.GetIndex();
+  const SizeType  regionSize = regionToProcess.GetSize();
+  std::vector<InputImageRegionType> tiles;
+  InputImageRegionType tileGrid;
+  SizeType             tileGridSize;
+  for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+    {
+    tileGridSize[dim] = ( regionSize[dim] + tileEdge - 1 ) / tileEdge;
+    }
+  tileGrid.SetSize( tileGridSize );
+  ForEachLineInRegion( tileGrid, [&]( const IndexType & line )
+    {
+    IndexType gridIndex = line;
+    for( gridIndex[0] = 0; gridIndex[0] < static_cast<IndexValueType>( tileGridSize[0] ); ++gridIndex[0] )
+      {
+      IndexType tileIndex;
+      SizeType  tileSize;
+      for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+        {
+        tileIndex[dim] = regionIndex[dim] + gridIndex[dim] * static_cast<IndexValueType>( tileEdge );
+        tileSize[dim] = std::min( tileEdge,
+          regionSize[dim] - static_cast<SizeValueType>( gridIndex[dim] ) * tileEdge );
+        }
+      tiles.push_back( InputImageRegionType( tileIndex, tileSize ) );
+      }
+    } );
+
+  // Linear position of an index in a buffer laid out over a region.
+  const auto strides = []( const InputImageRegionType & region ) -> OffsetType
+    {
+    OffsetType stride;
+    stride[0] = 1;
+    for( unsigned int dim = 1; dim < ImageDimension; ++dim )
+      {
+      stride[dim] = stride[dim - 1] * static_cast<OffsetValueType>( region.GetSize()[dim - 1] );
+      }
+    return stride;
+    };
+  const auto position = []( const InputImageRegionType & region, const OffsetType & stride,
+                            const IndexType & index ) -> OffsetValueType
+    {
+    OffsetValueType pos = 0;
+    for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      pos += ( index[dim] - region.GetIndex()[dim] ) * stride[dim];
+      }
+    return pos;
+    };
+
+  const OffsetType regionStride = strides( regionToProcess );
+  gradients.assign( regionToProcess.GetNumberOfPixels() * numComponents,
+                    NumericTraits<RealValueType>::ZeroValue() );
+
+  std::vector<PixelValueType> values;
+  std::vector<unsigned char>  inside;
+  std::vector<RealValueType>  differences;
+  std::vector<RealValueType>  distances;
+  std::vector<RealValueType>  boxSums[2];
+  std::vector<RealValueType>  sumOfGaussians;
+  std::vector<RealValueType>  tileGradients;
+
+  for( typename std::vector<InputImageRegionType>::const_iterator tileIt = tiles.begin();
+       tileIt != tiles.end(); ++tileIt )
+    {
+    const InputImageRegionType & tile = *tileIt;
+
+    // Pixel values that may be compared for this tile, with a flag telling
+    // whether they are inside the image.
+    InputImageRegionType valueRegion = tile;
+    SizeType             valuePadding;
+    for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+      {
+      valuePadding[dim] = patchRadius[dim] + searchRadius[dim];
+      }
+    valueRegion.PadByRadius( valuePadding );
+    const OffsetType    valueStride = strides( valueRegion );
+    const SizeValueType numberOfValues = valueRegion.GetNumberOfPixels();
+    values.assign( numberOfValues * numComponents, NumericTraits<PixelValueType>::ZeroValue() );
+    inside.assign( numberOfValues, 0 );
+
+    InputImageRegionType readRegion = valueRegion;
+    if( readRegion.Crop( imageRegion ) )
+      {
+      ImageRegionConstIteratorWithIndex<OutputImageType> valueIt( output, readRegion );
+      for( valueIt.GoToBegin(); !valueIt.IsAtEnd(); ++valueIt )
+        {
+        const OffsetValueType pos = position( valueRegion, valueStride, valueIt.GetIndex() );
+        const PixelType       pixel = valueIt.Get();
+        for( unsigned int pc = 0; pc < numComponents; ++pc )
+          {
+          values[pc * numberOfValues + pos] = this->GetComponent( pixel, pc );
+          }
+        inside[pos] = 1;
+        }
+      }
+
+    InputImageRegionType differenceRegion = tile;
+    differenceRegion.PadByRadius( patchRadius );
+    const OffsetType    differenceStride = strides( differenceRegion );
+    const SizeValueType numberOfDifferences = differenceRegion.GetNumberOfPixels();
+    differences.assign( numberOfDifferences * numComponents, NumericTraits<RealValueType>::ZeroValue() );
+    if( uniformWeights )
+      {
+      boxSums[0].resize( numberOfDifferences * numComponents );
+      boxSums[1].resize( numberOfDifferences * numComponents );
+      }
+
+    std::vector<OffsetValueType> tapPositions( tapOffsets.size() );
+    for( size_t tap = 0; tap < tapOffsets.size(); ++tap )
+      {
+      tapPositions[tap] = 0;
+      for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+        {
+        tapPositions[tap] += tapOffsets[tap][dim] * differenceStride[dim];
+        }
+      }
+
+    const OffsetType    tileStride = strides( tile );
+    const SizeValueType numberOfTilePixels = tile.GetNumberOfPixels();
+    distances.assign( numberOfTilePixels * numComponents, NumericTraits<RealValueType>::ZeroValue() );
+    sumOfGaussians.assign( numberOfTilePixels, NumericTraits<RealValueType>::ZeroValue() );
+    tileGradients.assign( numberOfTilePixels * numComponents, NumericTraits<RealValueType>::ZeroValue() );
+
+    for( typename std::vector<OffsetType>::const_iterator offsetIt = searchOffsets.begin();
+         offsetIt != searchOffsets.end(); ++offsetIt )
+      {
+      const OffsetType & searchOffset = *offsetIt;
+
+      // Restrict the tile to the pixels whose constrained search region
+      // contains the pixel at this offset.
+      InputImageRegionType validRegion = tile;
+      bool                 isEmpty = false;
+      for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+        {
+        IndexValueType lower = tile.GetIndex()[dim];
+        IndexValueType upper = tile.GetUpperIndex()[dim];
+        if( searchOffset[dim] > 0 )
+          {
+          upper = std::min( upper, imageIndex[dim] + static_cast<IndexValueType>( imageSize[dim] )
+                            - static_cast<IndexValueType>( patchRadius[dim] ) - 1 - searchOffset[dim] );
+          }
+        else if( searchOffset[dim] < 0 )
+          {
+          lower = std::max( lower, imageIndex[dim] + static_cast<IndexValueType>( patchRadius[dim] )
+                            - searchOffset[dim] );
+          }
+        if( lower > upper )
+          {
+          isEmpty = true;
+          break;
+          }
+        validRegion.SetIndex( dim, lower );
+        validRegion.SetSize( dim, static_cast<SizeValueType>( upper - lower + 1 ) );
+        }
+      if( isEmpty )
+        {
+        continue;
+        }
+
+      // Signed differences between the pixels around the valid region and
+      // the pixels at the offset. Pixels outside the image do not contribute
+      // to the patch distances.
+      OffsetValueType valueShift = 0;
+      OffsetValueType bufferShift = 0;
+      for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+        {
+        valueShift += searchOffset[dim] * valueStride[dim];
+        bufferShift += searchOffset[dim] * bufferOffsetTable[dim];
+        }
+      InputImageRegionType paddedValidRegion = validRegion;
+      paddedValidRegion.PadByRadius( patchRadius );
+      const SizeValueType paddedLineLength = paddedValidRegion.GetSize()[0];
+      ForEachLineInRegion( paddedValidRegion, [&]( const IndexType & line )
+        {
+        const OffsetValueType valuePos = position( valueRegion, valueStride, line );
+        const OffsetValueType differencePos = position( differenceRegion, differenceStride, line );
+        const unsigned char * isInside = &inside[valuePos];
+        for( unsigned int pc = 0; pc < numComponents; ++pc )
+          {
+          const PixelValueType *value = &values[pc * numberOfValues + valuePos];
+          RealValueType *       difference = &differences[pc * numberOfDifferences + differencePos];
+          for( SizeValueType i = 0; i < paddedLineLength; ++i )
+            {
+            const RealValueType diff = value[i + valueShift] - value[i];
+            difference[i] = ( isInside[i] && isInside[i + valueShift] ) ? diff : 0;
+            }
+          }
+        } );
+
+      // Weighted squared patch distances of the valid region.
+      const SizeValueType lineLength = validRegion.GetSize()[0];
+      if( uniformWeights )
+        {
+        // Separable box sums of the squared differences, one dimension at a
+        // time, over a region that shrinks to the valid region.
+        InputImageRegionType sumRegion = paddedValidRegion;
+        for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+          {
+          sumRegion.SetIndex( dim, validRegion.GetIndex()[dim] );
+          sumRegion.SetSize( dim, validRegion.GetSize()[dim] );
+          const OffsetValueType stride = differenceStride[dim];
+          const OffsetValueType radius = static_cast<OffsetValueType>( patchRadius[dim] );
+          const SizeValueType   sumLineLength = sumRegion.GetSize()[0];
+          ForEachLineInRegion( sumRegion, [&]( const IndexType & line )
+            {
+            const OffsetValueType pos = position( differenceRegion, differenceStride, line );
+            for( unsigned int ic = 0; ic < numComponents; ++ic )
+              {
+              const SizeValueType first = ic * numberOfDifferences + pos;
+              RealValueType *     sum = &boxSums[dim % 2][first];
+              std::fill( sum, sum + sumLineLength, NumericTraits<RealValueType>::ZeroValue() );
+              for( OffsetValueType k = -radius; k <= radius; ++k )
+                {
+                if( dim == 0 )
+                  {
+                  const RealValueType *difference = &differences[first + k * stride];
+                  for( SizeValueType i = 0; i < sumLineLength; ++i )
+                    {
+                    sum[i] += difference[i] * difference[i];
+                    }
+                  }
+                else
+                  {
+                  const RealValueType *previous = &boxSums[( dim - 1 ) % 2][first + k * stride];
+                  for( SizeValueType i = 0; i < sumLineLength; ++i )
+                    {
+                    sum[i] += previous[i];
+                    }
+                  }
+                }
+              }
+            } );
+          }
+        const std::vector<RealValueType> & boxSum = boxSums[( ImageDimension - 1 ) % 2];
+        const RealValueType squaredWeight = tapSquaredWeights.empty() ? 0 : tapSquaredWeights[0];
+        ForEachLineInRegion( validRegion, [&]( const IndexType & line )
+          {
+          const OffsetValueType tilePos = position( tile, tileStride, line );
+          const OffsetValueType differencePos = position( differenceRegion, differenceStride, line );
+          for( unsigned int ic = 0; ic < numComponents; ++ic )
+            {
+            RealValueType *       distance = &distances[ic * numberOfTilePixels + tilePos];
+            const RealValueType * sum = &boxSum[ic * numberOfDifferences + differencePos];
+            for( SizeValueType i = 0; i < lineLength; ++i )
+              {
+              distance[i] = squaredWeight * sum[i];
+              }
+            }
+          } );
+        }
+      else
+        {
+        ForEachLineInRegion( validRegion, [&]( const IndexType & line )
+          {
+          const OffsetValueType tilePos = position( tile, tileStride, line );
+          const OffsetValueType differencePos = position( differenceRegion, differenceStride, line );
+          for( unsigned int ic = 0; ic < numComponents; ++ic )
+            {
+            RealValueType *distance = &distances[ic * numberOfTilePixels + tilePos];
+            std::fill( distance, distance + lineLength, NumericTraits<RealValueType>::ZeroValue() );
+            for( size_t tap = 0; tap < tapPositions.size(); ++tap )
+              {
+              const RealValueType   squaredWeight = tapSquaredWeights[tap];
+              const RealValueType * difference =
+                &differences[ic * numberOfDifferences + differencePos + tapPositions[tap]];
+              for( SizeValueType i = 0; i < lineLength; ++i )
+                {
+                distance[i] += squaredWeight * difference[i] * difference[i];
+                }
+              }
+            }
+          } );
+        }
+
+      // Accumulate the Gaussian weights and the weighted center differences.
+      ForEachLineInRegion( validRegion, [&]( const IndexType & line )
+        {
+        const OffsetValueType tilePos = position( tile, tileStride, line );
+        const OffsetValueType differencePos = position( differenceRegion, differenceStride, line );
+        OffsetValueType       bufferPos = 0;
+        bool                  isLineInterior = true;
+        for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+          {
+          bufferPos += ( line[dim] - bufferIndex[dim] ) * bufferOffsetTable[dim];
+          if( dim > 0 )
+            {
+            const IndexValueType relative = line[dim] - imageIndex[dim];
+            isLineInterior = isLineInterior
+              && relative >= static_cast<IndexValueType>( patchRadius[dim] )
+              && relative + static_cast<IndexValueType>( patchRadius[dim] ) < static_cast<IndexValueType>( imageSize[dim] );
+            }
+          }
+        for( SizeValueType i = 0; i < lineLength; ++i )
+          {
+          if( preselect && isLineInterior )
+            {
+            const IndexValueType relative = line[0] + static_cast<IndexValueType>( i ) - imageIndex[0];
+            if( relative >= static_cast<IndexValueType>( patchRadius[0] )
+                && relative + static_cast<IndexValueType>( patchRadius[0] ) < static_cast<IndexValueType>( imageSize[0] )
+                && this->IsRejectedByPatchMeans( bufferPos + i, bufferPos + i + bufferShift ) )
+              {
+              continue;
+              }
+            }
+          const SizeValueType tilePixel = tilePos + i;
+          RealValueType distanceJointEntropy = 0.0;
+          RealValueType gaussianJointEntropy = 0.0;
+          for( unsigned int ic = 0; ic < numComponents; ++ic )
+            {
+            distanceJointEntropy += distances[ic * numberOfTilePixels + tilePixel] / sigmaSquared[ic];
+            gaussianJointEntropy = std::exp( -distanceJointEntropy / 2.0 );
+            sumOfGaussians[tilePixel] += gaussianJointEntropy;
+            }
+          for( unsigned int pc = 0; pc < numComponents; ++pc )
+            {
+            tileGradients[pc * numberOfTilePixels + tilePixel] +=
+              differences[pc * numberOfDifferences + differencePos + i] * gaussianJointEntropy;
+            }
+          }
+        } );
+      } // end for each search offset
+
+    const SizeValueType tileLineLength = tile.GetSize()[0];
+    ForEachLineInRegion( tile, [&]( const IndexType & line )
+      {
+      const OffsetValueType tilePos = position( tile, tileStride, line );
+      const OffsetValueType regionPos = position( regionToProcess, regionStride, line );
+      for( SizeValueType i = 0; i < tileLineLength; ++i )
+        {
+        for( unsigned int pc = 0; pc < numComponents; ++pc )
+          {
+          gradients[( regionPos + i ) * numComponents + pc] =
+            tileGradients[pc * numberOfTilePixels + tilePos + i]
+            / ( sumOfGaussians[tilePos + i] + m_MinProbability );
+          }
+        }
+      } );
+    } // end for each tile
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::ComputePatchMeans()
+{
+  const PatchWeightsType patchWeights = this->GetPatchWeights();
+  RealValueType          sumOfSquaredWeights = 0.0;
+  for( unsigned int jj = 0; jj < this->GetPatchLengthInVoxels(); ++jj )
+    {
+    const RealValueType weight = patchWeights[jj];
+    sumOfSquaredWeights += weight * weight;
+    }
+
+  // A patch whose first component mean differs by more than this from the
+  // mean of the patch being denoised has a weight below the threshold.
+  m_PatchPreselectionDistance = -2.0 * std::log( m_PatchPreselectionThreshold )
+    * itk::Math::sqr( m_KernelBandwidthSigma[0] ) / sumOfSquaredWeights;
+  m_PatchMeans.assign( this->m_OutputImage->GetBufferedRegion().GetNumberOfPixels(),
+                       NumericTraits<RealValueType>::ZeroValue() );
+
+  ThreadFilterStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->ComputePatchMeansThreaderCallback,
+                                            &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template <typename TInputImage, typename TOutputImage>
+ITK_THREAD_RETURN_TYPE
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::ComputePatchMeansThreaderCallback( void * arg )
+{
+  const unsigned int threadId = ( (MultiThreaderBase::ThreadInfoStruct *)(arg) )->ThreadID;
+  const unsigned int threadCount = ( (MultiThreaderBase::ThreadInfoStruct *)(arg) )->NumberOfThreads;
+
+  const ThreadFilterStruct *str =
+    (ThreadFilterStruct *)( ( (MultiThreaderBase::ThreadInfoStruct *)(arg) )->UserData);
+
+  InputImageRegionType splitRegion;
+
+  const unsigned int total =
+    str->Filter->SplitRequestedRegion(threadId, threadCount, splitRegion);
+
+  if (threadId < total)
+    {
+    str->Filter->ThreadedComputePatchMeans(splitRegion);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
+::ThreadedComputePatchMeans(const InputImageRegionType &regionToProcess)
+{
+  const OutputImageType *output = this->m_OutputImage;
+  const PatchWeightsType patchWeights = this->GetPatchWeights();
+  const unsigned int     lengthPatch = this->GetPatchLengthInVoxels();
+
+  std::vector<RealValueType> squaredWeights( lengthPatch );
+  RealValueType              sumOfSquaredWeights = 0.0;
+  for( unsigned int jj = 0; jj < lengthPatch; ++jj )
+    {
+    const RealValueType weight = patchWeights[jj];
+    squaredWeights[jj] = weight * weight;
+    sumOfSquaredWeights += squaredWeights[jj];
+    }
+
+  // Only the means of patches entirely inside the image are used.
+  ConstNeighborhoodIterator<OutputImageType> patchIt( this->GetPatchRadiusInVoxels(), output, regionToProcess );
+  for( patchIt.GoToBegin(); !patchIt.IsAtEnd(); ++patchIt )
+    {
+    if( !patchIt.InBounds() )
+      {
+      continue;
+      }
+    RealValueType sum = 0.0;
+    for( unsigned int jj = 0; jj < lengthPatch; ++jj )
+      {
+      sum += squaredWeights[jj] * this->GetComponent( patchIt.GetPixel( jj ), 0 );
+      }
+    m_PatchMeans[output->ComputeOffset( patchIt.GetIndex() )] = sum / sumOfSquaredWeights;
+    }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
@@ -2518,6 +3149,17 @@ PatchBasedDenoisingImageFilter<TInputImage, TOutputImage>
     os << indent << "UseFastTensorComputations: Off" << std::endl;
     }
 
+  if( m_UseSearchWindowPatchDistances )
+    {
+    os << indent << "UseSearchWindowPatchDistances: On" << std::endl;
+    }
+  else
+    {
+    os << indent << "UseSearchWindowPatchDistances: Off" << std::endl;
+    }
+  os << indent << "PatchPreselectionThreshold: "
+     << m_PatchPreselectionThreshold << std::endl;
+
   os << indent << "Kernel bandwidth sigma: "
      << m_KernelBandwidthSigma << std::endl;
   if( m_KernelBandwidthSigmaIsSet )
@@ -0,0 +1,224 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkSpatialNeighborSubsampler.h"
+#include "itkPatchBasedDenoisingImageFilter.h"
+#include "itkTestingMacros.h"
+
+// Compares the search window computation of the patch distances with the
+// per-pixel computation of PatchBasedDenoisingImageFilter.
+
+namespace
+{
+
+template< typename TImage >
+typename TImage::Pointer
+CreateNoisyImage( const typename TImage::SizeType & size )
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits< typename TImage::PixelType >;
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  const unsigned int numberOfComponents =
+    PixelTraits::GetNumberOfComponents();
+
+  itk::ImageRegionIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    bool insideBox = true;
+    for( unsigned int dim = 0; dim < TImage::ImageDimension; ++dim )
+      {
+      insideBox = insideBox && index[dim] > static_cast< itk::IndexValueType >( size[dim] / 4 )
+        && index[dim] < static_cast< itk::IndexValueType >( 3 * size[dim] / 4 );
+      }
+    typename TImage::PixelType pixel = it.Get();
+    for( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double value = ( insideBox ? 100.0 + 20.0 * c : 20.0 ) + generator->GetNormalVariate( 0.0, 100.0 );
+      PixelTraits::SetNthComponent( c, pixel, value );
+      }
+    it.Set( pixel );
+    }
+  return image;
+}
+
+template< typename TImage >
+typename TImage::Pointer
+Denoise( const TImage * input, bool useSmoothDiscPatchWeights,
+         bool useSearchWindowPatchDistances, double patchPreselectionThreshold )
+{
+  using FilterType = itk::PatchBasedDenoisingImageFilter< TImage, TImage >;
+  using SamplerType = itk::Statistics::SpatialNeighborSubsampler<
+    typename FilterType::PatchSampleType, typename TImage::RegionType >;
+
+  typename SamplerType::Pointer sampler = SamplerType::New();
+  sampler->SetRadius( 4 );
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetPatchRadius( 2 );
+  filter->SetUseSmoothDiscPatchWeights( useSmoothDiscPatchWeights );
+  filter->SetNoiseModel( FilterType::GAUSSIAN );
+  filter->SetNoiseModelFidelityWeight( 0.1 );
+  filter->SetNumberOfIterations( 2 );
+  filter->SetSampler( sampler );
+  filter->SetUseSearchWindowPatchDistances( useSearchWindowPatchDistances );
+  filter->SetPatchPreselectionThreshold( patchPreselectionThreshold );
+  filter->Update();
+
+  return filter->GetOutput();
+}
+
+template< typename TImage >
+double
+MaximumDifference( const TImage * image1, const TImage * image2 )
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits< typename TImage::PixelType >;
+  const unsigned int numberOfComponents =
+    PixelTraits::GetNumberOfComponents();
+
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image2->GetLargestPossibleRegion() );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    for( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double difference =
+        PixelTraits::GetNthComponent( c, it1.Get() ) -
+        PixelTraits::GetNthComponent( c, it2.Get() );
+      maximumDifference = std::max( maximumDifference, std::abs( difference ) );
+      }
+    }
+  return maximumDifference;
+}
+
+template< typename TImage >
+bool
+CompareSearchWindowAndPerPixel( const typename TImage::SizeType & size,
+                                bool useSmoothDiscPatchWeights, double tolerance )
+{
+  const typename TImage::Pointer input = CreateNoisyImage< TImage >( size );
+
+  const typename TImage::Pointer perPixel =
+    Denoise< TImage >( input, useSmoothDiscPatchWeights, false, 0.0 );
+  const typename TImage::Pointer searchWindow =
+    Denoise< TImage >( input, useSmoothDiscPatchWeights, true, 0.0 );
+
+  const double difference = MaximumDifference< TImage >( perPixel, searchWindow );
+  std::cout << "Size " << size << ", smooth disc weights " << useSmoothDiscPatchWeights
+            << ": maximum difference " << difference << std::endl;
+  if( difference > tolerance )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Search window and per-pixel results differ by " << difference
+              << ", more than " << tolerance << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end namespace
+
+int itkPatchBasedDenoisingImageFilterSearchWindowTest( int, char* [] )
+{
+  using ImageType = itk::Image< float, 2 >;
+  using FilterType = itk::PatchBasedDenoisingImageFilter< ImageType, ImageType >;
+
+  FilterType::Pointer filter = FilterType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( filter, PatchBasedDenoisingImageFilter,
+    PatchBasedDenoisingBaseImageFilter );
+
+  bool useSearchWindowPatchDistances = false;
+  TEST_SET_GET_BOOLEAN( filter, UseSearchWindowPatchDistances,
+    useSearchWindowPatchDistances );
+
+  double patchPreselectionThreshold = 1e-3;
+  filter->SetPatchPreselectionThreshold( patchPreselectionThreshold );
+  TEST_SET_GET_VALUE( patchPreselectionThreshold, filter->GetPatchPreselectionThreshold() );
+
+  bool testPassed = true;
+
+  // Smooth disc weights use the patch taps directly, uniform weights use
+  // separable box sums.
+  ImageType::SizeType size2D;
+  size2D[0] = 45;
+  size2D[1] = 37;
+  testPassed &= CompareSearchWindowAndPerPixel< ImageType >( size2D, true, 1e-4 );
+  testPassed &= CompareSearchWindowAndPerPixel< ImageType >( size2D, false, 1e-3 );
+
+  using Image3DType = itk::Image< float, 3 >;
+  Image3DType::SizeType size3D;
+  size3D[0] = 19;
+  size3D[1] = 14;
+  size3D[2] = 11;
+  testPassed &= CompareSearchWindowAndPerPixel< Image3DType >( size3D, true, 1e-4 );
+  testPassed &= CompareSearchWindowAndPerPixel< Image3DType >( size3D, false, 1e-3 );
+
+  using VectorImageType = itk::Image< itk::Vector< float, 2 >, 2 >;
+  testPassed &= CompareSearchWindowAndPerPixel< VectorImageType >( size2D, true, 1e-4 );
+
+  // Both computations skip the same candidate patches when preselecting, and
+  // the skipped patches only carry small weights.
+  const ImageType::Pointer input = CreateNoisyImage< ImageType >( size2D );
+  const ImageType::Pointer exhaustive = Denoise< ImageType >( input, true, true, 0.0 );
+  const ImageType::Pointer perPixelPreselected = Denoise< ImageType >( input, true, false, 1e-3 );
+  const ImageType::Pointer searchWindowPreselected = Denoise< ImageType >( input, true, true, 1e-3 );
+
+  const double preselectionDifference =
+    MaximumDifference< ImageType >( perPixelPreselected, searchWindowPreselected );
+  std::cout << "Preselection: maximum difference " << preselectionDifference << std::endl;
+  if( preselectionDifference > 1e-4 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Preselected search window and per-pixel results differ by "
+              << preselectionDifference << std::endl;
+    testPassed = false;
+    }
+
+  const double approximationError = MaximumDifference< ImageType >( exhaustive, searchWindowPreselected );
+  std::cout << "Preselection: maximum difference to the exhaustive search "
+            << approximationError << std::endl;
+  if( approximationError > 1.0 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Preselection changed the result by " << approximationError << std::endl;
+    testPassed = false;
+    }
+
+  if( !testPassed )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
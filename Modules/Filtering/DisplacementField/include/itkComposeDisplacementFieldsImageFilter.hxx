@@ -22,7 +22,8 @@
 
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
-#include "itkVectorLinearInterpolateImageFunction.h"
+
+#include <cstring>
 
 namespace itk
 {
@@ -32,11 +33,11 @@ namespace itk
  */
 template<typename InputImage, typename TOutputImage>
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
-::ComposeDisplacementFieldsImageFilter()
+::ComposeDisplacementFieldsImageFilter() :
+  m_UseLinearSampler( false )
 {
   this->SetNumberOfRequiredInputs( 2 );
 
-  using DefaultInterpolatorType = VectorLinearInterpolateImageFunction<InputFieldType, RealType>;
   typename DefaultInterpolatorType::Pointer interpolator = DefaultInterpolatorType::New();
   this->m_Interpolator = interpolator;
 }
@@ -69,14 +70,22 @@ void
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
 ::BeforeThreadedGenerateData()
 {
-  VectorType zeroVector( 0.0 );
-
-  this->GetOutput()->FillBuffer( zeroVector );
-
+  // Every output voxel is written by ThreadedGenerateData(), so the output
+  // buffer is not cleared beforehand.
   if( !this->m_Interpolator->GetInputImage() )
     {
     itkExceptionMacro( "Displacement field not set in interpolator." );
     }
+
+  // Subclasses of the default interpolator may override the evaluation, so
+  // the direct sampler is only substituted for the exact default type.
+  this->m_UseLinearSampler =
+    dynamic_cast<DefaultInterpolatorType *>( this->m_Interpolator.GetPointer() ) != nullptr &&
+    std::strcmp( this->m_Interpolator->GetNameOfClass(), "VectorLinearInterpolateImageFunction" ) == 0;
+  if( this->m_UseLinearSampler )
+    {
+    this->m_LinearSampler.SetField( this->m_Interpolator->GetInputImage() );
+    }
 }
 
 template<typename InputImage, typename TOutputImage>
@@ -108,7 +117,11 @@ ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
       }
 
     typename InterpolatorType::OutputType displacement( 0.0 );
-    if( this->m_Interpolator->IsInsideBuffer( pointIn2 ) )
+    if( this->m_UseLinearSampler )
+      {
+      this->m_LinearSampler.Evaluate( pointIn2, displacement );
+      }
+    else if( this->m_Interpolator->IsInsideBuffer( pointIn2 ) )
       {
       displacement = this->m_Interpolator->Evaluate( pointIn2 );
       }
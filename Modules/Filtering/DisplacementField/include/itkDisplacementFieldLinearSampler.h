@@ -0,0 +1,249 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldLinearSampler_h
+#define itkDisplacementFieldLinearSampler_h
+
+#include "itkVectorLinearInterpolateImageFunction.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * \class DisplacementFieldLinearSampler
+ *
+ * \brief Non-virtual, buffer-level linear sampling of a displacement field.
+ *
+ * This helper reproduces VectorLinearInterpolateImageFunction::IsInsideBuffer()
+ * followed by VectorLinearInterpolateImageFunction::Evaluate() bit for bit,
+ * and VectorLinearInterpolateNearestNeighborExtrapolateImageFunction::Evaluate()
+ * through EvaluateWithNearestNeighborExtrapolation(), but maps the point to a continuous index only once and reads the corner
+ * vectors straight from the pixel buffer through the offset table instead of
+ * going through virtual calls and Image::GetPixel(). It is intended for the
+ * inner loops of the filters in this module which resample one field at the
+ * points given by another one (composition, inversion, exponentiation).
+ *
+ * The sampled field must not be modified or reallocated while the sampler is
+ * in use.  Evaluate() is const and may be called concurrently.
+ *
+ * \ingroup ITKDisplacementField
+ */
+template <typename TField, typename TCoordRep = double>
+class DisplacementFieldLinearSampler
+{
+public:
+  using Self = DisplacementFieldLinearSampler;
+
+  using FieldType = TField;
+  using InterpolatorType = VectorLinearInterpolateImageFunction<FieldType, TCoordRep>;
+
+  static constexpr unsigned int ImageDimension = InterpolatorType::ImageDimension;
+  static constexpr unsigned int Dimension = InterpolatorType::Dimension;
+
+  using PixelType = typename FieldType::PixelType;
+  using IndexType = typename FieldType::IndexType;
+  using PointType = typename InterpolatorType::PointType;
+  using ContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
+  using InternalComputationType = typename InterpolatorType::InternalComputationType;
+  using RealType = typename InterpolatorType::RealType;
+  using OutputType = typename InterpolatorType::OutputType;
+
+  DisplacementFieldLinearSampler() :
+    m_Field( nullptr ),
+    m_Buffer( nullptr )
+    {
+    }
+
+  /** Cache the buffer layout of \c field.  Must be called again whenever the
+   * field is reallocated. */
+  void SetField( const FieldType * field )
+    {
+    this->m_Field = field;
+    this->m_Buffer = field->GetBufferPointer();
+
+    const typename FieldType::RegionType & region = field->GetBufferedRegion();
+    const typename FieldType::OffsetValueType * offsetTable = field->GetOffsetTable();
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      this->m_StartIndex[d] = region.GetIndex()[d];
+      this->m_EndIndex[d] = this->m_StartIndex[d] + static_cast<IndexValueType>( region.GetSize()[d] ) - 1;
+      this->m_StartContinuousIndex[d] = static_cast<TCoordRep>( this->m_StartIndex[d] - 0.5 );
+      this->m_EndContinuousIndex[d] = static_cast<TCoordRep>( this->m_EndIndex[d] + 0.5 );
+      this->m_OffsetTable[d] = offsetTable[d];
+      }
+    }
+
+  const FieldType * GetField() const
+    {
+    return this->m_Field;
+    }
+
+  /** Interpolate the field at \c point.  Returns false, leaving \c output
+   * untouched, if the point falls outside the buffered region. */
+  inline bool Evaluate( const PointType & point, OutputType & output ) const
+    {
+    ContinuousIndexType cindex;
+    this->m_Field->TransformPhysicalPointToContinuousIndex( point, cindex );
+
+    OffsetValueType lowerOffset[ImageDimension];
+    OffsetValueType upperOffset[ImageDimension];
+    InternalComputationType distance[ImageDimension];
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      // Test for negative of a positive so we can catch NaN's.
+      if( ! ( cindex[d] >= this->m_StartContinuousIndex[d] && cindex[d] < this->m_EndContinuousIndex[d] ) )
+        {
+        return false;
+        }
+      const IndexValueType baseIndex = Math::Floor<IndexValueType>( cindex[d] );
+      distance[d] = cindex[d] - static_cast<InternalComputationType>( baseIndex );
+
+      // Inside the buffer the lower neighbor can only fall below the start
+      // index and the upper one can only exceed the end index.
+      const IndexValueType lowerIndex = std::max( baseIndex, this->m_StartIndex[d] );
+      const IndexValueType upperIndex = std::min( baseIndex + 1, this->m_EndIndex[d] );
+      lowerOffset[d] = ( lowerIndex - this->m_StartIndex[d] ) * this->m_OffsetTable[d];
+      upperOffset[d] = ( upperIndex - this->m_StartIndex[d] ) * this->m_OffsetTable[d];
+      }
+
+    using ScalarRealType = typename NumericTraits<PixelType>::ScalarRealType;
+    ScalarRealType totalOverlap = NumericTraits<ScalarRealType>::ZeroValue();
+
+    output.Fill( 0.0 );
+    for( unsigned int counter = 0; counter < ( 1u << ImageDimension ); ++counter )
+      {
+      InternalComputationType overlap = 1.0;
+      OffsetValueType offset = 0;
+      unsigned int upper = counter;
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        if( upper & 1 )
+          {
+          offset += upperOffset[d];
+          overlap *= distance[d];
+          }
+        else
+          {
+          offset += lowerOffset[d];
+          overlap *= 1.0 - distance[d];
+          }
+        upper >>= 1;
+        }
+
+      if( overlap )
+        {
+        const PixelType & input = this->m_Buffer[offset];
+        for( unsigned int k = 0; k < Dimension; k++ )
+          {
+          output[k] += overlap * static_cast<InternalComputationType>( input[k] );
+          }
+        totalOverlap += overlap;
+        }
+
+      if( totalOverlap == 1.0 )
+        {
+        break;
+        }
+      }
+    return true;
+    }
+
+  /** Interpolate the field at \c point, using the value of the nearest
+   * boundary voxel along the dimensions where the point falls outside the
+   * buffered region. */
+  inline void EvaluateWithNearestNeighborExtrapolation( const PointType & point, OutputType & output ) const
+    {
+    ContinuousIndexType cindex;
+    this->m_Field->TransformPhysicalPointToContinuousIndex( point, cindex );
+
+    OffsetValueType lowerOffset[ImageDimension];
+    OffsetValueType upperOffset[ImageDimension];
+    double distance[ImageDimension];
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      IndexValueType baseIndex = Math::Floor<IndexValueType>( cindex[d] );
+      if( baseIndex >= this->m_StartIndex[d] && baseIndex < this->m_EndIndex[d] )
+        {
+        distance[d] = cindex[d] - static_cast<double>( baseIndex );
+        lowerOffset[d] = ( baseIndex - this->m_StartIndex[d] ) * this->m_OffsetTable[d];
+        upperOffset[d] = lowerOffset[d] + this->m_OffsetTable[d];
+        }
+      else
+        {
+        baseIndex = ( baseIndex < this->m_StartIndex[d] ) ? this->m_StartIndex[d] : this->m_EndIndex[d];
+        distance[d] = 0.0;
+        lowerOffset[d] = ( baseIndex - this->m_StartIndex[d] ) * this->m_OffsetTable[d];
+        // Never read: the upper neighbor has a zero weight.
+        upperOffset[d] = lowerOffset[d];
+        }
+      }
+
+    RealType totalOverlap = 0.0;
+
+    output.Fill( 0.0 );
+    for( unsigned int counter = 0; counter < ( 1u << ImageDimension ); ++counter )
+      {
+      double overlap = 1.0;
+      OffsetValueType offset = 0;
+      unsigned int upper = counter;
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        if( upper & 1 )
+          {
+          offset += upperOffset[d];
+          overlap *= distance[d];
+          }
+        else
+          {
+          offset += lowerOffset[d];
+          overlap *= 1.0 - distance[d];
+          }
+        upper >>= 1;
+        }
+
+      if( overlap )
+        {
+        const PixelType & input = this->m_Buffer[offset];
+        for( unsigned int k = 0; k < Dimension; k++ )
+          {
+          output[k] += overlap * static_cast<RealType>( input[k] );
+          }
+        totalOverlap += overlap;
+        }
+
+      if( totalOverlap == 1.0 )
+        {
+        break;
+        }
+      }
+    }
+
+private:
+  const FieldType *  m_Field;
+  const PixelType *  m_Buffer;
+  IndexValueType     m_StartIndex[ImageDimension];
+  IndexValueType     m_EndIndex[ImageDimension];
+  TCoordRep          m_StartContinuousIndex[ImageDimension];
+  TCoordRep          m_EndContinuousIndex[ImageDimension];
+  OffsetValueType    m_OffsetTable[ImageDimension];
+};
+
+} // end namespace itk
+
+#endif
@@ -18,11 +18,9 @@
 #ifndef itkExponentialDisplacementFieldImageFilter_h
 #define itkExponentialDisplacementFieldImageFilter_h
 
-#include "itkDivideImageFilter.h"
-#include "itkCastImageFilter.h"
-#include "itkWarpVectorImageFilter.h"
-#include "itkVectorLinearInterpolateNearestNeighborExtrapolateImageFunction.h"
-#include "itkAddImageFilter.h"
+#include "itkImageToImageFilter.h"
+#include "itkDisplacementFieldLinearSampler.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -48,6 +46,12 @@ namespace itk
  *    \f]
  *
  *
+ * The scaling and the squarings are computed in place by multithreaded
+ * passes that alternate between the output and a single scratch field: each
+ * squaring evaluates exp(Phi)(x) + exp(Phi)(x + exp(Phi)(x)) with a direct
+ * linear sampler of the previous field.  The number of squarings is adapted
+ * to the magnitude of the field when AutomaticNumberOfIterations is on.
+ *
  * This filter expects both the input and output images to be of pixel type
  * Vector.
  *
@@ -139,43 +143,36 @@ protected:
    */
   void GenerateData() override;
 
-  using RegionType = typename InputImageType::RegionType;
-
-  using DivideByConstantType = DivideImageFilter<
-    InputImageType,
-    itk::Image<InputPixelRealValueType, ImageDimension>,
-    OutputImageType >;
-
-  using CasterType = CastImageFilter<
-    InputImageType, OutputImageType >;
+  /** Run one of the threaded stages selected by GenerateData(). */
+  void ThreadedGenerateData(const typename OutputImageType::RegionType & outputRegionForThread,
+                            ThreadIdType threadId) override;
 
-  using VectorWarperType = WarpVectorImageFilter<
-    OutputImageType,
-    OutputImageType, OutputImageType >;
+  using RegionType = typename InputImageType::RegionType;
 
-  using FieldInterpolatorType = VectorLinearInterpolateNearestNeighborExtrapolateImageFunction<
-    OutputImageType, double >;
+  using FieldSamplerType = DisplacementFieldLinearSampler< OutputImageType, double >;
 
-  using AdderType = AddImageFilter<
-    OutputImageType, OutputImageType, OutputImageType >;
+private:
+  /** Stages of the threaded computation. */
+  enum ThreadedStageType {
+    ComputeMaximumSquaredNorm,
+    ScaleInput,
+    SquareField
+    };
 
-  using DivideByConstantPointer = typename DivideByConstantType::Pointer;
-  using CasterPointer = typename CasterType::Pointer;
-  using VectorWarperPointer = typename VectorWarperType::Pointer;
-  using FieldInterpolatorPointer = typename FieldInterpolatorType::Pointer;
-  using FieldInterpolatorOutputType = typename FieldInterpolatorType::OutputType;
-  using AdderPointer = typename AdderType::Pointer;
+  /** Run one threaded stage over the output requested region. */
+  void ExecuteThreadedStage(ThreadedStageType stage);
 
-private:
   bool         m_AutomaticNumberOfIterations;
   unsigned int m_MaximumNumberOfIterations;
 
   bool m_ComputeInverse;
 
-  DivideByConstantPointer m_Divider;
-  CasterPointer           m_Caster;
-  VectorWarperPointer     m_Warper;
-  AdderPointer            m_Adder;
+  ThreadedStageType       m_ThreadedStage;
+  InputPixelRealValueType m_MaximumSquaredNorm;
+  InputPixelRealValueType m_Divisor;
+  OutputImageType *       m_SquaringOutputField;
+  FieldSamplerType        m_SquaringInputSampler;
+  SimpleFastMutexLock     m_Mutex;
 };
 } // end namespace itk
 
@@ -21,6 +21,9 @@
 #include "itkExponentialDisplacementFieldImageFilter.h"
 #include "itkProgressReporter.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMutexLockHolder.h"
 
 namespace itk
 {
@@ -34,16 +37,11 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
   m_AutomaticNumberOfIterations = true;
   m_MaximumNumberOfIterations = 20;
   m_ComputeInverse = false;
-  m_Divider = DivideByConstantType::New();
-  m_Caster = CasterType::New();
-  m_Warper = VectorWarperType::New();
 
-  FieldInterpolatorPointer VectorInterpolator =
-    FieldInterpolatorType::New();
-  m_Warper->SetInterpolator(VectorInterpolator);
-
-  m_Adder = AdderType::New();
-  m_Adder->InPlaceOn();
+  m_ThreadedStage = ComputeMaximumSquaredNorm;
+  m_MaximumSquaredNorm = 0.0;
+  m_Divisor = 1.0;
+  m_SquaringOutputField = nullptr;
 }
 
 /**
@@ -78,6 +76,9 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
 
   InputImageConstPointer inputPtr = this->GetInput();
 
+  this->AllocateOutputs();
+  OutputImageType *outputPtr = this->GetOutput();
+
   unsigned int numiter = 0;
 
   if ( m_AutomaticNumberOfIterations )
@@ -88,8 +89,6 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
     // needs to be diffeomorphic. For this we simply impose to have
     // max(norm(Phi)/2^N) < 0.5*pixelspacing
 
-    InputPixelRealValueType maxnorm2 = 0.0;
-
     double minpixelspacing = inputPtr->GetSpacing()[0];
     for ( unsigned int i = 1; i < Self::ImageDimension; ++i )
       {
@@ -99,15 +98,9 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
         }
       }
 
-    using InputConstIterator = ImageRegionConstIterator< InputImageType >;
-    InputConstIterator InputIt = InputConstIterator(
-      inputPtr, inputPtr->GetRequestedRegion() );
-
-    for ( InputIt.GoToBegin(); !InputIt.IsAtEnd(); ++InputIt )
-      {
-      InputPixelRealValueType norm2 = InputIt.Get().GetSquaredNorm();
-      if ( norm2 > maxnorm2 ) { maxnorm2 = norm2; }
-      }
+    m_MaximumSquaredNorm = 0.0;
+    this->ExecuteThreadedStage(ComputeMaximumSquaredNorm);
+    InputPixelRealValueType maxnorm2 = m_MaximumSquaredNorm;
 
     // Divide the norm by the minimum pixel spacing
     maxnorm2 /= itk::Math::sqr(minpixelspacing);
@@ -134,90 +127,138 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
 
   ProgressReporter progress(this, 0, numiter + 1, numiter + 1);
 
-  if ( numiter == 0 )
+  // Each squaring reads the whole previous field, so it cannot be done in
+  // place; the passes alternate between the output and one scratch field.
+  // The first order approximation is written to whichever of the two makes
+  // the last squaring land in the output.
+  OutputImagePointer scratchField;
+  if ( numiter > 0 )
     {
-    if ( !this->m_ComputeInverse )
-      {
-      m_Caster->SetInput(inputPtr);
-      m_Caster->GraftOutput( this->GetOutput() );
-      m_Caster->Update();
-      // Region passing stuff
-      this->GraftOutput( m_Caster->GetOutput() );
-      }
-    else
-      {
-      // We only need the opposite. Here we use the
-      // divider for simplicity. If a filter appears in ITK
-      // to compute the opposite, we should use it.
-      m_Divider->SetInput(inputPtr);
-      m_Divider->SetInput2( static_cast< InputPixelRealValueType >( -1 ) );
-      m_Divider->GraftOutput( this->GetOutput() );
-      m_Divider->Update();
-      // Region passing stuff
-      this->GraftOutput( m_Divider->GetOutput() );
-      }
-
-    this->GetOutput()->Modified();
-
-    progress.CompletedPixel();
-    return;
+    scratchField = OutputImageType::New();
+    scratchField->CopyInformation(outputPtr);
+    scratchField->SetBufferedRegion( outputPtr->GetBufferedRegion() );
+    scratchField->SetRequestedRegion( outputPtr->GetRequestedRegion() );
+    scratchField->Allocate();
     }
 
+  OutputImageType *currentField = ( numiter % 2 == 0 ) ? outputPtr : scratchField.GetPointer();
+  OutputImageType *nextField = ( numiter % 2 == 0 ) ? scratchField.GetPointer() : outputPtr;
+
   // Get the first order approximation (division by 2^numiter)
-  m_Divider->SetInput(inputPtr);
-  m_Divider->GraftOutput( this->GetOutput() );
-  if ( !this->m_ComputeInverse )
+  if ( numiter == 0 )
     {
-    m_Divider->SetInput2( static_cast< InputPixelRealValueType >( 1 << numiter ) );
+    m_Divisor = static_cast< InputPixelRealValueType >( 1 );
     }
   else
     {
-    m_Divider->SetInput2( -static_cast< InputPixelRealValueType >( 1 << numiter ) );
+    m_Divisor = static_cast< InputPixelRealValueType >( 1 << numiter );
     }
-
-  m_Divider->Update();
-
-  // Region passing stuff
-  this->GraftOutput( m_Divider->GetOutput() );
-  this->GetOutput()->Modified();
+  if ( this->m_ComputeInverse )
+    {
+    m_Divisor = -m_Divisor;
+    }
+  m_SquaringOutputField = currentField;
+  this->ExecuteThreadedStage(ScaleInput);
 
   progress.CompletedPixel();
 
   // Do the iterative composition of the vector field
-  m_Warper->SetOutputOrigin( inputPtr->GetOrigin() );
-  m_Warper->SetOutputSpacing( inputPtr->GetSpacing() );
-  m_Warper->SetOutputDirection( inputPtr->GetDirection() );
-
   for ( unsigned int i = 0; i < numiter; i++ )
     {
-    m_Warper->SetInput( this->GetOutput() );
-    m_Warper->SetDisplacementField( this->GetOutput() );
+    m_SquaringInputSampler.SetField(currentField);
+    m_SquaringOutputField = nextField;
+    this->ExecuteThreadedStage(SquareField);
 
-    m_Warper->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
+    std::swap(currentField, nextField);
 
-    m_Warper->Update();
+    progress.CompletedPixel();
+    }
 
-    OutputImagePointer warpedIm = m_Warper->GetOutput();
-    warpedIm->DisconnectPipeline();
+  m_SquaringOutputField = nullptr;
+}
 
-    // Remember we chose to use an inplace adder
-    m_Adder->SetInput1( this->GetOutput() );
+template< typename TInputImage, typename TOutputImage >
+void
+ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::ExecuteThreadedStage(ThreadedStageType stage)
+{
+  m_ThreadedStage = stage;
+
+  typename Superclass::ThreadStruct str;
+  str.Filter = this;
 
-    m_Adder->SetInput2(warpedIm);
-    m_Adder->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
 
-    m_Adder->Update();
+template< typename TInputImage, typename TOutputImage >
+void
+ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const typename OutputImageType::RegionType & outputRegionForThread,
+                       ThreadIdType itkNotUsed(threadId))
+{
+  InputImageConstPointer inputPtr = this->GetInput();
 
-    // Region passing stuff
-    this->GraftOutput( m_Adder->GetOutput() );
+  switch ( m_ThreadedStage )
+    {
+    case ComputeMaximumSquaredNorm:
+      {
+      InputPixelRealValueType maxnorm2 = 0.0;
 
-    // Make a call to modified. This seems only necessary for
-    // a non-inplace adder but it doesn't hurt anyhow.
-    this->GetOutput()->Modified();
+      ImageRegionConstIterator< InputImageType > InputIt(inputPtr, outputRegionForThread);
+      for ( InputIt.GoToBegin(); !InputIt.IsAtEnd(); ++InputIt )
+        {
+        InputPixelRealValueType norm2 = InputIt.Get().GetSquaredNorm();
+        if ( norm2 > maxnorm2 ) { maxnorm2 = norm2; }
+        }
 
-    progress.CompletedPixel();
+      MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+      if ( maxnorm2 > m_MaximumSquaredNorm ) { m_MaximumSquaredNorm = maxnorm2; }
+      break;
+      }
+    case ScaleInput:
+      {
+      ImageRegionConstIterator< InputImageType > InputIt(inputPtr, outputRegionForThread);
+      ImageRegionIterator< OutputImageType > OutputIt(m_SquaringOutputField, outputRegionForThread);
+      for ( InputIt.GoToBegin(), OutputIt.GoToBegin(); !InputIt.IsAtEnd(); ++InputIt, ++OutputIt )
+        {
+        OutputIt.Set( static_cast< OutputPixelType >( InputIt.Get() / m_Divisor ) );
+        }
+      break;
+      }
+    case SquareField:
+      {
+      // exp(Phi)(x) + exp(Phi)(x + exp(Phi)(x)), with the field extrapolated
+      // by its nearest boundary value.
+      const OutputImageType *currentField = m_SquaringInputSampler.GetField();
+
+      ImageRegionConstIteratorWithIndex< OutputImageType > CurrentIt(currentField, outputRegionForThread);
+      ImageRegionIterator< OutputImageType > OutputIt(m_SquaringOutputField, outputRegionForThread);
+
+      typename FieldSamplerType::PointType point;
+      typename FieldSamplerType::OutputType interpolatedValue;
+      OutputPixelType warpedValue;
+      for ( CurrentIt.GoToBegin(), OutputIt.GoToBegin(); !CurrentIt.IsAtEnd(); ++CurrentIt, ++OutputIt )
+        {
+        const OutputPixelType & displacement = CurrentIt.Get();
+
+        currentField->TransformIndexToPhysicalPoint(CurrentIt.GetIndex(), point);
+        for ( unsigned int j = 0; j < ImageDimension; j++ )
+          {
+          point[j] += displacement[j];
+          }
+
+        m_SquaringInputSampler.EvaluateWithNearestNeighborExtrapolation(point, interpolatedValue);
+        for ( unsigned int k = 0; k < OutputPixelDimension; k++ )
+          {
+          warpedValue[k] = static_cast< typename OutputPixelType::ValueType >( interpolatedValue[k] );
+          }
+
+        OutputIt.Set(displacement + warpedValue);
+        }
+      break;
+      }
     }
 }
 } // end namespace itk
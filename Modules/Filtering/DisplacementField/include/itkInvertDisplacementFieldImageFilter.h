@@ -18,6 +18,7 @@
 #ifndef itkInvertDisplacementFieldImageFilter_h
 #define itkInvertDisplacementFieldImageFilter_h
 
+#include "itkDisplacementFieldLinearSampler.h"
 #include "itkImageToImageFilter.h"
 #include "itkVectorInterpolateImageFunction.h"
 #include "itkVectorLinearInterpolateImageFunction.h"
@@ -31,6 +32,13 @@ namespace itk
  *
  * \brief Iteratively estimate the inverse field of a displacement field.
  *
+ * Each fixed-point iteration composes the displacement field with the
+ * current inverse estimate and updates the estimate from the residual.  The
+ * composition is evaluated in the same threaded pass as the update of the
+ * previous iteration, sampling the displacement field directly through
+ * DisplacementFieldLinearSampler, so every iteration costs a single sweep
+ * over the field and no intermediate filter or image is created.
+ *
  * \author Nick Tustison
  * \author Brian Avants
  *
@@ -80,6 +88,7 @@ public:
   using InterpolatorType = VectorInterpolateImageFunction<InputFieldType, RealType>;
   using DefaultInterpolatorType =
       VectorLinearInterpolateImageFunction <InputFieldType, RealType>;
+  using LinearSamplerType = DisplacementFieldLinearSampler<DisplacementFieldType, RealType>;
 
   /** Get the interpolator. */
   itkGetModifiableObjectMacro( Interpolator, InterpolatorType );
@@ -169,9 +178,13 @@ private:
 
   RealType                                          m_MaxErrorNorm;
   RealType                                          m_MeanErrorNorm;
+  RealType                                          m_AccumulatedMaxErrorNorm;
+  RealType                                          m_AccumulatedMeanErrorNorm;
   RealType                                          m_Epsilon;
   SpacingType                                       m_DisplacementFieldSpacing;
   bool                                              m_DoThreadedEstimateInverse;
+  bool                                              m_DoThreadedComposition;
+  LinearSamplerType                                 m_LinearSampler;
   bool                                              m_EnforceBoundaryCondition;
   SimpleFastMutexLock                               m_Mutex;
 
@@ -20,9 +20,9 @@
 
 #include "itkInvertDisplacementFieldImageFilter.h"
 
-#include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkImageDuplicator.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkMutexLockHolder.h"
 
 namespace itk
@@ -43,8 +43,11 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
   m_ScaledNormImage(RealImageType::New()),
   m_MaxErrorNorm(0.0),
   m_MeanErrorNorm(0.0),
+  m_AccumulatedMaxErrorNorm(0.0),
+  m_AccumulatedMeanErrorNorm(0.0),
   m_Epsilon(0.0),
   m_DoThreadedEstimateInverse(false),
+  m_DoThreadedComposition(false),
   m_EnforceBoundaryCondition(true)
 {
   this->SetNumberOfRequiredInputs( 1 );
@@ -108,17 +111,26 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
     this->m_DisplacementFieldSpacing[d] = displacementField->GetSpacing()[d];
     }
 
+  this->m_ComposedField->CopyInformation( displacementField );
+  this->m_ComposedField->SetRegions( displacementField->GetRequestedRegion() );
+  this->m_ComposedField->Allocate();
+
   this->m_ScaledNormImage->CopyInformation( displacementField );
   this->m_ScaledNormImage->SetRegions( displacementField->GetRequestedRegion() );
   this->m_ScaledNormImage->Allocate(true); // initialize
                                                                   // buffer
                                                                   // to zero
 
+  this->m_LinearSampler.SetField( displacementField );
+
   SizeValueType numberOfPixelsInRegion = ( displacementField->GetRequestedRegion() ).GetNumberOfPixels();
   this->m_MaxErrorNorm = NumericTraits<RealType>::max();
   this->m_MeanErrorNorm = NumericTraits<RealType>::max();
   unsigned int iteration = 0;
 
+  typename ImageSource<TOutputImage>::ThreadStruct str;
+  str.Filter = this;
+
   while( iteration++ < this->m_MaximumNumberOfIterations &&
     this->m_MaxErrorNorm > this->m_MaxErrorToleranceThreshold &&
     this->m_MeanErrorNorm > this->m_MeanErrorToleranceThreshold )
@@ -126,44 +138,39 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
     itkDebugMacro( "Iteration " << iteration << ": mean error norm = " << this->m_MeanErrorNorm
       << ", max error norm = " << this->m_MaxErrorNorm );
 
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
-    typename ComposerType::Pointer composer = ComposerType::New();
-    composer->SetDisplacementField( displacementField );
-    composer->SetWarpingField( inverseDisplacementField );
-
-    this->m_ComposedField = composer->GetOutput();
-    this->m_ComposedField->Update();
-    this->m_ComposedField->DisconnectPipeline();
-
     /**
-     * Multithread processing to multiply each element of the composed field by 1 / spacing
+     * Multithread processing to apply the update estimated in the previous
+     * iteration, compose the displacement field with the resulting inverse
+     * estimate and multiply each element of the composed field by 1 / spacing
      */
-    this->m_MeanErrorNorm = NumericTraits<RealType>::ZeroValue();
-    this->m_MaxErrorNorm = NumericTraits<RealType>::ZeroValue();
+    this->m_AccumulatedMeanErrorNorm = NumericTraits<RealType>::ZeroValue();
+    this->m_AccumulatedMaxErrorNorm = NumericTraits<RealType>::ZeroValue();
 
-    this->m_DoThreadedEstimateInverse = false;
-    typename ImageSource<TOutputImage>::ThreadStruct str0;
-    str0.Filter = this;
+    this->m_DoThreadedEstimateInverse = ( iteration > 1 );
+    this->m_DoThreadedComposition = true;
     this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str0 );
+    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str );
     this->GetMultiThreader()->SingleMethodExecute();
 
-    this->m_MeanErrorNorm /= static_cast<RealType>( numberOfPixelsInRegion );
+    this->m_MeanErrorNorm = this->m_AccumulatedMeanErrorNorm / static_cast<RealType>( numberOfPixelsInRegion );
+    this->m_MaxErrorNorm = this->m_AccumulatedMaxErrorNorm;
 
     this->m_Epsilon = 0.5;
     if( iteration == 1 )
       {
       this->m_Epsilon = 0.75;
       }
+    }
 
-    /**
-     * Multithread processing to estimate inverse field
-     */
+  /**
+   * Multithread processing to apply the update of the last iteration
+   */
+  if( iteration > 1 )
+    {
     this->m_DoThreadedEstimateInverse = true;
-    typename ImageSource<TOutputImage>::ThreadStruct str1;
-    str1.Filter = this;
+    this->m_DoThreadedComposition = false;
     this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str1 );
+    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str );
     this->GetMultiThreader()->SingleMethodExecute();
     }
 }
@@ -180,12 +187,27 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
 
   ImageRegionIterator<DisplacementFieldType> ItE( this->m_ComposedField, region );
   ImageRegionIterator<RealImageType> ItS( this->m_ScaledNormImage, region );
+  ImageRegionIteratorWithIndex<InverseDisplacementFieldType> ItI( this->GetOutput(), region );
 
-  if( this->m_DoThreadedEstimateInverse )
+  const InverseDisplacementFieldType * inverseField = this->GetOutput();
+
+  VectorType inverseSpacing;
+  RealType localMean = NumericTraits<RealType>::ZeroValue();
+  RealType localMax  = NumericTraits<RealType>::ZeroValue();
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    inverseSpacing[d]=1.0/this->m_DisplacementFieldSpacing[d];
+    }
+
+  PointType pointIn1;
+  PointType pointIn2;
+  PointType pointIn3;
+
+  for( ItI.GoToBegin(), ItE.GoToBegin(), ItS.GoToBegin(); !ItI.IsAtEnd(); ++ItI, ++ItE, ++ItS )
     {
-    ImageRegionIterator<DisplacementFieldType> ItI( this->GetOutput(), region );
+    const typename DisplacementFieldType::IndexType index = ItI.GetIndex();
 
-    for( ItI.GoToBegin(), ItE.GoToBegin(), ItS.GoToBegin(); !ItI.IsAtEnd(); ++ItI, ++ItE, ++ItS )
+    if( this->m_DoThreadedEstimateInverse )
       {
       VectorType update = ItE.Get();
       RealType scaledNorm = ItS.Get();
@@ -196,7 +218,6 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
         }
       update = ItI.Get() + update * this->m_Epsilon;
       ItI.Set( update );
-      typename DisplacementFieldType::IndexType index = ItI.GetIndex();
       if( this->m_EnforceBoundaryCondition )
         {
         for( unsigned int d = 0; d < ImageDimension; d++ )
@@ -209,19 +230,30 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
           }
         } // enforce boundary condition
       }
-    }
-  else
-    {
-    VectorType inverseSpacing;
-    RealType localMean = NumericTraits<RealType>::ZeroValue();
-    RealType localMax  = NumericTraits<RealType>::ZeroValue();
-    for( unsigned int d = 0; d < ImageDimension; ++d )
-      {
-      inverseSpacing[d]=1.0/this->m_DisplacementFieldSpacing[d];
-      }
-    for( ItE.GoToBegin(), ItS.GoToBegin(); !ItE.IsAtEnd(); ++ItE, ++ItS )
+
+    if( this->m_DoThreadedComposition )
       {
-      const VectorType & displacement = ItE.Get();
+      // Compose the displacement field with the current inverse estimate,
+      // i.e. the pixel-wise equivalent of ComposeDisplacementFieldsImageFilter
+      // with the default linear interpolator.
+      const VectorType warpVector = ItI.Get();
+      inverseField->TransformIndexToPhysicalPoint( index, pointIn1 );
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        pointIn2[d] = pointIn1[d] + warpVector[d];
+        }
+
+      typename LinearSamplerType::OutputType sampledDisplacement( 0.0 );
+      this->m_LinearSampler.Evaluate( pointIn2, sampledDisplacement );
+
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        pointIn3[d] = pointIn2[d] + sampledDisplacement[d];
+        }
+
+      VectorType displacement;
+      displacement = pointIn3 - pointIn1;
+
       RealType scaledNorm = 0.0;
       for( unsigned int d = 0; d < ImageDimension; ++d )
         {
@@ -238,13 +270,15 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
       ItS.Set( scaledNorm );
       ItE.Set( -displacement );
       }
+    }
+
+  if( this->m_DoThreadedComposition )
+    {
+    MutexLockHolder<SimpleFastMutexLock> holder(m_Mutex);
+    this->m_AccumulatedMeanErrorNorm += localMean;
+    if( this->m_AccumulatedMaxErrorNorm < localMax )
       {
-      MutexLockHolder<SimpleFastMutexLock> holder(m_Mutex);
-      this->m_MeanErrorNorm += localMean;
-      if( this->m_MaxErrorNorm < localMax )
-        {
-        this->m_MaxErrorNorm = localMax;
-        }
+      this->m_AccumulatedMaxErrorNorm = localMax;
       }
     }
 }
@@ -0,0 +1,234 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkComposeDisplacementFieldsImageFilter.h"
+#include "itkDisplacementFieldLinearSampler.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+#include "itkVectorLinearInterpolateNearestNeighborExtrapolateImageFunction.h"
+
+namespace
+{
+
+template <typename TField>
+typename TField::Pointer
+CreateDisplacementField( double amplitude, double phase )
+{
+  constexpr unsigned int ImageDimension = TField::ImageDimension;
+
+  typename TField::IndexType start;
+  typename TField::SizeType size;
+  typename TField::SpacingType spacing;
+  typename TField::PointType origin;
+  typename TField::DirectionType direction;
+  direction.SetIdentity();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    start[d] = static_cast<itk::IndexValueType>( d ) - 2;
+    size[d] = 17 + 3 * d;
+    spacing[d] = 0.8 + 0.2 * d;
+    origin[d] = -4.0 + 1.5 * d;
+    }
+  // Rotate the first two axes so the physical-to-index mapping is not diagonal.
+  const double angle = 0.3;
+  direction[0][0] = std::cos( angle );
+  direction[0][1] = -std::sin( angle );
+  direction[1][0] = std::sin( angle );
+  direction[1][1] = std::cos( angle );
+
+  typename TField::Pointer field = TField::New();
+  field->SetRegions( typename TField::RegionType( start, size ) );
+  field->SetSpacing( spacing );
+  field->SetOrigin( origin );
+  field->SetDirection( direction );
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<TField> It( field, field->GetBufferedRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const typename TField::IndexType index = It.GetIndex();
+    typename TField::PixelType displacement;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      displacement[d] = amplitude * std::sin( 0.37 * index[( d + 1 ) % ImageDimension] + phase + d );
+      }
+    It.Set( displacement );
+    }
+  return field;
+}
+
+template <typename TField>
+int
+TestDisplacementFieldLinearSampler()
+{
+  constexpr unsigned int ImageDimension = TField::ImageDimension;
+
+  using RealType = typename TField::PixelType::ComponentType;
+  using SamplerType = itk::DisplacementFieldLinearSampler<TField, RealType>;
+  using InterpolatorType = typename SamplerType::InterpolatorType;
+
+  typename TField::Pointer field = CreateDisplacementField<TField>( 2.0, 0.1 );
+  typename TField::Pointer warpingField = CreateDisplacementField<TField>( 3.0, 1.3 );
+
+  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetInputImage( field );
+
+  using ExtrapolatorType = itk::VectorLinearInterpolateNearestNeighborExtrapolateImageFunction<TField, RealType>;
+  typename ExtrapolatorType::Pointer extrapolator = ExtrapolatorType::New();
+  extrapolator->SetInputImage( field );
+
+  SamplerType sampler;
+  sampler.SetField( field );
+  TEST_EXPECT_TRUE( sampler.GetField() == field.GetPointer() );
+
+  // The sampler must agree bit for bit with IsInsideBuffer() + Evaluate() of
+  // the linear interpolator and with Evaluate() of the extrapolating one,
+  // including points on grid nodes and points outside the buffer.
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  typename TField::PointType lower;
+  typename TField::PointType upper;
+  field->TransformIndexToPhysicalPoint( field->GetBufferedRegion().GetIndex(), lower );
+  field->TransformIndexToPhysicalPoint( field->GetBufferedRegion().GetUpperIndex(), upper );
+
+  unsigned int numberOfInsidePoints = 0;
+  for( unsigned int n = 0; n < 5000; n++ )
+    {
+    typename SamplerType::PointType point;
+    if( n % 5 == 0 )
+      {
+      typename TField::IndexType index = field->GetBufferedRegion().GetIndex();
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        index[d] += generator->GetIntegerVariate( field->GetBufferedRegion().GetSize()[d] - 1 );
+        }
+      field->TransformIndexToPhysicalPoint( index, point );
+      }
+    else
+      {
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        const double extent = upper[d] - lower[d];
+        point[d] = generator->GetUniformVariate( lower[d] - 0.6 * std::abs( extent ), upper[d] + 0.6 * std::abs( extent ) );
+        }
+      }
+
+    typename SamplerType::OutputType sampled( 0.0 );
+    const bool isInside = sampler.Evaluate( point, sampled );
+    if( isInside != interpolator->IsInsideBuffer( point ) )
+      {
+      std::cerr << "Inside test mismatch at " << point << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    typename SamplerType::OutputType extrapolated;
+    sampler.EvaluateWithNearestNeighborExtrapolation( point, extrapolated );
+    const typename SamplerType::OutputType expectedExtrapolated = extrapolator->Evaluate( point );
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( extrapolated[d] != expectedExtrapolated[d] )
+        {
+        std::cerr << "Extrapolated " << extrapolated << " but expected " << expectedExtrapolated << " at " << point << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( isInside )
+      {
+      ++numberOfInsidePoints;
+      const typename SamplerType::OutputType expected = interpolator->Evaluate( point );
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        if( sampled[d] != expected[d] )
+          {
+          std::cerr << "Sampled " << sampled << " but interpolated " << expected << " at " << point << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  TEST_EXPECT_TRUE( numberOfInsidePoints > 0 && numberOfInsidePoints < 5000 );
+
+  // The composition with the default interpolator, which goes through the
+  // sampler, must match the composition evaluated with the interpolator.
+  using ComposerType = itk::ComposeDisplacementFieldsImageFilter<TField>;
+  typename ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( field );
+  composer->SetWarpingField( warpingField );
+  TRY_EXPECT_NO_EXCEPTION( composer->Update() );
+
+  itk::ImageRegionIteratorWithIndex<TField> ItW( warpingField, warpingField->GetBufferedRegion() );
+  itk::ImageRegionIteratorWithIndex<TField> ItC( composer->GetOutput(), warpingField->GetBufferedRegion() );
+  for( ItW.GoToBegin(), ItC.GoToBegin(); !ItW.IsAtEnd(); ++ItW, ++ItC )
+    {
+    typename TField::PointType pointIn1;
+    typename TField::PointType pointIn2;
+    typename TField::PointType pointIn3;
+    warpingField->TransformIndexToPhysicalPoint( ItW.GetIndex(), pointIn1 );
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      pointIn2[d] = pointIn1[d] + ItW.Get()[d];
+      }
+    typename InterpolatorType::OutputType displacement( 0.0 );
+    if( interpolator->IsInsideBuffer( pointIn2 ) )
+      {
+      displacement = interpolator->Evaluate( pointIn2 );
+      }
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      pointIn3[d] = pointIn2[d] + displacement[d];
+      }
+    typename TField::PixelType expected;
+    expected = pointIn3 - pointIn1;
+    if( ItC.Get() != expected )
+      {
+      std::cerr << "Composed " << ItC.Get() << " but expected " << expected << " at " << ItW.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkDisplacementFieldLinearSamplerTest( int, char * [] )
+{
+  int result = EXIT_SUCCESS;
+
+  if( TestDisplacementFieldLinearSampler<itk::Image<itk::Vector<float, 2>, 2> >() == EXIT_FAILURE )
+    {
+    std::cerr << "2D float field failed." << std::endl;
+    result = EXIT_FAILURE;
+    }
+  if( TestDisplacementFieldLinearSampler<itk::Image<itk::Vector<float, 3>, 3> >() == EXIT_FAILURE )
+    {
+    std::cerr << "3D float field failed." << std::endl;
+    result = EXIT_FAILURE;
+    }
+  if( TestDisplacementFieldLinearSampler<itk::Image<itk::Vector<double, 3>, 3> >() == EXIT_FAILURE )
+    {
+    std::cerr << "3D double field failed." << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -15,7 +15,8 @@
  *  limitations under the License.
  *
  *=========================================================================*/
-
+#include "itkExponentialDisplacementFieldImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkExponentialDisplacementFieldImageFilter.h"
 
 #include "vnl/vnl_random.h"
@@ -48,6 +48,24 @@ namespace itk
  * Bilateral filtering is capable of reducing the noise in an image
  * by an order of magnitude while maintaining edges.
  *
+ * The cost of the direct evaluation grows with the size of the domain
+ * kernel. When the kernel size is automatic and the domain sigma is at
+ * least BilateralGridMinimumDomainSigma pixels in every dimension, the
+ * filter instead uses the bilateral grid of Paris and Durand (A Fast
+ * Approximation of the Bilateral Filter using a Signal Processing
+ * Approach. ECCV. 2006): the pixels are splatted into a grid sampled
+ * BilateralGridSamplingRate times per sigma along the image and intensity
+ * axes, the grid is blurred with separable Gaussians, and the output is
+ * interpolated from the grid. The result is still a normalized weighted
+ * average of the input, with a kernel that departs from the exact one by
+ * the interpolation error of the grid; this error decreases as the
+ * sampling rate increases, and the memory grows with its (ImageDimension+1)
+ * power. A grid which would take more than BilateralGridMaximumMemoryInBytes,
+ * e.g. for a range sigma much smaller than the intensity range, is not
+ * allocated and the direct evaluation is used instead. Near the image
+ * boundary, the grid ignores pixels outside the image instead of extending
+ * the boundary values.
+ *
  * The bilateral operator used here was described by Tomasi and
  * Manduchi (Bilateral Filtering for Gray and ColorImages. IEEE
  * ICCV. 1998.)
@@ -143,7 +161,9 @@ public:
    * same values.  */
   void SetDomainSigma(const double v)
   {
-    m_DomainSigma.Fill(v);
+    ArrayType domainSigma;
+    domainSigma.Fill(v);
+    this->SetDomainSigma(domainSigma);
   }
 
   /** Control automatic kernel size determination. When
@@ -168,6 +188,28 @@ public:
   itkSetMacro(NumberOfRangeGaussianSamples, unsigned long);
   itkGetConstMacro(NumberOfRangeGaussianSamples, unsigned long);
 
+  /** Set/Get the smallest domain sigma, in pixels, for which the bilateral
+   * grid approximation is used instead of the direct evaluation. The grid
+   * is only used when AutomaticKernelSize is "on". Set it to 0 to always
+   * use the grid, or to a very large value to never use it. Default is 6. */
+  itkSetMacro(BilateralGridMinimumDomainSigma, double);
+  itkGetConstMacro(BilateralGridMinimumDomainSigma, double);
+
+  /** Set/Get the number of bilateral grid cells per sigma, along both the
+   * image axes and the intensity axis. Higher rates reduce the
+   * approximation error. Default is 1. */
+  itkSetClampMacro(BilateralGridSamplingRate, double, 1.0, NumericTraits< double >::max());
+  itkGetConstMacro(BilateralGridSamplingRate, double);
+
+  /** Set/Get the largest memory, in bytes, the bilateral grid may take. When
+   * the grid would be larger, the filter falls back to the direct
+   * evaluation. Default is 1 GiB. */
+  itkSetMacro(BilateralGridMaximumMemoryInBytes, SizeValueType);
+  itkGetConstMacro(BilateralGridMaximumMemoryInBytes, SizeValueType);
+
+  /** Returns true if the last update used the bilateral grid. */
+  itkGetConstMacro(BilateralGridUsed, bool);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro( OutputHasNumericTraitsCheck,
@@ -188,6 +230,9 @@ protected:
   /** Do some setup before the ThreadedGenerateData */
   void BeforeThreadedGenerateData() override;
 
+  /** Release the bilateral grid after the ThreadedGenerateData */
+  void AfterThreadedGenerateData() override;
+
   /** Standard pipeline method. This filter is implemented as a multi-threaded
    * filter. */
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
@@ -201,7 +246,40 @@ protected:
    * \sa ImageToImageFilter::GenerateInputRequestedRegion() */
   void GenerateInputRequestedRegion() override;
 
+  /** Splat the input requested region into the bilateral grid and blur the
+   * grid. Return false, without allocating the grid, if it would take more
+   * than BilateralGridMaximumMemoryInBytes. */
+  bool ComputeBilateralGrid();
+
+  /** Splat the pixels into the nodes of the grid whose index along the last
+   * image dimension belongs to this thread. */
+  void ThreadedSplatBilateralGrid(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  /** Blur the lines of the grid along the given grid dimension. */
+  void ThreadedBlurBilateralGrid(unsigned int dimension, ThreadIdType threadId,
+                                 ThreadIdType numberOfThreads);
+
+  /** Interpolate the output from the blurred grid. */
+  void ThreadedSliceBilateralGrid(const OutputImageRegionType & outputRegionForThread,
+                                  ThreadIdType threadId);
+
 private:
+  /** Dimension of the bilateral grid: the image dimensions plus intensity. */
+  static constexpr unsigned int GridDimension = ImageDimension + 1;
+
+  using GridArrayType = FixedArray< double, GridDimension >;
+  using GridSizeType = FixedArray< SizeValueType, GridDimension >;
+
+  struct BilateralGridThreadStruct
+  {
+    BilateralImageFilter *Filter;
+    unsigned int          Dimension;
+  };
+
+  static ITK_THREAD_RETURN_TYPE SplatBilateralGridThreaderCallback(void *arg);
+
+  static ITK_THREAD_RETURN_TYPE BlurBilateralGridThreaderCallback(void *arg);
+
   /** The standard deviation of the gaussian blurring kernel in the image
       range. Units are intensity. */
   double m_RangeSigma;
@@ -228,6 +306,21 @@ private:
   double                m_DynamicRange;
   double                m_DynamicRangeUsed;
   std::vector< double > m_RangeGaussianTable;
+
+  /** Bilateral grid parameters and storage. Each node holds the weighted
+   * sum of the intensities followed by the sum of the weights. */
+  double                               m_BilateralGridMinimumDomainSigma;
+  double                               m_BilateralGridSamplingRate;
+  SizeValueType                        m_BilateralGridMaximumMemoryInBytes;
+  bool                                 m_BilateralGridUsed;
+  typename TInputImage::IndexType      m_GridOriginIndex;
+  double                               m_GridRangeMinimum;
+  GridArrayType                        m_GridCellSize;
+  GridSizeType                         m_GridPadding;
+  GridSizeType                         m_GridSize;
+  GridSizeType                         m_GridStride;
+  std::vector< std::vector< double > > m_GridKernels;
+  std::vector< double >                m_Grid;
 };
 } // end namespace itk
 
@@ -25,6 +25,8 @@
 #include "itkZeroFluxNeumannBoundaryCondition.h"
 #include "itkProgressReporter.h"
 #include "itkStatisticsImageFilter.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 namespace itk
 {
@@ -43,6 +45,16 @@ BilateralImageFilter< TInputImage, TOutputImage >
   this->m_DomainMu = 2.5;  // keep small to keep kernels small
   this->m_RangeMu = 4.0;   // can be bigger then DomainMu since we only
                            // index into a single table
+  this->m_BilateralGridMinimumDomainSigma = 6.0;
+  this->m_BilateralGridSamplingRate = 1.0;
+  this->m_BilateralGridMaximumMemoryInBytes = static_cast< SizeValueType >( 1 ) << 30;
+  this->m_BilateralGridUsed = false;
+  this->m_GridOriginIndex.Fill(0);
+  this->m_GridRangeMinimum = 0.0;
+  this->m_GridCellSize.Fill(1.0);
+  this->m_GridPadding.Fill(0);
+  this->m_GridSize.Fill(0);
+  this->m_GridStride.Fill(0);
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -142,6 +154,26 @@ BilateralImageFilter< TInputImage, TOutputImage >
   const typename InputImageType::SpacingType inputSpacing = inputImage->GetSpacing();
   const typename InputImageType::PointType inputOrigin  = inputImage->GetOrigin();
 
+  // Large domain kernels are approximated with the bilateral grid
+  m_BilateralGridUsed = m_AutomaticKernelSize;
+  for ( i = 0; i < ImageDimension; i++ )
+    {
+    if ( m_DomainSigma[i] / inputSpacing[i] < m_BilateralGridMinimumDomainSigma )
+      {
+      m_BilateralGridUsed = false;
+      }
+    }
+  if ( m_BilateralGridUsed )
+    {
+    m_BilateralGridUsed = this->ComputeBilateralGrid();
+    if ( m_BilateralGridUsed )
+      {
+      return;
+      }
+    itkDebugMacro("The bilateral grid exceeds " << m_BilateralGridMaximumMemoryInBytes
+                  << " bytes, using the direct evaluation");
+    }
+
   if ( m_AutomaticKernelSize )
     {
     for ( i = 0; i < ImageDimension; i++ )
@@ -256,6 +288,12 @@ BilateralImageFilter< TInputImage, TOutputImage >
   typename TInputImage::IndexValueType i;
   const double  rangeDistanceThreshold = m_DynamicRangeUsed;
 
+  if ( m_BilateralGridUsed )
+    {
+    this->ThreadedSliceBilateralGrid(outputRegionForThread, threadId);
+    return;
+    }
+
   // Now we are ready to bilateral filter!
   //
   //
@@ -346,6 +384,292 @@ BilateralImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  // Release the memory held by the bilateral grid
+  std::vector< double >().swap(m_Grid);
+}
+
+template< typename TInputImage, typename TOutputImage >
+bool
+BilateralImageFilter< TInputImage, TOutputImage >
+::ComputeBilateralGrid()
+{
+  const InputImageType *inputImage = this->GetInput();
+  const typename TInputImage::RegionType inputRegion = inputImage->GetRequestedRegion();
+  const typename InputImageType::SpacingType inputSpacing = inputImage->GetSpacing();
+
+  // Intensity range of the pixels splatted into the grid
+  using CalculatorType = MinimumMaximumImageCalculator< TInputImage >;
+  typename CalculatorType::Pointer calculator = CalculatorType::New();
+  calculator->SetImage(inputImage);
+  calculator->SetRegion(inputRegion);
+  calculator->Compute();
+
+  m_GridRangeMinimum = static_cast< double >( calculator->GetMinimum() );
+  m_DynamicRange = static_cast< double >( calculator->GetMaximum() ) - m_GridRangeMinimum;
+  m_DynamicRangeUsed = m_RangeMu * m_RangeSigma;
+  m_GridOriginIndex = inputRegion.GetIndex();
+
+  // Splatting and slicing with linear interpolation each add a variance of
+  // 1/6 cell^2, which the Gaussian blurring the grid compensates for.
+  const double rate = m_BilateralGridSamplingRate;
+  const double kernelSigma = std::sqrt(rate * rate - 1.0 / 3.0);
+
+  m_GridKernels.resize(GridDimension);
+  SizeValueType numberOfNodes = 1;
+  // Counted in floating point so that huge grids cannot overflow the count
+  double numberOfBytes = 2.0 * sizeof( double );
+  for ( unsigned int j = 0; j < GridDimension; j++ )
+    {
+    const double mu = ( j < ImageDimension ) ? m_DomainMu : m_RangeMu;
+    const SizeValueType radius = static_cast< SizeValueType >( std::ceil(mu * kernelSigma) );
+    std::vector< double > & kernel = m_GridKernels[j];
+    kernel.resize(2 * radius + 1);
+    double sum = 0.0;
+    for ( SizeValueType k = 0; k < kernel.size(); k++ )
+      {
+      const double x = static_cast< double >( k ) - static_cast< double >( radius );
+      kernel[k] = std::exp(-0.5 * x * x / ( kernelSigma * kernelSigma ));
+      sum += kernel[k];
+      }
+    for ( SizeValueType k = 0; k < kernel.size(); k++ )
+      {
+      kernel[k] /= sum;
+      }
+
+    double extent;
+    if ( j < ImageDimension )
+      {
+      m_GridCellSize[j] = m_DomainSigma[j] / inputSpacing[j] / rate;
+      extent = static_cast< double >( inputRegion.GetSize()[j] - 1 );
+      }
+    else
+      {
+      m_GridCellSize[j] = m_RangeSigma / rate;
+      extent = m_DynamicRange;
+      }
+    m_GridPadding[j] = radius;
+    const double gridSize = std::floor(extent / m_GridCellSize[j]) + 2.0 + 2.0 * radius;
+    numberOfBytes *= gridSize;
+    if ( numberOfBytes > static_cast< double >( m_BilateralGridMaximumMemoryInBytes ) )
+      {
+      return false;
+      }
+    m_GridSize[j] = static_cast< SizeValueType >( gridSize );
+    m_GridStride[j] = numberOfNodes;
+    numberOfNodes *= m_GridSize[j];
+    }
+
+  m_Grid.assign(2 * numberOfNodes, 0.0);
+
+  BilateralGridThreadStruct str;
+  str.Filter = this;
+  str.Dimension = 0;
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->SplatBilateralGridThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  for ( unsigned int j = 0; j < GridDimension; j++ )
+    {
+    str.Dimension = j;
+    this->GetMultiThreader()->SetSingleMethod(this->BlurBilateralGridThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  return true;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+BilateralImageFilter< TInputImage, TOutputImage >
+::SplatBilateralGridThreaderCallback(void *arg)
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  const BilateralGridThreadStruct *str = static_cast< BilateralGridThreadStruct * >( info->UserData );
+
+  str->Filter->ThreadedSplatBilateralGrid(info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+BilateralImageFilter< TInputImage, TOutputImage >
+::BlurBilateralGridThreaderCallback(void *arg)
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  const BilateralGridThreadStruct *str = static_cast< BilateralGridThreadStruct * >( info->UserData );
+
+  str->Filter->ThreadedBlurBilateralGrid(str->Dimension, info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedSplatBilateralGrid(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  // Each thread owns a slab of nodes along the last image dimension, and
+  // splats the rows of pixels that touch it.
+  const unsigned int  splitDimension = ImageDimension - 1;
+  const SizeValueType firstNode = m_GridSize[splitDimension] * threadId / numberOfThreads;
+  const SizeValueType lastNode = m_GridSize[splitDimension] * ( threadId + 1 ) / numberOfThreads;
+
+  const InputImageType *inputImage = this->GetInput();
+  typename TInputImage::RegionType region = inputImage->GetRequestedRegion();
+
+  IndexValueType firstRow = NumericTraits< IndexValueType >::max();
+  IndexValueType lastRow = NumericTraits< IndexValueType >::NonpositiveMin();
+  for ( SizeValueType row = 0; row < region.GetSize()[splitDimension]; row++ )
+    {
+    const SizeValueType base = Math::Floor< SizeValueType >(
+      static_cast< double >( row ) / m_GridCellSize[splitDimension] ) + m_GridPadding[splitDimension];
+    if ( base + 1 >= firstNode && base < lastNode )
+      {
+      firstRow = std::min(firstRow, static_cast< IndexValueType >( row ));
+      lastRow = std::max(lastRow, static_cast< IndexValueType >( row ));
+      }
+    }
+  if ( firstRow > lastRow )
+    {
+    return;
+    }
+  region.SetIndex(splitDimension, m_GridOriginIndex[splitDimension] + firstRow);
+  region.SetSize(splitDimension, static_cast< SizeValueType >( lastRow - firstRow + 1 ));
+
+  GridSizeType  base;
+  GridArrayType fraction;
+  for ( ImageRegionConstIteratorWithIndex< TInputImage > it(inputImage, region); !it.IsAtEnd(); ++it )
+    {
+    const typename TInputImage::IndexType index = it.GetIndex();
+    const double value = static_cast< double >( it.Get() );
+    for ( unsigned int j = 0; j < GridDimension; j++ )
+      {
+      const double coordinate = ( j < ImageDimension )
+        ? static_cast< double >( index[j] - m_GridOriginIndex[j] ) / m_GridCellSize[j]
+        : ( value - m_GridRangeMinimum ) / m_GridCellSize[j];
+      base[j] = Math::Floor< SizeValueType >(coordinate);
+      fraction[j] = coordinate - static_cast< double >( base[j] );
+      base[j] += m_GridPadding[j];
+      }
+
+    for ( unsigned int corner = 0; corner < ( 1u << GridDimension ); corner++ )
+      {
+      const SizeValueType splitNode = base[splitDimension] + ( ( corner >> splitDimension ) & 1u );
+      if ( splitNode < firstNode || splitNode >= lastNode )
+        {
+        continue;
+        }
+      SizeValueType node = 0;
+      double        weight = 1.0;
+      for ( unsigned int j = 0; j < GridDimension; j++ )
+        {
+        const SizeValueType bit = ( corner >> j ) & 1u;
+        node += ( base[j] + bit ) * m_GridStride[j];
+        weight *= bit ? fraction[j] : 1.0 - fraction[j];
+        }
+      m_Grid[2 * node] += weight * value;
+      m_Grid[2 * node + 1] += weight;
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedBlurBilateralGrid(unsigned int dimension, ThreadIdType threadId,
+                            ThreadIdType numberOfThreads)
+{
+  const SizeValueType           length = m_GridSize[dimension];
+  const SizeValueType           stride = m_GridStride[dimension];
+  const SizeValueType           numberOfLines = m_Grid.size() / ( 2 * length );
+  const SizeValueType           firstLine = numberOfLines * threadId / numberOfThreads;
+  const SizeValueType           lastLine = numberOfLines * ( threadId + 1 ) / numberOfThreads;
+  const std::vector< double > & kernel = m_GridKernels[dimension];
+  const SizeValueType           radius = ( kernel.size() - 1 ) / 2;
+
+  std::vector< double > line(2 * length);
+  for ( SizeValueType l = firstLine; l < lastLine; l++ )
+    {
+    const SizeValueType first = ( l / stride ) * stride * length + l % stride;
+    for ( SizeValueType k = 0; k < length; k++ )
+      {
+      line[2 * k] = m_Grid[2 * ( first + k * stride )];
+      line[2 * k + 1] = m_Grid[2 * ( first + k * stride ) + 1];
+      }
+    for ( SizeValueType k = 0; k < length; k++ )
+      {
+      const SizeValueType begin = ( k > radius ) ? k - radius : 0;
+      const SizeValueType end = std::min(k + radius + 1, length);
+      double value = 0.0;
+      double weight = 0.0;
+      for ( SizeValueType m = begin; m < end; m++ )
+        {
+        value += kernel[m + radius - k] * line[2 * m];
+        weight += kernel[m + radius - k] * line[2 * m + 1];
+        }
+      m_Grid[2 * ( first + k * stride )] = value;
+      m_Grid[2 * ( first + k * stride ) + 1] = weight;
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedSliceBilateralGrid(const OutputImageRegionType & outputRegionForThread,
+                             ThreadIdType threadId)
+{
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ImageRegionConstIteratorWithIndex< TInputImage > it(this->GetInput(), outputRegionForThread);
+  ImageRegionIterator< OutputImageType >           o_iter(this->GetOutput(), outputRegionForThread);
+
+  GridSizeType  base;
+  GridArrayType fraction;
+  for ( ; !it.IsAtEnd(); ++it, ++o_iter )
+    {
+    const typename TInputImage::IndexType index = it.GetIndex();
+    const double value = static_cast< double >( it.Get() );
+    for ( unsigned int j = 0; j < GridDimension; j++ )
+      {
+      const double coordinate = ( j < ImageDimension )
+        ? static_cast< double >( index[j] - m_GridOriginIndex[j] ) / m_GridCellSize[j]
+        : ( value - m_GridRangeMinimum ) / m_GridCellSize[j];
+      base[j] = Math::Floor< SizeValueType >(coordinate);
+      fraction[j] = coordinate - static_cast< double >( base[j] );
+      base[j] += m_GridPadding[j];
+      }
+
+    OutputPixelRealType val = 0.0;
+    OutputPixelRealType normFactor = 0.0;
+    for ( unsigned int corner = 0; corner < ( 1u << GridDimension ); corner++ )
+      {
+      SizeValueType node = 0;
+      double        weight = 1.0;
+      for ( unsigned int j = 0; j < GridDimension; j++ )
+        {
+        const SizeValueType bit = ( corner >> j ) & 1u;
+        node += ( base[j] + bit ) * m_GridStride[j];
+        weight *= bit ? fraction[j] : 1.0 - fraction[j];
+        }
+      val += weight * m_Grid[2 * node];
+      normFactor += weight * m_Grid[2 * node + 1];
+      }
+    // normalize the value
+    val /= normFactor;
+
+    o_iter.Set( static_cast< OutputPixelType >( val ) );
+    progress.CompletedPixel();
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 BilateralImageFilter< TInputImage, TOutputImage >
@@ -361,6 +685,10 @@ BilateralImageFilter< TInputImage, TOutputImage >
   os << indent << "Amount of dynamic range used: " << m_DynamicRangeUsed << std::endl;
   os << indent << "AutomaticKernelSize: " << m_AutomaticKernelSize << std::endl;
   os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "BilateralGridMinimumDomainSigma: " << m_BilateralGridMinimumDomainSigma << std::endl;
+  os << indent << "BilateralGridSamplingRate: " << m_BilateralGridSamplingRate << std::endl;
+  os << indent << "BilateralGridMaximumMemoryInBytes: " << m_BilateralGridMaximumMemoryInBytes << std::endl;
+  os << indent << "BilateralGridUsed: " << m_BilateralGridUsed << std::endl;
 }
 } // end namespace itk
 
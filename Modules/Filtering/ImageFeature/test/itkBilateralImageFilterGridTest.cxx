@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBilateralImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Compares the bilateral grid approximation of BilateralImageFilter with
+// the direct evaluation of the filter.
+
+namespace
+{
+
+template< typename TImage >
+typename TImage::Pointer
+CreateStepImage( const typename TImage::SizeType & size )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 2018 );
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    // A ramp with a step edge across the first dimension, plus noise
+    double value = 50.0 + 0.5 * index[1];
+    if( index[0] >= static_cast< itk::IndexValueType >( size[0] / 2 ) )
+      {
+      value += 100.0;
+      }
+    it.Set( value + generator->GetNormalVariate( 0.0, 100.0 ) );
+    }
+  return image;
+}
+
+template< typename TImage >
+typename TImage::Pointer
+Filter( const TImage * input, double domainSigma, double rangeSigma,
+        double minimumDomainSigma, double samplingRate, bool & gridUsed )
+{
+  using FilterType = itk::BilateralImageFilter< TImage, TImage >;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetDomainSigma( domainSigma );
+  filter->SetRangeSigma( rangeSigma );
+  filter->SetNumberOfRangeGaussianSamples( 1000 );
+  filter->SetBilateralGridMinimumDomainSigma( minimumDomainSigma );
+  filter->SetBilateralGridSamplingRate( samplingRate );
+  filter->Update();
+  gridUsed = filter->GetBilateralGridUsed();
+  return filter->GetOutput();
+}
+
+// Mean absolute difference away from the image boundary, where the two
+// methods treat the pixels outside the image differently.
+template< typename TImage >
+double
+MeanAbsoluteDifference( const TImage * image1, const TImage * image2, itk::IndexValueType margin )
+{
+  typename TImage::RegionType region = image1->GetLargestPossibleRegion();
+  region.ShrinkByRadius( margin );
+
+  double sum = 0.0;
+  itk::ImageRegionConstIteratorWithIndex< TImage > it1( image1, region );
+  itk::ImageRegionConstIteratorWithIndex< TImage > it2( image2, region );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    sum += std::abs( static_cast< double >( it1.Get() ) - static_cast< double >( it2.Get() ) );
+    }
+  return sum / region.GetNumberOfPixels();
+}
+
+template< typename TImage >
+bool
+CompareGridAndDirect( const typename TImage::SizeType & size, double domainSigma,
+                      double rangeSigma, double samplingRate, double tolerance )
+{
+  const typename TImage::Pointer input = CreateStepImage< TImage >( size );
+
+  bool gridUsed;
+  const typename TImage::Pointer direct =
+    Filter< TImage >( input, domainSigma, rangeSigma, 1e6, samplingRate, gridUsed );
+  if( gridUsed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The bilateral grid was used with a minimum domain sigma of 1e6" << std::endl;
+    return false;
+    }
+  const typename TImage::Pointer grid =
+    Filter< TImage >( input, domainSigma, rangeSigma, 0.0, samplingRate, gridUsed );
+  if( !gridUsed )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The bilateral grid was not used with a minimum domain sigma of 0" << std::endl;
+    return false;
+    }
+
+  const itk::IndexValueType margin = static_cast< itk::IndexValueType >( std::ceil( 2.5 * domainSigma ) );
+  const double difference = MeanAbsoluteDifference< TImage >( direct, grid, margin );
+  std::cout << "Size " << size << ", domain sigma " << domainSigma << ", range sigma " << rangeSigma
+            << ", sampling rate " << samplingRate << ": mean absolute difference " << difference << std::endl;
+  if( difference > tolerance )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The bilateral grid differs from the direct evaluation by " << difference
+              << ", more than " << tolerance << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end namespace
+
+int itkBilateralImageFilterGridTest( int, char* [] )
+{
+  using ImageType = itk::Image< float, 2 >;
+  using FilterType = itk::BilateralImageFilter< ImageType, ImageType >;
+
+  FilterType::Pointer filter = FilterType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( filter, BilateralImageFilter, ImageToImageFilter );
+
+  TEST_EXPECT_EQUAL( filter->GetBilateralGridMinimumDomainSigma(), 6.0 );
+  TEST_EXPECT_EQUAL( filter->GetBilateralGridSamplingRate(), 1.0 );
+  TEST_EXPECT_EQUAL( filter->GetBilateralGridMaximumMemoryInBytes(), static_cast< itk::SizeValueType >( 1 ) << 30 );
+
+  double samplingRate = 0.5;
+  filter->SetBilateralGridSamplingRate( samplingRate );
+  TEST_SET_GET_VALUE( 1.0, filter->GetBilateralGridSamplingRate() );
+
+  // The grid is selected automatically for large domain sigmas only
+  ImageType::SizeType size2D;
+  size2D[0] = 96;
+  size2D[1] = 80;
+  const ImageType::Pointer input = CreateStepImage< ImageType >( size2D );
+  filter->SetInput( input );
+  filter->SetRangeSigma( 30.0 );
+  filter->SetDomainSigma( 4.0 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( !filter->GetBilateralGridUsed() );
+  filter->SetDomainSigma( 6.0 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( filter->GetBilateralGridUsed() );
+
+  // A grid larger than the memory cap falls back to the direct evaluation,
+  // with the same result as when the grid is not selected at all.
+  filter->SetBilateralGridMaximumMemoryInBytes( 1024 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( !filter->GetBilateralGridUsed() );
+  const ImageType::Pointer cappedOutput = filter->GetOutput();
+  cappedOutput->DisconnectPipeline();
+  filter->SetBilateralGridMaximumMemoryInBytes( static_cast< itk::SizeValueType >( 1 ) << 30 );
+  filter->SetBilateralGridMinimumDomainSigma( 1e6 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( !filter->GetBilateralGridUsed() );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > cappedIt( cappedOutput, cappedOutput->GetBufferedRegion() );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > directIt( filter->GetOutput(), cappedOutput->GetBufferedRegion() );
+  for( ; !cappedIt.IsAtEnd(); ++cappedIt, ++directIt )
+    {
+    TEST_EXPECT_EQUAL( cappedIt.Get(), directIt.Get() );
+    }
+  filter->SetBilateralGridMinimumDomainSigma( 6.0 );
+  filter->AutomaticKernelSizeOff();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_TRUE( !filter->GetBilateralGridUsed() );
+
+  bool testPassed = true;
+
+  testPassed &= CompareGridAndDirect< ImageType >( size2D, 6.0, 30.0, 1.0, 1.0 );
+  testPassed &= CompareGridAndDirect< ImageType >( size2D, 6.0, 30.0, 2.0, 0.25 );
+
+  using Image3DType = itk::Image< float, 3 >;
+  Image3DType::SizeType size3D;
+  size3D[0] = 40;
+  size3D[1] = 36;
+  size3D[2] = 32;
+  testPassed &= CompareGridAndDirect< Image3DType >( size3D, 3.0, 30.0, 1.0, 1.0 );
+
+  if( !testPassed )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -104,6 +104,14 @@ namespace itk
  * pointSet->SetPointData( 1, p1 );
  * \endcode
  *
+ * The fitting is multithreaded over the points.  The points are bucketed by
+ * their first control point along the last non-closed parametric dimension
+ * and each thread accumulates its bucket range into a slab of the control
+ * point lattice, so the memory used per thread is bounded by the number of
+ * points it handles rather than the size of the lattice.  The output image
+ * is reconstructed separably with the B-spline weights evaluated once per
+ * output index along each axis.
+ *
  * \author Nicholas J. Tustison
  *
  * This code was contributed in the Insight Journal paper:
@@ -315,10 +323,16 @@ private:
   /** Function used to generate the sampled B-spline object quickly. */
   void ThreadedGenerateDataForReconstruction( const RegionType &, ThreadIdType );
 
-  /** Sub-function used by GenerateOutputImageFast() to generate the sampled
-   * B-spline object quickly. */
-  void CollapsePhiLattice( PointDataImageType *, PointDataImageType *,
-    const RealType, const unsigned int );
+  /** Evaluate the B-spline kernel of the given parametric dimension. */
+  RealType EvaluateKernel( const RealType, const unsigned int ) const;
+
+  /** Sort the points by their first control point along the split dimension
+   * and assign contiguous control point slabs to the threads. */
+  void PartitionPointsForFitting();
+
+  /** Compute the control point spans and B-spline weights of every output
+   * index along each axis for the reconstruction. */
+  void ComputeReconstructionWeights();
 
   /** Set the grid parametric domain parameters such as the origin, size,
    * spacing, and direction. */
@@ -359,6 +373,14 @@ private:
   std::vector<RealImagePointer>                m_OmegaLatticePerThread;
   std::vector<PointDataImagePointer>           m_DeltaLatticePerThread;
 
+  unsigned int                                 m_FittingSplitDimension;
+  std::vector<unsigned int>                    m_SortedPointIndices;
+  std::vector<SizeValueType>                   m_ThreadPointStart;
+  std::vector<unsigned int>                    m_ThreadSlabStart;
+
+  std::vector<unsigned int>                    m_ReconstructionSpans[ImageDimension];
+  std::vector<RealType>                        m_ReconstructionWeights[ImageDimension];
+
   RealType                                     m_BSplineEpsilon;
   bool                                         m_IsFittingComplete;
 };
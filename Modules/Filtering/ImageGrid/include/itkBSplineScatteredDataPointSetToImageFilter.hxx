@@ -21,6 +21,7 @@
 #include "itkBSplineScatteredDataPointSetToImageFilter.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "itkImageDuplicator.h"
 #include "itkCastImageFilter.h"
 #include "itkNumericTraits.h"
@@ -74,6 +75,8 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   this->m_OutputPointData = PointDataContainerType::New();
 
   this->m_PointWeights = WeightsContainerType::New();
+
+  this->m_FittingSplitDimension = ImageDimension - 1;
 }
 
 template<typename TInputPointSet, typename TOutputImage>
@@ -408,8 +411,12 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 
   this->m_IsFittingComplete = true;
 
+  std::vector<unsigned int>().swap( this->m_SortedPointIndices );
+
   if( this->m_GenerateOutputImage )
     {
+    this->ComputeReconstructionWeights();
+
     typename ImageSource<ImageType>::ThreadStruct str3;
     str3.Filter = this;
 
@@ -419,6 +426,12 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 //    this->BeforeThreadedGenerateData();
     this->GetMultiThreader()->SingleMethodExecute();
 //    this->AfterThreadedGenerateData();
+
+    for( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      std::vector<unsigned int>().swap( this->m_ReconstructionSpans[i] );
+      std::vector<RealType>().swap( this->m_ReconstructionWeights[i] );
+      }
     }
 
   this->SetPhiLatticeParametricDomainParameters();
@@ -434,21 +447,41 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     this->m_DeltaLatticePerThread.resize( this->GetNumberOfThreads() );
     this->m_OmegaLatticePerThread.resize( this->GetNumberOfThreads() );
 
-    typename RealImageType::SizeType size;
+    typename RealImageType::SizeType latticeSize;
     for( unsigned int i = 0; i < ImageDimension; i++ )
       {
       if( this->m_CloseDimension[i] )
         {
-        size[i] = this->m_CurrentNumberOfControlPoints[i] - this->m_SplineOrder[i];
+        latticeSize[i] = this->m_CurrentNumberOfControlPoints[i] - this->m_SplineOrder[i];
         }
       else
         {
-        size[i] = this->m_CurrentNumberOfControlPoints[i];
+        latticeSize[i] = this->m_CurrentNumberOfControlPoints[i];
         }
       }
 
+    this->PartitionPointsForFitting();
+
+    // Each thread only allocates the slab of the lattice along the split
+    // dimension that its points contribute to.
+
+    const unsigned int splitDimension = this->m_FittingSplitDimension;
     for( unsigned int n = 0; n < this->GetNumberOfThreads(); n++ )
       {
+      this->m_OmegaLatticePerThread[n] = nullptr;
+      this->m_DeltaLatticePerThread[n] = nullptr;
+      if( this->m_ThreadPointStart[n] == this->m_ThreadPointStart[n + 1] )
+        {
+        continue;
+        }
+
+      typename RealImageType::SizeType size = latticeSize;
+      if( !this->m_CloseDimension[splitDimension] )
+        {
+        size[splitDimension] = this->m_ThreadSlabStart[n + 1] -
+          this->m_ThreadSlabStart[n] + this->m_SplineOrder[splitDimension];
+        }
+
       this->m_OmegaLatticePerThread[n] = RealImageType::New();
       this->m_OmegaLatticePerThread[n]->SetRegions( size );
       this->m_OmegaLatticePerThread[n]->Allocate();
@@ -462,6 +495,98 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     }
 }
 
+template<typename TInputPointSet, typename TOutputImage>
+void
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::PartitionPointsForFitting()
+{
+  const TInputPointSet *input = this->GetInput();
+  const SizeValueType numberOfPoints = input->GetNumberOfPoints();
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+
+  // Split along the last parametric dimension which is not closed.  If all
+  // the dimensions are closed, every thread uses the whole lattice.
+
+  this->m_FittingSplitDimension = ImageDimension - 1;
+  for( int i = ImageDimension - 1; i >= 0; i-- )
+    {
+    if( !this->m_CloseDimension[i] )
+      {
+      this->m_FittingSplitDimension = i;
+      break;
+      }
+    }
+  const unsigned int d = this->m_FittingSplitDimension;
+
+  const unsigned int totalNumberOfSpans =
+    this->m_CurrentNumberOfControlPoints[d] - this->m_SplineOrder[d];
+  const RealType r = static_cast<RealType>( totalNumberOfSpans ) /
+    ( static_cast<RealType>( this->m_Size[d] - 1 ) * this->m_Spacing[d] );
+  const RealType epsilon = r * this->m_Spacing[d] * this->m_BSplineEpsilon;
+
+  // Bucket the points by their first control point along the split
+  // dimension.  Points outside the parametric domain are reported when
+  // the lattice is accumulated.
+
+  std::vector<unsigned int> pointSpans( numberOfPoints );
+  std::vector<SizeValueType> numberOfPointsBefore( totalNumberOfSpans + 1, 0 );
+  for( SizeValueType n = 0; n < numberOfPoints; n++ )
+    {
+    PointType point;
+    point.Fill( 0.0 );
+
+    input->GetPoint( n, &point );
+
+    RealType p = ( point[d] - this->m_Origin[d] ) * r;
+    if( std::abs( p - static_cast<RealType>( totalNumberOfSpans ) ) <= epsilon )
+      {
+      p = static_cast<RealType>( totalNumberOfSpans ) - epsilon;
+      }
+
+    unsigned int span = 0;
+    if( p > NumericTraits<RealType>::ZeroValue() )
+      {
+      span = std::min( static_cast<unsigned int>( p ), totalNumberOfSpans - 1 );
+      }
+    pointSpans[n] = span;
+    numberOfPointsBefore[span + 1]++;
+    }
+  for( unsigned int s = 0; s < totalNumberOfSpans; s++ )
+    {
+    numberOfPointsBefore[s + 1] += numberOfPointsBefore[s];
+    }
+
+  this->m_SortedPointIndices.resize( numberOfPoints );
+  std::vector<SizeValueType> position( numberOfPointsBefore.begin(),
+    numberOfPointsBefore.end() - 1 );
+  for( SizeValueType n = 0; n < numberOfPoints; n++ )
+    {
+    this->m_SortedPointIndices[position[pointSpans[n]]++] = n;
+    }
+
+  // Give each thread a contiguous range of spans holding about the same
+  // number of points.
+
+  this->m_ThreadSlabStart.resize( numberOfThreads + 1 );
+  this->m_ThreadPointStart.resize( numberOfThreads + 1 );
+  this->m_ThreadSlabStart[0] = 0;
+  for( ThreadIdType n = 1; n < numberOfThreads; n++ )
+    {
+    const SizeValueType target = numberOfPoints * n / numberOfThreads;
+    unsigned int s = this->m_ThreadSlabStart[n - 1];
+    while( s < totalNumberOfSpans && numberOfPointsBefore[s] < target )
+      {
+      s++;
+      }
+    this->m_ThreadSlabStart[n] = s;
+    }
+  this->m_ThreadSlabStart[numberOfThreads] = totalNumberOfSpans;
+  for( ThreadIdType n = 0; n <= numberOfThreads; n++ )
+    {
+    this->m_ThreadPointStart[n] = numberOfPointsBefore[this->m_ThreadSlabStart[n]];
+    }
+}
+
 template<typename TInputPointSet, typename TOutputImage>
 unsigned int
 BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
@@ -575,21 +700,23 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     epsilon[i] = r[i] * this->m_Spacing[i] * this->m_BSplineEpsilon;
     }
 
-  // Determine which points should be handled by this particular thread.
+  // The points handled by this particular thread were assigned by
+  // PartitionPointsForFitting().
 
-  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
-  auto numberOfPointsPerThread = static_cast<SizeValueType>(
-    input->GetNumberOfPoints() / numberOfThreads );
+  const SizeValueType start = this->m_ThreadPointStart[threadId];
+  const SizeValueType end = this->m_ThreadPointStart[threadId + 1];
 
-  unsigned int start = threadId * numberOfPointsPerThread;
-  unsigned int end = start + numberOfPointsPerThread;
-  if( threadId == this->GetNumberOfThreads() - 1 )
+  const unsigned int splitDimension = this->m_FittingSplitDimension;
+  unsigned int slabStart = 0;
+  if( !this->m_CloseDimension[splitDimension] )
     {
-    end = input->GetNumberOfPoints();
+    slabStart = this->m_ThreadSlabStart[threadId];
     }
 
-  for( unsigned int n = start; n < end; n++ )
+  for( SizeValueType m = start; m < end; m++ )
     {
+    const unsigned int n = this->m_SortedPointIndices[m];
+
     PointType point;
     point.Fill( 0.0 );
 
@@ -677,6 +804,7 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
           idx[i] %= size[i];
           }
         }
+      idx[splitDimension] -= slabStart;
       RealType wc = this->m_PointWeights->GetElement(n);
       RealType t = ItW.Get();
       currentThreadOmegaLattice->SetPixel( idx,
@@ -692,110 +820,193 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 template<typename TInputPointSet, typename TOutputImage>
 void
 BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
-::ThreadedGenerateDataForReconstruction( const RegionType &region, ThreadIdType
-  itkNotUsed( threadId ) )
+::ComputeReconstructionWeights()
 {
-  typename PointDataImageType::Pointer collapsedPhiLattices[ImageDimension + 1];
+  const RegionType & requestedRegion = this->GetOutput()->GetRequestedRegion();
+
   for( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    collapsedPhiLattices[i] = PointDataImageType::New();
-    collapsedPhiLattices[i]->CopyInformation( this->m_PhiLattice );
-
-    typename PointDataImageType::SizeType size;
-    size.Fill(1);
-    for( unsigned int j = 0; j < i; j++ )
+    unsigned int totalNumberOfSpans =
+      this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[i];
+    if( !this->m_CloseDimension[i] )
       {
-      size[j] = this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[j];
+      totalNumberOfSpans -= this->m_SplineOrder[i];
       }
-    collapsedPhiLattices[i]->SetRegions( size );
-    collapsedPhiLattices[i]->Allocate();
-    }
-  using ImageDuplicatorType = ImageDuplicator<PointDataImageType>;
-  typename ImageDuplicatorType::Pointer duplicator = ImageDuplicatorType::New();
-  duplicator->SetInputImage( this->m_PhiLattice );
-  duplicator->Update();
 
-  collapsedPhiLattices[ImageDimension] = duplicator->GetOutput();
+    const RealType r = static_cast<RealType>( totalNumberOfSpans ) /
+      ( static_cast<RealType>( this->m_Size[i] - 1 ) * this->m_Spacing[i] );
+    const RealType epsilon = r * this->m_Spacing[i] * this->m_BSplineEpsilon;
 
-  ArrayType totalNumberOfSpans;
-  for( unsigned int i = 0; i < ImageDimension; i++ )
-    {
-    if( this->m_CloseDimension[i] )
-      {
-      totalNumberOfSpans[i] =
-        this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[i];
-      }
-    else
+    const SizeValueType size = requestedRegion.GetSize()[i];
+    const unsigned int numberOfWeights = this->m_SplineOrder[i] + 1;
+
+    this->m_ReconstructionSpans[i].resize( size );
+    this->m_ReconstructionWeights[i].resize( size * numberOfWeights );
+
+    for( SizeValueType c = 0; c < size; c++ )
       {
-      totalNumberOfSpans[i] =
-        this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[i] -
-        this->m_SplineOrder[i];
+      RealType U = static_cast<RealType>( totalNumberOfSpans ) *
+        static_cast<RealType>( c ) / static_cast<RealType>( this->m_Size[i] - 1 );
+
+      if( std::abs( U - static_cast<RealType>( totalNumberOfSpans ) ) <= epsilon )
+        {
+        U = static_cast<RealType>( totalNumberOfSpans ) - epsilon;
+        }
+      if( U < NumericTraits<RealType>::ZeroValue() && std::abs( U ) <= epsilon )
+        {
+        U = NumericTraits<RealType>::ZeroValue();
+        }
+
+      if( U < NumericTraits<RealType>::ZeroValue() ||
+          U >= static_cast<RealType>( totalNumberOfSpans ) )
+        {
+        itkExceptionMacro( "The collapse point component " << U
+          << " is outside the corresponding parametric domain of [0, "
+          << totalNumberOfSpans << ")." );
+        }
+
+      const auto span = static_cast<unsigned int>( U );
+      this->m_ReconstructionSpans[i][c] = span;
+      for( unsigned int k = 0; k < numberOfWeights; k++ )
+        {
+        RealType v = U - static_cast<IndexValueType>( span + k ) + 0.5 *
+          static_cast<RealType>( this->m_SplineOrder[i] - 1 );
+        this->m_ReconstructionWeights[i][c * numberOfWeights + k] =
+          this->EvaluateKernel( v, i );
+        }
       }
     }
+}
 
-  RealArrayType r;
-  for( unsigned int i = 0; i < ImageDimension; i++ )
+template<typename TInputPointSet, typename TOutputImage>
+void
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::ThreadedGenerateDataForReconstruction( const RegionType &region, ThreadIdType
+  itkNotUsed( threadId ) )
+{
+  // The control point lattice is collapsed one dimension at a time, from the
+  // last to the first, using the weights computed once per output index in
+  // ComputeReconstructionWeights().  collapsedLattices[j] holds the lattice
+  // collapsed along dimensions j to ImageDimension - 1 and is only updated
+  // when the output index changes in dimension j.
+
+  const typename PointDataImageType::SizeType latticeSize =
+    this->m_PhiLattice->GetLargestPossibleRegion().GetSize();
+
+  SizeValueType collapsedSize[ImageDimension + 1];
+  collapsedSize[0] = 1;
+  for( unsigned int j = 0; j < ImageDimension; j++ )
     {
-    r[i] = static_cast<RealType>( totalNumberOfSpans[i] ) /
-      ( static_cast<RealType>( this->m_Size[i] - 1 ) * this->m_Spacing[i] );
+    collapsedSize[j + 1] = collapsedSize[j] * latticeSize[j];
     }
 
-  RealArrayType epsilon;
-  for( unsigned int i = 0; i < ImageDimension; i++ )
+  std::vector<PointDataType> collapsedLattices[ImageDimension];
+  const PointDataType * lattices[ImageDimension + 1];
+  lattices[ImageDimension] = this->m_PhiLattice->GetBufferPointer();
+  for( unsigned int j = 1; j < ImageDimension; j++ )
     {
-    epsilon[i] = r[i] * this->m_Spacing[i] * this->m_BSplineEpsilon;
+    collapsedLattices[j].resize( collapsedSize[j] );
+    lattices[j] = collapsedLattices[j].data();
     }
 
-  FixedArray<RealType, ImageDimension> U;
-  FixedArray<RealType, ImageDimension> currentU;
-  currentU.Fill( -1 );
+  const IndexType startIndex = this->GetOutput()->GetRequestedRegion().GetIndex();
 
-  typename ImageType::IndexType startIndex =
-    this->GetOutput()->GetRequestedRegion().GetIndex();
-  typename PointDataImageType::IndexType startPhiIndex =
-    this->m_PhiLattice->GetLargestPossibleRegion().GetIndex();
+  IndexType currentIndex;
+  currentIndex.Fill( NumericTraits<IndexValueType>::max() );
 
-  ImageRegionIteratorWithIndex<ImageType> It( this->GetOutput(), region );
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  ImageScanlineIterator<ImageType> It( this->GetOutput(), region );
+  while( !It.IsAtEnd() )
     {
-    typename ImageType::IndexType idx = It.GetIndex();
-    for( unsigned int i = 0; i < ImageDimension; i++ )
+    const IndexType lineIndex = It.GetIndex();
+    for( int i = ImageDimension - 1; i >= 1; i-- )
       {
-      U[i] = static_cast<RealType>( totalNumberOfSpans[i] ) *
-        static_cast<RealType>( idx[i] - startIndex[i] ) /
-        static_cast<RealType>( this->m_Size[i] - 1 );
-
-      if( std::abs( U[i] - static_cast<RealType>( totalNumberOfSpans[i] ) ) <= epsilon[i] )
-        {
-        U[i] = static_cast<RealType>( totalNumberOfSpans[i] ) - epsilon[i];
-        }
-      if( U[i] < NumericTraits<RealType>::ZeroValue() && std::abs( U[i] ) <= epsilon[i] )
-        {
-        U[i] = NumericTraits<RealType>::ZeroValue();
-        }
-
-      if( U[i] < NumericTraits<RealType>::ZeroValue() ||
-          U[i] >= static_cast<RealType>( totalNumberOfSpans[i] ) )
+      if( lineIndex[i] != currentIndex[i] )
         {
-        itkExceptionMacro( "The collapse point component " << U[i]
-          << " is outside the corresponding parametric domain of [0, "
-          << totalNumberOfSpans[i] << ")." );
+        for( int j = i; j >= 1; j-- )
+          {
+          const SizeValueType c = lineIndex[j] - startIndex[j];
+          const unsigned int numberOfWeights = this->m_SplineOrder[j] + 1;
+          const unsigned int span = this->m_ReconstructionSpans[j][c];
+          const RealType * B = &this->m_ReconstructionWeights[j][c * numberOfWeights];
+
+          const PointDataType * lattice = lattices[j + 1];
+          PointDataType * collapsedLattice = collapsedLattices[j].data();
+          for( SizeValueType m = 0; m < collapsedSize[j]; m++ )
+            {
+            PointDataType data;
+            data.Fill( 0.0 );
+            for( unsigned int k = 0; k < numberOfWeights; k++ )
+              {
+              SizeValueType idx = span + k;
+              if( this->m_CloseDimension[j] )
+                {
+                idx %= latticeSize[j];
+                }
+              data += ( lattice[m + idx * collapsedSize[j]] * B[k] );
+              }
+            collapsedLattice[m] = data;
+            }
+          currentIndex[j] = lineIndex[j];
+          }
+        break;
         }
       }
-    for( int i = ImageDimension - 1; i >= 0; i-- )
+
+    const unsigned int numberOfWeights = this->m_SplineOrder[0] + 1;
+    const PointDataType * lattice = lattices[1];
+    SizeValueType c = lineIndex[0] - startIndex[0];
+    while( !It.IsAtEndOfLine() )
       {
-      if( Math::NotExactlyEquals(U[i], currentU[i]) )
+      const unsigned int span = this->m_ReconstructionSpans[0][c];
+      const RealType * B = &this->m_ReconstructionWeights[0][c * numberOfWeights];
+
+      PointDataType data;
+      data.Fill( 0.0 );
+      for( unsigned int k = 0; k < numberOfWeights; k++ )
         {
-        for( int j = i; j >= 0; j-- )
+        SizeValueType idx = span + k;
+        if( this->m_CloseDimension[0] )
           {
-          this->CollapsePhiLattice( collapsedPhiLattices[j + 1],
-            collapsedPhiLattices[j], U[j], j );
-          currentU[j] = U[j];
+          idx %= latticeSize[0];
           }
-        break;
+        data += ( lattice[idx] * B[k] );
         }
+      It.Set( data );
+
+      ++It;
+      ++c;
+      }
+    It.NextLine();
+    }
+}
+
+template<typename TInputPointSet, typename TOutputImage>
+typename BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>::RealType
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::EvaluateKernel( const RealType u, const unsigned int dimension ) const
+{
+  switch( this->m_SplineOrder[dimension] )
+    {
+    case 0:
+      {
+      return this->m_KernelOrder0->Evaluate( u );
+      }
+    case 1:
+      {
+      return this->m_KernelOrder1->Evaluate( u );
+      }
+    case 2:
+      {
+      return this->m_KernelOrder2->Evaluate( u );
+      }
+    case 3:
+      {
+      return this->m_KernelOrder3->Evaluate( u );
+      }
+    default:
+      {
+      return this->m_Kernel[dimension]->Evaluate( u );
       }
-    It.Set( collapsedPhiLattices[0]->GetPixel( startPhiIndex ) );
     }
 }
 
@@ -806,18 +1017,51 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 {
   if( !this->m_IsFittingComplete )
     {
-    // Accumulate all the delta lattice and omega lattice values to
+    // Generate the control point lattice
+
+    typename RealImageType::SizeType size;
+    for( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      if( this->m_CloseDimension[i] )
+        {
+        size[i] = this->m_CurrentNumberOfControlPoints[i] - this->m_SplineOrder[i];
+        }
+      else
+        {
+        size[i] = this->m_CurrentNumberOfControlPoints[i];
+        }
+      }
+
+    // Accumulate all the delta lattice and omega lattice slabs to
     // calculate the final phi lattice.
 
-    ImageRegionIterator< PointDataImageType > ItD(
-      this->m_DeltaLatticePerThread[0],
-      this->m_DeltaLatticePerThread[0]->GetLargestPossibleRegion() );
-    ImageRegionIterator< RealImageType > ItO(
-      this->m_OmegaLatticePerThread[0],
-      this->m_OmegaLatticePerThread[0]->GetLargestPossibleRegion() );
+    RealImagePointer omegaLattice = RealImageType::New();
+    omegaLattice->SetRegions( size );
+    omegaLattice->Allocate();
+    omegaLattice->FillBuffer( 0.0 );
 
-    for( ThreadIdType n = 1; n < this->GetNumberOfThreads(); n++ )
+    PointDataImagePointer deltaLattice = PointDataImageType::New();
+    deltaLattice->SetRegions( size );
+    deltaLattice->Allocate();
+    deltaLattice->FillBuffer( NumericTraits<PointDataType>::ZeroValue() );
+
+    const unsigned int splitDimension = this->m_FittingSplitDimension;
+    for( ThreadIdType n = 0; n < this->GetNumberOfThreads(); n++ )
       {
+      if( this->m_OmegaLatticePerThread[n].IsNull() )
+        {
+        continue;
+        }
+
+      typename RealImageType::RegionType slabRegion =
+        this->m_OmegaLatticePerThread[n]->GetLargestPossibleRegion();
+      if( !this->m_CloseDimension[splitDimension] )
+        {
+        slabRegion.SetIndex( splitDimension, this->m_ThreadSlabStart[n] );
+        }
+
+      ImageRegionIterator< PointDataImageType > ItD( deltaLattice, slabRegion );
+      ImageRegionIterator< RealImageType > ItO( omegaLattice, slabRegion );
       ImageRegionIterator< PointDataImageType > Itd(
         this->m_DeltaLatticePerThread[n],
         this->m_DeltaLatticePerThread[n]->GetLargestPossibleRegion() );
@@ -825,10 +1069,6 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
         this->m_OmegaLatticePerThread[n],
         this->m_OmegaLatticePerThread[n]->GetLargestPossibleRegion() );
 
-      ItD.GoToBegin();
-      ItO.GoToBegin();
-      Itd.GoToBegin();
-      Ito.GoToBegin();
       while( !ItD.IsAtEnd() )
         {
         ItD.Set( ItD.Get() + Itd.Get() );
@@ -839,22 +1079,15 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
         ++Itd;
         ++Ito;
         }
-      }
-
-    // Generate the control point lattice
 
-    typename RealImageType::SizeType size;
-    for( unsigned int i = 0; i < ImageDimension; i++ )
-      {
-      if( this->m_CloseDimension[i] )
-        {
-        size[i] = this->m_CurrentNumberOfControlPoints[i] - this->m_SplineOrder[i];
-        }
-      else
-        {
-        size[i] = this->m_CurrentNumberOfControlPoints[i];
-        }
+      this->m_OmegaLatticePerThread[n] = nullptr;
+      this->m_DeltaLatticePerThread[n] = nullptr;
       }
+
+    ImageRegionIterator< PointDataImageType > ItD(
+      deltaLattice, deltaLattice->GetLargestPossibleRegion() );
+    ImageRegionIterator< RealImageType > ItO(
+      omegaLattice, omegaLattice->GetLargestPossibleRegion() );
     this->m_PhiLattice = PointDataImageType::New();
     this->m_PhiLattice->SetRegions( size );
     this->m_PhiLattice->Allocate();
@@ -1047,37 +1280,20 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 ::UpdatePointSet()
 {
   const TInputPointSet *input = this->GetInput();
-  PointDataImagePointer collapsedPhiLattices[ImageDimension + 1];
-  for( unsigned int i = 0; i < ImageDimension; i++ )
-    {
-    collapsedPhiLattices[i] = PointDataImageType::New();
-    collapsedPhiLattices[i]->SetOrigin( this->m_PhiLattice->GetOrigin() );
-    collapsedPhiLattices[i]->SetSpacing( this->m_PhiLattice->GetSpacing() );
-    collapsedPhiLattices[i]->SetDirection( this->m_PhiLattice->GetDirection() );
-
-    typename PointDataImageType::SizeType size;
-    size.Fill( 1 );
-    for( unsigned int j = 0; j < i; j++ )
-      {
-      size[j] = this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[j];
-      }
-    collapsedPhiLattices[i]->SetRegions( size );
-    collapsedPhiLattices[i]->Allocate();
-    }
-  collapsedPhiLattices[ImageDimension] = this->m_PhiLattice;
+
+  const typename PointDataImageType::SizeType latticeSize =
+    this->m_PhiLattice->GetLargestPossibleRegion().GetSize();
+
   ArrayType totalNumberOfSpans;
   for( unsigned int i = 0; i < ImageDimension; i++ )
     {
     if( this->m_CloseDimension[i] )
       {
-      totalNumberOfSpans[i] =
-        this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[i];
+      totalNumberOfSpans[i] = latticeSize[i];
       }
     else
       {
-      totalNumberOfSpans[i] =
-        this->m_PhiLattice->GetLargestPossibleRegion().GetSize()[i] -
-        this->m_SplineOrder[i];
+      totalNumberOfSpans[i] = latticeSize[i] - this->m_SplineOrder[i];
       }
     }
 
@@ -1094,12 +1310,33 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     epsilon[i] = r[i] * this->m_Spacing[i] * this->m_BSplineEpsilon;
     }
 
-  FixedArray<RealType, ImageDimension> U;
-  FixedArray<RealType, ImageDimension> currentU;
-  currentU.Fill( -1 );
+  // Each point only depends on the (SplineOrder + 1)^ImageDimension control
+  // points around it, so only that neighborhood is gathered and collapsed,
+  // one dimension at a time from the last to the first.
+
+  SizeValueType latticeStride[ImageDimension];
+  SizeValueType neighborhoodStride[ImageDimension + 1];
+  latticeStride[0] = 1;
+  neighborhoodStride[0] = 1;
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    if( i > 0 )
+      {
+      latticeStride[i] = latticeStride[i - 1] * latticeSize[i - 1];
+      }
+    neighborhoodStride[i + 1] = neighborhoodStride[i] * ( this->m_SplineOrder[i] + 1 );
+    }
+  std::vector<PointDataType> neighborhood( neighborhoodStride[ImageDimension] );
+  std::vector<RealType> weights[ImageDimension];
+  unsigned int spans[ImageDimension];
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    weights[i].resize( this->m_SplineOrder[i] + 1 );
+    }
 
-  typename PointDataImageType::IndexType startPhiIndex =
-    this->m_PhiLattice->GetLargestPossibleRegion().GetIndex();
+  const PointDataType * phi = this->m_PhiLattice->GetBufferPointer();
+
+  FixedArray<RealType, ImageDimension> U;
 
   typename PointDataContainerType::ConstIterator ItIn =
     this->m_InputPointData->Begin();
@@ -1132,84 +1369,50 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
           << " is outside the corresponding parametric domain of [0, "
           << totalNumberOfSpans[i] << ")." );
         }
+
+      spans[i] = static_cast<unsigned int>( U[i] );
+      for( unsigned int k = 0; k <= this->m_SplineOrder[i]; k++ )
+        {
+        RealType v = U[i] - static_cast<IndexValueType>( spans[i] + k ) + 0.5 *
+          static_cast<RealType>( this->m_SplineOrder[i] - 1 );
+        weights[i][k] = this->EvaluateKernel( v, i );
+        }
       }
-    for( int i = ImageDimension - 1; i >= 0; i-- )
+
+    // Gather the control point neighborhood.
+    for( SizeValueType m = 0; m < neighborhoodStride[ImageDimension]; m++ )
       {
-      if( Math::NotExactlyEquals(U[i], currentU[i]) )
+      SizeValueType latticeOffset = 0;
+      for( unsigned int i = 0; i < ImageDimension; i++ )
         {
-        for( int j = i; j >= 0; j-- )
+        SizeValueType idx = spans[i] +
+          ( m / neighborhoodStride[i] ) % ( this->m_SplineOrder[i] + 1 );
+        if( this->m_CloseDimension[i] )
           {
-          this->CollapsePhiLattice( collapsedPhiLattices[j + 1],
-            collapsedPhiLattices[j], U[j], j );
-          currentU[j] = U[j];
+          idx %= latticeSize[i];
           }
-        break;
+        latticeOffset += idx * latticeStride[i];
         }
+      neighborhood[m] = phi[latticeOffset];
       }
-    this->m_OutputPointData->InsertElement( ItIn.Index(),
-      collapsedPhiLattices[0]->GetPixel( startPhiIndex ) );
-    ++ItIn;
-    }
-}
-
-template<typename TInputPointSet, typename TOutputImage>
-void
-BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
-::CollapsePhiLattice( PointDataImageType *lattice,
-  PointDataImageType *collapsedLattice,
-  const RealType u, const unsigned int dimension )
-{
-  ImageRegionIteratorWithIndex< PointDataImageType > It(
-    collapsedLattice, collapsedLattice->GetLargestPossibleRegion() );
 
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
-    {
-    PointDataType data;
-    data.Fill( 0.0 );
-    typename PointDataImageType::IndexType idx = It.GetIndex();
-    for( unsigned int i = 0; i < this->m_SplineOrder[dimension] + 1; i++ )
+    // Collapse it.
+    for( int j = ImageDimension - 1; j >= 0; j-- )
       {
-      idx[dimension] = static_cast<unsigned int>( u ) + i;
-      RealType v = u - idx[dimension] + 0.5 * static_cast<RealType>(
-        this->m_SplineOrder[dimension] - 1 );
-
-      RealType B = 0.0;
-      switch( this->m_SplineOrder[dimension] )
+      for( SizeValueType m = 0; m < neighborhoodStride[j]; m++ )
         {
-        case 0:
+        PointDataType data;
+        data.Fill( 0.0 );
+        for( unsigned int k = 0; k <= this->m_SplineOrder[j]; k++ )
           {
-          B = this->m_KernelOrder0->Evaluate( v );
-          break;
-          }
-        case 1:
-          {
-          B = this->m_KernelOrder1->Evaluate( v );
-          break;
-          }
-        case 2:
-          {
-          B = this->m_KernelOrder2->Evaluate( v );
-          break;
-          }
-        case 3:
-          {
-          B = this->m_KernelOrder3->Evaluate( v );
-          break;
-          }
-        default:
-          {
-          B = this->m_Kernel[dimension]->Evaluate( v );
-          break;
+          data += ( neighborhood[m + k * neighborhoodStride[j]] * weights[j][k] );
           }
+        neighborhood[m] = data;
         }
-      if( this->m_CloseDimension[dimension] )
-        {
-        idx[dimension] %=
-          lattice->GetLargestPossibleRegion().GetSize()[dimension];
-        }
-      data += ( lattice->GetPixel( idx ) * B );
       }
-    It.Set( data );
+
+    this->m_OutputPointData->InsertElement( ItIn.Index(), neighborhood[0] );
+    ++ItIn;
     }
 }
 
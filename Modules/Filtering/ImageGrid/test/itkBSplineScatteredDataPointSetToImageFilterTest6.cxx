@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineScatteredDataPointSetToImageFilter.h"
+#include "itkBSplineControlPointImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+/**
+ * In this test, we approximate scattered samples of a smooth 2-D vector
+ * field and 3-D scalar field and check that
+ *  - the fitted control point lattice does not depend on the number of
+ *    threads used to accumulate it, and
+ *  - the sampled output matches the reconstruction of the control point
+ *    lattice by BSplineControlPointImageFilter.
+ */
+namespace
+{
+
+template< typename TImage >
+double
+MaximumDifference( const TImage * image1, const TImage * image2 )
+{
+  double difference = 0.0;
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image2->GetLargestPossibleRegion() );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    for( unsigned int i = 0; i < it1.Get().Size(); i++ )
+      {
+      difference = std::max( difference,
+        std::abs( static_cast< double >( it1.Get()[i] ) - static_cast< double >( it2.Get()[i] ) ) );
+      }
+    }
+  return difference;
+}
+
+template< unsigned int VDimension, unsigned int VDataDimension >
+bool
+FitScatteredData( unsigned int numberOfPoints, unsigned int numberOfLevels )
+{
+  using VectorType = itk::Vector< float, VDataDimension >;
+  using ImageType = itk::Image< VectorType, VDimension >;
+  using PointSetType = itk::PointSet< VectorType, VDimension >;
+  using FilterType = itk::BSplineScatteredDataPointSetToImageFilter< PointSetType, ImageType >;
+  using LatticeType = typename FilterType::PointDataImageType;
+
+  typename ImageType::SizeType size;
+  typename ImageType::SpacingType spacing;
+  typename ImageType::PointType origin;
+  for( unsigned int d = 0; d < VDimension; d++ )
+    {
+    size[d] = 40 + 7 * d;
+    spacing[d] = 0.5 + 0.25 * d;
+    origin[d] = -2.0 + d;
+    }
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 2018 );
+
+  typename PointSetType::Pointer pointSet = PointSetType::New();
+  for( unsigned int n = 0; n < numberOfPoints; n++ )
+    {
+    typename PointSetType::PointType point;
+    double phase = 0.0;
+    for( unsigned int d = 0; d < VDimension; d++ )
+      {
+      point[d] = origin[d] + generator->GetUniformVariate( 0.0, ( size[d] - 1 ) * spacing[d] );
+      phase += ( point[d] - origin[d] ) / ( ( size[d] - 1 ) * spacing[d] );
+      }
+    VectorType data;
+    for( unsigned int i = 0; i < VDataDimension; i++ )
+      {
+      data[i] = std::sin( 3.0 * phase + i ) + generator->GetNormalVariate( 0.0, 0.01 );
+      }
+    pointSet->SetPoint( n, point );
+    pointSet->SetPointData( n, data );
+    }
+
+  typename FilterType::ArrayType numberOfControlPoints;
+  numberOfControlPoints.Fill( 5 );
+
+  typename ImageType::Pointer outputs[2];
+  typename LatticeType::Pointer lattices[2];
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 5 };
+  for( unsigned int n = 0; n < 2; n++ )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( pointSet );
+    filter->SetOrigin( origin );
+    filter->SetSpacing( spacing );
+    filter->SetSize( size );
+    filter->SetSplineOrder( 3 );
+    filter->SetNumberOfControlPoints( numberOfControlPoints );
+    filter->SetNumberOfLevels( numberOfLevels );
+    filter->SetNumberOfThreads( numberOfThreads[n] );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    outputs[n] = filter->GetOutput();
+    lattices[n] = filter->GetPhiLattice();
+    }
+
+  const double threadDifference = MaximumDifference< LatticeType >( lattices[0], lattices[1] );
+
+  // Reconstruct the output from the lattice independently.
+  using ReconstructerType = itk::BSplineControlPointImageFilter< LatticeType, ImageType >;
+  typename ReconstructerType::Pointer reconstructer = ReconstructerType::New();
+  reconstructer->SetInput( lattices[1] );
+  reconstructer->SetOrigin( origin );
+  reconstructer->SetSpacing( spacing );
+  reconstructer->SetSize( size );
+  reconstructer->SetSplineOrder( 3 );
+  TRY_EXPECT_NO_EXCEPTION( reconstructer->Update() );
+
+  const double reconstructionDifference =
+    MaximumDifference< ImageType >( outputs[1], reconstructer->GetOutput() );
+
+  std::cout << VDimension << "-D, " << numberOfPoints << " points, " << numberOfLevels
+            << " levels: lattice difference between 1 and 5 threads " << threadDifference
+            << ", difference from the control point reconstruction "
+            << reconstructionDifference << std::endl;
+
+  const double tolerance = 1e-4;
+  if( threadDifference > tolerance || reconstructionDifference > tolerance )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Difference larger than " << tolerance << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end namespace
+
+int itkBSplineScatteredDataPointSetToImageFilterTest6( int, char * [] )
+{
+  bool testPassed = true;
+
+  testPassed &= FitScatteredData< 2, 2 >( 2000, 1 );
+  testPassed &= FitScatteredData< 2, 2 >( 2000, 4 );
+  testPassed &= FitScatteredData< 3, 1 >( 5000, 3 );
+
+  if( !testPassed )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
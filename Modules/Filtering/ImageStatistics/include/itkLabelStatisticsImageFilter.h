@@ -24,6 +24,8 @@
 #include "itksys/hash_map.hxx"
 #include "itkHistogram.h"
 #include "itkFastMutexLock.h"
+#include "itkCompensatedSummation.h"
+#include "itkFixedArray.h"
 #include <vector>
 
 namespace itk
@@ -49,6 +51,13 @@ namespace itk
  * threaded. It computes statistics in each thread then combines them in
  * its AfterThreadedGenerate method.
  *
+ * When the label image is of an integral type and its labels span a range
+ * that is small compared to the number of pixels per thread, each thread
+ * accumulates its statistics (and histograms) in flat arrays indexed by
+ * label instead of a hash map. Sums are accumulated with
+ * CompensatedSummation and the threads are combined in a fixed order, so
+ * the results do not drift with the number of threads used.
+ *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITKImageStatistics
  *
@@ -353,7 +362,49 @@ protected:
   void EnlargeOutputRequestedRegion(DataObject *data) override;
 
 private:
-  std::vector< MapType >        m_LabelStatisticsPerThread;
+  /** Statistics of one label accumulated by one thread. */
+  struct LabelAccumulator
+  {
+    LabelAccumulator();
+
+    IdentifierType                                   m_Count;
+    CompensatedSummation< RealType >                 m_Sum;
+    CompensatedSummation< RealType >                 m_SumOfSquares;
+    RealType                                         m_Minimum;
+    RealType                                         m_Maximum;
+    FixedArray< IndexValueType, 2 * ImageDimension > m_BoundingBox;
+    /** Offset of the histogram of the label in the frequencies of the
+     * thread, or NumericTraits< SizeValueType >::max() if there is none. */
+    SizeValueType                                    m_HistogramOffset;
+  };
+
+  using AccumulatorMapType = itksys::hash_map< LabelPixelType, LabelAccumulator >;
+
+  /** Everything a thread accumulates. Only one of the dense labels and
+   * the sparse labels is used, depending on m_UseDenseLabels. */
+  struct ThreadAccumulator
+  {
+    std::vector< LabelAccumulator > m_DenseLabels;
+    AccumulatorMapType              m_SparseLabels;
+    std::vector< IdentifierType >   m_Frequencies;
+  };
+
+  /** Decide whether the labels can be accumulated in flat arrays. */
+  void ComputeDenseLabelRange();
+
+  /** Add the statistics a thread accumulated for a label to a total. */
+  void MergeLabelAccumulator(LabelAccumulator & total,
+                             std::vector< IdentifierType > & totalFrequencies,
+                             const LabelAccumulator & part,
+                             const std::vector< IdentifierType > & partFrequencies) const;
+
+  /** Compute the final statistics of a label from its total. */
+  void AddLabelStatistics(LabelPixelType label,
+                          const LabelAccumulator & total,
+                          const std::vector< IdentifierType > & frequencies);
+
+  std::vector< ThreadAccumulator > m_ThreadAccumulators;
+
   MapType                       m_LabelStatistics;
   ValidLabelValuesContainerType m_ValidLabelValues;
 
@@ -363,6 +414,14 @@ private:
 
   RealType            m_LowerBound;
   RealType            m_UpperBound;
+
+  /** Histogram shared read-only by the threads to bin the values. */
+  HistogramPointer    m_BinningHistogram;
+
+  bool                m_UseDenseLabels;
+  LabelPixelType      m_DenseLabelMinimum;
+  SizeValueType       m_NumberOfDenseLabels;
+
   SimpleFastMutexLock m_Mutex;
 }; // end of class
 } // end namespace itk
@@ -21,6 +21,7 @@
 
 #include "itkImageLinearConstIteratorWithIndex.h"
 #include "itkImageScanlineConstIterator.h"
+#include "itkMinimumMaximumImageFilter.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -36,6 +37,9 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
   m_LowerBound = static_cast< RealType >( NumericTraits< PixelType >::NonpositiveMin() );
   m_UpperBound = static_cast< RealType >( NumericTraits< PixelType >::max() );
   m_ValidLabelValues.clear();
+  m_UseDenseLabels = false;
+  m_DenseLabelMinimum = NumericTraits< LabelPixelType >::ZeroValue();
+  m_NumberOfDenseLabels = 0;
 }
 
 template< typename TInputImage, typename TLabelImage >
@@ -72,6 +76,63 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
   m_UseHistograms = true;
 }
 
+template< typename TInputImage, typename TLabelImage >
+LabelStatisticsImageFilter< TInputImage, TLabelImage >
+::LabelAccumulator::LabelAccumulator()
+{
+  m_Count = NumericTraits< IdentifierType >::ZeroValue();
+
+  // Set such that the first pixel encountered can be compared
+  m_Minimum = NumericTraits< RealType >::max();
+  m_Maximum = NumericTraits< RealType >::NonpositiveMin();
+
+  for ( unsigned int i = 0; i < ImageDimension * 2; i += 2 )
+    {
+    m_BoundingBox[i] = NumericTraits< IndexValueType >::max();
+    m_BoundingBox[i + 1] = NumericTraits< IndexValueType >::NonpositiveMin();
+    }
+
+  m_HistogramOffset = NumericTraits< SizeValueType >::max();
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+LabelStatisticsImageFilter< TInputImage, TLabelImage >
+::ComputeDenseLabelRange()
+{
+  m_UseDenseLabels = false;
+  m_DenseLabelMinimum = NumericTraits< LabelPixelType >::ZeroValue();
+  m_NumberOfDenseLabels = 0;
+
+  if ( !NumericTraits< LabelPixelType >::is_integer )
+    {
+    return;
+    }
+
+  using MinimumMaximumFilterType = MinimumMaximumImageFilter< TLabelImage >;
+  typename MinimumMaximumFilterType::Pointer minimumMaximum = MinimumMaximumFilterType::New();
+  minimumMaximum->SetInput( this->GetLabelInput() );
+  minimumMaximum->SetNumberOfThreads( this->GetNumberOfThreads() );
+  minimumMaximum->Update();
+
+  // The flat arrays are worth it as long as they are not larger than
+  // the part of the image a thread visits; beyond a fixed number of
+  // labels their memory outweighs the hash map.
+  const double numberOfLabels = static_cast< double >( minimumMaximum->GetMaximum() )
+    - static_cast< double >( minimumMaximum->GetMinimum() ) + 1.0;
+  const double numberOfPixelsPerThread =
+    static_cast< double >( this->GetLabelInput()->GetRequestedRegion().GetNumberOfPixels() )
+    / static_cast< double >( this->GetNumberOfThreads() );
+  const double maximumNumberOfDenseLabels = 65536.0;
+
+  if ( numberOfLabels <= numberOfPixelsPerThread && numberOfLabels <= maximumNumberOfDenseLabels )
+    {
+    m_UseDenseLabels = true;
+    m_DenseLabelMinimum = minimumMaximum->GetMinimum();
+    m_NumberOfDenseLabels = static_cast< SizeValueType >( numberOfLabels );
+    }
+}
+
 template< typename TInputImage, typename TLabelImage >
 void
 LabelStatisticsImageFilter< TInputImage, TLabelImage >
@@ -79,13 +140,24 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 {
   ThreadIdType numberOfThreads = this->GetNumberOfThreads();
 
-  // Resize the thread temporaries
-  m_LabelStatisticsPerThread.resize(numberOfThreads);
+  this->ComputeDenseLabelRange();
 
-  // Initialize the temporaries
-  for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+  // The threads share a histogram to find the bin of each value
+  m_BinningHistogram = nullptr;
+  if ( m_UseHistograms )
     {
-    m_LabelStatisticsPerThread[i].clear();
+    m_BinningHistogram = LabelStatistics(m_NumBins[0], m_LowerBound, m_UpperBound).m_Histogram;
+    }
+
+  // Resize and initialize the thread temporaries
+  m_ThreadAccumulators.clear();
+  m_ThreadAccumulators.resize(numberOfThreads);
+  if ( m_UseDenseLabels )
+    {
+    for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+      {
+      m_ThreadAccumulators[i].m_DenseLabels.resize(m_NumberOfDenseLabels);
+      }
     }
 
   // Initialize the final map
@@ -95,120 +167,179 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 template< typename TInputImage, typename TLabelImage >
 void
 LabelStatisticsImageFilter< TInputImage, TLabelImage >
-::AfterThreadedGenerateData()
+::MergeLabelAccumulator(LabelAccumulator & total,
+                        std::vector< IdentifierType > & totalFrequencies,
+                        const LabelAccumulator & part,
+                        const std::vector< IdentifierType > & partFrequencies) const
 {
-  MapIterator      mapIt;
-  MapConstIterator threadIt;
-  ThreadIdType     i;
-  ThreadIdType     numberOfThreads = this->GetNumberOfThreads();
-
-  // Run through the map for each thread and accumulate the count,
-  // sum, and sumofsquares
-  for ( i = 0; i < numberOfThreads; i++ )
-    {
-    // iterate over the map for this thread
-    for ( threadIt = m_LabelStatisticsPerThread[i].begin();
-          threadIt != m_LabelStatisticsPerThread[i].end();
-          ++threadIt )
+  total.m_Count += part.m_Count;
+  total.m_Sum += part.m_Sum.GetSum();
+  total.m_SumOfSquares += part.m_SumOfSquares.GetSum();
+
+  if ( total.m_Minimum > part.m_Minimum )
+    {
+    total.m_Minimum = part.m_Minimum;
+    }
+  if ( total.m_Maximum < part.m_Maximum )
+    {
+    total.m_Maximum = part.m_Maximum;
+    }
+
+  //bounding box is min,max pairs
+  for ( unsigned int ii = 0; ii < ( ImageDimension * 2 ); ii += 2 )
+    {
+    if ( total.m_BoundingBox[ii] > part.m_BoundingBox[ii] )
       {
-      // does this label exist in the cumulative structure yet?
-      mapIt = m_LabelStatistics.find( ( *threadIt ).first );
-      if ( mapIt == m_LabelStatistics.end() )
-        {
-        // create a new entry
-        using MapValueType = typename MapType::value_type;
-        if ( m_UseHistograms )
-          {
-          mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-                                                          LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                          m_UpperBound) ) ).first;
-          }
-        else
-          {
-          mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-                                                          LabelStatistics() ) ).first;
-          }
-        }
+      total.m_BoundingBox[ii] = part.m_BoundingBox[ii];
+      }
+    if ( total.m_BoundingBox[ii + 1] < part.m_BoundingBox[ii + 1] )
+      {
+      total.m_BoundingBox[ii + 1] = part.m_BoundingBox[ii + 1];
+      }
+    }
+
+  // if enabled, add the histogram of this part
+  if ( m_UseHistograms )
+    {
+    const SizeValueType numberOfBins = m_NumBins[0];
+    if ( total.m_HistogramOffset == NumericTraits< SizeValueType >::max() )
+      {
+      total.m_HistogramOffset = totalFrequencies.size();
+      totalFrequencies.resize(totalFrequencies.size() + numberOfBins, 0);
+      }
+    for ( SizeValueType bin = 0; bin < numberOfBins; ++bin )
+      {
+      totalFrequencies[total.m_HistogramOffset + bin] += partFrequencies[part.m_HistogramOffset + bin];
+      }
+    }
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+LabelStatisticsImageFilter< TInputImage, TLabelImage >
+::AddLabelStatistics(LabelPixelType label,
+                     const LabelAccumulator & total,
+                     const std::vector< IdentifierType > & frequencies)
+{
+  using MapValueType = typename MapType::value_type;
+  MapIterator mapIt;
+  if ( m_UseHistograms )
+    {
+    mapIt = m_LabelStatistics.insert( MapValueType( label,
+                                                    LabelStatistics(m_NumBins[0], m_LowerBound,
+                                                                    m_UpperBound) ) ).first;
+    }
+  else
+    {
+    mapIt = m_LabelStatistics.insert( MapValueType( label, LabelStatistics() ) ).first;
+    }
+
+  LabelStatistics & labelStats = mapIt->second;
 
+  labelStats.m_Count = total.m_Count;
+  labelStats.m_Sum = total.m_Sum.GetSum();
+  labelStats.m_SumOfSquares = total.m_SumOfSquares.GetSum();
+  labelStats.m_Minimum = total.m_Minimum;
+  labelStats.m_Maximum = total.m_Maximum;
+  for ( unsigned int ii = 0; ii < ( ImageDimension * 2 ); ++ii )
+    {
+    labelStats.m_BoundingBox[ii] = total.m_BoundingBox[ii];
+    }
 
-      typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+  // if enabled, fill the histogram for this label
+  if ( m_UseHistograms )
+    {
+    for ( unsigned int bin = 0; bin < m_NumBins[0]; bin++ )
+      {
+      labelStats.m_Histogram->IncreaseFrequency( bin, frequencies[total.m_HistogramOffset + bin] );
+      }
+    }
 
-      // accumulate the information from this thread
-      labelStats.m_Count += ( *threadIt ).second.m_Count;
-      labelStats.m_Sum += ( *threadIt ).second.m_Sum;
-      labelStats.m_SumOfSquares += ( *threadIt ).second.m_SumOfSquares;
+  // mean
+  labelStats.m_Mean = labelStats.m_Sum / static_cast< RealType >( labelStats.m_Count );
 
-      if ( labelStats.m_Minimum > ( *threadIt ).second.m_Minimum )
-        {
-        labelStats.m_Minimum = ( *threadIt ).second.m_Minimum;
-        }
-      if ( labelStats.m_Maximum < ( *threadIt ).second.m_Maximum )
-        {
-        labelStats.m_Maximum = ( *threadIt ).second.m_Maximum;
-        }
+  // variance
+  if ( labelStats.m_Count > 1 )
+    {
+    // unbiased estimate of variance
+    const RealType sumSquared  = labelStats.m_Sum * labelStats.m_Sum;
+    const auto     count = static_cast< RealType >( labelStats.m_Count );
 
-      //bounding box is min,max pairs
-      for ( unsigned int ii = 0; ii < ( ImageDimension * 2 ); ii += 2 )
+    labelStats.m_Variance = ( labelStats.m_SumOfSquares - sumSquared / count ) / ( count - 1.0 );
+    }
+  else
+    {
+    labelStats.m_Variance = NumericTraits< RealType >::ZeroValue();
+    }
+
+  // sigma
+  labelStats.m_Sigma = std::sqrt( labelStats.m_Variance );
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+LabelStatisticsImageFilter< TInputImage, TLabelImage >
+::AfterThreadedGenerateData()
+{
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+
+  // Combine the threads in thread order for every label so that the
+  // compensated sums are added in a fixed order
+  if ( m_UseDenseLabels )
+    {
+    std::vector< IdentifierType > frequencies;
+    for ( SizeValueType l = 0; l < m_NumberOfDenseLabels; ++l )
+      {
+      LabelAccumulator total;
+      frequencies.clear();
+      for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
         {
-        if ( labelStats.m_BoundingBox[ii] > ( *threadIt ).second.m_BoundingBox[ii] )
+        const ThreadAccumulator & threadAccumulator = m_ThreadAccumulators[i];
+        if ( threadAccumulator.m_DenseLabels[l].m_Count > 0 )
           {
-          labelStats.m_BoundingBox[ii] = ( *threadIt ).second.m_BoundingBox[ii];
-          }
-        if ( labelStats.m_BoundingBox[ii + 1] < ( *threadIt ).second.m_BoundingBox[ii + 1] )
-          {
-          labelStats.m_BoundingBox[ii + 1] = ( *threadIt ).second.m_BoundingBox[ii + 1];
+          this->MergeLabelAccumulator( total, frequencies,
+                                       threadAccumulator.m_DenseLabels[l], threadAccumulator.m_Frequencies );
           }
         }
-
-      // if enabled, update the histogram for this label
-      if ( m_UseHistograms )
+      if ( total.m_Count > 0 )
         {
-        typename HistogramType::IndexType index;
-        index.SetSize(1);
-        for ( unsigned int bin = 0; bin < m_NumBins[0]; bin++ )
-          {
-          index[0] = bin;
-          labelStats.m_Histogram->IncreaseFrequency( bin, ( *threadIt ).second.m_Histogram->GetFrequency(bin) );
-          }
+        const auto label = static_cast< LabelPixelType >( m_DenseLabelMinimum + l );
+        this->AddLabelStatistics( label, total, frequencies );
         }
-      } // end of thread map iterator loop
-    }   // end of thread loop
-
-  // compute the remainder of the statistics
-  for ( mapIt = m_LabelStatistics.begin();
-        mapIt != m_LabelStatistics.end();
-        ++mapIt )
+      }
+    }
+  else
     {
-    typename MapType::mapped_type &labelStats = ( *mapIt ).second;
-
-    // mean
-    labelStats.m_Mean = labelStats.m_Sum
-                               / static_cast< RealType >( labelStats.m_Count );
-
-    // variance
-    if ( labelStats.m_Count > 1 )
+    AccumulatorMapType            totals;
+    std::vector< IdentifierType > frequencies;
+    for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
       {
-      // unbiased estimate of variance
-      LabelStatistics & ls = mapIt->second;
-      const RealType    sumSquared  = ls.m_Sum * ls.m_Sum;
-      const auto count = static_cast< RealType >( ls.m_Count );
-
-      ls.m_Variance = ( ls.m_SumOfSquares - sumSquared / count ) / ( count - 1.0 );
+      const ThreadAccumulator & threadAccumulator = m_ThreadAccumulators[i];
+      for ( typename AccumulatorMapType::const_iterator threadIt = threadAccumulator.m_SparseLabels.begin();
+            threadIt != threadAccumulator.m_SparseLabels.end();
+            ++threadIt )
+        {
+        this->MergeLabelAccumulator( totals[threadIt->first], frequencies,
+                                     threadIt->second, threadAccumulator.m_Frequencies );
+        }
       }
-    else
+    for ( typename AccumulatorMapType::const_iterator totalIt = totals.begin();
+          totalIt != totals.end();
+          ++totalIt )
       {
-      labelStats.m_Variance = NumericTraits< RealType >::ZeroValue();
+      this->AddLabelStatistics( totalIt->first, totalIt->second, frequencies );
       }
-
-    // sigma
-    labelStats.m_Sigma = std::sqrt( labelStats.m_Variance );
     }
 
+  // Release the thread temporaries
+  m_ThreadAccumulators.clear();
+  m_BinningHistogram = nullptr;
+
     {
     //Now update the cached vector of valid labels.
     m_ValidLabelValues.resize(0);
     m_ValidLabelValues.reserve(m_LabelStatistics.size());
-    for ( mapIt = m_LabelStatistics.begin();
+    for ( MapIterator mapIt = m_LabelStatistics.begin();
       mapIt != m_LabelStatistics.end();
       ++mapIt )
       {
@@ -239,7 +370,8 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
   ImageScanlineConstIterator< TLabelImage > labelIt (this->GetLabelInput(),
                                                      outputRegionForThread);
 
-  MapIterator mapIt;
+  ThreadAccumulator & threadAccumulator = m_ThreadAccumulators[threadId];
+  const SizeValueType numberOfBins = m_NumBins[0];
 
   // support progress methods/callbacks
   const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
@@ -254,26 +386,11 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 
       const LabelPixelType & label = labelIt.Get();
 
-      // is the label already in this thread?
-      mapIt = m_LabelStatisticsPerThread[threadId].find(label);
-      if ( mapIt == m_LabelStatisticsPerThread[threadId].end() )
-        {
-        // create a new statistics object
-        using MapValueType = typename MapType::value_type;
-        if ( m_UseHistograms )
-          {
-          mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                             LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                                             m_UpperBound) ) ).first;
-          }
-        else
-          {
-          mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                             LabelStatistics() ) ).first;
-          }
-        }
-
-      typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+      // find the statistics of the label in this thread, either by
+      // indexing the flat array or through the map
+      LabelAccumulator & labelStats = m_UseDenseLabels
+        ? threadAccumulator.m_DenseLabels[static_cast< SizeValueType >( label - m_DenseLabelMinimum )]
+        : threadAccumulator.m_SparseLabels[label];
 
       // update the values for this label and this thread
       if ( value < labelStats.m_Minimum )
@@ -306,12 +423,18 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
       // if enabled, update the histogram for this label
       if ( m_UseHistograms )
         {
+        if ( labelStats.m_HistogramOffset == NumericTraits< SizeValueType >::max() )
+          {
+          labelStats.m_HistogramOffset = threadAccumulator.m_Frequencies.size();
+          threadAccumulator.m_Frequencies.resize(threadAccumulator.m_Frequencies.size() + numberOfBins, 0);
+          }
         histogramMeasurement[0] = value;
-        labelStats.m_Histogram->GetIndex(histogramMeasurement, histogramIndex);
-        labelStats.m_Histogram->IncreaseFrequencyOfIndex(histogramIndex, 1);
+        if ( m_BinningHistogram->GetIndex(histogramMeasurement, histogramIndex) )
+          {
+          ++threadAccumulator.m_Frequencies[labelStats.m_HistogramOffset + histogramIndex[0]];
+          }
         }
 
-
       ++labelIt;
       ++it;
       }
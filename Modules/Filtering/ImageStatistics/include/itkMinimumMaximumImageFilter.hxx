@@ -19,7 +19,7 @@
 #define itkMinimumMaximumImageFilter_hxx
 #include "itkMinimumMaximumImageFilter.h"
 
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkProgressReporter.h"
 
 #include <vector>
@@ -193,37 +193,44 @@ MinimumMaximumImageFilter< TInputImage >
   PixelType localMin = m_ThreadMin[threadId];
   PixelType localMax = m_ThreadMax[threadId];
 
-  ImageRegionConstIterator< TInputImage > it (this->GetInput(), outputRegionForThread);
+  ImageScanlineConstIterator< TInputImage > it (this->GetInput(), outputRegionForThread);
 
   // support progress methods/callbacks
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels()/2 );
+  const SizeValueType size0 = outputRegionForThread.GetSize(0);
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() / size0 );
 
-  // Handle the odd pixel separately
-  if ( outputRegionForThread.GetNumberOfPixels()%2 == 1 )
-    {
-    const PixelType value = it.Get();
-    localMin = localMax = value;
-    ++it;
-    }
-
-  // do the work for the even number of pixels 2 at a time
+  // do the work, one line at a time
   while ( !it.IsAtEnd() )
     {
-    const PixelType value1 = it.Get();
-    ++it;
-    const PixelType value2 = it.Get();
-    ++it;
-
-    if (value1 > value2)
+    // Handle the odd pixel of the line separately
+    if ( size0 % 2 == 1 )
       {
-      localMax = std::max(value1,localMax);
-      localMin = std::min(value2,localMin);
+      const PixelType value = it.Get();
+      localMax = std::max(value,localMax);
+      localMin = std::min(value,localMin);
+      ++it;
       }
-    else
+
+    // the remaining even number of pixels are handled 2 at a time
+    while ( !it.IsAtEndOfLine() )
       {
-      localMax = std::max(value2,localMax);
-      localMin = std::min(value1,localMin);
+      const PixelType value1 = it.Get();
+      ++it;
+      const PixelType value2 = it.Get();
+      ++it;
+
+      if (value1 > value2)
+        {
+        localMax = std::max(value1,localMax);
+        localMin = std::min(value2,localMin);
+        }
+      else
+        {
+        localMax = std::max(value2,localMax);
+        localMin = std::min(value1,localMin);
+        }
       }
+    it.NextLine();
     progress.CompletedPixel();
     }
 
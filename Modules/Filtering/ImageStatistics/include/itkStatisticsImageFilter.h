@@ -22,6 +22,8 @@
 #include "itkNumericTraits.h"
 #include "itkArray.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkCompensatedSummation.h"
+#include <vector>
 
 namespace itk
 {
@@ -38,6 +40,11 @@ namespace itk
  * threaded. It computes statistics in each thread then combines them in
  * its AfterThreadedGenerate method.
  *
+ * Each scanline is summed directly and the line sums are accumulated with
+ * CompensatedSummation, both within a thread and when the threads are
+ * combined, so the sum, mean and variance do not drift with the number of
+ * threads used.
+ *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITKImageStatistics
  *
@@ -169,8 +176,10 @@ protected:
   void EnlargeOutputRequestedRegion(DataObject *data) override;
 
 private:
-  Array< RealType >       m_ThreadSum;
-  Array< RealType >       m_SumOfSquares;
+  using CompensatedSummationType = CompensatedSummation< RealType >;
+
+  std::vector< CompensatedSummationType > m_ThreadSum;
+  std::vector< CompensatedSummationType > m_SumOfSquares;
   Array< SizeValueType >  m_Count;
   Array< PixelType >      m_ThreadMin;
   Array< PixelType >      m_ThreadMax;
@@ -228,15 +228,13 @@ StatisticsImageFilter< TInputImage >
 
   // Resize the thread temporaries
   m_Count.SetSize(numberOfThreads);
-  m_SumOfSquares.SetSize(numberOfThreads);
-  m_ThreadSum.SetSize(numberOfThreads);
   m_ThreadMin.SetSize(numberOfThreads);
   m_ThreadMax.SetSize(numberOfThreads);
 
   // Initialize the temporaries
+  m_ThreadSum.assign( numberOfThreads, CompensatedSummationType() );
+  m_SumOfSquares.assign( numberOfThreads, CompensatedSummationType() );
   m_Count.Fill(NumericTraits< SizeValueType >::ZeroValue());
-  m_ThreadSum.Fill(NumericTraits< RealType >::ZeroValue());
-  m_SumOfSquares.Fill(NumericTraits< RealType >::ZeroValue());
   m_ThreadMin.Fill( NumericTraits< PixelType >::max() );
   m_ThreadMax.Fill( NumericTraits< PixelType >::NonpositiveMin() );
 }
@@ -248,7 +246,6 @@ StatisticsImageFilter< TInputImage >
 {
   ThreadIdType    i;
   SizeValueType   count;
-  RealType        sumOfSquares;
 
   ThreadIdType numberOfThreads = this->GetNumberOfThreads();
 
@@ -257,9 +254,10 @@ StatisticsImageFilter< TInputImage >
   RealType  mean;
   RealType  sigma;
   RealType  variance;
-  RealType  sum;
 
-  sum = sumOfSquares = NumericTraits< RealType >::ZeroValue();
+  // Combine the threads in a fixed order with compensated summation
+  CompensatedSummationType sumOfThreads;
+  CompensatedSummationType sumOfSquaresOfThreads;
   count = 0;
 
   // Find the min/max over all threads and accumulate count, sum and
@@ -269,8 +267,8 @@ StatisticsImageFilter< TInputImage >
   for ( i = 0; i < numberOfThreads; i++ )
     {
     count += m_Count[i];
-    sum += m_ThreadSum[i];
-    sumOfSquares += m_SumOfSquares[i];
+    sumOfThreads += m_ThreadSum[i].GetSum();
+    sumOfSquaresOfThreads += m_SumOfSquares[i].GetSum();
 
     if ( m_ThreadMin[i] < minimum )
       {
@@ -281,6 +279,9 @@ StatisticsImageFilter< TInputImage >
       maximum = m_ThreadMax[i];
       }
     }
+  const RealType sum = sumOfThreads.GetSum();
+  const RealType sumOfSquares = sumOfSquaresOfThreads.GetSum();
+
   // compute statistics
   mean = sum / static_cast< RealType >( count );
 
@@ -312,8 +313,8 @@ StatisticsImageFilter< TInputImage >
   RealType  realValue;
   PixelType value;
 
-  RealType sum = NumericTraits< RealType >::ZeroValue();
-  RealType sumOfSquares = NumericTraits< RealType >::ZeroValue();
+  CompensatedSummationType sum;
+  CompensatedSummationType sumOfSquares;
   SizeValueType count = NumericTraits< SizeValueType >::ZeroValue();
   PixelType min = NumericTraits< PixelType >::max();
   PixelType max = NumericTraits< PixelType >::NonpositiveMin();
@@ -327,6 +328,10 @@ StatisticsImageFilter< TInputImage >
   // do the work
   while ( !it.IsAtEnd() )
     {
+    // Sum each line directly; only the line sums go through the
+    // compensated accumulators
+    RealType lineSum = NumericTraits< RealType >::ZeroValue();
+    RealType lineSumOfSquares = NumericTraits< RealType >::ZeroValue();
     while ( !it.IsAtEndOfLine() )
       {
       value = it.Get();
@@ -340,11 +345,13 @@ StatisticsImageFilter< TInputImage >
         max  = value;
         }
 
-      sum += realValue;
-      sumOfSquares += ( realValue * realValue );
+      lineSum += realValue;
+      lineSumOfSquares += ( realValue * realValue );
       ++count;
       ++it;
       }
+    sum += lineSum;
+    sumOfSquares += lineSumOfSquares;
     it.NextLine();
     progress.CompletedPixel();
     }
@@ -0,0 +1,220 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageToHistogramFilter.h"
+#include "itkMaskedImageToHistogramFilter.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Compare the histograms computed by ImageToHistogramFilter and
+ * MaskedImageToHistogramFilter with histograms filled by searching the bins
+ * with Histogram::GetIndex(), for scalar and vector images, with automatic
+ * and user provided bounds, and with different numbers of threads.
+ */
+namespace
+{
+template< typename THistogram, typename TImage, typename TMask >
+typename THistogram::Pointer
+ComputeReferenceHistogram( const THistogram * bins, const TImage * image, const TMask * mask )
+{
+  using PixelType = typename TImage::PixelType;
+
+  typename THistogram::Pointer reference = THistogram::New();
+  reference->SetMeasurementVectorSize( bins->GetMeasurementVectorSize() );
+  reference->SetClipBinsAtEnds( bins->GetClipBinsAtEnds() );
+  typename THistogram::MeasurementVectorType lower( bins->GetMeasurementVectorSize() );
+  typename THistogram::MeasurementVectorType upper( bins->GetMeasurementVectorSize() );
+  for( unsigned int i = 0; i < bins->GetMeasurementVectorSize(); ++i )
+    {
+    lower[i] = bins->GetBinMin( i, 0 );
+    upper[i] = bins->GetBinMax( i, bins->GetSize( i ) - 1 );
+    }
+  typename THistogram::SizeType size = bins->GetSize();
+  reference->Initialize( size, lower, upper );
+
+  typename THistogram::MeasurementVectorType m( bins->GetMeasurementVectorSize() );
+  typename THistogram::IndexType index;
+  itk::ImageRegionConstIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TMask > maskIt( mask, image->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it, ++maskIt )
+    {
+    if( maskIt.Get() == 0 )
+      {
+      continue;
+      }
+    itk::NumericTraits< PixelType >::AssignToArray( it.Get(), m );
+    if( reference->GetIndex( m, index ) )
+      {
+      reference->IncreaseFrequencyOfIndex( index, 1 );
+      }
+    }
+  return reference;
+}
+
+template< typename THistogram >
+bool
+CompareHistograms( const THistogram * histogram, const THistogram * reference, const char * name )
+{
+  if( histogram->Size() != reference->Size() )
+    {
+    std::cerr << name << ": wrong number of bins" << std::endl;
+    return false;
+    }
+  for( typename THistogram::InstanceIdentifier id = 0; id < histogram->Size(); ++id )
+    {
+    if( histogram->GetFrequency( id ) != reference->GetFrequency( id ) )
+      {
+      std::cerr << name << ": wrong frequency in bin " << id << ": "
+                << histogram->GetFrequency( id ) << " instead of "
+                << reference->GetFrequency( id ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TImage, typename TMask >
+bool
+CheckImage( const TImage * image, const TMask * mask, const TMask * fullMask,
+            unsigned int binsPerComponent, bool autoMinimumMaximum, double lower, double upper )
+{
+  using FilterType = itk::Statistics::ImageToHistogramFilter< TImage >;
+  using MaskedFilterType = itk::Statistics::MaskedImageToHistogramFilter< TImage, TMask >;
+  using HistogramType = typename FilterType::HistogramType;
+
+  const unsigned int nbOfComponents = image->GetNumberOfComponentsPerPixel();
+  typename FilterType::HistogramSizeType size( nbOfComponents );
+  size.Fill( binsPerComponent );
+  typename FilterType::HistogramMeasurementVectorType binMinimum( nbOfComponents );
+  typename FilterType::HistogramMeasurementVectorType binMaximum( nbOfComponents );
+  binMinimum.Fill( lower );
+  binMaximum.Fill( upper );
+
+  bool pass = true;
+  const itk::ThreadIdType numberOfThreads[] = { 1, 3 };
+  for( itk::ThreadIdType threads : numberOfThreads )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( image );
+    filter->SetHistogramSize( size );
+    filter->SetAutoMinimumMaximum( autoMinimumMaximum );
+    if( !autoMinimumMaximum )
+      {
+      filter->SetHistogramBinMinimum( binMinimum );
+      filter->SetHistogramBinMaximum( binMaximum );
+      }
+    filter->SetNumberOfThreads( threads );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    typename HistogramType::Pointer reference =
+      ComputeReferenceHistogram( filter->GetOutput(), image, fullMask );
+    pass &= CompareHistograms< HistogramType >( filter->GetOutput(), reference, "ImageToHistogramFilter" );
+
+    typename MaskedFilterType::Pointer masked = MaskedFilterType::New();
+    masked->SetInput( image );
+    masked->SetMaskImage( mask );
+    masked->SetMaskValue( 1 );
+    masked->SetHistogramSize( size );
+    masked->SetAutoMinimumMaximum( autoMinimumMaximum );
+    if( !autoMinimumMaximum )
+      {
+      masked->SetHistogramBinMinimum( binMinimum );
+      masked->SetHistogramBinMaximum( binMaximum );
+      }
+    masked->SetNumberOfThreads( threads );
+    TRY_EXPECT_NO_EXCEPTION( masked->Update() );
+
+    reference = ComputeReferenceHistogram( masked->GetOutput(), image, mask );
+    pass &= CompareHistograms< HistogramType >( masked->GetOutput(), reference, "MaskedImageToHistogramFilter" );
+    }
+  return pass;
+}
+}
+
+int itkImageToHistogramFilterBinsTest( int, char * [] )
+{
+  constexpr unsigned int Dimension = 2;
+  using MaskType = itk::Image< unsigned char, Dimension >;
+  using ScalarImageType = itk::Image< float, Dimension >;
+  using CharImageType = itk::Image< unsigned char, Dimension >;
+  using VectorImageType = itk::VectorImage< short, Dimension >;
+
+  MaskType::SizeType size;
+  size[0] = 67;
+  size[1] = 45;
+  MaskType::RegionType region( size );
+
+  MaskType::Pointer mask = MaskType::New();
+  mask->SetRegions( region );
+  mask->Allocate();
+  MaskType::Pointer fullMask = MaskType::New();
+  fullMask->SetRegions( region );
+  fullMask->Allocate();
+  fullMask->FillBuffer( 1 );
+
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions( region );
+  scalarImage->Allocate();
+
+  CharImageType::Pointer charImage = CharImageType::New();
+  charImage->SetRegions( region );
+  charImage->Allocate();
+
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( region );
+  vectorImage->SetNumberOfComponentsPerPixel( 3 );
+  vectorImage->Allocate();
+
+  // Fill the images with deterministic values, including values that
+  // fall exactly on the bin bounds
+  itk::ImageRegionIterator< ScalarImageType > it( scalarImage, region );
+  VectorImageType::PixelType vector( 3 );
+  unsigned int n = 0;
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it, ++n )
+    {
+    const MaskType::IndexType & index = it.GetIndex();
+    const unsigned int value = ( n * 7919 ) % 1009;
+    it.Set( ( n % 5 == 0 ) ? static_cast< float >( value % 64 ) / 4.0f
+                           : static_cast< float >( value ) / 17.0f - 3.0f );
+    charImage->SetPixel( index, static_cast< unsigned char >( value % 256 ) );
+    vector[0] = static_cast< short >( value % 200 ) - 100;
+    vector[1] = static_cast< short >( ( n * 13 ) % 300 );
+    vector[2] = static_cast< short >( value % 7 );
+    vectorImage->SetPixel( index, vector );
+    mask->SetPixel( index, static_cast< unsigned char >( ( n / 3 ) % 2 ) );
+    }
+
+  bool pass = true;
+  pass &= CheckImage( scalarImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 64, true, 0.0, 0.0 );
+  pass &= CheckImage( scalarImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 16, false, 0.0, 16.0 );
+  pass &= CheckImage( charImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 256, false, -0.5, 255.5 );
+  pass &= CheckImage( charImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 10, true, 0.0, 0.0 );
+  pass &= CheckImage( vectorImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 8, true, 0.0, 0.0 );
+  pass &= CheckImage( vectorImage.GetPointer(), mask.GetPointer(), fullMask.GetPointer(), 12, false, -50.0, 100.0 );
+
+  if( !pass )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
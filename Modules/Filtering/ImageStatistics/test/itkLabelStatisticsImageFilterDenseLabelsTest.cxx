@@ -0,0 +1,229 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkStatisticsImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+#include <map>
+
+/*
+ * Compare LabelStatisticsImageFilter with statistics computed by brute
+ * force, for labels stored in flat arrays (a small range of unsigned
+ * short labels) and labels stored in hash maps (the same labels spread
+ * over a range of unsigned int that is too large for flat arrays), and
+ * for different numbers of threads.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 3;
+constexpr unsigned int NumberOfLabels = 37;
+constexpr unsigned int NumberOfBins = 16;
+
+using PixelType = float;
+using ImageType = itk::Image< PixelType, Dimension >;
+
+struct ReferenceStatistics
+{
+  ReferenceStatistics() :
+    m_Count(0), m_Sum(0.0), m_Minimum(itk::NumericTraits< double >::max()),
+    m_Maximum(itk::NumericTraits< double >::NonpositiveMin()), m_Frequencies(NumberOfBins, 0)
+  {
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      m_BoundingBox[2 * i] = itk::NumericTraits< itk::IndexValueType >::max();
+      m_BoundingBox[2 * i + 1] = itk::NumericTraits< itk::IndexValueType >::NonpositiveMin();
+      }
+  }
+
+  itk::SizeValueType                  m_Count;
+  double                              m_Sum;
+  double                              m_Minimum;
+  double                              m_Maximum;
+  itk::IndexValueType                 m_BoundingBox[2 * Dimension];
+  std::vector< itk::SizeValueType >   m_Frequencies;
+};
+
+template< typename TLabelImage >
+bool
+CheckLabelStatistics( const ImageType * image, const TLabelImage * labelImage,
+                      const std::map< unsigned int, ReferenceStatistics > & reference,
+                      unsigned int labelScale, unsigned int labelShift,
+                      itk::ThreadIdType numberOfThreads )
+{
+  using FilterType = itk::LabelStatisticsImageFilter< ImageType, TLabelImage >;
+  using LabelPixelType = typename TLabelImage::PixelType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetLabelInput( labelImage );
+  filter->SetHistogramParameters( NumberOfBins, 0.0, 1.0 );
+  filter->SetNumberOfThreads( numberOfThreads );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  bool pass = true;
+  if ( filter->GetNumberOfLabels() != reference.size() )
+    {
+    std::cerr << "Expected " << reference.size() << " labels but got "
+              << filter->GetNumberOfLabels() << std::endl;
+    return false;
+    }
+
+  for ( auto it = reference.begin(); it != reference.end(); ++it )
+    {
+    const auto label = static_cast< LabelPixelType >( it->first * labelScale + labelShift );
+    const ReferenceStatistics & expected = it->second;
+
+    if ( !filter->HasLabel( label )
+         || filter->GetCount( label ) != expected.m_Count
+         || filter->GetMinimum( label ) != expected.m_Minimum
+         || filter->GetMaximum( label ) != expected.m_Maximum
+         || !itk::Math::FloatAlmostEqual( filter->GetSum( label ), expected.m_Sum, 4, 1e-10 )
+         || !itk::Math::FloatAlmostEqual( filter->GetMean( label ),
+                                          expected.m_Sum / expected.m_Count, 4, 1e-10 ) )
+      {
+      std::cerr << "Wrong statistics for label " << static_cast< double >( label )
+                << " with " << numberOfThreads << " threads" << std::endl;
+      pass = false;
+      continue;
+      }
+
+    const typename FilterType::BoundingBoxType boundingBox = filter->GetBoundingBox( label );
+    for ( unsigned int i = 0; i < 2 * Dimension; ++i )
+      {
+      if ( boundingBox[i] != expected.m_BoundingBox[i] )
+        {
+        std::cerr << "Wrong bounding box for label " << static_cast< double >( label ) << std::endl;
+        pass = false;
+        }
+      }
+
+    typename FilterType::HistogramPointer histogram = filter->GetHistogram( label );
+    for ( unsigned int bin = 0; bin < NumberOfBins; ++bin )
+      {
+      if ( histogram->GetFrequency( bin ) != expected.m_Frequencies[bin] )
+        {
+        std::cerr << "Wrong frequency in bin " << bin << " for label "
+                  << static_cast< double >( label ) << std::endl;
+        pass = false;
+        }
+      }
+    }
+  return pass;
+}
+}
+
+int itkLabelStatisticsImageFilterDenseLabelsTest( int, char * [] )
+{
+  using DenseLabelImageType = itk::Image< unsigned short, Dimension >;
+  using SparseLabelImageType = itk::Image< unsigned int, Dimension >;
+
+  ImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 23;
+  size[2] = 17;
+  ImageType::IndexType start;
+  start[0] = -3;
+  start[1] = 5;
+  start[2] = 0;
+  ImageType::RegionType region( start, size );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  DenseLabelImageType::Pointer denseLabels = DenseLabelImageType::New();
+  denseLabels->SetRegions( region );
+  denseLabels->Allocate();
+
+  SparseLabelImageType::Pointer sparseLabels = SparseLabelImageType::New();
+  sparseLabels->SetRegions( region );
+  sparseLabels->Allocate();
+
+  // Dense labels are 3 + l, sparse labels are 100000 * l + 1
+  const unsigned int denseShift = 3;
+  const unsigned int sparseScale = 100000;
+  const unsigned int sparseShift = 1;
+
+  std::map< unsigned int, ReferenceStatistics > reference;
+
+  // Fill the images with a deterministic sequence of values in [0, 1)
+  // and labels
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  itk::SizeValueType n = 0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++n )
+    {
+    const PixelType value = static_cast< PixelType >( ( n * 7919 ) % 10007 ) / 10007.0f;
+    const unsigned int label = static_cast< unsigned int >( ( n * 31 + n / 97 ) % NumberOfLabels );
+    const ImageType::IndexType & index = it.GetIndex();
+
+    it.Set( value );
+    denseLabels->SetPixel( index, static_cast< unsigned short >( label + denseShift ) );
+    sparseLabels->SetPixel( index, label * sparseScale + sparseShift );
+
+    ReferenceStatistics & stats = reference[label];
+    ++stats.m_Count;
+    stats.m_Sum += value;
+    stats.m_Minimum = std::min( stats.m_Minimum, static_cast< double >( value ) );
+    stats.m_Maximum = std::max( stats.m_Maximum, static_cast< double >( value ) );
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      stats.m_BoundingBox[2 * i] = std::min( stats.m_BoundingBox[2 * i], index[i] );
+      stats.m_BoundingBox[2 * i + 1] = std::max( stats.m_BoundingBox[2 * i + 1], index[i] );
+      }
+    ++stats.m_Frequencies[static_cast< unsigned int >( value * NumberOfBins )];
+    }
+
+  bool pass = true;
+  const itk::ThreadIdType numberOfThreads[] = { 1, 3, 8 };
+  for ( itk::ThreadIdType threads : numberOfThreads )
+    {
+    pass &= CheckLabelStatistics( image.GetPointer(), denseLabels.GetPointer(), reference,
+                                  1, denseShift, threads );
+    pass &= CheckLabelStatistics( image.GetPointer(), sparseLabels.GetPointer(), reference,
+                                  sparseScale, sparseShift, threads );
+    }
+
+  // The statistics of the whole image do not depend on the number of threads
+  using StatisticsFilterType = itk::StatisticsImageFilter< ImageType >;
+  StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+  statistics->SetInput( image );
+  statistics->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( statistics->Update() );
+  const double sum = statistics->GetSum();
+  const double variance = statistics->GetVariance();
+  for ( itk::ThreadIdType threads : numberOfThreads )
+    {
+    statistics->SetNumberOfThreads( threads );
+    statistics->Modified();
+    TRY_EXPECT_NO_EXCEPTION( statistics->Update() );
+    TEST_EXPECT_TRUE( itk::Math::FloatAlmostEqual( statistics->GetSum(), sum, 4, 1e-12 ) );
+    TEST_EXPECT_TRUE( itk::Math::FloatAlmostEqual( statistics->GetVariance(), variance, 4, 1e-12 ) );
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
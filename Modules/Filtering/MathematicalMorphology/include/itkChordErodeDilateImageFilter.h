@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkChordErodeDilateImageFilter_h
+#define itkChordErodeDilateImageFilter_h
+
+#include "itkKernelImageFilter.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class ChordErodeDilateImageFilter
+ * \brief Erosion or dilation by an arbitrary flat structuring element
+ * decomposed into chords.
+ *
+ * The structuring element is split into chords, i.e. runs of active
+ * elements along the first image axis. The value of the output pixel is the
+ * extreme over all the chords of the extreme of the input along each chord.
+ * The extreme along a chord is computed with the van Herk / Gil-Werman
+ * algorithm, at a constant cost per pixel whatever the chord length.
+ *
+ * Unlike the van Herk / Gil-Werman and anchor filters, the result is exact
+ * for any structuring element, so it is well suited to large balls, which
+ * cannot be decomposed in lines. The cost per pixel is proportional to the
+ * number of chords, i.e. to the number of lines of the structuring element
+ * along the first axis, rather than to its number of elements.
+ *
+ * This is the base class that must be instantiated with appropriate
+ * definitions of the extreme function.
+ * The SetBoundary facility is included for compatibility with other
+ * morphology classes in itk.
+ *
+ * See "Efficient 2-D grayscale morphological transformations with arbitrary
+ * flat structuring elements", E. R. Urbach and M. H. F. Wilkinson, IEEE
+ * Transactions on Image Processing, 17(1), 2008.
+ *
+ * \sa VanHerkGilWermanErodeDilateImageFilter, GrayscaleDilateImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template< typename TImage, typename TKernel, typename TFunction1 >
+class ITK_TEMPLATE_EXPORT ChordErodeDilateImageFilter:
+  public KernelImageFilter< TImage, TImage, TKernel >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ChordErodeDilateImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = ChordErodeDilateImageFilter;
+  using Superclass = KernelImageFilter< TImage, TImage, TKernel >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Kernel type alias. */
+  using KernelType = TKernel;
+
+  using InputImageType = TImage;
+  using InputImagePointer = typename InputImageType::Pointer;
+  using InputImageConstPointer = typename InputImageType::ConstPointer;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using InputImagePixelType = typename InputImageType::PixelType;
+  using IndexType = typename TImage::IndexType;
+  using SizeType = typename TImage::SizeType;
+  using OffsetType = typename TImage::OffsetType;
+
+  /** ImageDimension constants */
+  static constexpr unsigned int InputImageDimension = TImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TImage::ImageDimension;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ChordErodeDilateImageFilter,
+               KernelImageFilter);
+
+  /** Set kernel (structuring element). The kernel is decomposed in chords. */
+  void SetKernel(const KernelType & kernel) override;
+
+  /** Set/Get the boundary value. */
+  itkSetMacro(Boundary, InputImagePixelType);
+  itkGetConstMacro(Boundary, InputImagePixelType);
+
+  /** Get the number of chords of the current kernel. The cost per pixel of
+   * the filter is proportional to this number. */
+  SizeValueType GetNumberOfChords() const
+  {
+    return static_cast< SizeValueType >( m_Chords.size() );
+  }
+
+  /** Get the length of the longest chord of the current kernel. */
+  itkGetConstMacro(MaximumChordLength, SizeValueType);
+
+  /** Return whether the chords of the current kernel are estimated to be
+   * faster than the basic algorithm, or than the moving histogram when
+   * \a histogram is true. The costs are counted in visits per pixel: the
+   * basic algorithm visits every element of the kernel, the histogram about
+   * 5.4 (2D) or 4.5 (3D) per pixel of \a pixelsPerTranslation, and the van
+   * Herk / Gil-Werman recurrence about 4 per chord. GrayscaleDilateImageFilter
+   * and GrayscaleErodeImageFilter use it to select their algorithm. */
+  bool IsFasterThan(bool histogram, SizeValueType pixelsPerTranslation) const;
+
+protected:
+  ChordErodeDilateImageFilter();
+  ~ChordErodeDilateImageFilter() override {}
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Multi-thread version GenerateData. */
+  void  ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
+                             ThreadIdType threadId) override;
+
+  // should be set by the meta filter
+  InputImagePixelType m_Boundary;
+
+private:
+  /** A run of active kernel elements along the first axis. The offset is
+   * the one of the first element of the run, relative to the kernel
+   * center. */
+  struct ChordType
+    {
+    OffsetType    m_Offset;
+    SizeValueType m_Length;
+    };
+  using ChordVectorType = std::vector< ChordType >;
+
+  using LineBufferType = std::vector< InputImagePixelType >;
+
+  /** Compute the extreme over each window of length chordLength of the
+   * first windowCount + chordLength - 1 elements of lineBuffer. The
+   * extremes are combined with the content of the result buffer when
+   * combine is true, and replace it otherwise. */
+  void ComputeLineExtreme(const LineBufferType & lineBuffer,
+                          LineBufferType & forward,
+                          LineBufferType & reverse,
+                          SizeValueType windowCount,
+                          SizeValueType chordLength,
+                          LineBufferType & result,
+                          bool combine) const;
+
+  ChordVectorType m_Chords;
+
+  SizeValueType m_MaximumChordLength;
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkChordErodeDilateImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,259 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkChordErodeDilateImageFilter_hxx
+#define itkChordErodeDilateImageFilter_hxx
+
+#include "itkChordErodeDilateImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TImage, typename TKernel, typename TFunction1 >
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::ChordErodeDilateImageFilter():
+  m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() ),
+  m_MaximumChordLength( 0 )
+{
+  // call again SetKernel in that class, to have the chords computed for
+  // the default kernel
+  this->SetKernel( this->GetKernel() );
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::SetKernel(const KernelType & kernel)
+{
+  using KernelPixelType = typename KernelType::PixelType;
+
+  m_Chords.clear();
+  m_MaximumChordLength = 0;
+
+  // the kernel is stored with the first axis varying fastest, so each row
+  // of the kernel along the first axis is contiguous
+  const SizeValueType rowLength = kernel.GetSize(0);
+  const SizeValueType kernelSize = kernel.Size();
+  for ( SizeValueType rowStart = 0; rowStart < kernelSize; rowStart += rowLength )
+    {
+    SizeValueType i = 0;
+    while ( i < rowLength )
+      {
+      if ( kernel[rowStart + i] > NumericTraits< KernelPixelType >::ZeroValue() )
+        {
+        ChordType chord;
+        chord.m_Offset = kernel.GetOffset(rowStart + i);
+        chord.m_Length = 0;
+        while ( i < rowLength && kernel[rowStart + i] > NumericTraits< KernelPixelType >::ZeroValue() )
+          {
+          ++chord.m_Length;
+          ++i;
+          }
+        m_MaximumChordLength = std::max(m_MaximumChordLength, chord.m_Length);
+        m_Chords.push_back(chord);
+        }
+      else
+        {
+        ++i;
+        }
+      }
+    }
+
+  Superclass::SetKernel(kernel);
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+bool
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::IsFasterThan(bool histogram, SizeValueType pixelsPerTranslation) const
+{
+  const double chordCost = 4.0 * this->GetNumberOfChords();
+  double       otherCost = this->GetKernel().Size();
+  if ( histogram )
+    {
+    otherCost = pixelsPerTranslation * ( InputImageDimension == 2 ? 5.4 : 4.5 );
+    }
+  return chordCost < otherCost;
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const InputImageType *  input = this->GetInput();
+  InputImageType *        output = this->GetOutput();
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  if ( lineLength == 0 )
+    {
+    return;
+    }
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / lineLength);
+
+  const InputImageRegionType  inputRegion = input->GetBufferedRegion();
+  const IndexType             inputStart = inputRegion.GetIndex();
+  const IndexType             inputEnd = inputRegion.GetUpperIndex();
+  const InputImagePixelType * inputBuffer = input->GetBufferPointer();
+
+  // the buffers are allocated once for the whole region, so the processing
+  // of the lines is allocation free
+  LineBufferType lineBuffer(lineLength + m_MaximumChordLength);
+  LineBufferType forward( lineBuffer.size() );
+  LineBufferType reverse( lineBuffer.size() );
+  LineBufferType result(lineLength, m_Boundary);
+
+  ImageScanlineIterator< InputImageType > outIt(output, outputRegionForThread);
+  while ( !outIt.IsAtEnd() )
+    {
+    const IndexType lineStart = outIt.GetIndex();
+
+    bool combine = false;
+    for ( typename ChordVectorType::const_iterator chordIt = m_Chords.begin(); chordIt != m_Chords.end(); ++chordIt )
+      {
+      const SizeValueType count = lineLength + chordIt->m_Length - 1;
+      IndexType           rowIndex = lineStart + chordIt->m_Offset;
+
+      bool rowInside = true;
+      for ( unsigned int d = 1; d < InputImageDimension; ++d )
+        {
+        if ( rowIndex[d] < inputStart[d] || rowIndex[d] > inputEnd[d] )
+          {
+          rowInside = false;
+          break;
+          }
+        }
+
+      // load the part of the input line seen by the chord, using the boundary
+      // value outside of the input buffer
+      const IndexValueType first = rowIndex[0];
+      const IndexValueType last = first + static_cast< IndexValueType >( count ) - 1;
+      if ( !rowInside || last < inputStart[0] || first > inputEnd[0] )
+        {
+        std::fill(lineBuffer.begin(), lineBuffer.begin() + count, m_Boundary);
+        }
+      else
+        {
+        const IndexValueType firstInside = std::max(first, inputStart[0]);
+        const IndexValueType lastInside = std::min(last, inputEnd[0]);
+        rowIndex[0] = firstInside;
+        const InputImagePixelType * inputLine = inputBuffer + input->ComputeOffset(rowIndex);
+
+        typename LineBufferType::iterator bufferIt = lineBuffer.begin();
+        bufferIt = std::fill_n(bufferIt, firstInside - first, m_Boundary);
+        bufferIt = std::copy(inputLine, inputLine + ( lastInside - firstInside + 1 ), bufferIt);
+        std::fill_n(bufferIt, last - lastInside, m_Boundary);
+        }
+
+      this->ComputeLineExtreme(lineBuffer, forward, reverse, lineLength, chordIt->m_Length, result, combine);
+      combine = true;
+      }
+
+    for ( SizeValueType i = 0; i < lineLength; ++i )
+      {
+      outIt.Set(result[i]);
+      ++outIt;
+      }
+    outIt.NextLine();
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::ComputeLineExtreme(const LineBufferType & lineBuffer,
+                     LineBufferType & forward,
+                     LineBufferType & reverse,
+                     SizeValueType windowCount,
+                     SizeValueType chordLength,
+                     LineBufferType & result,
+                     bool combine) const
+{
+  TFunction1 extreme;
+
+  if ( chordLength == 1 )
+    {
+    if ( combine )
+      {
+      for ( SizeValueType i = 0; i < windowCount; ++i )
+        {
+        result[i] = extreme(result[i], lineBuffer[i]);
+        }
+      }
+    else
+      {
+      std::copy(lineBuffer.begin(), lineBuffer.begin() + windowCount, result.begin());
+      }
+    return;
+    }
+
+  // van Herk / Gil-Werman: the line is split in blocks of the chord
+  // length. The forward buffer stores the extreme from the beginning of the
+  // block, and the reverse buffer the extreme up to the end of the block, so
+  // any window of the chord length is covered by one value of each buffer.
+  const SizeValueType count = windowCount + chordLength - 1;
+  for ( SizeValueType blockStart = 0; blockStart < count; blockStart += chordLength )
+    {
+    const SizeValueType blockEnd = std::min(blockStart + chordLength, count);
+    forward[blockStart] = lineBuffer[blockStart];
+    for ( SizeValueType i = blockStart + 1; i < blockEnd; ++i )
+      {
+      forward[i] = extreme(forward[i - 1], lineBuffer[i]);
+      }
+    reverse[blockEnd - 1] = lineBuffer[blockEnd - 1];
+    for ( SizeValueType i = blockEnd - 1; i > blockStart; --i )
+      {
+      reverse[i - 1] = extreme(reverse[i], lineBuffer[i - 1]);
+      }
+    }
+
+  if ( combine )
+    {
+    for ( SizeValueType i = 0; i < windowCount; ++i )
+      {
+      result[i] = extreme( result[i], extreme(reverse[i], forward[i + chordLength - 1]) );
+      }
+    }
+  else
+    {
+    for ( SizeValueType i = 0; i < windowCount; ++i )
+      {
+      result[i] = extreme(reverse[i], forward[i + chordLength - 1]);
+      }
+    }
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+ChordErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Boundary: "
+     << static_cast< typename NumericTraits< InputImagePixelType >::PrintType >( m_Boundary ) << std::endl;
+  os << indent << "NumberOfChords: " << this->GetNumberOfChords() << std::endl;
+  os << indent << "MaximumChordLength: " << m_MaximumChordLength << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -89,6 +89,7 @@ ClosingByReconstructionImageFilter< TInputImage, TOutputImage, TKernel >
   erode->SetMarkerImage( dilate->GetOutput() );
   erode->SetMaskImage( this->GetInput() );
   erode->SetFullyConnected(m_FullyConnected);
+  erode->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   if ( m_PreserveIntensities )
     {
@@ -129,6 +130,7 @@ ClosingByReconstructionImageFilter< TInputImage, TOutputImage, TKernel >
     erodeAgain->SetMaskImage ( this->GetInput() );
     erodeAgain->SetMarkerImage (tempImage);
     erodeAgain->SetFullyConnected(m_FullyConnected);
+    erodeAgain->SetNumberOfThreads( this->GetNumberOfThreads() );
     erodeAgain->GraftOutput( this->GetOutput() );
     progress->RegisterInternalFilter(erodeAgain, 0.25f);
     erodeAgain->Update();
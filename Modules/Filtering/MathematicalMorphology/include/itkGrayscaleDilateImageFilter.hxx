@@ -33,6 +33,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   m_HistogramFilter = HistogramFilterType::New();
   m_AnchorFilter = AnchorFilterType::New();
   m_VHGWFilter = VHGWFilterType::New();
+  m_ChordFilter = ChordFilterType::New();
   m_Algorithm = HISTO;
 
   this->SetBoundary( NumericTraits< PixelType >::NonpositiveMin() );
@@ -48,6 +49,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   m_AnchorFilter->SetNumberOfThreads(nb);
   m_VHGWFilter->SetNumberOfThreads(nb);
   m_BasicFilter->SetNumberOfThreads(nb);
+  m_ChordFilter->SetNumberOfThreads(nb);
 }
 
 template< typename TInputImage, typename TOutputImage, typename TKernel >
@@ -91,6 +93,18 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
       }
     }
 
+  if ( m_Algorithm != ANCHOR )
+    {
+    // the cost of the chord decomposition only grows with the number of
+    // lines of the kernel along the first axis, so it is usually the best
+    // choice for large balls
+    m_ChordFilter->SetKernel(kernel);
+    if ( m_ChordFilter->IsFasterThan( m_Algorithm == HISTO, m_HistogramFilter->GetPixelsPerTranslation() ) )
+      {
+      m_Algorithm = CHORD;
+      }
+    }
+
   Superclass::SetKernel(kernel);
 }
 
@@ -103,6 +117,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   m_HistogramFilter->SetBoundary(value);
   m_AnchorFilter->SetBoundary(value);
   m_VHGWFilter->SetBoundary(value);
+  m_ChordFilter->SetBoundary(value);
   m_BoundaryCondition.SetConstant(value);
   m_BasicFilter->OverrideBoundaryCondition(&m_BoundaryCondition);
 }
@@ -132,6 +147,10 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
       {
       m_VHGWFilter->SetKernel(*flatKernel);
       }
+    else if ( algo == CHORD )
+      {
+      m_ChordFilter->SetKernel( this->GetKernel() );
+      }
     else
       {
       itkExceptionMacro(<< "Invalid algorithm");
@@ -200,6 +219,20 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
     cast->SetInput( m_VHGWFilter->GetOutput() );
     progress->RegisterInternalFilter(cast, 0.1f);
 
+    cast->GraftOutput( this->GetOutput() );
+    cast->Update();
+    this->GraftOutput( cast->GetOutput() );
+    }
+  else if ( m_Algorithm == CHORD )
+    {
+    itkDebugMacro("Running ChordDilateImageFilter");
+    m_ChordFilter->SetInput( this->GetInput() );
+    progress->RegisterInternalFilter(m_ChordFilter, 0.9f);
+
+    typename CastFilterType::Pointer cast = CastFilterType::New();
+    cast->SetInput( m_ChordFilter->GetOutput() );
+    progress->RegisterInternalFilter(cast, 0.1f);
+
     cast->GraftOutput( this->GetOutput() );
     cast->Update();
     this->GraftOutput( cast->GetOutput() );
@@ -216,6 +249,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   m_HistogramFilter->Modified();
   m_AnchorFilter->Modified();
   m_VHGWFilter->Modified();
+  m_ChordFilter->Modified();
 }
 
 template< typename TInputImage, typename TOutputImage, typename TKernel >
@@ -23,6 +23,7 @@
 #include "itkBasicErodeImageFilter.h"
 #include "itkAnchorErodeImageFilter.h"
 #include "itkVanHerkGilWermanErodeImageFilter.h"
+#include "itkChordErodeImageFilter.h"
 #include "itkCastImageFilter.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkNeighborhood.h"
@@ -40,6 +41,14 @@ namespace itk
  * values (zero or one). Only elements of the structuring element
  * having values > 0 are candidates for affecting the center pixel.
  *
+ * The erosion is delegated to one of several algorithms, selected
+ * automatically from the structuring element when it is set:
+ * decomposable FlatStructuringElement use the anchor algorithm,
+ * small structuring elements use the basic algorithm, and large
+ * non-decomposable ones, like balls, use either the moving histogram or
+ * the chord decomposition, whichever is expected to be cheaper. The
+ * algorithm can be forced with SetAlgorithm().
+ *
  * \sa MorphologyImageFilter, GrayscaleFunctionErodeImageFilter, BinaryErodeImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  * \ingroup ITKMathematicalMorphology
@@ -87,7 +96,8 @@ public:
     BASIC = 0,
     HISTO = 1,
     ANCHOR = 2,
-    VHGW = 3
+    VHGW = 3,
+    CHORD = 4
     };
 
   using HistogramFilterType =
@@ -99,6 +109,7 @@ public:
 
   using AnchorFilterType = AnchorErodeImageFilter< TInputImage, FlatKernelType >;
   using VHGWFilterType = VanHerkGilWermanErodeImageFilter< TInputImage, FlatKernelType >;
+  using ChordFilterType = ChordErodeImageFilter< TInputImage, TKernel >;
   using CastFilterType = CastImageFilter< TInputImage, TOutputImage >;
 
   /** Typedef for boundary conditions. */
@@ -148,6 +159,8 @@ private:
 
   typename VHGWFilterType::Pointer m_VHGWFilter;
 
+  typename ChordFilterType::Pointer m_ChordFilter;
+
   // and the name of the filter
   int m_Algorithm;
 
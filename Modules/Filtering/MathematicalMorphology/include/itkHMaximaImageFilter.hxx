@@ -94,6 +94,7 @@ HMaximaImageFilter< TInputImage, TOutputImage >
   dilate->SetMarkerImage( shift->GetOutput() );
   dilate->SetMaskImage( this->GetInput() );
   dilate->SetFullyConnected(m_FullyConnected);
+  dilate->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   // Must cast to the output type
   typename CastImageFilter< TInputImage, TOutputImage >::Pointer cast =
@@ -94,6 +94,7 @@ HMinimaImageFilter< TInputImage, TOutputImage >
   erode->SetMarkerImage( shift->GetOutput() );
   erode->SetMaskImage( this->GetInput() );
   erode->SetFullyConnected(m_FullyConnected);
+  erode->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   // Must cast to the output type
   typename CastImageFilter< TInputImage, TOutputImage >::Pointer cast =
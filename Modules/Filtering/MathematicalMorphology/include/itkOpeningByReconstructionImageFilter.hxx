@@ -88,6 +88,7 @@ OpeningByReconstructionImageFilter< TInputImage, TOutputImage, TKernel >
   dilate->SetMarkerImage( erode->GetOutput() );
   dilate->SetMaskImage( this->GetInput() );
   dilate->SetFullyConnected(m_FullyConnected);
+  dilate->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   progress->RegisterInternalFilter(erode, 0.5f);
   progress->RegisterInternalFilter(dilate, 0.25f);
@@ -130,6 +131,7 @@ OpeningByReconstructionImageFilter< TInputImage, TOutputImage, TKernel >
     dilateAgain->SetMaskImage ( this->GetInput() );
     dilateAgain->SetMarkerImage (tempImage);
     dilateAgain->SetFullyConnected(m_FullyConnected);
+    dilateAgain->SetNumberOfThreads( this->GetNumberOfThreads() );
     dilateAgain->GraftOutput( this->GetOutput() );
     progress->RegisterInternalFilter(dilateAgain, 0.25f);
     dilateAgain->Update();
@@ -22,7 +22,9 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include "itkImageScanlineConstIterator.h"
 #include <queue>
+#include <vector>
 
 //#define BASIC
 #define COPY
@@ -43,6 +45,13 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When UseParallelAlgorithm is on, the image is split in slabs along
+ * its last dimension. The slabs with the same parity don't touch each
+ * other: they are processed concurrently with the hybrid algorithm, and
+ * the even and odd slabs alternate until no value propagates anymore from
+ * one slab to another. The result is the same as the one of the
+ * sequential algorithm.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -135,6 +144,14 @@ public:
   itkGetConstReferenceMacro(UseInternalCopy, bool);
   itkBooleanMacro(UseInternalCopy);
 
+  /**
+   * Use the multithreaded algorithm. It works on the internal copy, so it is
+   * only used when UseInternalCopy is on. Default is on.
+   */
+  itkSetMacro(UseParallelAlgorithm, bool);
+  itkGetConstReferenceMacro(UseParallelAlgorithm, bool);
+  itkBooleanMacro(UseParallelAlgorithm);
+
 protected:
   ReconstructionImageFilter();
   ~ReconstructionImageFilter() override {}
@@ -150,6 +167,11 @@ protected:
 
   void GenerateData() override;
 
+  /** Reconstruct the padded internal copies of the marker and mask
+   * images with the multithreaded algorithm. The marker image is
+   * modified in place. */
+  void ParallelReconstruction(MarkerImageType *markerImage, const MaskImageType *maskImage);
+
   /**
    * the value of the border - used in boundary condition.
    */
@@ -158,6 +180,49 @@ protected:
 private:
   bool m_FullyConnected;
   bool m_UseInternalCopy;
+  bool m_UseParallelAlgorithm;
+
+  using OffsetValueVectorType = std::vector< OffsetValueType >;
+
+  /** A slab of the padded images, along their last dimension. */
+  struct BlockType
+    {
+    /** range of the buffer offsets in the slab */
+    OffsetValueType m_Begin;
+    OffsetValueType m_End;
+    /** offsets of the beginning of the lines of the slab, without the
+     * padding */
+    OffsetValueVectorType m_LineStarts;
+    SizeValueType m_LinesPerSlice;
+    };
+
+  struct ReconstructionThreadStruct
+    {
+    Self *                      Filter;
+    MarkerImagePixelType *      Marker;
+    const MaskImagePixelType *  Mask;
+    unsigned int                Parity;
+    bool                        FullScan;
+    std::vector< int >          Changed;
+    std::vector< int >          Invalid;
+    };
+
+  static ITK_THREAD_RETURN_TYPE ParallelReconstructionThreaderCallback(void *arg);
+
+  /** Run the hybrid algorithm in a slab when fullScan is true, or only
+   * propagate the values of the neighbor slabs otherwise. Returns true if
+   * some pixels have changed. */
+  bool ReconstructBlock(const BlockType & block,
+                        MarkerImagePixelType *marker,
+                        const MaskImagePixelType *mask,
+                        bool fullScan,
+                        bool & invalid) const;
+
+  std::vector< BlockType > m_Blocks;
+  SizeValueType            m_LineLength;
+  OffsetValueVectorType    m_NeighborOffsets;
+  OffsetValueVectorType    m_PreviousNeighborOffsets;
+  OffsetValueVectorType    m_LaterNeighborOffsets;
 
   using FaceCalculatorType = typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< OutputImageType >;
 
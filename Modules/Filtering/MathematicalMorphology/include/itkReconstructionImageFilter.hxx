@@ -25,6 +25,7 @@
 
 #include "itkConstantPadImageFilter.h"
 #include "itkCropImageFilter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -34,6 +35,8 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 {
   m_FullyConnected = false;
   m_UseInternalCopy = true;
+  m_UseParallelAlgorithm = true;
+  m_LineLength = 0;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TCompare >
@@ -172,220 +175,577 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     markerImageP = output;
     }
 
-  // declare our queue type
-  using FifoType = typename std::queue< OutputImageIndexType >;
-  FifoType IndexFifo;
-
-  NOutputIterator   outNIt;
-  InputIteratorType mskIt;
-  CNInputIterator   mskNIt;
-  ISizeType         kernelRadius;
-  kernelRadius.Fill(1);
-  if ( m_UseInternalCopy )
+  if ( m_UseInternalCopy && m_UseParallelAlgorithm )
     {
-    FaceCalculatorType faceCalculator;
-
-    FaceListType   faceList;
-    FaceListTypeIt fit;
-
-    faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(),
-                              kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    NOutputIterator tt(kernelRadius,
-                       markerImageP,
-                       *fit);
-    outNIt = tt;
-
-    InputIteratorType ttt(maskImageP,
-                          *fit);
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius,
-                         maskImageP,
-                         *fit);
-    mskNIt = tttt;
+    // the padded marker is a private copy, used as the work image
+    this->ParallelReconstruction( const_cast< MarkerImageType * >( markerImageP.GetPointer() ), maskImageP );
     }
   else
     {
-    NOutputIterator tt( kernelRadius,
-                        markerImageP,
-                        output->GetRequestedRegion() );
-    outNIt = tt;
-
-    InputIteratorType ttt( maskImageP,
-                           output->GetRequestedRegion() );
-    mskIt = ttt;
-    CNInputIterator tttt( kernelRadius,
-                          maskImageP,
+    // declare our queue type
+    using FifoType = typename std::queue< OutputImageIndexType >;
+    FifoType IndexFifo;
+
+    NOutputIterator   outNIt;
+    InputIteratorType mskIt;
+    CNInputIterator   mskNIt;
+    ISizeType         kernelRadius;
+    kernelRadius.Fill(1);
+    if ( m_UseInternalCopy )
+      {
+      FaceCalculatorType faceCalculator;
+
+      FaceListType   faceList;
+      FaceListTypeIt fit;
+
+      faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(),
+                                kernelRadius);
+      // we will only be processing the body region
+      fit = faceList.begin();
+      // must be a better way of doing this
+      NOutputIterator tt(kernelRadius,
+                         markerImageP,
+                         *fit);
+      outNIt = tt;
+
+      InputIteratorType ttt(maskImageP,
+                            *fit);
+      mskIt = ttt;
+      CNInputIterator tttt(kernelRadius,
+                           maskImageP,
+                           *fit);
+      mskNIt = tttt;
+      }
+    else
+      {
+      NOutputIterator tt( kernelRadius,
+                          markerImageP,
                           output->GetRequestedRegion() );
-    mskNIt = tttt;
-    }
+      outNIt = tt;
 
-  setConnectivityPrevious(&outNIt, m_FullyConnected);
+      InputIteratorType ttt( maskImageP,
+                             output->GetRequestedRegion() );
+      mskIt = ttt;
+      CNInputIterator tttt( kernelRadius,
+                            maskImageP,
+                            output->GetRequestedRegion() );
+      mskNIt = tttt;
+      }
 
-  ConstantBoundaryCondition< OutputImageType > oBC;
-  oBC.SetConstant(m_MarkerValue);
-  outNIt.OverrideBoundaryCondition(&oBC);
+    setConnectivityPrevious(&outNIt, m_FullyConnected);
 
-  mskIt.GoToBegin();
-  // scan in forward raster order
-  for ( outNIt.GoToBegin(), mskIt.GoToBegin(); !outNIt.IsAtEnd(); ++outNIt, ++mskIt )
-    {
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    auto iV = static_cast< OutputImagePixelType >( mskIt.Get() );
+    ConstantBoundaryCondition< OutputImageType > oBC;
+    oBC.SetConstant(m_MarkerValue);
+    outNIt.OverrideBoundaryCondition(&oBC);
 
-    // be sure that the pixels in the images follow the preconditions
-    if ( compare(V, iV) )
+    mskIt.GoToBegin();
+    // scan in forward raster order
+    for ( outNIt.GoToBegin(), mskIt.GoToBegin(); !outNIt.IsAtEnd(); ++outNIt, ++mskIt )
       {
-      if ( compare(0, 1) )
+      InputImagePixelType V = outNIt.GetCenterPixel();
+      auto iV = static_cast< OutputImagePixelType >( mskIt.Get() );
+
+      // be sure that the pixels in the images follow the preconditions
+      if ( compare(V, iV) )
         {
-        itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+        if ( compare(0, 1) )
+          {
+          itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+          }
+        else
+          {
+          itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+          }
         }
-      else
+
+      // visit the previous neighbours
+      typename NOutputIterator::ConstIterator sIt;
+      for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+        {
+        InputImagePixelType VN = sIt.Get();
+        if ( compare(VN, V) )
+          {
+          outNIt.SetCenterPixel(VN);
+          V = VN;
+          }
+        }
+
+      // this step clamps to the mask
+      if ( compare(V, iV) )
         {
-        itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+        outNIt.SetCenterPixel(iV);
         }
+
+      progress.CompletedPixel();
       }
 
-    // visit the previous neighbours
-    typename NOutputIterator::ConstIterator sIt;
-    for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+    // now for the reverse raster order pass
+    // reset the neighborhood
+    setConnectivityLater(&outNIt, m_FullyConnected);
+    outNIt.OverrideBoundaryCondition(&oBC);
+    outNIt.GoToEnd();
+    //mskIt.GoToEnd();
+
+    ConstantBoundaryCondition< InputImageType > iBC;
+    iBC.SetConstant(m_MarkerValue);
+
+    setConnectivityLater(&mskNIt, m_FullyConnected);
+    mskNIt.OverrideBoundaryCondition(&iBC);
+
+    typename NOutputIterator::IndexListType oIndexList, mIndexList;
+    typename NOutputIterator::IndexListType::const_iterator oLIt, mLIt;
+
+    oIndexList = outNIt.GetActiveIndexList();
+    mIndexList = mskNIt.GetActiveIndexList();
+
+    mskNIt.GoToEnd();
+    while ( !outNIt.IsAtBegin() )
       {
-      InputImagePixelType VN = sIt.Get();
-      if ( compare(VN, V) )
+      --outNIt;
+      --mskNIt;
+      InputImagePixelType V = outNIt.GetCenterPixel();
+      typename NOutputIterator::ConstIterator sIt;
+      for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+        {
+        InputImagePixelType VN = sIt.Get();
+        if ( compare(VN, V) )
+          {
+          outNIt.SetCenterPixel(VN);
+          V = VN;
+          }
+        }
+      InputImagePixelType iV = mskNIt.GetCenterPixel();
+      if ( compare(V, iV) )
+        {
+        outNIt.SetCenterPixel(iV);
+        V = iV;
+        }
+
+      // now put indexes in the fifo
+      //typename CNInputIterator::ConstIterator mIt;
+      for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt )
         {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
+        InputImagePixelType VN = outNIt.GetPixel(*oLIt);
+        InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
+        if ( compare(V, VN) && compare(iN, VN) )
+          {
+          IndexFifo.push( outNIt.GetIndex() );
+          break;
+          }
         }
+      progress.CompletedPixel();
       }
 
-    // this step clamps to the mask
-    if ( compare(V, iV) )
+    // Now we want to check the full neighborhood
+    setConnectivity(&outNIt, m_FullyConnected);
+    setConnectivity(&mskNIt, m_FullyConnected);
+    mskNIt.OverrideBoundaryCondition(&iBC);
+    outNIt.OverrideBoundaryCondition(&oBC);
+    oIndexList = outNIt.GetActiveIndexList();
+    mIndexList = mskNIt.GetActiveIndexList();
+    // now process the fifo - this fill the parts that weren't dealt
+    // with by the raster and anti-raster passes
+    //typename NOutputIterator::Iterator sIt;
+    typename CNInputIterator::ConstIterator mIt;
+
+    while ( !IndexFifo.empty() )
       {
-      outNIt.SetCenterPixel(iV);
+      InputImageIndexType I = IndexFifo.front();
+      IndexFifo.pop();
+      // reposition the iterators
+      outNIt += I - outNIt.GetIndex();
+      mskNIt += I - mskNIt.GetIndex();
+      InputImagePixelType V = outNIt.GetCenterPixel();
+      for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin();
+            oLIt != oIndexList.end();
+            ++oLIt, ++mLIt )
+        {
+        InputImagePixelType VN = outNIt.GetPixel(*oLIt);
+        InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
+        // candidate for dilation via flooding
+        if ( compare(V, VN) && Math::NotAlmostEquals( iN, VN ) )
+          {
+          if ( compare(iN, V) )
+            {
+            // not clamped by the mask, propagate the center value
+            outNIt.SetPixel(*oLIt, V);
+            }
+          else
+            {
+            // apply the clamping
+            outNIt.SetPixel(*oLIt, iN);
+            }
+          IndexFifo.push( outNIt.GetIndex(*oLIt) );
+          }
+        }
+      progress.CompletedPixel();
       }
+    }
+
+  if ( m_UseInternalCopy )
+    {
+    using CropType = typename itk::CropImageFilter< InputImageType, OutputImageType >;
+    typename CropType::Pointer crop = CropType::New();
+
+    crop->SetInput(markerImageP);
+    crop->SetUpperBoundaryCropSize(padSize);
+    crop->SetLowerBoundaryCropSize(padSize);
+    crop->GraftOutput( this->GetOutput() );
+    /** execute the minipipeline */
+    crop->Update();
 
-    progress.CompletedPixel();
+    /** graft the minipipeline output back into this filter's output */
+    this->GraftOutput( crop->GetOutput() );
     }
+}
 
-  // now for the reverse raster order pass
-  // reset the neighborhood
-  setConnectivityLater(&outNIt, m_FullyConnected);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  outNIt.GoToEnd();
-  //mskIt.GoToEnd();
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ParallelReconstruction(MarkerImageType *markerImage, const MaskImageType *maskImage)
+{
+  // both images are padded by one pixel, so the neighbors of all the pixels
+  // of the original image can be accessed directly with an offset in the
+  // buffer
+  const MarkerImageRegionType paddedRegion = markerImage->GetBufferedRegion();
+  const ISizeType             paddedSize = paddedRegion.GetSize();
+  const OffsetValueType *     offsetTable = markerImage->GetOffsetTable();
+
+  // the neighbor offsets in the buffer
+  m_NeighborOffsets.clear();
+  m_PreviousNeighborOffsets.clear();
+  m_LaterNeighborOffsets.clear();
+  OffsetValueType neighborCount = 1;
+  for ( unsigned int d = 0; d < MarkerImageDimension; ++d )
+    {
+    neighborCount *= 3;
+    }
+  for ( OffsetValueType n = 0; n < neighborCount; ++n )
+    {
+    OffsetValueType position = n;
+    OffsetValueType offset = 0;
+    unsigned int    nonZero = 0;
+    for ( unsigned int d = 0; d < MarkerImageDimension; ++d )
+      {
+      const OffsetValueType o = position % 3 - 1;
+      position /= 3;
+      offset += o * offsetTable[d];
+      if ( o != 0 )
+        {
+        ++nonZero;
+        }
+      }
+    if ( nonZero == 0 || ( !m_FullyConnected && nonZero > 1 ) )
+      {
+      continue;
+      }
+    m_NeighborOffsets.push_back(offset);
+    if ( offset < 0 )
+      {
+      m_PreviousNeighborOffsets.push_back(offset);
+      }
+    else
+      {
+      m_LaterNeighborOffsets.push_back(offset);
+      }
+    }
 
-  ConstantBoundaryCondition< InputImageType > iBC;
-  iBC.SetConstant(m_MarkerValue);
+  // split the image in slabs along the last dimension. The slabs with the
+  // same parity don't touch each other, so they can be processed
+  // concurrently. Each thread gets one slab of each parity.
+  constexpr unsigned int lastDimension = MarkerImageDimension - 1;
+  const SizeValueType    sliceCount = paddedSize[lastDimension] - 2;
+  const ThreadIdType     numberOfThreads = this->GetNumberOfThreads();
+  SizeValueType          numberOfBlocks = 1;
+  if ( MarkerImageDimension > 1 && numberOfThreads > 1 )
+    {
+    numberOfBlocks = std::min( static_cast< SizeValueType >( 2 * numberOfThreads ), sliceCount );
+    }
 
-  setConnectivityLater(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
+  m_LineLength = paddedSize[0] - 2;
+  m_Blocks.clear();
+  m_Blocks.resize(numberOfBlocks);
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    BlockType & block = m_Blocks[b];
 
-  typename NOutputIterator::IndexListType oIndexList, mIndexList;
-  typename NOutputIterator::IndexListType::const_iterator oLIt, mLIt;
+    // the region of the block, without the padding
+    MarkerImageRegionType blockRegion = paddedRegion;
+    for ( unsigned int d = 0; d < MarkerImageDimension; ++d )
+      {
+      blockRegion.SetIndex( d, paddedRegion.GetIndex(d) + 1 );
+      blockRegion.SetSize( d, paddedSize[d] - 2 );
+      }
+    if ( numberOfBlocks > 1 )
+      {
+      const SizeValueType firstSlice = b * sliceCount / numberOfBlocks;
+      const SizeValueType nextSlice = ( b + 1 ) * sliceCount / numberOfBlocks;
+      blockRegion.SetIndex( lastDimension, paddedRegion.GetIndex(lastDimension) + 1 + firstSlice );
+      blockRegion.SetSize( lastDimension, nextSlice - firstSlice );
+      block.m_Begin = ( firstSlice + 1 ) * offsetTable[lastDimension];
+      block.m_End = ( nextSlice + 1 ) * offsetTable[lastDimension];
+      }
+    else
+      {
+      block.m_Begin = 0;
+      block.m_End = offsetTable[MarkerImageDimension];
+      }
 
-  oIndexList = outNIt.GetActiveIndexList();
-  mIndexList = mskNIt.GetActiveIndexList();
+    block.m_LineStarts.clear();
+    block.m_LineStarts.reserve( blockRegion.GetNumberOfPixels() / m_LineLength );
+    ImageScanlineConstIterator< MarkerImageType > lineIt(markerImage, blockRegion);
+    while ( !lineIt.IsAtEnd() )
+      {
+      block.m_LineStarts.push_back( markerImage->ComputeOffset( lineIt.GetIndex() ) );
+      lineIt.NextLine();
+      }
+    block.m_LinesPerSlice = block.m_LineStarts.size() / blockRegion.GetSize(lastDimension);
+    }
 
-  mskNIt.GoToEnd();
-  while ( !outNIt.IsAtBegin() )
+  ReconstructionThreadStruct str;
+  str.Filter = this;
+  str.Marker = markerImage->GetBufferPointer();
+  str.Mask = maskImage->GetBufferPointer();
+  str.Changed.resize(numberOfThreads);
+  str.Invalid.resize(numberOfThreads);
+
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->ParallelReconstructionThreaderCallback, &str);
+
+  // the first round runs the complete hybrid algorithm in each slab. The
+  // next ones only propagate the values coming from the neighbor slabs, until
+  // the slabs are stable.
+  const unsigned int numberOfParities = ( numberOfBlocks > 1 ) ? 2 : 1;
+  bool               changed = true;
+  for ( unsigned int round = 0; changed; ++round )
     {
-    --outNIt;
-    --mskNIt;
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    typename NOutputIterator::ConstIterator sIt;
-    for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+    str.FullScan = ( round == 0 );
+    changed = false;
+    for ( unsigned int parity = 0; parity < numberOfParities; ++parity )
       {
-      InputImagePixelType VN = sIt.Get();
-      if ( compare(VN, V) )
+      str.Parity = parity;
+      std::fill(str.Changed.begin(), str.Changed.end(), 0);
+      this->GetMultiThreader()->SingleMethodExecute();
+
+      if ( str.FullScan && std::find(str.Invalid.begin(), str.Invalid.end(), 1) != str.Invalid.end() )
         {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
+        TCompare compare;
+        if ( compare(0, 1) )
+          {
+          itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+          }
+        else
+          {
+          itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+          }
+        }
+
+      // values propagated in a slab may go further in the slabs of the
+      // other parity
+      if ( std::find(str.Changed.begin(), str.Changed.end(), 1) != str.Changed.end() )
+        {
+        changed = true;
         }
       }
-    InputImagePixelType iV = mskNIt.GetCenterPixel();
-    if ( compare(V, iV) )
+    if ( numberOfParities == 1 )
       {
-      outNIt.SetCenterPixel(iV);
-      V = iV;
+      // a single slab is complete after the hybrid algorithm
+      changed = false;
       }
+    this->UpdateProgress( changed ? 0.9f : 1.0f );
+    }
+
+  m_Blocks.clear();
+}
 
-    // now put indexes in the fifo
-    //typename CNInputIterator::ConstIterator mIt;
-    for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt )
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+ITK_THREAD_RETURN_TYPE
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ParallelReconstructionThreaderCallback(void *arg)
+{
+  ThreadIdType threadId = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->ThreadID;
+  ThreadIdType threadCount = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  auto * str = (ReconstructionThreadStruct *) ( ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->UserData );
+
+  const SizeValueType numberOfBlocks = str->Filter->m_Blocks.size();
+  const SizeValueType stride = ( numberOfBlocks > 1 ) ? 2 : 1;
+  for ( SizeValueType b = str->Parity + stride * threadId; b < numberOfBlocks; b += stride * threadCount )
+    {
+    bool invalid = false;
+    if ( str->Filter->ReconstructBlock(str->Filter->m_Blocks[b], str->Marker, str->Mask, str->FullScan, invalid) )
       {
-      InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
-      if ( compare(V, VN) && compare(iN, VN) )
-        {
-        IndexFifo.push( outNIt.GetIndex() );
-        break;
-        }
+      str->Changed[threadId] = 1;
+      }
+    if ( invalid )
+      {
+      str->Invalid[threadId] = 1;
       }
-    progress.CompletedPixel();
     }
 
-  // Now we want to check the full neighborhood
-  setConnectivity(&outNIt, m_FullyConnected);
-  setConnectivity(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  oIndexList = outNIt.GetActiveIndexList();
-  mIndexList = mskNIt.GetActiveIndexList();
-  // now process the fifo - this fill the parts that weren't dealt
-  // with by the raster and anti-raster passes
-  //typename NOutputIterator::Iterator sIt;
-  typename CNInputIterator::ConstIterator mIt;
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+bool
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ReconstructBlock(const BlockType & block,
+                   MarkerImagePixelType *marker,
+                   const MaskImagePixelType *mask,
+                   bool fullScan,
+                   bool & invalid) const
+{
+  TCompare compare;
+  bool     changed = false;
 
-  while ( !IndexFifo.empty() )
+  using FifoType = std::queue< OffsetValueType >;
+  FifoType fifo;
+
+  const auto lineLength = static_cast< OffsetValueType >( m_LineLength );
+  using OffsetIterator = typename OffsetValueVectorType::const_iterator;
+
+  if ( fullScan )
     {
-    InputImageIndexType I = IndexFifo.front();
-    IndexFifo.pop();
-    // reposition the iterators
-    outNIt += I - outNIt.GetIndex();
-    mskNIt += I - mskNIt.GetIndex();
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin();
-          oLIt != oIndexList.end();
-          ++oLIt, ++mLIt )
+    // scan in forward raster order
+    for ( typename OffsetValueVectorType::const_iterator lIt = block.m_LineStarts.begin();
+          lIt != block.m_LineStarts.end(); ++lIt )
       {
-      InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
-      // candidate for dilation via flooding
-      if ( compare(V, VN) && Math::NotAlmostEquals( iN, VN ) )
+      for ( OffsetValueType p = *lIt; p < *lIt + lineLength; ++p )
         {
-        if ( compare(iN, V) )
+        MarkerImagePixelType     V = marker[p];
+        const MaskImagePixelType iV = mask[p];
+
+        // be sure that the pixels in the images follow the preconditions
+        if ( compare(V, iV) )
           {
-          // not clamped by the mask, propagate the center value
-          outNIt.SetPixel(*oLIt, V);
+          invalid = true;
           }
-        else
+
+        // visit the previous neighbours
+        for ( OffsetIterator oIt = m_PreviousNeighborOffsets.begin(); oIt != m_PreviousNeighborOffsets.end(); ++oIt )
+          {
+          const MarkerImagePixelType VN = marker[p + *oIt];
+          if ( compare(VN, V) )
+            {
+            V = VN;
+            }
+          }
+
+        // this step clamps to the mask
+        if ( compare(V, iV) )
+          {
+          V = iV;
+          }
+        if ( Math::NotExactlyEquals(V, marker[p]) )
           {
-          // apply the clamping
-          outNIt.SetPixel(*oLIt, iN);
+          marker[p] = V;
+          changed = true;
           }
-        IndexFifo.push( outNIt.GetIndex(*oLIt) );
         }
       }
-    progress.CompletedPixel();
-    }
 
-  if ( m_UseInternalCopy )
-    {
-    using CropType = typename itk::CropImageFilter< InputImageType, OutputImageType >;
-    typename CropType::Pointer crop = CropType::New();
+    // now for the reverse raster order pass
+    for ( typename OffsetValueVectorType::const_reverse_iterator lIt = block.m_LineStarts.rbegin();
+          lIt != block.m_LineStarts.rend(); ++lIt )
+      {
+      for ( OffsetValueType p = *lIt + lineLength - 1; p >= *lIt; --p )
+        {
+        MarkerImagePixelType     V = marker[p];
+        const MaskImagePixelType iV = mask[p];
+        for ( OffsetIterator oIt = m_LaterNeighborOffsets.begin(); oIt != m_LaterNeighborOffsets.end(); ++oIt )
+          {
+          const MarkerImagePixelType VN = marker[p + *oIt];
+          if ( compare(VN, V) )
+            {
+            V = VN;
+            }
+          }
+        if ( compare(V, iV) )
+          {
+          V = iV;
+          }
+        if ( Math::NotExactlyEquals(V, marker[p]) )
+          {
+          marker[p] = V;
+          changed = true;
+          }
 
-    crop->SetInput(markerImageP);
-    crop->SetUpperBoundaryCropSize(padSize);
-    crop->SetLowerBoundaryCropSize(padSize);
-    crop->GraftOutput( this->GetOutput() );
-    /** execute the minipipeline */
-    crop->Update();
+        // now put indexes in the fifo
+        for ( OffsetIterator oIt = m_LaterNeighborOffsets.begin(); oIt != m_LaterNeighborOffsets.end(); ++oIt )
+          {
+          const OffsetValueType q = p + *oIt;
+          if ( q < block.m_End && compare(V, marker[q]) && compare(mask[q], marker[q]) )
+            {
+            fifo.push(p);
+            break;
+            }
+          }
+        }
+      }
+    }
+  else
+    {
+    // propagate the values of the neighbor slabs in the first and last
+    // slices of the block
+    const SizeValueType lineCount = block.m_LineStarts.size();
+    for ( SizeValueType l = 0; l < lineCount; ++l )
+      {
+      if ( l == block.m_LinesPerSlice && lineCount > 2 * block.m_LinesPerSlice )
+        {
+        // skip the inner slices
+        l = lineCount - block.m_LinesPerSlice;
+        }
+      const OffsetValueType lineStart = block.m_LineStarts[l];
+      for ( OffsetValueType p = lineStart; p < lineStart + lineLength; ++p )
+        {
+        const MaskImagePixelType iV = mask[p];
+        for ( OffsetIterator oIt = m_NeighborOffsets.begin(); oIt != m_NeighborOffsets.end(); ++oIt )
+          {
+          const OffsetValueType q = p + *oIt;
+          if ( q >= block.m_Begin && q < block.m_End )
+            {
+            continue;
+            }
+          const MarkerImagePixelType VN = marker[q];
+          if ( compare(VN, marker[p]) && compare(iV, marker[p]) )
+            {
+            marker[p] = compare(iV, VN) ? VN : iV;
+            fifo.push(p);
+            changed = true;
+            }
+          }
+        }
+      }
+    }
 
-    /** graft the minipipeline output back into this filter's output */
-    this->GraftOutput( crop->GetOutput() );
+  // now process the fifo - this fill the parts that weren't dealt
+  // with by the raster and anti-raster passes
+  while ( !fifo.empty() )
+    {
+    const OffsetValueType p = fifo.front();
+    fifo.pop();
+    const MarkerImagePixelType V = marker[p];
+    for ( OffsetIterator oIt = m_NeighborOffsets.begin(); oIt != m_NeighborOffsets.end(); ++oIt )
+      {
+      const OffsetValueType q = p + *oIt;
+      if ( q < block.m_Begin || q >= block.m_End )
+        {
+        continue;
+        }
+      const MarkerImagePixelType VN = marker[q];
+      const MaskImagePixelType   iN = mask[q];
+      // candidate for dilation via flooding
+      if ( compare(V, VN) && compare(iN, VN) )
+        {
+        // apply the clamping
+        marker[q] = compare(iN, V) ? V : iN;
+        fifo.push(q);
+        changed = true;
+        }
+      }
     }
+
+  return changed;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TCompare >
@@ -398,6 +758,7 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
   os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
   os << indent << "MarkerValue: " << m_MarkerValue << std::endl;
   os << indent << "UseInternalCopy: " << m_UseInternalCopy << std::endl;
+  os << indent << "UseParallelAlgorithm: " << m_UseParallelAlgorithm << std::endl;
 }
 }
 #endif
@@ -0,0 +1,265 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkChordErodeImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+template< typename TImage >
+typename TImage::Pointer
+MakeChordTestImage( const typename TImage::SizeType & size )
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  itk::ImageRegionIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< typename TImage::PixelType >( generator->GetUniformVariate( 0.0, 255.0 ) ) );
+    }
+  return image;
+}
+
+template< typename TImage >
+bool
+SameImages( const TImage * image1, const TImage * image2 )
+{
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image2->GetLargestPossibleRegion() );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      {
+      std::cerr << "Pixel " << it1.GetIndex() << " differs: "
+                << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >( it1.Get() )
+                << " != "
+                << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >( it2.Get() )
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// Run the filter with each of the algorithms usable with a ball, check that
+// they all produce the same output as the basic algorithm, and report their
+// run time
+template< typename TFilter >
+int
+CompareChordAlgorithms( TFilter * filter, const char * name )
+{
+  using ImageType = typename TFilter::OutputImageType;
+
+  const int algorithms[] = { TFilter::BASIC, TFilter::HISTO, TFilter::CHORD };
+  const char * algorithmNames[] = { "BASIC", "HISTO", "CHORD" };
+
+  typename ImageType::Pointer reference;
+  int status = EXIT_SUCCESS;
+  for( unsigned int i = 0; i < 3; ++i )
+    {
+    filter->SetAlgorithm( algorithms[i] );
+
+    itk::TimeProbe probe;
+    probe.Start();
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    probe.Stop();
+
+    std::cout << name << " " << algorithmNames[i] << ": " << probe.GetTotal() << probe.GetUnit() << std::endl;
+
+    typename ImageType::Pointer output = filter->GetOutput();
+    output->DisconnectPipeline();
+    if( i == 0 )
+      {
+      reference = output;
+      }
+    else if( !SameImages< ImageType >( reference, output ) )
+      {
+      std::cerr << name << ": " << algorithmNames[i] << " differs from BASIC" << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+} // end anonymous namespace
+
+int itkChordErodeDilateImageFilterTest( int argc, char * argv[] )
+{
+  unsigned int radius = 3;
+  if( argc > 1 )
+    {
+    radius = std::stoi( argv[1] );
+    }
+
+  int status = EXIT_SUCCESS;
+
+  // 3D float image: the histogram is map based
+  {
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image< float, Dimension >;
+  using KernelType = itk::FlatStructuringElement< Dimension >;
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 23;
+  ImageType::Pointer image = MakeChordTestImage< ImageType >( size );
+
+  KernelType::RadiusType kernelRadius;
+  kernelRadius.Fill( radius );
+  kernelRadius[2] = radius + 1;
+  const KernelType ball = KernelType::Ball( kernelRadius );
+
+  using ChordFilterType = itk::ChordDilateImageFilter< ImageType, KernelType >;
+  ChordFilterType::Pointer chord = ChordFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( chord, ChordDilateImageFilter, ChordErodeDilateImageFilter );
+  chord->SetKernel( ball );
+  TEST_EXPECT_EQUAL( chord->GetMaximumChordLength(), 2 * radius + 1 );
+
+  using DilateFilterType = itk::GrayscaleDilateImageFilter< ImageType, ImageType, KernelType >;
+  DilateFilterType::Pointer dilate = DilateFilterType::New();
+  dilate->SetInput( image );
+  dilate->SetKernel( ball );
+  if( radius > 1 )
+    {
+    TEST_EXPECT_EQUAL( dilate->GetAlgorithm(), static_cast< int >( DilateFilterType::CHORD ) );
+    }
+  if( CompareChordAlgorithms( dilate.GetPointer(), "3D dilate" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  using ErodeFilterType = itk::GrayscaleErodeImageFilter< ImageType, ImageType, KernelType >;
+  ErodeFilterType::Pointer erode = ErodeFilterType::New();
+  erode->SetInput( image );
+  erode->SetKernel( ball );
+  erode->SetNumberOfThreads( 3 );
+  if( CompareChordAlgorithms( erode.GetPointer(), "3D erode" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  }
+
+  // 2D unsigned char image with a non convex kernel, where several chords
+  // share the same line
+  {
+  constexpr unsigned int Dimension = 2;
+  using ImageType = itk::Image< unsigned char, Dimension >;
+  using KernelType = itk::FlatStructuringElement< Dimension >;
+
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 47;
+  ImageType::Pointer image = MakeChordTestImage< ImageType >( size );
+
+  KernelType::RadiusType kernelRadius;
+  kernelRadius.Fill( radius + 2 );
+  const KernelType annulus = KernelType::Annulus( kernelRadius, 2, false );
+
+  using DilateFilterType = itk::GrayscaleDilateImageFilter< ImageType, ImageType, KernelType >;
+  DilateFilterType::Pointer dilate = DilateFilterType::New();
+  dilate->SetInput( image );
+  dilate->SetKernel( annulus );
+  dilate->SetBoundary( 100 );
+  if( CompareChordAlgorithms( dilate.GetPointer(), "2D dilate" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  using ErodeFilterType = itk::GrayscaleErodeImageFilter< ImageType, ImageType, KernelType >;
+  ErodeFilterType::Pointer erode = ErodeFilterType::New();
+  erode->SetInput( image );
+  erode->SetKernel( annulus );
+  erode->SetBoundary( 100 );
+  if( CompareChordAlgorithms( erode.GetPointer(), "2D erode" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  }
+
+  // 2D image with an asymmetric kernel: a reflected kernel, or chords
+  // misplaced along their line, would give a different result
+  {
+  constexpr unsigned int Dimension = 2;
+  using ImageType = itk::Image< short, Dimension >;
+  using KernelType = itk::FlatStructuringElement< Dimension >;
+
+  ImageType::SizeType size;
+  size[0] = 53;
+  size[1] = 41;
+  ImageType::Pointer image = MakeChordTestImage< ImageType >( size );
+
+  // a wedge to the right of the center, with a hole, and a detached run on
+  // the left of the top line
+  KernelType::RadiusType kernelRadius;
+  kernelRadius.Fill( radius + 1 );
+  KernelType wedge;
+  wedge.SetRadius( kernelRadius );
+  const auto r = static_cast< itk::OffsetValueType >( radius + 1 );
+  for( unsigned int i = 0; i < wedge.Size(); ++i )
+    {
+    const KernelType::OffsetType offset = wedge.GetOffset( i );
+    const bool inWedge = offset[0] >= -1 && offset[1] >= -offset[0] / 2
+      && !( offset[0] == 1 && offset[1] == 1 );
+    const bool detached = offset[1] == -r && offset[0] <= -r + 1;
+    wedge[i] = inWedge || detached;
+    }
+  TEST_EXPECT_TRUE( !wedge.GetDecomposable() );
+
+  using ChordFilterType = itk::ChordErodeImageFilter< ImageType, KernelType >;
+  ChordFilterType::Pointer chord = ChordFilterType::New();
+  chord->SetKernel( wedge );
+  std::cout << "Asymmetric kernel: " << chord->GetNumberOfChords() << " chords" << std::endl;
+
+  using DilateFilterType = itk::GrayscaleDilateImageFilter< ImageType, ImageType, KernelType >;
+  DilateFilterType::Pointer dilate = DilateFilterType::New();
+  dilate->SetInput( image );
+  dilate->SetKernel( wedge );
+  if( CompareChordAlgorithms( dilate.GetPointer(), "2D asymmetric dilate" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  using ErodeFilterType = itk::GrayscaleErodeImageFilter< ImageType, ImageType, KernelType >;
+  ErodeFilterType::Pointer erode = ErodeFilterType::New();
+  erode->SetInput( image );
+  erode->SetKernel( wedge );
+  erode->SetNumberOfThreads( 2 );
+  if( CompareChordAlgorithms( erode.GetPointer(), "2D asymmetric erode" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+  }
+
+  return status;
+}
+
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+template< typename TImage >
+bool
+SameReconstructions( const TImage * image1, const TImage * image2 )
+{
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image2->GetLargestPossibleRegion() );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      {
+      std::cerr << "Pixel " << it1.GetIndex() << " differs: "
+                << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >( it1.Get() )
+                << " != "
+                << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >( it2.Get() )
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// Compare the parallel algorithm, with several numbers of threads, to the
+// sequential one
+template< typename TFilter >
+int
+CompareReconstructions( TFilter * filter, const char * name )
+{
+  using ImageType = typename TFilter::OutputImageType;
+
+  int status = EXIT_SUCCESS;
+  for( unsigned int connectivity = 0; connectivity < 2; ++connectivity )
+    {
+    filter->SetFullyConnected( connectivity == 1 );
+
+    filter->UseParallelAlgorithmOff();
+    filter->SetNumberOfThreads( 1 );
+    itk::TimeProbe sequentialProbe;
+    sequentialProbe.Start();
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    sequentialProbe.Stop();
+    typename ImageType::Pointer reference = filter->GetOutput();
+    reference->DisconnectPipeline();
+    std::cout << name << " sequential, FullyConnected " << filter->GetFullyConnected() << ": "
+              << sequentialProbe.GetTotal() << sequentialProbe.GetUnit() << std::endl;
+
+    filter->UseParallelAlgorithmOn();
+    const itk::ThreadIdType numberOfThreads[] = { 1, 2, 3, 8 };
+    for( unsigned int i = 0; i < 4; ++i )
+      {
+      filter->SetNumberOfThreads( numberOfThreads[i] );
+      itk::TimeProbe probe;
+      probe.Start();
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      probe.Stop();
+      std::cout << name << " parallel, " << filter->GetNumberOfThreads() << " threads: "
+                << probe.GetTotal() << probe.GetUnit() << std::endl;
+
+      if( !SameReconstructions< ImageType >( reference, filter->GetOutput() ) )
+        {
+        std::cerr << name << ": parallel result with " << numberOfThreads[i]
+                  << " threads differs from the sequential one" << std::endl;
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+  return status;
+}
+
+} // end anonymous namespace
+
+int itkReconstructionImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int Dimension = 3;
+  using PixelType = short;
+  using ImageType = itk::Image< PixelType, Dimension >;
+
+  // a smooth random image, with long paths for the propagation
+  ImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 33;
+  size[2] = 27;
+  ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions( size );
+  mask->Allocate();
+  ImageType::Pointer lowMarker = ImageType::New();
+  lowMarker->SetRegions( size );
+  lowMarker->Allocate();
+  ImageType::Pointer highMarker = ImageType::New();
+  highMarker->SetRegions( size );
+  highMarker->Allocate();
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 4321 );
+
+  itk::ImageRegionIterator< ImageType > maskIt( mask, mask->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< ImageType > lowIt( lowMarker, lowMarker->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< ImageType > highIt( highMarker, highMarker->GetLargestPossibleRegion() );
+  for( ; !maskIt.IsAtEnd(); ++maskIt, ++lowIt, ++highIt )
+    {
+    const ImageType::IndexType index = maskIt.GetIndex();
+    const double wave = 100.0 * std::sin( 0.3 * index[0] ) * std::cos( 0.2 * index[1] + 0.25 * index[2] );
+    const auto value = static_cast< PixelType >( wave + generator->GetUniformVariate( 0.0, 40.0 ) );
+    maskIt.Set( value );
+    lowIt.Set( value - 30 );
+    highIt.Set( value + 30 );
+    }
+  // make sure some values have to go through all the slabs
+  ImageType::IndexType seed;
+  seed.Fill( 0 );
+  lowMarker->SetPixel( seed, mask->GetPixel( seed ) );
+  highMarker->SetPixel( seed, mask->GetPixel( seed ) );
+
+  int status = EXIT_SUCCESS;
+
+  using DilationFilterType = itk::ReconstructionByDilationImageFilter< ImageType, ImageType >;
+  DilationFilterType::Pointer dilation = DilationFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( dilation, ReconstructionByDilationImageFilter, ReconstructionImageFilter );
+  TEST_EXPECT_TRUE( dilation->GetUseParallelAlgorithm() );
+  dilation->SetMarkerImage( lowMarker );
+  dilation->SetMaskImage( mask );
+  if( CompareReconstructions( dilation.GetPointer(), "dilation" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  using ErosionFilterType = itk::ReconstructionByErosionImageFilter< ImageType, ImageType >;
+  ErosionFilterType::Pointer erosion = ErosionFilterType::New();
+  erosion->SetMarkerImage( highMarker );
+  erosion->SetMaskImage( mask );
+  if( CompareReconstructions( erosion.GetPointer(), "erosion" ) != EXIT_SUCCESS )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // the preconditions are still checked by the parallel algorithm
+  DilationFilterType::Pointer invalid = DilationFilterType::New();
+  invalid->SetMarkerImage( highMarker );
+  invalid->SetMaskImage( mask );
+  invalid->SetNumberOfThreads( 2 );
+  TRY_EXPECT_EXCEPTION( invalid->Update() );
+
+  return status;
+}
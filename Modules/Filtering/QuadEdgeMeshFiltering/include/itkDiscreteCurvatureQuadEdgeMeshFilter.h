@@ -19,8 +19,12 @@
 #define itkDiscreteCurvatureQuadEdgeMeshFilter_h
 
 #include "itkQuadEdgeMeshToQuadEdgeMeshFilter.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
+#include "itkQuadEdgeMeshSubRangeThreader.h"
 #include "itkConceptChecking.h"
 #include "itkTriangleHelper.h"
+#include <algorithm>
+#include <vector>
 
 namespace itk
 {
@@ -29,6 +33,13 @@ namespace itk
  *
  * \brief FIXME
  *
+ * The curvature of each vertex only depends on its one-ring, the vertices
+ * are therefore processed in parallel over dense index ranges. The one-ring
+ * connectivity is read from a QuadEdgeMeshOneRingAdjacency, built from the
+ * output mesh at every update unless a compatible one was set with
+ * SetOneRingAdjacency(), e.g. the one of a previous filter of the same
+ * chain.
+ *
  * \ingroup ITKQuadEdgeMeshFiltering
  */
 template< typename TInputMesh, typename TOutputMesh=TInputMesh >
@@ -48,6 +59,7 @@ public:
 
   using OutputMeshType = TOutputMesh;
   using OutputMeshPointer = typename OutputMeshType::Pointer;
+  using OutputVectorType = typename Superclass::OutputVectorType;
   using OutputPointsContainerPointer = typename OutputMeshType::PointsContainerPointer;
   using OutputPointsContainerIterator = typename OutputMeshType::PointsContainerIterator;
   using OutputPointType = typename OutputMeshType::PointType;
@@ -60,6 +72,10 @@ public:
 
   using TriangleType = TriangleHelper< OutputPointType >;
 
+  using OneRingAdjacencyType = QuadEdgeMeshOneRingAdjacency< OutputMeshType >;
+  using OneRingAdjacencyPointer = typename OneRingAdjacencyType::Pointer;
+  using VertexIndexType = typename OneRingAdjacencyType::IndexType;
+
   /** Run-time type information (and related methods).   */
   itkTypeMacro(DiscreteCurvatureQuadEdgeMeshFilter, QuadEdgeMeshToQuadEdgeMeshFilter);
 
@@ -70,12 +86,103 @@ public:
   // End concept checking
 #endif
 
+  /** Set/Get the one-ring connectivity of the mesh. A table set here is
+   * used as long as it IsCompatible() with the output mesh. Otherwise, and
+   * when none was set, a new table is built from the output mesh at every
+   * update, since IsCompatible() cannot tell whether the connectivity of a
+   * re-updated input changed. */
+  virtual void SetOneRingAdjacency(OneRingAdjacencyType *iAdjacency)
+  {
+    if ( m_OneRingAdjacency != iAdjacency )
+      {
+      m_OneRingAdjacency = iAdjacency;
+      this->Modified();
+      }
+    m_OneRingAdjacencyIsUserSet = ( iAdjacency != nullptr );
+  }
+  itkGetModifiableObjectMacro(OneRingAdjacency, OneRingAdjacencyType);
+
 protected:
-  DiscreteCurvatureQuadEdgeMeshFilter() : m_OutputMesh(nullptr) {}
+  DiscreteCurvatureQuadEdgeMeshFilter() : m_OutputMesh(nullptr), m_OneRingAdjacencyIsUserSet(false)
+  {
+    m_Threader = ThreaderType::New();
+    m_Threader->SetSubRangeMethod(&Self::EstimateCurvaturesOverSubRange);
+  }
   ~DiscreteCurvatureQuadEdgeMeshFilter() override {}
 
   virtual OutputCurvatureType EstimateCurvature(const OutputPointType & iP) = 0;
 
+  /** Estimate the curvature at the vertex of dense index iVertex of the
+   * one-ring adjacency. It is called concurrently on disjoint vertex ranges,
+   * it must not modify the filter. The default implementation forwards to
+   * EstimateCurvature(const OutputPointType &). */
+  virtual OutputCurvatureType EstimateCurvatureAtVertex(VertexIndexType iVertex)
+  {
+    return this->EstimateCurvature(
+      this->m_OutputMesh->GetPoint( m_OneRingAdjacency->GetPointIdentifier(iVertex) ) );
+  }
+
+  /** Dense index of the origin of the edges of iP, NoVertex for an isolated
+   * point. Only valid while the filter updates. */
+  VertexIndexType GetVertexIndex(const OutputPointType & iP) const
+  {
+    const OutputQEType *qe = iP.GetEdge();
+    if ( qe == nullptr )
+      {
+      return OneRingAdjacencyType::NoVertex;
+      }
+    return m_OneRingAdjacency->GetVertexIndex( qe->GetOrigin() );
+  }
+
+  /** Sums over the one-ring of iVertex, in the Onext order of its edges:
+   * the cotangent (conformal) weighted Laplacian, the mixed area, the sum of
+   * the angles at the vertex and the (unnormalized) sum of the normals of
+   * the triangles formed by consecutive neighbors. */
+  void ComputeOneRingSums(VertexIndexType iVertex,
+                          OutputVectorType & oLaplace,
+                          OutputCurvatureType & oArea,
+                          OutputCurvatureType & oSumTheta,
+                          OutputVectorType & oNormal) const
+  {
+    oLaplace.Fill(0.);
+    oNormal.Fill(0.);
+    oArea = 0.;
+    oSumTheta = 0.;
+
+    const OneRingAdjacencyType *adjacency = m_OneRingAdjacency.GetPointer();
+    const VertexIndexType begin = adjacency->GetRingBegin(iVertex);
+    const VertexIndexType end = adjacency->GetRingEnd(iVertex);
+    const OutputPointType & p = m_Positions[iVertex];
+
+    for ( VertexIndexType k = begin; k < end; ++k )
+      {
+      const OutputPointType & q0 = m_Positions[adjacency->GetNeighbor(k)];
+      const OutputPointType & q1 =
+        m_Positions[adjacency->GetNeighbor( ( k + 1 < end ) ? k + 1 : begin )];
+
+      // Same weight as ConformalMatrixCoefficients
+      OutputCoordType coeff(0.);
+      const VertexIndexType a = adjacency->GetLeftOpposite(k);
+      if ( a != OneRingAdjacencyType::NoVertex )
+        {
+        coeff += TriangleType::Cotangent(p, m_Positions[a], q0);
+        }
+      const VertexIndexType b = adjacency->GetRightOpposite(k);
+      if ( b != OneRingAdjacencyType::NoVertex )
+        {
+        coeff += TriangleType::Cotangent(p, m_Positions[b], q0);
+        }
+      coeff = std::max( NumericTraits< OutputCoordType >::ZeroValue(), coeff );
+
+      oLaplace += coeff * ( p - q0 );
+      oSumTheta += static_cast< OutputCurvatureType >(
+        TriangleType::ComputeAngle(q0, p, q1) );
+      oArea += static_cast< OutputCurvatureType >(
+        TriangleType::ComputeMixedArea(p, q0, q1) );
+      oNormal += TriangleType::ComputeNormal(q0, p, q1);
+      }
+  }
+
   OutputCurvatureType ComputeMixedArea(OutputQEType *iQE1, OutputQEType *iQE2)
   {
 
@@ -99,25 +206,68 @@ protected:
   {
     this->CopyInputMeshToOutputMesh();
 
-    OutputMeshPointer output = this->GetOutput();
+    OutputMeshType *output = this->GetOutput();
+    this->m_OutputMesh = output;
+
+    OneRingAdjacencyType *userAdjacency =
+      m_OneRingAdjacencyIsUserSet ? m_OneRingAdjacency.GetPointer() : nullptr;
+    m_OneRingAdjacency = OneRingAdjacencyType::Reuse(userAdjacency, output);
+    m_OneRingAdjacencyIsUserSet = ( m_OneRingAdjacency == userAdjacency );
+
+    OutputPointsContainerPointer points = output->GetPoints();
+    const VertexIndexType numberOfVertices = m_OneRingAdjacency->GetNumberOfVertices();
+
+    m_Positions.resize(numberOfVertices);
+    m_Curvatures.resize(numberOfVertices);
+
+    VertexIndexType v = 0;
+    for ( OutputPointsContainerIterator p_it = points->Begin(); p_it != points->End(); ++p_it, ++v )
+      {
+      m_Positions[v] = p_it.Value();
+      }
+
+    if ( numberOfVertices > 0 )
+      {
+      typename ThreaderType::IndexRangeType range;
+      range[0] = 0;
+      range[1] = numberOfVertices - 1;
+      m_Threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+      m_Threader->Execute(this, range);
+      }
 
-    OutputPointsContainerPointer  points = output->GetPoints();
-    OutputPointsContainerIterator p_it = points->Begin();
+    v = 0;
+    for ( OutputPointsContainerIterator p_it = points->Begin(); p_it != points->End(); ++p_it, ++v )
+      {
+      output->SetPointData(p_it->Index(), m_Curvatures[v]);
+      }
 
-    OutputCurvatureType curvature;
+    m_Positions.clear();
+    m_Curvatures.clear();
+  }
 
-    this->m_OutputMesh = this->GetOutput();
-    while ( p_it != points->End() )
+  void EstimateCurvaturesOverSubRange(const ThreadedIndexedContainerPartitioner::IndexRangeType & iRange)
+  {
+    for ( IndexValueType v = iRange[0]; v <= iRange[1]; ++v )
       {
-      curvature = this->EstimateCurvature( p_it->Value() );
-      output->SetPointData(p_it->Index(), curvature);
-      ++p_it;
+      m_Curvatures[v] = this->EstimateCurvatureAtVertex( static_cast< VertexIndexType >( v ) );
       }
   }
 
-private:
   /** Cache output pointer to avoid calls in inner loop to GetOutput() */
   OutputMeshType *m_OutputMesh;
+
+  OneRingAdjacencyPointer m_OneRingAdjacency;
+  bool                    m_OneRingAdjacencyIsUserSet;
+
+  /** Point coordinates in the dense order of m_OneRingAdjacency, valid while
+   * the filter updates. */
+  std::vector< OutputPointType > m_Positions;
+
+private:
+  using ThreaderType = QuadEdgeMeshSubRangeThreader< Self >;
+  typename ThreaderType::Pointer m_Threader;
+
+  std::vector< OutputCurvatureType > m_Curvatures;
 };
 } // end namespace itk
 
@@ -81,41 +81,33 @@ protected:
   DiscreteGaussianCurvatureQuadEdgeMeshFilter() {}
   ~DiscreteGaussianCurvatureQuadEdgeMeshFilter() override {}
 
+  using VertexIndexType = typename Superclass::VertexIndexType;
+
   OutputCurvatureType EstimateCurvature(const OutputPointType & iP) override
   {
-    OutputMeshPointer output = this->GetOutput();
-
-    OutputQEType *qe = iP.GetEdge();
+    const VertexIndexType v = this->GetVertexIndex(iP);
+    if ( v == Superclass::OneRingAdjacencyType::NoVertex )
+      {
+      return 0.;
+      }
+    return this->EstimateCurvatureAtVertex(v);
+  }
 
-    if ( qe != nullptr )
+  OutputCurvatureType EstimateCurvatureAtVertex(VertexIndexType iVertex) override
+  {
+    if ( this->m_OneRingAdjacency->GetValence(iVertex) == 0 )
       {
-      OutputQEType *qe_it = qe;
-      OutputQEType *qe_it2;
-
-      OutputPointType q0, q1;
-
-      OutputCurvatureType sum_theta = 0.;
-      OutputCurvatureType area = 0.;
-
-      do
-        {
-        // cell_id = qe_it->GetLeft();
-        qe_it2 = qe_it->GetOnext();
-        q0 = output->GetPoint( qe_it->GetDestination() );
-        q1 = output->GetPoint( qe_it2->GetDestination() );
-
-        // Compute Angle;
-        sum_theta += static_cast< OutputCurvatureType >(
-          TriangleType::ComputeAngle(q0, iP, q1) );
-        area += this->ComputeMixedArea(qe_it, qe_it2);
-        qe_it = qe_it2;
-        }
-      while ( qe_it != qe );
-
-      return ( 2.0 * itk::Math::pi - sum_theta ) / area;
+      return 0.;
       }
 
-    return 0.;
+    OutputVectorType    Laplace;
+    OutputVectorType    normal;
+    OutputCurvatureType area;
+    OutputCurvatureType sum_theta;
+
+    this->ComputeOneRingSums(iVertex, Laplace, area, sum_theta, normal);
+
+    return ( 2.0 * itk::Math::pi - sum_theta ) / area;
   }
 };
 }
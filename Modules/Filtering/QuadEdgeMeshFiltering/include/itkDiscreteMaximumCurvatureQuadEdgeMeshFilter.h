@@ -77,11 +77,22 @@ protected:
   DiscreteMaximumCurvatureQuadEdgeMeshFilter() {}
   ~DiscreteMaximumCurvatureQuadEdgeMeshFilter() override {}
 
+  using VertexIndexType = typename Superclass::VertexIndexType;
+
   OutputCurvatureType EstimateCurvature(const OutputPointType & iP) override
   {
     this->ComputeMeanAndGaussianCurvatures(iP);
     return this->m_Mean + std::sqrt( this->ComputeDelta() );
   }
+
+  OutputCurvatureType EstimateCurvatureAtVertex(VertexIndexType iVertex) override
+  {
+    OutputCurvatureType mean;
+    OutputCurvatureType gaussian;
+
+    this->ComputeMeanAndGaussianCurvatures(iVertex, mean, gaussian);
+    return mean + std::sqrt( Superclass::ComputeDelta(mean, gaussian) );
+  }
 };
 }
 
@@ -81,76 +81,40 @@ protected:
   DiscreteMeanCurvatureQuadEdgeMeshFilter() {}
   ~DiscreteMeanCurvatureQuadEdgeMeshFilter() override {}
 
+  using VertexIndexType = typename Superclass::VertexIndexType;
+
   OutputCurvatureType EstimateCurvature(const OutputPointType & iP) override
   {
-    OutputMeshPointer output = this->GetOutput();
-
-    OutputQEType *qe = iP.GetEdge();
-
-    OutputCurvatureType oH(0.);
-
-    OutputVectorType Laplace;
+    const VertexIndexType v = this->GetVertexIndex(iP);
+    if ( v == Superclass::OneRingAdjacencyType::NoVertex )
+      {
+      return 0.;
+      }
+    return this->EstimateCurvatureAtVertex(v);
+  }
 
-    Laplace.Fill(0.);
+  OutputCurvatureType EstimateCurvatureAtVertex(VertexIndexType iVertex) override
+  {
+    if ( this->m_OneRingAdjacency->GetValence(iVertex) < 2 )
+      {
+      return 0.;
+      }
 
-    OutputCurvatureType area(0.);
+    OutputVectorType    Laplace;
     OutputVectorType    normal;
-    normal.Fill(0.);
+    OutputCurvatureType area;
+    OutputCurvatureType sum_theta;
+
+    this->ComputeOneRingSums(iVertex, Laplace, area, sum_theta, normal);
 
-    if ( qe != nullptr )
+    if ( area < 1e-6 || !( normal.GetSquaredNorm() > 0. ) )
       {
-      if ( qe != qe->GetOnext() )
-        {
-        CoefficientType coefficent;
-
-        OutputQEType *qe_it = qe;
-        OutputQEType *qe_it2;
-
-        OutputCurvatureType temp_area;
-        OutputCoordType     temp_coeff;
-
-        OutputPointType  q0, q1;
-        OutputVectorType face_normal;
-
-        do
-          {
-          qe_it2 = qe_it->GetOnext();
-          q0 = output->GetPoint( qe_it->GetDestination() );
-          q1 = output->GetPoint( qe_it2->GetDestination() );
-
-          temp_coeff = coefficent(output, qe_it);
-          Laplace += temp_coeff * ( iP - q0 );
-
-          temp_area = this->ComputeMixedArea(qe_it, qe_it2);
-          area += temp_area;
-
-          face_normal = TriangleType::ComputeNormal(q0, iP, q1);
-          normal += face_normal;
-
-          qe_it = qe_it2;
-          }
-        while ( qe_it != qe );
-
-        if ( area < 1e-6 )
-          {
-          oH = 0.;
-          }
-        else
-          {
-          if ( normal.GetSquaredNorm() > 0. )
-            {
-            normal.Normalize();
-            Laplace *= 0.25 / area;
-            oH = Laplace * normal;
-            }
-          else
-            {
-            oH = 0.;
-            }
-          }
-        }
+      return 0.;
       }
-    return oH;
+
+    normal.Normalize();
+    Laplace *= 0.25 / area;
+    return Laplace * normal;
   }
 };
 }
@@ -75,81 +75,66 @@ protected:
     m_Gaussian(0.0), m_Mean(0.0){}
   ~DiscretePrincipalCurvaturesQuadEdgeMeshFilter() override {}
 
+  using VertexIndexType = typename Superclass::VertexIndexType;
+
+  /** Curvatures of the last point passed to
+   * ComputeMeanAndGaussianCurvatures(const OutputPointType &). They are not
+   * used by the threaded estimation. */
   OutputCurvatureType m_Gaussian;
   OutputCurvatureType m_Mean;
 
   void ComputeMeanAndGaussianCurvatures(const OutputPointType & iP)
   {
-    OutputMeshPointer output = this->GetOutput();
-
-    OutputQEType *qe = iP.GetEdge();
-
     m_Mean = 0.;
     m_Gaussian = 0.;
 
-    if ( qe != nullptr )
+    const VertexIndexType v = this->GetVertexIndex(iP);
+    if ( v != Superclass::OneRingAdjacencyType::NoVertex )
       {
-      OutputVectorType Laplace;
-      Laplace.Fill(0.);
-
-      OutputQEType *qe_it = qe;
-
-      OutputCurvatureType area(0.), sum_theta(0.);
-
-      if ( qe_it != qe_it->GetOnext() )
-        {
-        qe_it = qe;
-        OutputQEType *qe_it2;
-
-        OutputPointType  q0, q1;
-        OutputVectorType face_normal;
-
-        OutputVectorType normal;
-        normal.Fill(0.);
-
-        OutputCurvatureType temp_area;
-        OutputCoordType     temp_coeff;
-
-        CoefficientType coefficent;
-
-        do
-          {
-          qe_it2 = qe_it->GetOnext();
-          q0 = output->GetPoint( qe_it->GetDestination() );
-          q1 = output->GetPoint( qe_it2->GetDestination() );
-
-          temp_coeff = coefficent(output, qe_it);
-          Laplace += temp_coeff * ( iP - q0 );
+      this->ComputeMeanAndGaussianCurvatures(v, m_Mean, m_Gaussian);
+      }
+  }
 
-          // Compute Angle;
-          sum_theta += static_cast< OutputCurvatureType >(
-            TriangleType::ComputeAngle(q0, iP, q1) );
+  /** Thread safe version, the curvatures are returned in oMean and
+   * oGaussian. */
+  void ComputeMeanAndGaussianCurvatures(VertexIndexType iVertex,
+                                        OutputCurvatureType & oMean,
+                                        OutputCurvatureType & oGaussian) const
+  {
+    oMean = 0.;
+    oGaussian = 0.;
 
-          temp_area = this->ComputeMixedArea(qe_it, qe_it2);
-          area += temp_area;
+    if ( this->m_OneRingAdjacency->GetValence(iVertex) < 2 )
+      {
+      return;
+      }
 
-          face_normal = TriangleType::ComputeNormal(q0, iP, q1);
-          normal += face_normal;
+    OutputVectorType    Laplace;
+    OutputVectorType    normal;
+    OutputCurvatureType area;
+    OutputCurvatureType sum_theta;
 
-          qe_it = qe_it2;
-          }
-        while ( qe_it != qe );
+    this->ComputeOneRingSums(iVertex, Laplace, area, sum_theta, normal);
 
-        if ( area > 1e-10 )
-          {
-          area = 1. / area;
-          Laplace *= 0.25 * area;
-          m_Mean = Laplace * normal;
-          m_Gaussian = ( 2. * itk::Math::pi - sum_theta ) * area;
-          }
-        }
+    if ( area > 1e-10 )
+      {
+      area = 1. / area;
+      Laplace *= 0.25 * area;
+      oMean = Laplace * normal;
+      oGaussian = ( 2. * itk::Math::pi - sum_theta ) * area;
       }
   }
 
   virtual OutputCurvatureType ComputeDelta()
+  {
+    return ComputeDelta(m_Mean, m_Gaussian);
+  }
+
+  static OutputCurvatureType ComputeDelta(const OutputCurvatureType & iMean,
+                                          const OutputCurvatureType & iGaussian)
   {
     return std::max( static_cast<OutputCurvatureType>( 0. ),
-                         m_Mean * m_Mean - m_Gaussian );
+                         iMean * iMean - iGaussian );
   }
 
 private:
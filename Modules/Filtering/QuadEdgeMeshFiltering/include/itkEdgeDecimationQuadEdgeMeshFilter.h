@@ -20,6 +20,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <algorithm>
 
 #include "itkQuadEdgeMeshEulerOperatorJoinVertexFunction.h"
@@ -64,6 +65,7 @@ public:
   using OutputCellIdentifier = typename OutputMeshType::CellIdentifier;
   using OutputCellsContainerPointer = typename OutputMeshType::CellsContainerPointer;
   using OutputCellsContainerIterator = typename OutputMeshType::CellsContainerIterator;
+  using OutputPointsContainerIterator = typename OutputMeshType::PointsContainerIterator;
 
   using OutputPolygonType = QuadEdgeMeshPolygonCell< OutputCellType >;
 
@@ -85,6 +87,18 @@ public:
   using OperatorType = QuadEdgeMeshEulerOperatorJoinVertexFunction< OutputMeshType, OutputQEType >;
   using OperatorPointer = typename OperatorType::Pointer;
 
+  /** Collapse the edges in rounds.  Each round extracts, in priority
+   * order, the cheapest edges whose closed one-rings do not overlap.  The
+   * new locations of these independent edges are computed concurrently,
+   * the edges are collapsed, and the edges around the merged vertices are
+   * then measured concurrently before the next round.  Edges which become
+   * cheaper during a round wait for the next one, so the result differs
+   * slightly from the strictly greedy order.  MeasureEdge() and
+   * Relocate() must be thread safe when this is on.  Off by default. */
+  itkSetMacro(ParallelDecimation, bool);
+  itkGetConstMacro(ParallelDecimation, bool);
+  itkBooleanMacro(ParallelDecimation);
+
 protected:
 
   EdgeDecimationQuadEdgeMeshFilter();
@@ -99,6 +113,21 @@ protected:
   PriorityType         m_Priority;
   OperatorPointer      m_JoinVertexFunction;
 
+  bool m_ParallelDecimation;
+
+  /** Edges of the current round, with their priorities and their
+   * precomputed locations, and the edges to measure before the next
+   * round. */
+  std::vector< OutputQEType * >    m_RoundElements;
+  std::vector< PriorityType >      m_RoundPriorities;
+  std::vector< OutputPointType >   m_RoundLocations;
+  SizeValueType                    m_RoundPosition;
+  std::vector< OutputQEType * >    m_ElementsToMeasure;
+  std::vector< bool >              m_LockedPoints;
+  std::vector< OutputPointIdentifier > m_LockedPointIds;
+  OutputPointType                  m_Location;
+  bool                             m_LocationIsComputed;
+
   /**
   * \brief Compute the measure value for iEdge
   * \param[in] iEdge
@@ -129,6 +158,46 @@ protected:
   */
   void Extract() override;
 
+  /**
+  * \brief Measure the edges left by the previous round and extract the
+  * next round of independent edges.
+  */
+  void ExtractRound();
+
+  /**
+  * \brief Lock the closed one-ring of iEdge for the current round
+  * \return false if one of its points is already locked
+  */
+  bool LockOneRing(OutputQEType *iEdge);
+
+  /**
+  * \brief Measure iEdges, concurrently when there are enough of them
+  */
+  void MeasureEdges(const std::vector< OutputQEType * > & iEdges,
+                    std::vector< MeasureType > & oMeasures);
+
+  /**
+  * \brief Compute the location of iEdges, concurrently when there are
+  * enough of them
+  */
+  void RelocateEdges(const std::vector< OutputQEType * > & iEdges,
+                     std::vector< OutputPointType > & oLocations);
+
+  struct ThreadStruct
+  {
+    Self *                                Filter;
+    const std::vector< OutputQEType * > * Edges;
+    std::vector< MeasureType > *          Measures;
+    std::vector< OutputPointType > *      Locations;
+  };
+
+  static ITK_THREAD_RETURN_TYPE MeasureEdgesThreaderCallback(void *arg);
+
+  static ITK_THREAD_RETURN_TYPE RelocateEdgesThreaderCallback(void *arg);
+
+  /** Number of threads to use for n independent items */
+  ThreadIdType GetNumberOfThreadsForItems(SizeValueType n) const;
+
   /**
   * \brief Delete a given edge in the priority queue
   * \param[in] iEdge
@@ -145,6 +214,13 @@ protected:
   */
   virtual void PushOrUpdateElement(OutputQEType *iEdge);
 
+  /**
+  * \brief Same as PushOrUpdateElement(), with an already computed
+  * measure for iEdge, which must be the edge whose origin is the smallest
+  * point identifier.
+  */
+  void PushOrUpdateElement(OutputQEType *iEdge, const MeasureType & iMeasure);
+
   /**
   * \brief
   */
@@ -28,8 +28,10 @@ EdgeDecimationQuadEdgeMeshFilter() :
   Superclass(),
   m_Relocate(true),
   m_CheckOrientation(false),
-  m_Element(nullptr)
-
+  m_Element(nullptr),
+  m_ParallelDecimation(false),
+  m_RoundPosition(0),
+  m_LocationIsComputed(false)
 {
   m_JoinVertexFunction = OperatorType::New();
   m_PriorityQueue = PriorityQueueType::New();
@@ -68,16 +70,169 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::FillPriorityQue
   // cache for use in MeasureEdge
   this->m_OutputMesh = this->GetOutput();
 
+  if ( !m_ParallelDecimation )
+    {
+    while ( it != end )
+      {
+      edge = dynamic_cast< OutputEdgeCellType * >( it.Value() );
+
+      if ( edge )
+        {
+        PushElement( edge->GetQEGeom() );
+        }
+      ++it;
+      }
+    return;
+    }
+
+  m_RoundElements.clear();
+  m_RoundPriorities.clear();
+  m_RoundLocations.clear();
+  m_RoundPosition = 0;
+  m_ElementsToMeasure.clear();
+  m_LocationIsComputed = false;
+
+  OutputPointIdentifier maxPointId = 0;
+  OutputPointsContainerIterator p_it = output->GetPoints()->Begin();
+  while ( p_it != output->GetPoints()->End() )
+    {
+    maxPointId = std::max( maxPointId, p_it.Index() );
+    ++p_it;
+    }
+  m_LockedPoints.assign(maxPointId + 1, false);
+  m_LockedPointIds.clear();
+
+  // Measure all the edges concurrently, then fill the queue in the same
+  // order as the serial mode.
+  std::vector< OutputQEType * > edges;
+  edges.reserve( output->GetEdgeCells()->Size() );
   while ( it != end )
     {
     edge = dynamic_cast< OutputEdgeCellType * >( it.Value() );
 
     if ( edge )
       {
-      PushElement( edge->GetQEGeom() );
+      OutputQEType *qe = edge->GetQEGeom();
+      edges.push_back( ( qe->GetOrigin() < qe->GetDestination() ) ? qe : qe->GetSym() );
       }
     ++it;
     }
+
+  std::vector< MeasureType > measures;
+  this->MeasureEdges(edges, measures);
+
+  for ( size_t i = 0; i < edges.size(); ++i )
+    {
+    auto * qi = new PriorityQueueItemType( edges[i], PriorityType(false, measures[i]) );
+
+    m_QueueMapper[edges[i]] = qi;
+    m_PriorityQueue->Push(qi);
+    }
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+ThreadIdType
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::GetNumberOfThreadsForItems(SizeValueType n) const
+{
+  // below a few dozens of edges per thread, the threads cost more than
+  // they save
+  const SizeValueType numberOfThreads = std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+                                                  n / 64 );
+  return static_cast< ThreadIdType >( std::max( numberOfThreads, static_cast< SizeValueType >( 1 ) ) );
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::MeasureEdges(
+  const std::vector< OutputQEType * > & iEdges,
+  std::vector< MeasureType > & oMeasures)
+{
+  oMeasures.resize( iEdges.size() );
+
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsForItems( iEdges.size() );
+  if ( numberOfThreads == 1 )
+    {
+    for ( size_t i = 0; i < iEdges.size(); ++i )
+      {
+      oMeasures[i] = this->MeasureEdge(iEdges[i]);
+      }
+    return;
+    }
+
+  ThreadStruct str;
+  str.Filter = this;
+  str.Edges = &iEdges;
+  str.Measures = &oMeasures;
+  str.Locations = nullptr;
+
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->MeasureEdgesThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::RelocateEdges(
+  const std::vector< OutputQEType * > & iEdges,
+  std::vector< OutputPointType > & oLocations)
+{
+  oLocations.resize( iEdges.size() );
+
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsForItems( iEdges.size() );
+  if ( numberOfThreads == 1 )
+    {
+    for ( size_t i = 0; i < iEdges.size(); ++i )
+      {
+      oLocations[i] = this->Relocate(iEdges[i]);
+      }
+    return;
+    }
+
+  ThreadStruct str;
+  str.Filter = this;
+  str.Edges = &iEdges;
+  str.Measures = nullptr;
+  str.Locations = &oLocations;
+
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->RelocateEdgesThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+ITK_THREAD_RETURN_TYPE
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::MeasureEdgesThreaderCallback(void *arg)
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+
+  const size_t n = str->Edges->size();
+  const size_t begin = n * info->ThreadID / info->NumberOfThreads;
+  const size_t end = n * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  for ( size_t i = begin; i < end; ++i )
+    {
+    ( *str->Measures )[i] = str->Filter->MeasureEdge( ( *str->Edges )[i] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+ITK_THREAD_RETURN_TYPE
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::RelocateEdgesThreaderCallback(void *arg)
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+
+  const size_t n = str->Edges->size();
+  const size_t begin = n * info->ThreadID / info->NumberOfThreads;
+  const size_t end = n * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  for ( size_t i = begin; i < end; ++i )
+    {
+    ( *str->Locations )[i] = str->Filter->Relocate( ( *str->Edges )[i] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TInput, typename TOutput, typename TCriterion >
@@ -163,7 +318,34 @@ template< typename TInput, typename TOutput, typename TCriterion >
 void
 EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::Extract()
 {
-  OutputMeshPointer output = this->GetOutput();
+  m_LocationIsComputed = false;
+
+  if ( m_ParallelDecimation )
+    {
+    if ( m_RoundPosition >= m_RoundElements.size() )
+      {
+      this->ExtractRound();
+      }
+    if ( m_RoundPosition < m_RoundElements.size() )
+      {
+      m_Element = m_RoundElements[m_RoundPosition];
+      m_Priority = m_RoundPriorities[m_RoundPosition];
+      if ( m_Relocate )
+        {
+        m_Location = m_RoundLocations[m_RoundPosition];
+        m_LocationIsComputed = true;
+        }
+      ++m_RoundPosition;
+      return;
+      }
+    if ( m_PriorityQueue->Empty() )
+      {
+      // only invalid edges were left
+      m_Element = nullptr;
+      m_Priority = PriorityType( true, static_cast< MeasureType >( 0. ) );
+      return;
+      }
+    }
 
   do
     {
@@ -178,6 +360,117 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::Extract()
   while ( !IsEdgeOKToBeProcessed(m_Element) );
 }
 
+template< typename TInput, typename TOutput, typename TCriterion >
+bool
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::LockOneRing(OutputQEType *iEdge)
+{
+  OutputQEType *qe[2] = { iEdge, iEdge->GetSym() };
+
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    OutputQEType *qe_it = qe[i];
+    do
+      {
+      OutputPointIdentifier id = qe_it->GetDestination();
+      if ( id < m_LockedPoints.size() && m_LockedPoints[id] )
+        {
+        return false;
+        }
+      qe_it = qe_it->GetOnext();
+      }
+    while ( qe_it != qe[i] );
+    }
+
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    OutputQEType *qe_it = qe[i];
+    do
+      {
+      OutputPointIdentifier id = qe_it->GetDestination();
+      if ( id >= m_LockedPoints.size() )
+        {
+        m_LockedPoints.resize(id + 1, false);
+        }
+      m_LockedPoints[id] = true;
+      m_LockedPointIds.push_back(id);
+      qe_it = qe_it->GetOnext();
+      }
+    while ( qe_it != qe[i] );
+    }
+  return true;
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::ExtractRound()
+{
+  // The edges around the points merged during the previous round are
+  // measured together.
+  std::vector< MeasureType > measures;
+  this->MeasureEdges(m_ElementsToMeasure, measures);
+  for ( size_t i = 0; i < m_ElementsToMeasure.size(); ++i )
+    {
+    this->PushOrUpdateElement(m_ElementsToMeasure[i], measures[i]);
+    }
+  m_ElementsToMeasure.clear();
+
+  m_RoundElements.clear();
+  m_RoundPriorities.clear();
+  m_RoundPosition = 0;
+
+  // Scan the top of the queue: an edge joins the round when its closed
+  // one-ring does not overlap the one of a cheaper edge of the round, so
+  // that the edges of a round can be collapsed in any order and measured
+  // concurrently afterwards. The other scanned edges are postponed.
+  const SizeValueType scanLimit =
+    std::max( static_cast< SizeValueType >( 64 ),
+              static_cast< SizeValueType >( m_PriorityQueue->Size() / 32 ) );
+
+  std::vector< PriorityQueueItemType * > postponed;
+  SizeValueType                          scanned = 0;
+
+  while ( !m_PriorityQueue->Empty() && scanned < scanLimit )
+    {
+    PriorityQueueItemType *qi = m_PriorityQueue->Peek();
+    if ( qi->m_Priority.first )
+      {
+      break;
+      }
+    m_PriorityQueue->Pop();
+    ++scanned;
+
+    OutputQEType *element = qi->m_Element;
+    if ( IsEdgeOKToBeProcessed(element) )
+      {
+      if ( !this->LockOneRing(element) )
+        {
+        postponed.push_back(qi);
+        continue;
+        }
+      m_RoundElements.push_back(element);
+      m_RoundPriorities.push_back(qi->m_Priority);
+      }
+    m_QueueMapper.erase(element);
+    delete qi;
+    }
+
+  for ( size_t i = 0; i < postponed.size(); ++i )
+    {
+    m_PriorityQueue->Push(postponed[i]);
+    }
+
+  for ( size_t i = 0; i < m_LockedPointIds.size(); ++i )
+    {
+    m_LockedPoints[m_LockedPointIds[i]] = false;
+    }
+  m_LockedPointIds.clear();
+
+  if ( m_Relocate )
+    {
+    this->RelocateEdges(m_RoundElements, m_RoundLocations);
+    }
+}
+
 template< typename TInput, typename TOutput, typename TCriterion >
 void
 EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::DeleteElement(OutputQEType *iEdge)
@@ -232,6 +525,29 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::PushOrUpdateEle
     }
 }
 
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::PushOrUpdateElement(OutputQEType *iEdge,
+                                                                                     const MeasureType & iMeasure)
+{
+  auto map_it = m_QueueMapper.find(iEdge);
+
+  if ( map_it != m_QueueMapper.end() )
+    {
+    if ( !map_it->second->m_Priority.first )
+      {
+      map_it->second->m_Priority.second = iMeasure;
+      m_PriorityQueue->Update(map_it->second);
+      }
+    }
+  else
+    {
+    auto * qi = new PriorityQueueItemType( iEdge, PriorityType(false, iMeasure) );
+    m_QueueMapper[iEdge] = qi;
+    m_PriorityQueue->Push(qi);
+    }
+}
+
 template< typename TInput, typename TOutput, typename TCriterion >
 void
 EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::JoinVertexFailed()
@@ -313,7 +629,11 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::ProcessWithoutA
 
   bool to_be_processed(true);
 
-  if ( m_Relocate )
+  if ( m_LocationIsComputed )
+    {
+    pt = m_Location;
+    }
+  else if ( m_Relocate )
     {
     pt = Relocate(m_Element);
     }
@@ -390,12 +710,25 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::ProcessWithoutA
 
     temp = edge;
 
-    do
+    if ( m_ParallelDecimation )
+      {
+      // measured with the other edges of the round, before the next one
+      do
+        {
+        m_ElementsToMeasure.push_back( ( temp->GetOrigin() < temp->GetDestination() ) ? temp : temp->GetSym() );
+        temp = temp->GetOnext();
+        }
+      while ( temp != edge );
+      }
+    else
       {
-      PushOrUpdateElement(temp);
-      temp = temp->GetOnext();
+      do
+        {
+        PushOrUpdateElement(temp);
+        temp = temp->GetOnext();
+        }
+      while ( temp != edge );
       }
-    while ( temp != edge );
     }
   return false;
 }
@@ -590,7 +923,7 @@ template< typename TInput, typename TOutput, typename TCriterion >
 bool
 EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::IsCriterionSatisfied()
 {
-  if ( m_PriorityQueue->Empty() )
+  if ( m_PriorityQueue->Empty() && m_RoundPosition >= m_RoundElements.size() && m_ElementsToMeasure.empty() )
     {
     return true;
     }
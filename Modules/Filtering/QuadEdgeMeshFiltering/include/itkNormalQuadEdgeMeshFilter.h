@@ -20,7 +20,10 @@
 
 #include "itkQuadEdgeMeshToQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshPolygonCell.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
+#include "itkQuadEdgeMeshSubRangeThreader.h"
 #include "itkTriangleHelper.h"
+#include <vector>
 
 namespace itk
 {
@@ -57,6 +60,11 @@ namespace itk
  *
  * \note By default the weight is set to the TURMER weight.
  *
+ * Face normals, then vertex normals, are computed in parallel over dense
+ * index ranges. The vertices are enumerated by a
+ * QuadEdgeMeshOneRingAdjacency, which can be shared with the other filters
+ * of a chain through SetOneRingAdjacency().
+ *
  * \todo Fix run-time issues regarding the difference between the Traits of
  * TInputMesh and the one of TOutputMesh. Right now, it only works if
  * TInputMesh::MeshTraits == TOutputMesh::MeshTraits
@@ -125,6 +133,25 @@ public:
   itkSetMacro (Weight, WeightType);
   itkGetConstMacro (Weight, WeightType);
 
+  using OneRingAdjacencyType = QuadEdgeMeshOneRingAdjacency< OutputMeshType >;
+  using OneRingAdjacencyPointer = typename OneRingAdjacencyType::Pointer;
+
+  /** Set/Get the one-ring connectivity of the mesh. A table set here is
+   * used as long as it IsCompatible() with the output mesh. Otherwise, and
+   * when none was set, a new table is built from the output mesh at every
+   * update, since IsCompatible() cannot tell whether the connectivity of a
+   * re-updated input changed. */
+  virtual void SetOneRingAdjacency(OneRingAdjacencyType *iAdjacency)
+  {
+    if ( m_OneRingAdjacency != iAdjacency )
+      {
+      m_OneRingAdjacency = iAdjacency;
+      this->Modified();
+      }
+    m_OneRingAdjacencyIsUserSet = ( iAdjacency != nullptr );
+  }
+  itkGetModifiableObjectMacro(OneRingAdjacency, OneRingAdjacencyType);
+
 protected:
   NormalQuadEdgeMeshFilter();
   ~NormalQuadEdgeMeshFilter() override;
@@ -140,18 +167,22 @@ protected:
   */
   OutputFaceNormalType ComputeFaceNormal(OutputPolygonType *iPoly);
 
-  /** \brief Compute the normal to all faces on the mesh.
-  * \note This method should be implemented in a multi-thread way in order
-  * to reduce the processing time.
+  /** \brief Compute the normal to all faces on the mesh, in parallel over
+  * the triangles.
   */
   void ComputeAllFaceNormals();
 
-  /** \brief Compute the normal to all vertices on the mesh.
-  * \note This method should be implemented in a multi-thread way in order
-  * to reduce the processing time.
+  /** \brief Compute the normal to all vertices on the mesh, in parallel over
+  * the vertices of the one-ring adjacency.
   */
   void ComputeAllVertexNormals();
 
+  using IndexRangeType = ThreadedIndexedContainerPartitioner::IndexRangeType;
+
+  void ComputeFaceNormalsOverSubRange(const IndexRangeType & iRange);
+
+  void ComputeVertexNormalsOverSubRange(const IndexRangeType & iRange);
+
   /** \brief Compute the normal to one vertex by a weighted sum of the faces
   * normal in the 0-ring.
   * \note The weight is chosen by the member m_Weight.
@@ -165,13 +196,46 @@ protected:
                                          const OutputCellIdentifier & iCId,
                                          OutputMeshType *outputMesh);
 
+  using TriangleIdentifiersType = FixedArray< OutputPointIdentifier, 3 >;
+  using TriangleWeightsType = FixedArray< OutputVertexNormalComponentType, 3 >;
+
+  /** \brief Weights of the three corners of the triangle iPoly, in the
+  * Lnext order of its edges starting from its edge ring entry, which is
+  * also the order of the point identifiers returned in oIds.
+  */
+  void ComputeTriangleWeights(OutputPolygonType *iPoly,
+                              TriangleIdentifiersType & oIds,
+                              TriangleWeightsType & oWeights) const;
+
   /** \note Calling Superclass::GenerateData( ) is the longest part in the
   * filter! Something must be done in the class
   * itkQuadEdgeMeshToQuadEdgeMeshFilter.
   */
   void GenerateData() override;
 
+  OneRingAdjacencyPointer m_OneRingAdjacency;
+  bool                    m_OneRingAdjacencyIsUserSet;
+
 private:
+  using ThreaderType = QuadEdgeMeshSubRangeThreader< Self >;
+  typename ThreaderType::Pointer m_Threader;
+
+  /** Cache output pointer to avoid calls in inner loop to GetOutput() */
+  OutputMeshType *m_OutputMesh;
+
+  /** Triangles of the output mesh and their normals, while updating. */
+  std::vector< OutputCellIdentifier >    m_TriangleIdentifiers;
+  std::vector< OutputPolygonType * >     m_Triangles;
+  std::vector< OutputFaceNormalType >    m_FaceNormals;
+  std::vector< TriangleIdentifiersType > m_TriangleCorners;
+  std::vector< TriangleWeightsType >     m_TriangleWeights;
+  std::vector< OutputVertexNormalType >  m_VertexNormals;
+
+  /** Index in m_Triangles of each cell identifier. Only filled when all the
+   * faces are triangles; the vertex normals are then accumulated from the
+   * face normals and weights above instead of the cell data. */
+  std::vector< SizeValueType > m_TriangleIndices;
+
   NormalQuadEdgeMeshFilter (const Self &);
   void operator=(const Self &);
 };
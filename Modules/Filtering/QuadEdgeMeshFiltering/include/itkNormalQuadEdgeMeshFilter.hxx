@@ -20,14 +20,19 @@
 
 #include "itkNormalQuadEdgeMeshFilter.h"
 #include "itkMath.h"
+#include <algorithm>
 
 namespace itk
 {
 template< typename TInputMesh, typename TOutputMesh >
 NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
-::NormalQuadEdgeMeshFilter()
+::NormalQuadEdgeMeshFilter() :
+  m_OneRingAdjacencyIsUserSet(false),
+  m_OutputMesh(nullptr)
 {
   this->m_Weight = THURMER;
+
+  this->m_Threader = ThreaderType::New();
 }
 
 template< typename TInputMesh, typename TOutputMesh >
@@ -40,7 +45,7 @@ typename NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::OutputFaceNormalTy
 NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::ComputeFaceNormal(OutputPolygonType *iPoly)
 {
-  OutputMeshPointer output = this->GetOutput();
+  const OutputMeshType *output = this->m_OutputMesh;
 
   OutputPointType pt[3];
   int             k(0);
@@ -63,9 +68,14 @@ void
 NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::ComputeAllFaceNormals()
 {
-  OutputMeshPointer  output = this->GetOutput();
+  OutputMeshType    *output = this->m_OutputMesh;
   OutputPolygonType *poly;
 
+  m_TriangleIdentifiers.clear();
+  m_Triangles.clear();
+  m_TriangleIdentifiers.reserve( output->GetNumberOfFaces() );
+  m_Triangles.reserve( output->GetNumberOfFaces() );
+
   for ( OutputCellsContainerConstIterator
         cell_it = output->GetCells()->Begin();
         cell_it != output->GetCells()->End();
@@ -77,10 +87,55 @@ NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
       {
       if ( poly->GetNumberOfPoints() == 3 )
         {
-        output->SetCellData( cell_it->Index(), ComputeFaceNormal(poly) );
+        m_TriangleIdentifiers.push_back( cell_it->Index() );
+        m_Triangles.push_back(poly);
         }
       }
     }
+
+  m_FaceNormals.resize( m_Triangles.size() );
+  m_TriangleCorners.resize( m_Triangles.size() );
+  m_TriangleWeights.resize( m_Triangles.size() );
+  if ( !m_Triangles.empty() )
+    {
+    IndexRangeType range;
+    range[0] = 0;
+    range[1] = m_Triangles.size() - 1;
+    m_Threader->SetSubRangeMethod(&Self::ComputeFaceNormalsOverSubRange);
+    m_Threader->Execute(this, range);
+    }
+
+  for ( size_t i = 0; i < m_Triangles.size(); ++i )
+    {
+    output->SetCellData( m_TriangleIdentifiers[i], m_FaceNormals[i] );
+    }
+
+  m_TriangleIndices.clear();
+  if ( m_Triangles.size() == output->GetNumberOfFaces() && !m_Triangles.empty() )
+    {
+    const OutputCellIdentifier maximumIdentifier =
+      *std::max_element( m_TriangleIdentifiers.begin(), m_TriangleIdentifiers.end() );
+    m_TriangleIndices.resize( maximumIdentifier + 1, NumericTraits< SizeValueType >::max() );
+    for ( size_t i = 0; i < m_Triangles.size(); ++i )
+      {
+      m_TriangleIndices[m_TriangleIdentifiers[i]] = i;
+      }
+    }
+
+  m_TriangleIdentifiers.clear();
+  m_Triangles.clear();
+}
+
+template< typename TInputMesh, typename TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeFaceNormalsOverSubRange(const IndexRangeType & iRange)
+{
+  for ( IndexValueType i = iRange[0]; i <= iRange[1]; ++i )
+    {
+    m_FaceNormals[i] = this->ComputeFaceNormal( m_Triangles[i] );
+    this->ComputeTriangleWeights( m_Triangles[i], m_TriangleCorners[i], m_TriangleWeights[i] );
+    }
 }
 
 template< typename TInputMesh, typename TOutputMesh >
@@ -88,18 +143,89 @@ void
 NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::ComputeAllVertexNormals()
 {
-  OutputMeshPointer            output = this->GetOutput();
-  OutputPointsContainerPointer points = output->GetPoints();
-  OutputPointIdentifier        id;
+  OutputMeshType *output = this->m_OutputMesh;
+
+  OneRingAdjacencyType *userAdjacency =
+    m_OneRingAdjacencyIsUserSet ? m_OneRingAdjacency.GetPointer() : nullptr;
+  m_OneRingAdjacency = OneRingAdjacencyType::Reuse(userAdjacency, output);
+  m_OneRingAdjacencyIsUserSet = ( m_OneRingAdjacency == userAdjacency );
 
-  OutputMeshType *outputMesh = this->GetOutput();
+  const SizeValueType numberOfVertices = m_OneRingAdjacency->GetNumberOfVertices();
 
-  for ( OutputPointsContainerIterator it = points->Begin();
-        it != points->End();
-        ++it )
+  m_VertexNormals.resize(numberOfVertices);
+  if ( numberOfVertices > 0 )
     {
-    id = it->Index();
-    output->SetPointData( id, ComputeVertexNormal(id,outputMesh));
+    IndexRangeType range;
+    range[0] = 0;
+    range[1] = numberOfVertices - 1;
+    m_Threader->SetSubRangeMethod(&Self::ComputeVertexNormalsOverSubRange);
+    m_Threader->Execute(this, range);
+    }
+
+  for ( SizeValueType v = 0; v < numberOfVertices; ++v )
+    {
+    output->SetPointData( m_OneRingAdjacency->GetPointIdentifier(v), m_VertexNormals[v] );
+    }
+
+  m_VertexNormals.clear();
+  m_FaceNormals.clear();
+  m_TriangleCorners.clear();
+  m_TriangleWeights.clear();
+  m_TriangleIndices.clear();
+}
+
+template< typename TInputMesh, typename TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeVertexNormalsOverSubRange(const IndexRangeType & iRange)
+{
+  OutputMeshType *output = this->m_OutputMesh;
+
+  if ( m_TriangleIndices.empty() )
+    {
+    for ( IndexValueType v = iRange[0]; v <= iRange[1]; ++v )
+      {
+      m_VertexNormals[v] =
+        this->ComputeVertexNormal( m_OneRingAdjacency->GetPointIdentifier(v), output );
+      }
+    return;
+    }
+
+  // Same sum as ComputeVertexNormal, reading the face normals and weights
+  // computed with the face normals instead of looking the faces up.
+  for ( IndexValueType v = iRange[0]; v <= iRange[1]; ++v )
+    {
+    const OutputPointIdentifier id = m_OneRingAdjacency->GetPointIdentifier(v);
+
+    OutputVertexNormalType n(0.);
+
+    OutputQEType *edge = output->FindEdge(id);
+    if ( edge != nullptr )
+      {
+      OutputQEType *temp = edge;
+      do
+        {
+        const OutputCellIdentifier cell_id = temp->GetLeft();
+        if ( cell_id != OutputMeshType::m_NoFace )
+          {
+          const SizeValueType t = m_TriangleIndices[cell_id];
+          int internal_id(0);
+          for ( int k = 0; k < 3; ++k )
+            {
+            if ( m_TriangleCorners[t][k] == id )
+              {
+              internal_id = k;
+              }
+            }
+          n += m_FaceNormals[t] * m_TriangleWeights[t][internal_id];
+          }
+        temp = temp->GetOnext();
+        }
+      while ( temp != edge );
+
+      n.Normalize();
+      }
+    m_VertexNormals[v] = n;
     }
 }
 
@@ -151,72 +277,20 @@ NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
       // this test should be removed...
       if ( poly->GetNumberOfPoints() == 3 )
         {
-        int              internal_id(0), k(0);
-        OutputPointType  pt[3];
-        OutputVectorType u, v;
+        TriangleIdentifiersType ids;
+        TriangleWeightsType     weights;
 
-        OutputQEType *edge = poly->GetEdgeRingEntry();
-        OutputQEType *temp = edge;
-        do
-          {
-          pt[k] = outputMesh->GetPoint( temp->GetOrigin() );
-          if ( temp->GetOrigin() == iPId )
-            {
-            internal_id = k;
-            }
+        this->ComputeTriangleWeights(poly, ids, weights);
 
-          temp = temp->GetLnext();
-          k++;
-          }
-        while ( temp != edge );
-
-        switch ( m_Weight )
+        int internal_id(0);
+        for ( int k = 0; k < 3; ++k )
           {
-          default:
-          case GOURAUD:
-            {
-            return static_cast< OutputVertexNormalComponentType >( 1. );
-            }
-          case THURMER:
-            {
-            // this implementation may be included inside itkTriangle
-            switch ( internal_id )
-              {
-              case 0:
-                u = pt[1] - pt[0];
-                v = pt[2] - pt[0];
-                break;
-              case 1:
-                u = pt[0] - pt[1];
-                v = pt[2] - pt[1];
-                break;
-              case 2:
-                u = pt[0] - pt[2];
-                v = pt[1] - pt[2];
-                break;
-              }
-            typename OutputVectorType::RealValueType norm_u = u.GetNorm();
-            if ( norm_u > itk::Math::eps )
-              {
-              norm_u = 1. / norm_u;
-              u *= norm_u;
-              }
-
-            typename OutputVectorType::RealValueType norm_v = v.GetNorm();
-            if ( norm_v > itk::Math::eps )
-              {
-              norm_v = 1. / norm_v;
-              v *= norm_v;
-              }
-            return static_cast< OutputVertexNormalComponentType >(
-                     std::acos(u * v) );
-            }
-          case AREA:
+          if ( ids[k] == iPId )
             {
-            return static_cast< OutputVertexNormalComponentType >(
-                     TriangleType::ComputeArea(pt[0], pt[1], pt[2]) );
+            internal_id = k;
             }
           }
+        return weights[internal_id];
         }
       else
         {
@@ -231,11 +305,92 @@ NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
     }
 }
 
+template< typename TInputMesh, typename TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeTriangleWeights(OutputPolygonType *iPoly,
+                         TriangleIdentifiersType & oIds,
+                         TriangleWeightsType & oWeights) const
+{
+  int             k(0);
+  OutputPointType pt[3];
+
+  OutputQEType *edge = iPoly->GetEdgeRingEntry();
+  OutputQEType *temp = edge;
+  do
+    {
+    oIds[k] = temp->GetOrigin();
+    pt[k] = this->m_OutputMesh->GetPoint( oIds[k] );
+    temp = temp->GetLnext();
+    k++;
+    }
+  while ( temp != edge );
+
+  switch ( m_Weight )
+    {
+    default:
+    case GOURAUD:
+      {
+      oWeights.Fill( static_cast< OutputVertexNormalComponentType >( 1. ) );
+      break;
+      }
+    case THURMER:
+      {
+      // this implementation may be included inside itkTriangle
+      for ( int internal_id = 0; internal_id < 3; ++internal_id )
+        {
+        OutputVectorType u, v;
+        switch ( internal_id )
+          {
+          case 0:
+            u = pt[1] - pt[0];
+            v = pt[2] - pt[0];
+            break;
+          case 1:
+            u = pt[0] - pt[1];
+            v = pt[2] - pt[1];
+            break;
+          case 2:
+            u = pt[0] - pt[2];
+            v = pt[1] - pt[2];
+            break;
+          }
+        typename OutputVectorType::RealValueType norm_u = u.GetNorm();
+        if ( norm_u > itk::Math::eps )
+          {
+          norm_u = 1. / norm_u;
+          u *= norm_u;
+          }
+
+        typename OutputVectorType::RealValueType norm_v = v.GetNorm();
+        if ( norm_v > itk::Math::eps )
+          {
+          norm_v = 1. / norm_v;
+          v *= norm_v;
+          }
+        oWeights[internal_id] = static_cast< OutputVertexNormalComponentType >(
+          std::acos(u * v) );
+        }
+      break;
+      }
+    case AREA:
+      {
+      oWeights.Fill( static_cast< OutputVertexNormalComponentType >(
+                       TriangleType::ComputeArea(pt[0], pt[1], pt[2]) ) );
+      break;
+      }
+    }
+}
+
 template< typename TInputMesh, typename TOutputMesh >
 void NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::GenerateData()
 {
   this->CopyInputMeshToOutputMesh();
+
+  this->m_OutputMesh = this->GetOutput();
+  this->m_Threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+
   this->ComputeAllFaceNormals();
   this->ComputeAllVertexNormals();
 }
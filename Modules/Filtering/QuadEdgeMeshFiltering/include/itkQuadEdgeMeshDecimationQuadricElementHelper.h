@@ -21,7 +21,8 @@
 #include "itkPoint.h"
 #include "vnl/vnl_vector_fixed.h"
 #include "vnl/vnl_matrix.h"
-#include "vnl/algo/vnl_matrix_inverse.h"
+#include "vnl/vnl_matrix_fixed.h"
+#include "vnl/algo/vnl_svd_fixed.h"
 
 #include "itkTriangleHelper.h"
 
@@ -38,10 +39,12 @@ public:
   using CoordType = typename PointType::CoordRepType;
 
   static constexpr unsigned int PointDimension = PointType::PointDimension;
-  static constexpr unsigned int NumberOfCoefficients = PointDimension * ( PointDimension + 1 / 2 + PointDimension + 1);
+  static constexpr unsigned int NumberOfCoefficients = ( PointDimension + 1 ) * ( PointDimension + 2 ) / 2;
 
   using VectorType = typename PointType::VectorType;
   using VNLMatrixType = vnl_matrix< CoordType >;
+  using VNLMatrixFixedType = vnl_matrix_fixed< CoordType,
+                            Self::PointDimension, Self::PointDimension >;
   using VNLVectorType = vnl_vector_fixed< CoordType,
                             Self::PointDimension >;
   using CoefficientVectorType = vnl_vector_fixed< CoordType,
@@ -51,7 +54,7 @@ public:
   // *****************************************************************
   QuadEdgeMeshDecimationQuadricElementHelper():
     m_Coefficients(itk::NumericTraits< CoordType >::ZeroValue()),
-    m_A(PointDimension, PointDimension, itk::NumericTraits< CoordType >::ZeroValue()),
+    m_A(itk::NumericTraits< CoordType >::ZeroValue()),
     m_B(itk::NumericTraits< CoordType >::ZeroValue()),
     m_SVDAbsoluteThreshold( static_cast< CoordType >( 1e-6 ) ),
     m_SVDRelativeThreshold( static_cast< CoordType >( 1e-3 ) )
@@ -61,7 +64,7 @@ public:
 
   QuadEdgeMeshDecimationQuadricElementHelper(const CoefficientVectorType & iCoefficients):
     m_Coefficients(iCoefficients),
-    m_A(PointDimension, PointDimension, itk::NumericTraits< CoordType >::ZeroValue()),
+    m_A(itk::NumericTraits< CoordType >::ZeroValue()),
     m_B(itk::NumericTraits< CoordType >::ZeroValue()),
     m_SVDAbsoluteThreshold( static_cast< CoordType >( 1e-3 ) ),
     m_SVDRelativeThreshold( static_cast< CoordType >( 1e-3 ) )
@@ -81,7 +84,7 @@ public:
   VNLMatrixType GetAMatrix()
   {
     this->ComputeAMatrixAndBVector();
-    return m_A;
+    return m_A.as_matrix();
   }
 
   VNLVectorType GetBVector()
@@ -95,43 +98,35 @@ public:
     return m_Rank;
   }
 
-  ///TODO this method should be really optimized!!!
+  /** Evaluate the quadric at iP, i.e. the weighted sum of the squared
+   * distances from iP to the planes accumulated in this element.  The
+   * quadric form is evaluated directly from the coefficients, in
+   * homogeneous coordinates. */
   inline CoordType ComputeError(const PointType & iP) const
   {
-    //     ComputeAMatrixAndBVector();
-    vnl_svd< CoordType > svd(m_A, m_SVDAbsoluteThreshold);
-    svd.zero_out_relative(m_SVDRelativeThreshold);
-    CoordType oError = inner_product( iP.GetVnlVector(), svd.recompose() * iP.GetVnlVector() );
-
-    return this->m_Coefficients[this->m_Coefficients.size() - 1] - oError;
-    /*
-    CoordType oError( 0. );
-
-    std::vector< CoordType > pt( PointDimension + 1, 1. );
+    CoordType pt[PointDimension + 1];
 
-    unsigned int dim1( 0 ), dim2, k( 0 );
-
-    while( dim1 < PointDimension )
+    for ( unsigned int dim = 0; dim < PointDimension; ++dim )
       {
-      pt[dim1] = iP[dim1];
-      ++dim1;
+      pt[dim] = iP[dim];
       }
+    pt[PointDimension] = static_cast< CoordType >( 1. );
 
-    for( dim1 = 0; dim1 < PointDimension + 1; ++dim1 )
+    CoordType    oError = NumericTraits< CoordType >::ZeroValue();
+    unsigned int k = 0;
+    for ( unsigned int dim1 = 0; dim1 < PointDimension + 1; ++dim1 )
       {
-      oError += this->m_Coefficients[k++] * pt[dim1] * pt[dim1];
-
-      for( dim2 = dim1 + 1; dim2 < PointDimension + 1; ++dim2 )
+      CoordType row = this->m_Coefficients[k++] * pt[dim1];
+      for ( unsigned int dim2 = dim1 + 1; dim2 < PointDimension + 1; ++dim2 )
         {
-        oError += 2. * this->m_Coefficients[k++] * pt[dim1] * pt[dim2];
+        row += static_cast< CoordType >( 2. ) * this->m_Coefficients[k++] * pt[dim2];
         }
+      oError += row * pt[dim1];
       }
-    oError += this->m_Coefficients[k++];
 
-    return oError;*/
+    return oError;
   }
 
-  ///TODO this method should be really optimized!!!
   inline CoordType ComputeErrorAtOptimalLocation(const PointType & iP)
   {
     PointType optimal_location = ComputeOptimalLocation(iP);
@@ -143,12 +138,12 @@ public:
   {
     ComputeAMatrixAndBVector();
 
-    vnl_svd< CoordType > svd(m_A, m_SVDAbsoluteThreshold);
+    vnl_svd_fixed< CoordType, PointDimension, PointDimension > svd(m_A, m_SVDAbsoluteThreshold);
     svd.zero_out_relative(m_SVDRelativeThreshold);
 
     m_Rank = svd.rank();
 
-    VNLVectorType y = m_B.as_vector() - m_A *iP.GetVnlVector();
+    VNLVectorType y = m_B - m_A * VNLVectorType( iP.GetDataPointer() );
 
     VNLVectorType displacement = svd.solve(y);
     PointType     oP;
@@ -245,7 +240,7 @@ public:
 protected:
 
   CoefficientVectorType m_Coefficients;
-  VNLMatrixType         m_A;
+  VNLMatrixFixedType    m_A;
   VNLVectorType         m_B;
   unsigned int          m_Rank;
   CoordType             m_SVDAbsoluteThreshold;
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkQuadEdgeMeshOneRingAdjacency_h
+#define itkQuadEdgeMeshOneRingAdjacency_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include <vector>
+#include <limits>
+
+namespace itk
+{
+/** \class QuadEdgeMeshOneRingAdjacency
+ * \brief Compact (CSR) copy of the one-ring connectivity of a QuadEdgeMesh.
+ *
+ * Vertices are numbered densely, in the iteration order of the points
+ * container. For vertex \c v the ring slots are
+ * [ GetRingBegin(v), GetRingEnd(v) ), in the Onext order of the edges
+ * leaving the point. Slot \c k stores the dense index of the destination of
+ * the k-th edge, and the dense indices of the third vertex of the faces on
+ * its left and on its right (NoVertex when there is no such face).
+ *
+ * Building the table walks the mesh once; the filters computing per-vertex
+ * quantities then read flat arrays instead of following quad-edges and
+ * looking points up in the containers, which also makes them safe to split
+ * over vertex ranges. The table only depends on the connectivity and on the
+ * point identifiers, so it can be passed from one filter to the next in a
+ * chain which does not modify the connectivity (curvature, normals,
+ * smoothing without Delaunay flips). IsCompatible() only compares the point
+ * identifiers and the number of edges and faces, which edge flips keep;
+ * sharing the table between meshes with different connectivity is the
+ * caller's responsibility. The filters only reuse a table set by the user,
+ * and rebuild the ones they own at every update.
+ *
+ * \sa DiscreteCurvatureQuadEdgeMeshFilter
+ * \sa NormalQuadEdgeMeshFilter
+ * \sa SmoothingQuadEdgeMeshFilter
+ * \ingroup ITKQuadEdgeMeshFiltering
+ */
+template< typename TMesh >
+class ITK_TEMPLATE_EXPORT QuadEdgeMeshOneRingAdjacency:public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(QuadEdgeMeshOneRingAdjacency);
+
+  using Self = QuadEdgeMeshOneRingAdjacency;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods).   */
+  itkTypeMacro(QuadEdgeMeshOneRingAdjacency, Object);
+
+  /** New macro for creation of through a Smart Pointer   */
+  itkNewMacro(Self);
+
+  using MeshType = TMesh;
+  using PointIdentifier = typename MeshType::PointIdentifier;
+  using CellIdentifier = typename MeshType::CellIdentifier;
+  using QEType = typename MeshType::QEType;
+
+  /** Dense vertex index, or ring slot index. */
+  using IndexType = SizeValueType;
+  using IndexContainerType = std::vector< IndexType >;
+  using PointIdentifierContainerType = std::vector< PointIdentifier >;
+
+  static constexpr IndexType NoVertex = std::numeric_limits< IndexType >::max();
+
+  /** Build the table from the current connectivity of iMesh. */
+  void Build(const MeshType *iMesh);
+
+  /** Whether the table describes iMesh, see the class documentation. */
+  bool IsCompatible(const MeshType *iMesh) const;
+
+  /** Return iAdjacency if it is not null and IsCompatible() with iMesh,
+   * otherwise a new table built from iMesh. iAdjacency may be shared with
+   * other filters, so it is never rebuilt in place. */
+  static Pointer Reuse(Self *iAdjacency, const MeshType *iMesh);
+
+  IndexType GetNumberOfVertices() const
+  {
+    return static_cast< IndexType >( m_PointIdentifiers.size() );
+  }
+
+  IndexType GetNumberOfSlots() const
+  {
+    return static_cast< IndexType >( m_Neighbors.size() );
+  }
+
+  PointIdentifier GetPointIdentifier(IndexType iVertex) const
+  {
+    return m_PointIdentifiers[iVertex];
+  }
+
+  /** Dense index of the point iId, NoVertex if it is not in the table. */
+  IndexType GetVertexIndex(PointIdentifier iId) const;
+
+  IndexType GetRingBegin(IndexType iVertex) const
+  {
+    return m_Offsets[iVertex];
+  }
+
+  IndexType GetRingEnd(IndexType iVertex) const
+  {
+    return m_Offsets[iVertex + 1];
+  }
+
+  IndexType GetValence(IndexType iVertex) const
+  {
+    return m_Offsets[iVertex + 1] - m_Offsets[iVertex];
+  }
+
+  IndexType GetNeighbor(IndexType iSlot) const
+  {
+    return m_Neighbors[iSlot];
+  }
+
+  IndexType GetLeftOpposite(IndexType iSlot) const
+  {
+    return m_LeftOpposites[iSlot];
+  }
+
+  IndexType GetRightOpposite(IndexType iSlot) const
+  {
+    return m_RightOpposites[iSlot];
+  }
+
+  const PointIdentifierContainerType & GetPointIdentifiers() const
+  {
+    return m_PointIdentifiers;
+  }
+
+protected:
+  QuadEdgeMeshOneRingAdjacency();
+  ~QuadEdgeMeshOneRingAdjacency() override {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  PointIdentifierContainerType m_PointIdentifiers;
+  IndexContainerType           m_Offsets;
+  IndexContainerType           m_Neighbors;
+  IndexContainerType           m_LeftOpposites;
+  IndexContainerType           m_RightOpposites;
+
+  /** Point identifiers are m_PointIdentifiers[0] + i, no search needed. */
+  bool m_ContiguousIdentifiers;
+
+  CellIdentifier m_NumberOfEdges;
+  CellIdentifier m_NumberOfFaces;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkQuadEdgeMeshOneRingAdjacency.hxx"
+#endif
+
+#endif
@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkQuadEdgeMeshOneRingAdjacency_hxx
+#define itkQuadEdgeMeshOneRingAdjacency_hxx
+
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TMesh >
+constexpr typename QuadEdgeMeshOneRingAdjacency< TMesh >::IndexType
+QuadEdgeMeshOneRingAdjacency< TMesh >::NoVertex;
+
+template< typename TMesh >
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::QuadEdgeMeshOneRingAdjacency() :
+  m_ContiguousIdentifiers(true),
+  m_NumberOfEdges(0),
+  m_NumberOfFaces(0)
+{
+  m_Offsets.push_back(0);
+}
+
+template< typename TMesh >
+void
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::Build(const MeshType *iMesh)
+{
+  using PointsContainer = typename MeshType::PointsContainer;
+  using PointsContainerConstIterator = typename PointsContainer::ConstIterator;
+
+  m_PointIdentifiers.clear();
+  m_Offsets.clear();
+  m_Neighbors.clear();
+  m_LeftOpposites.clear();
+  m_RightOpposites.clear();
+
+  m_NumberOfEdges = iMesh->GetNumberOfEdges();
+  m_NumberOfFaces = iMesh->GetNumberOfFaces();
+
+  const PointsContainer *points = iMesh->GetPoints();
+  const IndexType numberOfPoints = ( points != nullptr ) ? points->Size() : 0;
+
+  m_PointIdentifiers.reserve(numberOfPoints);
+  m_Offsets.reserve(numberOfPoints + 1);
+  // Every edge appears in the ring of both of its end points.
+  m_Neighbors.reserve(2 * m_NumberOfEdges);
+
+  std::vector< QEType * > firstEdges;
+  firstEdges.reserve(numberOfPoints);
+
+  m_Offsets.push_back(0);
+  IndexType numberOfSlots = 0;
+  if ( points != nullptr )
+    {
+    for ( PointsContainerConstIterator it = points->Begin(); it != points->End(); ++it )
+      {
+      QEType *qe = it.Value().GetEdge();
+      if ( qe != nullptr )
+        {
+        QEType *qe_it = qe;
+        do
+          {
+          ++numberOfSlots;
+          qe_it = qe_it->GetOnext();
+          }
+        while ( qe_it != qe );
+        }
+      m_PointIdentifiers.push_back( it.Index() );
+      m_Offsets.push_back(numberOfSlots);
+      firstEdges.push_back(qe);
+      }
+    }
+
+  m_ContiguousIdentifiers = m_PointIdentifiers.empty()
+    || ( m_PointIdentifiers.back() - m_PointIdentifiers.front() + 1 == m_PointIdentifiers.size() );
+
+  m_Neighbors.resize(numberOfSlots);
+  m_LeftOpposites.resize(numberOfSlots);
+  m_RightOpposites.resize(numberOfSlots);
+
+  for ( IndexType v = 0; v < numberOfPoints; ++v )
+    {
+    QEType *qe = firstEdges[v];
+    if ( qe == nullptr )
+      {
+      continue;
+      }
+    IndexType k = m_Offsets[v];
+    QEType *qe_it = qe;
+    do
+      {
+      m_Neighbors[k] = this->GetVertexIndex( qe_it->GetDestination() );
+      m_LeftOpposites[k] = qe_it->IsLeftSet() ?
+        this->GetVertexIndex( qe_it->GetLnext()->GetDestination() ) : NoVertex;
+      m_RightOpposites[k] = qe_it->IsRightSet() ?
+        this->GetVertexIndex( qe_it->GetRnext()->GetOrigin() ) : NoVertex;
+      ++k;
+      qe_it = qe_it->GetOnext();
+      }
+    while ( qe_it != qe );
+    }
+
+  this->Modified();
+}
+
+template< typename TMesh >
+bool
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::IsCompatible(const MeshType *iMesh) const
+{
+  if ( iMesh == nullptr
+       || iMesh->GetNumberOfEdges() != m_NumberOfEdges
+       || iMesh->GetNumberOfFaces() != m_NumberOfFaces )
+    {
+    return false;
+    }
+
+  const typename MeshType::PointsContainer *points = iMesh->GetPoints();
+  const IndexType numberOfPoints = ( points != nullptr ) ? points->Size() : 0;
+  if ( numberOfPoints != this->GetNumberOfVertices() )
+    {
+    return false;
+    }
+  if ( numberOfPoints == 0 )
+    {
+    return true;
+    }
+
+  // The containers are sorted by identifier: comparing both ends is enough
+  // when the identifiers are contiguous, otherwise compare them all.
+  if ( m_ContiguousIdentifiers )
+    {
+    return points->Begin().Index() == m_PointIdentifiers.front()
+           && ( --points->End() ).Index() == m_PointIdentifiers.back();
+    }
+
+  IndexType v = 0;
+  for ( typename MeshType::PointsContainer::ConstIterator it = points->Begin();
+        it != points->End(); ++it, ++v )
+    {
+    if ( it.Index() != m_PointIdentifiers[v] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TMesh >
+typename QuadEdgeMeshOneRingAdjacency< TMesh >::Pointer
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::Reuse(Self *iAdjacency, const MeshType *iMesh)
+{
+  if ( iAdjacency != nullptr && iAdjacency->IsCompatible(iMesh) )
+    {
+    return iAdjacency;
+    }
+  Pointer adjacency = Self::New();
+  adjacency->Build(iMesh);
+  return adjacency;
+}
+
+template< typename TMesh >
+typename QuadEdgeMeshOneRingAdjacency< TMesh >::IndexType
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::GetVertexIndex(PointIdentifier iId) const
+{
+  if ( m_PointIdentifiers.empty() )
+    {
+    return NoVertex;
+    }
+  if ( m_ContiguousIdentifiers )
+    {
+    if ( iId < m_PointIdentifiers.front() || iId > m_PointIdentifiers.back() )
+      {
+      return NoVertex;
+      }
+    return static_cast< IndexType >( iId - m_PointIdentifiers.front() );
+    }
+
+  typename PointIdentifierContainerType::const_iterator it =
+    std::lower_bound( m_PointIdentifiers.begin(), m_PointIdentifiers.end(), iId );
+  if ( it == m_PointIdentifiers.end() || *it != iId )
+    {
+    return NoVertex;
+    }
+  return static_cast< IndexType >( it - m_PointIdentifiers.begin() );
+}
+
+template< typename TMesh >
+void
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfVertices: " << this->GetNumberOfVertices() << std::endl;
+  os << indent << "NumberOfSlots: " << this->GetNumberOfSlots() << std::endl;
+  os << indent << "ContiguousIdentifiers: " << m_ContiguousIdentifiers << std::endl;
+  os << indent << "NumberOfEdges: " << m_NumberOfEdges << std::endl;
+  os << indent << "NumberOfFaces: " << m_NumberOfFaces << std::endl;
+}
+} // end namespace itk
+
+#endif
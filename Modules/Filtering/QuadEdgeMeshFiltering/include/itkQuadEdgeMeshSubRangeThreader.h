@@ -0,0 +1,83 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkQuadEdgeMeshSubRangeThreader_h
+#define itkQuadEdgeMeshSubRangeThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+/** \class QuadEdgeMeshSubRangeThreader
+ * \brief Run a method of a QuadEdgeMesh filter over index sub-ranges.
+ *
+ * The domain is a range of dense vertex (or face) indices, split by a
+ * ThreadedIndexedContainerPartitioner. Each thread calls the method set with
+ * SetSubRangeMethod() on the associate with its own sub-range, so a filter
+ * can thread several independent passes with a single threader type.
+ *
+ * \sa QuadEdgeMeshOneRingAdjacency
+ * \ingroup ITKQuadEdgeMeshFiltering
+ */
+template< typename TAssociate >
+class ITK_TEMPLATE_EXPORT QuadEdgeMeshSubRangeThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(QuadEdgeMeshSubRangeThreader);
+
+  /** Standard class type aliases. */
+  using Self = QuadEdgeMeshSubRangeThreader;
+  using Superclass = DomainThreader< ThreadedIndexedContainerPartitioner, TAssociate >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  itkTypeMacro( QuadEdgeMeshSubRangeThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  using DomainType = typename Superclass::DomainType;
+  using AssociateType = typename Superclass::AssociateType;
+  using IndexRangeType = DomainType;
+
+  /** Method of the associate processing the inclusive range
+   * [ subrange[0], subrange[1] ]. It is called concurrently from several
+   * threads on disjoint sub-ranges. */
+  using SubRangeMethodType = void ( AssociateType::* )( const IndexRangeType & );
+
+  void SetSubRangeMethod( SubRangeMethodType iMethod )
+  {
+    this->m_SubRangeMethod = iMethod;
+  }
+
+protected:
+  QuadEdgeMeshSubRangeThreader() : m_SubRangeMethod( nullptr ) {}
+  ~QuadEdgeMeshSubRangeThreader() override {}
+
+  void ThreadedExecution( const IndexRangeType & subrange,
+                          const ThreadIdType itkNotUsed(threadId) ) override
+  {
+    ( this->m_Associate->*m_SubRangeMethod )( subrange );
+  }
+
+private:
+  SubRangeMethodType m_SubRangeMethod;
+};
+} // end namespace itk
+
+#endif
@@ -84,6 +84,9 @@ public:
 
   using QuadricElementMapIterator = typename QuadricElementMapType::iterator;
 
+  /** Quadrics indexed by point identifier */
+  using QuadricElementContainerType = std::vector< QuadricElementType >;
+
 protected:
   /** \brief Constructor */
   QuadricDecimationQuadEdgeMeshFilter();
@@ -124,6 +127,7 @@ protected:
     OutputPointIdentifier id_dest = iEdge->GetDestination();
     QuadricElementType    Q = m_Quadric[id_org] + m_Quadric[id_dest];
 
+    // read only, as this is called concurrently in parallel decimation
     OutputPointType org = this->m_OutputMesh->GetPoint(id_org);
     OutputPointType dest = this->m_OutputMesh->GetPoint(id_dest);
 
@@ -152,7 +156,19 @@ protected:
   void Initialize() override;
 
 private:
-  QuadricElementMapType m_Quadric;
+  struct InitializeThreadStruct
+  {
+    Self *                                     Filter;
+    const std::vector< OutputPointIdentifier > *PointIds;
+  };
+
+  static ITK_THREAD_RETURN_TYPE InitializeThreaderCallback(void *arg);
+
+  /** Accumulate the quadrics of the faces around iPointIds[iBegin, iEnd) */
+  void InitializePoints(const std::vector< OutputPointIdentifier > & iPointIds,
+                        SizeValueType iBegin, SizeValueType iEnd);
+
+  QuadricElementContainerType m_Quadric;
 };
 }
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -41,19 +41,70 @@ QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
   OutputMeshPointer             output = this->GetOutput();
   OutputPointsContainerPointer  points = output->GetPoints();
   OutputPointsContainerIterator it = points->Begin();
-  OutputPointIdentifier         p_id;
-  OutputQEType *                qe;
-  OutputQEType *                qe_it;
 
-  OutputMeshType *outputMesh = this->GetOutput();
+  std::vector< OutputPointIdentifier > pointIds;
+  pointIds.reserve( points->Size() );
+
+  OutputPointIdentifier maxPointId = 0;
   while ( it != points->End() )
     {
-    p_id = it->Index();
+    pointIds.push_back( it->Index() );
+    maxPointId = std::max( maxPointId, it->Index() );
+    ++it;
+    }
+
+  m_Quadric.assign( pointIds.empty() ? 0 : maxPointId + 1, QuadricElementType() );
+  this->m_OutputMesh = output;
+
+  // Each point only writes its own quadric.
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsForItems( pointIds.size() );
+  if ( numberOfThreads == 1 )
+    {
+    this->InitializePoints(pointIds, 0, pointIds.size());
+    return;
+    }
+
+  InitializeThreadStruct str;
+  str.Filter = this;
+  str.PointIds = &pointIds;
+
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->InitializeThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+ITK_THREAD_RETURN_TYPE
+QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
+::InitializeThreaderCallback(void *arg)
+{
+  const MultiThreaderBase::ThreadInfoStruct *info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  InitializeThreadStruct *str = static_cast< InitializeThreadStruct * >( info->UserData );
+
+  const SizeValueType n = str->PointIds->size();
+  str->Filter->InitializePoints( *str->PointIds,
+                                 n * info->ThreadID / info->NumberOfThreads,
+                                 n * ( info->ThreadID + 1 ) / info->NumberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
+::InitializePoints(const std::vector< OutputPointIdentifier > & iPointIds,
+                   SizeValueType iBegin, SizeValueType iEnd)
+{
+  OutputMeshType *outputMesh = this->m_OutputMesh;
+
+  for ( SizeValueType i = iBegin; i < iEnd; ++i )
+    {
+    const OutputPointIdentifier p_id = iPointIds[i];
 
-    qe = output->FindEdge(p_id);
+    OutputQEType *qe = outputMesh->FindEdge(p_id);
     if ( qe != nullptr )
       {
-      qe_it = qe;
+      OutputQEType *qe_it = qe;
       do
         {
         QuadricAtOrigin(qe_it, m_Quadric[p_id], outputMesh);
@@ -61,7 +112,6 @@ QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
         }
       while ( qe_it != qe );
       }
-    ++it;
     }
 }
 
@@ -73,9 +123,7 @@ QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
 {
   Superclass::DeletePoint(iIdToBeDeleted, iRemaining);
 
-  auto it = m_Quadric.find(iIdToBeDeleted);
-  m_Quadric[iRemaining] += it->second;
-  m_Quadric.erase(it);
+  m_Quadric[iRemaining] += m_Quadric[iIdToBeDeleted];
 }
 
 template< typename TInput, typename TOutput, typename TCriterion >
@@ -89,10 +137,8 @@ QuadricDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >
   OutputPointIdentifier id_dest = iEdge->GetDestination();
   QuadricElementType    Q = m_Quadric[id_org] + m_Quadric[id_dest];
 
-  OutputMeshPointer output = this->GetOutput();
-
-  OutputPointType org = output->GetPoint(id_org);
-  OutputPointType dest = output->GetPoint(id_dest);
+  OutputPointType org = this->m_OutputMesh->GetPoint(id_org);
+  OutputPointType dest = this->m_OutputMesh->GetPoint(id_dest);
 
   OutputPointType mid;
 
@@ -20,6 +20,9 @@
 
 #include "itkDelaunayConformingQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshParamMatrixCoefficients.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
+#include "itkQuadEdgeMeshSubRangeThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -50,6 +53,13 @@ namespace itk
  * DelaunayConformingQuadEdgeMeshFilter, then run this filter and apply this
  * process M times.
  *
+ * All the vertices of one iteration are moved from the positions of the
+ * previous iteration, in parallel over dense vertex ranges. The point
+ * identifiers are mapped to dense indices by a QuadEdgeMeshOneRingAdjacency,
+ * which can be shared with the other filters of a chain through
+ * SetOneRingAdjacency(). The coefficients functor is called concurrently and
+ * must not modify its state.
+ *
  *
  * \ingroup ITKQuadEdgeMeshFiltering
  */
@@ -105,6 +115,24 @@ public:
   itkSetMacro(RelaxationFactor, OutputCoordType);
   itkGetConstMacro(RelaxationFactor, OutputCoordType);
 
+  using OneRingAdjacencyType = QuadEdgeMeshOneRingAdjacency< OutputMeshType >;
+  using OneRingAdjacencyPointer = typename OneRingAdjacencyType::Pointer;
+
+  /** Set/Get the one-ring connectivity of the mesh. A table set here is
+   * used as long as it IsCompatible() with the mesh being smoothed and no
+   * edge has been flipped. Otherwise, and when none was set, a new table is
+   * built at every update and after every iteration that flipped edges. */
+  virtual void SetOneRingAdjacency(OneRingAdjacencyType *iAdjacency)
+  {
+    if ( m_OneRingAdjacency != iAdjacency )
+      {
+      m_OneRingAdjacency = iAdjacency;
+      this->Modified();
+      }
+    m_OneRingAdjacencyIsUserSet = ( iAdjacency != nullptr );
+  }
+  itkGetModifiableObjectMacro(OneRingAdjacency, OneRingAdjacencyType);
+
 protected:
   SmoothingQuadEdgeMeshFilter();
   ~SmoothingQuadEdgeMeshFilter() override;
@@ -128,11 +156,28 @@ protected:
 
   OutputCoordType m_RelaxationFactor;
 
+  OneRingAdjacencyPointer m_OneRingAdjacency;
+  bool                    m_OneRingAdjacencyIsUserSet;
+
   void GenerateData() override;
 
+  using IndexRangeType = ThreadedIndexedContainerPartitioner::IndexRangeType;
+
+  /** Compute the positions of one iteration for the vertices of iRange. */
+  void SmoothOverSubRange(const IndexRangeType & iRange);
+
 private:
   SmoothingQuadEdgeMeshFilter(const Self &);
   void operator=(const Self &);
+
+  using ThreaderType = QuadEdgeMeshSubRangeThreader< Self >;
+  typename ThreaderType::Pointer m_Threader;
+
+  /** Mesh being smoothed, and its points before and after the current
+   * iteration in the dense order of m_OneRingAdjacency. */
+  OutputMeshType                *m_Mesh;
+  std::vector< OutputPointType > m_Points;
+  std::vector< OutputPointType > m_NewPoints;
 };
 }
 
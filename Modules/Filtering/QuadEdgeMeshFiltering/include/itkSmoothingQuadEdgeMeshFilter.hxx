@@ -31,9 +31,14 @@ SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
   this->m_DelaunayConforming = false;
   this->m_NumberOfIterations = 1;
   this->m_RelaxationFactor = static_cast< OutputCoordType >( 1.0 );
+  this->m_OneRingAdjacencyIsUserSet = false;
 
   this->m_InputDelaunayFilter = InputOutputDelaunayConformingType::New();
   this->m_OutputDelaunayFilter = OutputDelaunayConformingType::New();
+
+  this->m_Threader = ThreaderType::New();
+  this->m_Threader->SetSubRangeMethod(&Self::SmoothOverSubRange);
+  this->m_Mesh = nullptr;
 }
 
 template< typename TInputMesh, typename TOutputMesh >
@@ -58,24 +63,9 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
 
   OutputMeshPointer mesh = OutputMeshType::New();
 
-  OutputPointsContainerPointer temp = OutputPointsContainer::New();
-  temp->Reserve( numberOfPoints );
-
   OutputPointsContainerPointer  points;
   OutputPointsContainerIterator it;
 
-  OutputPointType  p;
-  OutputPointType  q;
-  OutputPointType  r;
-  OutputVectorType v;
-
-  OutputCoordType coeff;
-  OutputCoordType sum_coeff;
-  OutputCoordType den;
-
-  OutputQEType *qe;
-  OutputQEType *qe_it;
-
   if ( this->m_DelaunayConforming )
     {
     m_InputDelaunayFilter->SetInput( this->GetInput() );
@@ -103,48 +93,55 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
       }
     }
 
+  this->m_Threader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+
+  // Edge flips keep the numbers of points, edges and faces, so
+  // IsCompatible() cannot detect them: the adjacency is rebuilt after each
+  // Delaunay pass which flipped edges.
+  if ( m_NumberOfIterations > 0 )
+    {
+    const bool inputEdgesFlipped =
+      this->m_DelaunayConforming && m_InputDelaunayFilter->GetNumberOfEdgeFlips() > 0;
+    OneRingAdjacencyType *userAdjacency =
+      ( m_OneRingAdjacencyIsUserSet && !inputEdgesFlipped ) ? m_OneRingAdjacency.GetPointer() : nullptr;
+    m_OneRingAdjacency = OneRingAdjacencyType::Reuse(userAdjacency, mesh);
+    m_OneRingAdjacencyIsUserSet = ( m_OneRingAdjacency == userAdjacency );
+    }
+
   for ( unsigned int iter = 0; iter < m_NumberOfIterations; ++iter )
     {
     points = mesh->GetPoints();
 
-    for ( it = points->Begin(); it != points->End(); ++it )
+    const SizeValueType numberOfVertices = m_OneRingAdjacency->GetNumberOfVertices();
+    m_Points.resize(numberOfVertices);
+    m_NewPoints.resize(numberOfVertices);
+
+    SizeValueType i = 0;
+    for ( it = points->Begin(); it != points->End(); ++it, ++i )
       {
-      p = it.Value();
-      qe = p.GetEdge();
-      if ( qe != nullptr )
-        {
-        r = p;
-        v.Fill(0.0);
-        qe_it = qe;
-        sum_coeff = 0.;
-        do
-          {
-          q = mesh->GetPoint( qe_it->GetDestination() );
-
-          coeff = ( *m_CoefficientsMethod )( mesh, qe_it );
-          sum_coeff += coeff;
-
-          v += coeff * ( q - p );
-          qe_it = qe_it->GetOnext();
-          }
-        while ( qe_it != qe );
-
-        den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
-        v *= den;
-
-        r += m_RelaxationFactor * v;
-        r.SetEdge(qe);
-        temp->SetElement(it.Index(), r);
-        }
-      else
-        {
-        temp->SetElement(it.Index(), p);
-        }
+      m_Points[i] = it.Value();
+      }
 
-      progress.CompletedPixel();
+    if ( numberOfVertices > 0 )
+      {
+      m_Mesh = mesh.GetPointer();
+      IndexRangeType range;
+      range[0] = 0;
+      range[1] = numberOfVertices - 1;
+      this->m_Threader->Execute(this, range);
+      m_Mesh = nullptr;
       }
 
-    mesh->SetPoints(temp);
+    // All the new positions are computed from the previous ones: update the
+    // container in place.
+    i = 0;
+    for ( it = points->Begin(); it != points->End(); ++it, ++i )
+      {
+      it.Value() = m_NewPoints[i];
+      progress.CompletedPixel();
+      }
+    points->Modified();
+    mesh->Modified();
 
     if ( this->m_DelaunayConforming )
       {
@@ -170,6 +167,67 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
       {
       this->GraftOutput(mesh);
       }
+
+    if ( this->m_DelaunayConforming && m_OutputDelaunayFilter->GetNumberOfEdgeFlips() > 0 )
+      {
+      m_OneRingAdjacency = OneRingAdjacencyType::New();
+      m_OneRingAdjacency->Build( iter + 1 == m_NumberOfIterations ? this->GetOutput() : mesh.GetPointer() );
+      m_OneRingAdjacencyIsUserSet = false;
+      }
+    }
+}
+
+template< typename TInputMesh, typename TOutputMesh >
+void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::SmoothOverSubRange(const IndexRangeType & iRange)
+{
+  const OutputMeshType       *mesh = this->m_Mesh;
+  const OneRingAdjacencyType *adjacency = this->m_OneRingAdjacency.GetPointer();
+
+  OutputPointType  q;
+  OutputPointType  r;
+  OutputVectorType v;
+
+  OutputCoordType coeff;
+  OutputCoordType sum_coeff;
+  OutputCoordType den;
+
+  OutputQEType *qe;
+  OutputQEType *qe_it;
+
+  for ( IndexValueType i = iRange[0]; i <= iRange[1]; ++i )
+    {
+    const OutputPointType & p = m_Points[i];
+    qe = p.GetEdge();
+    if ( qe != nullptr )
+      {
+      r = p;
+      v.Fill(0.0);
+      qe_it = qe;
+      sum_coeff = 0.;
+      do
+        {
+        q = m_Points[adjacency->GetVertexIndex( qe_it->GetDestination() )];
+
+        coeff = ( *m_CoefficientsMethod )( mesh, qe_it );
+        sum_coeff += coeff;
+
+        v += coeff * ( q - p );
+        qe_it = qe_it->GetOnext();
+        }
+      while ( qe_it != qe );
+
+      den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
+      v *= den;
+
+      r += m_RelaxationFactor * v;
+      r.SetEdge(qe);
+      m_NewPoints[i] = r;
+      }
+    else
+      {
+      m_NewPoints[i] = p;
+      }
     }
 }
 
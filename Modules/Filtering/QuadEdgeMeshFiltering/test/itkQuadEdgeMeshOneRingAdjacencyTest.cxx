@@ -0,0 +1,333 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkQuadEdgeMesh.h"
+#include "itkQuadEdgeMeshExtendedTraits.h"
+#include "itkRegularSphereMeshSource.h"
+#include "itkDiscreteMeanCurvatureQuadEdgeMeshFilter.h"
+#include "itkNormalQuadEdgeMeshFilter.h"
+#include "itkSmoothingQuadEdgeMeshFilter.h"
+#include "itkQuadEdgeMeshEulerOperatorFlipEdgeFunction.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TMesh >
+bool CheckOneRingAdjacency( const TMesh *mesh,
+                            const itk::QuadEdgeMeshOneRingAdjacency< TMesh > *adjacency )
+{
+  using AdjacencyType = itk::QuadEdgeMeshOneRingAdjacency< TMesh >;
+  using IndexType = typename AdjacencyType::IndexType;
+
+  if ( adjacency->GetNumberOfVertices() != mesh->GetNumberOfPoints()
+       || adjacency->GetNumberOfSlots() != 2 * mesh->GetNumberOfEdges() )
+    {
+    std::cerr << "Wrong number of vertices or slots" << std::endl;
+    return false;
+    }
+
+  for ( IndexType v = 0; v < adjacency->GetNumberOfVertices(); ++v )
+    {
+    const typename TMesh::PointIdentifier id = adjacency->GetPointIdentifier(v);
+    if ( adjacency->GetVertexIndex(id) != v )
+      {
+      std::cerr << "Point " << id << " is not at index " << v << std::endl;
+      return false;
+      }
+    if ( adjacency->GetValence(v) != static_cast< IndexType >( mesh->GetPoint(id).GetValence() ) )
+      {
+      std::cerr << "Wrong valence at point " << id << std::endl;
+      return false;
+      }
+    for ( IndexType k = adjacency->GetRingBegin(v); k < adjacency->GetRingEnd(v); ++k )
+      {
+      const IndexType w = adjacency->GetNeighbor(k);
+      if ( mesh->FindEdge( id, adjacency->GetPointIdentifier(w) ) == nullptr )
+        {
+        std::cerr << "No edge between " << v << " and " << w << std::endl;
+        return false;
+        }
+      // closed triangulated surface: both faces exist, and their third
+      // vertices are neighbors of v as well
+      const IndexType a = adjacency->GetLeftOpposite(k);
+      const IndexType b = adjacency->GetRightOpposite(k);
+      if ( a == AdjacencyType::NoVertex || b == AdjacencyType::NoVertex )
+        {
+        std::cerr << "Missing face along slot " << k << std::endl;
+        return false;
+        }
+      if ( mesh->FindEdge( id, adjacency->GetPointIdentifier(a) ) == nullptr
+           || mesh->FindEdge( id, adjacency->GetPointIdentifier(b) ) == nullptr )
+        {
+        std::cerr << "Opposite vertices of slot " << k << " are not neighbors" << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+template< typename TContainer >
+bool SameElements( const TContainer *a, const TContainer *b )
+{
+  if ( a->Size() != b->Size() )
+    {
+    return false;
+    }
+  typename TContainer::ConstIterator bIt = b->Begin();
+  for ( typename TContainer::ConstIterator aIt = a->Begin(); aIt != a->End(); ++aIt, ++bIt )
+    {
+    if ( aIt.Index() != bIt.Index() || aIt.Value() != bIt.Value() )
+      {
+      std::cerr << "Element " << aIt.Index() << " differs: "
+                << aIt.Value() << " != " << bIt.Value() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TContainer >
+bool ClosePoints( const TContainer *a, const TContainer *b, double tolerance )
+{
+  if ( a->Size() != b->Size() )
+    {
+    return false;
+    }
+  typename TContainer::ConstIterator bIt = b->Begin();
+  for ( typename TContainer::ConstIterator aIt = a->Begin(); aIt != a->End(); ++aIt, ++bIt )
+    {
+    if ( aIt.Index() != bIt.Index() || aIt.Value().EuclideanDistanceTo( bIt.Value() ) > tolerance )
+      {
+      std::cerr << "Point " << aIt.Index() << " differs: "
+                << aIt.Value() << " != " << bIt.Value() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkQuadEdgeMeshOneRingAdjacencyTest( int, char* [] )
+{
+  using CoordType = double;
+  constexpr unsigned int Dimension = 3;
+
+  using MeshType = itk::QuadEdgeMesh< CoordType, Dimension >;
+  using SphereSourceType = itk::RegularSphereMeshSource< MeshType >;
+  using AdjacencyType = itk::QuadEdgeMeshOneRingAdjacency< MeshType >;
+
+  SphereSourceType::Pointer source = SphereSourceType::New();
+  source->SetResolution( 4 );
+  source->Update();
+
+  MeshType::Pointer mesh = source->GetOutput();
+  mesh->DisconnectPipeline();
+
+  for ( MeshType::PointsContainer::Iterator it = mesh->GetPoints()->Begin();
+        it != mesh->GetPoints()->End(); ++it )
+    {
+    MeshType::PointType & p = it.Value();
+    p[0] *= 1.0 + 0.3 * std::sin( 5.0 * p[1] );
+    }
+
+  // Adjacency table
+  AdjacencyType::Pointer adjacency = AdjacencyType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( adjacency, QuadEdgeMeshOneRingAdjacency, Object );
+
+  adjacency->Build( mesh );
+  TEST_EXPECT_TRUE( CheckOneRingAdjacency< MeshType >( mesh, adjacency ) );
+  TEST_EXPECT_TRUE( adjacency->IsCompatible( mesh ) );
+  TEST_EXPECT_EQUAL( adjacency->GetVertexIndex( mesh->GetNumberOfPoints() + 10 ), AdjacencyType::NoVertex );
+
+  SphereSourceType::Pointer coarseSource = SphereSourceType::New();
+  coarseSource->SetResolution( 3 );
+  coarseSource->Update();
+  TEST_EXPECT_TRUE( !adjacency->IsCompatible( coarseSource->GetOutput() ) );
+
+  // Curvature: one thread and several threads, the second one reusing the
+  // adjacency of the first
+  using CurvatureFilterType = itk::DiscreteMeanCurvatureQuadEdgeMeshFilter< MeshType, MeshType >;
+
+  CurvatureFilterType::Pointer curvature1 = CurvatureFilterType::New();
+  curvature1->SetInput( mesh );
+  curvature1->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( curvature1->Update() );
+
+  AdjacencyType::Pointer chainAdjacency = curvature1->GetOneRingAdjacency();
+  TEST_EXPECT_TRUE( chainAdjacency.IsNotNull() );
+  TEST_EXPECT_TRUE( CheckOneRingAdjacency< MeshType >( curvature1->GetOutput(), chainAdjacency ) );
+  const itk::ModifiedTimeType buildTime = chainAdjacency->GetMTime();
+
+  CurvatureFilterType::Pointer curvature4 = CurvatureFilterType::New();
+  curvature4->SetInput( mesh );
+  curvature4->SetNumberOfThreads( 4 );
+  curvature4->SetOneRingAdjacency( chainAdjacency );
+  TRY_EXPECT_NO_EXCEPTION( curvature4->Update() );
+
+  TEST_EXPECT_EQUAL( curvature4->GetOneRingAdjacency(), chainAdjacency.GetPointer() );
+  TEST_EXPECT_EQUAL( chainAdjacency->GetMTime(), buildTime );
+  TEST_EXPECT_TRUE( SameElements( curvature1->GetOutput()->GetPointData(),
+                                  curvature4->GetOutput()->GetPointData() ) );
+
+  // Smoothing of the curvature output, with the same adjacency
+  using SmoothingFilterType = itk::SmoothingQuadEdgeMeshFilter< MeshType, MeshType >;
+  itk::ConformalMatrixCoefficients< MeshType > coefficients;
+
+  SmoothingFilterType::Pointer smoothing1 = SmoothingFilterType::New();
+  smoothing1->SetInput( curvature1->GetOutput() );
+  smoothing1->SetCoefficientsMethod( &coefficients );
+  smoothing1->SetNumberOfIterations( 3 );
+  smoothing1->SetRelaxationFactor( 0.5 );
+  smoothing1->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( smoothing1->Update() );
+
+  SmoothingFilterType::Pointer smoothing4 = SmoothingFilterType::New();
+  smoothing4->SetInput( curvature4->GetOutput() );
+  smoothing4->SetCoefficientsMethod( &coefficients );
+  smoothing4->SetNumberOfIterations( 3 );
+  smoothing4->SetRelaxationFactor( 0.5 );
+  smoothing4->SetNumberOfThreads( 4 );
+  smoothing4->SetOneRingAdjacency( chainAdjacency );
+  TRY_EXPECT_NO_EXCEPTION( smoothing4->Update() );
+
+  TEST_EXPECT_EQUAL( chainAdjacency->GetMTime(), buildTime );
+  TEST_EXPECT_TRUE( SameElements( smoothing1->GetOutput()->GetPoints(),
+                                  smoothing4->GetOutput()->GetPoints() ) );
+
+  // Normals
+  using VectorType = itk::Vector< CoordType, Dimension >;
+  using NormalTraits = itk::QuadEdgeMeshExtendedTraits< VectorType, Dimension, 2, CoordType, CoordType,
+                                                         VectorType, bool, bool >;
+  using NormalMeshType = itk::QuadEdgeMesh< VectorType, Dimension, NormalTraits >;
+  using NormalFilterType = itk::NormalQuadEdgeMeshFilter< MeshType, NormalMeshType >;
+
+  NormalFilterType::Pointer normals1 = NormalFilterType::New();
+  normals1->SetInput( mesh );
+  normals1->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( normals1->Update() );
+
+  NormalFilterType::Pointer normals4 = NormalFilterType::New();
+  normals4->SetInput( mesh );
+  normals4->SetNumberOfThreads( 4 );
+  normals4->SetOneRingAdjacency( normals1->GetOneRingAdjacency() );
+  TRY_EXPECT_NO_EXCEPTION( normals4->Update() );
+
+  TEST_EXPECT_TRUE( SameElements( normals1->GetOutput()->GetPointData(),
+                                  normals4->GetOutput()->GetPointData() ) );
+  TEST_EXPECT_TRUE( SameElements( normals1->GetOutput()->GetCellData(),
+                                  normals4->GetOutput()->GetCellData() ) );
+
+  // the normals of a sphere-like surface point outward
+  const NormalMeshType *normalMesh = normals4->GetOutput();
+  for ( NormalMeshType::PointsContainer::ConstIterator it = normalMesh->GetPoints()->Begin();
+        it != normalMesh->GetPoints()->End(); ++it )
+    {
+    VectorType n;
+    normalMesh->GetPointData( it.Index(), &n );
+    if ( n * it.Value().GetVectorFromOrigin() <= 0. )
+      {
+      std::cerr << "Normal " << n << " at point " << it.Value() << " points inward" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Flipping an edge keeps the numbers of points, edges and faces, so a
+  // re-updated filter must not reuse the adjacency it built before.
+  MeshType::Pointer flipped = MeshType::New();
+  itk::CopyMeshToMesh< MeshType, MeshType >( mesh, flipped );
+
+  CurvatureFilterType::Pointer flippedCurvature = CurvatureFilterType::New();
+  flippedCurvature->SetInput( flipped );
+  TRY_EXPECT_NO_EXCEPTION( flippedCurvature->Update() );
+  NormalFilterType::Pointer flippedNormals = NormalFilterType::New();
+  flippedNormals->SetInput( flipped );
+  TRY_EXPECT_NO_EXCEPTION( flippedNormals->Update() );
+  const AdjacencyType *firstAdjacency = flippedCurvature->GetOneRingAdjacency();
+
+  using FlipEdgeType = itk::QuadEdgeMeshEulerOperatorFlipEdgeFunction< MeshType, MeshType::QEType >;
+  FlipEdgeType::Pointer flip = FlipEdgeType::New();
+  flip->SetInput( flipped );
+  TEST_EXPECT_TRUE( flip->Evaluate( flipped->GetEdge() ) != nullptr );
+  flipped->Modified();
+
+  TRY_EXPECT_NO_EXCEPTION( flippedCurvature->Update() );
+  TRY_EXPECT_NO_EXCEPTION( flippedNormals->Update() );
+  TEST_EXPECT_TRUE( flippedCurvature->GetOneRingAdjacency() != firstAdjacency );
+  TEST_EXPECT_TRUE( CheckOneRingAdjacency< MeshType >( flippedCurvature->GetOutput(),
+                                                       flippedCurvature->GetOneRingAdjacency() ) );
+
+  CurvatureFilterType::Pointer referenceCurvature = CurvatureFilterType::New();
+  referenceCurvature->SetInput( flipped );
+  TRY_EXPECT_NO_EXCEPTION( referenceCurvature->Update() );
+  TEST_EXPECT_TRUE( SameElements( flippedCurvature->GetOutput()->GetPointData(),
+                                  referenceCurvature->GetOutput()->GetPointData() ) );
+
+  NormalFilterType::Pointer referenceNormals = NormalFilterType::New();
+  referenceNormals->SetInput( flipped );
+  TRY_EXPECT_NO_EXCEPTION( referenceNormals->Update() );
+  TEST_EXPECT_TRUE( SameElements( flippedNormals->GetOutput()->GetPointData(),
+                                  referenceNormals->GetOutput()->GetPointData() ) );
+
+  // Smoothing of a noisy mesh with Delaunay flips between the iterations:
+  // each iteration must use the connectivity left by the previous flips, as
+  // a chain of single iteration filters does, and the adjacency of the
+  // filter must describe its output.
+  MeshType::Pointer noisy = MeshType::New();
+  itk::CopyMeshToMesh< MeshType, MeshType >( mesh, noisy );
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+  for ( MeshType::PointsContainer::Iterator it = noisy->GetPoints()->Begin();
+        it != noisy->GetPoints()->End(); ++it )
+    {
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      it.Value()[d] += generator->GetNormalVariate( 0.0, 0.0025 );
+      }
+    }
+
+  SmoothingFilterType::Pointer delaunaySmoothing = SmoothingFilterType::New();
+  delaunaySmoothing->SetInput( noisy );
+  delaunaySmoothing->SetCoefficientsMethod( &coefficients );
+  delaunaySmoothing->SetNumberOfIterations( 3 );
+  delaunaySmoothing->SetRelaxationFactor( 0.5 );
+  delaunaySmoothing->SetDelaunayConforming( true );
+  TRY_EXPECT_NO_EXCEPTION( delaunaySmoothing->Update() );
+
+  SmoothingFilterType::Pointer chainSmoothing[3];
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    chainSmoothing[i] = SmoothingFilterType::New();
+    chainSmoothing[i]->SetInput( i == 0 ? noisy.GetPointer() : chainSmoothing[i - 1]->GetOutput() );
+    chainSmoothing[i]->SetCoefficientsMethod( &coefficients );
+    chainSmoothing[i]->SetNumberOfIterations( 1 );
+    chainSmoothing[i]->SetRelaxationFactor( 0.5 );
+    chainSmoothing[i]->SetDelaunayConforming( true );
+    }
+  TRY_EXPECT_NO_EXCEPTION( chainSmoothing[2]->Update() );
+
+  TEST_EXPECT_TRUE( ClosePoints( delaunaySmoothing->GetOutput()->GetPoints(),
+                                 chainSmoothing[2]->GetOutput()->GetPoints(), 1e-9 ) );
+  TEST_EXPECT_TRUE( CheckOneRingAdjacency< MeshType >( delaunaySmoothing->GetOutput(),
+                                                       delaunaySmoothing->GetOneRingAdjacency() ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkQuadEdgeMesh.h"
+#include "itkRegularSphereMeshSource.h"
+#include "itkQuadEdgeMeshDecimationCriteria.h"
+#include "itkQuadricDecimationQuadEdgeMeshFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TMesh >
+bool CheckDecimatedMesh( TMesh *mesh, unsigned int maximumValence )
+{
+  using PointsContainerConstIterator = typename TMesh::PointsContainer::ConstIterator;
+  for ( PointsContainerConstIterator it = mesh->GetPoints()->Begin(); it != mesh->GetPoints()->End(); ++it )
+    {
+    typename TMesh::QEType *edge = it.Value().GetEdge();
+    if ( edge == nullptr )
+      {
+      std::cerr << "Point " << it.Index() << " is isolated" << std::endl;
+      return false;
+      }
+    if ( edge->GetOrigin() != it.Index() )
+      {
+      std::cerr << "Point " << it.Index() << " has a wrong edge" << std::endl;
+      return false;
+      }
+    const unsigned int valence = edge->GetOrder();
+    if ( valence < 3 || valence > maximumValence )
+      {
+      std::cerr << "Point " << it.Index() << " has valence " << valence << std::endl;
+      return false;
+      }
+    // the sphere is only mildly deformed, the collapsed points stay close
+    const double radius = it.Value().GetVectorFromOrigin().GetNorm();
+    if ( radius < 0.5 || radius > 1.5 )
+      {
+      std::cerr << "Point " << it.Index() << " moved away: " << it.Value() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkQuadricDecimationQuadEdgeMeshFilterParallelTest( int, char* [] )
+{
+  using CoordType = double;
+  constexpr unsigned int Dimension = 3;
+
+  using MeshType = itk::QuadEdgeMesh< CoordType, Dimension >;
+  using SphereSourceType = itk::RegularSphereMeshSource< MeshType >;
+  using CriterionType = itk::NumberOfFacesCriterion< MeshType >;
+  using DecimationType = itk::QuadricDecimationQuadEdgeMeshFilter<
+    MeshType, MeshType, CriterionType >;
+
+  SphereSourceType::Pointer source = SphereSourceType::New();
+  source->SetResolution( 5 );
+  source->Update();
+
+  MeshType::Pointer mesh = source->GetOutput();
+  mesh->DisconnectPipeline();
+
+  // Deform the sphere so that the quadrics do not all agree.
+  for ( MeshType::PointsContainer::Iterator it = mesh->GetPoints()->Begin();
+        it != mesh->GetPoints()->End(); ++it )
+    {
+    MeshType::PointType & p = it.Value();
+    p[0] *= 1.0 + 0.2 * std::sin( 5.0 * p[1] );
+    p[2] *= 1.0 + 0.1 * std::cos( 3.0 * p[0] );
+    }
+
+  const MeshType::CellIdentifier numberOfFaces = mesh->GetNumberOfFaces();
+  const MeshType::CellIdentifier targetNumberOfFaces = numberOfFaces / 10;
+
+  for ( unsigned int parallel = 0; parallel < 2; ++parallel )
+    {
+    CriterionType::Pointer criterion = CriterionType::New();
+    criterion->SetTopologicalChange( true );
+    criterion->SetNumberOfElements( targetNumberOfFaces );
+
+    DecimationType::Pointer decimate = DecimationType::New();
+    EXERCISE_BASIC_OBJECT_METHODS( decimate, QuadricDecimationQuadEdgeMeshFilter,
+                                   EdgeDecimationQuadEdgeMeshFilter );
+
+    TEST_SET_GET_BOOLEAN( decimate, ParallelDecimation, parallel != 0 );
+
+    decimate->SetInput( mesh );
+    decimate->SetCriterion( criterion );
+    decimate->SetNumberOfThreads( 4 );
+
+    TRY_EXPECT_NO_EXCEPTION( decimate->Update() );
+
+    MeshType *output = decimate->GetOutput();
+    std::cout << ( parallel ? "Parallel" : "Serial" ) << " decimation: "
+              << numberOfFaces << " -> " << output->GetNumberOfFaces() << " faces, "
+              << output->GetNumberOfPoints() << " points" << std::endl;
+
+    // each collapse removes two faces
+    TEST_EXPECT_TRUE( output->GetNumberOfFaces() < targetNumberOfFaces );
+    TEST_EXPECT_TRUE( output->GetNumberOfFaces() + 2 >= targetNumberOfFaces );
+
+    // still a closed surface of genus 0
+    const long eulerCharacteristic = static_cast< long >( output->GetNumberOfPoints() )
+      - static_cast< long >( output->GetNumberOfEdges() )
+      + static_cast< long >( output->GetNumberOfFaces() );
+    TEST_EXPECT_EQUAL( eulerCharacteristic, 2 );
+
+    TEST_EXPECT_TRUE( CheckDecimatedMesh( output, 12 ) );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,9 @@
 #include "itkNumericTraits.h"
 #include <itksys/SystemTools.hxx>
 #include  <locale>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
 #include <vector>
 
 
@@ -237,17 +240,21 @@ OBJMeshIO
   std::string line;
   std::string inputLine;
   std::string type;
-  std::locale loc;
+  std::istringstream lineStream;
+  lineStream.imbue( std::locale::classic() );
   while ( std::getline(m_InputFile, line, '\n') )
     {
     if ( SplitLine(line, type, inputLine) && !inputLine.empty() )
       {
       if ( type == "v" )
         {
-        std::stringstream ss(inputLine);
+        // The classic locale reads '.' as the decimal point whatever the
+        // locale of the application.
+        lineStream.clear();
+        lineStream.str(inputLine);
         for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
           {
-          ss >> data[index++];
+          lineStream >> data[index++];
           }
         }
       }
@@ -277,30 +284,27 @@ OBJMeshIO
       {
       if ( type == "f" )
         {
-        std::stringstream   ss(inputLine);
-        std::string         item;
-        std::vector< long > idList;
-        while ( ss >> item )
+        // Each item is "v", "v/vt", "v//vn" or "v/vt/vn"; only the vertex
+        // index is kept.
+        const SizeValueType numberOfPointsIndex = index++;
+        const char *        token = inputLine.c_str();
+        while ( true )
           {
-          long                   id;
-          std::string::size_type pos = item.find('/');
-          while ( pos != std::string::npos )
+          while ( std::isspace( static_cast< unsigned char >( *token ) ) )
             {
-            item.replace(pos, 1, " ");
-            pos = item.find('/', pos);
+            ++token;
+            }
+          if ( *token == '\0' )
+            {
+            break;
+            }
+          data[index++] = std::strtol(token, nullptr, 10) - 1;
+          while ( *token != '\0' && !std::isspace( static_cast< unsigned char >( *token ) ) )
+            {
+            ++token;
             }
-
-          std::stringstream st(item);
-          st >> id;
-
-          idList.push_back(id);
-          }
-
-        data[index++] = static_cast<long>( idList.size() );
-        for ( std::vector< long >::const_iterator it = idList.begin(); it != idList.end(); ++it )
-          {
-          data[index++] = ( *it - 1 );
           }
+        data[numberOfPointsIndex] = static_cast< long >( index - numberOfPointsIndex - 1 );
         }
       }
     }
@@ -328,17 +332,21 @@ OBJMeshIO
   std::string line;
   std::string inputLine;
   std::string type;
-  std::locale loc;
+  std::istringstream lineStream;
+  lineStream.imbue( std::locale::classic() );
   while ( std::getline(m_InputFile, line, '\n') )
     {
     if ( SplitLine(line, type, inputLine) && !inputLine.empty() )
       {
       if ( type == "vn" )
         {
-        std::stringstream ss(inputLine);
+        // The classic locale reads '.' as the decimal point whatever the
+        // locale of the application.
+        lineStream.clear();
+        lineStream.str(inputLine);
         for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
           {
-          ss >> data[index++];
+          lineStream >> data[index++];
           }
         }
       }
@@ -20,6 +20,8 @@
 
 #include <itksys/SystemTools.hxx>
 
+#include <vector>
+
 namespace itk
 {
 BYUMeshIO
@@ -143,23 +145,16 @@ BYUMeshIO
   // Set default point component type
   this->m_PointComponentType = DOUBLE;
 
-  // Read and omit points
-  double x;
-  for ( SizeValueType ii = 0; ii < this->m_NumberOfPoints; ii++ )
-    {
-    for ( unsigned int jj = 0; jj < this->m_PointDimension; jj++ )
-      {
-      inputFile >> x;
-      }
-    }
+  // Skip points; they are converted by ReadPoints
+  this->SkipAsciiTokens(inputFile, this->m_NumberOfPoints * this->m_PointDimension);
 
-  // Determine cellbuffersize
+  // Determine cellbuffersize, parsing the ids as ReadCells does
   int ptId;
   this->m_CellBufferSize = 0;
   SizeValueType numLines = 0;
   while ( numLines < this->m_NumberOfCells )
     {
-    inputFile >> ptId;
+    this->ReadAsciiValue(inputFile, ptId);
 
     this->m_CellBufferSize++;
     if ( ptId < 0 )
@@ -210,14 +205,7 @@ BYUMeshIO
   // Read points
   inputFile.precision(12);
 
-  SizeValueType index = 0;
-  for ( SizeValueType id = 0; id < this->m_NumberOfPoints; id++ )
-    {
-    for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
-      {
-      inputFile >> data[index++];
-      }
-    }
+  this->ReadBufferAsAscii(data, inputFile, this->m_NumberOfPoints * this->m_PointDimension);
 
   // Determine cells start position
   m_FilePosition = inputFile.tellg();
@@ -244,15 +232,18 @@ BYUMeshIO
   // Get cell buffer
   inputFile.precision(12);
   auto * data = static_cast< unsigned int * >( buffer );
+  std::vector< int > ptIds( this->m_CellBufferSize - 2 * this->m_NumberOfCells );
+  this->ReadBufferAsAscii(ptIds.data(), inputFile, ptIds.size());
+
   SizeValueType  numPoints = 0;
   SizeValueType id = itk::NumericTraits< SizeValueType >::ZeroValue();
   SizeValueType index = 2;
-  int           ptId;
+  SizeValueType ptIndex = 0;
   m_FirstCellId -= 1;
   m_LastCellId -= 1;
   while ( id < this->m_NumberOfCells )
     {
-    inputFile >> ptId;
+    const int ptId = ptIds[ptIndex++];
     if ( ptId >= 0 )
       {
       if ( id >= m_FirstCellId && id <= m_LastCellId )
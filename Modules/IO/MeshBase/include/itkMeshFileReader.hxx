@@ -120,17 +120,19 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadPoints(T *buffer)
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
-  output->GetPoints()->Reserve( m_MeshIO->GetNumberOfPoints() );
-  OutputPointType point;
+  typename TOutputMesh::PointsContainer *points = output->GetPoints();
+  points->Reserve( m_MeshIO->GetNumberOfPoints() );
 
-  for ( OutputPointIdentifier id = 0; id < output->GetNumberOfPoints(); id++ )
+  // Fill the reserved container in place rather than inserting the points
+  // one by one.
+  const T *pointBuffer = buffer;
+  for ( typename TOutputMesh::PointsContainer::Iterator it = points->Begin(); it != points->End(); ++it )
     {
+    OutputPointType & point = it.Value();
     for ( OutputPointIdentifier ii = 0; ii < OutputPointDimension; ii++ )
       {
-      point[ii] = static_cast< typename OutputPointType::ValueType >( buffer[id * OutputPointDimension + ii] );
+      point[ii] = static_cast< typename OutputPointType::ValueType >( *pointBuffer++ );
       }
-
-    output->SetPoint(id, point);
     }
 }
 
@@ -140,202 +142,122 @@ void
 MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadCells(T *buffer)
 {
-  typename TOutputMesh::Pointer output = this->GetOutput();
+  using CellGeometriesContainer = typename TOutputMesh::CellGeometriesContainer;
+  using CellOffsetsContainer = typename TOutputMesh::CellOffsetsContainer;
+  using CellConnectivityContainer = typename TOutputMesh::CellConnectivityContainer;
+
+  typename CellGeometriesContainer::Pointer   geometries = CellGeometriesContainer::New();
+  typename CellOffsetsContainer::Pointer      offsets = CellOffsetsContainer::New();
+  typename CellConnectivityContainer::Pointer connectivity = CellConnectivityContainer::New();
+
+  auto & geometriesVector = geometries->CastToSTLContainer();
+  auto & offsetsVector = offsets->CastToSTLContainer();
+  auto & connectivityVector = connectivity->CastToSTLContainer();
+
+  // Every cell of the buffer is stored as its type, its number of points
+  // and its point identifiers.
+  const SizeValueType bufferSize = m_MeshIO->GetCellBufferSize();
+  const SizeValueType numberOfCells = m_MeshIO->GetNumberOfCells();
+  geometriesVector.reserve(numberOfCells);
+  offsetsVector.reserve(numberOfCells + 1);
+  if ( bufferSize > 2 * numberOfCells )
+    {
+    connectivityVector.reserve(bufferSize - 2 * numberOfCells);
+    }
+  offsetsVector.push_back(0);
 
-  SizeValueType        index = NumericTraits< SizeValueType >::ZeroValue();
-  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::ZeroValue();
-  while ( index < m_MeshIO->GetCellBufferSize() )
+  SizeValueType index = NumericTraits< SizeValueType >::ZeroValue();
+  while ( index < bufferSize )
     {
     auto type = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
+    auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
+
+    unsigned char geometry = OutputCellType::LAST_ITK_CELL;
+    unsigned int  expectedNumberOfPoints = numberOfPoints;
+    const char *  cellName = "";
     switch ( type )
       {
       case MeshIOBase::VERTEX_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputVertexCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Vertex Cell with number of points = " << numberOfPoints);
-          }
-        OutputCellAutoPointer cell;
-        auto * vertexCell = new OutputVertexCellType;
-        for ( unsigned int jj = 0; jj < OutputVertexCellType::NumberOfPoints; jj++ )
-          {
-          vertexCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(vertexCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::VERTEX_CELL;
+        expectedNumberOfPoints = OutputVertexCellType::NumberOfPoints;
+        cellName = "Vertex";
         break;
-        }
       case MeshIOBase::LINE_CELL:
         {
         // for polylines will be loaded as individual edges.
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
         if ( numberOfPoints < 2 )
           {
           itkExceptionMacro(<< "Invalid Line Cell with number of points = " << numberOfPoints);
           }
-        auto pointIDBuffer = static_cast< OutputPointIdentifier >( buffer[index++] );
         for ( unsigned int jj = 1; jj < numberOfPoints; ++jj )
           {
-          OutputCellAutoPointer cell;
-          auto * lineCell = new OutputLineCellType;
-          lineCell->SetPointId(0, pointIDBuffer);
-          pointIDBuffer = static_cast< OutputPointIdentifier >( buffer[index++] );
-          lineCell->SetPointId(1, pointIDBuffer);
-          cell.TakeOwnership(lineCell);
-          output->SetCell(id++, cell);
+          geometriesVector.push_back(OutputCellType::LINE_CELL);
+          connectivityVector.push_back( static_cast< OutputPointIdentifier >( buffer[index + jj - 1] ) );
+          connectivityVector.push_back( static_cast< OutputPointIdentifier >( buffer[index + jj] ) );
+          offsetsVector.push_back( connectivityVector.size() );
           }
-        break;
+        index += numberOfPoints;
+        continue;
         }
       case MeshIOBase::TRIANGLE_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputTriangleCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Triangle Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer   cell;
-        auto * triangleCell = new OutputTriangleCellType;
-        for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
-          {
-          triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(triangleCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::TRIANGLE_CELL;
+        expectedNumberOfPoints = OutputTriangleCellType::NumberOfPoints;
+        cellName = "Triangle";
         break;
-        }
       case MeshIOBase::QUADRILATERAL_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadrilateralCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Quadrilateral Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer        cell;
-        auto * quadrilateralCell = new OutputQuadrilateralCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadrilateralCellType::NumberOfPoints; jj++ )
-          {
-          quadrilateralCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(quadrilateralCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::QUADRILATERAL_CELL;
+        expectedNumberOfPoints = OutputQuadrilateralCellType::NumberOfPoints;
+        cellName = "Quadrilateral";
         break;
-        }
       case MeshIOBase::POLYGON_CELL:
-        {
         // For polyhedron, if the number of points is 3, then we treat it as
         // triangle cell
-        OutputCellAutoPointer cell;
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints == OutputTriangleCellType::NumberOfPoints )
-          {
-          auto * triangleCell = new OutputTriangleCellType;
-          for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
-            {
-            triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-            }
-          cell.TakeOwnership(triangleCell);
-          }
-        else
-          {
-          auto * polygonCell = new OutputPolygonCellType;
-          for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
-            {
-            polygonCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-            }
-          cell.TakeOwnership(polygonCell);
-          }
-
-        output->SetCell(id++, cell);
+        geometry = ( numberOfPoints == OutputTriangleCellType::NumberOfPoints ) ?
+                   OutputCellType::TRIANGLE_CELL : OutputCellType::POLYGON_CELL;
         break;
-        }
       case MeshIOBase::TETRAHEDRON_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputTetrahedronCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Tetrahedron Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer      cell;
-        auto * tetrahedronCell = new OutputTetrahedronCellType;
-        for ( unsigned int jj = 0; jj < OutputTetrahedronCellType::NumberOfPoints; jj++ )
-          {
-          tetrahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(tetrahedronCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::TETRAHEDRON_CELL;
+        expectedNumberOfPoints = OutputTetrahedronCellType::NumberOfPoints;
+        cellName = "Tetrahedron";
         break;
-        }
       case MeshIOBase::HEXAHEDRON_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputHexahedronCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Hexahedron Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer     cell;
-        auto * hexahedronCell = new OutputHexahedronCellType;
-        for ( unsigned int jj = 0; jj < OutputHexahedronCellType::NumberOfPoints; jj++ )
-          {
-          hexahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(hexahedronCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::HEXAHEDRON_CELL;
+        expectedNumberOfPoints = OutputHexahedronCellType::NumberOfPoints;
+        cellName = "Hexahedron";
         break;
-        }
       case MeshIOBase::QUADRATIC_EDGE_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadraticEdgeCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Quadratic edge Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer        cell;
-        auto * quadraticEdgeCell = new OutputQuadraticEdgeCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadraticEdgeCellType::NumberOfPoints; jj++ )
-          {
-          quadraticEdgeCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(quadraticEdgeCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::QUADRATIC_EDGE_CELL;
+        expectedNumberOfPoints = OutputQuadraticEdgeCellType::NumberOfPoints;
+        cellName = "Quadratic edge";
         break;
-        }
       case MeshIOBase::QUADRATIC_TRIANGLE_CELL:
-        {
-        auto numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadraticTriangleCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Quadratic triangle Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer            cell;
-        auto * quadraticTriangleCell = new OutputQuadraticTriangleCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadraticTriangleCellType::NumberOfPoints; jj++ )
-          {
-          quadraticTriangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(quadraticTriangleCell);
-        output->SetCell(id++, cell);
+        geometry = OutputCellType::QUADRATIC_TRIANGLE_CELL;
+        expectedNumberOfPoints = OutputQuadraticTriangleCellType::NumberOfPoints;
+        cellName = "Quadratic triangle";
         break;
-        }
       default:
         {
         itkExceptionMacro(<< "Unknown cell type");
         }
       }
+
+    if ( numberOfPoints != expectedNumberOfPoints )
+      {
+      itkExceptionMacro(<< "Invalid " << cellName << " Cell with number of points = " << numberOfPoints);
+      }
+
+    geometriesVector.push_back(geometry);
+    for ( unsigned int jj = 0; jj < numberOfPoints; ++jj )
+      {
+      connectivityVector.push_back( static_cast< OutputPointIdentifier >( buffer[index++] ) );
+      }
+    offsetsVector.push_back( connectivityVector.size() );
     }
+
+  // With UseCellsArrays on, a plain Mesh keeps the arrays, without
+  // allocating a cell object per cell.
+  TOutputMesh::SetCellsFromArrays(this->GetOutput(), geometries, offsets, connectivity,
+                                  this->GetUseCellsArrays());
 }
 
 template< typename TOutputMesh, typename ConvertPointPixelTraits, typename ConvertCellPixelTraits >
@@ -398,10 +320,14 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
   delete[] inputPointDataBuffer;
   inputPointDataBuffer = nullptr;
 
-  for ( OutputPointIdentifier id = 0; id < m_MeshIO->GetNumberOfPointPixels(); id++ )
+  typename TOutputMesh::PointDataContainer::Pointer pointData = TOutputMesh::PointDataContainer::New();
+  pointData->Reserve( m_MeshIO->GetNumberOfPointPixels() );
+  const OutputPointPixelType *pointDataValue = outputPointDataBuffer;
+  for ( typename TOutputMesh::PointDataContainer::Iterator it = pointData->Begin(); it != pointData->End(); ++it )
     {
-    output->SetPointData(id, outputPointDataBuffer[id]);
+    it.Value() = *pointDataValue++;
     }
+  output->SetPointData(pointData);
 
   delete[] outputPointDataBuffer;
   outputPointDataBuffer = nullptr;
@@ -467,10 +393,14 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
   delete[] inputCellDataBuffer;
   inputCellDataBuffer = nullptr;
 
-  for ( OutputCellIdentifier id = 0; id < m_MeshIO->GetNumberOfCellPixels(); id++ )
+  typename TOutputMesh::CellDataContainer::Pointer cellData = TOutputMesh::CellDataContainer::New();
+  cellData->Reserve( m_MeshIO->GetNumberOfCellPixels() );
+  const OutputCellPixelType *cellDataValue = outputCellDataBuffer;
+  for ( typename TOutputMesh::CellDataContainer::Iterator it = cellData->Begin(); it != cellData->End(); ++it )
     {
-    output->SetCellData(id, outputCellDataBuffer[id]);
+    it.Value() = *cellDataValue++;
     }
+  output->SetCellData(cellData);
 
   delete[] outputCellDataBuffer;
   outputCellDataBuffer = nullptr;
@@ -138,6 +138,9 @@ protected:
   template< typename Output >
   void CopyCellsToBuffer(Output *data);
 
+  /** MeshIOBase cell type of a cell of the given CellGeometry. */
+  MeshIOBase::CellGeometryType GetMeshIOCellType(unsigned int cellType) const;
+
   template< typename Output >
   void CopyPointDataToBuffer(Output *data);
 
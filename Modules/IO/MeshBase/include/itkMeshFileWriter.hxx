@@ -176,13 +176,21 @@ MeshFileWriter< TInputMesh >
     m_MeshIO->SetPointComponentType(MeshIOBase::MapComponentType< typename TInputMesh::PointType::ValueType >::CType);
     }
 
-  // Whether write cells
-  if ( input->GetCells() && input->GetNumberOfCells() )
+  // Whether write cells, stored either as cell objects or as compact arrays
+  const bool writeCells = ( input->HasCellsArrays() || input->GetCells() ) && input->GetNumberOfCells();
+  if ( writeCells )
     {
     SizeValueType cellsBufferSize = 2 * input->GetNumberOfCells();
-    for ( typename TInputMesh::CellsContainerConstIterator ct = input->GetCells()->Begin(); ct != input->GetCells()->End(); ++ct )
+    if ( input->HasCellsArrays() )
       {
-      cellsBufferSize += ct->Value()->GetNumberOfPoints();
+      cellsBufferSize += input->GetCellConnectivity()->Size();
+      }
+    else
+      {
+      for ( typename TInputMesh::CellsContainerConstIterator ct = input->GetCells()->Begin(); ct != input->GetCells()->End(); ++ct )
+        {
+        cellsBufferSize += ct->Value()->GetNumberOfPoints();
+        }
       }
     m_MeshIO->SetCellBufferSize(cellsBufferSize);
     m_MeshIO->SetUpdateCells(true);
@@ -222,7 +230,7 @@ MeshFileWriter< TInputMesh >
     }
 
   // Write cells
-  if ( input->GetCells() && input->GetNumberOfCells() )
+  if ( writeCells )
     {
     WriteCells();
     }
@@ -353,53 +361,44 @@ void
 MeshFileWriter< TInputMesh >
 ::CopyCellsToBuffer(Output *data)
 {
-  // Get input mesh pointer
-  const typename InputMeshType::CellsContainer * cells = this->GetInput()->GetCells();
+  const InputMeshType *input = this->GetInput();
+
+  // Every cell is written as its type, its number of points and its point
+  // identifiers
+  SizeValueType index = NumericTraits< SizeValueType >::ZeroValue();
+
+  // Cells stored as compact arrays are read directly from the arrays
+  if ( input->HasCellsArrays() )
+    {
+    const auto & geometries = input->GetCellGeometries()->CastToSTLConstContainer();
+    const auto & offsets = input->GetCellOffsets()->CastToSTLConstContainer();
+    const auto & connectivity = input->GetCellConnectivity()->CastToSTLConstContainer();
+    for ( SizeValueType cellId = 0; cellId < geometries.size(); ++cellId )
+      {
+      data[index++] = static_cast< Output >( this->GetMeshIOCellType(geometries[cellId]) );
+      data[index++] = static_cast< Output >( offsets[cellId + 1] - offsets[cellId] );
+      for ( SizeValueType ii = offsets[cellId]; ii < offsets[cellId + 1]; ii++ )
+        {
+        data[index++] = static_cast< Output >( connectivity[ii] );
+        }
+      }
+    return;
+    }
+
+  const typename InputMeshType::CellsContainer * cells = input->GetCells();
 
   // Define required variables
   typename TInputMesh::PointIdentifier const  *ptIds;
   typename TInputMesh::CellType * cellPtr;
 
   // For each cell
-  SizeValueType index = NumericTraits< SizeValueType >::ZeroValue();
   typename TInputMesh::CellsContainerConstIterator cter = cells->Begin();
   while ( cter != cells->End() )
     {
     cellPtr = cter.Value();
 
     // Write the cell type
-    switch ( cellPtr->GetType() )
-      {
-      case InputMeshCellType::VERTEX_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::VERTEX_CELL );
-        break;
-      case InputMeshCellType::LINE_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::LINE_CELL );
-        break;
-      case InputMeshCellType::TRIANGLE_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::TRIANGLE_CELL );
-        break;
-      case InputMeshCellType::QUADRILATERAL_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::QUADRILATERAL_CELL );
-        break;
-      case InputMeshCellType::POLYGON_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::POLYGON_CELL );
-        break;
-      case InputMeshCellType::TETRAHEDRON_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::TETRAHEDRON_CELL );
-        break;
-      case InputMeshCellType::HEXAHEDRON_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::HEXAHEDRON_CELL );
-        break;
-      case InputMeshCellType::QUADRATIC_EDGE_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::QUADRATIC_EDGE_CELL );
-        break;
-      case InputMeshCellType::QUADRATIC_TRIANGLE_CELL:
-        data[index++] = static_cast< Output >( MeshIOBase::QUADRATIC_TRIANGLE_CELL );
-        break;
-      default:
-        itkExceptionMacro(<< "Unknown mesh cell");
-      }
+    data[index++] = static_cast< Output >( this->GetMeshIOCellType( cellPtr->GetType() ) );
 
     // The second element is number of points for each cell
     data[index++] = cellPtr->GetNumberOfPoints();
@@ -416,6 +415,36 @@ MeshFileWriter< TInputMesh >
     }
 }
 
+template< typename TInputMesh >
+MeshIOBase::CellGeometryType
+MeshFileWriter< TInputMesh >
+::GetMeshIOCellType(unsigned int cellType) const
+{
+  switch ( cellType )
+    {
+    case InputMeshCellType::VERTEX_CELL:
+      return MeshIOBase::VERTEX_CELL;
+    case InputMeshCellType::LINE_CELL:
+      return MeshIOBase::LINE_CELL;
+    case InputMeshCellType::TRIANGLE_CELL:
+      return MeshIOBase::TRIANGLE_CELL;
+    case InputMeshCellType::QUADRILATERAL_CELL:
+      return MeshIOBase::QUADRILATERAL_CELL;
+    case InputMeshCellType::POLYGON_CELL:
+      return MeshIOBase::POLYGON_CELL;
+    case InputMeshCellType::TETRAHEDRON_CELL:
+      return MeshIOBase::TETRAHEDRON_CELL;
+    case InputMeshCellType::HEXAHEDRON_CELL:
+      return MeshIOBase::HEXAHEDRON_CELL;
+    case InputMeshCellType::QUADRATIC_EDGE_CELL:
+      return MeshIOBase::QUADRATIC_EDGE_CELL;
+    case InputMeshCellType::QUADRATIC_TRIANGLE_CELL:
+      return MeshIOBase::QUADRATIC_TRIANGLE_CELL;
+    default:
+      itkExceptionMacro(<< "Unknown mesh cell");
+    }
+}
+
 template< typename TInputMesh >
 template< typename Output >
 void
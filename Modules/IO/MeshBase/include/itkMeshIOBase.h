@@ -37,6 +37,9 @@
 #include <string>
 #include <complex>
 #include <fstream>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -127,6 +130,9 @@ public:
                  QUADRATIC_EDGE_CELL, QUADRATIC_TRIANGLE_CELL,
                  LAST_ITK_CELL, MAX_ITK_CELLS = 255}  CellGeometryType;
 
+  /** Enums used to report the conversion of an ASCII number token. */
+  typedef  enum {ASCII_NUMBER, ASCII_OUT_OF_RANGE, ASCII_NOT_A_NUMBER} AsciiConversionType;
+
   /** Set/Get the type of the point/cell pixel. The PixelTypes provides context
     * to the IO mechanisms for data conversions.  PixelTypes can be
     * SCALAR, RGB, RGBA, VECTOR, COVARIANTVECTOR, POINT, INDEX. If
@@ -525,16 +531,140 @@ protected:
   /** Insert an extension to the list of supported extensions for writing. */
   void AddSupportedWriteExtension(const char *extension);
 
-  /** Read data from input file stream to buffer with ascii style */
+  /** Read data from input file stream to buffer with ascii style.  The
+   * numbers are split into tokens in one pass over the stream buffer, and
+   * the tokens are then converted in parallel without going through the
+   * formatted extraction operators.  The stream is left just after the last
+   * number read, as with operator>>.  A token which is not entirely a number
+   * throws an exception.  A number out of the range of T is clamped and sets
+   * the failbit of the stream, as operator>> does. */
+  template< typename T >
+  void ReadBufferAsAscii(T *buffer, std::istream & inputFile, SizeValueType numberOfComponents)
+  {
+    std::vector< char >          text;
+    std::vector< SizeValueType > offsets;
+    this->ReadAsciiTokens(inputFile, numberOfComponents, text, offsets);
+    const SizeValueType first = Self::ConvertAsciiTokens(&Self::ConvertAsciiTokensRange< T >, buffer, text, offsets);
+
+    // Tokens which did not convert cleanly are rare; look at them one by one.
+    for ( SizeValueType ii = first; ii < numberOfComponents; ++ii )
+      {
+      this->CheckAsciiConversion(inputFile, text.data() + offsets[ii],
+                                 ConvertAsciiToken(text.data() + offsets[ii], buffer[ii]) );
+      }
+  }
+
+  /** Read the next number of the stream with the same tokenization and
+   * conversion as ReadBufferAsAscii(). */
+  template< typename T >
+  void ReadAsciiValue(std::istream & inputFile, T & value)
+  {
+    std::string token;
+    this->ReadAsciiToken(inputFile, token);
+    this->CheckAsciiConversion( inputFile, token.c_str(), ConvertAsciiToken(token.c_str(), value) );
+  }
+
+  /** Split the next \a numberOfTokens white space separated tokens of the
+   * stream into \a text, as null terminated strings starting at \a
+   * offsets.  An exception is thrown if the stream ends too early. */
+  void ReadAsciiTokens(std::istream & inputFile, SizeValueType numberOfTokens,
+                       std::vector< char > & text, std::vector< SizeValueType > & offsets);
+
+  /** Read the next white space separated token of the stream into \a token.
+   * An exception is thrown at the end of the stream. */
+  void ReadAsciiToken(std::istream & inputFile, std::string & token);
+
+  /** Skip the next \a numberOfTokens white space separated tokens of the
+   * stream.  An exception is thrown if the stream ends too early. */
+  void SkipAsciiTokens(std::istream & inputFile, SizeValueType numberOfTokens);
+
+  /** Throw an exception if \a token is ASCII_NOT_A_NUMBER, and set the
+   * failbit of the stream if it is ASCII_OUT_OF_RANGE. */
+  void CheckAsciiConversion(std::istream & inputFile, const char *token, AsciiConversionType conversion);
+
+  /** Convert a number token.  Integers are parsed directly; floating point
+   * numbers are extracted with the classic locale, so that they do not
+   * depend on the locale of the application.  Out of range numbers are
+   * clamped to the limits of T and invalid tokens give zero, as with
+   * operator>>. */
+  template< typename T >
+  static AsciiConversionType ConvertAsciiToken(const char *token, T & value)
+  {
+    using MagnitudeType = typename std::make_unsigned< T >::type;
+
+    bool negative = false;
+    if ( *token == '-' || *token == '+' )
+      {
+      negative = ( *token == '-' );
+      ++token;
+      }
+    // Unsigned types accept a minus sign and wrap around, as strtoul does.
+    const bool          negativeSigned = negative && std::numeric_limits< T >::is_signed;
+    const MagnitudeType maximum = negativeSigned
+      ? static_cast< MagnitudeType >( static_cast< MagnitudeType >( std::numeric_limits< T >::max() ) + 1 )
+      : static_cast< MagnitudeType >( std::numeric_limits< T >::max() );
+
+    const char *  digits = token;
+    MagnitudeType number = 0;
+    bool          outOfRange = false;
+    while ( *token >= '0' && *token <= '9' )
+      {
+      const auto digit = static_cast< MagnitudeType >( *token - '0' );
+      if ( number > ( maximum - digit ) / 10 )
+        {
+        outOfRange = true;
+        }
+      number = static_cast< MagnitudeType >( number * 10 + digit );
+      ++token;
+      }
+    if ( token == digits || *token != '\0' )
+      {
+      value = 0;
+      return ASCII_NOT_A_NUMBER;
+      }
+    if ( outOfRange )
+      {
+      value = negativeSigned ? std::numeric_limits< T >::lowest() : std::numeric_limits< T >::max();
+      return ASCII_OUT_OF_RANGE;
+      }
+    value = static_cast< T >( negative ? static_cast< MagnitudeType >( 0 - number ) : number );
+    return ASCII_NUMBER;
+  }
+
+  static AsciiConversionType ConvertAsciiToken(const char *token, float & value);
+  static AsciiConversionType ConvertAsciiToken(const char *token, double & value);
+  static AsciiConversionType ConvertAsciiToken(const char *token, long double & value);
+
+  /** Convert the tokens [begin, end) into buffer, which is a T array.
+   * Return the index of the first token which is not a number in the range
+   * of T, or \a end.  The floating point types are specialized to share
+   * one classic locale stream across the range. */
   template< typename T >
-  void ReadBufferAsAscii(T *buffer, std::ifstream & inputFile, SizeValueType numberOfComponents)
+  static SizeValueType ConvertAsciiTokensRange(void *buffer, const char *text, const SizeValueType *offsets,
+                                               SizeValueType begin, SizeValueType end)
   {
-    for ( SizeValueType i = 0; i < numberOfComponents; i++ )
+    T *           output = static_cast< T * >( buffer );
+    SizeValueType first = end;
+    for ( SizeValueType ii = begin; ii < end; ++ii )
       {
-      inputFile >> buffer[i];
+      if ( ConvertAsciiToken(text + offsets[ii], output[ii]) != ASCII_NUMBER && first == end )
+        {
+        first = ii;
+        }
       }
+    return first;
   }
 
+  using ConvertAsciiTokensRangeFunction = SizeValueType (*)(void *, const char *, const SizeValueType *,
+                                                            SizeValueType, SizeValueType);
+
+  /** Convert all the tokens, splitting large token lists across threads.
+   * Return the index of the first token which did not convert cleanly, or
+   * the number of tokens. */
+  static SizeValueType ConvertAsciiTokens(ConvertAsciiTokensRangeFunction convert, void *buffer,
+                                          const std::vector< char > & text,
+                                          const std::vector< SizeValueType > & offsets);
+
   /** Read data from input file to buffer with binary style */
   template< typename T >
   void ReadBufferAsBinary(T *buffer, std::ifstream & inputFile, SizeValueType numberOfComponents)
@@ -777,6 +907,16 @@ MESHIOBASE_TYPEMAP(float, FLOAT);
 MESHIOBASE_TYPEMAP(double, DOUBLE);
 MESHIOBASE_TYPEMAP(long double, LDOUBLE);
 #undef MESHIOBASE_TYPEMAP
+
+template<>
+ITKIOMeshBase_EXPORT SizeValueType MeshIOBase::ConvertAsciiTokensRange< float >(
+  void *, const char *, const SizeValueType *, SizeValueType, SizeValueType);
+template<>
+ITKIOMeshBase_EXPORT SizeValueType MeshIOBase::ConvertAsciiTokensRange< double >(
+  void *, const char *, const SizeValueType *, SizeValueType, SizeValueType);
+template<>
+ITKIOMeshBase_EXPORT SizeValueType MeshIOBase::ConvertAsciiTokensRange< long double >(
+  void *, const char *, const SizeValueType *, SizeValueType, SizeValueType);
 } // end namespace itk
 
 #endif
@@ -17,6 +17,13 @@
  *=========================================================================*/
 
 #include "itkMeshIOBase.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <istream>
+#include <locale>
 
 namespace itk
 {
@@ -221,6 +228,295 @@ MeshIOBase
   itkExceptionMacro ("Unknown pixel type: " << t);
 }
 
+namespace
+{
+// Append the characters of the next white space separated token of the
+// stream buffer to text.  Return false if the stream ends before a token.
+template< typename TText >
+bool
+AppendAsciiToken(std::streambuf *streamBuffer, TText & text)
+{
+  using TraitsType = std::char_traits< char >;
+
+  // Read characters straight from the stream buffer; the extraction
+  // operators pay for a sentry and a locale lookup on every number.
+  TraitsType::int_type c = streamBuffer->sgetc();
+  while ( !TraitsType::eq_int_type( c, TraitsType::eof() ) && std::isspace(c) )
+    {
+    c = streamBuffer->snextc();
+    }
+  if ( TraitsType::eq_int_type( c, TraitsType::eof() ) )
+    {
+    return false;
+    }
+  while ( !TraitsType::eq_int_type( c, TraitsType::eof() ) && !std::isspace(c) )
+    {
+    text.push_back( TraitsType::to_char_type(c) );
+    c = streamBuffer->snextc();
+    }
+  return true;
+}
+
+// Stands for the text when the tokens are skipped.
+struct DiscardedAsciiText
+{
+  void push_back(char) {}
+};
+
+// Set the end of file bit as operator>> does when the last token ends the stream.
+void
+UpdateAsciiStreamState(std::istream & inputFile)
+{
+  using TraitsType = std::char_traits< char >;
+
+  if ( TraitsType::eq_int_type( inputFile.rdbuf()->sgetc(), TraitsType::eof() ) )
+    {
+    inputFile.setstate(std::ios::eofbit);
+    }
+}
+}
+
+void
+MeshIOBase
+::ReadAsciiTokens(std::istream & inputFile, SizeValueType numberOfTokens,
+                  std::vector< char > & text, std::vector< SizeValueType > & offsets)
+{
+  text.clear();
+  offsets.clear();
+  offsets.reserve(numberOfTokens);
+  text.reserve(numberOfTokens * 8);
+
+  std::streambuf *streamBuffer = inputFile.rdbuf();
+  for ( SizeValueType ii = 0; ii < numberOfTokens; ++ii )
+    {
+    offsets.push_back( text.size() );
+    if ( !AppendAsciiToken(streamBuffer, text) )
+      {
+      inputFile.setstate(std::ios::eofbit | std::ios::failbit);
+      itkExceptionMacro(<< "Unexpected end of file after reading " << ii
+                        << " of " << numberOfTokens << " values");
+      }
+    text.push_back('\0');
+    }
+  UpdateAsciiStreamState(inputFile);
+}
+
+void
+MeshIOBase
+::ReadAsciiToken(std::istream & inputFile, std::string & token)
+{
+  token.clear();
+  if ( !AppendAsciiToken(inputFile.rdbuf(), token) )
+    {
+    inputFile.setstate(std::ios::eofbit | std::ios::failbit);
+    itkExceptionMacro(<< "Unexpected end of file");
+    }
+  UpdateAsciiStreamState(inputFile);
+}
+
+void
+MeshIOBase
+::SkipAsciiTokens(std::istream & inputFile, SizeValueType numberOfTokens)
+{
+  std::streambuf *   streamBuffer = inputFile.rdbuf();
+  DiscardedAsciiText discarded;
+  for ( SizeValueType ii = 0; ii < numberOfTokens; ++ii )
+    {
+    if ( !AppendAsciiToken(streamBuffer, discarded) )
+      {
+      inputFile.setstate(std::ios::eofbit | std::ios::failbit);
+      itkExceptionMacro(<< "Unexpected end of file after skipping " << ii
+                        << " of " << numberOfTokens << " values");
+      }
+    }
+  UpdateAsciiStreamState(inputFile);
+}
+
+void
+MeshIOBase
+::CheckAsciiConversion(std::istream & inputFile, const char *token, AsciiConversionType conversion)
+{
+  if ( conversion == ASCII_NUMBER )
+    {
+    return;
+    }
+  inputFile.setstate(std::ios::failbit);
+  if ( conversion == ASCII_NOT_A_NUMBER )
+    {
+    itkExceptionMacro(<< "Invalid number \"" << token << "\" in " << m_FileName);
+    }
+}
+
+namespace
+{
+// Convert floating point tokens with a stream imbued with the classic
+// locale, so that the decimal point is '.' whatever the LC_NUMERIC setting
+// of the application.  The stream reads the token in place.  The whole
+// token must be used.  As with operator>>, an overflow gives the largest
+// value of T and underflow to a denormal or zero is accepted.
+class ClassicFloatingPointTokenReader : private std::streambuf
+{
+public:
+  ClassicFloatingPointTokenReader() :
+    m_Stream(this)
+  {
+    m_Stream.imbue( std::locale::classic() );
+  }
+
+  template< typename T >
+  MeshIOBase::AsciiConversionType Convert(const char *token, T & value)
+  {
+    char *begin = const_cast< char * >( token );
+    this->setg( begin, begin, begin + std::strlen(token) );
+    m_Stream.clear();
+    m_Stream >> value;
+    if ( !m_Stream.fail() && m_Stream.eof() )
+      {
+      return MeshIOBase::ASCII_NUMBER;
+      }
+    if ( m_Stream.eof()
+         && ( value == std::numeric_limits< T >::max() || value == std::numeric_limits< T >::lowest() ) )
+      {
+      return MeshIOBase::ASCII_OUT_OF_RANGE;
+      }
+    value = 0;
+    return MeshIOBase::ASCII_NOT_A_NUMBER;
+  }
+
+private:
+  std::istream m_Stream;
+};
+
+// One reader serves all the tokens of the range.
+template< typename T >
+SizeValueType
+ConvertFloatingPointTokensRange(void *buffer, const char *text, const SizeValueType *offsets,
+                                SizeValueType begin, SizeValueType end)
+{
+  ClassicFloatingPointTokenReader reader;
+  T *                             output = static_cast< T * >( buffer );
+  SizeValueType                   first = end;
+  for ( SizeValueType ii = begin; ii < end; ++ii )
+    {
+    if ( reader.Convert(text + offsets[ii], output[ii]) != MeshIOBase::ASCII_NUMBER && first == end )
+      {
+      first = ii;
+      }
+    }
+  return first;
+}
+}
+
+MeshIOBase::AsciiConversionType
+MeshIOBase
+::ConvertAsciiToken(const char *token, float & value)
+{
+  return ClassicFloatingPointTokenReader().Convert(token, value);
+}
+
+MeshIOBase::AsciiConversionType
+MeshIOBase
+::ConvertAsciiToken(const char *token, double & value)
+{
+  return ClassicFloatingPointTokenReader().Convert(token, value);
+}
+
+MeshIOBase::AsciiConversionType
+MeshIOBase
+::ConvertAsciiToken(const char *token, long double & value)
+{
+  return ClassicFloatingPointTokenReader().Convert(token, value);
+}
+
+template<>
+SizeValueType
+MeshIOBase
+::ConvertAsciiTokensRange< float >(void *buffer, const char *text, const SizeValueType *offsets,
+                                   SizeValueType begin, SizeValueType end)
+{
+  return ConvertFloatingPointTokensRange< float >(buffer, text, offsets, begin, end);
+}
+
+template<>
+SizeValueType
+MeshIOBase
+::ConvertAsciiTokensRange< double >(void *buffer, const char *text, const SizeValueType *offsets,
+                                    SizeValueType begin, SizeValueType end)
+{
+  return ConvertFloatingPointTokensRange< double >(buffer, text, offsets, begin, end);
+}
+
+template<>
+SizeValueType
+MeshIOBase
+::ConvertAsciiTokensRange< long double >(void *buffer, const char *text, const SizeValueType *offsets,
+                                         SizeValueType begin, SizeValueType end)
+{
+  return ConvertFloatingPointTokensRange< long double >(buffer, text, offsets, begin, end);
+}
+
+namespace
+{
+struct ConvertAsciiTokensStruct
+{
+  SizeValueType (*Convert)(void *, const char *, const SizeValueType *, SizeValueType, SizeValueType);
+  void *                       Buffer;
+  const char *                 Text;
+  const SizeValueType *        Offsets;
+  SizeValueType                NumberOfTokens;
+  std::vector< SizeValueType > FirstFailures;
+};
+
+ITK_THREAD_RETURN_TYPE
+ConvertAsciiTokensThreaderCallback(void *arg)
+{
+  auto * info = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  auto * str = static_cast< ConvertAsciiTokensStruct * >( info->UserData );
+
+  const SizeValueType begin = str->NumberOfTokens * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType end = str->NumberOfTokens * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  const SizeValueType first = ( *str->Convert )(str->Buffer, str->Text, str->Offsets, begin, end);
+  str->FirstFailures[info->ThreadID] = ( first < end ? first : str->NumberOfTokens );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+SizeValueType
+MeshIOBase
+::ConvertAsciiTokens(ConvertAsciiTokensRangeFunction convert, void *buffer,
+                     const std::vector< char > & text,
+                     const std::vector< SizeValueType > & offsets)
+{
+  const SizeValueType numberOfTokens = offsets.size();
+
+  // Below a few tens of thousands of tokens, starting threads costs more
+  // than the conversion itself.
+  constexpr SizeValueType minimumTokensPerThread = 32768;
+  const SizeValueType     numberOfThreads = std::min< SizeValueType >(
+    MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), numberOfTokens / minimumTokensPerThread );
+
+  if ( numberOfThreads <= 1 )
+    {
+    return ( *convert )(buffer, text.data(), offsets.data(), 0, numberOfTokens);
+    }
+
+  ConvertAsciiTokensStruct str;
+  str.Convert = convert;
+  str.Buffer = buffer;
+  str.Text = text.data();
+  str.Offsets = offsets.data();
+  str.NumberOfTokens = numberOfTokens;
+  str.FirstFailures.assign(numberOfThreads, numberOfTokens);
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >( numberOfThreads ) );
+  threader->SetSingleMethod(ConvertAsciiTokensThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  return *std::min_element( str.FirstFailures.begin(), str.FirstFailures.end() );
+}
+
 void
 MeshIOBase
 ::PrintSelf(std::ostream & os, Indent indent) const
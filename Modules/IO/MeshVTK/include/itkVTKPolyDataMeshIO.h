@@ -181,10 +181,8 @@ protected:
         {
         /**  Load the point coordinates into the itk::Mesh */
         SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
+        this->ReadBufferAsAscii(buffer, inputFile, numberOfComponents);
+        break;
         }
       }
   }
@@ -253,10 +251,8 @@ protected:
 
         /** for VECTORS or NORMALS or TENSORS, we could read them directly */
         SizeValueType numberOfComponents = this->m_NumberOfPointPixels * this->m_NumberOfPointPixelComponents;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
+        this->ReadBufferAsAscii(buffer, inputFile, numberOfComponents);
+        break;
         }
       }
   }
@@ -346,10 +342,8 @@ protected:
 
         /** for VECTORS or NORMALS or TENSORS, we could read them directly */
         SizeValueType numberOfComponents = this->m_NumberOfCellPixels * this->m_NumberOfCellPixelComponents;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
+        this->ReadBufferAsAscii(buffer, inputFile, numberOfComponents);
+        break;
         }
       }
   }
@@ -362,7 +356,7 @@ protected:
     while ( !inputFile.eof() )
       {
       std::getline(inputFile, line, '\n');
-      if ( line.find("POINT_DATA") != std::string::npos )
+      if ( line.find("CELL_DATA") != std::string::npos )
         {
         if ( !inputFile.eof() )
           {
@@ -370,7 +364,7 @@ protected:
           }
         else
           {
-          itkExceptionMacro("UnExpected end of line while trying to read POINT_DATA");
+          itkExceptionMacro("UnExpected end of line while trying to read CELL_DATA");
           }
 
         /** For scalars we have to read the next line of LOOKUP_TABLE */
@@ -396,6 +390,7 @@ protected:
           {
           itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
           }
+        break;
         }
       }
   }
@@ -592,7 +587,24 @@ protected:
       ExposeMetaData< unsigned int >(metaDic, "numberOfVertexIndices", numberOfVertexIndices);
       outputFile << "VERTICES " << numberOfVertices << " " << numberOfVertexIndices << '\n';
       auto * data = new unsigned int[numberOfVertexIndices];
-      ReadCellsBuffer(buffer, data);
+      SizeValueType outputIndex = 0;
+      for ( SizeValueType ii = 0; ii < this->m_NumberOfCells; ii++ )
+        {
+        auto cellType = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
+        auto nn = static_cast< unsigned int >( buffer[index++] );
+        if ( cellType == VERTEX_CELL )
+          {
+          data[outputIndex++] = nn;
+          for ( unsigned int jj = 0; jj < nn; jj++ )
+            {
+            data[outputIndex++] = static_cast< unsigned int >( buffer[index++] );
+            }
+          }
+        else
+          {
+          index += nn;
+          }
+        }
       itk::ByteSwapper< unsigned int >::SwapWriteRangeFromSystemToBigEndian(data, numberOfVertexIndices, &outputFile);
       outputFile << "\n";
       delete[] data;
@@ -682,7 +694,26 @@ protected:
       ExposeMetaData< unsigned int >(metaDic, "numberOfPolygonIndices", numberOfPolygonIndices);
       outputFile << "POLYGONS " << numberOfPolygons << " " << numberOfPolygonIndices << '\n';
       auto * data = new unsigned int[numberOfPolygonIndices];
-      ReadCellsBuffer(buffer, data);
+      SizeValueType outputIndex = 0;
+      for ( SizeValueType ii = 0; ii < this->m_NumberOfCells; ii++ )
+        {
+        auto cellType = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
+        auto nn = static_cast< unsigned int >( buffer[index++] );
+        if ( cellType == POLYGON_CELL ||
+             cellType == TRIANGLE_CELL ||
+             cellType == QUADRILATERAL_CELL )
+          {
+          data[outputIndex++] = nn;
+          for ( unsigned int jj = 0; jj < nn; jj++ )
+            {
+            data[outputIndex++] = static_cast< unsigned int >( buffer[index++] );
+            }
+          }
+        else
+          {
+          index += nn;
+          }
+        }
       itk::ByteSwapper< unsigned int >::SwapWriteRangeFromSystemToBigEndian(data, numberOfPolygonIndices, &outputFile);
       outputFile << "\n";
       delete[] data;
@@ -790,65 +790,49 @@ VTKPolyDataMeshIO
 
 void VTKPolyDataMeshIO::ReadCellsBufferAsASCII(std::ifstream & inputFile, void *buffer)
 {
-  std::string   line;
-  SizeValueType index = 0;
-  unsigned int  numPoints; // number of point in each cell
+  std::string line;
 
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
-  auto * data = static_cast< unsigned int * >( buffer );
+  auto * outputBuffer = static_cast< unsigned int * >( buffer );
 
+  // Each section holds, for every cell, its number of points followed by
+  // its point ids.  A whole section is parsed at once, and then expanded
+  // with the cell type.
+  std::vector< unsigned int > data;
   while ( !inputFile.eof() )
     {
     std::getline(inputFile, line, '\n');
+
+    MeshIOBase::CellGeometryType cellType;
+    unsigned int                 numberOfCells = 0;
+    unsigned int                 numberOfIndices = 0;
     if ( line.find("VERTICES") != std::string::npos )
       {
-      unsigned int numberOfVertices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertices", numberOfVertices);
-
-      for ( unsigned int ii = 0; ii < numberOfVertices; ii++ )
-        {
-        inputFile >> numPoints;
-        data[index++] = MeshIOBase::VERTEX_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+      cellType = MeshIOBase::VERTEX_CELL;
+      ExposeMetaData< unsigned int >(metaDic, "numberOfVertices", numberOfCells);
+      ExposeMetaData< unsigned int >(metaDic, "numberOfVertexIndices", numberOfIndices);
       }
     else if ( line.find("LINES") != std::string::npos )
       {
-      unsigned int numberOfLines = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLines", numberOfLines);
-
-      for ( unsigned int ii = 0; ii < numberOfLines; ii++ )
-        {
-        inputFile >> numPoints;
-        data[index++] = MeshIOBase::LINE_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+      cellType = MeshIOBase::LINE_CELL;
+      ExposeMetaData< unsigned int >(metaDic, "numberOfLines", numberOfCells);
+      ExposeMetaData< unsigned int >(metaDic, "numberOfLineIndices", numberOfIndices);
       }
     else if ( line.find("POLYGONS") != std::string::npos )
       {
-      unsigned int numberOfPolygons = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygons", numberOfPolygons);
-
-      for ( unsigned int ii = 0; ii < numberOfPolygons; ii++ )
-        {
-        inputFile >> numPoints;
-
-        data[index++] = MeshIOBase::POLYGON_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+      cellType = MeshIOBase::POLYGON_CELL;
+      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygons", numberOfCells);
+      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygonIndices", numberOfIndices);
       }
+    else
+      {
+      continue;
+      }
+
+    data.resize(numberOfIndices);
+    this->ReadBufferAsAscii(data.data(), inputFile, numberOfIndices);
+    this->WriteCellsBuffer(data.data(), outputBuffer, cellType, numberOfCells);
+    outputBuffer += numberOfIndices + numberOfCells;
     }
 }
 
@@ -888,7 +872,7 @@ VTKPolyDataMeshIO
         }
       this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::VERTEX_CELL, numberOfVertices);
       startBuffer += numberOfVertexIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfVertexIndices + numberOfVertices ) * sizeof( unsigned int );
+      outputBuffer += numberOfVertexIndices + numberOfVertices;
       }
     else if ( line.find("LINES") != std::string::npos )
       {
@@ -906,7 +890,7 @@ VTKPolyDataMeshIO
         }
       this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::LINE_CELL, numberOfLines);
       startBuffer += numberOfLineIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfLineIndices + numberOfLines ) * sizeof( unsigned int );
+      outputBuffer += numberOfLineIndices + numberOfLines;
       }
     else if ( line.find("POLYGONS") != std::string::npos )
       {
@@ -925,7 +909,7 @@ VTKPolyDataMeshIO
 
       this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::POLYGON_CELL, numberOfPolygons);
       startBuffer += numberOfPolygonIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfPolygonIndices + numberOfPolygons ) * sizeof( unsigned int );
+      outputBuffer += numberOfPolygonIndices + numberOfPolygons;
       }
     }
 
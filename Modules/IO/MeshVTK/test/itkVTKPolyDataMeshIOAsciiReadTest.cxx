@@ -0,0 +1,394 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMesh.h"
+#include "itkMeshFileReader.h"
+#include "itkMeshFileWriter.h"
+#include "itkVTKPolyDataMeshIO.h"
+#include "itkTestingMacros.h"
+
+#include <clocale>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+// Write an ASCII polydata file with lines, triangles and polygons by
+// hand, read it back, and compare every value to what was written.  The
+// mesh is then written as binary and read again.
+namespace
+{
+using MeshType = itk::Mesh< float, 3 >;
+using ReaderType = itk::MeshFileReader< MeshType >;
+using WriterType = itk::MeshFileWriter< MeshType >;
+
+constexpr unsigned int GridSize = 64;
+
+float
+PointCoordinate(unsigned int id, unsigned int dimension)
+{
+  return static_cast< float >( id * 3 + dimension ) * 0.125f - 100.0f;
+}
+
+float
+PointValue(unsigned int id)
+{
+  return static_cast< float >( id ) * -0.5f;
+}
+
+float
+CellValue(unsigned int id)
+{
+  return static_cast< float >( id ) + 0.25f;
+}
+
+int
+CheckMesh(const MeshType * mesh,
+          const std::vector< std::vector< MeshType::PointIdentifier > > & cells,
+          const std::vector< unsigned char > & cellTypes)
+{
+  const unsigned int numberOfPoints = GridSize * GridSize;
+  TEST_EXPECT_EQUAL( mesh->GetNumberOfPoints(), numberOfPoints );
+  TEST_EXPECT_EQUAL( mesh->GetNumberOfCells(), cells.size() );
+
+  for ( unsigned int ii = 0; ii < numberOfPoints; ++ii )
+    {
+    const MeshType::PointType point = mesh->GetPoint(ii);
+    for ( unsigned int jj = 0; jj < 3; ++jj )
+      {
+      TEST_EXPECT_EQUAL( point[jj], PointCoordinate(ii, jj) );
+      }
+    float value = 0.0f;
+    TEST_EXPECT_TRUE( mesh->GetPointData(ii, &value) );
+    TEST_EXPECT_EQUAL( value, PointValue(ii) );
+    }
+
+  for ( unsigned int ii = 0; ii < cells.size(); ++ii )
+    {
+    MeshType::CellAutoPointer cell;
+    TEST_EXPECT_TRUE( mesh->GetCell(ii, cell) );
+    TEST_EXPECT_EQUAL( static_cast< unsigned int >( cell->GetType() ), static_cast< unsigned int >( cellTypes[ii] ) );
+    TEST_EXPECT_EQUAL( cell->GetNumberOfPoints(), cells[ii].size() );
+    for ( unsigned int jj = 0; jj < cells[ii].size(); ++jj )
+      {
+      TEST_EXPECT_EQUAL( cell->GetPointIds()[jj], cells[ii][jj] );
+      }
+    float value = 0.0f;
+    TEST_EXPECT_TRUE( mesh->GetCellData(ii, &value) );
+    TEST_EXPECT_EQUAL( value, CellValue(ii) );
+    }
+
+  return EXIT_SUCCESS;
+}
+
+// Gives access to the ASCII conversion of the mesh IO classes.
+class AsciiMeshIO : public itk::VTKPolyDataMeshIO
+{
+public:
+  using Self = AsciiMeshIO;
+  using Pointer = itk::SmartPointer< Self >;
+  itkNewMacro(Self);
+
+  template< typename T >
+  bool Read(const char *text, T & value)
+  {
+    std::istringstream stream(text);
+    this->ReadBufferAsAscii(&value, stream, 1);
+    return !stream.fail();
+  }
+};
+
+// A number in range converts silently; an out of range number is clamped
+// and fails the stream.
+template< typename T >
+int
+CheckAsciiNumber(AsciiMeshIO * meshIO, const char *text, T expected, bool inRange)
+{
+  T value = 1;
+  TEST_EXPECT_EQUAL( meshIO->Read(text, value), inRange );
+  TEST_EXPECT_EQUAL( value, expected );
+  return EXIT_SUCCESS;
+}
+
+int
+CheckAsciiConversion()
+{
+  AsciiMeshIO::Pointer meshIO = AsciiMeshIO::New();
+
+  if ( CheckAsciiNumber< short >( meshIO, "32767", 32767, true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< short >( meshIO, "-32768", -32768, true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< short >( meshIO, "+12", 12, true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< short >( meshIO, "32768", 32767, false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< short >( meshIO, "-32769", -32768, false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< unsigned int >( meshIO, "4294967295", 4294967295u, true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< unsigned int >( meshIO, "4294967296", 4294967295u, false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< long long >( meshIO, "-9223372036854775808",
+                                         std::numeric_limits< long long >::lowest(), true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< long long >( meshIO, "99999999999999999999",
+                                         std::numeric_limits< long long >::max(), false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< double >( meshIO, "-2.5e3", -2500.0, true ) != EXIT_SUCCESS
+       || CheckAsciiNumber< double >( meshIO, "1e400", std::numeric_limits< double >::max(), false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< float >( meshIO, "-1e40", std::numeric_limits< float >::lowest(), false ) != EXIT_SUCCESS
+       || CheckAsciiNumber< float >( meshIO, "1e-50", 0.0f, true ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Tokens which are not entirely a number are rejected.
+  int   integer = 0;
+  float real = 0.0f;
+  TRY_EXPECT_EXCEPTION( meshIO->Read("12abc", integer) );
+  TRY_EXPECT_EXCEPTION( meshIO->Read("-", integer) );
+  TRY_EXPECT_EXCEPTION( meshIO->Read("1.5", integer) );
+  TRY_EXPECT_EXCEPTION( meshIO->Read("1.5.2", real) );
+  TRY_EXPECT_EXCEPTION( meshIO->Read("x", real) );
+
+  return EXIT_SUCCESS;
+}
+
+struct CommaDecimalPoint : public std::numpunct< char >
+{
+  char do_decimal_point() const override { return ','; }
+};
+
+// The decimal point of the files is '.' whatever the locale of the
+// application, both the global C++ locale and the C LC_NUMERIC setting.
+// The C locales are only installed on some systems.
+int
+CheckAsciiConversionLocale()
+{
+  AsciiMeshIO::Pointer meshIO = AsciiMeshIO::New();
+
+  const std::string previousNumeric = std::setlocale(LC_NUMERIC, nullptr);
+  const std::locale previousGlobal = std::locale::global( std::locale( std::locale::classic(), new CommaDecimalPoint ) );
+  const char *      commaLocales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR" };
+  for ( const char *commaLocale : commaLocales )
+    {
+    if ( std::setlocale(LC_NUMERIC, commaLocale) != nullptr )
+      {
+      std::cout << "Reading numbers with the " << commaLocale << " locale" << std::endl;
+      break;
+      }
+    }
+
+  float  real = 0.0f;
+  double value = 0.0;
+  bool   realRead = false;
+  bool   valueRead = false;
+  try
+    {
+    realRead = meshIO->Read("1.5", real);
+    valueRead = meshIO->Read("-2.25e-1", value);
+    }
+  catch ( itk::ExceptionObject & error )
+    {
+    std::cerr << error << std::endl;
+    }
+
+  std::locale::global(previousGlobal);
+  std::setlocale( LC_NUMERIC, previousNumeric.c_str() );
+
+  TEST_EXPECT_TRUE( realRead );
+  TEST_EXPECT_EQUAL( real, 1.5f );
+  TEST_EXPECT_TRUE( valueRead );
+  TEST_EXPECT_EQUAL( value, -0.225 );
+  return EXIT_SUCCESS;
+}
+}
+
+int itkVTKPolyDataMeshIOAsciiReadTest( int argc, char* argv[] )
+{
+  if( argc < 3 )
+    {
+    std::cerr << "Usage: " << argv[0]
+              << " <InputASCIIMesh.vtk> <OutputBinaryMesh.vtk>" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int numberOfPoints = GridSize * GridSize;
+
+  // One line along the first row, then a four point polygon or two
+  // triangles per grid square.
+  std::vector< std::vector< MeshType::PointIdentifier > > cells;
+  std::vector< unsigned char >                            cellTypes;
+  for ( unsigned int ii = 0; ii + 1 < GridSize; ++ii )
+    {
+    cells.push_back( { ii, ii + 1 } );
+    cellTypes.push_back( MeshType::CellType::LINE_CELL );
+    }
+  const std::size_t numberOfLines = cells.size();
+  for ( unsigned int jj = 0; jj + 1 < GridSize; ++jj )
+    {
+    for ( unsigned int ii = 0; ii + 1 < GridSize; ++ii )
+      {
+      const MeshType::PointIdentifier p = jj * GridSize + ii;
+      if ( ( ii + jj ) % 2 )
+        {
+        cells.push_back( { p, p + 1, p + GridSize + 1, p + GridSize } );
+        cellTypes.push_back( MeshType::CellType::POLYGON_CELL );
+        }
+      else
+        {
+        cells.push_back( { p, p + 1, p + GridSize + 1 } );
+        cellTypes.push_back( MeshType::CellType::TRIANGLE_CELL );
+        cells.push_back( { p, p + GridSize + 1, p + GridSize } );
+        cellTypes.push_back( MeshType::CellType::TRIANGLE_CELL );
+        }
+      }
+    }
+
+  std::size_t numberOfLineIndices = 0;
+  std::size_t numberOfPolygonIndices = 0;
+  for ( std::size_t ii = 0; ii < cells.size(); ++ii )
+    {
+    ( ii < numberOfLines ? numberOfLineIndices : numberOfPolygonIndices ) += cells[ii].size() + 1;
+    }
+
+  std::ofstream file( argv[1] );
+  file << "# vtk DataFile Version 2.0\n"
+       << "ASCII polydata\n"
+       << "ASCII\n"
+       << "DATASET POLYDATA\n"
+       << "POINTS " << numberOfPoints << " float\n";
+  file.precision(9);
+  for ( unsigned int ii = 0; ii < numberOfPoints; ++ii )
+    {
+    // Vary the separators to exercise the tokenizer.
+    file << PointCoordinate(ii, 0) << ( ii % 2 ? "\t" : " " )
+         << PointCoordinate(ii, 1) << "  " << PointCoordinate(ii, 2) << ( ii % 3 ? "\n" : " " );
+    }
+  file << "\nLINES " << numberOfLines << ' ' << numberOfLineIndices << '\n';
+  for ( std::size_t ii = 0; ii < cells.size(); ++ii )
+    {
+    if ( ii == numberOfLines )
+      {
+      file << "POLYGONS " << cells.size() - numberOfLines << ' ' << numberOfPolygonIndices << '\n';
+      }
+    file << cells[ii].size();
+    for ( auto id : cells[ii] )
+      {
+      file << ' ' << id;
+      }
+    file << '\n';
+    }
+  file << "POINT_DATA " << numberOfPoints << '\n'
+       << "SCALARS pointValues float 1\n"
+       << "LOOKUP_TABLE default\n";
+  for ( unsigned int ii = 0; ii < numberOfPoints; ++ii )
+    {
+    file << PointValue(ii) << '\n';
+    }
+  file << "CELL_DATA " << cells.size() << '\n'
+       << "SCALARS cellValues float 1\n"
+       << "LOOKUP_TABLE default\n";
+  for ( unsigned int ii = 0; ii < cells.size(); ++ii )
+    {
+    file << CellValue(ii) << '\n';
+    }
+  file.close();
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  reader->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+
+  std::cout << "Checking the ASCII file" << std::endl;
+  if ( CheckMesh( reader->GetOutput(), cells, cellTypes ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // By default the reader creates cell objects, available through a const
+  // mesh.
+  const MeshType *constMesh = reader->GetOutput();
+  TEST_EXPECT_TRUE( !constMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( constMesh->GetCells() != nullptr );
+  TEST_EXPECT_EQUAL( constMesh->GetCells()->Size(), cells.size() );
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  writer->SetInput( reader->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->SetFileTypeAsBINARY();
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  ReaderType::Pointer binaryReader = ReaderType::New();
+  binaryReader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  binaryReader->SetFileName( argv[2] );
+  binaryReader->UseCellsArraysOn();
+  TRY_EXPECT_NO_EXCEPTION( binaryReader->Update() );
+
+  std::cout << "Checking the binary file" << std::endl;
+  if ( CheckMesh( binaryReader->GetOutput(), cells, cellTypes ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Compact cell arrays are converted when a const mesh is asked for its
+  // cells container.
+  constMesh = binaryReader->GetOutput();
+  TEST_EXPECT_TRUE( constMesh->HasCellsArrays() );
+  TEST_EXPECT_TRUE( constMesh->GetCells() != nullptr );
+  TEST_EXPECT_EQUAL( constMesh->GetCells()->Size(), cells.size() );
+  TEST_EXPECT_TRUE( !constMesh->HasCellsArrays() );
+  if ( CheckMesh( constMesh, cells, cellTypes ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // A truncated file must be reported, not read as zeros.
+  std::ofstream truncated( argv[1] );
+  truncated << "# vtk DataFile Version 2.0\n"
+            << "truncated\n"
+            << "ASCII\n"
+            << "DATASET POLYDATA\n"
+            << "POINTS 2 float\n"
+            << "0 0 0 1 1\n";
+  truncated.close();
+
+  ReaderType::Pointer truncatedReader = ReaderType::New();
+  truncatedReader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  truncatedReader->SetFileName( argv[1] );
+  TRY_EXPECT_EXCEPTION( truncatedReader->Update() );
+
+  // So must a value with trailing characters, which operator>> used to
+  // leave for the next read.
+  std::ofstream malformed( argv[1] );
+  malformed << "# vtk DataFile Version 2.0\n"
+            << "malformed\n"
+            << "ASCII\n"
+            << "DATASET POLYDATA\n"
+            << "POINTS 3 float\n"
+            << "0 0 0 1 0 0 0 1 0\n"
+            << "POLYGONS 1 4\n"
+            << "3 0 1 2x\n";
+  malformed.close();
+
+  ReaderType::Pointer malformedReader = ReaderType::New();
+  malformedReader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  malformedReader->SetFileName( argv[1] );
+  TRY_EXPECT_EXCEPTION( malformedReader->Update() );
+
+  if ( CheckAsciiConversion() != EXIT_SUCCESS || CheckAsciiConversionLocale() != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -265,8 +265,10 @@ ConformalFlatteningMeshFilter< TInputMesh, TOutputMesh >
   by(boundaryId1) = tmp2 * t;           // 0.0;
   by(boundaryId2) = -tmp2;              // 1.0;
 
-  CellIterator cellIterator = inputMesh->GetCells()->Begin();
-  CellIterator cellEnd      = inputMesh->GetCells()->End();
+  // Cells stored as compact arrays are read through cell objects
+  const auto inputMeshWithCells = inputMesh->GetMeshWithCellObjects();
+  CellIterator cellIterator = inputMeshWithCells->GetCells()->Begin();
+  CellIterator cellEnd      = inputMeshWithCells->GetCells()->End();
 
   PointIdentifier ptIdA;
   PointIdentifier ptIdB;
@@ -20,9 +20,9 @@
 
 #include "itkHistogram.h"
 #include "itkImageTransformer.h"
-#include "itkBarrier.h"
 #include "itkSimpleDataObjectDecorator.h"
 #include "itkProgressReporter.h"
+#include <vector>
 
 namespace itk
 {
@@ -133,13 +133,53 @@ protected:
   virtual void ThreadedComputeMinimumAndMaximum( const RegionType & inputRegionForThread, ThreadIdType threadId, ProgressReporter & progress );
   virtual void ThreadedComputeHistogram( const RegionType & inputRegionForThread, ThreadIdType threadId, ProgressReporter & progress );
 
+  /** \class BinCounter
+   * \brief Counts the measurements of a thread in the bins of its histogram.
+   *
+   * When the bins of every component are contiguous and increasing, as
+   * Histogram::Initialize() creates them, the bin of a measurement is
+   * computed from the bin width and then checked against the bin bounds,
+   * instead of searching them with Histogram::GetIndex(). Small histograms
+   * are counted in a dense array that is added to the histogram by
+   * Flush().
+   *
+   * \ingroup ITKStatistics
+   */
+  class BinCounter
+  {
+  public:
+    using InstanceIdentifier = typename HistogramType::InstanceIdentifier;
+    using AbsoluteFrequencyType = typename HistogramType::AbsoluteFrequencyType;
+
+    explicit BinCounter( HistogramType * histogram );
+
+    /** Count a measurement. Measurements outside of the bins are
+     * ignored when the histogram clips its bins at the ends. */
+    void AddMeasurement( const HistogramMeasurementVectorType & measurement );
+
+    /** Add the dense counts to the histogram. */
+    void Flush();
+
+  private:
+    HistogramType *                      m_Histogram;
+    bool                                 m_ComputeBins;
+    bool                                 m_ClipBinsAtEnds;
+    std::vector< double >                m_Origins;
+    std::vector< double >                m_InverseBinWidths;
+    std::vector< InstanceIdentifier >    m_Offsets;
+    std::vector< AbsoluteFrequencyType > m_Frequencies;
+    typename HistogramType::IndexType    m_Index;
+  };
+
   std::vector< HistogramPointer >               m_Histograms;
   std::vector< HistogramMeasurementVectorType > m_Minimums;
   std::vector< HistogramMeasurementVectorType > m_Maximums;
 
 private:
   void ApplyMarginalScale( HistogramMeasurementVectorType & min, HistogramMeasurementVectorType & max, HistogramSizeType & size );
-  typename Barrier::Pointer                     m_Barrier;
+  /** Whether the threads compute the minimum and maximum values, in the
+   * pass before the one that fills the histograms. */
+  bool                                          m_ComputeMinimumAndMaximum;
 
 };
 } // end of namespace Statistics
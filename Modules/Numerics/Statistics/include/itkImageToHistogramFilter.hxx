@@ -20,6 +20,8 @@
 
 #include "itkImageToHistogramFilter.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkMath.h"
+#include <cmath>
 
 namespace itk
 {
@@ -51,6 +53,8 @@ ImageToHistogramFilter< TImage >
     autoMinMax->Set(true);
     }
    this->ProcessObject::SetInput( "AutoMinimumMaximum", autoMinMax );
+
+  m_ComputeMinimumAndMaximum = false;
 }
 
 template< typename TImage >
@@ -116,35 +120,19 @@ ImageToHistogramFilter< TImage >
   m_Histograms.resize(nbOfThreads);
   m_Minimums.resize(nbOfThreads);
   m_Maximums.resize(nbOfThreads);
-  m_Barrier = Barrier::New();
-  m_Barrier->Initialize(nbOfThreads);
-}
-
-
-template< typename TImage >
-void
-ImageToHistogramFilter< TImage >
-::ThreadedGenerateData(const RegionType & inputRegionForThread, ThreadIdType threadId)
-{
-  long nbOfPixels = inputRegionForThread.GetNumberOfPixels();
-  if( this->GetAutoMinimumMaximumInput() && this->GetAutoMinimumMaximum() )
+  for( long t=0; t<nbOfThreads; t++ )
     {
-    // we'll have to iterate over all the pixels 2 times
-    nbOfPixels *= 2;
-    }
-  ProgressReporter progress( this, threadId, nbOfPixels );
-
-  if( threadId == 0 )
-    {
-    // just use the main one
-    m_Histograms[threadId] = this->GetOutput();
-    }
-  else
-    {
-    m_Histograms[threadId] = HistogramType::New();
+    if( t == 0 )
+      {
+      // just use the main one
+      m_Histograms[t] = this->GetOutput();
+      }
+    else
+      {
+      m_Histograms[t] = HistogramType::New();
+      }
+    m_Histograms[t]->SetClipBinsAtEnds(true);
     }
-  HistogramType * hist = m_Histograms[threadId];
-  hist->SetClipBinsAtEnds(true);
 
   // the parameter needed to initialize the histogram
   unsigned int nbOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
@@ -164,37 +152,27 @@ ImageToHistogramFilter< TImage >
 
   if( this->GetAutoMinimumMaximumInput() && this->GetAutoMinimumMaximum() )
     {
-    // we have to compute the minimum and maximum values
-    this->ThreadedComputeMinimumAndMaximum( inputRegionForThread, threadId, progress );
+    // we have to compute the minimum and maximum values in a first threaded
+    // pass, before any thread can fill its histogram
+    m_ComputeMinimumAndMaximum = true;
+    typename Superclass::ThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetNumberOfThreads( nbOfThreads );
+    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
+    m_ComputeMinimumAndMaximum = false;
 
-    // wait for the other threads to complete their part
-    m_Barrier->Wait();
-
-    // a non multithreaded part
-    if( threadId == 0 )
+    min = m_Minimums[0];
+    max = m_Maximums[0];
+    for( unsigned int t=1; t<m_Minimums.size(); t++ )
       {
-      min = m_Minimums[0];
-      max = m_Maximums[0];
-      for( unsigned int t=1; t<m_Minimums.size(); t++ )
+      for( unsigned int i=0; i<nbOfComponents; i++ )
         {
-        for( unsigned int i=0; i<nbOfComponents; i++ )
-          {
-          min[i] = std::min( min[i], m_Minimums[t][i] );
-          max[i] = std::max( max[i], m_Maximums[t][i] );
-          }
+        min[i] = std::min( min[i], m_Minimums[t][i] );
+        max[i] = std::max( max[i], m_Maximums[t][i] );
         }
-      this->ApplyMarginalScale( min, max, size );
-      // store the values so they can be retreived by the other threads
-      m_Minimums[0] = min;
-      m_Maximums[0] = max;
       }
-
-    // wait for all the threads to complete
-    m_Barrier->Wait();
-
-    // and get the values computed in the main thread
-    min = m_Minimums[0];
-    max = m_Maximums[0];
+    this->ApplyMarginalScale( min, max, size );
     }
   else
     {
@@ -217,34 +195,54 @@ ImageToHistogramFilter< TImage >
       }
     }
 
-  // finally, initialize the histogram
-  hist->SetMeasurementVectorSize( nbOfComponents );
-  hist->Initialize( size, min, max );
-
-  // now fill the histograms
-  this->ThreadedComputeHistogram( inputRegionForThread, threadId, progress );
+  // finally, initialize the histograms
+  for( long t=0; t<nbOfThreads; t++ )
+    {
+    m_Histograms[t]->SetMeasurementVectorSize( nbOfComponents );
+    m_Histograms[t]->Initialize( size, min, max );
+    }
 }
 
+template< typename TImage >
+void
+ImageToHistogramFilter< TImage >
+::ThreadedGenerateData(const RegionType & inputRegionForThread, ThreadIdType threadId)
+{
+  const SizeValueType nbOfPixels = inputRegionForThread.GetNumberOfPixels();
+  // when the minimum and maximum are computed, each pass is half of the work
+  const bool twoPasses = this->GetAutoMinimumMaximumInput() && this->GetAutoMinimumMaximum();
+  const float progressWeight = twoPasses ? 0.5f : 1.0f;
+
+  if( m_ComputeMinimumAndMaximum )
+    {
+    ProgressReporter progress( this, threadId, nbOfPixels, 100, 0.0f, progressWeight );
+    this->ThreadedComputeMinimumAndMaximum( inputRegionForThread, threadId, progress );
+    }
+  else
+    {
+    ProgressReporter progress( this, threadId, nbOfPixels, 100, 1.0f - progressWeight, progressWeight );
+    this->ThreadedComputeHistogram( inputRegionForThread, threadId, progress );
+    }
+}
 
 template< typename TImage >
 void
 ImageToHistogramFilter< TImage >
 ::AfterThreadedGenerateData()
 {
-  // group the results in the output histogram
+  // group the results in the output histogram. All the histograms share
+  // the same bins, so their frequencies can be added bin by bin.
   HistogramType * hist = m_Histograms[0];
-  typename HistogramType::IndexType index;
+  const typename HistogramType::InstanceIdentifier numberOfBins = hist->Size();
   for( unsigned int i=1; i<m_Histograms.size(); i++ )
     {
-    using HistogramIterator = typename HistogramType::ConstIterator;
-
-    HistogramIterator hit = m_Histograms[i]->Begin();
-    HistogramIterator end = m_Histograms[i]->End();
-    while ( hit != end )
+    for( typename HistogramType::InstanceIdentifier id=0; id<numberOfBins; id++ )
       {
-      hist->GetIndex( hit.GetMeasurementVector(), index);
-      hist->IncreaseFrequencyOfIndex( index, hit.GetFrequency() );
-      ++hit;
+      const typename HistogramType::AbsoluteFrequencyType frequency = m_Histograms[i]->GetFrequency( id );
+      if( frequency != 0 )
+        {
+        hist->IncreaseFrequency( id, frequency );
+        }
       }
     }
 
@@ -252,7 +250,6 @@ ImageToHistogramFilter< TImage >
   m_Histograms.clear();
   m_Minimums.clear();
   m_Maximums.clear();
-  m_Barrier = nullptr;
 }
 
 
@@ -296,17 +293,158 @@ ImageToHistogramFilter< TImage >
   ImageRegionConstIterator< TImage > inputIt( this->GetInput(), inputRegionForThread );
   inputIt.GoToBegin();
   HistogramMeasurementVectorType m( nbOfComponents );
-
-  typename HistogramType::IndexType index;
+  BinCounter counter( m_Histograms[threadId] );
   while ( !inputIt.IsAtEnd() )
     {
     const PixelType & p = inputIt.Get();
     NumericTraits<PixelType>::AssignToArray( p, m );
-    m_Histograms[threadId]->GetIndex( m, index );
-    m_Histograms[threadId]->IncreaseFrequencyOfIndex( index, 1 );
+    counter.AddMeasurement( m );
     ++inputIt;
     progress.CompletedPixel();  // potential exception thrown here
     }
+  counter.Flush();
+}
+
+template< typename TImage >
+ImageToHistogramFilter< TImage >
+::BinCounter::BinCounter( HistogramType * histogram ):
+  m_Histogram( histogram ),
+  m_ComputeBins( true ),
+  m_ClipBinsAtEnds( histogram->GetClipBinsAtEnds() )
+{
+  const unsigned int nbOfComponents = histogram->GetMeasurementVectorSize();
+  m_Origins.resize( nbOfComponents );
+  m_InverseBinWidths.resize( nbOfComponents );
+  m_Offsets.resize( nbOfComponents );
+  m_Index.SetSize( nbOfComponents );
+
+  InstanceIdentifier offset = 1;
+  for( unsigned int i=0; i<nbOfComponents; i++ )
+    {
+    const std::vector< HistogramMeasurementType > & mins = histogram->GetMins()[i];
+    const std::vector< HistogramMeasurementType > & maxs = histogram->GetMaxs()[i];
+    const SizeValueType size = histogram->GetSize( i );
+
+    m_Offsets[i] = offset;
+    offset *= size;
+
+    // the bins must partition the range in increasing order
+    if( size == 0 )
+      {
+      m_ComputeBins = false;
+      continue;
+      }
+    for( SizeValueType bin=0; bin<size; bin++ )
+      {
+      if( !( mins[bin] < maxs[bin] ) || ( bin + 1 < size && maxs[bin] != mins[bin + 1] ) )
+        {
+        m_ComputeBins = false;
+        }
+      }
+    m_Origins[i] = static_cast< double >( mins[0] );
+    m_InverseBinWidths[i] = static_cast< double >( size )
+      / ( static_cast< double >( maxs[size - 1] ) - static_cast< double >( mins[0] ) );
+    if( !std::isfinite( m_Origins[i] ) || !std::isfinite( m_InverseBinWidths[i] ) )
+      {
+      m_ComputeBins = false;
+      }
+    }
+
+  // a dense array is only worth it for small histograms
+  const InstanceIdentifier maximumNumberOfDenseBins = 65536;
+  if( histogram->Size() <= maximumNumberOfDenseBins )
+    {
+    m_Frequencies.resize( histogram->Size(), 0 );
+    }
+}
+
+template< typename TImage >
+inline void
+ImageToHistogramFilter< TImage >
+::BinCounter::AddMeasurement( const HistogramMeasurementVectorType & measurement )
+{
+  InstanceIdentifier id = 0;
+  bool computed = m_ComputeBins;
+  for( unsigned int i=0; computed && i<m_Offsets.size(); i++ )
+    {
+    const HistogramMeasurementType value = measurement[i];
+    const std::vector< HistogramMeasurementType > & mins = m_Histogram->GetMins()[i];
+    const std::vector< HistogramMeasurementType > & maxs = m_Histogram->GetMaxs()[i];
+    const auto last = static_cast< IndexValueType >( mins.size() ) - 1;
+    IndexValueType bin;
+
+    // same rules as Histogram::GetIndex() at the ends of the bins
+    if( value < mins[0] )
+      {
+      if( m_ClipBinsAtEnds )
+        {
+        return;
+        }
+      bin = 0;
+      }
+    else if( value >= maxs[last] )
+      {
+      if( m_ClipBinsAtEnds && !Math::AlmostEquals( value, maxs[last] ) )
+        {
+        return;
+        }
+      bin = last;
+      }
+    else if( value >= mins[0] )
+      {
+      bin = static_cast< IndexValueType >( ( value - m_Origins[i] ) * m_InverseBinWidths[i] );
+      bin = std::min( std::max( bin, IndexValueType( 0 ) ), last );
+      // correct the rounding of the division against the actual bounds
+      while( value < mins[bin] )
+        {
+        --bin;
+        }
+      while( value >= maxs[bin] )
+        {
+        ++bin;
+        }
+      }
+    else
+      {
+      // not a number: leave it to the histogram
+      computed = false;
+      break;
+      }
+    id += static_cast< InstanceIdentifier >( bin ) * m_Offsets[i];
+    }
+
+  if( !computed )
+    {
+    if( !m_Histogram->GetIndex( measurement, m_Index ) )
+      {
+      return;
+      }
+    id = m_Histogram->GetInstanceIdentifier( m_Index );
+    }
+
+  if( !m_Frequencies.empty() )
+    {
+    ++m_Frequencies[id];
+    }
+  else
+    {
+    m_Histogram->IncreaseFrequency( id, 1 );
+    }
+}
+
+template< typename TImage >
+void
+ImageToHistogramFilter< TImage >
+::BinCounter::Flush()
+{
+  for( InstanceIdentifier id=0; id<m_Frequencies.size(); id++ )
+    {
+    if( m_Frequencies[id] != 0 )
+      {
+      m_Histogram->IncreaseFrequency( id, m_Frequencies[id] );
+      m_Frequencies[id] = 0;
+      }
+    }
 }
 
 template< typename TImage >
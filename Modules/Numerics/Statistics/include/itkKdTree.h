@@ -18,6 +18,7 @@
 #ifndef itkKdTree_h
 #define itkKdTree_h
 
+#include <atomic>
 #include <queue>
 #include <vector>
 
@@ -25,6 +26,8 @@
 #include "itkSize.h"
 #include "itkObject.h"
 #include "itkArray.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSimpleFastMutexLock.h"
 
 #include "itkSubsample.h"
 
@@ -467,6 +470,24 @@ private:
  * GetSearchResult method returns a pointer to a NearestNeighbors object
  * with k-nearest neighbors.
  *
+ * The searches do not walk the node objects. On the first search after
+ * SetRoot or SetSample, the tree is copied into a flat array of nodes
+ * in depth-first order, with the measurement vectors of each node stored
+ * contiguously next to it. The node objects remain available through
+ * GetRoot for algorithms that need them, such as the
+ * KdTreeBasedKmeansEstimator.
+ *
+ * The Search methods are thread safe. The overloads that take a vector of
+ * query points answer all of them in one call, and split the queries
+ * between threads (SetNumberOfThreads).
+ *
+ * The k-nearest neighbor searches can be made approximate with
+ * SetErrorBound. With an error bound eps > 0, a subtree is skipped when
+ * it cannot hold a point closer than d / (1 + eps), d being the distance
+ * of the current k-th neighbor, so the i-th returned neighbor is at most
+ * (1 + eps) times farther than the true i-th nearest neighbor. The
+ * default, 0, gives exact results. The radius searches are always exact.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * 'MeasurementVectorSize'  has been removed to allow the length of a measurement
@@ -523,6 +544,11 @@ public:
 
   using InstanceIdentifierVectorType = std::vector< InstanceIdentifier >;
 
+  /** Containers of the batch searches, with one entry per query point. */
+  using MeasurementVectorListType = std::vector< MeasurementVectorType >;
+  using InstanceIdentifierVectorListType = std::vector< InstanceIdentifierVectorType >;
+  using DistanceVectorListType = std::vector< std::vector< double > >;
+
   /** \class NearestNeighbors
    * \brief data structure for storing k-nearest neighbor search result
    * (k number of Neighbors)
@@ -641,6 +667,8 @@ public:
       this->DeleteNode( this->m_Root );
       }
     this->m_Root = root;
+    this->m_SearchLayoutIsCurrent = false;
+    this->Modified();
   }
 
   /** Returns the pointer to the root node. */
@@ -684,6 +712,30 @@ public:
   void Search( const MeasurementVectorType &, double,
     InstanceIdentifierVectorType & ) const;
 
+  /** Searches the k-nearest neighbors of each query point. The queries
+   * are split between NumberOfThreads threads. */
+  void Search( const MeasurementVectorListType &, unsigned int,
+    InstanceIdentifierVectorListType & ) const;
+
+  /** Searches the k-nearest neighbors of each query point and returns
+   * their distances too. */
+  void Search( const MeasurementVectorListType &, unsigned int,
+    InstanceIdentifierVectorListType &, DistanceVectorListType & ) const;
+
+  /** Searches the neighbors fallen into a hypersphere around each query
+   * point. */
+  void Search( const MeasurementVectorListType &, double,
+    InstanceIdentifierVectorListType & ) const;
+
+  /** Set/Get the number of threads used by the batch searches. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
+  /** Set/Get the relative distance error allowed to the k-nearest
+   * neighbor searches. The default, 0, gives exact neighbors. */
+  itkSetClampMacro( ErrorBound, double, 0.0, NumericTraits< double >::max() );
+  itkGetConstMacro( ErrorBound, double );
+
   /** Returns true if the intermediate k-nearest neighbors exist within
    * the the bounding box defined by the lowerBound and the
    * upperBound. Otherwise returns false. Returns false if the ball
@@ -738,6 +790,66 @@ protected:
     InstanceIdentifierVectorType & ) const;
 
 private:
+  /** Node of the flat search layout. A terminal node owns the
+   * measurement vectors [m_Begin, m_End); a nonterminal node owns the
+   * single vector m_Begin and the children at m_Left and m_Right. */
+  struct SearchNode {
+    MeasurementType m_PartitionValue;
+    unsigned int    m_PartitionDimension;
+    bool            m_IsTerminal;
+    SizeValueType   m_Begin;
+    SizeValueType   m_End;
+    SizeValueType   m_Left;
+    SizeValueType   m_Right;
+  };
+
+  /** Index of the empty terminal node in the flat search layout */
+  static constexpr SizeValueType EmptySearchNode = NumericTraits< SizeValueType >::max();
+
+  /** Builds the flat search layout if the tree changed since the last
+   * search. */
+  void UpdateSearchLayout() const;
+
+  /** Appends the subtree of node to the flat search layout and returns
+   * the index of its root. */
+  SizeValueType AppendSearchNode( const KdTreeNodeType * ) const;
+
+  /** Returns the distance between the query point and the pointIndex-th
+   * measurement vector of the flat search layout. */
+  double SearchPointDistance( const MeasurementVectorType &, SizeValueType ) const;
+
+  /** Sets the bounds of a search to the whole measurement space. */
+  void InitializeSearchBounds( MeasurementVectorType &, MeasurementVectorType & ) const;
+
+  /** search loops on the flat search layout */
+  int NearestNeighborSearchLoop( SizeValueType, const MeasurementVectorType &,
+    MeasurementVectorType &, MeasurementVectorType &, NearestNeighbors & ) const;
+
+  int SearchLoop( SizeValueType, const MeasurementVectorType &, double,
+    MeasurementVectorType &, MeasurementVectorType &,
+    InstanceIdentifierVectorType & ) const;
+
+  struct BatchSearchStruct {
+    const Self *                       Tree;
+    const MeasurementVectorListType *  Queries;
+    unsigned int                       NumberOfNeighbors;
+    double                             Radius;
+    bool                               IsRadiusSearch;
+    InstanceIdentifierVectorListType * Results;
+    DistanceVectorListType *           Distances;
+  };
+
+  /** Runs a batch search on the threads. */
+  void BatchSearch( BatchSearchStruct & ) const;
+
+  /** Answers the queries [begin, end) of a batch search. */
+  void BatchSearchQueries( const BatchSearchStruct &, SizeValueType,
+    SizeValueType ) const;
+
+  /** Static function used as a "callback" by the MultiThreaderBase. It
+   * answers a contiguous block of the queries of a batch search. */
+  static ITK_THREAD_RETURN_TYPE BatchSearchThreaderCallback( void *arg );
+
   /** Pointer to the input sample */
   const TSample *m_Sample;
 
@@ -755,6 +867,21 @@ private:
 
   /** Measurement vector size */
   MeasurementVectorSizeType m_MeasurementVectorSize;
+
+  /** Number of threads of the batch searches */
+  ThreadIdType m_NumberOfThreads;
+
+  /** Relative distance error of the k-nearest neighbor searches */
+  double m_ErrorBound;
+
+  /** Flat search layout: nodes in depth-first order, and the instance
+   * identifiers and measurement vectors they own, in the same order. */
+  mutable std::vector< SearchNode >         m_SearchNodes;
+  mutable std::vector< InstanceIdentifier > m_SearchIdentifiers;
+  mutable std::vector< MeasurementType >    m_SearchMeasurements;
+  mutable SizeValueType                     m_SearchRoot;
+  mutable std::atomic< bool >               m_SearchLayoutIsCurrent;
+  mutable SimpleFastMutexLock               m_SearchLayoutLock;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
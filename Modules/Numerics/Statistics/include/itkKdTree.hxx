@@ -19,6 +19,7 @@
 #define itkKdTree_hxx
 
 #include "itkKdTree.h"
+#include "itkMutexLockHolder.h"
 
 namespace itk
 {
@@ -86,6 +87,10 @@ KdTree<TSample>
   this->m_Root = nullptr;
   this->m_BucketSize = 16;
   this->m_MeasurementVectorSize = 0;
+  this->m_NumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  this->m_ErrorBound = 0.0;
+  this->m_SearchRoot = EmptySearchNode;
+  this->m_SearchLayoutIsCurrent = false;
 }
 
 template<typename TSample>
@@ -127,6 +132,8 @@ KdTree<TSample>
     }
   os << indent << "MeasurementVectorSize: "
      << this->m_MeasurementVectorSize << std::endl;
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+  os << indent << "ErrorBound: " << this->m_ErrorBound << std::endl;
 }
 
 template<typename TSample>
@@ -169,9 +176,127 @@ KdTree<TSample>
   this->m_MeasurementVectorSize = this->m_Sample->GetMeasurementVectorSize();
   this->m_DistanceMetric->SetMeasurementVectorSize(
     this->m_MeasurementVectorSize );
+  this->m_SearchLayoutIsCurrent = false;
   this->Modified();
 }
 
+template<typename TSample>
+void
+KdTree<TSample>
+::UpdateSearchLayout() const
+{
+  if( this->m_SearchLayoutIsCurrent )
+    {
+    return;
+    }
+
+  MutexLockHolder< SimpleFastMutexLock > holder( this->m_SearchLayoutLock );
+  if( this->m_SearchLayoutIsCurrent )
+    {
+    return;
+    }
+
+  this->m_SearchNodes.clear();
+  this->m_SearchIdentifiers.clear();
+  this->m_SearchMeasurements.clear();
+  if( this->m_Sample != nullptr )
+    {
+    this->m_SearchIdentifiers.reserve( this->m_Sample->Size() );
+    this->m_SearchMeasurements.reserve(
+      this->m_Sample->Size() * this->m_MeasurementVectorSize );
+    }
+  this->m_SearchRoot = this->AppendSearchNode( this->m_Root );
+
+  this->m_SearchLayoutIsCurrent = true;
+}
+
+template<typename TSample>
+SizeValueType
+KdTree<TSample>
+::AppendSearchNode( const KdTreeNodeType *node ) const
+{
+  if( node == nullptr || node == this->m_EmptyTerminalNode )
+    {
+    return EmptySearchNode;
+    }
+
+  const SizeValueType nodeIndex = this->m_SearchNodes.size();
+  this->m_SearchNodes.push_back( SearchNode() );
+
+  SearchNode searchNode;
+  searchNode.m_IsTerminal = node->IsTerminal();
+  searchNode.m_PartitionDimension = 0;
+  searchNode.m_PartitionValue = NumericTraits< MeasurementType >::ZeroValue();
+  searchNode.m_Left = EmptySearchNode;
+  searchNode.m_Right = EmptySearchNode;
+  searchNode.m_Begin = this->m_SearchIdentifiers.size();
+
+  const unsigned int numberOfInstances = searchNode.m_IsTerminal ? node->Size() : 1;
+  for( unsigned int i = 0; i < numberOfInstances; ++i )
+    {
+    const InstanceIdentifier id = node->GetInstanceIdentifier( i );
+    const MeasurementVectorType & measurement =
+      this->m_Sample->GetMeasurementVector( id );
+    this->m_SearchIdentifiers.push_back( id );
+    for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+      {
+      this->m_SearchMeasurements.push_back( measurement[d] );
+      }
+    }
+  searchNode.m_End = this->m_SearchIdentifiers.size();
+
+  if( !searchNode.m_IsTerminal )
+    {
+    node->GetParameters( searchNode.m_PartitionDimension,
+      searchNode.m_PartitionValue );
+    searchNode.m_Left = this->AppendSearchNode( node->Left() );
+    searchNode.m_Right = this->AppendSearchNode( node->Right() );
+    }
+
+  this->m_SearchNodes[nodeIndex] = searchNode;
+  return nodeIndex;
+}
+
+template<typename TSample>
+inline double
+KdTree<TSample>
+::SearchPointDistance( const MeasurementVectorType & query,
+  SizeValueType pointIndex ) const
+{
+  // same arithmetic as EuclideanDistanceMetric::Evaluate
+  const MeasurementType *measurement =
+    this->m_SearchMeasurements.data() + pointIndex * this->m_MeasurementVectorSize;
+
+  double sumOfSquares = NumericTraits< double >::ZeroValue();
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    const double temp = query[d] - measurement[d];
+    sumOfSquares += temp * temp;
+    }
+  return std::sqrt( sumOfSquares );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::InitializeSearchBounds( MeasurementVectorType & lowerBound,
+  MeasurementVectorType & upperBound ) const
+{
+  NumericTraits<MeasurementVectorType>::SetLength( lowerBound,
+    this->m_MeasurementVectorSize );
+  NumericTraits<MeasurementVectorType>::SetLength( upperBound,
+    this->m_MeasurementVectorSize );
+
+  for(  unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    lowerBound[d] = static_cast< MeasurementType >( -std::sqrt(
+      -static_cast< double >( NumericTraits< MeasurementType >::
+      NonpositiveMin() ) ) / 2.0 );
+    upperBound[d] = static_cast< MeasurementType >( std::sqrt(
+      static_cast<double >( NumericTraits< MeasurementType >::max() ) / 2.0 ) );
+    }
+}
+
 template<typename TSample>
 void
 KdTree<TSample>
@@ -206,6 +331,15 @@ KdTree<TSample>
       << "the measurement vectors." );
     }
 
+  if( numberOfNeighborsRequested == 0 )
+    {
+    result.clear();
+    distances.clear();
+    return;
+    }
+
+  this->UpdateSearchLayout();
+
   /* 'distances' is the storage container used internally for the
    * NearestNeighbors class.  The 'distances' vector is modified
    * by the NearestNeighbors class.  By passing in
@@ -215,22 +349,11 @@ KdTree<TSample>
   nearestNeighbors.resize( numberOfNeighborsRequested );
 
   MeasurementVectorType lowerBound;
-  NumericTraits<MeasurementVectorType>::SetLength( lowerBound,
-    this->m_MeasurementVectorSize );
   MeasurementVectorType upperBound;
-  NumericTraits<MeasurementVectorType>::SetLength( upperBound,
-    this->m_MeasurementVectorSize );
+  this->InitializeSearchBounds( lowerBound, upperBound );
 
-  for(  unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
-    {
-    lowerBound[d] = static_cast< MeasurementType >( -std::sqrt(
-      -static_cast< double >( NumericTraits< MeasurementType >::
-      NonpositiveMin() ) ) / 2.0 );
-    upperBound[d] = static_cast< MeasurementType >( std::sqrt(
-      static_cast<double >( NumericTraits< MeasurementType >::max() ) / 2.0 ) );
-    }
-  this->NearestNeighborSearchLoop( this->m_Root, query, lowerBound, upperBound,
-    nearestNeighbors );
+  this->NearestNeighborSearchLoop( this->m_SearchRoot, query, lowerBound,
+    upperBound, nearestNeighbors );
 
   result = nearestNeighbors.GetNeighbors();
 }
@@ -358,25 +481,15 @@ KdTree<TSample>
 ::Search( const MeasurementVectorType & query, double radius,
   InstanceIdentifierVectorType & result ) const
 {
+  this->UpdateSearchLayout();
+
   MeasurementVectorType lowerBound;
   MeasurementVectorType upperBound;
-
-  NumericTraits<MeasurementVectorType>::SetLength( lowerBound,
-    this->m_MeasurementVectorSize );
-  NumericTraits<MeasurementVectorType>::SetLength( upperBound,
-    this->m_MeasurementVectorSize );
-
-  for(  unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
-    {
-    lowerBound[d] = static_cast<MeasurementType>( -std::sqrt(
-      -static_cast<double>( NumericTraits<MeasurementType>::
-      NonpositiveMin() ) ) / 2.0 );
-    upperBound[d] = static_cast< MeasurementType >( std::sqrt(
-      static_cast<double>( NumericTraits< MeasurementType >::max() ) / 2.0 ) );
-    }
+  this->InitializeSearchBounds( lowerBound, upperBound );
 
   result.clear();
-  this->SearchLoop( this->m_Root, query, radius, lowerBound, upperBound, result );
+  this->SearchLoop( this->m_SearchRoot, query, radius, lowerBound, upperBound,
+    result );
 }
 
 template<typename TSample>
@@ -486,6 +599,331 @@ KdTree<TSample>
   return 0;
 }
 
+template<typename TSample>
+int
+KdTree<TSample>
+::NearestNeighborSearchLoop( SizeValueType nodeIndex,
+  const MeasurementVectorType &query, MeasurementVectorType &lowerBound,
+  MeasurementVectorType &upperBound, NearestNeighbors &nearestNeighbors ) const
+{
+  if( nodeIndex == EmptySearchNode )
+    {
+    // empty node
+    return 0;
+    }
+
+  const SearchNode & node = this->m_SearchNodes[nodeIndex];
+  for( SizeValueType i = node.m_Begin; i < node.m_End; ++i )
+    {
+    const double tempDistance = this->SearchPointDistance( query, i );
+    if( tempDistance < nearestNeighbors.GetLargestDistance() )
+      {
+      nearestNeighbors.ReplaceFarthestNeighbor( this->m_SearchIdentifiers[i],
+        tempDistance );
+      }
+    }
+
+  // the subtrees and the rest of the tree are pruned with a radius shrunk
+  // by the error bound
+  const double errorFactor = 1.0 / ( 1.0 + this->m_ErrorBound );
+
+  if( !node.m_IsTerminal )
+    {
+    const unsigned int    partitionDimension = node.m_PartitionDimension;
+    const MeasurementType partitionValue = node.m_PartitionValue;
+    MeasurementType       tempValue;
+
+    if( query[partitionDimension] <= partitionValue )
+      {
+      // search the closer child node
+      tempValue = upperBound[partitionDimension];
+      upperBound[partitionDimension] = partitionValue;
+      if( this->NearestNeighborSearchLoop( node.m_Left, query, lowerBound,
+        upperBound, nearestNeighbors ) )
+        {
+        return 1;
+        }
+      upperBound[partitionDimension] = tempValue;
+
+      // search the other node, if necessary
+      tempValue = lowerBound[partitionDimension];
+      lowerBound[partitionDimension] = partitionValue;
+      if( this->BoundsOverlapBall( query, lowerBound, upperBound,
+        errorFactor * nearestNeighbors.GetLargestDistance() ) )
+        {
+        this->NearestNeighborSearchLoop( node.m_Right, query, lowerBound,
+          upperBound, nearestNeighbors );
+        }
+      lowerBound[partitionDimension] = tempValue;
+      }
+    else
+      {
+      // search the closer child node
+      tempValue = lowerBound[partitionDimension];
+      lowerBound[partitionDimension] = partitionValue;
+      if( this->NearestNeighborSearchLoop( node.m_Right, query, lowerBound,
+        upperBound, nearestNeighbors ) )
+        {
+        return 1;
+        }
+      lowerBound[partitionDimension] = tempValue;
+
+      // search the other node, if necessary
+      tempValue = upperBound[partitionDimension];
+      upperBound[partitionDimension] = partitionValue;
+      if( this->BoundsOverlapBall( query, lowerBound, upperBound,
+        errorFactor * nearestNeighbors.GetLargestDistance() ) )
+        {
+        this->NearestNeighborSearchLoop( node.m_Left, query, lowerBound,
+          upperBound, nearestNeighbors );
+        }
+      upperBound[partitionDimension] = tempValue;
+      }
+    }
+
+  // stop or continue search
+  if( this->BallWithinBounds( query, lowerBound, upperBound,
+    errorFactor * nearestNeighbors.GetLargestDistance() ) )
+    {
+    return 1;
+    }
+
+  return 0;
+}
+
+template<typename TSample>
+int
+KdTree<TSample>
+::SearchLoop( SizeValueType nodeIndex, const MeasurementVectorType &query,
+  double radius, MeasurementVectorType &lowerBound,
+  MeasurementVectorType &upperBound, InstanceIdentifierVectorType &neighbors ) const
+{
+  if( nodeIndex == EmptySearchNode )
+    {
+    // empty node
+    return 0;
+    }
+
+  const SearchNode & node = this->m_SearchNodes[nodeIndex];
+  for( SizeValueType i = node.m_Begin; i < node.m_End; ++i )
+    {
+    if( this->SearchPointDistance( query, i ) <= radius )
+      {
+      neighbors.push_back( this->m_SearchIdentifiers[i] );
+      }
+    }
+
+  if( !node.m_IsTerminal )
+    {
+    const unsigned int    partitionDimension = node.m_PartitionDimension;
+    const MeasurementType partitionValue = node.m_PartitionValue;
+    MeasurementType       tempValue;
+
+    if( query[partitionDimension] <= partitionValue )
+      {
+      // search the closer child node
+      tempValue = upperBound[partitionDimension];
+      upperBound[partitionDimension] = partitionValue;
+      if( this->SearchLoop( node.m_Left, query, radius, lowerBound, upperBound,
+        neighbors ) )
+        {
+        return 1;
+        }
+      upperBound[partitionDimension] = tempValue;
+
+      // search the other node, if necessary
+      tempValue = lowerBound[partitionDimension];
+      lowerBound[partitionDimension] = partitionValue;
+      if( this->BoundsOverlapBall( query, lowerBound, upperBound, radius ) )
+        {
+        this->SearchLoop( node.m_Right, query, radius, lowerBound, upperBound,
+          neighbors );
+        }
+      lowerBound[partitionDimension] = tempValue;
+      }
+    else
+      {
+      // search the closer child node
+      tempValue = lowerBound[partitionDimension];
+      lowerBound[partitionDimension] = partitionValue;
+      if( this->SearchLoop( node.m_Right, query, radius, lowerBound, upperBound,
+        neighbors ) )
+        {
+        return 1;
+        }
+      lowerBound[partitionDimension] = tempValue;
+
+      // search the other node, if necessary
+      tempValue = upperBound[partitionDimension];
+      upperBound[partitionDimension] = partitionValue;
+      if( this->BoundsOverlapBall( query, lowerBound, upperBound, radius ) )
+        {
+        this->SearchLoop( node.m_Left, query, radius, lowerBound, upperBound,
+          neighbors );
+        }
+      upperBound[partitionDimension] = tempValue;
+      }
+    }
+
+  // stop or continue search
+  if( this->BallWithinBounds( query, lowerBound, upperBound, radius ) )
+    {
+    return 1;
+    }
+
+  return 0;
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const MeasurementVectorListType & queries,
+  unsigned int numberOfNeighborsRequested,
+  InstanceIdentifierVectorListType & results ) const
+{
+  DistanceVectorListType not_used_distances;
+  this->Search( queries, numberOfNeighborsRequested, results, not_used_distances );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const MeasurementVectorListType & queries,
+  unsigned int numberOfNeighborsRequested,
+  InstanceIdentifierVectorListType & results,
+  DistanceVectorListType & distances ) const
+{
+  if( numberOfNeighborsRequested > this->Size() )
+    {
+    itkExceptionMacro( "The numberOfNeighborsRequested for the nearest "
+      << "neighbor search should be less than or equal to the number of "
+      << "the measurement vectors." );
+    }
+
+  BatchSearchStruct str;
+  str.Tree = this;
+  str.Queries = &queries;
+  str.NumberOfNeighbors = numberOfNeighborsRequested;
+  str.Radius = 0.0;
+  str.IsRadiusSearch = false;
+  str.Results = &results;
+  str.Distances = &distances;
+  this->BatchSearch( str );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const MeasurementVectorListType & queries, double radius,
+  InstanceIdentifierVectorListType & results ) const
+{
+  BatchSearchStruct str;
+  str.Tree = this;
+  str.Queries = &queries;
+  str.NumberOfNeighbors = 0;
+  str.Radius = radius;
+  str.IsRadiusSearch = true;
+  str.Results = &results;
+  str.Distances = nullptr;
+  this->BatchSearch( str );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::BatchSearch( BatchSearchStruct & str ) const
+{
+  this->UpdateSearchLayout();
+
+  const SizeValueType numberOfQueries = str.Queries->size();
+  str.Results->resize( numberOfQueries );
+  if( str.Distances != nullptr )
+    {
+    str.Distances->resize( numberOfQueries );
+    }
+  if( numberOfQueries == 0 )
+    {
+    return;
+    }
+
+  // a few hundred queries per thread at least
+  const SizeValueType minimumQueriesPerThread = 256;
+  const auto numberOfThreads = static_cast< ThreadIdType >( std::max< SizeValueType >( 1,
+    std::min< SizeValueType >( this->m_NumberOfThreads,
+    numberOfQueries / minimumQueriesPerThread ) ) );
+
+  if( numberOfThreads == 1 )
+    {
+    this->BatchSearchQueries( str, 0, numberOfQueries );
+    return;
+    }
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( Self::BatchSearchThreaderCallback, &str );
+  threader->SingleMethodExecute();
+}
+
+template<typename TSample>
+ITK_THREAD_RETURN_TYPE
+KdTree<TSample>
+::BatchSearchThreaderCallback( void *arg )
+{
+  auto * threadInfo = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  const ThreadIdType threadId = threadInfo->ThreadID;
+  const ThreadIdType numberOfThreads = threadInfo->NumberOfThreads;
+  const BatchSearchStruct & str =
+    *static_cast< BatchSearchStruct * >( threadInfo->UserData );
+
+  const SizeValueType numberOfQueries = str.Queries->size();
+  str.Tree->BatchSearchQueries( str,
+    numberOfQueries * threadId / numberOfThreads,
+    numberOfQueries * ( threadId + 1 ) / numberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::BatchSearchQueries( const BatchSearchStruct & str, SizeValueType begin,
+  SizeValueType end ) const
+{
+  // the buffers of the thread are reused by all its queries
+  MeasurementVectorType lowerBound;
+  MeasurementVectorType upperBound;
+  std::vector< double > distances;
+  NearestNeighbors      nearestNeighbors( distances );
+
+  for( SizeValueType q = begin; q < end; ++q )
+    {
+    const MeasurementVectorType & query = ( *str.Queries )[q];
+    InstanceIdentifierVectorType & result = ( *str.Results )[q];
+    this->InitializeSearchBounds( lowerBound, upperBound );
+
+    if( str.IsRadiusSearch )
+      {
+      result.clear();
+      this->SearchLoop( this->m_SearchRoot, query, str.Radius, lowerBound,
+        upperBound, result );
+      continue;
+      }
+
+    if( str.NumberOfNeighbors == 0 )
+      {
+      result.clear();
+      ( *str.Distances )[q].clear();
+      continue;
+      }
+    nearestNeighbors.resize( str.NumberOfNeighbors );
+    this->NearestNeighborSearchLoop( this->m_SearchRoot, query, lowerBound,
+      upperBound, nearestNeighbors );
+    result.assign( nearestNeighbors.GetNeighbors().begin(),
+      nearestNeighbors.GetNeighbors().end() );
+    ( *str.Distances )[q].assign( distances.begin(), distances.end() );
+    }
+}
+
 template<typename TSample>
 inline bool
 KdTree<TSample>
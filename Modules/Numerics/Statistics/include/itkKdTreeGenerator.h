@@ -18,9 +18,11 @@
 #ifndef itkKdTreeGenerator_h
 #define itkKdTreeGenerator_h
 
+#include <map>
 #include <vector>
 
 #include "itkKdTree.h"
+#include "itkMultiThreaderBase.h"
 #include "itkStatisticsAlgorithm.h"
 
 namespace itk
@@ -51,6 +53,14 @@ namespace Statistics
  * Update method will run this generator. To get the resulting KdTree
  * object, call the GetOutput method.
  *
+ * The measurement vectors are copied once from the sample before the
+ * partitioning starts, so the sample is never read concurrently. Large
+ * samples are built in parallel: the top levels of the tree are
+ * partitioned first, then the subtrees below them are generated on
+ * separate threads (SetNumberOfThreads). The split into subtrees only
+ * depends on the sample size, and the generated tree is the same for any
+ * number of threads.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * 'MeasurementVectorSize'  has been removed to allow the length of a measurement
@@ -131,6 +141,16 @@ public:
   /** Runs this k-d tree construction algorithm. */
   void GenerateData();
 
+  /** Set/Get the number of threads used to generate the subtrees. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Get the multithreader used to generate the subtrees. */
+  MultiThreaderBase * GetMultiThreader()
+  {
+    return m_Threader;
+  }
+
   /** Get macro to get the length of the measurement vectors that are being
    * held in the 'sample' that is passed to this class */
   itkGetConstMacro(MeasurementVectorSize, unsigned int);
@@ -150,6 +170,88 @@ protected:
     return m_Subsample;
   }
 
+  /** \class PartitionSample
+   * \brief Copy of the subsample that is partitioned during the tree
+   * generation.
+   *
+   * It provides the part of the Subsample interface used by the
+   * Statistics algorithms (GetMeasurementVectorByIndex, Swap, ...). The
+   * measurement vectors and frequencies are read once from the sample, so
+   * disjoint index ranges can be partitioned by different threads.
+   * \ingroup ITKStatistics
+   */
+  class PartitionSample
+  {
+  public:
+    using MeasurementVectorType = typename TSample::MeasurementVectorType;
+    using MeasurementType = typename TSample::MeasurementType;
+    using MeasurementVectorSizeType = unsigned int;
+    using InstanceIdentifier = typename TSample::InstanceIdentifier;
+    using AbsoluteFrequencyType = typename TSample::AbsoluteFrequencyType;
+
+    /** Copies the instances of the subsample in their current order. */
+    void Initialize(SubsampleType *subsample);
+
+    /** Releases the copied measurement vectors. */
+    void Clear();
+
+    MeasurementVectorSizeType GetMeasurementVectorSize() const
+    {
+      return m_MeasurementVectorSize;
+    }
+
+    SizeValueType Size() const
+    {
+      return static_cast< SizeValueType >( m_Order.size() );
+    }
+
+    const MeasurementVectorType & GetMeasurementVectorByIndex(unsigned int index) const
+    {
+      return m_MeasurementVectors[m_Order[index]];
+    }
+
+    AbsoluteFrequencyType GetFrequencyByIndex(unsigned int index) const
+    {
+      return m_Frequencies[m_Order[index]];
+    }
+
+    InstanceIdentifier GetInstanceIdentifier(unsigned int index) const
+    {
+      return m_InstanceIdentifiers[m_Order[index]];
+    }
+
+    void Swap(unsigned int index1, unsigned int index2)
+    {
+      std::swap(m_Order[index1], m_Order[index2]);
+    }
+
+  private:
+    MeasurementVectorSizeType            m_MeasurementVectorSize{ 0 };
+    std::vector< MeasurementVectorType > m_MeasurementVectors;
+    std::vector< AbsoluteFrequencyType > m_Frequencies;
+    std::vector< InstanceIdentifier >    m_InstanceIdentifiers;
+    std::vector< unsigned int >          m_Order;
+  };
+
+  /** Returns the copy of the subsample that is being partitioned. The
+   * node generation routines read the measurement vectors from it instead
+   * of the subsample. */
+  PartitionSample * GetPartitionSample()
+  {
+    return &m_PartitionSample;
+  }
+
+  /** Finds the most widely spread dimension of the instances in
+   * [beginIndex, endIndex) and moves their median along it to
+   * medianIndex. The top levels of a parallel generation are partitioned
+   * only once; the result is remembered and reused when the tree is
+   * assembled. */
+  void PartitionInstances(unsigned int beginIndex,
+                          unsigned int endIndex,
+                          unsigned int & partitionDimension,
+                          MeasurementType & partitionValue,
+                          unsigned int & medianIndex);
+
   /** Nonterminal node generation routine */
   virtual KdTreeNodeType * GenerateNonterminalNode(unsigned int beginIndex,
                                                    unsigned int endIndex,
@@ -181,17 +283,50 @@ private:
   /** Pointer to the resulting k-d tree. */
   OutputPointer m_Tree;
 
-  /** Temporary lower bound for the TreeGenerationLoop */
-  MeasurementVectorType m_TempLowerBound;
-
-  /** Temporary upper bound for the TreeGenerationLoop */
-  MeasurementVectorType m_TempUpperBound;
-
-  /** Temporary mean for the TreeGenerationLoop */
-  MeasurementVectorType m_TempMean;
+  /** Copy of the subsample partitioned by the generation routines. */
+  PartitionSample m_PartitionSample;
 
   /** Length of a measurement vector */
   MeasurementVectorSizeType m_MeasurementVectorSize;
+
+  /** Stages of a parallel generation. Serial generates whole subtrees;
+   * Plan partitions the top levels and records the subtrees below them
+   * as tasks; Assemble links the generated tasks under the top levels. */
+  enum GenerationStageType { SerialStage, PlanStage, AssembleStage };
+
+  using IndexRangeType = std::pair< unsigned int, unsigned int >;
+
+  struct PartitionType {
+    unsigned int    m_PartitionDimension;
+    MeasurementType m_PartitionValue;
+    unsigned int    m_MedianIndex;
+  };
+
+  struct SubtreeTaskType {
+    unsigned int          m_BeginIndex;
+    unsigned int          m_EndIndex;
+    MeasurementVectorType m_LowerBound;
+    MeasurementVectorType m_UpperBound;
+    unsigned int          m_Level;
+    KdTreeNodeType *      m_Node;
+  };
+
+  struct ThreadStruct {
+    Self * Generator;
+  };
+
+  /** Static function used as a "callback" by the MultiThreaderBase. It
+   * generates every NumberOfThreads-th subtree task. */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+
+  GenerationStageType                          m_GenerationStage;
+  std::map< IndexRangeType, PartitionType >    m_Partitions;
+  std::map< IndexRangeType, SizeValueType >    m_SubtreeTaskIndices;
+  std::vector< SubtreeTaskType >               m_SubtreeTasks;
+  unsigned int                                 m_SubtreeTaskSize;
+
+  ThreadIdType               m_NumberOfThreads;
+  MultiThreaderBase::Pointer m_Threader;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
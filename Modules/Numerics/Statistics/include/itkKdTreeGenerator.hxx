@@ -32,6 +32,10 @@ KdTreeGenerator< TSample >
   m_BucketSize = 16;
   m_Subsample = SubsampleType::New();
   m_MeasurementVectorSize = 0;
+  m_GenerationStage = SerialStage;
+  m_SubtreeTaskSize = 0;
+  m_Threader = MultiThreaderBase::New();
+  m_NumberOfThreads = m_Threader->GetNumberOfThreads();
 }
 
 template< typename TSample >
@@ -54,6 +58,7 @@ KdTreeGenerator< TSample >
   os << indent << "Bucket Size: " << m_BucketSize << std::endl;
   os << indent << "MeasurementVectorSize: "
      << m_MeasurementVectorSize << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
 }
 
 template< typename TSample >
@@ -65,9 +70,6 @@ KdTreeGenerator< TSample >
   m_Subsample->SetSample(sample);
   m_Subsample->InitializeWithAllInstances();
   m_MeasurementVectorSize = sample->GetMeasurementVectorSize();
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempLowerBound, m_MeasurementVectorSize);
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempUpperBound, m_MeasurementVectorSize);
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempMean, m_MeasurementVectorSize);
 }
 
 template< typename TSample >
@@ -115,42 +117,112 @@ KdTreeGenerator< TSample >
     upperBound[d] = NumericTraits< MeasurementType >::max();
     }
 
-  KdTreeNodeType *root =
-    this->GenerateTreeLoop(0, m_Subsample->Size(), lowerBound, upperBound, 0);
+  m_PartitionSample.Initialize(subsample);
+  const auto numberOfInstances = static_cast< unsigned int >( m_PartitionSample.Size() );
+
+  // The subtree tasks are chosen from the sample size alone, so that the
+  // tree does not depend on the number of threads.
+  constexpr unsigned int MinimumSubtreeTaskSize = 4096;
+  m_SubtreeTaskSize = std::max( numberOfInstances / 64, MinimumSubtreeTaskSize );
+
+  KdTreeNodeType *root;
+  if ( numberOfInstances <= m_SubtreeTaskSize )
+    {
+    m_GenerationStage = SerialStage;
+    root = this->GenerateTreeLoop(0, numberOfInstances, lowerBound, upperBound, 0);
+    }
+  else
+    {
+    // Partition the top levels and collect the subtrees below them. The
+    // nodes of this pass are discarded; its partitions are reused below.
+    m_GenerationStage = PlanStage;
+    KdTreeNodeType *plan =
+      this->GenerateTreeLoop(0, numberOfInstances, lowerBound, upperBound, 0);
+    m_Tree->DeleteNode(plan);
+
+    m_GenerationStage = SerialStage;
+    ThreadStruct str;
+    str.Generator = this;
+    const auto numberOfTasks = static_cast< ThreadIdType >( m_SubtreeTasks.size() );
+    m_Threader->SetNumberOfThreads( std::min( m_NumberOfThreads, numberOfTasks ) );
+    m_Threader->SetSingleMethod(Self::ThreaderCallback, &str);
+    m_Threader->SingleMethodExecute();
+
+    m_GenerationStage = AssembleStage;
+    root = this->GenerateTreeLoop(0, numberOfInstances, lowerBound, upperBound, 0);
+    m_GenerationStage = SerialStage;
+    }
+
+  m_Partitions.clear();
+  m_SubtreeTaskIndices.clear();
+  m_SubtreeTasks.clear();
+  m_PartitionSample.Clear();
+
   m_Tree->SetRoot(root);
 }
 
 template< typename TSample >
-inline typename KdTreeGenerator< TSample >::KdTreeNodeType *
+ITK_THREAD_RETURN_TYPE
 KdTreeGenerator< TSample >
-::GenerateNonterminalNode(unsigned int beginIndex,
-                          unsigned int endIndex,
-                          MeasurementVectorType & lowerBound,
-                          MeasurementVectorType & upperBound,
-                          unsigned int level)
+::ThreaderCallback(void *arg)
 {
-  using NodeType = typename KdTreeType::KdTreeNodeType;
-  MeasurementType dimensionLowerBound;
-  MeasurementType dimensionUpperBound;
-  MeasurementType partitionValue;
-  unsigned int    partitionDimension = 0;
-  unsigned int    i;
-  MeasurementType spread;
-  MeasurementType maxSpread;
-  unsigned int    medianIndex;
+  auto * threadInfo = static_cast< MultiThreaderBase::ThreadInfoStruct * >( arg );
+  const ThreadIdType threadId = threadInfo->ThreadID;
+  const ThreadIdType numberOfThreads = threadInfo->NumberOfThreads;
+  Self *generator = static_cast< ThreadStruct * >( threadInfo->UserData )->Generator;
 
-  SubsamplePointer subsample = this->GetSubsample();
+  for ( SizeValueType i = threadId; i < generator->m_SubtreeTasks.size(); i += numberOfThreads )
+    {
+    SubtreeTaskType & task = generator->m_SubtreeTasks[i];
+    task.m_Node = generator->GenerateTreeLoop(task.m_BeginIndex, task.m_EndIndex,
+                                              task.m_LowerBound, task.m_UpperBound,
+                                              task.m_Level);
+    }
 
-  // find most widely spread dimension
-  Algorithm::FindSampleBoundAndMean< SubsampleType >(subsample,
-                                                     beginIndex, endIndex,
-                                                     m_TempLowerBound, m_TempUpperBound,
-                                                     m_TempMean);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+KdTreeGenerator< TSample >
+::PartitionInstances(unsigned int beginIndex,
+                     unsigned int endIndex,
+                     unsigned int & partitionDimension,
+                     MeasurementType & partitionValue,
+                     unsigned int & medianIndex)
+{
+  const IndexRangeType range(beginIndex, endIndex);
+  if ( m_GenerationStage == AssembleStage )
+    {
+    const typename std::map< IndexRangeType, PartitionType >::const_iterator it =
+      m_Partitions.find(range);
+    if ( it != m_Partitions.end() )
+      {
+      partitionDimension = it->second.m_PartitionDimension;
+      partitionValue = it->second.m_PartitionValue;
+      medianIndex = it->second.m_MedianIndex;
+      return;
+      }
+    }
+
+  MeasurementVectorType tempLowerBound;
+  MeasurementVectorType tempUpperBound;
+  MeasurementVectorType tempMean;
+  NumericTraits<MeasurementVectorType>::SetLength(tempLowerBound, m_MeasurementVectorSize);
+  NumericTraits<MeasurementVectorType>::SetLength(tempUpperBound, m_MeasurementVectorSize);
+  NumericTraits<MeasurementVectorType>::SetLength(tempMean, m_MeasurementVectorSize);
 
-  maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
-  for ( i = 0; i < m_MeasurementVectorSize; i++ )
+  // find most widely spread dimension
+  Algorithm::FindSampleBoundAndMean< PartitionSample >(&m_PartitionSample,
+                                                       beginIndex, endIndex,
+                                                       tempLowerBound, tempUpperBound,
+                                                       tempMean);
+
+  partitionDimension = 0;
+  MeasurementType maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
+  for ( unsigned int i = 0; i < m_MeasurementVectorSize; i++ )
     {
-    spread = m_TempUpperBound[i] - m_TempLowerBound[i];
+    const MeasurementType spread = tempUpperBound[i] - tempLowerBound[i];
     if ( spread >= maxSpread )
       {
       maxSpread = spread;
@@ -165,13 +237,41 @@ KdTreeGenerator< TSample >
   // based on the STL implementation of the QuickSelect algorithm.
   //
   partitionValue =
-    Algorithm::NthElement< SubsampleType >(m_Subsample,
-                                           partitionDimension,
-                                           beginIndex, endIndex,
-                                           medianIndex);
+    Algorithm::NthElement< PartitionSample >(&m_PartitionSample,
+                                             partitionDimension,
+                                             beginIndex, endIndex,
+                                             medianIndex);
 
   medianIndex += beginIndex;
 
+  if ( m_GenerationStage == PlanStage )
+    {
+    PartitionType & partition = m_Partitions[range];
+    partition.m_PartitionDimension = partitionDimension;
+    partition.m_PartitionValue = partitionValue;
+    partition.m_MedianIndex = medianIndex;
+    }
+}
+
+template< typename TSample >
+inline typename KdTreeGenerator< TSample >::KdTreeNodeType *
+KdTreeGenerator< TSample >
+::GenerateNonterminalNode(unsigned int beginIndex,
+                          unsigned int endIndex,
+                          MeasurementVectorType & lowerBound,
+                          MeasurementVectorType & upperBound,
+                          unsigned int level)
+{
+  using NodeType = typename KdTreeType::KdTreeNodeType;
+  MeasurementType dimensionLowerBound;
+  MeasurementType dimensionUpperBound;
+  MeasurementType partitionValue;
+  unsigned int    partitionDimension;
+  unsigned int    medianIndex;
+
+  this->PartitionInstances(beginIndex, endIndex,
+                           partitionDimension, partitionValue, medianIndex);
+
   // save bounds for cutting dimension
   dimensionLowerBound = lowerBound[partitionDimension];
   dimensionUpperBound = upperBound[partitionDimension];
@@ -196,7 +296,7 @@ KdTreeGenerator< TSample >
                                   right);
 
   nonTerminalNode->AddInstanceIdentifier(
-    subsample->GetInstanceIdentifier(medianIndex) );
+    m_PartitionSample.GetInstanceIdentifier(medianIndex) );
 
   return nonTerminalNode;
 }
@@ -225,19 +325,72 @@ KdTreeGenerator< TSample >
       for ( unsigned int j = beginIndex; j < endIndex; j++ )
         {
         ptr->AddInstanceIdentifier(
-          this->GetSubsample()->GetInstanceIdentifier(j) );
+          m_PartitionSample.GetInstanceIdentifier(j) );
         }
 
       // return a terminal node
       return ptr;
       }
     }
+  else if ( m_GenerationStage != SerialStage
+            && endIndex - beginIndex <= m_SubtreeTaskSize )
+    {
+    const IndexRangeType range(beginIndex, endIndex);
+    if ( m_GenerationStage == PlanStage )
+      {
+      // record the subtree for a thread and leave an empty placeholder
+      SubtreeTaskType task;
+      task.m_BeginIndex = beginIndex;
+      task.m_EndIndex = endIndex;
+      task.m_LowerBound = lowerBound;
+      task.m_UpperBound = upperBound;
+      task.m_Level = level;
+      task.m_Node = nullptr;
+      m_SubtreeTaskIndices[range] = m_SubtreeTasks.size();
+      m_SubtreeTasks.push_back(task);
+      return m_Tree->GetEmptyTerminalNode();
+      }
+    // return the subtree generated by a thread
+    return m_SubtreeTasks[m_SubtreeTaskIndices[range]].m_Node;
+    }
   else
     {
     return this->GenerateNonterminalNode(beginIndex, endIndex,
                                          lowerBound, upperBound, level + 1);
     }
 }
+
+template< typename TSample >
+void
+KdTreeGenerator< TSample >::PartitionSample
+::Initialize(SubsampleType *subsample)
+{
+  const auto size = static_cast< unsigned int >( subsample->Size() );
+
+  m_MeasurementVectorSize = subsample->GetMeasurementVectorSize();
+  m_MeasurementVectors.resize(size);
+  m_Frequencies.resize(size);
+  m_InstanceIdentifiers.resize(size);
+  m_Order.resize(size);
+  for ( unsigned int i = 0; i < size; i++ )
+    {
+    m_MeasurementVectors[i] = subsample->GetMeasurementVectorByIndex(i);
+    m_Frequencies[i] = subsample->GetFrequencyByIndex(i);
+    m_InstanceIdentifiers[i] = subsample->GetInstanceIdentifier(i);
+    m_Order[i] = i;
+    }
+}
+
+template< typename TSample >
+void
+KdTreeGenerator< TSample >::PartitionSample
+::Clear()
+{
+  std::vector< MeasurementVectorType >().swap(m_MeasurementVectors);
+  std::vector< AbsoluteFrequencyType >().swap(m_Frequencies);
+  std::vector< InstanceIdentifier >().swap(m_InstanceIdentifiers);
+  std::vector< unsigned int >().swap(m_Order);
+}
 } // end of namespace Statistics
 } // end of namespace itk
 
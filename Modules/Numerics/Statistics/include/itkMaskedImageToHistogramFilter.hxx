@@ -86,20 +86,20 @@ MaskedImageToHistogramFilter< TImage, TMaskImage >
   HistogramMeasurementVectorType m( nbOfComponents );
   MaskPixelType maskValue = this->GetMaskValue();
 
-  typename HistogramType::IndexType index;
+  typename Superclass::BinCounter counter( this->m_Histograms[threadId] );
   while ( !inputIt.IsAtEnd() )
     {
     if( maskIt.Get() == maskValue )
       {
       const PixelType & p = inputIt.Get();
       NumericTraits<PixelType>::AssignToArray( p, m );
-      this->m_Histograms[threadId]->GetIndex( m, index );
-      this->m_Histograms[threadId]->IncreaseFrequencyOfIndex( index, 1 );
+      counter.AddMeasurement( m );
       }
     ++inputIt;
     ++maskIt;
     progress.CompletedPixel();  // potential exception thrown here
     }
+  counter.Flush();
 }
 
 } // end of namespace Statistics
@@ -106,11 +106,6 @@ protected:
                                                    MeasurementVectorType
                                                    & upperBound,
                                                    unsigned int level) override;
-
-private:
-  MeasurementVectorType m_TempLowerBound;
-  MeasurementVectorType m_TempUpperBound;
-  MeasurementVectorType m_TempMean;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
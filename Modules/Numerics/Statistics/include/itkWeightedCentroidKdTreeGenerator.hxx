@@ -49,18 +49,16 @@ WeightedCentroidKdTreeGenerator< TSample >
   MeasurementType dimensionLowerBound;
   MeasurementType dimensionUpperBound;
   MeasurementType partitionValue;
-  unsigned int    partitionDimension = 0;
+  unsigned int    partitionDimension;
   unsigned int    i;
   unsigned int    j;
-  MeasurementType spread;
-  MeasurementType maxSpread;
   unsigned int    medianIndex;
 
-  SubsamplePointer subsample = this->GetSubsample();
+  typename Superclass::PartitionSample *partitionSample = this->GetPartitionSample();
 
   // Sanity check. Verify that the subsample has measurement vectors of the
   // same length as the sample generated by the tree.
-  if ( this->GetMeasurementVectorSize() != subsample->GetMeasurementVectorSize() )
+  if ( this->GetMeasurementVectorSize() != partitionSample->GetMeasurementVectorSize() )
     {
     itkExceptionMacro(<< "Measurement Vector Length mismatch");
     }
@@ -70,48 +68,19 @@ WeightedCentroidKdTreeGenerator< TSample >
   typename KdTreeNodeType::CentroidType weightedCentroid;
   NumericTraits<typename KdTreeNodeType::CentroidType>::SetLength( weightedCentroid,
     this->GetMeasurementVectorSize() );
-  MeasurementVectorType tempVector;
   weightedCentroid.Fill(NumericTraits< MeasurementType >::ZeroValue());
 
   for ( i = beginIndex; i < endIndex; i++ )
     {
-    tempVector = subsample->GetMeasurementVectorByIndex(i);
+    const MeasurementVectorType & tempVector = partitionSample->GetMeasurementVectorByIndex(i);
     for ( j = 0; j < this->GetMeasurementVectorSize(); j++ )
       {
       weightedCentroid[j] += tempVector[j];
       }
     }
 
-  // find most widely spread dimension
-  Algorithm::FindSampleBoundAndMean< SubsampleType >(this->GetSubsample(),
-                                                     beginIndex, endIndex,
-                                                     m_TempLowerBound, m_TempUpperBound,
-                                                     m_TempMean);
-
-  maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
-  for ( i = 0; i < this->GetMeasurementVectorSize(); i++ )
-    {
-    spread = m_TempUpperBound[i] - m_TempLowerBound[i];
-    if ( spread >= maxSpread )
-      {
-      maxSpread = spread;
-      partitionDimension = i;
-      }
-    }
-
-  medianIndex = ( endIndex - beginIndex ) / 2;
-
-  //
-  // Find the medial element by using the NthElement function
-  // based on the STL implementation of the QuickSelect algorithm.
-  //
-  partitionValue =
-    Algorithm::NthElement< SubsampleType >(this->GetSubsample(),
-                                           partitionDimension,
-                                           beginIndex, endIndex,
-                                           medianIndex);
-
-  medianIndex += beginIndex;
+  this->PartitionInstances(beginIndex, endIndex,
+                           partitionDimension, partitionValue, medianIndex);
 
   // save bounds for cutting dimension
   dimensionLowerBound = lowerBound[partitionDimension];
@@ -138,7 +107,7 @@ WeightedCentroidKdTreeGenerator< TSample >
                                   endIndex - beginIndex);
 
   nonTerminalNode->AddInstanceIdentifier(
-    subsample->GetInstanceIdentifier(medianIndex) );
+    partitionSample->GetInstanceIdentifier(medianIndex) );
 
   return nonTerminalNode;
 }
@@ -0,0 +1,256 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkVectorContainerToListSampleAdaptor.h"
+#include "itkWeightedCentroidKdTreeGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PointType = itk::Point< float, 3 >;
+using PointsContainerType = itk::VectorContainer< itk::IdentifierType, PointType >;
+using SampleType = itk::Statistics::VectorContainerToListSampleAdaptor< PointsContainerType >;
+using TreeGeneratorType = itk::Statistics::KdTreeGenerator< SampleType >;
+using CentroidTreeGeneratorType = itk::Statistics::WeightedCentroidKdTreeGenerator< SampleType >;
+using TreeType = TreeGeneratorType::KdTreeType;
+using NodeType = TreeType::KdTreeNodeType;
+
+// Compares two trees node by node, centroids included.
+bool
+SameTree( NodeType *node1, const NodeType *empty1, NodeType *node2, const NodeType *empty2 )
+{
+  if( ( node1 == empty1 ) != ( node2 == empty2 ) )
+    {
+    return false;
+    }
+  if( node1 == empty1 )
+    {
+    return true;
+    }
+  if( node1->IsTerminal() != node2->IsTerminal() || node1->Size() != node2->Size() )
+    {
+    return false;
+    }
+  if( node1->IsTerminal() )
+    {
+    for( unsigned int i = 0; i < node1->Size(); ++i )
+      {
+      if( node1->GetInstanceIdentifier( i ) != node2->GetInstanceIdentifier( i ) )
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  unsigned int dimension1, dimension2;
+  float        value1, value2;
+  node1->GetParameters( dimension1, value1 );
+  node2->GetParameters( dimension2, value2 );
+  NodeType::CentroidType centroid1, centroid2;
+  node1->GetWeightedCentroid( centroid1 );
+  node2->GetWeightedCentroid( centroid2 );
+  if( dimension1 != dimension2 || value1 != value2 || centroid1 != centroid2
+      || node1->GetInstanceIdentifier( 0 ) != node2->GetInstanceIdentifier( 0 ) )
+    {
+    return false;
+    }
+  return SameTree( node1->Left(), empty1, node2->Left(), empty2 )
+    && SameTree( node1->Right(), empty1, node2->Right(), empty2 );
+}
+
+template< typename TGenerator >
+TreeType::Pointer
+GenerateTree( SampleType *sample, itk::ThreadIdType numberOfThreads )
+{
+  typename TGenerator::Pointer generator = TGenerator::New();
+  generator->SetSample( sample );
+  generator->SetBucketSize( 16 );
+  generator->SetNumberOfThreads( numberOfThreads );
+  generator->Update();
+  return generator->GetOutput();
+}
+}
+
+int itkKdTreeBatchSearchTest( int, char * [] )
+{
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::New();
+  randomNumberGenerator->SetSeed( 1234 );
+
+  // Points on a grid of spacing 0.5, so that many of them share their
+  // coordinates. The sample is larger than one subtree of the parallel
+  // generation.
+  constexpr unsigned int numberOfPoints = 20000;
+  PointsContainerType::Pointer points = PointsContainerType::New();
+  points->Reserve( numberOfPoints );
+  for( unsigned int i = 0; i < numberOfPoints; ++i )
+    {
+    PointType & point = points->ElementAt( i );
+    for( unsigned int d = 0; d < 3; ++d )
+      {
+      point[d] = std::floor( randomNumberGenerator->GetUniformVariate( 0.0, 60.0 ) ) * 0.5f;
+      }
+    }
+
+  SampleType::Pointer sample = SampleType::New();
+  sample->SetVectorContainer( points );
+  sample->SetMeasurementVectorSize( 3 );
+
+  //
+  // The generated trees do not depend on the number of threads.
+  //
+  TreeType::Pointer tree = GenerateTree< TreeGeneratorType >( sample, 1 );
+  TreeType::Pointer tree4 = GenerateTree< TreeGeneratorType >( sample, 4 );
+  TEST_EXPECT_TRUE( SameTree( tree->GetRoot(), tree->GetEmptyTerminalNode(),
+    tree4->GetRoot(), tree4->GetEmptyTerminalNode() ) );
+
+  TreeType::Pointer centroidTree = GenerateTree< CentroidTreeGeneratorType >( sample, 1 );
+  TreeType::Pointer centroidTree4 = GenerateTree< CentroidTreeGeneratorType >( sample, 4 );
+  TEST_EXPECT_TRUE( SameTree( centroidTree->GetRoot(), centroidTree->GetEmptyTerminalNode(),
+    centroidTree4->GetRoot(), centroidTree4->GetEmptyTerminalNode() ) );
+
+  //
+  // The batch searches return the results of the single searches.
+  //
+  TreeType::MeasurementVectorListType queries( 2000 );
+  for( auto & query : queries )
+    {
+    for( unsigned int d = 0; d < 3; ++d )
+      {
+      query[d] = randomNumberGenerator->GetUniformVariate( -2.0, 32.0 );
+      }
+    }
+  // a few queries on the sample points themselves
+  for( unsigned int q = 0; q < 100; ++q )
+    {
+    queries[q] = sample->GetMeasurementVector( q * 7 );
+    }
+
+  constexpr unsigned int numberOfNeighbors = 6;
+  constexpr double       radius = 1.5;
+
+  int status = EXIT_SUCCESS;
+  for( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads *= 2 )
+    {
+    tree->SetNumberOfThreads( numberOfThreads );
+
+    TreeType::InstanceIdentifierVectorListType neighborsList;
+    TreeType::DistanceVectorListType           distancesList;
+    tree->Search( queries, numberOfNeighbors, neighborsList, distancesList );
+    TreeType::InstanceIdentifierVectorListType radiusNeighborsList;
+    tree->Search( queries, radius, radiusNeighborsList );
+
+    TEST_EXPECT_EQUAL( neighborsList.size(), queries.size() );
+    TEST_EXPECT_EQUAL( radiusNeighborsList.size(), queries.size() );
+
+    for( unsigned int q = 0; q < queries.size(); ++q )
+      {
+      TreeType::InstanceIdentifierVectorType neighbors;
+      std::vector< double >                  distances;
+      tree->Search( queries[q], numberOfNeighbors, neighbors, distances );
+      TreeType::InstanceIdentifierVectorType radiusNeighbors;
+      tree->Search( queries[q], radius, radiusNeighbors );
+
+      if( neighbors != neighborsList[q] || distances != distancesList[q]
+          || radiusNeighbors != radiusNeighborsList[q] )
+        {
+        std::cerr << "Batch search with " << numberOfThreads
+                  << " threads differs from the single search of query " << q
+                  << std::endl;
+        status = EXIT_FAILURE;
+        }
+
+      // check the single searches against a linear scan
+      if( q % 50 == 0 )
+        {
+        std::vector< double > bruteForceDistances;
+        unsigned int          numberInRadius = 0;
+        for( unsigned int i = 0; i < numberOfPoints; ++i )
+          {
+          const double distance = queries[q].EuclideanDistanceTo( points->ElementAt( i ) );
+          bruteForceDistances.push_back( distance );
+          if( distance <= radius )
+            {
+            ++numberInRadius;
+            }
+          }
+        std::sort( bruteForceDistances.begin(), bruteForceDistances.end() );
+        std::sort( distances.begin(), distances.end() );
+        for( unsigned int k = 0; k < numberOfNeighbors; ++k )
+          {
+          if( std::abs( distances[k] - bruteForceDistances[k] ) > 1e-5 )
+            {
+            std::cerr << "Neighbor " << k << " of query " << q << " is at "
+                      << distances[k] << " instead of " << bruteForceDistances[k]
+                      << std::endl;
+            status = EXIT_FAILURE;
+            }
+          }
+        if( radiusNeighbors.size() != numberInRadius )
+          {
+          std::cerr << "Query " << q << " has " << radiusNeighbors.size()
+                    << " neighbors in the radius instead of " << numberInRadius
+                    << std::endl;
+          status = EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  //
+  // Degenerate batches
+  //
+  TreeType::InstanceIdentifierVectorListType neighborsList;
+  TreeType::DistanceVectorListType           distancesList;
+  tree->Search( queries, 0u, neighborsList, distancesList );
+  TEST_EXPECT_EQUAL( neighborsList.size(), queries.size() );
+  TEST_EXPECT_TRUE( neighborsList[0].empty() && distancesList[0].empty() );
+
+  tree->Search( TreeType::MeasurementVectorListType(), numberOfNeighbors, neighborsList );
+  TEST_EXPECT_TRUE( neighborsList.empty() );
+
+  TRY_EXPECT_EXCEPTION( tree->Search( queries, numberOfPoints + 1, neighborsList ) );
+
+  //
+  // A new root invalidates the search layout of the tree.
+  //
+  PointsContainerType::Pointer fewPoints = PointsContainerType::New();
+  fewPoints->Reserve( 3 );
+  for( unsigned int i = 0; i < 3; ++i )
+    {
+    fewPoints->ElementAt( i ).Fill( 10.0f * i );
+    }
+  sample->SetVectorContainer( fewPoints );
+  TreeGeneratorType::Pointer generator = TreeGeneratorType::New();
+  generator->SetSample( sample );
+  generator->Update();
+  TreeType::Pointer smallTree = generator->GetOutput();
+  TreeType::InstanceIdentifierVectorType neighbors;
+  smallTree->Search( queries[0], 3u, neighbors );
+  TEST_EXPECT_EQUAL( neighbors.size(), 3u );
+
+  PointType query;
+  query.Fill( 19.0f );
+  smallTree->Search( query, 1u, neighbors );
+  TEST_EXPECT_EQUAL( neighbors[0], 2u );
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
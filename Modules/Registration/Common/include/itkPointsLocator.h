@@ -36,6 +36,12 @@ namespace itk
  * This class accelerates the search for the closest point to a user-provided
  * point, by using constructing a Kd-Tree structure for the PointSetContainer.
  *
+ * The searches are thread safe. The overloads that take a vector of query
+ * points answer all of them in one call, split between NumberOfThreads
+ * threads. The k-nearest neighbor searches become approximate when an
+ * ErrorBound > 0 is set: each returned neighbor is then at most
+ * (1 + ErrorBound) times farther than the exact one. See KdTree.
+ *
  * \ingroup ITKRegistrationCommon
  */
 template<
@@ -81,7 +87,10 @@ public:
   using TreeGeneratorPointer = typename TreeGeneratorType::Pointer;
   using TreeType = typename TreeGeneratorType::KdTreeType;
   using TreeConstPointer = typename TreeType::ConstPointer;
+  using TreePointer = typename TreeType::Pointer;
   using NeighborsIdentifierType = typename TreeType::InstanceIdentifierVectorType;
+  using NeighborsIdentifierListType = typename TreeType::InstanceIdentifierVectorListType;
+  using PointListType = typename TreeType::MeasurementVectorListType;
 
   /** Set/Get the points from which the bounding box should be computed. */
   itkSetObjectMacro( Points, PointsContainer );
@@ -110,6 +119,26 @@ public:
   void FindPointsWithinRadius( const PointType &, double,
     NeighborsIdentifierType & ) const;
 
+  /** Find the k-nearest neighbors of each query point.  Returns the point
+   * ids, in the order of the queries. */
+  void Search( const PointListType &, unsigned int,
+    NeighborsIdentifierListType & ) const;
+
+  /** Find all the points within a specified radius of each query point.
+   * Returns the point ids, in the order of the queries. */
+  void Search( const PointListType &, double,
+    NeighborsIdentifierListType & ) const;
+
+  /** Set/Get the number of threads used by the searches of several
+   * query points. */
+  virtual void SetNumberOfThreads( ThreadIdType );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
+  /** Set/Get the relative distance error allowed to the k-nearest
+   * neighbor searches. The default, 0, gives exact neighbors. */
+  virtual void SetErrorBound( double );
+  itkGetConstMacro( ErrorBound, double );
+
 protected:
   PointsLocator();
   ~PointsLocator() override;
@@ -119,7 +148,9 @@ private:
   PointsContainerPointer   m_Points;
   SampleAdaptorPointer     m_SampleAdaptor;
   TreeGeneratorPointer     m_KdTreeGenerator;
-  TreeConstPointer         m_Tree;
+  TreePointer              m_Tree;
+  ThreadIdType             m_NumberOfThreads;
+  double                   m_ErrorBound;
 };
 
 } // end namespace itk
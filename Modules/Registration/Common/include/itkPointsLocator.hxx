@@ -18,6 +18,9 @@
 #ifndef itkPointsLocator_hxx
 #define itkPointsLocator_hxx
 #include "itkPointsLocator.h"
+#include "itkMath.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -28,6 +31,8 @@ PointsLocator<TPointsContainer>
 {
   this->m_SampleAdaptor = SampleAdaptorType::New();
   this->m_KdTreeGenerator = TreeGeneratorType::New();
+  this->m_NumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  this->m_ErrorBound = 0.0;
 }
 
 template<typename TPointsContainer>
@@ -61,10 +66,48 @@ PointsLocator<TPointsContainer>
 
   this->m_KdTreeGenerator->SetSample( this->m_SampleAdaptor );
   this->m_KdTreeGenerator->SetBucketSize( 16 );
+  this->m_KdTreeGenerator->SetNumberOfThreads( this->m_NumberOfThreads );
 
   this->m_KdTreeGenerator->Update();
 
   this->m_Tree = this->m_KdTreeGenerator->GetOutput();
+  this->m_Tree->SetNumberOfThreads( this->m_NumberOfThreads );
+  this->m_Tree->SetErrorBound( this->m_ErrorBound );
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SetNumberOfThreads( ThreadIdType numberOfThreads )
+{
+  numberOfThreads = std::max< ThreadIdType >( 1,
+    std::min< ThreadIdType >( numberOfThreads, ITK_MAX_THREADS ) );
+  if( this->m_NumberOfThreads != numberOfThreads )
+    {
+    this->m_NumberOfThreads = numberOfThreads;
+    if( this->m_Tree )
+      {
+      this->m_Tree->SetNumberOfThreads( numberOfThreads );
+      }
+    this->Modified();
+    }
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SetErrorBound( double errorBound )
+{
+  errorBound = std::max( 0.0, errorBound );
+  if( Math::NotExactlyEquals( this->m_ErrorBound, errorBound ) )
+    {
+    this->m_ErrorBound = errorBound;
+    if( this->m_Tree )
+      {
+      this->m_Tree->SetErrorBound( errorBound );
+      }
+    this->Modified();
+    }
 }
 
 template<typename TPointsContainer>
@@ -135,6 +178,34 @@ PointsLocator<TPointsContainer>
   this->m_Tree->Search( query, radius, identifiers );
 }
 
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::Search( const PointListType &queries, unsigned int
+  numberOfNeighborsRequested, NeighborsIdentifierListType &identifiers ) const
+{
+  unsigned int N = numberOfNeighborsRequested;
+  if( N > this->m_Points->Size() )
+    {
+    N = this->m_Points->Size();
+
+    itkWarningMacro( "The number of requested neighbors is greater than the "
+     << "total number of points.  Only returning " << N << " points." );
+    }
+  this->m_Tree->Search( queries, N, identifiers );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::Search( const PointListType &queries, double radius,
+  NeighborsIdentifierListType &identifiers ) const
+{
+  this->m_Tree->Search( queries, radius, identifiers );
+}
+
 /**
  * Print out internals
  */
@@ -145,6 +216,9 @@ PointsLocator<TPointsContainer>
 ::PrintSelf( std::ostream& os, Indent indent ) const
 {
   Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+  os << indent << "ErrorBound: " << this->m_ErrorBound << std::endl;
 }
 
 } // end namespace itk
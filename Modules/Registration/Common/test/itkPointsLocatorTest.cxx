@@ -110,6 +110,90 @@ int testPointsLocatorTest()
     return EXIT_FAILURE;
     }
 
+  std::cout << "Test:  Search() of several points" << std::endl;
+
+  typename PointsLocatorType::PointListType queries;
+  for( unsigned int i = 0; i < 1000; ++i )
+    {
+    PointType query;
+    query[0] = static_cast<float>( ( i * 37 ) % 101 );
+    query[1] = static_cast<float>( ( i * 53 ) % 103 );
+    query[2] = static_cast<float>( ( i * 71 ) % 107 );
+    queries.push_back( query );
+    }
+
+  for( unsigned int numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads *= 2 )
+    {
+    pointsLocator->SetNumberOfThreads( numberOfThreads );
+
+    typename PointsLocatorType::NeighborsIdentifierListType neighborhoods;
+    pointsLocator->Search( queries, 10u, neighborhoods );
+    if( neighborhoods.size() != queries.size() )
+      {
+      std::cerr << "Error with Search() of several points" << std::endl;
+      return EXIT_FAILURE;
+      }
+    typename PointsLocatorType::NeighborsIdentifierListType radiusNeighborhoods;
+    pointsLocator->Search( queries, radius, radiusNeighborhoods );
+    if( radiusNeighborhoods.size() != queries.size() )
+      {
+      std::cerr << "Error with Search() of several points" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    for( unsigned int i = 0; i < queries.size(); ++i )
+      {
+      pointsLocator->Search( queries[i], 10u, neighborhood );
+      if( neighborhoods[i] != neighborhood )
+        {
+        std::cerr << "Error with Search() of several points: the neighbors of query "
+          << i << " differ from the ones of Search() 1" << std::endl;
+        return EXIT_FAILURE;
+        }
+      pointsLocator->Search( queries[i], radius, neighborhood );
+      if( radiusNeighborhoods[i] != neighborhood )
+        {
+        std::cerr << "Error with Search() of several points: the neighbors of query "
+          << i << " differ from the ones of Search() 2" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test:  SetErrorBound()" << std::endl;
+
+  // The i-th approximate neighbor is at most (1 + ErrorBound) times farther
+  // than the i-th exact one.
+  const double errorBound = 0.5;
+  for( unsigned int i = 0; i < queries.size(); ++i )
+    {
+    pointsLocator->SetErrorBound( 0.0 );
+    pointsLocator->Search( queries[i], 10u, neighborhood );
+    typename PointsLocatorType::NeighborsIdentifierType approximateNeighborhood;
+    pointsLocator->SetErrorBound( errorBound );
+    pointsLocator->Search( queries[i], 10u, approximateNeighborhood );
+    if( approximateNeighborhood.size() != neighborhood.size() )
+      {
+      std::cerr << "Error with SetErrorBound()" << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( unsigned int j = 0; j < neighborhood.size(); ++j )
+      {
+      const double exactDistance =
+        queries[i].EuclideanDistanceTo( points->ElementAt( neighborhood[j] ) );
+      const double approximateDistance =
+        queries[i].EuclideanDistanceTo( points->ElementAt( approximateNeighborhood[j] ) );
+      if( approximateDistance > ( 1.0 + errorBound ) * exactDistance + 1e-5 )
+        {
+        std::cerr << "Error with SetErrorBound(): neighbor " << j << " of query "
+          << i << " is at " << approximateDistance << " instead of "
+          << exactDistance << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  pointsLocator->SetErrorBound( 0.0 );
+
   return EXIT_SUCCESS;
 }
 
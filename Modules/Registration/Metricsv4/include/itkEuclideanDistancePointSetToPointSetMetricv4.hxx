@@ -28,6 +28,8 @@ template<typename TFixedPointSet, typename TMovingPointSet, class TInternalCompu
 EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::EuclideanDistancePointSetToPointSetMetricv4()
 {
+  // Only the moving points are searched.
+  this->m_UseFixedTransformedPointsLocator = false;
 }
 
 /** Destructor */
@@ -32,6 +32,8 @@ ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInt
   m_Denominator( 0.0 ),
   m_EvaluationKNeighborhood( 50 )
 {
+  // Only the moving points are searched.
+  this->m_UseFixedTransformedPointsLocator = false;
 }
 
 /** Destructor */
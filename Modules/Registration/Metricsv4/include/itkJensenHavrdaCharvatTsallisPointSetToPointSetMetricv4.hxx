@@ -37,6 +37,8 @@ JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<TPointSet, TInternalComputa
   m_Prefactor0( 0.0 ),
   m_Prefactor1( 0.0 )
 {
+  // The density functions have their own locators.
+  this->m_UseFixedTransformedPointsLocator = false;
 }
 
 /** Destructor */
@@ -62,6 +64,8 @@ JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<TPointSet, TInternalComputa
   this->m_FixedDensityFunction->SetUseAnisotropicCovariances( this->m_UseAnisotropicCovariances );
   this->m_FixedDensityFunction->SetCovarianceKNeighborhood( this->m_CovarianceKNeighborhood );
   this->m_FixedDensityFunction->SetEvaluationKNeighborhood( this->m_EvaluationKNeighborhood );
+  this->m_FixedDensityFunction->SetNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  this->m_FixedDensityFunction->SetNearestNeighborErrorBound( this->GetNearestNeighborErrorBound() );
   this->m_FixedDensityFunction->SetInputPointSet( this->m_FixedTransformedPointSet );
 
   // Initialize the moving density function
@@ -72,6 +76,8 @@ JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<TPointSet, TInternalComputa
   this->m_MovingDensityFunction->SetUseAnisotropicCovariances( this->m_UseAnisotropicCovariances );
   this->m_MovingDensityFunction->SetCovarianceKNeighborhood( this->m_CovarianceKNeighborhood );
   this->m_MovingDensityFunction->SetEvaluationKNeighborhood( this->m_EvaluationKNeighborhood );
+  this->m_MovingDensityFunction->SetNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  this->m_MovingDensityFunction->SetNearestNeighborErrorBound( this->GetNearestNeighborErrorBound() );
   this->m_MovingDensityFunction->SetInputPointSet( this->m_MovingTransformedPointSet );
 
   // Pre-calc some values for efficiency
@@ -120,7 +126,11 @@ JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<TPointSet, TInternalComputa
    * first term only
    */
   typename PointSetType::PointIdentifier numberOfMovingPoints = this->m_MovingDensityFunction->GetInputPointSet()->GetNumberOfPoints();
-  RealType probabilityStar = this->m_MovingDensityFunction->Evaluate( samplePoint ) * static_cast<RealType>( numberOfMovingPoints );
+  // The Gaussians summed by the density are the ones of the derivative.
+  typename DensityFunctionType::NeighborsIdentifierType neighbors;
+  std::vector<RealType> gaussians;
+  RealType probabilityStar = this->m_MovingDensityFunction->Evaluate( samplePoint, neighbors, gaussians ) *
+    static_cast<RealType>( numberOfMovingPoints );
 
   probabilityStar /= this->m_TotalNumberOfPoints;
 
@@ -147,12 +157,9 @@ JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<TPointSet, TInternalComputa
     {
     RealType probabilityStarFactor = std::pow( probabilityStar, static_cast<RealType>( 2.0 - this->m_Alpha ) );
 
-    typename DensityFunctionType::NeighborsIdentifierType neighbors;
-    this->m_MovingDensityFunction->GetPointsLocator()->FindClosestNPoints( samplePoint, this->m_EvaluationKNeighborhood, neighbors );
-
     for( SizeValueType n = 0; n < neighbors.size(); n++ )
       {
-      RealType gaussian = this->m_MovingDensityFunction->GetGaussian( neighbors[n] )->Evaluate( samplePoint );
+      RealType gaussian = gaussians[n];
 
       if( Math::AlmostEquals( gaussian, NumericTraits<RealType>::ZeroValue() ) )
         {
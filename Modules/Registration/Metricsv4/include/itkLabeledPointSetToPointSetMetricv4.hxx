@@ -37,6 +37,9 @@ LabeledPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComp
   this->m_PointSetMetric = euclideanMetric;
 
   this->m_UsePointSetData = true;
+
+  // The metrics of the labels have their own locators.
+  this->m_UseFixedTransformedPointsLocator = false;
 }
 
 /** Destructor */
@@ -83,6 +86,7 @@ LabeledPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComp
       this->GetCalculateValueAndDerivativeInTangentSpace() );
     metric->SetStoreDerivativeAsSparseFieldForLocalSupportTransforms(
       this->GetStoreDerivativeAsSparseFieldForLocalSupportTransforms() );
+    metric->SetNearestNeighborErrorBound( this->GetNearestNeighborErrorBound() );
 
     metric->Initialize();
 
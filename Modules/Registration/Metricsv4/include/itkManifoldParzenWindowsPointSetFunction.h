@@ -39,6 +39,11 @@ namespace itk
  * Each point is associated with a Gaussian and local shape can
  * be encoded in the covariance matrix.
  *
+ * The neighbors of all the points, used to build the covariance
+ * matrices, are searched in one batch split between NumberOfThreads
+ * threads. A NearestNeighborErrorBound > 0 makes the neighbor searches
+ * approximate, see PointsLocator.
+ *
  * \ingroup ITKMetricsv4
  */
 template <typename TPointSet, typename TOutput = double, typename TCoordRep = double>
@@ -76,6 +81,7 @@ public:
   /** Typedef for points locator class to speed up finding neighboring points */
   using PointsLocatorType = PointsLocator< PointsContainer>;
   using NeighborsIdentifierType = typename PointsLocatorType::NeighborsIdentifierType;
+  using NeighborsIdentifierListType = typename PointsLocatorType::NeighborsIdentifierListType;
 
   using GaussianType = typename Statistics::GaussianMembershipFunction<PointType>;
   using GaussianPointer = typename GaussianType::Pointer;
@@ -164,12 +170,35 @@ public:
    */
   itkBooleanMacro( UseAnisotropicCovariances );
 
+  /**
+   * Set/Get the number of threads searching the neighbors of the points
+   * when the input point set is set.  Default = the global default number
+   * of threads.
+   */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
+  /**
+   * Set/Get the relative distance error allowed to the k-nearest neighbor
+   * searches.  Must be set before the input point set.  Default = 0, the
+   * exact neighbors.
+   */
+  itkSetClampMacro( NearestNeighborErrorBound, double, 0.0, NumericTraits<double>::max() );
+  itkGetConstMacro( NearestNeighborErrorBound, double );
+
   /** Set the input point set */
   void SetInputPointSet( const InputPointSetType * ) override;
 
   /** Evaluate function value at specified point */
   TOutput Evaluate( const InputPointType & ) const override;
 
+  /**
+   * Evaluate function value at specified point, and return the identifiers
+   * of the Gaussians that were summed, with their values at the point.
+   */
+  TOutput Evaluate( const InputPointType &, NeighborsIdentifierType &,
+    std::vector<OutputType> & ) const;
+
   /** Get Gaussian corresponding to a specific point */
   GaussianConstPointer GetGaussian( PointIdentifier ) const;
 
@@ -194,6 +223,8 @@ private:
   GaussianContainerType                         m_Gaussians;
   bool                                          m_Normalize;
   bool                                          m_UseAnisotropicCovariances;
+  ThreadIdType                                  m_NumberOfThreads;
+  double                                        m_NearestNeighborErrorBound;
 };
 
 } // end namespace itk
@@ -34,7 +34,9 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
   m_RegularizationSigma( 1.0 ),
   m_KernelSigma( 1.0 ),
   m_Normalize( true ),
-  m_UseAnisotropicCovariances( true )
+  m_UseAnisotropicCovariances( true ),
+  m_NumberOfThreads( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() ),
+  m_NearestNeighborErrorBound( 0.0 )
 {
 }
 
@@ -82,13 +84,34 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
 
   this->m_PointsLocator = PointsLocatorType::New();
   this->m_PointsLocator->SetPoints( const_cast<PointsContainer *>( points ) );
+  this->m_PointsLocator->SetNumberOfThreads( this->m_NumberOfThreads );
+  this->m_PointsLocator->SetErrorBound( this->m_NearestNeighborErrorBound );
   this->m_PointsLocator->Initialize();
 
+  /**
+   * Search the neighbors of all the points at once
+   */
+  const bool useNeighborhoods = ( this->m_CovarianceKNeighborhood > 0
+    && this->m_UseAnisotropicCovariances );
+  NeighborsIdentifierListType pointsNeighbors;
+  if( useNeighborhoods )
+    {
+    typename PointsLocatorType::PointListType queries;
+    queries.reserve( points->Size() );
+    for( It = points->Begin(); It != points->End(); ++It )
+      {
+      queries.push_back( It.Value() );
+      }
+    this->m_PointsLocator->Search( queries, this->m_CovarianceKNeighborhood,
+      pointsNeighbors );
+    }
+
   /**
    * Calculate covariance matrices
    */
 
   It = points->Begin();
+  count = NumericTraits< IdentifierType >::ZeroValue();
   while( It != points->End() )
     {
     PointType point = It.Value();
@@ -98,17 +121,15 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
     this->m_Gaussians[index]->SetMeasurementVectorSize( PointDimension );
     this->m_Gaussians[index]->SetMean( inputGaussians[index]->GetMean() );
 
-    if( this->m_CovarianceKNeighborhood > 0
-      && this->m_UseAnisotropicCovariances )
+    if( useNeighborhoods )
       {
       CovarianceMatrixType Cout( PointDimension, PointDimension );
       Cout.Fill( 0 );
 
-      typename PointsLocatorType::NeighborsIdentifierType neighbors;
-      this->m_PointsLocator->Search( point, this->m_CovarianceKNeighborhood, neighbors );
+      const NeighborsIdentifierType & neighbors = pointsNeighbors[count];
 
       RealType denominator = 0.0;
-      for( unsigned int j = 0; j < this->m_CovarianceKNeighborhood; j++ )
+      for( unsigned int j = 0; j < neighbors.size(); j++ )
         {
         if( neighbors[j] != index
           && neighbors[j] < this->GetInputPointSet()->GetNumberOfPoints() )
@@ -158,6 +179,7 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
       covariance *= itk::Math::sqr( this->m_RegularizationSigma );
       this->m_Gaussians[index]->SetCovariance( covariance );
       }
+    count++;
     ++It;
     }
 }
@@ -201,6 +223,47 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
     sum / static_cast<OutputType>( this->m_Gaussians.size() ) );
 }
 
+template <typename TPointSet, typename TOutput, typename TCoordRep>
+TOutput
+ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
+::Evaluate( const InputPointType &point, NeighborsIdentifierType &neighbors,
+  std::vector<OutputType> &values ) const
+{
+  if( this->GetInputPointSet() == nullptr )
+    {
+    itkExceptionMacro( "The input point set has not been specified." );
+    }
+
+  unsigned int numberOfNeighbors = std::min(
+    this->m_EvaluationKNeighborhood,
+    static_cast<unsigned int>( this->m_Gaussians.size() ) );
+
+  if( numberOfNeighbors == this->m_Gaussians.size() )
+    {
+    neighbors.resize( numberOfNeighbors );
+    for( unsigned int j = 0; j < numberOfNeighbors; j++ )
+      {
+      neighbors[j] = j;
+      }
+    }
+  else
+    {
+    this->m_PointsLocator->Search( point, numberOfNeighbors, neighbors );
+    }
+
+  // Same summation order as Evaluate( point ).
+  OutputType sum = NumericTraits< OutputType>::ZeroValue();
+  values.resize( numberOfNeighbors );
+  for( unsigned int j = 0; j < numberOfNeighbors; j++ )
+    {
+    values[j] = static_cast<OutputType>(
+      this->m_Gaussians[neighbors[j]]->Evaluate( point ) );
+    sum += values[j];
+    }
+  return static_cast<OutputType>(
+    sum / static_cast<OutputType>( this->m_Gaussians.size() ) );
+}
+
 template <typename TPointSet, typename TOutput, typename TCoordRep>
 typename ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>::GaussianConstPointer
 ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
@@ -238,6 +301,10 @@ ManifoldParzenWindowsPointSetFunction<TPointSet, TOutput, TCoordRep>
                << this->m_Normalize << std::endl;
   os << indent << "Use anisotropic covariances: "
                << this->m_UseAnisotropicCovariances << std::endl;
+  os << indent << "Number of threads: "
+               << this->m_NumberOfThreads << std::endl;
+  os << indent << "Nearest neighbor error bound: "
+               << this->m_NearestNeighborErrorBound << std::endl;
 }
 
 }  //end namespace itk
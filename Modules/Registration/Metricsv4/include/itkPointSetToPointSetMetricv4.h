@@ -21,9 +21,12 @@
 #include "itkObjectToObjectMetric.h"
 
 #include "itkFixedArray.h"
+#include "itkMultiThreaderBase.h"
 #include "itkPointsLocator.h"
 #include "itkPointSet.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class PointSetToPointSetMetricv4
@@ -63,6 +66,24 @@ namespace itk
  * The virtual domain point set can be retrieved from the metric using the
  * GetVirtualTransformedPointSet() method.
  *
+ * The local neighborhood values and derivatives of the fixed points are
+ * evaluated concurrently by up to MaximumNumberOfThreads threads, so derived
+ * classes must implement GetLocalNeighborhoodValue and
+ * GetLocalNeighborhoodValueAndDerivative in a thread safe way, or set
+ * MaximumNumberOfThreads to 1. The per-point results are then summed in
+ * the order of the fixed points, which makes the value and the derivative
+ * independent of the number of threads.
+ *
+ * The points locators are only rebuilt when the point sets they index
+ * change: the moving transformed point set depends on the moving transform
+ * only when the metric is calculated in tangent space, and the fixed
+ * transformed point set depends on it only when it is not. The fixed
+ * points locator is only built for derived classes that search the fixed
+ * points (m_UseFixedTransformedPointsLocator). Setting a
+ * NearestNeighborErrorBound > 0 makes their k-nearest neighbor searches
+ * approximate, each neighbor being at most (1 + NearestNeighborErrorBound)
+ * times farther than the exact one.
+ *
  * \ingroup ITKMetricsv4
  */
 
@@ -322,6 +343,21 @@ public:
   itkGetConstMacro( CalculateValueAndDerivativeInTangentSpace, bool );
   itkBooleanMacro( CalculateValueAndDerivativeInTangentSpace );
 
+  /**
+   * Set/Get the maximum number of threads evaluating the local
+   * neighborhoods of the fixed points. Defaults to the global default
+   * number of threads.
+   */
+  itkSetClampMacro( MaximumNumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( MaximumNumberOfThreads, ThreadIdType );
+
+  /**
+   * Set/Get the relative distance error allowed to the k-nearest neighbor
+   * searches of the points locators. The default, 0, gives exact neighbors.
+   */
+  itkSetClampMacro( NearestNeighborErrorBound, double, 0.0, NumericTraits<double>::max() );
+  itkGetConstMacro( NearestNeighborErrorBound, double );
+
 protected:
   PointSetToPointSetMetricv4();
   ~PointSetToPointSetMetricv4() override;
@@ -346,6 +382,13 @@ protected:
    */
   bool m_UsePointSetData;
 
+  /**
+   * Bool set by derived classes on whether they search the fixed
+   * transformed points with m_FixedTransformedPointsLocator.  If false,
+   * the locator is not built.  Default = true.
+   */
+  bool m_UseFixedTransformedPointsLocator;
+
   /**
    * Flag to calculate value and/or derivative at tangent space.  This is needed
    * for the diffeomorphic registration methods.  The fixed and moving points are
@@ -404,6 +447,15 @@ protected:
    */
   void StorePointDerivative( const VirtualPointType &, const DerivativeType &, DerivativeType & ) const;
 
+  /**
+   * Evaluate the local neighborhoods of the fixed transformed points that
+   * are inside the virtual domain, in their order, possibly in several
+   * threads. The values are only computed if \c values is not null and the
+   * derivatives if \c derivatives is not null.
+   */
+  void EvaluateLocalNeighborhoods( std::vector<MeasureType> * values,
+    std::vector<LocalDerivativeType> * derivatives ) const;
+
   using MetricCategoryType = typename Superclass::MetricCategoryType;
 
   /** Get metric category */
@@ -425,8 +477,26 @@ private:
   // (default = true).
   bool m_StoreDerivativeAsSparseFieldForLocalSupportTransforms;
 
-  mutable ModifiedTimeType m_MovingTransformedPointSetTime;
-  mutable ModifiedTimeType m_FixedTransformedPointSetTime;
+  mutable TimeStamp m_MovingTransformedPointSetTime;
+  mutable TimeStamp m_FixedTransformedPointSetTime;
+
+  ThreadIdType m_MaximumNumberOfThreads;
+  double       m_NearestNeighborErrorBound;
+
+  /** Work shared by the threads of EvaluateLocalNeighborhoods */
+  struct LocalNeighborhoodsStruct
+  {
+    const Self *                       Metric;
+    const std::vector<PointType> *     Points;
+    const std::vector<PixelType> *     Pixels;
+    std::vector<MeasureType> *         Values;
+    std::vector<LocalDerivativeType> * Derivatives;
+  };
+
+  static ITK_THREAD_RETURN_TYPE EvaluateLocalNeighborhoodsThreaderCallback( void * arg );
+
+  void EvaluateLocalNeighborhoodsInRange( const LocalNeighborhoodsStruct &,
+    SizeValueType begin, SizeValueType end ) const;
 };
 } // end namespace itk
 
@@ -21,6 +21,8 @@
 #include "itkPointSetToPointSetMetricv4.h"
 #include "itkIdentityTransform.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -42,8 +44,8 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
   this->m_MovingTransformPointLocatorsNeedInitialization = false;
   this->m_FixedTransformPointLocatorsNeedInitialization = false;
 
-  this->m_MovingTransformedPointSetTime = this->GetMTime();
-  this->m_FixedTransformedPointSetTime = this->GetMTime();
+  this->m_MaximumNumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  this->m_NearestNeighborErrorBound = 0.0;
 
   // We iterate over the fixed points to calculate the value and derivative.
   this->SetGradientSource( Superclass::GRADIENT_SOURCE_FIXED );
@@ -52,6 +54,8 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 
   this->m_UsePointSetData = false;
 
+  this->m_UseFixedTransformedPointsLocator = true;
+
   this->m_StoreDerivativeAsSparseFieldForLocalSupportTransforms = true;
 
   this->m_CalculateValueAndDerivativeInTangentSpace = false;
@@ -167,43 +171,20 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 {
   this->InitializeForIteration();
 
-  MeasureType value = 0.0;
-
-  PointsConstIterator It = this->m_FixedTransformedPointSet->GetPoints()->Begin();
   // Virtual point set will be the same size as fixed point set as long as it's
   // generated from the fixed point set.
   if( this->m_VirtualTransformedPointSet->GetNumberOfPoints() != this->m_FixedTransformedPointSet->GetNumberOfPoints() )
     {
     itkExceptionMacro("Expected FixedTransformedPointSet to be the same size as VirtualTransformedPointSet.");
     }
-  PointsConstIterator virtualIt = this->m_VirtualTransformedPointSet->GetPoints()->Begin();
-
-  while( It != this->m_FixedTransformedPointSet->GetPoints()->End() )
-    {
-    /* Verify the virtual point is in the virtual domain.
-     * If user hasn't defined a virtual space, and the active transform is not
-     * a displacement field transform type, then this will always return true. */
-    if( ! this->IsInsideVirtualDomain( virtualIt.Value() ) )
-      {
-      ++It;
-      ++virtualIt;
-      continue;
-      }
 
-    PixelType pixel;
-    NumericTraits<PixelType>::SetLength( pixel, 1 );
-    if( this->m_UsePointSetData )
-      {
-      bool doesPointDataExist = this->m_FixedPointSet->GetPointData( It.Index(), &pixel );
-      if( ! doesPointDataExist )
-        {
-        itkExceptionMacro( "The corresponding data for point " << It.Value() << " (pointId = " << It.Index() << ") does not exist." );
-        }
-      }
+  std::vector<MeasureType> pointValues;
+  this->EvaluateLocalNeighborhoods( &pointValues, nullptr );
 
-    value += this->GetLocalNeighborhoodValue( It.Value(), pixel );
-    ++virtualIt;
-    ++It;
+  MeasureType value = 0.0;
+  for( SizeValueType n = 0; n < pointValues.size(); ++n )
+    {
+    value += pointValues[n];
     }
 
   DerivativeType derivative;
@@ -260,15 +241,21 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
     {
     itkExceptionMacro( "Expected FixedTransformedPointSet to be the same size as VirtualTransformedPointSet." );
     }
+
+  // The local neighborhoods, the expensive part, are evaluated first, possibly
+  // in several threads. Their results are then mapped into parameter space and
+  // accumulated in the order of the points.
+  std::vector<MeasureType> pointValues;
+  std::vector<LocalDerivativeType> pointDerivatives;
+  this->EvaluateLocalNeighborhoods( calculateValue ? &pointValues : nullptr, &pointDerivatives );
+
   PointsConstIterator virtualIt = this->m_VirtualTransformedPointSet->GetPoints()->Begin();
   PointsConstIterator It = this->m_FixedTransformedPointSet->GetPoints()->Begin();
   PointsConstIterator end = this->m_FixedTransformedPointSet->GetPoints()->End();
+  SizeValueType validPointIndex = 0;
 
   while( It != end )
     {
-    MeasureType pointValue = NumericTraits<MeasureType>::ZeroValue();
-    LocalDerivativeType pointDerivative;
-
     /* Verify the virtual point is in the virtual domain.
      * If user hasn't defined a virtual space, and the active transform is not
      * a displacement field transform type, then this will always return true. */
@@ -279,26 +266,12 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       continue;
       }
 
-    PixelType pixel;
-    NumericTraits<PixelType>::SetLength( pixel, 1 );
-    if( this->m_UsePointSetData )
-      {
-      bool doesPointDataExist = this->m_FixedPointSet->GetPointData( It.Index(), &pixel );
-      if( ! doesPointDataExist )
-        {
-        itkExceptionMacro( "The corresponding data for point " << It.Value() << " (pointId = " << It.Index() << ") does not exist." );
-        }
-      }
-
     if( calculateValue )
       {
-      this->GetLocalNeighborhoodValueAndDerivative( It.Value(), pointValue, pointDerivative, pixel );
-      value += pointValue;
-      }
-    else
-      {
-      pointDerivative = this->GetLocalNeighborhoodDerivative( It.Value(), pixel );
+      value += pointValues[validPointIndex];
       }
+    const LocalDerivativeType & pointDerivative = pointDerivatives[validPointIndex];
+    ++validPointIndex;
 
     // Map into parameter space
     if( this->HasLocalSupport() || this->m_CalculateValueAndDerivativeInTangentSpace )
@@ -412,6 +385,118 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
     }
 }
 
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::EvaluateLocalNeighborhoods( std::vector<MeasureType> * values, std::vector<LocalDerivativeType> * derivatives ) const
+{
+  // Gather the points inside the virtual domain, and their data, so that
+  // the threads can address them by index.
+  std::vector<PointType> points;
+  std::vector<PixelType> pixels;
+  points.reserve( this->m_NumberOfValidPoints );
+  pixels.reserve( this->m_NumberOfValidPoints );
+
+  PointsConstIterator virtualIt = this->m_VirtualTransformedPointSet->GetPoints()->Begin();
+  PointsConstIterator It = this->m_FixedTransformedPointSet->GetPoints()->Begin();
+  while( It != this->m_FixedTransformedPointSet->GetPoints()->End() )
+    {
+    if( this->IsInsideVirtualDomain( virtualIt.Value() ) )
+      {
+      PixelType pixel;
+      NumericTraits<PixelType>::SetLength( pixel, 1 );
+      if( this->m_UsePointSetData )
+        {
+        bool doesPointDataExist = this->m_FixedPointSet->GetPointData( It.Index(), &pixel );
+        if( ! doesPointDataExist )
+          {
+          itkExceptionMacro( "The corresponding data for point " << It.Value() << " (pointId = " << It.Index() << ") does not exist." );
+          }
+        }
+      points.push_back( It.Value() );
+      pixels.push_back( pixel );
+      }
+    ++It;
+    ++virtualIt;
+    }
+
+  const SizeValueType numberOfPoints = points.size();
+  if( values )
+    {
+    values->assign( numberOfPoints, NumericTraits<MeasureType>::ZeroValue() );
+    }
+  if( derivatives )
+    {
+    derivatives->resize( numberOfPoints );
+    }
+
+  LocalNeighborhoodsStruct str;
+  str.Metric = this;
+  str.Points = &points;
+  str.Pixels = &pixels;
+  str.Values = values;
+  str.Derivatives = derivatives;
+
+  // a neighborhood evaluation is a few neighbor searches, so a small
+  // number of points already keeps a thread busy
+  const SizeValueType minimumPointsPerThread = 64;
+  const auto numberOfThreads = static_cast<ThreadIdType>( std::max<SizeValueType>( 1,
+    std::min<SizeValueType>( this->m_MaximumNumberOfThreads, numberOfPoints / minimumPointsPerThread ) ) );
+
+  if( numberOfThreads == 1 )
+    {
+    this->EvaluateLocalNeighborhoodsInRange( str, 0, numberOfPoints );
+    return;
+    }
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( Self::EvaluateLocalNeighborhoodsThreaderCallback, &str );
+  threader->SingleMethodExecute();
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+ITK_THREAD_RETURN_TYPE
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::EvaluateLocalNeighborhoodsThreaderCallback( void * arg )
+{
+  auto * threadInfo = static_cast<MultiThreaderBase::ThreadInfoStruct *>( arg );
+  const ThreadIdType threadId = threadInfo->ThreadID;
+  const ThreadIdType numberOfThreads = threadInfo->NumberOfThreads;
+  const LocalNeighborhoodsStruct & str = *static_cast<LocalNeighborhoodsStruct *>( threadInfo->UserData );
+
+  const SizeValueType numberOfPoints = str.Points->size();
+  str.Metric->EvaluateLocalNeighborhoodsInRange( str,
+    numberOfPoints * threadId / numberOfThreads,
+    numberOfPoints * ( threadId + 1 ) / numberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::EvaluateLocalNeighborhoodsInRange( const LocalNeighborhoodsStruct & str, SizeValueType begin, SizeValueType end ) const
+{
+  for( SizeValueType n = begin; n < end; ++n )
+    {
+    const PointType & point = ( *str.Points )[n];
+    const PixelType & pixel = ( *str.Pixels )[n];
+    if( str.Values && str.Derivatives )
+      {
+      this->GetLocalNeighborhoodValueAndDerivative( point, ( *str.Values )[n], ( *str.Derivatives )[n], pixel );
+      }
+    else if( str.Derivatives )
+      {
+      ( *str.Derivatives )[n] = this->GetLocalNeighborhoodDerivative( point, pixel );
+      }
+    else if( str.Values )
+      {
+      ( *str.Values )[n] = this->GetLocalNeighborhoodValue( point, pixel );
+      }
+    }
+}
+
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 typename PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::LocalDerivativeType
@@ -430,8 +515,13 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 ::TransformMovingPointSet() const
 {
   // Transform the moving point set with the moving transform.
-  // We calculate the value and derivatives in the moving space.
-  if( ( this->GetMTime() > this->m_MovingTransformedPointSetTime ) || ( this->m_MovingTransform->GetMTime() > this->GetMTime() ) || !this->m_MovingTransformedPointSet )
+  // We calculate the value and derivatives in the moving space, where the
+  // moving points are only copied. They, and their locator, are then kept
+  // until the metric or the moving point set change.
+  if( ( this->GetMTime() > this->m_MovingTransformedPointSetTime.GetMTime() )
+      || ( this->m_MovingPointSet->GetMTime() > this->m_MovingTransformedPointSetTime.GetMTime() )
+      || ( this->m_CalculateValueAndDerivativeInTangentSpace && this->m_MovingTransform->GetMTime() > this->GetMTime() )
+      || !this->m_MovingTransformedPointSet )
     {
     this->m_MovingTransformPointLocatorsNeedInitialization = true;
     this->m_MovingTransformedPointSet = MovingTransformedPointSetType::New();
@@ -455,7 +545,7 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
         }
       ++It;
       }
-    this->m_MovingTransformedPointSetTime = this->GetMTime();
+    this->m_MovingTransformedPointSetTime.Modified();
     }
 }
 
@@ -465,7 +555,8 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 ::TransformFixedAndCreateVirtualPointSet() const
 {
   // Transform the fixed point set through the virtual domain, and into the moving domain
-  if( ( this->GetMTime() > this->m_FixedTransformedPointSetTime )
+  if( ( this->GetMTime() > this->m_FixedTransformedPointSetTime.GetMTime() )
+      || ( this->m_FixedPointSet->GetMTime() > this->m_FixedTransformedPointSetTime.GetMTime() )
       || ( this->m_FixedTransform->GetMTime() > this->GetMTime() )
       || ! this->m_FixedTransformedPointSet
       || ! this->m_VirtualTransformedPointSet
@@ -500,7 +591,7 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
         }
       ++It;
       }
-    this->m_FixedTransformedPointSetTime = this->GetMTime();
+    this->m_FixedTransformedPointSetTime.Modified();
     }
 }
 
@@ -519,7 +610,7 @@ void
 PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::InitializePointsLocators() const
 {
-  if( this->m_FixedTransformPointLocatorsNeedInitialization )
+  if( this->m_FixedTransformPointLocatorsNeedInitialization && this->m_UseFixedTransformedPointsLocator )
     {
     if( !this->m_FixedTransformedPointSet )
       {
@@ -531,6 +622,7 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       }
     this->m_FixedTransformedPointsLocator->SetPoints( this->m_FixedTransformedPointSet->GetPoints() );
     this->m_FixedTransformedPointsLocator->Initialize();
+    this->m_FixedTransformPointLocatorsNeedInitialization = false;
     }
 
   if( this->m_MovingTransformPointLocatorsNeedInitialization )
@@ -545,6 +637,19 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       }
     this->m_MovingTransformedPointsLocator->SetPoints( this->m_MovingTransformedPointSet->GetPoints() );
     this->m_MovingTransformedPointsLocator->Initialize();
+    this->m_MovingTransformPointLocatorsNeedInitialization = false;
+    }
+
+  // The search settings do not need a rebuild of the locators.
+  if( this->m_FixedTransformedPointsLocator )
+    {
+    this->m_FixedTransformedPointsLocator->SetNumberOfThreads( this->m_MaximumNumberOfThreads );
+    this->m_FixedTransformedPointsLocator->SetErrorBound( this->m_NearestNeighborErrorBound );
+    }
+  if( this->m_MovingTransformedPointsLocator )
+    {
+    this->m_MovingTransformedPointsLocator->SetNumberOfThreads( this->m_MaximumNumberOfThreads );
+    this->m_MovingTransformedPointsLocator->SetErrorBound( this->m_NearestNeighborErrorBound );
     }
 }
 
@@ -579,6 +684,9 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
     {
     os << "false." << std::endl;
     }
+
+  os << indent << "Maximum number of threads: " << this->m_MaximumNumberOfThreads << std::endl;
+  os << indent << "Nearest neighbor error bound: " << this->m_NearestNeighborErrorBound << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkEuclideanDistancePointSetToPointSetMetricv4.h"
+#include "itkExpectationBasedPointSetToPointSetMetricv4.h"
+#include "itkJensenHavrdaCharvatTsallisPointSetToPointSetMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+/*
+ * Checks that the point set metrics give the same value and derivative
+ * with any number of threads, that the moving points locator is only
+ * rebuilt when needed, and that the approximate nearest neighbor mode
+ * respects its error bound.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 3;
+
+using PointSetType = itk::PointSet<unsigned char, Dimension>;
+using PointType = PointSetType::PointType;
+using AffineTransformType = itk::AffineTransform<double, Dimension>;
+
+// Noisy points on a sphere.
+PointSetType::Pointer
+MakeSurfacePoints( unsigned int numberOfPoints, double offset, unsigned int seed )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( seed );
+
+  PointSetType::Pointer points = PointSetType::New();
+  points->Initialize();
+  for( unsigned int i = 0; i < numberOfPoints; ++i )
+    {
+    const double theta = generator->GetUniformVariate( 0.0, itk::Math::pi );
+    const double phi = generator->GetUniformVariate( 0.0, 2.0 * itk::Math::pi );
+    const double radius = 100.0 + generator->GetUniformVariate( -1.0, 1.0 );
+    PointType point;
+    point[0] = radius * std::sin( theta ) * std::cos( phi ) + offset;
+    point[1] = radius * std::sin( theta ) * std::sin( phi ) + offset;
+    point[2] = radius * std::cos( theta ) + offset;
+    points->SetPoint( i, point );
+    }
+  return points;
+}
+
+AffineTransformType::Pointer
+MakeTransform( double angle )
+{
+  AffineTransformType::Pointer transform = AffineTransformType::New();
+  transform->SetIdentity();
+  transform->Rotate( 0, 1, angle );
+  AffineTransformType::OutputVectorType translation;
+  translation.Fill( 0.5 );
+  transform->Translate( translation );
+  return transform;
+}
+
+template<typename TMetric>
+int
+CheckThreads( TMetric * metric, const char * name )
+{
+  using MeasureType = typename TMetric::MeasureType;
+  using DerivativeType = typename TMetric::DerivativeType;
+
+  metric->SetMaximumNumberOfThreads( 1 );
+  metric->Initialize();
+  MeasureType value1;
+  DerivativeType derivative1;
+  metric->GetValueAndDerivative( value1, derivative1 );
+  const MeasureType valueOnly1 = metric->GetValue();
+
+  for( itk::ThreadIdType numberOfThreads = 2; numberOfThreads <= 8; numberOfThreads *= 2 )
+    {
+    metric->SetMaximumNumberOfThreads( numberOfThreads );
+    MeasureType value;
+    DerivativeType derivative;
+    metric->GetValueAndDerivative( value, derivative );
+    DerivativeType derivativeOnly;
+    metric->GetDerivative( derivativeOnly );
+    const MeasureType valueOnly = metric->GetValue();
+
+    // The per-point results are summed in the same order whatever the
+    // number of threads.
+    if( itk::Math::NotExactlyEquals( value, value1 )
+      || itk::Math::NotExactlyEquals( valueOnly, valueOnly1 )
+      || derivative != derivative1
+      || derivativeOnly != derivative1 )
+      {
+      std::cerr << name << ": the results with " << numberOfThreads
+        << " threads differ from the ones with 1 thread." << std::endl;
+      std::cerr << "  value " << value << " vs " << value1
+        << ", derivative " << derivative << " vs " << derivative1 << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if( itk::Math::NotExactlyEquals( valueOnly1, value1 ) )
+    {
+    std::cerr << name << ": GetValue() = " << valueOnly1
+      << " differs from GetValueAndDerivative() = " << value1 << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << name << ": value " << value1 << std::endl;
+  return EXIT_SUCCESS;
+}
+}
+
+int itkPointSetMetricNeighborSearchTest( int, char* [] )
+{
+  PointSetType::Pointer fixedPoints = MakeSurfacePoints( 5000, 0.0, 1 );
+  PointSetType::Pointer movingPoints = MakeSurfacePoints( 6000, 2.0, 2 );
+
+  // Same results with any number of threads
+  using EuclideanMetricType = itk::EuclideanDistancePointSetToPointSetMetricv4<PointSetType>;
+  EuclideanMetricType::Pointer euclideanMetric = EuclideanMetricType::New();
+  euclideanMetric->SetFixedPointSet( fixedPoints );
+  euclideanMetric->SetMovingPointSet( movingPoints );
+  euclideanMetric->SetMovingTransform( MakeTransform( 0.05 ) );
+  if( CheckThreads( euclideanMetric.GetPointer(), "EuclideanDistance" ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  using ExpectationMetricType = itk::ExpectationBasedPointSetToPointSetMetricv4<PointSetType>;
+  ExpectationMetricType::Pointer expectationMetric = ExpectationMetricType::New();
+  expectationMetric->SetFixedPointSet( fixedPoints );
+  expectationMetric->SetMovingPointSet( movingPoints );
+  expectationMetric->SetMovingTransform( MakeTransform( 0.05 ) );
+  expectationMetric->SetPointSetSigma( 2.0 );
+  expectationMetric->SetEvaluationKNeighborhood( 20 );
+  if( CheckThreads( expectationMetric.GetPointer(), "ExpectationBased" ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  using JHCTMetricType = itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4<PointSetType>;
+  JHCTMetricType::Pointer jhctMetric = JHCTMetricType::New();
+  jhctMetric->SetFixedPointSet( fixedPoints );
+  jhctMetric->SetMovingPointSet( movingPoints );
+  jhctMetric->SetMovingTransform( MakeTransform( 0.05 ) );
+  jhctMetric->SetPointSetSigma( 2.0 );
+  jhctMetric->SetKernelSigma( 5.0 );
+  jhctMetric->SetUseAnisotropicCovariances( true );
+  jhctMetric->SetCovarianceKNeighborhood( 5 );
+  jhctMetric->SetEvaluationKNeighborhood( 20 );
+  if( CheckThreads( jhctMetric.GetPointer(), "JensenHavrdaCharvatTsallis" ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The moving points, and their locator, do not depend on the moving
+  // transform outside of the tangent space.
+  euclideanMetric->SetMaximumNumberOfThreads( 4 );
+  AffineTransformType::Pointer transform = MakeTransform( 0.1 );
+  euclideanMetric->SetMovingTransform( transform );
+  euclideanMetric->Initialize();
+  EuclideanMetricType::MovingTransformedPointSetType * movingTransformedPoints =
+    euclideanMetric->GetModifiableMovingTransformedPointSet();
+  const EuclideanMetricType::MeasureType initialValue = euclideanMetric->GetValue();
+
+  AffineTransformType::ParametersType parameters = transform->GetParameters();
+  parameters[parameters.Size() - 1] += 1.0;
+  transform->SetParameters( parameters );
+  const EuclideanMetricType::MeasureType updatedValue = euclideanMetric->GetValue();
+  if( euclideanMetric->GetModifiableMovingTransformedPointSet() != movingTransformedPoints )
+    {
+    std::cerr << "The moving points were transformed again after a change of the moving transform." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( itk::Math::ExactlyEquals( updatedValue, initialValue ) )
+    {
+    std::cerr << "The value did not change with the moving transform." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  EuclideanMetricType::Pointer freshMetric = EuclideanMetricType::New();
+  freshMetric->SetFixedPointSet( fixedPoints );
+  freshMetric->SetMovingPointSet( movingPoints );
+  freshMetric->SetMovingTransform( transform );
+  freshMetric->Initialize();
+  if( itk::Math::NotExactlyEquals( freshMetric->GetValue(), updatedValue ) )
+    {
+    std::cerr << "The value after a change of the moving transform is " << updatedValue
+      << " instead of " << freshMetric->GetValue() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A new moving point set is transformed again.
+  PointSetType::Pointer otherMovingPoints = MakeSurfacePoints( 6000, 3.0, 3 );
+  euclideanMetric->SetMovingPointSet( otherMovingPoints );
+  euclideanMetric->GetValue();
+  if( euclideanMetric->GetModifiableMovingTransformedPointSet() == movingTransformedPoints )
+    {
+    std::cerr << "The moving points were not transformed again after a change of the moving point set." << std::endl;
+    return EXIT_FAILURE;
+    }
+  euclideanMetric->SetMovingPointSet( movingPoints );
+
+  // In the tangent space the moving points follow the moving transform.
+  euclideanMetric->SetCalculateValueAndDerivativeInTangentSpace( true );
+  euclideanMetric->Initialize();
+  movingTransformedPoints = euclideanMetric->GetModifiableMovingTransformedPointSet();
+  parameters[parameters.Size() - 1] += 1.0;
+  transform->SetParameters( parameters );
+  euclideanMetric->GetValue();
+  if( euclideanMetric->GetModifiableMovingTransformedPointSet() == movingTransformedPoints )
+    {
+    std::cerr << "The moving points were not transformed again in the tangent space." << std::endl;
+    return EXIT_FAILURE;
+    }
+  euclideanMetric->SetCalculateValueAndDerivativeInTangentSpace( false );
+
+  // Approximate nearest neighbors: each distance is at most (1 + bound)
+  // times the exact one, so is the mean distance.
+  euclideanMetric->Initialize();
+  const EuclideanMetricType::MeasureType exactValue = euclideanMetric->GetValue();
+  const double errorBound = 0.5;
+  euclideanMetric->SetNearestNeighborErrorBound( errorBound );
+  const EuclideanMetricType::MeasureType approximateValue = euclideanMetric->GetValue();
+  std::cout << "Exact value " << exactValue << ", approximate value " << approximateValue << std::endl;
+  if( approximateValue < exactValue - 1e-9 || approximateValue > ( 1.0 + errorBound ) * exactValue + 1e-9 )
+    {
+    std::cerr << "The approximate value " << approximateValue << " is not within the error bound of "
+      << exactValue << std::endl;
+    return EXIT_FAILURE;
+    }
+  euclideanMetric->SetNearestNeighborErrorBound( 0.0 );
+  if( itk::Math::NotExactlyEquals( euclideanMetric->GetValue(), exactValue ) )
+    {
+    std::cerr << "The value is not exact again after resetting the error bound." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -52,6 +52,15 @@ namespace itk
  * This class make use of the finite difference solver hierarchy. Update
  * for each iteration is computed in DemonsRegistrationFunction.
  *
+ * When UseFusedIteration is on (the default), each iteration is done in
+ * a single multithreaded pass after the first smoothing passes: the last
+ * smoothing direction of the displacement field, the demons force and
+ * the update of the field are computed pixel by pixel, without writing
+ * the update buffer and reading it back. The resulting field is equal to
+ * that of the separate steps. The separate steps are used when the
+ * update field is smoothed, with active blocks, or when the difference
+ * function was replaced by another type.
+ *
  * \warning This filter assumes that the fixed image type, moving image type
  * and displacement field type all have the same number of dimensions.
  *
@@ -83,6 +92,9 @@ public:
   /** Inherit types from superclass. */
   using TimeStepType = typename Superclass::TimeStepType;
 
+  /** Dimension of the displacement field. */
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
   /** FixedImage image type. */
   using FixedImageType = typename Superclass::FixedImageType;
   using FixedImagePointer = typename Superclass::FixedImagePointer;
@@ -123,6 +135,13 @@ public:
 
   virtual double GetIntensityDifferenceThreshold() const;
 
+  /** Set/Get whether the last smoothing pass, the force computation and
+   * the update of the displacement field are fused in a single pass when
+   * possible. On by default. */
+  itkSetMacro(UseFusedIteration, bool);
+  itkGetConstMacro(UseFusedIteration, bool);
+  itkBooleanMacro(UseFusedIteration);
+
 protected:
   DemonsRegistrationFilter();
   // ~DemonsRegistrationFilter() {} default implementation ok
@@ -131,6 +150,10 @@ protected:
   /** Initialize the state of filter and equation before each iteration. */
   void InitializeIteration() override;
 
+  /** Compute the update, and apply it in the same pass when the iteration
+   * is fused. */
+  TimeStepType CalculateChange() override;
+
   /** Apply update. */
   void ApplyUpdate(const TimeStepType& dt) override;
 
@@ -142,7 +165,37 @@ protected:
   void VerifyInputInformation() override {}
 
 private:
+  using OutputImageRegionType = typename DisplacementFieldType::RegionType;
+  using SmoothingKernelType = typename Superclass::SmoothingKernelType;
+
+  /** Arguments of the fused pass. */
+  struct FusedIterationThreadStruct {
+    Self *                          Filter;
+    DemonsRegistrationFunctionType *Function;
+    const DisplacementFieldType *   Input;
+    DisplacementFieldType *         Output;
+    TimeStepType                    TimeStep;
+    bool                            Smooth;
+    SmoothingKernelType             Kernel;
+  };
+
+  /** Whether the current iteration can be fused. */
+  bool CanFuseIteration() const;
+
+  /** Splits the requested region among the threads and calls
+   * ThreadedFusedIteration(). */
+  static ITK_THREAD_RETURN_TYPE FusedIterationThreaderCallback(void *arg);
+
+  /** Smooth along the last direction if requested, compute the update and
+   * apply it, for the pixels of \a region. */
+  void ThreadedFusedIteration(const FusedIterationThreadStruct & str,
+                              const OutputImageRegionType & region) const;
+
   bool m_UseMovingImageGradient;
+  bool m_UseFusedIteration;
+
+  /** Whether the current iteration is fused. */
+  bool m_FusedIteration;
 };
 } // end namespace itk
 
@@ -18,6 +18,9 @@
 #ifndef itkDemonsRegistrationFilter_hxx
 #define itkDemonsRegistrationFilter_hxx
 #include "itkDemonsRegistrationFilter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+
+#include <typeinfo>
 
 namespace itk
 {
@@ -35,6 +38,8 @@ DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
                                  drfp.GetPointer() ) );
 
   m_UseMovingImageGradient = false;
+  m_UseFusedIteration = true;
+  m_FusedIteration = false;
 }
 
 template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
@@ -47,6 +52,8 @@ DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
   os << m_UseMovingImageGradient << std::endl;
   os << indent << "Intensity difference threshold: "
      << this->GetIntensityDifferenceThreshold() << std::endl;
+  os << indent << "UseFusedIteration: ";
+  os << m_UseFusedIteration << std::endl;
 }
 
 /*
@@ -71,13 +78,169 @@ DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 
   drfp->SetUseMovingImageGradient(m_UseMovingImageGradient);
 
+  m_FusedIteration = this->CanFuseIteration();
+
   /**
    * Smooth the deformation field
    */
   if ( this->GetSmoothDisplacementField() )
     {
-    this->SmoothDisplacementField();
+    if ( m_FusedIteration )
+      {
+      // The last direction is smoothed by the fused pass.
+      this->SmoothGivenFieldAlongFirstDirections( this->GetOutput(), this->GetStandardDeviations(),
+                                                  ImageDimension - 1 );
+      }
+    else
+      {
+      this->SmoothDisplacementField();
+      }
+    }
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+bool
+DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::CanFuseIteration() const
+{
+  if ( !m_UseFusedIteration || this->GetSmoothUpdateField() || this->GetUseActiveBlocks() )
+    {
+    return false;
+    }
+
+  // A subclass of the function may compute its update differently.
+  const FiniteDifferenceFunctionType *df = this->GetDifferenceFunction().GetPointer();
+  if ( df == nullptr || typeid( *df ) != typeid( DemonsRegistrationFunctionType ) )
+    {
+    return false;
     }
+
+  const DisplacementFieldType *output = this->GetOutput();
+  return output->GetBufferedRegion() == output->GetRequestedRegion();
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+typename DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >::TimeStepType
+DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::CalculateChange()
+{
+  if ( !m_FusedIteration )
+    {
+    return Superclass::CalculateChange();
+    }
+
+  DisplacementFieldType *field = this->GetOutput();
+
+  FusedIterationThreadStruct str;
+  str.Filter = this;
+  str.Function = static_cast< DemonsRegistrationFunctionType * >( this->GetDifferenceFunction().GetPointer() );
+
+  // The time step of the demons is constant, so the update of a pixel can
+  // be applied as soon as it is computed.
+  str.TimeStep = str.Function->ComputeGlobalTimeStep(nullptr);
+
+  // The update of a pixel only depends on its own displacement, so the
+  // field is updated in place, or written into the scratch field of the
+  // smoothing when the pass also smooths along the last direction.
+  str.Smooth = this->GetSmoothDisplacementField();
+  str.Input = field;
+  if ( str.Smooth )
+    {
+    str.Output = this->GetSmoothingScratchField(field);
+    this->GetSmoothingKernel(ImageDimension - 1, this->GetStandardDeviations()[ImageDimension - 1], str.Kernel);
+    }
+  else
+    {
+    str.Output = field;
+    }
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->FusedIterationThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  if ( str.Smooth )
+    {
+    this->SwapSmoothingScratchField(field);
+    }
+
+  return str.TimeStep;
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+ITK_THREAD_RETURN_TYPE
+DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::FusedIterationThreaderCallback(void *arg)
+{
+  ThreadIdType threadId = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->ThreadID;
+  ThreadIdType threadCount = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  auto * str = (FusedIterationThreadStruct *) ( ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->UserData );
+
+  OutputImageRegionType splitRegion;
+  const ThreadIdType total = str->Filter->SplitRequestedRegion(threadId, threadCount, splitRegion);
+
+  if ( threadId < total )
+    {
+    str->Filter->ThreadedFusedIteration(*str, splitRegion);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::ThreadedFusedIteration(const FusedIterationThreadStruct & str,
+                         const OutputImageRegionType & region) const
+{
+  using PixelType = typename DisplacementFieldType::PixelType;
+  using IndexType = typename DisplacementFieldType::IndexType;
+
+  constexpr unsigned int direction = ImageDimension - 1;
+
+  const OutputImageRegionType & bufferedRegion = str.Input->GetBufferedRegion();
+  const OffsetValueType stride = str.Input->GetOffsetTable()[direction];
+  const IndexValueType  firstIndex = bufferedRegion.GetIndex(direction);
+  const IndexValueType  lastPosition = static_cast< IndexValueType >( bufferedRegion.GetSize(direction) ) - 1;
+  const SizeValueType   lineLength = region.GetSize(0);
+
+  const PixelType *inputBuffer = str.Input->GetBufferPointer();
+  PixelType       *outputBuffer = str.Output->GetBufferPointer();
+
+  void *globalData = str.Function->GetGlobalDataPointer();
+
+  // The lines are visited along the first direction, so that the output
+  // is written contiguously whatever the smoothing direction.
+  ImageLinearConstIteratorWithIndex< DisplacementFieldType > lineIt(str.Input, region);
+  lineIt.SetDirection(0);
+  for ( lineIt.GoToBegin(); !lineIt.IsAtEnd(); lineIt.NextLine() )
+    {
+    IndexType index = lineIt.GetIndex();
+    const OffsetValueType lineOffset = str.Input->ComputeOffset(index);
+
+    for ( SizeValueType i = 0; i < lineLength; ++i, ++index[0] )
+      {
+      const OffsetValueType offset = lineOffset + static_cast< OffsetValueType >( i );
+
+      PixelType value;
+      if ( str.Smooth )
+        {
+        const IndexValueType position = index[direction] - firstIndex;
+        value = Superclass::SmoothPixelAlongLine(inputBuffer + offset - position * stride,
+                                                 position, stride, lastPosition, str.Kernel);
+        }
+      else
+        {
+        value = inputBuffer[offset];
+        }
+
+      const PixelType update = str.Function->ComputeUpdateAtIndex(index, value, globalData);
+      value += static_cast< PixelType >( update * str.TimeStep );
+      outputBuffer[offset] = value;
+      }
+    }
+
+  str.Function->ReleaseGlobalDataPointer(globalData);
 }
 
 /**
@@ -145,14 +308,22 @@ void
 DemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 ::ApplyUpdate(const TimeStepType& dt)
 {
-  // If we smooth the update buffer before applying it, then the are
-  // approximating a viscuous problem as opposed to an elastic problem
-  if ( this->GetSmoothUpdateField() )
+  if ( m_FusedIteration )
     {
-    this->SmoothUpdateField();
+    // The update was applied by the fused pass of CalculateChange().
+    this->GetOutput()->Modified();
     }
+  else
+    {
+    // If we smooth the update buffer before applying it, then the are
+    // approximating a viscuous problem as opposed to an elastic problem
+    if ( this->GetSmoothUpdateField() )
+      {
+      this->SmoothUpdateField();
+      }
 
-  this->Superclass::ApplyUpdate(dt);
+    this->Superclass::ApplyUpdate(dt);
+    }
 
   auto * drfp = dynamic_cast< DemonsRegistrationFunctionType * > ( this->GetDifferenceFunction().GetPointer() );
 
@@ -154,6 +154,13 @@ public:
                                     const FloatOffsetType & offset =
                                       FloatOffsetType(0.0) ) override;
 
+  /** Compute the update at the pixel \a index of the fixed image, given
+   * the current \a displacement of that pixel. ComputeUpdate() only
+   * needs these two values, so DemonsRegistrationFilter calls this method
+   * directly when it fuses the update with the rest of the iteration. */
+  PixelType ComputeUpdateAtIndex(const IndexType & index, const PixelType & displacement,
+                                 void *globalData);
+
   /** Get the metric value. The metric value is the mean square difference
    * in intensity between the fixed image and transforming moving image
    * computed over the the overlapping region between the two images. */
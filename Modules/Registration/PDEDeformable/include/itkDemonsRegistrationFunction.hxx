@@ -169,11 +169,22 @@ typename DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementFie
 DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
 ::ComputeUpdate( const NeighborhoodType & it, void *gd,
                  const FloatOffsetType & itkNotUsed(offset) )
+{
+  return this->ComputeUpdateAtIndex(it.GetIndex(), it.GetCenterPixel(), gd);
+}
+
+/**
+ * Compute update at a given pixel
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+typename DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
+::PixelType
+DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
+::ComputeUpdateAtIndex(const IndexType & index, const PixelType & displacement, void *gd)
 {
   // Get fixed image related information
   // Note: no need to check the index is within
   // fixed image buffer. This is done by the external filter.
-  const IndexType index = it.GetIndex();
   const auto fixedValue = (double)this->GetFixedImage()->GetPixel(index);
 
   // Get moving image related information
@@ -182,7 +193,7 @@ DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
   this->GetFixedImage()->TransformIndexToPhysicalPoint(index, mappedPoint);
   for ( unsigned int j = 0; j < ImageDimension; j++ )
     {
-    mappedPoint[j] += it.GetCenterPixel()[j];
+    mappedPoint[j] += displacement[j];
     }
 
   double movingValue;
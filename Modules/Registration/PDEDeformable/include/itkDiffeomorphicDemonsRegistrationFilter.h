@@ -23,6 +23,9 @@
 
 #include "itkMultiplyImageFilter.h"
 #include "itkExponentialDisplacementFieldImageFilter.h"
+#include "itkWarpVectorImageFilter.h"
+#include "itkVectorLinearInterpolateNearestNeighborExtrapolateImageFunction.h"
+#include "itkAddImageFilter.h"
 
 namespace itk
 {
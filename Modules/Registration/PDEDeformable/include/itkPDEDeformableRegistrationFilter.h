@@ -21,6 +21,9 @@
 #include "itkDenseFiniteDifferenceImageFilter.h"
 #include "itkPDEDeformableRegistrationFunction.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 /**
@@ -233,6 +236,74 @@ protected:
    * UpdateFieldStandardDeviations. */
   virtual void SmoothUpdateField();
 
+  /** Smooth \a field in place with a separable Gaussian of the given
+   * standard deviations (in pixel units). Each direction is a
+   * multithreaded pass whose result is equal to that of
+   * VectorNeighborhoodOperatorImageFilter with a GaussianOperator and a
+   * zero flux Neumann boundary condition. The passes alternate between
+   * \a field and a scratch field that is kept for the whole registration,
+   * so no field is allocated per iteration. */
+  void SmoothGivenField(DisplacementFieldType *field, const StandardDeviationsType & standardDeviations);
+
+  using DisplacementFieldRegionType = typename DisplacementFieldType::RegionType;
+  using DisplacementFieldPixelType = typename DisplacementFieldType::PixelType;
+  using DisplacementFieldScalarType = typename DisplacementFieldPixelType::ValueType;
+  using SmoothingKernelType = std::vector< DisplacementFieldScalarType >;
+
+  /** Smooth \a field in place along its first \a numberOfDirections
+   * directions only, as the first passes of SmoothGivenField(). A
+   * subclass can then fuse the remaining pass with its own work, using
+   * GetSmoothingKernel(), SmoothPixelAlongLine(),
+   * GetSmoothingScratchField() and SwapSmoothingScratchField(). */
+  void SmoothGivenFieldAlongFirstDirections(DisplacementFieldType *field,
+                                            const StandardDeviationsType & standardDeviations,
+                                            unsigned int numberOfDirections);
+
+  /** The Gaussian kernel used by SmoothGivenField() along \a direction. */
+  void GetSmoothingKernel(unsigned int direction, double standardDeviation,
+                          SmoothingKernelType & kernel) const;
+
+  /** The scratch field of the smoothing passes, with the buffered region
+   * of \a field. It is allocated on first use and kept until
+   * PostProcessOutput(). */
+  DisplacementFieldType * GetSmoothingScratchField(const DisplacementFieldType *field);
+
+  /** Swap the buffers of \a field and of the scratch field, once a pass
+   * has written the smoothed values into the scratch field. */
+  void SwapSmoothingScratchField(DisplacementFieldType *field);
+
+  /** The value at \a position of the line starting at \a line, with
+   * pixels \a stride apart and positions up to \a lastPosition, convolved
+   * with \a kernel. Positions outside the line are clamped to its ends
+   * (zero flux Neumann condition). */
+  static DisplacementFieldPixelType SmoothPixelAlongLine(const DisplacementFieldPixelType *line,
+                                                         IndexValueType position, OffsetValueType stride,
+                                                         IndexValueType lastPosition,
+                                                         const SmoothingKernelType & kernel)
+  {
+    constexpr unsigned int VectorDimension = DisplacementFieldPixelType::Dimension;
+
+    const auto kernelSize = static_cast< IndexValueType >( kernel.size() );
+    const IndexValueType radius = kernelSize / 2;
+
+    DisplacementFieldPixelType sum;
+    for ( unsigned int c = 0; c < VectorDimension; ++c )
+      {
+      sum[c] = NumericTraits< DisplacementFieldScalarType >::ZeroValue();
+      }
+    for ( IndexValueType k = 0; k < kernelSize; ++k )
+      {
+      IndexValueType neighbor = position + k - radius;
+      neighbor = std::min( std::max( neighbor, IndexValueType(0) ), lastPosition );
+      const DisplacementFieldPixelType & value = line[neighbor * stride];
+      for ( unsigned int c = 0; c < VectorDimension; ++c )
+        {
+        sum[c] += kernel[k] * value[c];
+        }
+      }
+    return sum;
+  }
+
   /** This method is called after the solution has been generated. In this case,
    * the filter release the memory of the internal buffers. */
   void PostProcessOutput() override;
@@ -255,6 +326,23 @@ protected:
   void GenerateInputRequestedRegion() override;
 
 private:
+  /** Arguments of one directional smoothing pass. */
+  struct SmoothingThreadStruct {
+    Self *                        Filter;
+    const DisplacementFieldType * Input;
+    DisplacementFieldType *       Output;
+    unsigned int                  Direction;
+    SmoothingKernelType           Kernel;
+  };
+
+  /** Splits the buffered region of the field among the threads and calls
+   * ThreadedSmoothAlongDirection(). */
+  static ITK_THREAD_RETURN_TYPE SmoothingThreaderCallback(void *arg);
+
+  /** Convolve the lines of \a region along one direction. */
+  void ThreadedSmoothAlongDirection(const SmoothingThreadStruct & str,
+                                    const DisplacementFieldRegionType & region) const;
+
   /** Standard deviation for Gaussian smoothing */
   StandardDeviationsType m_StandardDeviations;
   StandardDeviationsType m_UpdateFieldStandardDeviations;
@@ -263,8 +351,8 @@ private:
   bool m_SmoothDisplacementField;
   bool m_SmoothUpdateField;
 
-  /** Temporary displacement field use for smoothing the
-   * the displacement field. */
+  /** Temporary displacement field used for smoothing the
+   * displacement and update fields. */
   DisplacementFieldPointer m_TempField;
 
 private:
@@ -22,6 +22,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
 #include "itkDataObject.h"
 
 #include "itkGaussianOperator.h"
@@ -345,124 +346,162 @@ void
 PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 ::SmoothDisplacementField()
 {
-  DisplacementFieldPointer field = this->GetOutput();
-
-  // copy field to TempField
-  m_TempField->SetOrigin( field->GetOrigin() );
-  m_TempField->SetSpacing( field->GetSpacing() );
-  m_TempField->SetDirection( field->GetDirection() );
-  m_TempField->SetLargestPossibleRegion(
-    field->GetLargestPossibleRegion() );
-  m_TempField->SetRequestedRegion(
-    field->GetRequestedRegion() );
-  m_TempField->SetBufferedRegion( field->GetBufferedRegion() );
-  m_TempField->Allocate();
-
-  using VectorType = typename DisplacementFieldType::PixelType;
-  using ScalarType = typename VectorType::ValueType;
-  using OperatorType = GaussianOperator< ScalarType, ImageDimension >;
-  using SmootherType = VectorNeighborhoodOperatorImageFilter<
-    DisplacementFieldType,
-    DisplacementFieldType >;
-
-  auto * oper = new OperatorType;
-  typename SmootherType::Pointer smoother = SmootherType::New();
+  this->SmoothGivenField(this->GetOutput(), m_StandardDeviations);
+}
 
-  using PixelContainerPointer = typename DisplacementFieldType::PixelContainerPointer;
-  PixelContainerPointer swapPtr;
+/*
+ * Smooth deformation using a separable Gaussian kernel
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothUpdateField()
+{
+  // The update buffer will be overwritten with new data.
+  this->SmoothGivenField(this->GetUpdateBuffer(), this->GetUpdateFieldStandardDeviations());
+}
+
+/*
+ * Smooth a field in place using a separable Gaussian kernel
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothGivenField(DisplacementFieldType *field, const StandardDeviationsType & standardDeviations)
+{
+  this->SmoothGivenFieldAlongFirstDirections(field, standardDeviations, ImageDimension);
+}
 
-  // graft the output field onto the mini-pipeline
-  smoother->GraftOutput(m_TempField);
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothGivenFieldAlongFirstDirections(DisplacementFieldType *field,
+                                       const StandardDeviationsType & standardDeviations,
+                                       unsigned int numberOfDirections)
+{
+  SmoothingThreadStruct str;
+  str.Filter = this;
+  str.Input = field;
+  str.Output = this->GetSmoothingScratchField(field);
 
-  for ( unsigned int j = 0; j < ImageDimension; j++ )
+  for ( unsigned int j = 0; j < numberOfDirections; j++ )
     {
     // smooth along this dimension
-    oper->SetDirection(j);
-    double variance = itk::Math::sqr(m_StandardDeviations[j]);
-    oper->SetVariance(variance);
-    oper->SetMaximumError(m_MaximumError);
-    oper->SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper->CreateDirectional();
-
-    // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator(*oper);
-    smoother->SetInput(field);
-    smoother->Update();
-
-    if ( j + 1 < ImageDimension )
-      {
-      // swap the containers
-      swapPtr = smoother->GetOutput()->GetPixelContainer();
-      smoother->GraftOutput(field);
-      field->SetPixelContainer(swapPtr);
-      smoother->Modified();
-      }
+    str.Direction = j;
+    this->GetSmoothingKernel(j, standardDeviations[j], str.Kernel);
+
+    this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+    this->GetMultiThreader()->SetSingleMethod(this->SmoothingThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    // swap the containers so that the field holds the smoothed data
+    this->SwapSmoothingScratchField(field);
     }
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::GetSmoothingKernel(unsigned int direction, double standardDeviation, SmoothingKernelType & kernel) const
+{
+  using OperatorType = GaussianOperator< DisplacementFieldScalarType, ImageDimension >;
 
-  // graft the output back to this filter
+  OperatorType oper;
+  oper.SetDirection(direction);
+  double variance = itk::Math::sqr(standardDeviation);
+  oper.SetVariance(variance);
+  oper.SetMaximumError(m_MaximumError);
+  oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+  oper.CreateDirectional();
+
+  kernel.assign( oper.Begin(), oper.End() );
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+typename PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >::DisplacementFieldType *
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::GetSmoothingScratchField(const DisplacementFieldType *field)
+{
+  // The scratch field is allocated on first use and released in
+  // PostProcessOutput(), so consecutive iterations reuse its buffer.
+  m_TempField->CopyInformation(field);
+  if ( m_TempField->GetBufferPointer() == nullptr
+       || m_TempField->GetBufferedRegion() != field->GetBufferedRegion() )
+    {
+    m_TempField->SetBufferedRegion( field->GetBufferedRegion() );
+    m_TempField->Allocate();
+    }
+  m_TempField->SetRequestedRegion( field->GetRequestedRegion() );
+  return m_TempField;
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SwapSmoothingScratchField(DisplacementFieldType *field)
+{
+  using PixelContainerPointer = typename DisplacementFieldType::PixelContainerPointer;
+
+  PixelContainerPointer swapPtr = m_TempField->GetPixelContainer();
   m_TempField->SetPixelContainer( field->GetPixelContainer() );
-  this->GraftOutput( smoother->GetOutput() );
+  field->SetPixelContainer(swapPtr);
+}
 
-  delete oper;
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+ITK_THREAD_RETURN_TYPE
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothingThreaderCallback(void *arg)
+{
+  ThreadIdType threadId = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->ThreadID;
+  ThreadIdType threadCount = ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  auto * str = (SmoothingThreadStruct *) ( ( (MultiThreaderBase::ThreadInfoStruct *)( arg ) )->UserData );
+
+  DisplacementFieldRegionType splitRegion = str->Input->GetBufferedRegion();
+  const ThreadIdType total = str->Filter->GetImageRegionSplitter()->GetSplit(threadId, threadCount, splitRegion);
+
+  if ( threadId < total )
+    {
+    str->Filter->ThreadedSmoothAlongDirection(*str, splitRegion);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
-/*
- * Smooth deformation using a separable Gaussian kernel
- */
 template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
 void
 PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
-::SmoothUpdateField()
+::ThreadedSmoothAlongDirection(const SmoothingThreadStruct & str,
+                               const DisplacementFieldRegionType & region) const
 {
-  // The update buffer will be overwritten with new data.
-  DisplacementFieldPointer field = this->GetUpdateBuffer();
+  using PixelType = typename DisplacementFieldType::PixelType;
 
-  using VectorType = typename DisplacementFieldType::PixelType;
-  using ScalarType = typename VectorType::ValueType;
-  using OperatorType = GaussianOperator< ScalarType, ImageDimension >;
-  using SmootherType = VectorNeighborhoodOperatorImageFilter<
-    DisplacementFieldType,
-    DisplacementFieldType >;
+  const unsigned int direction = str.Direction;
+  const DisplacementFieldRegionType & bufferedRegion = str.Input->GetBufferedRegion();
+  const OffsetValueType stride = str.Input->GetOffsetTable()[direction];
+  const IndexValueType  lastPosition = static_cast< IndexValueType >( bufferedRegion.GetSize(direction) ) - 1;
+  const IndexValueType  firstOutputPosition = region.GetIndex(direction) - bufferedRegion.GetIndex(direction);
+  const IndexValueType  endOutputPosition = firstOutputPosition + static_cast< IndexValueType >( region.GetSize(direction) );
 
-  OperatorType opers[ImageDimension];
-  typename SmootherType::Pointer smoothers[ImageDimension];
+  const PixelType *inputBuffer = str.Input->GetBufferPointer();
+  PixelType       *outputBuffer = str.Output->GetBufferPointer();
 
-  for ( unsigned int j = 0; j < ImageDimension; j++ )
+  ImageLinearConstIteratorWithIndex< DisplacementFieldType > lineIt(str.Input, region);
+  lineIt.SetDirection(direction);
+  for ( lineIt.GoToBegin(); !lineIt.IsAtEnd(); lineIt.NextLine() )
     {
-    // smooth along this dimension
-    opers[j].SetDirection(j);
-    double variance = itk::Math::sqr(this->GetUpdateFieldStandardDeviations()[j]);
-    //double variance = itk::Math::sqr( 1.0 );
-    opers[j].SetVariance(variance);
-    opers[j].SetMaximumError( this->GetMaximumError() );
-    opers[j].SetMaximumKernelWidth( this->GetMaximumKernelWidth() );
-    opers[j].CreateDirectional();
-
-    smoothers[j] = SmootherType::New();
-    smoothers[j]->SetOperator(opers[j]);
-    smoothers[j]->ReleaseDataFlagOn();
-
-    if ( j > 0 )
+    typename DisplacementFieldType::IndexType lineStart = lineIt.GetIndex();
+    lineStart[direction] = bufferedRegion.GetIndex(direction);
+    const OffsetValueType lineOffset = str.Input->ComputeOffset(lineStart);
+    const PixelType *inputLine = inputBuffer + lineOffset;
+    PixelType       *outputLine = outputBuffer + lineOffset;
+
+    for ( IndexValueType position = firstOutputPosition; position < endOutputPosition; ++position )
       {
-      smoothers[j]->SetInput( smoothers[j - 1]->GetOutput() );
+      outputLine[position * stride] =
+        Self::SmoothPixelAlongLine(inputLine, position, stride, lastPosition, str.Kernel);
       }
     }
-  smoothers[0]->SetInput(field);
-  smoothers[ImageDimension - 1]->GetOutput()
-  ->SetRequestedRegion( field->GetBufferedRegion() );
-
-  smoothers[ImageDimension - 1]->Update();
-
-  // field to contain the final smoothed data, do the equivalent of a graft
-  field->SetPixelContainer( smoothers[ImageDimension - 1]->GetOutput()
-                            ->GetPixelContainer() );
-  field->SetRequestedRegion( smoothers[ImageDimension - 1]->GetOutput()
-                             ->GetRequestedRegion() );
-  field->SetBufferedRegion( smoothers[ImageDimension - 1]->GetOutput()
-                            ->GetBufferedRegion() );
-  field->SetLargestPossibleRegion( smoothers[ImageDimension - 1]->GetOutput()
-                                   ->GetLargestPossibleRegion() );
-  field->CopyInformation( smoothers[ImageDimension - 1]->GetOutput() );
 }
 } // end namespace itk
 
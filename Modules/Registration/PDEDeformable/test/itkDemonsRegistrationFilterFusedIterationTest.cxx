@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDemonsRegistrationFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+// Fill an image with a smooth blob centered on center.
+template< typename TImage >
+void
+FillWithBlob(TImage *image, const double *center, double radius)
+{
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    double distance = 0;
+    for ( unsigned int j = 0; j < TImage::ImageDimension; j++ )
+      {
+      distance += itk::Math::sqr( static_cast< double >( index[j] ) - center[j] );
+      }
+    it.Set( static_cast< typename TImage::PixelType >( 200.0 * std::exp( -distance / itk::Math::sqr(radius) ) ) );
+    }
+}
+
+// Register a shifted blob with the fused iteration on and off, and check
+// that both give the same field.
+template< unsigned int VDimension >
+int
+CompareFusedIteration(const typename itk::Image< float, VDimension >::SizeType & size,
+                      bool smoothDisplacementField, bool smoothUpdateField,
+                      bool useMovingImageGradient, unsigned int numberOfIterations)
+{
+  using ImageType = itk::Image< float, VDimension >;
+  using VectorType = itk::Vector< float, VDimension >;
+  using FieldType = itk::Image< VectorType, VDimension >;
+  using RegistrationType = itk::DemonsRegistrationFilter< ImageType, ImageType, FieldType >;
+
+  typename ImageType::IndexType start;
+  for ( unsigned int j = 0; j < VDimension; j++ )
+    {
+    start[j] = static_cast< typename ImageType::IndexValueType >( j ) - 2;
+    }
+  const typename ImageType::RegionType region( start, size );
+
+  double fixedCenter[VDimension];
+  double movingCenter[VDimension];
+  for ( unsigned int j = 0; j < VDimension; j++ )
+    {
+    fixedCenter[j] = start[j] + 0.5 * size[j];
+    movingCenter[j] = fixedCenter[j] + 1.5 + j;
+    }
+
+  typename ImageType::Pointer fixed = ImageType::New();
+  fixed->SetRegions(region);
+  fixed->Allocate();
+  FillWithBlob< ImageType >( fixed, fixedCenter, 0.25 * size[0] );
+
+  typename ImageType::Pointer moving = ImageType::New();
+  moving->SetRegions(region);
+  moving->Allocate();
+  FillWithBlob< ImageType >( moving, movingCenter, 0.25 * size[0] );
+
+  typename FieldType::Pointer fields[2];
+  double metrics[2];
+  itk::TimeProbe probes[2];
+  for ( unsigned int fused = 0; fused < 2; ++fused )
+    {
+    typename RegistrationType::Pointer registrator = RegistrationType::New();
+    registrator->SetFixedImage(fixed);
+    registrator->SetMovingImage(moving);
+    registrator->SetNumberOfIterations(numberOfIterations);
+    registrator->SetStandardDeviations(1.5);
+    registrator->SetUpdateFieldStandardDeviations(1.0);
+    registrator->SetSmoothDisplacementField(smoothDisplacementField);
+    registrator->SetSmoothUpdateField(smoothUpdateField);
+    registrator->SetUseMovingImageGradient(useMovingImageGradient);
+    registrator->SetUseFusedIteration( fused != 0 );
+
+    probes[fused].Start();
+    TRY_EXPECT_NO_EXCEPTION( registrator->Update() );
+    probes[fused].Stop();
+
+    fields[fused] = registrator->GetOutput();
+    fields[fused]->DisconnectPipeline();
+    metrics[fused] = registrator->GetMetric();
+    }
+
+  std::cout << VDimension << "D " << size
+            << " smooth field: " << smoothDisplacementField
+            << " smooth update: " << smoothUpdateField
+            << " moving gradient: " << useMovingImageGradient
+            << " separate steps: " << probes[0].GetTotal() << " s"
+            << " fused: " << probes[1].GetTotal() << " s" << std::endl;
+
+  // Each pixel goes through the same operations in the same order.
+  itk::ImageRegionConstIteratorWithIndex< FieldType > separateIt( fields[0], region );
+  itk::ImageRegionConstIteratorWithIndex< FieldType > fusedIt( fields[1], region );
+  unsigned int numberOfDifferences = 0;
+  bool         moved = false;
+  for ( ; !separateIt.IsAtEnd(); ++separateIt, ++fusedIt )
+    {
+    if ( separateIt.Get() != fusedIt.Get() )
+      {
+      if ( numberOfDifferences++ == 0 )
+        {
+        std::cerr << "Fields differ at " << separateIt.GetIndex() << ": "
+                  << separateIt.Get() << " and " << fusedIt.Get() << std::endl;
+        }
+      }
+    moved = moved || separateIt.Get().GetNorm() > 0.1;
+    }
+
+  int status = EXIT_SUCCESS;
+  if ( numberOfDifferences != 0 )
+    {
+    std::cerr << numberOfDifferences << " pixels differ" << std::endl;
+    status = EXIT_FAILURE;
+    }
+  if ( !moved )
+    {
+    std::cerr << "The registration did not move the field" << std::endl;
+    status = EXIT_FAILURE;
+    }
+  // The metric is summed in another pixel order.
+  if ( !itk::Math::FloatAlmostEqual( metrics[0], metrics[1], 4, 1e-9 * metrics[0] ) )
+    {
+    std::cerr << "Metrics differ: " << metrics[0] << " and " << metrics[1] << std::endl;
+    status = EXIT_FAILURE;
+    }
+  return status;
+}
+
+}
+
+int itkDemonsRegistrationFilterFusedIterationTest(int, char* [] )
+{
+  using RegistrationType = itk::DemonsRegistrationFilter< itk::Image< float, 3 >, itk::Image< float, 3 >,
+                                                          itk::Image< itk::Vector< float, 3 >, 3 > >;
+  RegistrationType::Pointer registrator = RegistrationType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( registrator, DemonsRegistrationFilter, PDEDeformableRegistrationFilter );
+  TEST_SET_GET_BOOLEAN( registrator, UseFusedIteration, false );
+
+  int status = EXIT_SUCCESS;
+
+  itk::Size< 2 > size2D = { { 37, 30 } };
+  for ( unsigned int smooth = 0; smooth < 2; ++smooth )
+    {
+    for ( unsigned int movingGradient = 0; movingGradient < 2; ++movingGradient )
+      {
+      if ( CompareFusedIteration< 2 >( size2D, smooth != 0, false, movingGradient != 0, 10 ) == EXIT_FAILURE )
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+
+  // The update field is smoothed by the separate steps only.
+  if ( CompareFusedIteration< 2 >( size2D, true, true, false, 10 ) == EXIT_FAILURE )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  itk::Size< 3 > size3D = { { 64, 60, 50 } };
+  for ( unsigned int smooth = 0; smooth < 2; ++smooth )
+    {
+    if ( CompareFusedIteration< 3 >( size3D, smooth != 0, false, false, 10 ) == EXIT_FAILURE )
+      {
+      status = EXIT_FAILURE;
+      }
+    }
+
+  return status;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPDEDeformableRegistrationFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+// Expose the protected smoothing utility of the registration filter.
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+class PDEDeformableRegistrationFilterSmoothingHelper:
+  public itk::PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(PDEDeformableRegistrationFilterSmoothingHelper);
+
+  using Self = PDEDeformableRegistrationFilterSmoothingHelper;
+  using Superclass = itk::PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >;
+  using Pointer = itk::SmartPointer< Self >;
+
+  itkNewMacro(Self);
+
+  using Superclass::SmoothGivenField;
+
+protected:
+  PDEDeformableRegistrationFilterSmoothingHelper() {}
+  ~PDEDeformableRegistrationFilterSmoothingHelper() override {}
+};
+
+}
+
+int itkPDEDeformableRegistrationFilterSmoothingTest(int, char* [] )
+{
+  constexpr unsigned int ImageDimension = 3;
+
+  using ImageType = itk::Image< float, ImageDimension >;
+  using VectorType = itk::Vector< float, ImageDimension >;
+  using FieldType = itk::Image< VectorType, ImageDimension >;
+
+  // A field with a non-zero start index and sizes of both parities, smaller
+  // than the kernel along one direction to exercise the boundary clamping.
+  FieldType::IndexType start;
+  start[0] = -3;
+  start[1] = 2;
+  start[2] = 0;
+  FieldType::SizeType size;
+  size[0] = 23;
+  size[1] = 16;
+  size[2] = 4;
+
+  FieldType::Pointer field = FieldType::New();
+  field->SetRegions( FieldType::RegionType( start, size ) );
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< FieldType > It( field, field->GetBufferedRegion() );
+  for ( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const FieldType::IndexType index = It.GetIndex();
+    VectorType value;
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      value[j] = std::sin( 0.7 * index[j] + 0.3 * index[( j + 1 ) % ImageDimension] + j ) * ( 1.0 + index[2] );
+      }
+    It.Set( value );
+    }
+
+  using HelperType = PDEDeformableRegistrationFilterSmoothingHelper< ImageType, ImageType, FieldType >;
+  HelperType::Pointer helper = HelperType::New();
+  helper->SetMaximumError( 0.05 );
+  helper->SetMaximumKernelWidth( 12 );
+
+  HelperType::StandardDeviationsType standardDeviations;
+  standardDeviations[0] = 1.5;
+  standardDeviations[1] = 0.8;
+  standardDeviations[2] = 2.5;
+
+  // Reference: the separable mini-pipeline of neighborhood operator filters.
+  using OperatorType = itk::GaussianOperator< float, ImageDimension >;
+  using SmootherType = itk::VectorNeighborhoodOperatorImageFilter< FieldType, FieldType >;
+
+  OperatorType opers[ImageDimension];
+  SmootherType::Pointer smoothers[ImageDimension];
+  for ( unsigned int j = 0; j < ImageDimension; j++ )
+    {
+    opers[j].SetDirection( j );
+    opers[j].SetVariance( itk::Math::sqr( standardDeviations[j] ) );
+    opers[j].SetMaximumError( helper->GetMaximumError() );
+    opers[j].SetMaximumKernelWidth( helper->GetMaximumKernelWidth() );
+    opers[j].CreateDirectional();
+    smoothers[j] = SmootherType::New();
+    smoothers[j]->SetOperator( opers[j] );
+    smoothers[j]->SetInput( j > 0 ? smoothers[j - 1]->GetOutput() : field.GetPointer() );
+    }
+  TRY_EXPECT_NO_EXCEPTION( smoothers[ImageDimension - 1]->Update() );
+  FieldType::Pointer expected = smoothers[ImageDimension - 1]->GetOutput();
+
+  // Smooth twice in place to check that the scratch field is reused.
+  for ( unsigned int pass = 0; pass < 2; ++pass )
+    {
+    FieldType::Pointer smoothed = FieldType::New();
+    smoothed->SetRegions( field->GetBufferedRegion() );
+    smoothed->Allocate();
+    itk::ImageRegionIterator< FieldType > ItC( smoothed, smoothed->GetBufferedRegion() );
+    for ( It.GoToBegin(), ItC.GoToBegin(); !It.IsAtEnd(); ++It, ++ItC )
+      {
+      ItC.Set( It.Get() );
+      }
+
+    helper->SmoothGivenField( smoothed, standardDeviations );
+
+    itk::ImageRegionIteratorWithIndex< FieldType > ItE( expected, expected->GetBufferedRegion() );
+    itk::ImageRegionIterator< FieldType > ItS( smoothed, smoothed->GetBufferedRegion() );
+    for ( ItE.GoToBegin(), ItS.GoToBegin(); !ItE.IsAtEnd(); ++ItE, ++ItS )
+      {
+      if ( ItE.Get() != ItS.Get() )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Smoothed value " << ItS.Get() << " differs from " << ItE.Get()
+                  << " at " << ItE.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
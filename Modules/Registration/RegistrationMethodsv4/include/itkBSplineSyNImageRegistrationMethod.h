@@ -131,15 +131,14 @@ protected:
   BSplineSyNImageRegistrationMethod();
   ~BSplineSyNImageRegistrationMethod() override;
 
-  /** Handle optimization internally */
-  void StartOptimization() override;
-
   void InitializeRegistrationAtEachLevel( const SizeValueType ) override;
 
   DisplacementFieldPointer ComputeUpdateField( const FixedImagesContainerType, const PointSetsContainerType,
     const TransformBaseType *, const MovingImagesContainerType, const PointSetsContainerType,
     const TransformBaseType *, const FixedImageMasksContainerType, const MovingImageMasksContainerType,
     MeasureType & ) override;
+
+  DisplacementFieldPointer SmoothTotalField( const DisplacementFieldType *, const OutputTransformType * ) override;
   virtual DisplacementFieldPointer BSplineSmoothDisplacementField( const DisplacementFieldType *,
     const ArrayType &, const WeightedMaskImageType *, const BSplinePointSetType * );
 };
@@ -71,119 +71,13 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
     }
 }
 
-/*
- * Start the optimization at each level.  We just do a basic gradient descent operation.
- */
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
-void
+typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::DisplacementFieldPointer
 BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
-::StartOptimization()
+::SmoothTotalField( const DisplacementFieldType * field, const OutputTransformType * toMiddleTransform )
 {
-  VirtualImageBaseConstPointer virtualDomainImage = this->GetCurrentLevelVirtualDomainImage();
-
-  if( virtualDomainImage.IsNull() )
-    {
-    itkExceptionMacro( "The virtual domain image is not found." );
-    }
-
-  auto * fixedInitialTransform = const_cast<InitialTransformType*>( this->GetFixedInitialTransform() );
-
-  // Monitor the convergence
-  using ConvergenceMonitoringType = itk::Function::WindowConvergenceMonitoringFunction<RealType>;
-  typename ConvergenceMonitoringType::Pointer convergenceMonitoring = ConvergenceMonitoringType::New();
-  convergenceMonitoring->SetWindowSize( this->m_ConvergenceWindowSize );
-
-  IterationReporter reporter( this, 0, 1 );
-
-  while( this->m_CurrentIteration++ < this->m_NumberOfIterationsPerLevel[this->m_CurrentLevel] && !this->m_IsConverged )
-    {
-    typename CompositeTransformType::Pointer fixedComposite = CompositeTransformType::New();
-    if( fixedInitialTransform != nullptr )
-      {
-      fixedComposite->AddTransform( fixedInitialTransform );
-      }
-
-    fixedComposite->AddTransform( this->m_FixedToMiddleTransform->GetInverseTransform() );
-    fixedComposite->FlattenTransformQueue();
-    fixedComposite->SetOnlyMostRecentTransformToOptimizeOn();
-
-    typename CompositeTransformType::Pointer movingComposite = CompositeTransformType::New();
-    movingComposite->AddTransform( this->m_CompositeTransform );
-    movingComposite->AddTransform( this->m_MovingToMiddleTransform->GetInverseTransform() );
-    movingComposite->FlattenTransformQueue();
-    movingComposite->SetOnlyMostRecentTransformToOptimizeOn();
-
-    // Compute the update fields (to both moving and fixed images) and smooth
-
-    MeasureType fixedMetricValue = 0.0;
-    MeasureType movingMetricValue = 0.0;
-
-    DisplacementFieldPointer fixedToMiddleSmoothUpdateField = this->ComputeUpdateField(
-      this->m_FixedSmoothImages, this->m_FixedPointSets, fixedComposite,
-      this->m_MovingSmoothImages, this->m_MovingPointSets, movingComposite,
-      this->m_FixedImageMasks, this->m_MovingImageMasks, movingMetricValue );
-
-    DisplacementFieldPointer movingToMiddleSmoothUpdateField = this->ComputeUpdateField(
-      this->m_MovingSmoothImages, this->m_MovingPointSets, movingComposite,
-      this->m_FixedSmoothImages, this->m_FixedPointSets, fixedComposite,
-      this->m_MovingImageMasks, this->m_FixedImageMasks, fixedMetricValue );
-
-    if ( this->m_AverageMidPointGradients )
-      {
-      ImageRegionIteratorWithIndex<DisplacementFieldType> ItF( fixedToMiddleSmoothUpdateField, fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion() );
-      for( ItF.GoToBegin(); !ItF.IsAtEnd(); ++ItF )
-        {
-        ItF.Set( ItF.Get() - movingToMiddleSmoothUpdateField->GetPixel( ItF.GetIndex() ) );
-        movingToMiddleSmoothUpdateField->SetPixel( ItF.GetIndex(), -ItF.Get() );
-        }
-      }
-
-    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
-
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
-
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField( fixedToMiddleSmoothUpdateField );
-    fixedComposer->SetWarpingField( this->m_FixedToMiddleTransform->GetDisplacementField() );
-    fixedComposer->Update();
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField( fixedComposer->GetOutput(),
-      this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheTotalField(), nullptr, nullptr );
-
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField( movingToMiddleSmoothUpdateField );
-    movingComposer->SetWarpingField( this->m_MovingToMiddleTransform->GetDisplacementField() );
-    movingComposer->Update();
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField( movingComposer->GetOutput(),
-      this->m_MovingToMiddleTransform->GetNumberOfControlPointsForTheTotalField(), nullptr, nullptr );
-
-    // Iteratively estimate the inverse fields.
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp );
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp );
-
-    // Assign the displacement fields and their inverses to the proper transforms.
-    this->m_FixedToMiddleTransform->SetDisplacementField( fixedToMiddleSmoothTotalField );
-    this->m_FixedToMiddleTransform->SetInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse );
-
-    this->m_MovingToMiddleTransform->SetDisplacementField( movingToMiddleSmoothTotalField );
-    this->m_MovingToMiddleTransform->SetInverseDisplacementField( movingToMiddleSmoothTotalFieldInverse );
-
-    this->m_CurrentMetricValue = 0.5 * ( movingMetricValue + fixedMetricValue );
-
-    convergenceMonitoring->AddEnergyValue( this->m_CurrentMetricValue );
-    this->m_CurrentConvergenceValue = convergenceMonitoring->GetConvergenceValue();
-
-    if( this->m_CurrentConvergenceValue < this->m_ConvergenceThreshold )
-      {
-      this->m_IsConverged = true;
-      }
-    reporter.CompletedStep();
-    }
+  return this->BSplineSmoothDisplacementField( field,
+    toMiddleTransform->GetNumberOfControlPointsForTheTotalField(), nullptr, nullptr );
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
@@ -23,6 +23,8 @@
 #include "itkImageMaskSpatialObject.h"
 #include "itkDisplacementFieldTransform.h"
 
+#include <initializer_list>
+
 namespace itk
 {
 
@@ -56,6 +58,14 @@ namespace itk
  * The method evolved since that time with crucial contributions from Gang Song and
  * Nick Tustison. Though similar in spirit, this implementation is not identical.
  *
+ * To bound the memory footprint on large volumes, each iteration composes, smooths and
+ * inverts the fixed-to-middle and moving-to-middle fields in turn, releasing the
+ * intermediate fields of one side before those of the other are allocated.  The forward
+ * total field is always rebuilt from its inverse rather than stored separately.  The peak
+ * number of bytes held in displacement fields during the last iteration is available
+ * through GetPeakFieldMemoryInBytes().  Instantiating the method with a single precision
+ * output transform halves the footprint of every field.
+ *
  * \todo Need to allow the fixed image to have a composite transform.
  *
  * \author Nick Tustison
@@ -195,6 +205,13 @@ public:
   itkSetObjectMacro( FixedToMiddleTransform, OutputTransformType);
   itkSetObjectMacro( MovingToMiddleTransform, OutputTransformType);
 
+  /**
+   * Get the peak memory, in bytes, of the displacement fields held by the registration
+   * method during the most recent iteration.  Fields which are only referenced by the
+   * metric are not included.  This value is updated before each IterationEvent.
+   */
+  itkGetConstMacro( PeakFieldMemoryInBytes, SizeValueType );
+
 protected:
   SyNImageRegistrationMethod();
   ~SyNImageRegistrationMethod() override;
@@ -224,6 +241,21 @@ protected:
   virtual DisplacementFieldPointer GaussianSmoothDisplacementField( const DisplacementFieldType *, const RealType );
   virtual DisplacementFieldPointer InvertDisplacementField( const DisplacementFieldType *, const DisplacementFieldType * = nullptr );
 
+  /** Smooth the composed total field of one of the two "to middle" transforms. */
+  virtual DisplacementFieldPointer SmoothTotalField( const DisplacementFieldType *, const OutputTransformType * );
+
+  /**
+   * Compose the update field with the total field of \c toMiddleTransform, smooth the
+   * result and replace the total field and its inverse.  The update field is released
+   * as soon as it has been composed.  \c pendingUpdateField is only used to account for
+   * the memory still held by the update of the other transform.
+   */
+  void UpdateToMiddleTransform( OutputTransformType * toMiddleTransform, DisplacementFieldPointer & updateField,
+    const DisplacementFieldType * pendingUpdateField );
+
+  /** Update the peak field memory with the fields of both "to middle" transforms and the given temporaries. */
+  void AccumulatePeakFieldMemory( std::initializer_list<const DisplacementFieldType *> temporaryFields );
+
   RealType                                                        m_LearningRate;
 
   OutputTransformPointer                                          m_MovingToMiddleTransform;
@@ -236,6 +268,8 @@ protected:
   bool                                                            m_DownsampleImagesForMetricDerivatives;
   bool                                                            m_AverageMidPointGradients;
 
+  SizeValueType                                                   m_PeakFieldMemoryInBytes;
+
 private:
   RealType                                                        m_GaussianSmoothingVarianceForTheUpdateField;
   RealType                                                        m_GaussianSmoothingVarianceForTheTotalField;
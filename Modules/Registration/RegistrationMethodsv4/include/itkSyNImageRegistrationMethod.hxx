@@ -41,6 +41,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   m_LearningRate( 0.25 ),
   m_ConvergenceThreshold( 1.0e-6 ),
   m_ConvergenceWindowSize( 10 ),
+  m_PeakFieldMemoryInBytes( 0 ),
   m_GaussianSmoothingVarianceForTheUpdateField( 3.0 ),
   m_GaussianSmoothingVarianceForTheTotalField( 0.5 )
 {
@@ -204,40 +205,23 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
         }
       }
 
-    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
+    // The composite transforms reference the current total fields through the inverse
+    // transforms so we release them before the total fields are replaced.
 
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+    fixedComposite = nullptr;
+    movingComposite = nullptr;
 
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField( fixedToMiddleSmoothUpdateField );
-    fixedComposer->SetWarpingField( this->m_FixedToMiddleTransform->GetDisplacementField() );
-    fixedComposer->Update();
+    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth.
+    // Both update fields were computed from the current transforms so the two sides can be
+    // finalized one after the other.
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
+    this->m_PeakFieldMemoryInBytes = 0;
+    this->AccumulatePeakFieldMemory( { fixedToMiddleSmoothUpdateField, movingToMiddleSmoothUpdateField } );
 
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField( movingToMiddleSmoothUpdateField );
-    movingComposer->SetWarpingField( this->m_MovingToMiddleTransform->GetDisplacementField() );
-    movingComposer->Update();
+    this->UpdateToMiddleTransform( this->m_FixedToMiddleTransform, fixedToMiddleSmoothUpdateField, movingToMiddleSmoothUpdateField );
+    this->UpdateToMiddleTransform( this->m_MovingToMiddleTransform, movingToMiddleSmoothUpdateField, nullptr );
 
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
-
-    // Iteratively estimate the inverse fields.
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp );
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp );
-
-    // Assign the displacement fields and their inverses to the proper transforms.
-    this->m_FixedToMiddleTransform->SetDisplacementField( fixedToMiddleSmoothTotalField );
-    this->m_FixedToMiddleTransform->SetInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse );
-
-    this->m_MovingToMiddleTransform->SetDisplacementField( movingToMiddleSmoothTotalField );
-    this->m_MovingToMiddleTransform->SetInverseDisplacementField( movingToMiddleSmoothTotalFieldInverse );
+    itkDebugMacro( "Peak field memory: " << this->m_PeakFieldMemoryInBytes << " bytes" );
 
     this->m_CurrentMetricValue = 0.5 * ( movingMetricValue + fixedMetricValue );
 
@@ -252,6 +236,77 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     }
 }
 
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::UpdateToMiddleTransform( OutputTransformType * toMiddleTransform, DisplacementFieldPointer & updateField,
+  const DisplacementFieldType * pendingUpdateField )
+{
+  using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+
+  typename ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( updateField );
+  composer->SetWarpingField( toMiddleTransform->GetDisplacementField() );
+  composer->Update();
+
+  DisplacementFieldPointer composedField = composer->GetOutput();
+  composedField->DisconnectPipeline();
+  composer = nullptr;
+
+  this->AccumulatePeakFieldMemory( { updateField, composedField, pendingUpdateField } );
+  updateField = nullptr;
+
+  DisplacementFieldPointer smoothTotalFieldTmp = this->SmoothTotalField( composedField, toMiddleTransform );
+
+  this->AccumulatePeakFieldMemory( { composedField, smoothTotalFieldTmp, pendingUpdateField } );
+  composedField = nullptr;
+
+  // Iteratively estimate the inverse field and rebuild the forward field from it.
+
+  DisplacementFieldPointer smoothTotalFieldInverse = this->InvertDisplacementField( smoothTotalFieldTmp, toMiddleTransform->GetInverseDisplacementField() );
+  DisplacementFieldPointer smoothTotalField = this->InvertDisplacementField( smoothTotalFieldInverse, smoothTotalFieldTmp );
+
+  this->AccumulatePeakFieldMemory( { smoothTotalFieldTmp, smoothTotalFieldInverse, smoothTotalField, pendingUpdateField } );
+
+  // Assign the displacement field and its inverse to the transform.
+  toMiddleTransform->SetDisplacementField( smoothTotalField );
+  toMiddleTransform->SetInverseDisplacementField( smoothTotalFieldInverse );
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::AccumulatePeakFieldMemory( std::initializer_list<const DisplacementFieldType *> temporaryFields )
+{
+  SizeValueType numberOfPixels = 0;
+
+  const OutputTransformType * transforms[2] = { this->m_FixedToMiddleTransform, this->m_MovingToMiddleTransform };
+  for( const OutputTransformType * transform : transforms )
+    {
+    if( transform->GetDisplacementField() )
+      {
+      numberOfPixels += transform->GetDisplacementField()->GetBufferedRegion().GetNumberOfPixels();
+      }
+    if( transform->GetInverseDisplacementField() )
+      {
+      numberOfPixels += transform->GetInverseDisplacementField()->GetBufferedRegion().GetNumberOfPixels();
+      }
+    }
+  for( const DisplacementFieldType * field : temporaryFields )
+    {
+    if( field )
+      {
+      numberOfPixels += field->GetBufferedRegion().GetNumberOfPixels();
+      }
+    }
+
+  const SizeValueType numberOfBytes = numberOfPixels * sizeof( DisplacementVectorType );
+  if( numberOfBytes > this->m_PeakFieldMemoryInBytes )
+    {
+    this->m_PeakFieldMemoryInBytes = numberOfBytes;
+    }
+}
+
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
 typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::DisplacementFieldPointer
 SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
@@ -728,6 +783,14 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   return smoothField;
 }
 
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::DisplacementFieldPointer
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::SmoothTotalField( const DisplacementFieldType * field, const OutputTransformType * itkNotUsed( toMiddleTransform ) )
+{
+  return this->GaussianSmoothDisplacementField( field, this->m_GaussianSmoothingVarianceForTheTotalField );
+}
+
 /*
  * Start the registration
  */
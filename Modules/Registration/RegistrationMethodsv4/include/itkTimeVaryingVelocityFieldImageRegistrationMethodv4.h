@@ -22,6 +22,8 @@
 
 #include "itkGaussianSmoothingOnUpdateTimeVaryingVelocityFieldTransform.h"
 
+#include <initializer_list>
+
 namespace itk
 {
 
@@ -75,6 +77,17 @@ namespace itk
  * (but not sufficient) condition being that the velocity
  * field have a constant norm for all time points.
  *
+ * Only the forward displacement fields along the geodesic are integrated
+ * during the optimization;  the fixed images are warped as soon as their
+ * displacement field is available so that at most one integrated field is
+ * held at a time.  The averaged update of the previous iteration can be
+ * kept in single precision with StorePreviousUpdateInSinglePrecisionOn()
+ * which halves the largest buffer besides the velocity field itself.  The
+ * fields and buffers held by the method are measured during each iteration
+ * and the peak is reported by GetPeakFieldMemoryInBytes().  When this peak
+ * exceeds SetMaximumFieldMemoryInBytes(), the remaining iterations of the
+ * level keep the previous update in single precision.
+ *
  * \author Nick Tustison
  * \author Brian Avants
  *
@@ -155,6 +168,33 @@ public:
   itkSetMacro( ConvergenceWindowSize, unsigned int );
   itkGetConstMacro( ConvergenceWindowSize, unsigned int );
 
+  /**
+   * Store the update of the previous iteration, which is averaged with the
+   * current update to reduce oscillations, in single precision.  Default = false.
+   */
+  itkSetMacro( StorePreviousUpdateInSinglePrecision, bool );
+  itkGetConstMacro( StorePreviousUpdateInSinglePrecision, bool );
+  itkBooleanMacro( StorePreviousUpdateInSinglePrecision );
+
+  /**
+   * Set/Get the memory budget, in bytes, of the fields and buffers held by the
+   * registration method.  Once an iteration exceeds it, the following iterations of
+   * the level store the previous update in single precision, as with
+   * StorePreviousUpdateInSinglePrecisionOn().  A warning is issued if the budget is
+   * still exceeded.  Default = 0, i.e. no budget.
+   */
+  itkSetMacro( MaximumFieldMemoryInBytes, SizeValueType );
+  itkGetConstMacro( MaximumFieldMemoryInBytes, SizeValueType );
+
+  /**
+   * Get the peak memory, in bytes, of the velocity field, the update buffers and the
+   * displacement fields held by the registration method during the most recent
+   * iteration.  Fields which are only allocated inside the output transform while
+   * its parameters are updated are not included.  This value is updated before each
+   * IterationEvent.
+   */
+  itkGetConstMacro( PeakFieldMemoryInBytes, SizeValueType );
+
 protected:
   TimeVaryingVelocityFieldImageRegistrationMethodv4();
   ~TimeVaryingVelocityFieldImageRegistrationMethodv4() override;
@@ -170,12 +210,26 @@ protected:
   virtual void StartOptimization();
 
 private:
+  /** Integrate the velocity field between the given time bounds without computing the inverse field. */
+  DisplacementFieldPointer IntegrateForwardDisplacementField( const RealType, const RealType, const SizeValueType );
+
+  /**
+   * Update the peak field memory with the velocity field, the fields of the output
+   * transform, the given temporary fields and \c numberOfBufferBytes held in arrays.
+   */
+  void AccumulatePeakFieldMemory( std::initializer_list<const DisplacementFieldType *> temporaryFields,
+    const SizeValueType numberOfBufferBytes );
+
   RealType                                                        m_LearningRate;
 
   RealType                                                        m_ConvergenceThreshold;
   unsigned int                                                    m_ConvergenceWindowSize;
 
   NumberOfIterationsArrayType                                     m_NumberOfIterationsPerLevel;
+
+  bool                                                            m_StorePreviousUpdateInSinglePrecision;
+  SizeValueType                                                   m_MaximumFieldMemoryInBytes;
+  SizeValueType                                                   m_PeakFieldMemoryInBytes;
 };
 } // end namespace itk
 
@@ -27,9 +27,12 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkResampleImageFilter.h"
 #include "itkStatisticsImageFilter.h"
+#include "itkTimeVaryingVelocityFieldIntegrationImageFilter.h"
 #include "itkVectorMagnitudeImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -41,7 +44,10 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
 ::TimeVaryingVelocityFieldImageRegistrationMethodv4() :
   m_LearningRate( 0.25 ),
   m_ConvergenceThreshold( 1.0e-7 ),
-  m_ConvergenceWindowSize( 10 )
+  m_ConvergenceWindowSize( 10 ),
+  m_StorePreviousUpdateInSinglePrecision( false ),
+  m_MaximumFieldMemoryInBytes( 0 ),
+  m_PeakFieldMemoryInBytes( 0 )
 {
   this->m_NumberOfIterationsPerLevel.SetSize( 3 );
   this->m_NumberOfIterationsPerLevel[0] = 20;
@@ -73,10 +79,17 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
   typename IdentityTransformType::Pointer identityTransform = IdentityTransformType::New();
   identityTransform->SetIdentity();
 
-  typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
-
-  // This transform gets used for the moving image
+  // A single zero displacement field serves as the identity transform of the metric
+  // and as the fixed (moving) transform at the first (last) time point.
   typename DisplacementFieldDuplicatorType::Pointer fieldDuplicatorIdentity = DisplacementFieldDuplicatorType::New();
+  fieldDuplicatorIdentity->SetInputImage( this->m_OutputTransform->GetDisplacementField() );
+  fieldDuplicatorIdentity->Update();
+
+  DisplacementFieldPointer identityField = fieldDuplicatorIdentity->GetOutput();
+  identityField->FillBuffer( zeroVector );
+
+  typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
+  identityDisplacementFieldTransform->SetDisplacementField( identityField );
 
   TimeVaryingVelocityFieldPointer velocityField = this->m_OutputTransform->GetModifiableVelocityField();
   IndexValueType numberOfTimePoints = velocityField->GetLargestPossibleRegion().GetSize()[ImageDimension];
@@ -124,16 +137,39 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
 
   // Instantiate the update derivative for all vectors of the velocity field
   DerivativeType updateDerivative( numberOfPixelsPerTimePoint * numberOfTimePoints * ImageDimension  );
-  DerivativeType lastUpdateDerivative( numberOfPixelsPerTimePoint * numberOfTimePoints * ImageDimension  );
-  lastUpdateDerivative.Fill( 0 );
   updateDerivative.Fill( 0 );
 
+  // The previous update is only used to damp oscillations so it can optionally be
+  // kept in single precision.  The memory budget may switch to single precision
+  // during the level.
+  bool storePreviousUpdateInSinglePrecision = this->m_StorePreviousUpdateInSinglePrecision;
+  bool fieldMemoryBudgetWarned = false;
+
+  DerivativeType lastUpdateDerivative;
+  vnl_vector<float> lastUpdateDerivativeSinglePrecision;
+  if( storePreviousUpdateInSinglePrecision )
+    {
+    lastUpdateDerivativeSinglePrecision.set_size( updateDerivative.size() );
+    lastUpdateDerivativeSinglePrecision.fill( 0.0f );
+    }
+  else
+    {
+    lastUpdateDerivative.SetSize( updateDerivative.size() );
+    lastUpdateDerivative.Fill( 0 );
+    }
+
   // Monitor the convergence
   using ConvergenceMonitoringType = itk::Function::WindowConvergenceMonitoringFunction<RealType>;
   typename ConvergenceMonitoringType::Pointer convergenceMonitoring = ConvergenceMonitoringType::New();
   convergenceMonitoring->SetWindowSize( this->m_ConvergenceWindowSize );
 
-  // m_OutputTransform is the velocity field
+  // m_OutputTransform is the velocity field.  The displacement fields along the geodesic
+  // are integrated separately so the transform only integrates the full time range
+  // when its parameters are updated.
+
+  this->m_OutputTransform->SetLowerTimeBound( 0.0 );
+  this->m_OutputTransform->SetUpperTimeBound( 1.0 );
+  this->m_OutputTransform->SetNumberOfIntegrationSteps( numberOfIntegrationSteps );
 
   IterationReporter reporter( this, 0, 1 );
 
@@ -143,6 +179,12 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
     MeasureType value = NumericTraits<MeasureType>::ZeroValue();
     this->m_CurrentMetricValue = NumericTraits<MeasureType>::ZeroValue();
 
+    this->m_PeakFieldMemoryInBytes = 0;
+    const SizeValueType numberOfBufferBytes = updateDerivative.size() * sizeof( DerivativeValueType )
+      + lastUpdateDerivative.size() * sizeof( DerivativeValueType )
+      + lastUpdateDerivativeSinglePrecision.size() * sizeof( float )
+      + metricDerivative.size() * sizeof( typename MetricDerivativeType::ValueType );
+
     // Time index zero brings the moving image closest to the fixed image
     for( IndexValueType timePoint = 0; timePoint < numberOfTimePoints; timePoint++ )
       {
@@ -152,53 +194,54 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
         t = static_cast<RealType>( timePoint ) / static_cast<RealType>( numberOfTimePoints - 1 );
         }
 
-      // Get the fixed transform.  We need to duplicate the resulting
-      // displacement field since it will be overwritten when we integrate
-      // the velocity field to get the moving image transform.
-      if( timePoint == 0 )
-        {
-        this->m_OutputTransform->GetModifiableDisplacementField()->FillBuffer( zeroVector );
-        }
-      else
+      // Get the fixed transform and warp the fixed images right away so that the
+      // corresponding displacement field can be released before the moving
+      // displacement field is integrated.  Only the forward fields are needed
+      // here;  the inverse fields are recomputed when the level finishes.
+      DisplacementFieldPointer fixedDisplacementField = identityField;
+      if( timePoint > 0 )
         {
-        this->m_OutputTransform->SetLowerTimeBound( t );
-        this->m_OutputTransform->SetUpperTimeBound( 0.0 );
-        this->m_OutputTransform->SetNumberOfIntegrationSteps( numberOfIntegrationSteps );
-        this->m_OutputTransform->IntegrateVelocityField();
+        fixedDisplacementField = this->IntegrateForwardDisplacementField( t, 0.0, numberOfIntegrationSteps );
         }
 
-      typename DisplacementFieldDuplicatorType::Pointer fieldDuplicator = DisplacementFieldDuplicatorType::New();
-      fieldDuplicator->SetInputImage( this->m_OutputTransform->GetDisplacementField() );
-      fieldDuplicator->Update();
-
       typename DisplacementFieldTransformType::Pointer fixedDisplacementFieldTransform = DisplacementFieldTransformType::New();
-      fixedDisplacementFieldTransform->SetDisplacementField( fieldDuplicator->GetOutput() );
+      fixedDisplacementFieldTransform->SetDisplacementField( fixedDisplacementField );
+      fixedDisplacementField = nullptr;
 
-      // Get the moving transform
-      if( timePoint == numberOfTimePoints - 1 )
+      std::vector<typename VirtualImageType::Pointer> fixedResampledImages( this->m_FixedSmoothImages.size() );
+      for( unsigned int n = 0; n < this->m_FixedSmoothImages.size(); n++ )
         {
-        this->m_OutputTransform->GetModifiableDisplacementField()->FillBuffer( zeroVector );
+        using FixedResamplerType = ResampleImageFilter<FixedImageType, VirtualImageType, RealType>;
+        typename FixedResamplerType::Pointer fixedResampler = FixedResamplerType::New();
+        fixedResampler->SetTransform( fixedDisplacementFieldTransform );
+        fixedResampler->SetInput( this->m_FixedSmoothImages[n] );
+        fixedResampler->SetSize( virtualDomainImage->GetRequestedRegion().GetSize() );
+        fixedResampler->SetOutputOrigin( virtualDomainImage->GetOrigin() );
+        fixedResampler->SetOutputSpacing( virtualDomainImage->GetSpacing() );
+        fixedResampler->SetOutputDirection( virtualDomainImage->GetDirection() );
+        fixedResampler->SetDefaultPixelValue( 0 );
+        fixedResampler->Update();
+
+        fixedResampledImages[n] = fixedResampler->GetOutput();
+        fixedResampledImages[n]->DisconnectPipeline();
         }
-      else
+      this->AccumulatePeakFieldMemory( { identityField,
+        timePoint > 0 ? fixedDisplacementFieldTransform->GetDisplacementField() : nullptr }, numberOfBufferBytes );
+      fixedDisplacementFieldTransform = nullptr;
+
+      // Get the moving transform
+      DisplacementFieldPointer movingDisplacementField = identityField;
+      if( timePoint < numberOfTimePoints - 1 )
         {
-        this->m_OutputTransform->SetLowerTimeBound( t );
-        this->m_OutputTransform->SetUpperTimeBound( 1.0 );
-        this->m_OutputTransform->SetNumberOfIntegrationSteps( numberOfIntegrationSteps );
-        this->m_OutputTransform->IntegrateVelocityField();
+        movingDisplacementField = this->IntegrateForwardDisplacementField( t, 1.0, numberOfIntegrationSteps );
         }
 
       typename DisplacementFieldTransformType::Pointer movingDisplacementFieldTransform = DisplacementFieldTransformType::New();
-      movingDisplacementFieldTransform->SetDisplacementField( this->m_OutputTransform->GetModifiableDisplacementField() );
+      movingDisplacementFieldTransform->SetDisplacementField( movingDisplacementField );
+      movingDisplacementField = nullptr;
 
       this->m_CompositeTransform->AddTransform( movingDisplacementFieldTransform );
       this->m_CompositeTransform->SetOnlyMostRecentTransformToOptimizeOn();
-      if( timePoint == 0 && this->m_CurrentIteration <= 1 )
-        {
-        fieldDuplicatorIdentity->SetInputImage( movingDisplacementFieldTransform->GetDisplacementField() );
-        fieldDuplicatorIdentity->Update();
-        fieldDuplicatorIdentity->GetOutput()->FillBuffer( zeroVector );
-        identityDisplacementFieldTransform->SetDisplacementField( fieldDuplicatorIdentity->GetOutput() );
-        }
 
       for( unsigned int n = 0; n < this->m_MovingSmoothImages.size(); n++ )
         {
@@ -213,23 +256,12 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
         movingResampler->SetDefaultPixelValue( 0 );
         movingResampler->Update();
 
-        using FixedResamplerType = ResampleImageFilter<FixedImageType, VirtualImageType, RealType>;
-        typename FixedResamplerType::Pointer fixedResampler = FixedResamplerType::New();
-        fixedResampler->SetTransform( fixedDisplacementFieldTransform );
-        fixedResampler->SetInput( this->m_FixedSmoothImages[n] );
-        fixedResampler->SetSize( virtualDomainImage->GetRequestedRegion().GetSize() );
-        fixedResampler->SetOutputOrigin( virtualDomainImage->GetOrigin() );
-        fixedResampler->SetOutputSpacing( virtualDomainImage->GetSpacing() );
-        fixedResampler->SetOutputDirection( virtualDomainImage->GetDirection() );
-        fixedResampler->SetDefaultPixelValue( 0 );
-        fixedResampler->Update();
-
         if( multiMetric )
           {
           typename ImageMetricType::Pointer metricQueue = dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() );
           if( metricQueue.IsNotNull() )
             {
-            metricQueue->SetFixedImage( fixedResampler->GetOutput() );
+            metricQueue->SetFixedImage( fixedResampledImages[n] );
             metricQueue->SetMovingImage( movingResampler->GetOutput() );
             }
           else
@@ -239,7 +271,7 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
           }
         else
           {
-          dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->SetFixedImage( fixedResampler->GetOutput() );
+          dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->SetFixedImage( fixedResampledImages[n] );
           dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->SetMovingImage( movingResampler->GetOutput() );
           }
         }
@@ -279,6 +311,10 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
 
       this->m_CurrentMetricValue += value;
 
+      this->AccumulatePeakFieldMemory( { identityField,
+        timePoint < numberOfTimePoints - 1 ? movingDisplacementFieldTransform->GetDisplacementField() : nullptr },
+        numberOfBufferBytes );
+
       // Remove the temporary mapping along the geodesic
       this->m_CompositeTransform->RemoveTransform();
 
@@ -322,10 +358,46 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
       } // end loop over time points
 
     // update the transform --- averaging with the last update reduces oscillations
-    updateDerivative = ( updateDerivative + lastUpdateDerivative ) * 0.5;
-    lastUpdateDerivative = updateDerivative;
+    if( storePreviousUpdateInSinglePrecision )
+      {
+      for( SizeValueType i = 0; i < updateDerivative.size(); i++ )
+        {
+        updateDerivative[i] = ( updateDerivative[i] + lastUpdateDerivativeSinglePrecision[i] ) * 0.5;
+        lastUpdateDerivativeSinglePrecision[i] = static_cast<float>( updateDerivative[i] );
+        }
+      }
+    else
+      {
+      updateDerivative += lastUpdateDerivative;
+      updateDerivative *= 0.5;
+      lastUpdateDerivative = updateDerivative;
+      }
     this->m_OutputTransform->UpdateTransformParameters( updateDerivative, this->m_LearningRate );
 
+    this->AccumulatePeakFieldMemory( { identityField }, numberOfBufferBytes );
+    itkDebugMacro( "Peak field memory: " << this->m_PeakFieldMemoryInBytes << " bytes" );
+
+    if( this->m_MaximumFieldMemoryInBytes > 0 && this->m_PeakFieldMemoryInBytes > this->m_MaximumFieldMemoryInBytes )
+      {
+      if( !storePreviousUpdateInSinglePrecision )
+        {
+        lastUpdateDerivativeSinglePrecision.set_size( lastUpdateDerivative.size() );
+        for( SizeValueType i = 0; i < lastUpdateDerivative.size(); i++ )
+          {
+          lastUpdateDerivativeSinglePrecision[i] = static_cast<float>( lastUpdateDerivative[i] );
+          }
+        lastUpdateDerivative.SetSize( 0 );
+        storePreviousUpdateInSinglePrecision = true;
+        itkDebugMacro( "Field memory budget exceeded, storing the previous update in single precision." );
+        }
+      else if( !fieldMemoryBudgetWarned )
+        {
+        itkWarningMacro( "The peak field memory of " << this->m_PeakFieldMemoryInBytes
+          << " bytes exceeds the budget of " << this->m_MaximumFieldMemoryInBytes << " bytes." );
+        fieldMemoryBudgetWarned = true;
+        }
+      }
+
     this->m_CurrentMetricValue /= static_cast<MeasureType>( numberOfTimePoints );
 
     convergenceMonitoring->AddEnergyValue( this->m_CurrentMetricValue );
@@ -391,6 +463,66 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
     }
 }
 
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+typename TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::DisplacementFieldPointer
+TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::IntegrateForwardDisplacementField( const RealType lowerTimeBound, const RealType upperTimeBound,
+  const SizeValueType numberOfIntegrationSteps )
+{
+  using IntegratorType = TimeVaryingVelocityFieldIntegrationImageFilter<TimeVaryingVelocityFieldType, DisplacementFieldType>;
+
+  typename IntegratorType::Pointer integrator = IntegratorType::New();
+  integrator->SetInput( this->m_OutputTransform->GetVelocityField() );
+  integrator->SetLowerTimeBound( lowerTimeBound );
+  integrator->SetUpperTimeBound( upperTimeBound );
+  if( this->m_OutputTransform->GetVelocityFieldInterpolator() )
+    {
+    integrator->SetVelocityFieldInterpolator( this->m_OutputTransform->GetModifiableVelocityFieldInterpolator() );
+    }
+  integrator->SetNumberOfIntegrationSteps( numberOfIntegrationSteps );
+  integrator->Update();
+
+  DisplacementFieldPointer displacementField = integrator->GetOutput();
+  displacementField->DisconnectPipeline();
+
+  return displacementField;
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform, typename TVirtualImage, typename TPointSet>
+void
+TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
+::AccumulatePeakFieldMemory( std::initializer_list<const DisplacementFieldType *> temporaryFields,
+  const SizeValueType numberOfBufferBytes )
+{
+  SizeValueType numberOfPixels = 0;
+
+  if( this->m_OutputTransform->GetVelocityField() )
+    {
+    numberOfPixels += this->m_OutputTransform->GetVelocityField()->GetBufferedRegion().GetNumberOfPixels();
+    }
+  if( this->m_OutputTransform->GetDisplacementField() )
+    {
+    numberOfPixels += this->m_OutputTransform->GetDisplacementField()->GetBufferedRegion().GetNumberOfPixels();
+    }
+  if( this->m_OutputTransform->GetInverseDisplacementField() )
+    {
+    numberOfPixels += this->m_OutputTransform->GetInverseDisplacementField()->GetBufferedRegion().GetNumberOfPixels();
+    }
+  for( const DisplacementFieldType * field : temporaryFields )
+    {
+    if( field )
+      {
+      numberOfPixels += field->GetBufferedRegion().GetNumberOfPixels();
+      }
+    }
+
+  const SizeValueType numberOfBytes = numberOfPixels * sizeof( DisplacementVectorType ) + numberOfBufferBytes;
+  if( numberOfBytes > this->m_PeakFieldMemoryInBytes )
+    {
+    this->m_PeakFieldMemoryInBytes = numberOfBytes;
+    }
+}
+
 /*
  * Start the registration
  */
@@ -436,6 +568,9 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
   os << indent << "Convergence threshold: " << this->m_ConvergenceThreshold << std::endl;
   os << indent << "Convergence window size: " << this->m_ConvergenceWindowSize << std::endl;
   os << indent << "Learning rate: " << this->m_LearningRate << std::endl;
+  os << indent << "Store previous update in single precision: "
+     << ( this->m_StorePreviousUpdateInSinglePrecision ? "On" : "Off" ) << std::endl;
+  os << indent << "Maximum field memory in bytes: " << this->m_MaximumFieldMemoryInBytes << std::endl;
 }
 
 } // end namespace itk
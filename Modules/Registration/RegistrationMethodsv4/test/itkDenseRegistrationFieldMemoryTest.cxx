@@ -0,0 +1,318 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkTimeVaryingVelocityFieldImageRegistrationMethodv4.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+/**
+ * Registers two shifted Gaussian blobs with the SyN and time-varying velocity
+ * field registration methods and checks the reported field memory.  For the
+ * time-varying method, keeping the previous update in single precision must
+ * lower the measured peak and only perturb the result slightly, and a memory
+ * budget must lower the peak of the following iterations.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+
+using ImageType = itk::Image<double, Dimension>;
+
+ImageType::Pointer
+CreateBlobImage( const double center0, const double center1 )
+{
+  ImageType::SizeType size;
+  size.Fill( 32 );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It( image, image->GetBufferedRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const double dx = It.GetIndex()[0] - center0;
+    const double dy = It.GetIndex()[1] - center1;
+    It.Set( 100.0 * std::exp( -( dx * dx + dy * dy ) / 50.0 ) );
+    }
+  return image;
+}
+
+template<typename TRegistration>
+void
+SetSingleLevel( TRegistration * registration, const itk::SizeValueType numberOfIterations )
+{
+  typename TRegistration::ShrinkFactorsArrayType shrinkFactorsPerLevel;
+  shrinkFactorsPerLevel.SetSize( 1 );
+  shrinkFactorsPerLevel.Fill( 1 );
+
+  typename TRegistration::SmoothingSigmasArrayType smoothingSigmasPerLevel;
+  smoothingSigmasPerLevel.SetSize( 1 );
+  smoothingSigmasPerLevel.Fill( 0 );
+
+  typename TRegistration::NumberOfIterationsArrayType numberOfIterationsPerLevel;
+  numberOfIterationsPerLevel.SetSize( 1 );
+  numberOfIterationsPerLevel.Fill( numberOfIterations );
+
+  registration->SetNumberOfLevels( 1 );
+  registration->SetShrinkFactorsPerLevel( shrinkFactorsPerLevel );
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmasPerLevel );
+  registration->SetNumberOfIterationsPerLevel( numberOfIterationsPerLevel );
+}
+
+int
+TestSyNFieldMemory( ImageType * fixedImage, ImageType * movingImage )
+{
+  using RegistrationType = itk::SyNImageRegistrationMethod<ImageType, ImageType>;
+  RegistrationType::Pointer registration = RegistrationType::New();
+
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  MetricType::Pointer metric = MetricType::New();
+
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetMetric( metric );
+  registration->SetLearningRate( 0.5 );
+  registration->SetConvergenceThreshold( 0.0 );
+  SetSingleLevel( registration.GetPointer(), 10 );
+
+  TRY_EXPECT_NO_EXCEPTION( registration->Update() );
+
+  const itk::SizeValueType fieldBytes = fixedImage->GetBufferedRegion().GetNumberOfPixels()
+    * sizeof( RegistrationType::DisplacementVectorType );
+  const itk::SizeValueType peak = registration->GetPeakFieldMemoryInBytes();
+  std::cout << "SyN peak field memory: " << peak << " bytes ("
+            << static_cast<double>( peak ) / fieldBytes << " fields)" << std::endl;
+
+  // The two pending update fields, the four total fields and at most three
+  // intermediate fields of the transform being updated.
+  TEST_EXPECT_TRUE( peak >= 6 * fieldBytes );
+  TEST_EXPECT_TRUE( peak <= 8 * fieldBytes );
+
+  const RegistrationType::DisplacementFieldType * field =
+    registration->GetModifiableTransform()->GetDisplacementField();
+  ImageType::IndexType index;
+  index.Fill( 16 );
+  index[0] = 12;
+  std::cout << "SyN displacement at " << index << ": " << field->GetPixel( index ) << std::endl;
+  TEST_EXPECT_TRUE( field->GetPixel( index )[0] > 0.5 );
+
+  return EXIT_SUCCESS;
+}
+
+template<typename TRegistration>
+class PeakFieldMemoryObserver : public itk::Command
+{
+public:
+  using Self = PeakFieldMemoryObserver;
+  using Superclass = itk::Command;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro( Self );
+
+  void Execute( itk::Object *caller, const itk::EventObject & event ) override
+    {
+    Execute( (const itk::Object *) caller, event );
+    }
+
+  void Execute( const itk::Object * object, const itk::EventObject & event ) override
+    {
+    if( typeid( event ) == typeid( itk::IterationEvent ) )
+      {
+      m_Peaks.push_back( dynamic_cast<const TRegistration *>( object )->GetPeakFieldMemoryInBytes() );
+      }
+    }
+
+  std::vector<itk::SizeValueType> m_Peaks;
+
+protected:
+  PeakFieldMemoryObserver() = default;
+};
+
+using TimeVaryingRegistrationType = itk::TimeVaryingVelocityFieldImageRegistrationMethodv4<ImageType, ImageType>;
+using TimeVaryingDisplacementFieldType = TimeVaryingRegistrationType::DisplacementFieldType;
+
+struct TimeVaryingResult
+{
+  std::vector<itk::SizeValueType>             peaks;
+  TimeVaryingDisplacementFieldType::Pointer   displacementField;
+  TimeVaryingDisplacementFieldType::Pointer   inverseDisplacementField;
+};
+
+int
+RunTimeVaryingRegistration( ImageType * fixedImage, ImageType * movingImage, const bool singlePrecision,
+  const itk::SizeValueType maximumFieldMemory, TimeVaryingResult & result )
+{
+  using RegistrationType = TimeVaryingRegistrationType;
+  RegistrationType::Pointer registration = RegistrationType::New();
+
+  using OutputTransformType = RegistrationType::OutputTransformType;
+  using VelocityFieldType = RegistrationType::TimeVaryingVelocityFieldType;
+
+  VelocityFieldType::SizeType velocityFieldSize;
+  VelocityFieldType::SpacingType velocityFieldSpacing;
+  VelocityFieldType::PointType velocityFieldOrigin;
+  velocityFieldSize.Fill( 4 );
+  velocityFieldSpacing.Fill( 1.0 );
+  velocityFieldOrigin.Fill( 0.0 );
+  for( unsigned int d = 0; d < Dimension; d++ )
+    {
+    velocityFieldSize[d] = fixedImage->GetBufferedRegion().GetSize()[d];
+    }
+
+  VelocityFieldType::Pointer velocityField = VelocityFieldType::New();
+  velocityField->SetOrigin( velocityFieldOrigin );
+  velocityField->SetSpacing( velocityFieldSpacing );
+  velocityField->SetRegions( velocityFieldSize );
+  velocityField->Allocate();
+  velocityField->FillBuffer( RegistrationType::DisplacementVectorType( 0.0 ) );
+
+  OutputTransformType::Pointer outputTransform = OutputTransformType::New();
+  outputTransform->SetGaussianSpatialSmoothingVarianceForTheTotalField( 0.0 );
+  outputTransform->SetGaussianSpatialSmoothingVarianceForTheUpdateField( 3.0 );
+  outputTransform->SetGaussianTemporalSmoothingVarianceForTheTotalField( 0.0 );
+  outputTransform->SetGaussianTemporalSmoothingVarianceForTheUpdateField( 0.5 );
+  outputTransform->SetVelocityField( velocityField );
+  outputTransform->IntegrateVelocityField();
+
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  MetricType::Pointer metric = MetricType::New();
+
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetMetric( metric );
+  registration->SetInitialTransform( outputTransform );
+  registration->InPlaceOn();
+  registration->SetLearningRate( 0.5 );
+  registration->SetConvergenceThreshold( 0.0 );
+  SetSingleLevel( registration.GetPointer(), 5 );
+
+  TEST_SET_GET_BOOLEAN( registration, StorePreviousUpdateInSinglePrecision, singlePrecision );
+  TEST_SET_GET_VALUE( 0, registration->GetMaximumFieldMemoryInBytes() );
+  registration->SetMaximumFieldMemoryInBytes( maximumFieldMemory );
+  TEST_SET_GET_VALUE( maximumFieldMemory, registration->GetMaximumFieldMemoryInBytes() );
+
+  using ObserverType = PeakFieldMemoryObserver<RegistrationType>;
+  ObserverType::Pointer observer = ObserverType::New();
+  registration->AddObserver( itk::IterationEvent(), observer );
+
+  TRY_EXPECT_NO_EXCEPTION( registration->Update() );
+
+  result.peaks = observer->m_Peaks;
+  result.displacementField = outputTransform->GetModifiableDisplacementField();
+  result.inverseDisplacementField = outputTransform->GetModifiableInverseDisplacementField();
+
+  std::cout << "Time-varying peak field memory per iteration (single precision "
+            << ( singlePrecision ? "on" : "off" ) << ", budget " << maximumFieldMemory << " bytes):";
+  for( itk::SizeValueType peak : result.peaks )
+    {
+    std::cout << " " << peak;
+    }
+  std::cout << std::endl;
+
+  TEST_EXPECT_EQUAL( result.peaks.size(), 5 );
+  TEST_EXPECT_TRUE( result.displacementField.IsNotNull() );
+  TEST_EXPECT_TRUE( result.inverseDisplacementField.IsNotNull() );
+
+  return EXIT_SUCCESS;
+}
+
+double
+MaximumDifference( const TimeVaryingDisplacementFieldType * field1, const TimeVaryingDisplacementFieldType * field2 )
+{
+  itk::ImageRegionConstIterator<TimeVaryingDisplacementFieldType> It1( field1, field1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator<TimeVaryingDisplacementFieldType> It2( field2, field2->GetBufferedRegion() );
+  double maximumDifference = 0.0;
+  for( It1.GoToBegin(), It2.GoToBegin(); !It1.IsAtEnd(); ++It1, ++It2 )
+    {
+    maximumDifference = std::max( maximumDifference, static_cast<double>( ( It1.Get() - It2.Get() ).GetNorm() ) );
+    }
+  return maximumDifference;
+}
+} // end anonymous namespace
+
+int itkDenseRegistrationFieldMemoryTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = CreateBlobImage( 14.0, 16.0 );
+  ImageType::Pointer movingImage = CreateBlobImage( 17.0, 16.0 );
+
+  if( TestSyNFieldMemory( fixedImage, movingImage ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  TimeVaryingResult doublePrecision;
+  TimeVaryingResult singlePrecision;
+  if( RunTimeVaryingRegistration( fixedImage, movingImage, false, 0, doublePrecision ) != EXIT_SUCCESS
+    || RunTimeVaryingRegistration( fixedImage, movingImage, true, 0, singlePrecision ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  ImageType::IndexType index;
+  index.Fill( 16 );
+  index[0] = 12;
+  std::cout << "Time-varying displacement at " << index << ": "
+            << doublePrecision.displacementField->GetPixel( index ) << std::endl;
+  TEST_EXPECT_TRUE( doublePrecision.displacementField->GetPixel( index )[0] > 0.5 );
+
+  // The memory held does not grow from one iteration to the next, and the single
+  // precision previous update only perturbs the result slightly.
+  for( unsigned int i = 1; i < 5; i++ )
+    {
+    TEST_EXPECT_EQUAL( doublePrecision.peaks[i], doublePrecision.peaks[0] );
+    }
+  for( unsigned int i = 0; i < 5; i++ )
+    {
+    TEST_EXPECT_TRUE( singlePrecision.peaks[i] < doublePrecision.peaks[i] );
+    }
+  TEST_EXPECT_TRUE( MaximumDifference( doublePrecision.displacementField, singlePrecision.displacementField ) < 1.0e-3 );
+
+  // A budget just below the peak of the first iteration switches the following
+  // iterations to single precision.  The previous update of the first iteration is
+  // rounded when it is converted, so the result matches the single precision run.
+  const itk::SizeValueType budget = doublePrecision.peaks[0] - 1;
+  TimeVaryingResult budgeted;
+  if( RunTimeVaryingRegistration( fixedImage, movingImage, false, budget, budgeted ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+  TEST_EXPECT_EQUAL( budgeted.peaks[0], doublePrecision.peaks[0] );
+  for( unsigned int i = 1; i < 5; i++ )
+    {
+    TEST_EXPECT_TRUE( budgeted.peaks[i] <= budget );
+    TEST_EXPECT_EQUAL( budgeted.peaks[i], singlePrecision.peaks[i] );
+    }
+  TEST_EXPECT_EQUAL( MaximumDifference( budgeted.displacementField, singlePrecision.displacementField ), 0.0 );
+  TEST_EXPECT_EQUAL( MaximumDifference( budgeted.inverseDisplacementField, singlePrecision.inverseDisplacementField ), 0.0 );
+
+  // A budget which cannot be met only warns.
+  TimeVaryingResult unreachable;
+  if( RunTimeVaryingRegistration( fixedImage, movingImage, true, 1, unreachable ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+  TEST_EXPECT_EQUAL( MaximumDifference( unreachable.displacementField, singlePrecision.displacementField ), 0.0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
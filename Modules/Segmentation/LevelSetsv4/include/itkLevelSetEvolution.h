@@ -231,6 +231,16 @@ public:
   /** Set the maximum number of threads to be used. */
   ThreadIdType GetNumberOfThreads() const;
 
+  /** Set/Get whether the level sets are updated concurrently, one update
+   * filter per level set. Each level set is then updated against the state
+   * the other level sets had at the beginning of the iteration, rather than
+   * against the ones already updated earlier in the same iteration. This
+   * only matters for coupled terms (e.g. the Chan and Vese external term).
+   * Off by default. */
+  itkSetMacro( UpdateLevelSetsInParallel, bool );
+  itkGetConstMacro( UpdateLevelSetsInParallel, bool );
+  itkBooleanMacro( UpdateLevelSetsInParallel );
+
 protected:
   LevelSetEvolution();
   ~LevelSetEvolution() override;
@@ -256,11 +266,20 @@ protected:
   /** Update the equations at the end of 1 iteration */
   void UpdateEquations() override;
 
+  /** Create the filter that updates the given level set by 1 iteration. */
+  UpdateLevelSetFilterPointer CreateUpdateLevelSetFilter( LevelSetType * levelSet, LevelSetIdentifierType levelSetId );
+
   using SplitLevelSetPartitionerType = ThreadedIteratorRangePartitioner< typename LevelSetType::LayerConstIterator >;
   friend class LevelSetEvolutionComputeIterationThreader< LevelSetType, SplitLevelSetPartitionerType, Self >;
   using SplitLevelSetComputeIterationThreaderType = LevelSetEvolutionComputeIterationThreader< LevelSetType, SplitLevelSetPartitionerType, Self >;
   typename SplitLevelSetComputeIterationThreaderType::Pointer m_SplitLevelSetComputeIterationThreader;
 
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  using SplitLevelSetUpdateLevelSetsThreaderType = LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  typename SplitLevelSetUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetUpdateLevelSetsThreader;
+
+  bool m_UpdateLevelSetsInParallel;
+
 private:
   LevelSetEvolution( const Self& );
   void operator = ( const Self& );
@@ -332,6 +351,21 @@ public:
   using UpdateLevelSetFilterType = UpdateShiSparseLevelSet< ImageDimension, EquationContainerType >;
   using UpdateLevelSetFilterPointer = typename UpdateLevelSetFilterType::Pointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
+  /** Set/Get whether the level sets are updated concurrently, one update
+   * filter per level set. Each level set is then updated against the state
+   * the other level sets had at the beginning of the iteration, rather than
+   * against the ones already updated earlier in the same iteration. This
+   * only matters for coupled terms (e.g. the Chan and Vese external term).
+   * Off by default. */
+  itkSetMacro( UpdateLevelSetsInParallel, bool );
+  itkGetConstMacro( UpdateLevelSetsInParallel, bool );
+  itkBooleanMacro( UpdateLevelSetsInParallel );
+
 protected:
   LevelSetEvolution();
   ~LevelSetEvolution() override;
@@ -342,6 +376,15 @@ protected:
   /** Update the equations at the end of 1 iteration */
   void UpdateEquations() override;
 
+  /** Create the filter that updates the given level set by 1 iteration. */
+  UpdateLevelSetFilterPointer CreateUpdateLevelSetFilter( LevelSetType * levelSet, LevelSetIdentifierType levelSetId );
+
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  using SplitLevelSetUpdateLevelSetsThreaderType = LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  typename SplitLevelSetUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetUpdateLevelSetsThreader;
+
+  bool m_UpdateLevelSetsInParallel;
+
 private:
   LevelSetEvolution( const Self& );
   void operator = ( const Self& );
@@ -414,6 +457,21 @@ public:
   using UpdateLevelSetFilterType = UpdateMalcolmSparseLevelSet< ImageDimension, EquationContainerType >;
   using UpdateLevelSetFilterPointer = typename UpdateLevelSetFilterType::Pointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
+  /** Set/Get whether the level sets are updated concurrently, one update
+   * filter per level set. Each level set is then updated against the state
+   * the other level sets had at the beginning of the iteration, rather than
+   * against the ones already updated earlier in the same iteration. This
+   * only matters for coupled terms (e.g. the Chan and Vese external term).
+   * Off by default. */
+  itkSetMacro( UpdateLevelSetsInParallel, bool );
+  itkGetConstMacro( UpdateLevelSetsInParallel, bool );
+  itkBooleanMacro( UpdateLevelSetsInParallel );
+
 protected:
   LevelSetEvolution();
   ~LevelSetEvolution() override;
@@ -421,6 +479,15 @@ protected:
   void UpdateLevelSets() override;
 
   void UpdateEquations() override;
+
+  /** Create the filter that updates the given level set by 1 iteration. */
+  UpdateLevelSetFilterPointer CreateUpdateLevelSetFilter( LevelSetType * levelSet, LevelSetIdentifierType levelSetId );
+
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  using SplitLevelSetUpdateLevelSetsThreaderType = LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, ThreadedIndexedContainerPartitioner, Self >;
+  typename SplitLevelSetUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetUpdateLevelSetsThreader;
+
+  bool m_UpdateLevelSetsInParallel;
 };
 }
 
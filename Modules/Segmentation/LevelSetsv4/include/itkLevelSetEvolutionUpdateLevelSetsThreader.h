@@ -22,6 +22,9 @@
 #include "itkDomainThreader.h"
 #include "itkLevelSetDenseImage.h"
 #include "itkThreadedImageRegionPartitioner.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -83,6 +86,52 @@ protected:
   RMSChangeAccumulatorPerThreadType m_RMSChangeAccumulatorPerThread;
 };
 
+// For sparse level sets: each level set has its own update filter, and each
+// thread runs the update filters of a subset of the level sets.
+template< typename TLevelSet, typename TLevelSetEvolution >
+class ITK_TEMPLATE_EXPORT LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetEvolutionUpdateLevelSetsThreader);
+
+  /** Standard class type aliases. */
+  using Self = LevelSetEvolutionUpdateLevelSetsThreader;
+  using Superclass = DomainThreader< ThreadedIndexedContainerPartitioner, TLevelSetEvolution >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run time type information. */
+  itkTypeMacro( LevelSetEvolutionUpdateLevelSetsThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  using DomainType = typename Superclass::DomainType;
+  using AssociateType = typename Superclass::AssociateType;
+
+  /** Types of the associate class. */
+  using LevelSetEvolutionType = TLevelSetEvolution;
+  using LevelSetContainerType = typename LevelSetEvolutionType::LevelSetContainerType;
+  using UpdateLevelSetFilterPointer = typename LevelSetEvolutionType::UpdateLevelSetFilterPointer;
+
+  /** Update all the level sets of the evolution concurrently. The update
+   * filters are created by the evolution's CreateUpdateLevelSetFilter() and
+   * leave their input untouched, so every level set is read in the state it
+   * had at the beginning of the iteration. Their outputs are grafted back in
+   * container order once all of them have run. */
+  void UpdateLevelSets( AssociateType * evolution );
+
+protected:
+  LevelSetEvolutionUpdateLevelSetsThreader();
+
+  void ThreadedExecution( const DomainType & indexSubRange, const ThreadIdType threadId ) override;
+
+  /** Update filters, one per level set in container order. */
+  std::vector< UpdateLevelSetFilterPointer > m_UpdateLevelSetFilters;
+};
+
 } // end namespace itk
 
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -89,6 +89,61 @@ LevelSetEvolutionUpdateLevelSetsThreader< LevelSetDenseImage< TImage >, Threaded
     }
 }
 
+template< typename TLevelSet, typename TLevelSetEvolution >
+LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+::LevelSetEvolutionUpdateLevelSetsThreader()
+{
+}
+
+template< typename TLevelSet, typename TLevelSetEvolution >
+void
+LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+::ThreadedExecution( const DomainType & indexSubRange,
+                     const ThreadIdType itkNotUsed( threadId ) )
+{
+  for( IndexValueType ii = indexSubRange[0]; ii <= indexSubRange[1]; ++ii )
+    {
+    this->m_UpdateLevelSetFilters[ii]->Update();
+    }
+}
+
+template< typename TLevelSet, typename TLevelSetEvolution >
+void
+LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+::UpdateLevelSets( AssociateType * evolution )
+{
+  typename LevelSetContainerType::Iterator it = evolution->m_LevelSetContainer->Begin();
+  while( it != evolution->m_LevelSetContainer->End() )
+    {
+    UpdateLevelSetFilterPointer updateLevelSet =
+      evolution->CreateUpdateLevelSetFilter( it->GetLevelSet(), it->GetIdentifier() );
+    // The level sets already run concurrently: do not nest thread pool jobs.
+    updateLevelSet->SetNumberOfThreads( 1 );
+    this->m_UpdateLevelSetFilters.push_back( updateLevelSet );
+    ++it;
+    }
+
+  if( !this->m_UpdateLevelSetFilters.empty() )
+    {
+    DomainType completeRange;
+    completeRange[0] = 0;
+    completeRange[1] = this->m_UpdateLevelSetFilters.size() - 1;
+    this->Execute( evolution, completeRange );
+    }
+
+  it = evolution->m_LevelSetContainer->Begin();
+  auto filterIt = this->m_UpdateLevelSetFilters.begin();
+  while( it != evolution->m_LevelSetContainer->End() )
+    {
+    it->GetLevelSet()->Graft( (*filterIt)->GetOutputLevelSet() );
+
+    evolution->m_RMSChangeAccumulator = (*filterIt)->GetRMSChangeAccumulator();
+    ++filterIt;
+    ++it;
+    }
+  this->m_UpdateLevelSetFilters.clear();
+}
+
 } // end namespace itk
 
 #endif
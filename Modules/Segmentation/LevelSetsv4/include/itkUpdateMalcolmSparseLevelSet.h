@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkUpdateSparseLevelSetLayerThreader.h"
 
 namespace itk
 {
@@ -83,6 +84,7 @@ public:
 
   using EquationContainerType = TEquationContainer;
   using EquationContainerPointer = typename EquationContainerType::Pointer;
+  using TermContainerType = typename EquationContainerType::TermContainerType;
   using TermContainerPointer = typename EquationContainerType::TermContainerPointer;
 
   itkGetModifiableObjectMacro(OutputLevelSet, LevelSetType );
@@ -105,6 +107,12 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the number of threads used by the internal label map
+   * conversions and by the evaluation of the equation on the layers. Set to 1
+   * when several update filters run concurrently. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
 protected:
   UpdateMalcolmSparseLevelSet();
   ~UpdateMalcolmSparseLevelSet() override;
@@ -117,12 +125,19 @@ protected:
   IdentifierType           m_CurrentLevelSetId;
   LevelSetOutputRealType   m_RMSChangeAccumulator;
   EquationContainerPointer m_EquationContainer;
+  ThreadIdType             m_NumberOfThreads;
 
   using LabelImageType = Image< int8_t, ImageDimension >;
   using LabelImagePointer = typename LabelImageType::Pointer;
 
   LabelImagePointer m_InternalImage;
 
+  using LayerThreaderType = UpdateSparseLevelSetLayerThreader< LevelSetType, TermContainerType >;
+  using LayerUpdateListType = typename LayerThreaderType::UpdateListType;
+
+  /** Evaluates the equation on the nodes of a layer, block by block. */
+  typename LayerThreaderType::Pointer m_LayerThreader;
+
   using NeighborhoodIteratorType = ShapedNeighborhoodIterator< LabelImageType >;
 
   bool m_IsUsingUnPhasedPropagation;
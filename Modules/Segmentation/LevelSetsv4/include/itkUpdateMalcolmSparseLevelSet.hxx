@@ -34,7 +34,9 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   m_IsUsingUnPhasedPropagation( true )
 {
   this->m_Offset.Fill( 0 );
+  this->m_NumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerThreader = LayerThreaderType::New();
 }
 
 template< unsigned int VDimension, typename TEquationContainer >
@@ -56,12 +58,17 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   this->m_Offset = this->m_InputLevelSet->GetDomainOffset();
 
   this->m_OutputLevelSet->SetLayer( LevelSetType::ZeroLayer(), this->m_InputLevelSet->GetLayer( LevelSetType::ZeroLayer() ) );
-  this->m_OutputLevelSet->SetLabelMap( this->m_InputLevelSet->GetModifiableLabelMap() );
+  // The output owns its label map: the input level set is left untouched
+  // until the caller grafts the output back into it.
+  LevelSetLabelMapPointer outputLabelMap = LevelSetLabelMapType::New();
+  outputLabelMap->CopyInformation( this->m_InputLevelSet->GetLabelMap() );
+  this->m_OutputLevelSet->SetLabelMap( outputLabelMap );
   this->m_OutputLevelSet->SetDomainOffset( this->m_Offset );
 
   using LabelMapToLabelImageFilterType = LabelMapToLabelImageFilter<LevelSetLabelMapType, LabelImageType>;
   typename LabelMapToLabelImageFilterType::Pointer labelMapToLabelImageFilter = LabelMapToLabelImageFilterType::New();
   labelMapToLabelImageFilter->SetInput( this->m_InputLevelSet->GetLabelMap() );
+  labelMapToLabelImageFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelMapToLabelImageFilter->Update();
 
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
@@ -123,9 +130,9 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   typename LabelImageToLabelMapFilterType::Pointer labelImageToLabelMapFilter = LabelImageToLabelMapFilterType::New();
   labelImageToLabelMapFilter->SetInput( this->m_InternalImage );
   labelImageToLabelMapFilter->SetBackgroundValue( LevelSetType::PlusOneLayer() );
+  labelImageToLabelMapFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelImageToLabelMapFilter->Update();
 
-  LevelSetLabelMapPointer outputLabelMap = this->m_OutputLevelSet->GetModifiableLabelMap( );
   outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
 }
 
@@ -135,20 +142,23 @@ void
 UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::FillUpdateContainer()
 {
-  LevelSetLayerType levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
+  const LevelSetLayerType & levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
+
+  TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
+
+  LayerUpdateListType updates;
+  this->m_LayerThreader->SetMaximumNumberOfThreads( this->m_NumberOfThreads );
+  this->m_LayerThreader->EvaluateLayer( termContainer, levelZero, this->m_InternalImage, this->m_Offset, updates );
 
   auto nodeIt = levelZero.begin();
   auto nodeEnd = levelZero.end();
 
-  TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
+  auto upIt = updates.begin();
 
-  LevelSetInputType inputIndex;
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
-    inputIndex = currentIndex + this->m_Offset;
-
-    const LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
 
     LevelSetOutputType value = NumericTraits< LevelSetOutputType >::ZeroValue();
 
@@ -161,9 +171,10 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
       value = - NumericTraits< LevelSetOutputType >::OneValue();
       }
 
-    this->m_Update.insert( NodePairType( currentIndex, value ) );
+    this->m_Update.insert( this->m_Update.end(), NodePairType( currentIndex, value ) );
 
     ++nodeIt;
+    ++upIt;
     }
 }
 
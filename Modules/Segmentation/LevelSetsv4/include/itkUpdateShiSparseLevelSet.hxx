@@ -31,7 +31,9 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   m_RMSChangeAccumulator( NumericTraits< LevelSetOutputRealType >::ZeroValue() )
 {
   this->m_Offset.Fill( 0 );
+  this->m_NumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerThreader = LayerThreaderType::New();
 }
 
 template< unsigned int VDimension,
@@ -58,12 +60,17 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   this->m_OutputLevelSet->SetLayer( LevelSetType::MinusOneLayer(), this->m_InputLevelSet->GetLayer( LevelSetType::MinusOneLayer() ) );
   this->m_OutputLevelSet->SetLayer( LevelSetType::PlusOneLayer(), this->m_InputLevelSet->GetLayer( LevelSetType::PlusOneLayer() ) );
 
-  this->m_OutputLevelSet->SetLabelMap( this->m_InputLevelSet->GetModifiableLabelMap() );
+  // The output owns its label map: the input level set is left untouched
+  // until the caller grafts the output back into it.
+  LevelSetLabelMapPointer outputLabelMap = LevelSetLabelMapType::New();
+  outputLabelMap->CopyInformation( this->m_InputLevelSet->GetLabelMap() );
+  this->m_OutputLevelSet->SetLabelMap( outputLabelMap );
   this->m_OutputLevelSet->SetDomainOffset( this->m_Offset );
 
   using LabelMapToLabelImageFilterType = LabelMapToLabelImageFilter<LevelSetLabelMapType, LabelImageType>;
   typename LabelMapToLabelImageFilterType::Pointer labelMapToLabelImageFilter = LabelMapToLabelImageFilterType::New();
   labelMapToLabelImageFilter->SetInput( this->m_InputLevelSet->GetLabelMap() );
+  labelMapToLabelImageFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelMapToLabelImageFilter->Update();
 
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
@@ -188,9 +195,9 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   typename LabelImageToLabelMapFilterType::Pointer labelImageToLabelMapFilter = LabelImageToLabelMapFilterType::New();
   labelImageToLabelMapFilter->SetInput( this->m_InternalImage );
   labelImageToLabelMapFilter->SetBackgroundValue( LevelSetType::PlusThreeLayer() );
+  labelImageToLabelMapFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelImageToLabelMapFilter->Update();
 
-  LevelSetLabelMapPointer outputLabelMap = this->m_OutputLevelSet->GetModifiableLabelMap( );
   outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
 }
 
@@ -226,24 +233,30 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     sparseOffset[dim] = 0;
     }
 
+  // The terms and the label image are only modified once all the nodes are
+  // visited: the whole layer can be evaluated beforehand.
+  LayerUpdateListType updates;
+  this->m_LayerThreader->SetMaximumNumberOfThreads( this->m_NumberOfThreads );
+  this->m_LayerThreader->EvaluateLayer( termContainer, listOut, this->m_InternalImage, this->m_Offset, updates );
+
+  auto upIt = updates.begin();
+
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
   auto nodeIt   = listOut.begin();
   auto nodeEnd  = listOut.end();
 
-  LevelSetInputType inputIndex;
-
   // for each point in Lz
   while( nodeIt != nodeEnd )
     {
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    inputIndex = currentIndex + this->m_Offset;
 
     // update the level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
@@ -343,6 +356,14 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     sparseOffset[dim] = 0;
     }
 
+  // The terms and the label image are only modified once all the nodes are
+  // visited: the whole layer can be evaluated beforehand.
+  LayerUpdateListType updates;
+  this->m_LayerThreader->SetMaximumNumberOfThreads( this->m_NumberOfThreads );
+  this->m_LayerThreader->EvaluateLayer( termContainer, listIn, this->m_InternalImage, this->m_Offset, updates );
+
+  auto upIt = updates.begin();
+
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
@@ -355,10 +376,10 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
     // update for the current level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
@@ -0,0 +1,118 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkUpdateSparseLevelSetLayerThreader_h
+#define itkUpdateSparseLevelSetLayerThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkImageBase.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class UpdateSparseLevelSetLayerThreader
+ * \brief Evaluate the level set equation on the nodes of a sparse layer.
+ *
+ * The nodes of the layer are sorted by their linear offset in the label image
+ * of the level set domain, and the sorted array is split into contiguous
+ * blocks, one per thread. Each node is evaluated independently from the
+ * others, so the result does not depend on the number of threads.
+ *
+ * The terms are evaluated directly, without going through
+ * LevelSetEquationTermContainer::Evaluate(), so that the threads do not share
+ * the CFL contributions of the container. Use it for the representations that
+ * do not rely on a time step, i.e. ShiSparseLevelSetImage and
+ * MalcolmSparseLevelSetImage.
+ *
+ * \tparam TLevelSet Sparse level set type
+ * \tparam TTermContainer Container of the terms of the level set equation
+ *
+ * \ingroup ITKLevelSetsv4
+ */
+template< typename TLevelSet, typename TTermContainer >
+class ITK_TEMPLATE_EXPORT UpdateSparseLevelSetLayerThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TTermContainer >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(UpdateSparseLevelSetLayerThreader);
+
+  /** Standard class type aliases. */
+  using Self = UpdateSparseLevelSetLayerThreader;
+  using Superclass = DomainThreader< ThreadedIndexedContainerPartitioner, TTermContainer >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run time type information. */
+  itkTypeMacro( UpdateSparseLevelSetLayerThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  using DomainType = typename Superclass::DomainType;
+  using AssociateType = typename Superclass::AssociateType;
+
+  using TermContainerType = TTermContainer;
+  using LevelSetType = TLevelSet;
+  using LevelSetInputType = typename LevelSetType::InputType;
+  using LevelSetOffsetType = typename LevelSetType::OffsetType;
+  using LevelSetOutputRealType = typename LevelSetType::OutputRealType;
+  using LevelSetLayerType = typename LevelSetType::LayerType;
+
+  static constexpr unsigned int ImageDimension = LevelSetType::Dimension;
+
+  using ImageBaseType = ImageBase< ImageDimension >;
+
+  /** Updates of the nodes of a layer, in the order of the layer. */
+  using UpdateListType = std::vector< LevelSetOutputRealType >;
+
+  /** Evaluate the equation of \c termContainer at every node of \c layer and
+   * store the results in \c updates, in the order of the layer. \c image
+   * defines the linear offsets of the nodes, and \c offset is the offset of
+   * the level set domain in the input image. */
+  void EvaluateLayer( TermContainerType * termContainer,
+                      const LevelSetLayerType & layer,
+                      const ImageBaseType * image,
+                      const LevelSetOffsetType & offset,
+                      UpdateListType & updates );
+
+protected:
+  UpdateSparseLevelSetLayerThreader();
+
+  void ThreadedExecution( const DomainType & indexSubRange, const ThreadIdType threadId ) override;
+
+private:
+  /** Linear offset of a node, and its position in the layer. */
+  using LinearNodeType = std::pair< OffsetValueType, SizeValueType >;
+
+  std::vector< LinearNodeType >    m_SortedNodes;
+  std::vector< LevelSetInputType > m_Indices;
+  LevelSetOffsetType               m_Offset;
+  UpdateListType *                 m_Updates;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkUpdateSparseLevelSetLayerThreader.hxx"
+#endif
+
+#endif
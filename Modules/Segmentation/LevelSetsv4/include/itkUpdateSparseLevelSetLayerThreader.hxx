@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkUpdateSparseLevelSetLayerThreader_hxx
+#define itkUpdateSparseLevelSetLayerThreader_hxx
+
+#include "itkUpdateSparseLevelSetLayerThreader.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TLevelSet, typename TTermContainer >
+UpdateSparseLevelSetLayerThreader< TLevelSet, TTermContainer >
+::UpdateSparseLevelSetLayerThreader() :
+  m_Updates( nullptr )
+{
+  this->m_Offset.Fill( 0 );
+}
+
+template< typename TLevelSet, typename TTermContainer >
+void
+UpdateSparseLevelSetLayerThreader< TLevelSet, TTermContainer >
+::EvaluateLayer( TermContainerType * termContainer,
+                 const LevelSetLayerType & layer,
+                 const ImageBaseType * image,
+                 const LevelSetOffsetType & offset,
+                 UpdateListType & updates )
+{
+  updates.resize( layer.size() );
+  if( layer.empty() )
+    {
+    return;
+    }
+
+  this->m_Indices.clear();
+  this->m_Indices.reserve( layer.size() );
+  this->m_SortedNodes.clear();
+  this->m_SortedNodes.reserve( layer.size() );
+
+  SizeValueType position = 0;
+  for( typename LevelSetLayerType::const_iterator nodeIt = layer.begin(); nodeIt != layer.end(); ++nodeIt )
+    {
+    this->m_Indices.push_back( nodeIt->first );
+    this->m_SortedNodes.push_back( LinearNodeType( image->ComputeOffset( nodeIt->first ), position ) );
+    ++position;
+    }
+
+  // The layer is ordered lexicographically on the index, starting with the
+  // first dimension: sort it in memory order so that each thread processes a
+  // contiguous block of the image.
+  std::sort( this->m_SortedNodes.begin(), this->m_SortedNodes.end() );
+
+  this->m_Offset = offset;
+  this->m_Updates = &updates;
+
+  DomainType completeRange;
+  completeRange[0] = 0;
+  completeRange[1] = this->m_SortedNodes.size() - 1;
+  this->Execute( termContainer, completeRange );
+
+  this->m_Updates = nullptr;
+}
+
+template< typename TLevelSet, typename TTermContainer >
+void
+UpdateSparseLevelSetLayerThreader< TLevelSet, TTermContainer >
+::ThreadedExecution( const DomainType & indexSubRange,
+                     const ThreadIdType itkNotUsed( threadId ) )
+{
+  UpdateListType & updates = *this->m_Updates;
+
+  for( IndexValueType ii = indexSubRange[0]; ii <= indexSubRange[1]; ++ii )
+    {
+    const SizeValueType position = this->m_SortedNodes[ii].second;
+    const LevelSetInputType inputIndex = this->m_Indices[position] + this->m_Offset;
+
+    // Same summation order as LevelSetEquationTermContainer::Evaluate().
+    LevelSetOutputRealType update = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+    for( typename TermContainerType::Iterator termIt = this->m_Associate->Begin();
+         termIt != this->m_Associate->End();
+         ++termIt )
+      {
+      update += termIt->GetTerm()->Evaluate( inputIndex );
+      }
+    updates[position] = update;
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -122,6 +122,11 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the number of threads used by the internal label map
+   * conversions. Set to 1 when several update filters run concurrently. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
   /** Set the update map for all points in the zero layer */
   void SetUpdate( const LevelSetLayerType& update );
 
@@ -163,6 +168,7 @@ private:
   LevelSetOutputType m_TimeStep;
   LevelSetOutputType m_RMSChangeAccumulator;
   IdentifierType     m_CurrentLevelSetId;
+  ThreadIdType       m_NumberOfThreads;
 
   EquationContainerPointer m_EquationContainer;
 
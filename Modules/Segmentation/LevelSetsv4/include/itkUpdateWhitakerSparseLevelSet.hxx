@@ -34,6 +34,7 @@ m_MinStatus( LevelSetType::MinusThreeLayer() ),
 m_MaxStatus( LevelSetType::PlusThreeLayer() )
 {
   this->m_Offset.Fill( 0 );
+  this->m_NumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
   this->m_TempLevelSet = LevelSetType::New();
   this->m_OutputLevelSet = LevelSetType::New();
 }
@@ -82,10 +83,15 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   this->m_OutputLevelSet->SetDomainOffset( this->m_Offset );
   this->m_TempLevelSet->SetDomainOffset( this->m_Offset );
 
-  this->m_OutputLevelSet->SetLabelMap( this->m_InputLevelSet->GetModifiableLabelMap() );
+  // The output owns its label map: the input level set is left untouched
+  // until the caller grafts the output back into it.
+  LevelSetLabelMapPointer outputLabelMap = LevelSetLabelMapType::New();
+  outputLabelMap->CopyInformation( this->m_InputLevelSet->GetLabelMap() );
+  this->m_OutputLevelSet->SetLabelMap( outputLabelMap );
 
   typename LabelMapToLabelImageFilterType::Pointer labelMapToLabelImageFilter = LabelMapToLabelImageFilterType::New();
   labelMapToLabelImageFilter->SetInput( this->m_InputLevelSet->GetLabelMap() );
+  labelMapToLabelImageFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelMapToLabelImageFilter->Update();
 
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
@@ -192,9 +198,10 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   typename LabelImageToLabelMapFilterType::Pointer labelImageToLabelMapFilter = LabelImageToLabelMapFilterType::New();
   labelImageToLabelMapFilter->SetInput( this->m_InternalImage );
   labelImageToLabelMapFilter->SetBackgroundValue( LevelSetType::PlusThreeLayer() );
+  labelImageToLabelMapFilter->SetNumberOfThreads( this->m_NumberOfThreads );
   labelImageToLabelMapFilter->Update();
 
-  this->m_OutputLevelSet->GetModifiableLabelMap( )->Graft( labelImageToLabelMapFilter->GetOutput() );
+  outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
   this->m_TempPhi.clear();
 }
 
@@ -0,0 +1,345 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationPropagationTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkLevelSetEvolution.h"
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+
+using InputPixelType = unsigned short;
+using InputImageType = itk::Image< InputPixelType, Dimension >;
+using SpeedImageType = itk::Image< float, Dimension >;
+
+void FillRegion( InputImageType * image, const InputImageType::IndexValueType start,
+                 const InputImageType::SizeValueType length, const InputPixelType value )
+{
+  InputImageType::IndexType index;
+  index.Fill( start );
+  InputImageType::SizeType size;
+  size.Fill( length );
+  InputImageType::RegionType region( index, size );
+
+  itk::ImageRegionIteratorWithIndex< InputImageType > it( image, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( value );
+    }
+}
+
+InputImageType::Pointer CreateImage( const InputImageType::SizeValueType imageSize )
+{
+  InputImageType::SizeType size;
+  size.Fill( imageSize );
+
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( itk::NumericTraits< InputPixelType >::ZeroValue() );
+  return image;
+}
+
+/** Evolve two level sets, one per bright square of the input, and store the
+ * final values of both level sets in the returned vector. Each level set is
+ * driven by a propagation term that grows it inside the bright squares and
+ * shrinks it outside. When coupled is true, the equations also include the
+ * Chan and Vese internal and external terms; the external term reads the
+ * other level set. */
+template< typename TLevelSet >
+int EvolveTwoLevelSets( bool parallel, bool coupled, std::vector< typename TLevelSet::OutputType > & values )
+{
+  using LevelSetType = TLevelSet;
+  using BinaryToSparseAdaptorType = itk::BinaryImageToLevelSetImageAdaptor< InputImageType, LevelSetType >;
+
+  using IdentifierType = itk::IdentifierType;
+  using LevelSetContainerType = itk::LevelSetContainer< IdentifierType, LevelSetType >;
+
+  using IdListType = std::list< IdentifierType >;
+  using IdListImageType = itk::Image< IdListType, Dimension >;
+  using CacheImageType = itk::Image< short, Dimension >;
+  using DomainMapImageFilterType = itk::LevelSetDomainMapImageFilter< IdListImageType, CacheImageType >;
+
+  using ChanAndVeseInternalTermType = itk::LevelSetEquationChanAndVeseInternalTerm< InputImageType, LevelSetContainerType >;
+  using ChanAndVeseExternalTermType = itk::LevelSetEquationChanAndVeseExternalTerm< InputImageType, LevelSetContainerType >;
+  using PropagationTermType = itk::LevelSetEquationPropagationTerm< InputImageType, LevelSetContainerType, SpeedImageType >;
+  using TermContainerType = itk::LevelSetEquationTermContainer< InputImageType, LevelSetContainerType >;
+  using EquationContainerType = itk::LevelSetEquationContainer< TermContainerType >;
+  using LevelSetEvolutionType = itk::LevelSetEvolution< EquationContainerType, LevelSetType >;
+
+  using LevelSetOutputRealType = typename LevelSetType::OutputRealType;
+  using HeavisideFunctionType = itk::SinRegularizedHeavisideStepFunction< LevelSetOutputRealType, LevelSetOutputRealType >;
+
+  using StoppingCriterionType = itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >;
+
+  constexpr InputImageType::SizeValueType imageSize = 64;
+
+  InputImageType::Pointer input = CreateImage( imageSize );
+  FillRegion( input, 10, 14, 200 );
+  FillRegion( input, 38, 14, 200 );
+
+  // The level sets grow where the speed is negative and shrink where it is
+  // positive.
+  SpeedImageType::Pointer speed = SpeedImageType::New();
+  speed->SetRegions( input->GetLargestPossibleRegion() );
+  speed->Allocate();
+  itk::ImageRegionConstIterator< InputImageType > inputIt( input, input->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< SpeedImageType > speedIt( speed, speed->GetLargestPossibleRegion() );
+  for( ; !inputIt.IsAtEnd(); ++inputIt, ++speedIt )
+    {
+    speedIt.Set( inputIt.Get() > 0 ? -1.0f : 1.0f );
+    }
+
+  typename HeavisideFunctionType::Pointer heaviside = HeavisideFunctionType::New();
+  heaviside->SetEpsilon( 1.5 );
+
+  IdListType listIds;
+  listIds.push_back( 1 );
+  listIds.push_back( 2 );
+
+  typename IdListImageType::Pointer idImage = IdListImageType::New();
+  idImage->SetRegions( input->GetLargestPossibleRegion() );
+  idImage->Allocate();
+  idImage->FillBuffer( listIds );
+
+  typename DomainMapImageFilterType::Pointer domainMapFilter = DomainMapImageFilterType::New();
+  domainMapFilter->SetInput( idImage );
+  domainMapFilter->Update();
+
+  typename LevelSetContainerType::Pointer levelSetContainer = LevelSetContainerType::New();
+  levelSetContainer->SetHeaviside( heaviside );
+  levelSetContainer->SetDomainMapFilter( domainMapFilter );
+
+  typename EquationContainerType::Pointer equationContainer = EquationContainerType::New();
+  equationContainer->SetLevelSetContainer( levelSetContainer );
+
+  std::vector< typename LevelSetType::Pointer > levelSets;
+  for( IdentifierType id = 0; id < 2; ++id )
+    {
+    // Initialize each level set inside its own square.
+    InputImageType::Pointer binary = CreateImage( imageSize );
+    FillRegion( binary, 13 + 28 * id, 8, 1 );
+
+    typename BinaryToSparseAdaptorType::Pointer adaptor = BinaryToSparseAdaptorType::New();
+    adaptor->SetInputImage( binary );
+    adaptor->Initialize();
+
+    typename LevelSetType::Pointer levelSet = adaptor->GetModifiableLevelSet();
+    levelSets.push_back( levelSet );
+    levelSetContainer->AddLevelSet( id, levelSet, false );
+    }
+
+  for( IdentifierType id = 0; id < 2; ++id )
+    {
+    typename PropagationTermType::Pointer propagationTerm = PropagationTermType::New();
+    propagationTerm->SetInput( input );
+    propagationTerm->SetPropagationImage( speed );
+    propagationTerm->SetCoefficient( 1.0 );
+
+    typename TermContainerType::Pointer termContainer = TermContainerType::New();
+    termContainer->SetInput( input );
+    termContainer->SetCurrentLevelSetId( id );
+    termContainer->SetLevelSetContainer( levelSetContainer );
+    termContainer->AddTerm( 0, propagationTerm );
+
+    if( coupled )
+      {
+      typename ChanAndVeseInternalTermType::Pointer internalTerm = ChanAndVeseInternalTermType::New();
+      internalTerm->SetInput( input );
+      internalTerm->SetCoefficient( 1.0 );
+      termContainer->AddTerm( 1, internalTerm );
+
+      typename ChanAndVeseExternalTermType::Pointer externalTerm = ChanAndVeseExternalTermType::New();
+      externalTerm->SetInput( input );
+      externalTerm->SetCoefficient( 1.0 );
+      termContainer->AddTerm( 2, externalTerm );
+      }
+
+    equationContainer->AddEquation( id, termContainer );
+    }
+
+  typename StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
+  criterion->SetNumberOfIterations( 10 );
+
+  typename LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
+  evolution->SetEquationContainer( equationContainer );
+  evolution->SetStoppingCriterion( criterion );
+  evolution->SetLevelSetContainer( levelSetContainer );
+  evolution->SetNumberOfThreads( 2 );
+  evolution->SetUpdateLevelSetsInParallel( parallel );
+  TEST_SET_GET_VALUE( parallel, evolution->GetUpdateLevelSetsInParallel() );
+
+  TRY_EXPECT_NO_EXCEPTION( evolution->Update() );
+
+  values.clear();
+  itk::ImageRegionIteratorWithIndex< InputImageType > it( input, input->GetLargestPossibleRegion() );
+  for( IdentifierType id = 0; id < 2; ++id )
+    {
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      values.push_back( levelSets[id]->Evaluate( it.GetIndex() ) );
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+template< typename TLevelSet >
+int TestParallelUpdate( const char * name )
+{
+  using OutputType = typename TLevelSet::OutputType;
+  using PrintType = typename itk::NumericTraits< OutputType >::PrintType;
+
+  std::cout << name << std::endl;
+
+  // Uncoupled equations: each level set only reads itself, so updating the
+  // level sets concurrently must not change the result.
+  std::vector< OutputType > serialValues;
+  std::vector< OutputType > parallelValues;
+  if( EvolveTwoLevelSets< TLevelSet >( false, false, serialValues ) != EXIT_SUCCESS ||
+      EvolveTwoLevelSets< TLevelSet >( true, false, parallelValues ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  TEST_EXPECT_EQUAL( serialValues.size(), parallelValues.size() );
+  for( size_t ii = 0; ii < serialValues.size(); ++ii )
+    {
+    if( serialValues[ii] != parallelValues[ii] )
+      {
+      std::cerr << "Test failed for " << name << "!" << std::endl;
+      std::cerr << "Parallel update differs from serial update at position " << ii
+                << ": " << static_cast< PrintType >( parallelValues[ii] )
+                << " vs. " << static_cast< PrintType >( serialValues[ii] ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Coupled equations: the concurrent update reads the other level set as it
+  // was at the beginning of the iteration. It must run, and both level sets
+  // must still have a zero crossing.
+  if( EvolveTwoLevelSets< TLevelSet >( true, true, parallelValues ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  const size_t half = parallelValues.size() / 2;
+  for( size_t levelSet = 0; levelSet < 2; ++levelSet )
+    {
+    bool hasInside = false;
+    bool hasOutside = false;
+    for( size_t ii = levelSet * half; ii < ( levelSet + 1 ) * half; ++ii )
+      {
+      hasInside |= ( parallelValues[ii] < 0 );
+      hasOutside |= ( parallelValues[ii] > 0 );
+      }
+    if( !hasInside || !hasOutside )
+      {
+      std::cerr << "Test failed for " << name << "!" << std::endl;
+      std::cerr << "Level set " << levelSet << " vanished with coupled parallel update." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/** The Shi and Malcolm update filters evaluate the equation of their level
+ * set on blocks of the layers, one per thread. The evaluation of a node does
+ * not depend on the others, so the result must not depend on the number of
+ * threads of the update filters. */
+template< typename TLevelSet >
+int TestLayerThreads( const char * name )
+{
+  using OutputType = typename TLevelSet::OutputType;
+  using PrintType = typename itk::NumericTraits< OutputType >::PrintType;
+
+  std::cout << name << " layer threads" << std::endl;
+
+  const itk::ThreadIdType defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+  std::vector< OutputType > singleThreadValues;
+  std::vector< OutputType > multiThreadValues;
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( 1 );
+  const int singleThreadStatus = EvolveTwoLevelSets< TLevelSet >( false, true, singleThreadValues );
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( 3 );
+  const int multiThreadStatus = EvolveTwoLevelSets< TLevelSet >( false, true, multiThreadValues );
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( defaultNumberOfThreads );
+
+  if( singleThreadStatus != EXIT_SUCCESS || multiThreadStatus != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  TEST_EXPECT_EQUAL( singleThreadValues.size(), multiThreadValues.size() );
+  for( size_t ii = 0; ii < singleThreadValues.size(); ++ii )
+    {
+    if( singleThreadValues[ii] != multiThreadValues[ii] )
+      {
+      std::cerr << "Test failed for " << name << "!" << std::endl;
+      std::cerr << "Update with 3 threads differs from update with 1 thread at position " << ii
+                << ": " << static_cast< PrintType >( multiThreadValues[ii] )
+                << " vs. " << static_cast< PrintType >( singleThreadValues[ii] ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMultiLevelSetSparseParallelUpdateTest( int, char* [] )
+{
+  int testStatus = EXIT_SUCCESS;
+
+  if( TestParallelUpdate< itk::WhitakerSparseLevelSetImage< double, Dimension > >( "Whitaker" ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+  if( TestParallelUpdate< itk::ShiSparseLevelSetImage< Dimension > >( "Shi" ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+  if( TestParallelUpdate< itk::MalcolmSparseLevelSetImage< Dimension > >( "Malcolm" ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+  if( TestLayerThreads< itk::ShiSparseLevelSetImage< Dimension > >( "Shi" ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+  if( TestLayerThreads< itk::MalcolmSparseLevelSetImage< Dimension > >( "Malcolm" ) != EXIT_SUCCESS )
+    {
+    testStatus = EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}